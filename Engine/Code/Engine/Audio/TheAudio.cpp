@@ -1,6 +1,7 @@
 //---------------------------------------------------------------------------
 #include "Engine/Audio/TheAudio.hpp"
 #include "Engine/Error/ErrorWarningAssert.hpp"
+#include "Engine/Time/Profiler.hpp"
 
 
 //---------------------------------------------------------------------------
@@ -9,10 +10,14 @@ AudioSystem* g_theAudio = nullptr;
 
 
 //---------------------------------------------------------------------------
-AudioSystem::AudioSystem()
+AudioSystem::AudioSystem( bool isSilent /*= false*/ )
 	: m_fmodSystem( nullptr )
+	, m_soundsPlayedMetric( Metrics::RegisterCounter( "audio.sounds_played" ) )
+	, m_soundsLoadedMetric( Metrics::RegisterGauge( "audio.sounds_loaded" ) )
+	, m_channelsPlayingMetric( Metrics::RegisterGauge( "audio.channels_playing" ) )
 {
-	InitializeFMOD();
+	if ( !isSilent )
+		InitializeFMOD();
 }
 
 
@@ -107,10 +112,14 @@ AudioSystem::~AudioSystem()
 //---------------------------------------------------------------------------
 SoundID AudioSystem::CreateOrGetSound( const std::string& soundFileName )
 {
-	std::map< std::string, SoundID >::iterator found = m_registeredSoundIDs.find( soundFileName );
-	if( found != m_registeredSoundIDs.end() )
+	const SoundID* found = m_registeredSoundIDs.FindByText( soundFileName );
+	if( found != nullptr )
 	{
-		return found->second;
+		return *found;
+	}
+	else if ( IsSilent() )
+	{
+		return MISSING_SOUND_ID; //PlaySound already treats this as a no-op.
 	}
 	else
 	{
@@ -119,8 +128,9 @@ SoundID AudioSystem::CreateOrGetSound( const std::string& soundFileName )
 		if( newSound )
 		{
 			SoundID newSoundID = m_registeredSounds.size();
-			m_registeredSoundIDs[ soundFileName ] = newSoundID;
+			m_registeredSoundIDs.Insert( Name( soundFileName ), newSoundID );
 			m_registeredSounds.push_back( newSound );
+			Metrics::SetGauge( m_soundsLoadedMetric, (double)m_registeredSounds.size() );
 			return newSoundID;
 		}
 	}
@@ -144,6 +154,7 @@ AudioChannelHandle AudioSystem::PlaySound( SoundID soundID, float volumeLevel /*
 	m_fmodSystem->playSound( FMOD_CHANNEL_FREE, sound, false, &channelAssignedToSound );
 	if( channelAssignedToSound )
 	{
+		Metrics::AddToCounter( m_soundsPlayedMetric );
 		channelAssignedToSound->setVolume( volumeLevel );
 
 		if ( loop )
@@ -181,8 +192,17 @@ bool AudioSystem::isPlaying( AudioChannelHandle channel )
 //---------------------------------------------------------------------------
 void AudioSystem::Update( )
 {
+	PROFILE_SCOPE( "AudioSystem::Update" );
+
+	if ( IsSilent() )
+		return;
+
 	FMOD_RESULT result = m_fmodSystem->update();
 	ValidateResult( result );
+
+	int numChannelsPlaying = 0;
+	m_fmodSystem->getChannelsPlaying( &numChannelsPlaying );
+	Metrics::SetGauge( m_channelsPlayingMetric, numChannelsPlaying );
 }
 
 
@@ -5,9 +5,10 @@
 
 //---------------------------------------------------------------------------
 #include "ThirdParty/fmod/fmod.hpp"
+#include "Engine/Metrics/Metrics.hpp"
+#include "Engine/String/NameMap.hpp"
 #include <string>
 #include <vector>
-#include <map>
 
 
 //---------------------------------------------------------------------------
@@ -25,13 +26,14 @@ extern AudioSystem* g_theAudio;
 class AudioSystem
 {
 public:
-	AudioSystem();
+	AudioSystem( bool isSilent = false ); //Silent skips FMOD entirely, e.g. for headless simulation runs.
 	virtual ~AudioSystem();
 	SoundID CreateOrGetSound( const std::string& soundFileName );
 	AudioChannelHandle PlaySound( SoundID soundID, float volumeLevel = 1.f, bool loop = false );
 	void StopChannel( AudioChannelHandle channel );
 	bool isPlaying( AudioChannelHandle channel );
 	void Update( ); // Must be called at regular intervals (e.g. every frame)
+	bool IsSilent() const { return m_fmodSystem == nullptr; }
 
 protected:
 	void InitializeFMOD();
@@ -39,8 +41,11 @@ protected:
 
 protected:
 	FMOD::System*						m_fmodSystem;
-	std::map< std::string, SoundID >	m_registeredSoundIDs;
+	NameMap< SoundID >					m_registeredSoundIDs; //By file name.
 	std::vector< FMOD::Sound* >			m_registeredSounds;
+	MetricID							m_soundsPlayedMetric;
+	MetricID							m_soundsLoadedMetric;
+	MetricID							m_channelsPlayingMetric;
 };
 
 
@@ -0,0 +1,73 @@
+#include "Engine/Bench/BenchCommon.hpp"
+#include "Engine/Error/ErrorWarningAssert.hpp"
+#include "Engine/FileUtils/FileUtils.hpp"
+
+#include <stdarg.h>
+#include <vector>
+
+
+//--------------------------------------------------------------------------------------------------------------
+void BenchTiming::AddPass( double seconds )
+{
+	if ( m_numPasses == 0 )
+		m_coldSeconds = seconds;
+	else
+		m_warmSecondsSum += seconds;
+
+	if ( m_numPasses == 0 || seconds < m_bestSeconds )
+		m_bestSeconds = seconds;
+
+	++m_numPasses;
+}
+
+
+//--------------------------------------------------------------------------------------------------------------
+void BenchReport::Printf( const char* format, ... )
+{
+	va_list variableArgumentList;
+	va_start( variableArgumentList, format );
+	m_text.AppendVPrintf( format, variableArgumentList );
+	va_end( variableArgumentList );
+}
+
+
+//--------------------------------------------------------------------------------------------------------------
+bool BenchReport::Finish( const std::string& reportPath, bool didPass ) const
+{
+	DebuggerPrintf( "%s", m_text.GetCString() );
+
+	std::vector< unsigned char > buffer( m_text.GetCString(), m_text.GetCString() + m_text.GetLength() );
+	if ( !SaveBufferToBinaryFile( reportPath, buffer ) )
+		DebuggerPrintf( "BenchReport: failed to write %s!\n", reportPath.c_str() );
+
+	return didPass;
+}
+
+
+//--------------------------------------------------------------------------------------------------------------
+void HashBenchText( unsigned int& inout_hash, const char* text, size_t numChars )
+{
+	for ( size_t charIndex = 0; charIndex < numChars; charIndex++ )
+		inout_hash = ( inout_hash ^ (unsigned char)text[ charIndex ] ) * 16777619u;
+}
+
+
+//--------------------------------------------------------------------------------------------------------------
+double CalcMegabytesPerSecond( size_t numBytes, double seconds )
+{
+	return ( seconds > 0.0 ) ? ( numBytes / ( 1024.0 * 1024.0 ) / seconds ) : 0.0;
+}
+
+
+//--------------------------------------------------------------------------------------------------------------
+double CalcGigabytesPerSecond( size_t numBytes, double seconds )
+{
+	return ( seconds > 0.0 ) ? ( numBytes / seconds ) / ( 1024.0 * 1024.0 * 1024.0 ) : 0.0;
+}
+
+
+//--------------------------------------------------------------------------------------------------------------
+double CalcSpeedup( double baselineSeconds, double seconds )
+{
+	return ( seconds > 0.0 ) ? ( baselineSeconds / seconds ) : 0.0;
+}
@@ -0,0 +1,95 @@
+#pragma once
+
+
+#include "Engine/Memory/Memory.hpp"
+#include "Engine/String/StringFormat.hpp"
+#include "Engine/Time/Time.hpp"
+#include <stddef.h>
+#include <string>
+
+
+//-----------------------------------------------------------------------------
+// What every bench shares: a stopwatch that also counts heap calls, cold/warm/best bookkeeping over repeated
+// passes, and a report that's printed to the output window and written beside the run in one go.
+//-----------------------------------------------------------------------------
+
+//-----------------------------------------------------------------------------
+class BenchTimer //Starts on construction. Heap calls are counted through the engine's operator new.
+{
+public:
+	BenchTimer() { Restart(); }
+
+	void Restart() { m_numAllocationCallsAtStart = GetMemoryStats().m_numAllocationCalls; m_startSeconds = GetCurrentTimeSeconds(); }
+	double GetElapsedSeconds() const { return GetCurrentTimeSeconds() - m_startSeconds; }
+	int GetNumAllocationCalls() const { return (int)( GetMemoryStats().m_numAllocationCalls - m_numAllocationCallsAtStart ); }
+
+
+private:
+	double m_startSeconds;
+	size_t m_numAllocationCallsAtStart;
+};
+
+
+//-----------------------------------------------------------------------------
+struct BenchTiming //Fed one pass at a time. The first pass is the cold one, warm is the mean of the rest.
+{
+	BenchTiming() : m_numPasses( 0 ), m_coldSeconds( 0.0 ), m_warmSecondsSum( 0.0 ), m_bestSeconds( 0.0 ) {}
+
+	void AddPass( double seconds );
+	double GetColdSeconds() const { return m_coldSeconds; }
+	double GetWarmSeconds() const { return ( m_numPasses > 1 ) ? ( m_warmSecondsSum / ( m_numPasses - 1 ) ) : m_coldSeconds; }
+	double GetBestSeconds() const { return m_bestSeconds; }
+
+	int m_numPasses;
+	double m_coldSeconds;
+	double m_warmSecondsSum;
+	double m_bestSeconds;
+};
+
+
+//-----------------------------------------------------------------------------
+class BenchReport
+{
+public:
+	void Printf( const char* format, ... ); //Old printf syntax, which every bench line uses.
+	FormatBuffer& GetText() { return m_text; } //For AppendFormat.
+	bool Finish( const std::string& reportPath, bool didPass ) const; //Prints, writes reportPath, and returns didPass for the bench to return.
+
+
+private:
+	FormatBuffer m_text;
+};
+
+
+//-----------------------------------------------------------------------------
+template < typename Result, typename Corpus > //Warms once, then returns the mean seconds per pass over numIterations.
+double TimeRepeatedBenchPass( Result ( *pass )( const Corpus& ), const Corpus& corpus, int numIterations, int& out_numAllocationsPerPass, Result& out_result )
+{
+	pass( corpus );
+
+	BenchTimer timer;
+	for ( int iteration = 0; iteration < numIterations; iteration++ )
+		out_result = pass( corpus );
+	double seconds = timer.GetElapsedSeconds();
+	out_numAllocationsPerPass = timer.GetNumAllocationCalls() / numIterations;
+	return seconds / numIterations;
+}
+
+
+//-----------------------------------------------------------------------------
+const unsigned int BENCH_HASH_SEED = 2166136261u;
+
+template < typename T >
+inline void HashBenchValue( unsigned int& inout_hash, const T& value ) //FNV-1a over the value's bytes, so passes can be checked against each other.
+{
+	const unsigned char* bytes = reinterpret_cast< const unsigned char* >( &value );
+	for ( unsigned int byteIndex = 0; byteIndex < sizeof( T ); byteIndex++ )
+		inout_hash = ( inout_hash ^ bytes[ byteIndex ] ) * 16777619u;
+}
+void HashBenchText( unsigned int& inout_hash, const char* text, size_t numChars );
+
+
+//-----------------------------------------------------------------------------
+double CalcMegabytesPerSecond( size_t numBytes, double seconds );
+double CalcGigabytesPerSecond( size_t numBytes, double seconds );
+double CalcSpeedup( double baselineSeconds, double seconds ); //0 rather than infinite when seconds rounds to nothing.
@@ -0,0 +1,96 @@
+#include "Engine/Bench/EngineBenches.hpp"
+#include "Engine/Core/Command.hpp"
+#include "Engine/Error/ErrorWarningAssert.hpp"
+#include "Engine/EngineCommon.hpp"
+
+
+//--------------------------------------------------------------------------------------------------------------
+STATIC const int EngineBenches::s_DEFAULT_NUM_READ_BENCH_ITERATIONS = 10;
+STATIC const int EngineBenches::s_DEFAULT_NUM_XML_BENCH_ITERATIONS = 20;
+STATIC const int EngineBenches::s_DEFAULT_NUM_PARSE_BENCH_ITERATIONS = 20;
+STATIC const int EngineBenches::s_DEFAULT_NUM_FORMAT_BENCH_ITERATIONS = 20;
+STATIC const int EngineBenches::s_DEFAULT_NUM_SWAP_BENCH_ITERATIONS = 9; //Odd, so the in-place kernel checks compare against swapped values.
+STATIC const int EngineBenches::s_DEFAULT_NUM_HEAP_BENCH_ITERATIONS = 3;
+STATIC const int EngineBenches::s_DEFAULT_NUM_JOB_BENCH_ITERATIONS = 5;
+STATIC const int EngineBenches::s_DEFAULT_NUM_QUEUE_BENCH_ITERATIONS = 5;
+
+
+//--------------------------------------------------------------------------------------------------------------
+STATIC bool EngineBenches::IsBenchMode( const std::string& mode )
+{
+	return mode == "readbench" || mode == "xmlbench" || mode == "parsebench" || mode == "formatbench"
+		|| mode == "swapbench" || mode == "heapbench" || mode == "jobbench" || mode == "queuebench";
+}
+
+
+//--------------------------------------------------------------------------------------------------------------
+STATIC int EngineBenches::RunFromCommand( const std::string& mode, const std::string& reportPath, Command& args, const std::vector< std::string >& defaultXMLFilePaths )
+{
+	int numIterations;
+
+	if ( mode == "readbench" ) //The file to read comes before the iterations.
+	{
+		std::string filePath;
+		if ( !args.GetNextString( &filePath ) )
+		{
+			DebuggerPrintf( "EngineBenches: readbench needs a file to read.\n" );
+			return 1;
+		}
+
+		args.GetNextInt( &numIterations, s_DEFAULT_NUM_READ_BENCH_ITERATIONS );
+		return BenchmarkFileReaders( reportPath, filePath, numIterations ) ? 0 : 1;
+	}
+
+	if ( mode == "xmlbench" ) //The game's defaults when given no files.
+	{
+		args.GetNextInt( &numIterations, s_DEFAULT_NUM_XML_BENCH_ITERATIONS );
+
+		std::vector< std::string > filePaths;
+		std::string filePath;
+		while ( args.GetNextString( &filePath ) )
+			filePaths.push_back( filePath );
+		if ( filePaths.empty() )
+			filePaths = defaultXMLFilePaths;
+
+		return BenchmarkXMLParsers( reportPath, filePaths, numIterations ) ? 0 : 1;
+	}
+
+	if ( mode == "parsebench" )
+	{
+		args.GetNextInt( &numIterations, s_DEFAULT_NUM_PARSE_BENCH_ITERATIONS );
+		return BenchmarkParsers( reportPath, numIterations ) ? 0 : 1;
+	}
+
+	if ( mode == "formatbench" )
+	{
+		args.GetNextInt( &numIterations, s_DEFAULT_NUM_FORMAT_BENCH_ITERATIONS );
+		return BenchmarkFormatting( reportPath, numIterations ) ? 0 : 1;
+	}
+
+	if ( mode == "swapbench" )
+	{
+		args.GetNextInt( &numIterations, s_DEFAULT_NUM_SWAP_BENCH_ITERATIONS );
+		return BenchmarkByteSwaps( reportPath, numIterations ) ? 0 : 1;
+	}
+
+	if ( mode == "heapbench" )
+	{
+		args.GetNextInt( &numIterations, s_DEFAULT_NUM_HEAP_BENCH_ITERATIONS );
+		return BenchmarkHeap( reportPath, numIterations ) ? 0 : 1;
+	}
+
+	if ( mode == "jobbench" )
+	{
+		args.GetNextInt( &numIterations, s_DEFAULT_NUM_JOB_BENCH_ITERATIONS );
+		return BenchmarkJobs( reportPath, numIterations ) ? 0 : 1;
+	}
+
+	if ( mode == "queuebench" )
+	{
+		args.GetNextInt( &numIterations, s_DEFAULT_NUM_QUEUE_BENCH_ITERATIONS );
+		return BenchmarkQueues( reportPath, numIterations ) ? 0 : 1;
+	}
+
+	DebuggerPrintf( "EngineBenches: unknown bench %s.\n", mode.c_str() );
+	return 1;
+}
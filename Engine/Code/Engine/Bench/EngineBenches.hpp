@@ -0,0 +1,46 @@
+#pragma once
+
+
+#include <string>
+#include <vector>
+
+
+//-----------------------------------------------------------------------------
+class Command;
+
+
+//-----------------------------------------------------------------------------
+class EngineBenches //Benchmarks that need nothing but the engine, so any game's -headless can run them.
+{
+public:
+	//Usage: readbench <reportPath> <filePath> [numIterations]
+	//       xmlbench <reportPath> [numIterations] [filePath ...]
+	//       parsebench <reportPath> [numIterations]
+	//       formatbench <reportPath> [numIterations]
+	//       swapbench <reportPath> [numIterations]
+	//       heapbench <reportPath> [numIterations]
+	//       jobbench <reportPath> [numIterations]
+	//       queuebench <reportPath> [numIterations]
+	static bool IsBenchMode( const std::string& mode );
+	static int RunFromCommand( const std::string& mode, const std::string& reportPath, Command& args, const std::vector< std::string >& defaultXMLFilePaths ); //Returns the process exit code.
+
+	static bool BenchmarkFileReaders( const std::string& reportPath, const std::string& filePath, int numIterations ); //FileBinaryReader vs MappedFileReader.
+	static bool BenchmarkXMLParsers( const std::string& reportPath, const std::vector< std::string >& filePaths, int numIterations ); //xmlParser DOM vs XMLPullReader, bare and building trees.
+	static bool BenchmarkParsers( const std::string& reportPath, int numIterations ); //atoi, sscanf, and SplitString vs StringParsing on generated values.
+	static bool BenchmarkFormatting( const std::string& reportPath, int numIterations ); //Stringf, ToString, and += vs StringFormat.
+	static bool BenchmarkByteSwaps( const std::string& reportPath, int numIterations ); //GB/s of Read<T> vs ReadArray and of each byte swap kernel.
+	static bool BenchmarkHeap( const std::string& reportPath, int numIterations ); //operator new vs malloc on 1 to N threads of small blocks.
+	static bool BenchmarkJobs( const std::string& reportPath, int numIterations ); //ParallelFor speedup, per-job overhead, and a cellular automaton on 1 to N threads.
+	static bool BenchmarkQueues( const std::string& reportPath, int numIterations ); //Ring queues vs a locked deque, then TheConsole's per-line cost.
+
+
+private:
+	static const int s_DEFAULT_NUM_READ_BENCH_ITERATIONS;
+	static const int s_DEFAULT_NUM_XML_BENCH_ITERATIONS;
+	static const int s_DEFAULT_NUM_PARSE_BENCH_ITERATIONS;
+	static const int s_DEFAULT_NUM_FORMAT_BENCH_ITERATIONS;
+	static const int s_DEFAULT_NUM_SWAP_BENCH_ITERATIONS;
+	static const int s_DEFAULT_NUM_HEAP_BENCH_ITERATIONS;
+	static const int s_DEFAULT_NUM_JOB_BENCH_ITERATIONS;
+	static const int s_DEFAULT_NUM_QUEUE_BENCH_ITERATIONS;
+};
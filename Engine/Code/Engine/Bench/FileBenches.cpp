@@ -0,0 +1,297 @@
+#include "Engine/Bench/EngineBenches.hpp"
+#include "Engine/Bench/BenchCommon.hpp"
+#include "Engine/Error/ErrorWarningAssert.hpp"
+#include "Engine/FileUtils/FileUtils.hpp"
+#include "Engine/FileUtils/XMLPullReader.hpp"
+#include "Engine/FileUtils/XMLUtils.hpp"
+#include "Engine/FileUtils/Readers/FileBinaryReader.hpp"
+#include "Engine/FileUtils/Readers/MappedFileReader.hpp"
+#include "Engine/EngineCommon.hpp"
+
+#include <string.h>
+
+
+//--------------------------------------------------------------------------------------------------------------
+static unsigned int ChecksumWithReader( BinaryReader& reader ) //The one-Read<T>-at-a-time pattern every ReadFromStream uses.
+{
+	unsigned int checksum = 0;
+	uint32_t word;
+	while ( reader.Read<uint32_t>( &word ) )
+		checksum += word;
+	return checksum;
+}
+
+
+//--------------------------------------------------------------------------------------------------------------
+static bool TimeFileBinaryReaderPass( const std::string& filePath, double& out_seconds, unsigned int& out_checksum )
+{
+	BenchTimer timer;
+
+	FileBinaryReader reader;
+	if ( !reader.open( filePath.c_str() ) )
+		return false;
+	out_checksum = ChecksumWithReader( reader );
+	reader.close();
+
+	out_seconds = timer.GetElapsedSeconds();
+	return true;
+}
+
+
+//--------------------------------------------------------------------------------------------------------------
+static bool TimeMappedFileReaderPass( const std::string& filePath, bool readInPlace, double& out_seconds, unsigned int& out_checksum )
+{
+	BenchTimer timer;
+
+	MappedFileReader reader;
+	if ( !reader.open( filePath.c_str() ) )
+		return false;
+
+	if ( !readInPlace )
+	{
+		out_checksum = ChecksumWithReader( reader );
+	}
+	else //How a fixed-layout section gets used: one pointer, no per-value calls or copies.
+	{
+		size_t numWords = reader.GetNumBytes() / sizeof( uint32_t );
+		const byte_t* words = (const byte_t*)reader.ReadBytesInPlace( numWords * sizeof( uint32_t ) );
+		out_checksum = 0;
+		for ( size_t wordIndex = 0; wordIndex < numWords; wordIndex++ )
+		{
+			uint32_t word;
+			memcpy( &word, words + ( wordIndex * sizeof( uint32_t ) ), sizeof( uint32_t ) ); //Unaligned-safe, compiles to a plain load.
+			out_checksum += word;
+		}
+	}
+	reader.close();
+
+	out_seconds = timer.GetElapsedSeconds();
+	return true;
+}
+
+
+//--------------------------------------------------------------------------------------------------------------
+STATIC bool EngineBenches::BenchmarkFileReaders( const std::string& reportPath, const std::string& filePath, int numIterations )
+{
+	static const int NUM_READERS = 3;
+	static const char* READER_NAMES[ NUM_READERS ] = { "FileBinaryReader", "MappedFileReader", "MappedFileReader in place" };
+
+	if ( numIterations < 2 )
+		numIterations = 2; //One cold pass, at least one warm.
+
+	BenchTiming timings[ NUM_READERS ];
+	unsigned int checksums[ NUM_READERS ] = { 0, 0, 0 };
+
+	//FileBinaryReader goes first each round, so any cold read from disk is billed to it rather than the mapped readers.
+	for ( int iteration = 0; iteration < numIterations; iteration++ )
+	{
+		double passSeconds[ NUM_READERS ];
+		if ( !TimeFileBinaryReaderPass( filePath, passSeconds[ 0 ], checksums[ 0 ] )
+			 || !TimeMappedFileReaderPass( filePath, false, passSeconds[ 1 ], checksums[ 1 ] )
+			 || !TimeMappedFileReaderPass( filePath, true, passSeconds[ 2 ], checksums[ 2 ] ) )
+		{
+			DebuggerPrintf( "EngineBenches: readbench failed to open %s!\n", filePath.c_str() );
+			return false;
+		}
+
+		for ( int readerIndex = 0; readerIndex < NUM_READERS; readerIndex++ )
+			timings[ readerIndex ].AddPass( passSeconds[ readerIndex ] );
+	}
+
+	int64_t modifiedTime;
+	size_t numFileBytes = 0;
+	GetFileModifiedTimeAndSize( filePath, modifiedTime, numFileBytes );
+	bool doChecksumsMatch = ( checksums[ 0 ] == checksums[ 1 ] ) && ( checksums[ 1 ] == checksums[ 2 ] );
+
+	BenchReport report;
+	report.Printf( "Headless readbench: %s, %u bytes, %d iterations\n", filePath.c_str(), numFileBytes, numIterations );
+	for ( int readerIndex = 0; readerIndex < NUM_READERS; readerIndex++ )
+	{
+		report.Printf( "%-26s cold ms: %.3f, warm ms: %.3f, warm speedup: %.1fx\n",
+					   READER_NAMES[ readerIndex ],
+					   timings[ readerIndex ].GetColdSeconds() * 1000.0,
+					   timings[ readerIndex ].GetWarmSeconds() * 1000.0,
+					   CalcSpeedup( timings[ 0 ].GetWarmSeconds(), timings[ readerIndex ].GetWarmSeconds() ) );
+	}
+	report.Printf( "Checksums: %s\n", doChecksumsMatch ? "matched" : "DIFFERED" );
+	report.Printf( "Cold is the first pass in this process, flush the OS file cache beforehand for a true disk read.\n" );
+
+	return report.Finish( reportPath, doChecksumsMatch );
+}
+
+
+//--------------------------------------------------------------------------------------------------------------
+struct XMLBenchTotals //What every parser must agree on for the timings to be comparable.
+{
+	XMLBenchTotals() : m_numElements( 0 ), m_numAttributes( 0 ), m_attributeSum( 0.0 ) {}
+	bool operator==( const XMLBenchTotals& other ) const { return m_numElements == other.m_numElements && m_numAttributes == other.m_numAttributes && m_attributeSum == other.m_attributeSum; }
+
+	int m_numElements;
+	int m_numAttributes;
+	double m_attributeSum; //Every attribute read as a float, the typed access every loader does.
+};
+
+
+//--------------------------------------------------------------------------------------------------------------
+static void WalkXMLNodeForBenchmark( const XMLNode& node, XMLBenchTotals& totals )
+{
+	if ( node.isDeclaration() ) //The <?xml ?> line, which XMLPullReader skips.
+		return;
+
+	if ( node.getName() != nullptr ) //The document node parseFile returns has none.
+	{
+		++totals.m_numElements;
+		for ( int attributeIndex = 0; attributeIndex < node.nAttribute(); attributeIndex++ )
+		{
+			++totals.m_numAttributes;
+			totals.m_attributeSum += ReadXMLAttribute( node, node.getAttributeName( attributeIndex ), 0.f );
+		}
+	}
+
+	for ( int childIndex = 0; childIndex < node.nChildNode(); childIndex++ )
+		WalkXMLNodeForBenchmark( node.getChildNode( childIndex ), totals );
+}
+
+
+//--------------------------------------------------------------------------------------------------------------
+static bool TimeXMLNodePass( const std::string& filePath, double& out_seconds, XMLBenchTotals& out_totals )
+{
+	BenchTimer timer;
+	{
+		XMLResults results;
+		XMLNode document = XMLNode::parseFile( filePath.c_str(), nullptr, &results );
+		if ( results.error != eXMLErrorNone )
+			return false;
+
+		out_totals = XMLBenchTotals();
+		WalkXMLNodeForBenchmark( document, out_totals );
+	} //Freeing the DOM is part of its cost.
+	out_seconds = timer.GetElapsedSeconds();
+	return true;
+}
+
+
+//--------------------------------------------------------------------------------------------------------------
+static bool TimeXMLPullReaderPass( const std::string& filePath, double& out_seconds, XMLBenchTotals& out_totals )
+{
+	BenchTimer timer;
+
+	XMLPullReader reader;
+	if ( !reader.open( filePath.c_str() ) )
+		return false;
+
+	out_totals = XMLBenchTotals();
+	for ( XMLPullEvent event = reader.Next(); event != XML_PULL_EVENT_END_OF_DOCUMENT; event = reader.Next() )
+	{
+		if ( event == XML_PULL_EVENT_ERROR )
+		{
+			DebuggerPrintf( "EngineBenches: XMLPullReader stopped at line %d of %s: %s\n", reader.GetErrorLineNumber(), filePath.c_str(), reader.GetErrorDescription() );
+			return false;
+		}
+		if ( event != XML_PULL_EVENT_START_ELEMENT )
+			continue;
+
+		++out_totals.m_numElements;
+		for ( int attributeIndex = 0; attributeIndex < reader.GetNumAttributes(); attributeIndex++ )
+		{
+			++out_totals.m_numAttributes;
+			out_totals.m_attributeSum += reader.ReadAttribute( reader.GetAttribute( attributeIndex ).m_name, 0.f );
+		}
+	}
+	reader.close();
+
+	out_seconds = timer.GetElapsedSeconds();
+	return true;
+}
+
+
+//--------------------------------------------------------------------------------------------------------------
+static bool TimeXMLPullTreePass( const std::string& filePath, double& out_seconds, XMLBenchTotals& out_totals ) //The save import and blueprint rebuild's path.
+{
+	BenchTimer timer;
+
+	XMLPullReader reader;
+	if ( !reader.open( filePath.c_str() ) )
+		return false;
+
+	out_totals = XMLBenchTotals();
+	while ( reader.NextChildElement( 0 ) )
+	{
+		XMLNode topNode;
+		if ( !ReadXMLNodeFromPullReader( reader, topNode ) )
+			return false;
+		WalkXMLNodeForBenchmark( topNode, out_totals );
+	}
+	if ( reader.GetEvent() == XML_PULL_EVENT_ERROR )
+		return false;
+	reader.close();
+
+	out_seconds = timer.GetElapsedSeconds();
+	return true;
+}
+
+
+//--------------------------------------------------------------------------------------------------------------
+STATIC bool EngineBenches::BenchmarkXMLParsers( const std::string& reportPath, const std::vector< std::string >& filePaths, int numIterations )
+{
+	static const int NUM_PARSERS = 3;
+	static const char* PARSER_NAMES[ NUM_PARSERS ] = { "xmlParser DOM", "XMLPullReader", "XMLPullReader tree" };
+
+	if ( numIterations < 2 )
+		numIterations = 2; //One cold pass, at least one warm.
+
+	bool didAllMatch = true;
+	BenchReport report;
+	report.Printf( "Headless xmlbench: %d iterations, every attribute read as a float\n", numIterations );
+
+	for ( const std::string& filePath : filePaths )
+	{
+		int64_t modifiedTime;
+		size_t numFileBytes;
+		if ( !GetFileModifiedTimeAndSize( filePath, modifiedTime, numFileBytes ) )
+		{
+			report.Printf( "%s: not found, skipped.\n", filePath.c_str() );
+			continue;
+		}
+
+		BenchTiming timings[ NUM_PARSERS ];
+		XMLBenchTotals totals[ NUM_PARSERS ];
+		bool didParse = true;
+
+		//The DOM goes first each round, so any cold read from disk is billed to it.
+		for ( int iteration = 0; iteration < numIterations && didParse; iteration++ )
+		{
+			double passSeconds[ NUM_PARSERS ];
+			didParse = TimeXMLNodePass( filePath, passSeconds[ 0 ], totals[ 0 ] )
+				&& TimeXMLPullReaderPass( filePath, passSeconds[ 1 ], totals[ 1 ] )
+				&& TimeXMLPullTreePass( filePath, passSeconds[ 2 ], totals[ 2 ] );
+
+			for ( int parserIndex = 0; parserIndex < NUM_PARSERS && didParse; parserIndex++ )
+				timings[ parserIndex ].AddPass( passSeconds[ parserIndex ] );
+		}
+
+		if ( !didParse )
+		{
+			report.Printf( "%s: FAILED to parse.\n", filePath.c_str() );
+			didAllMatch = false;
+			continue;
+		}
+
+		bool doTotalsMatch = ( totals[ 0 ] == totals[ 1 ] ) && ( totals[ 0 ] == totals[ 2 ] );
+		didAllMatch &= doTotalsMatch;
+
+		report.Printf( "%s: %u bytes, %d elements, %d attributes, totals %s\n",
+					   filePath.c_str(), numFileBytes, totals[ 1 ].m_numElements, totals[ 1 ].m_numAttributes, doTotalsMatch ? "matched" : "DIFFERED" );
+		for ( int parserIndex = 0; parserIndex < NUM_PARSERS; parserIndex++ )
+		{
+			report.Printf( "  %-18s cold ms: %.3f, warm ms: %.3f, warm MB/s: %.1f, warm speedup: %.1fx\n",
+						   PARSER_NAMES[ parserIndex ],
+						   timings[ parserIndex ].GetColdSeconds() * 1000.0,
+						   timings[ parserIndex ].GetWarmSeconds() * 1000.0,
+						   CalcMegabytesPerSecond( numFileBytes, timings[ parserIndex ].GetWarmSeconds() ),
+						   CalcSpeedup( timings[ 0 ].GetWarmSeconds(), timings[ parserIndex ].GetWarmSeconds() ) );
+		}
+	}
+
+	return report.Finish( reportPath, didAllMatch );
+}
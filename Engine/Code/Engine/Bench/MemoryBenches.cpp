@@ -0,0 +1,252 @@
+#include "Engine/Bench/EngineBenches.hpp"
+#include "Engine/Bench/BenchCommon.hpp"
+#include "Engine/FileUtils/Readers/BufferBinaryReader.hpp"
+#include "Engine/Memory/ByteUtils.hpp"
+#include "Engine/Memory/Memory.hpp"
+#include "Engine/Memory/SlabAllocator.hpp"
+#include "Engine/EngineCommon.hpp"
+
+#include <map>
+#include <stdlib.h>
+#include <string.h>
+#include <thread>
+#include <vector>
+
+
+//--------------------------------------------------------------------------------------------------------------
+template < typename T >
+static double TimeSwapBenchReads( const std::vector< byte_t >& source, EndianMode endianMode, bool isPerElement, int numIterations, std::vector< T >& out_values )
+{
+	BenchTimer timer;
+	for ( int iteration = 0; iteration < numIterations; iteration++ )
+	{
+		BufferBinaryReader reader( source.data(), source.size(), endianMode );
+		if ( isPerElement )
+		{
+			for ( T& value : out_values )
+				reader.Read< T >( &value );
+		}
+		else
+		{
+			reader.ReadArray( out_values.data(), out_values.size() );
+		}
+	}
+	return timer.GetElapsedSeconds() / numIterations;
+}
+
+
+//--------------------------------------------------------------------------------------------------------------
+template < typename T >
+static void BenchmarkSwapsForType( const char* typeName, const std::vector< byte_t >& source, int numIterations, BenchReport& inout_report, bool& inout_didAllMatch )
+{
+	const size_t numValues = source.size() / sizeof( T );
+	const EndianMode foreignMode = ( GetLocalMachineEndianness() == LITTLE_ENDIAN ) ? BIG_ENDIAN : LITTLE_ENDIAN;
+
+	//Expected: the source with every element reversed, by the original one-at-a-time ByteSwap.
+	std::vector< T > expected( numValues );
+	memcpy( expected.data(), source.data(), numValues * sizeof( T ) );
+	for ( T& value : expected )
+		ByteSwap( &value, sizeof( T ) );
+
+	struct SwapBenchRead
+	{
+		const char* m_name;
+		EndianMode m_endianMode;
+		bool m_isPerElement;
+	};
+	const SwapBenchRead READS[] =
+	{
+		{ "Read<T> per element, native", GetLocalMachineEndianness(), true },
+		{ "Read<T> per element, foreign", foreignMode, true },
+		{ "ReadArray, native (memcpy)", GetLocalMachineEndianness(), false },
+		{ "ReadArray, foreign", foreignMode, false }
+	};
+
+	std::vector< T > values( numValues );
+	for ( const SwapBenchRead& read : READS )
+	{
+		TimeSwapBenchReads( source, read.m_endianMode, read.m_isPerElement, 1, values ); //Warm.
+		double seconds = TimeSwapBenchReads( source, read.m_endianMode, read.m_isPerElement, numIterations, values );
+
+		bool isForeign = ( read.m_endianMode == foreignMode );
+		bool doValuesMatch = isForeign ? ( memcmp( values.data(), expected.data(), numValues * sizeof( T ) ) == 0 )
+									   : ( memcmp( values.data(), source.data(), numValues * sizeof( T ) ) == 0 );
+		inout_didAllMatch &= doValuesMatch;
+		inout_report.Printf( "%-8s %-32s %7.2f GB/s, %s\n", typeName, read.m_name, CalcGigabytesPerSecond( source.size(), seconds ), doValuesMatch ? "matched" : "DIFFERED" );
+	}
+
+	//Each kernel on its own, in place, as ReadArray runs it.
+	for ( int pathIndex = BYTE_SWAP_PATH_SCALAR; pathIndex <= BYTE_SWAP_PATH_AVX2; pathIndex++ )
+	{
+		ByteSwapPath path = (ByteSwapPath)pathIndex;
+		if ( path > GetBestByteSwapPath() )
+		{
+			inout_report.Printf( "%-8s CopyByteSwapped %-16s unsupported on this CPU\n", typeName, GetByteSwapPathName( path ) );
+			continue;
+		}
+
+		memcpy( values.data(), source.data(), numValues * sizeof( T ) );
+		BenchTimer timer;
+		for ( int iteration = 0; iteration < numIterations; iteration++ )
+			CopyByteSwapped( values.data(), values.data(), sizeof( T ), numValues, path );
+		double seconds = timer.GetElapsedSeconds() / numIterations;
+
+		//An odd count of in-place swaps leaves the values reversed, an even count restores them.
+		const void* wanted = ( numIterations % 2 == 1 ) ? (const void*)expected.data() : (const void*)source.data();
+		bool doValuesMatch = ( memcmp( values.data(), wanted, numValues * sizeof( T ) ) == 0 );
+		inout_didAllMatch &= doValuesMatch;
+		inout_report.Printf( "%-8s CopyByteSwapped %-16s %7.2f GB/s, %s\n", typeName, GetByteSwapPathName( path ), CalcGigabytesPerSecond( source.size(), seconds ), doValuesMatch ? "matched" : "DIFFERED" );
+	}
+}
+
+
+//--------------------------------------------------------------------------------------------------------------
+STATIC bool EngineBenches::BenchmarkByteSwaps( const std::string& reportPath, int numIterations )
+{
+	static const size_t NUM_SOURCE_BYTES = 16 * 1024 * 1024; //Bigger than most caches, as a mesh or animation file is.
+
+	if ( numIterations < 1 )
+		numIterations = 1;
+
+	std::vector< byte_t > source( NUM_SOURCE_BYTES );
+	unsigned int state = 12345u;
+	for ( size_t byteIndex = 0; byteIndex < source.size(); byteIndex++ )
+	{
+		state = ( state * 1664525u ) + 1013904223u;
+		source[ byteIndex ] = (byte_t)( state >> 24 );
+	}
+
+	bool didAllMatch = true;
+	BenchReport report;
+	report.Printf( "Headless swapbench: %u MB per pass, %d iterations, best path %s\n",
+				   (unsigned int)( NUM_SOURCE_BYTES / ( 1024 * 1024 ) ), numIterations, GetByteSwapPathName( BYTE_SWAP_PATH_BEST ) );
+
+	BenchmarkSwapsForType< uint16_t >( "uint16_t", source, numIterations, report, didAllMatch );
+	BenchmarkSwapsForType< float >( "float", source, numIterations, report, didAllMatch );
+	BenchmarkSwapsForType< double >( "double", source, numIterations, report, didAllMatch );
+	report.Printf( "Values: %s\n", didAllMatch ? "matched" : "DIFFERED" );
+
+	return report.Finish( reportPath, didAllMatch );
+}
+
+
+
+//--------------------------------------------------------------------------------------------------------------
+enum HeapBenchAllocator { HEAP_BENCH_OPERATOR_NEW, HEAP_BENCH_MALLOC, NUM_HEAP_BENCH_ALLOCATORS };
+static const char* s_HEAP_BENCH_ALLOCATOR_NAMES[ NUM_HEAP_BENCH_ALLOCATORS ] = { "operator new", "malloc" };
+static const unsigned int NUM_HEAP_BENCH_LIVE_SLOTS = 4096; //Per thread, so frees come back in a shuffled order.
+
+
+//--------------------------------------------------------------------------------------------------------------
+static void RunHeapBenchThread( HeapBenchAllocator allocator, unsigned int seed, int numOperations, std::vector< void* >& inout_liveSlots )
+{
+	unsigned int state = seed;
+	for ( int operationIndex = 0; operationIndex < numOperations; operationIndex++ )
+	{
+		state = ( state * 1664525u ) + 1013904223u;
+		void*& slot = inout_liveSlots[ ( state >> 8 ) % NUM_HEAP_BENCH_LIVE_SLOTS ];
+		size_t numBytes = 8 + ( ( state >> 20 ) % 232 ); //PathNode, map node, and short string sizes.
+
+		if ( allocator == HEAP_BENCH_OPERATOR_NEW )
+		{
+			::operator delete( slot );
+			slot = ::operator new( numBytes );
+		}
+		else
+		{
+			free( slot );
+			slot = malloc( numBytes );
+		}
+		*(unsigned char*)slot = (unsigned char)operationIndex; //Touch it, as a real caller would.
+	}
+}
+
+
+//--------------------------------------------------------------------------------------------------------------
+static double TimeHeapBench( HeapBenchAllocator allocator, int numThreads, int numOperationsPerThread )
+{
+	std::vector< std::vector< void* > > liveSlotsPerThread( numThreads, std::vector< void* >( NUM_HEAP_BENCH_LIVE_SLOTS, nullptr ) );
+	std::vector< std::thread > threads;
+
+	BenchTimer timer;
+	for ( int threadIndex = 0; threadIndex < numThreads; threadIndex++ )
+		threads.push_back( std::thread( RunHeapBenchThread, allocator, 12345u + threadIndex, numOperationsPerThread, std::ref( liveSlotsPerThread[ threadIndex ] ) ) );
+	for ( std::thread& thread : threads )
+		thread.join();
+	double seconds = timer.GetElapsedSeconds();
+
+	//Freed here rather than on the threads that made them, which also covers cross-thread frees.
+	for ( std::vector< void* >& liveSlots : liveSlotsPerThread )
+	{
+		for ( void* block : liveSlots )
+		{
+			if ( allocator == HEAP_BENCH_OPERATOR_NEW )
+				::operator delete( block );
+			else
+				free( block );
+		}
+	}
+
+	return seconds;
+}
+
+
+//--------------------------------------------------------------------------------------------------------------
+STATIC bool EngineBenches::BenchmarkHeap( const std::string& reportPath, int numIterations )
+{
+	static const int NUM_OPERATIONS_PER_THREAD = 2 * 1000 * 1000;
+
+	if ( numIterations < 1 )
+		numIterations = 1;
+
+	int maxNumThreads = (int)std::thread::hardware_concurrency();
+	if ( maxNumThreads < 4 )
+		maxNumThreads = 4;
+
+	BenchReport report;
+	report.GetText().Reserve( 4096 ); //Up front, so its growth doesn't count against the balance check.
+	MemoryStats statsBefore = GetMemoryStats();
+
+#if defined( DISABLE_SLAB_ALLOCATOR )
+	report.Printf( "Headless heapbench: slab allocator DISABLED, %d ops per thread, best of %d\n", NUM_OPERATIONS_PER_THREAD, numIterations );
+#else
+	report.Printf( "Headless heapbench: slab allocator on, %d ops per thread, best of %d\n", NUM_OPERATIONS_PER_THREAD, numIterations );
+#endif
+
+	for ( int numThreads = 1; numThreads <= maxNumThreads; numThreads *= 2 )
+	{
+		for ( int allocatorIndex = 0; allocatorIndex < NUM_HEAP_BENCH_ALLOCATORS; allocatorIndex++ )
+		{
+			BenchTiming timing;
+			for ( int iteration = 0; iteration < numIterations; iteration++ )
+				timing.AddPass( TimeHeapBench( (HeapBenchAllocator)allocatorIndex, numThreads, NUM_OPERATIONS_PER_THREAD ) );
+
+			double bestSeconds = timing.GetBestSeconds();
+			double numMegaOpsPerSecond = ( (double)NUM_OPERATIONS_PER_THREAD * numThreads / bestSeconds ) / 1000000.0;
+			report.Printf( "%2d threads, %-12s %8.3f ms, %7.2f M alloc+free/s\n",
+						   numThreads, s_HEAP_BENCH_ALLOCATOR_NAMES[ allocatorIndex ], bestSeconds * 1000.0, numMegaOpsPerSecond );
+		}
+	}
+
+	//The node churn that motivated it: a std::map filled and emptied, one new and delete per insert and erase.
+	BenchTimer mapTimer;
+	int mapChecksum = 0;
+	for ( int iteration = 0; iteration < numIterations; iteration++ )
+	{
+		std::map< int, int > nodes;
+		for ( int key = 0; key < 200000; key++ )
+			nodes[ ( key * 7919 ) % 200000 ] = key;
+		mapChecksum += nodes.begin()->second;
+	}
+	double mapSeconds = mapTimer.GetElapsedSeconds() / numIterations;
+	report.Printf( "std::map< int, int > of 200000 built and freed: %.3f ms (checksum %d)\n", mapSeconds * 1000.0, mapChecksum );
+
+	MemoryStats statsAfter = GetMemoryStats();
+	bool didBalance = ( statsAfter.m_numLiveAllocations == statsBefore.m_numLiveAllocations ) && ( statsAfter.m_numLiveBytes == statsBefore.m_numLiveBytes );
+	report.Printf( "Slab bytes reserved: %u KB\n", (unsigned int)( SlabAllocator::GetNumSlabBytesReserved() / 1024 ) );
+	report.Printf( "Live allocations before %d, after %d: %s\n",
+				   (int)statsBefore.m_numLiveAllocations, (int)statsAfter.m_numLiveAllocations, didBalance ? "balanced" : "LEAKED" );
+
+	return report.Finish( reportPath, didBalance );
+}
+
@@ -0,0 +1,473 @@
+#include "Engine/Bench/EngineBenches.hpp"
+#include "Engine/Bench/BenchCommon.hpp"
+#include "Engine/FileUtils/XMLUtils.hpp"
+#include "Engine/Math/Interval.hpp"
+#include "Engine/Math/Vector2.hpp"
+#include "Engine/Renderer/Rgba.hpp"
+#include "Engine/String/StringFormat.hpp"
+#include "Engine/String/StringParsing.hpp"
+#include "Engine/String/StringUtils.hpp"
+#include "Engine/EngineCommon.hpp"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+
+//--------------------------------------------------------------------------------------------------------------
+struct ParseBenchCorpus //Values as the game's data writes them, each kept apart like the attributes it reads.
+{
+	std::vector< std::string > m_ints;
+	std::vector< std::string > m_floats;
+	std::vector< std::string > m_vectors;
+	std::vector< std::string > m_ranges;
+	std::vector< std::string > m_commands;
+	std::string m_tileData;
+};
+typedef double ( *ParseBenchPass )( const ParseBenchCorpus& corpus ); //Returns a checksum of everything parsed.
+
+
+//--------------------------------------------------------------------------------------------------------------
+static void BuildParseBenchCorpus( ParseBenchCorpus& out_corpus )
+{
+	static const int NUM_VALUES = 20000;
+	static const int TILE_DATA_SIDE = 256;
+	static const char TILE_GLYPHS[] = "#.~+*";
+
+	unsigned int state = 12345u;
+	for ( int valueIndex = 0; valueIndex < NUM_VALUES; valueIndex++ )
+	{
+		HashBenchValue( state, valueIndex );
+		int a = (int)( state % 2001 ) - 1000;
+		int b = (int)( ( state >> 11 ) % 2001 ) - 1000;
+		out_corpus.m_ints.push_back( Stringf( "%d", a ) );
+		out_corpus.m_floats.push_back( Stringf( "%.3f", a / 7.f ) );
+		out_corpus.m_vectors.push_back( Stringf( "%d,%d", a, b ) );
+		out_corpus.m_ranges.push_back( Stringf( "%d~%d", a, a + abs( b ) ) );
+		out_corpus.m_commands.push_back( Stringf( "SetColor %d %d %d 255", abs( a ) % 256, abs( b ) % 256, ( state >> 24 ) ) );
+	}
+
+	for ( int y = 0; y < TILE_DATA_SIDE; y++ )
+	{
+		out_corpus.m_tileData += "\t\t"; //Indented, as in a save's TileData.
+		for ( int x = 0; x < TILE_DATA_SIDE; x++ )
+			out_corpus.m_tileData += TILE_GLYPHS[ ( x * 7 + y * 13 ) % ( sizeof( TILE_GLYPHS ) - 1 ) ];
+		if ( y < TILE_DATA_SIDE - 1 )
+			out_corpus.m_tileData += "\r\n";
+	}
+}
+
+
+//--------------------------------------------------------------------------------------------------------------
+//The routines StringParsing replaced, each as its caller ran it: the attribute copied to a std::string first.
+//--------------------------------------------------------------------------------------------------------------
+static double ParseIntsWithCRT( const ParseBenchCorpus& corpus )
+{
+	double checksum = 0.0;
+	for ( const std::string& text : corpus.m_ints )
+	{
+		int value;
+		SetTypeFromUnwrappedString( value, std::string( text.c_str() ) );
+		checksum += value;
+	}
+	return checksum;
+}
+static double ParseFloatsWithCRT( const ParseBenchCorpus& corpus )
+{
+	double checksum = 0.0;
+	for ( const std::string& text : corpus.m_floats )
+	{
+		float value;
+		SetTypeFromUnwrappedString( value, std::string( text.c_str() ) );
+		checksum += value;
+	}
+	return checksum;
+}
+static double ParseVectorsWithCRT( const ParseBenchCorpus& corpus )
+{
+	double checksum = 0.0;
+	for ( const std::string& text : corpus.m_vectors )
+	{
+		Vector2i value( std::string( text.c_str() ) );
+		checksum += value.x * 3.0 + value.y;
+	}
+	return checksum;
+}
+static double ParseRangesWithCRT( const ParseBenchCorpus& corpus )
+{
+	double checksum = 0.0;
+	for ( const std::string& text : corpus.m_ranges )
+	{
+		Interval<int> value( std::string( text.c_str() ) );
+		checksum += value.minInclusive * 3.0 + value.maxInclusive;
+	}
+	return checksum;
+}
+static double ParseCommandsWithCRT( const ParseBenchCorpus& corpus ) //Command's old sscanf_s loop, minus its 80-char arg limit.
+{
+	double checksum = 0.0;
+	for ( const std::string& text : corpus.m_commands )
+	{
+		std::vector< std::string > args = SplitString( text.c_str(), ' ', true, false );
+		for ( unsigned int argIndex = 1; argIndex < args.size(); argIndex++ )
+		{
+			unsigned char channel;
+			if ( sscanf_s( args[ argIndex ].c_str(), " %hhu ", &channel ) == 1 )
+				checksum += channel;
+		}
+	}
+	return checksum;
+}
+static double ParseTileDataWithCRT( const ParseBenchCorpus& corpus )
+{
+	double checksum = 0.0;
+	std::vector< std::string > rows = SplitString( corpus.m_tileData.c_str(), '\n', true );
+	for ( unsigned int rowIndex = 0; rowIndex < rows.size(); rowIndex++ )
+		for ( char glyph : rows[ rowIndex ] )
+			checksum += glyph * ( rowIndex + 1.0 );
+	return checksum;
+}
+
+
+//--------------------------------------------------------------------------------------------------------------
+static double ParseIntsWithStringParsing( const ParseBenchCorpus& corpus )
+{
+	double checksum = 0.0;
+	for ( const std::string& text : corpus.m_ints )
+	{
+		int value;
+		SetTypeFromStringView( value, StringView( text.c_str() ) );
+		checksum += value;
+	}
+	return checksum;
+}
+static double ParseFloatsWithStringParsing( const ParseBenchCorpus& corpus )
+{
+	double checksum = 0.0;
+	for ( const std::string& text : corpus.m_floats )
+	{
+		float value;
+		SetTypeFromStringView( value, StringView( text.c_str() ) );
+		checksum += value;
+	}
+	return checksum;
+}
+static double ParseVectorsWithStringParsing( const ParseBenchCorpus& corpus )
+{
+	double checksum = 0.0;
+	for ( const std::string& text : corpus.m_vectors )
+	{
+		Vector2i value( 0, 0 );
+		ParseVector2i( StringView( text.c_str() ), value );
+		checksum += value.x * 3.0 + value.y;
+	}
+	return checksum;
+}
+static double ParseRangesWithStringParsing( const ParseBenchCorpus& corpus )
+{
+	double checksum = 0.0;
+	for ( const std::string& text : corpus.m_ranges )
+	{
+		Interval<int> value;
+		ParseIntRange( StringView( text.c_str() ), value );
+		checksum += value.minInclusive * 3.0 + value.maxInclusive;
+	}
+	return checksum;
+}
+static double ParseCommandsWithStringParsing( const ParseBenchCorpus& corpus )
+{
+	double checksum = 0.0;
+	for ( const std::string& text : corpus.m_commands )
+	{
+		StringTokenizer tokens( StringView( text.c_str() ) );
+		StringView token;
+		tokens.Next( token ); //The name.
+		while ( tokens.Next( token ) )
+		{
+			int channel;
+			if ( ParseInt( token, channel ) )
+				checksum += channel;
+		}
+	}
+	return checksum;
+}
+static double ParseTileDataWithStringParsing( const ParseBenchCorpus& corpus )
+{
+	double checksum = 0.0;
+	StringView line;
+	double rowNumber = 1.0;
+	for ( StringTokenizer lines( corpus.m_tileData, "\n", true ); lines.Next( line ); rowNumber++ )
+		for ( char glyph : line.GetTrimmed( "\t\r" ) )
+			checksum += glyph * rowNumber;
+	return checksum;
+}
+
+
+//--------------------------------------------------------------------------------------------------------------
+STATIC bool EngineBenches::BenchmarkParsers( const std::string& reportPath, int numIterations )
+{
+	struct ParseBenchCase
+	{
+		const char* m_name;
+		ParseBenchPass m_oldPass;
+		ParseBenchPass m_newPass;
+	};
+	static const ParseBenchCase CASES[] =
+	{
+		{ "int (atoi)", ParseIntsWithCRT, ParseIntsWithStringParsing },
+		{ "float (atof)", ParseFloatsWithCRT, ParseFloatsWithStringParsing },
+		{ "Vector2i (sscanf)", ParseVectorsWithCRT, ParseVectorsWithStringParsing },
+		{ "Interval<int> (Split)", ParseRangesWithCRT, ParseRangesWithStringParsing },
+		{ "Command args (sscanf)", ParseCommandsWithCRT, ParseCommandsWithStringParsing },
+		{ "TileData rows (Split)", ParseTileDataWithCRT, ParseTileDataWithStringParsing }
+	};
+
+	if ( numIterations < 1 )
+		numIterations = 1;
+
+	ParseBenchCorpus corpus;
+	BuildParseBenchCorpus( corpus );
+
+	bool didAllMatch = true;
+	BenchReport report;
+	report.Printf( "Headless parsebench: %u values per case, %u TileData bytes, %d iterations, ms and allocations per pass\n",
+				   corpus.m_ints.size(), corpus.m_tileData.size(), numIterations );
+
+	for ( const ParseBenchCase& benchCase : CASES )
+	{
+		double seconds[ 2 ];
+		int numAllocations[ 2 ];
+		double checksums[ 2 ];
+		seconds[ 0 ] = TimeRepeatedBenchPass( benchCase.m_oldPass, corpus, numIterations, numAllocations[ 0 ], checksums[ 0 ] );
+		seconds[ 1 ] = TimeRepeatedBenchPass( benchCase.m_newPass, corpus, numIterations, numAllocations[ 1 ], checksums[ 1 ] );
+
+		bool doChecksumsMatch = ( checksums[ 0 ] == checksums[ 1 ] );
+		didAllMatch &= doChecksumsMatch;
+
+		report.Printf( "%-22s old ms: %8.3f, allocs: %6d | StringParsing ms: %8.3f, allocs: %6d | speedup: %5.1fx, results %s\n",
+					   benchCase.m_name, seconds[ 0 ] * 1000.0, numAllocations[ 0 ], seconds[ 1 ] * 1000.0, numAllocations[ 1 ],
+					   CalcSpeedup( seconds[ 0 ], seconds[ 1 ] ), doChecksumsMatch ? "matched" : "DIFFERED" );
+	}
+
+	return report.Finish( reportPath, didAllMatch );
+}
+
+
+//--------------------------------------------------------------------------------------------------------------
+struct FormatBenchCorpus //What a combat log, save writer, and map dump format most.
+{
+	std::vector< std::string > m_names;
+	std::vector< int > m_ints;
+	std::vector< float > m_floats;
+	std::vector< Vector2i > m_vectors;
+	std::vector< Rgba > m_colors;
+	std::vector< char > m_glyphs; //A square grid, row 0 at the bottom, as a tile map keeps them.
+	int m_glyphGridSide;
+};
+typedef unsigned int ( *FormatBenchPass )( const FormatBenchCorpus& corpus ); //Returns a hash of all the text formatted.
+
+
+//--------------------------------------------------------------------------------------------------------------
+static void BuildFormatBenchCorpus( FormatBenchCorpus& out_corpus )
+{
+	static const int NUM_VALUES = 20000;
+	static const int GLYPH_GRID_SIDE = 256;
+	static const char* NAMES[] = { "Player", "Giant Rat", "Nightmare Amalgam", "Dreaming Wisp", "Lava Imp", "Goblin" };
+	static const char GLYPHS[] = "#.~+*";
+
+	unsigned int state = 12345u;
+	for ( int valueIndex = 0; valueIndex < NUM_VALUES; valueIndex++ )
+	{
+		HashBenchValue( state, valueIndex );
+		int a = (int)( state % 2001 ) - 1000;
+		int b = (int)( ( state >> 11 ) % 2001 ) - 1000;
+		out_corpus.m_names.push_back( NAMES[ state % ( sizeof( NAMES ) / sizeof( NAMES[ 0 ] ) ) ] );
+		out_corpus.m_ints.push_back( a );
+		out_corpus.m_floats.push_back( a / 7.f );
+		out_corpus.m_vectors.push_back( Vector2i( a, b ) );
+		out_corpus.m_colors.push_back( Rgba( (byte_t)a, (byte_t)b, (byte_t)( state >> 24 ), (byte_t)255 ) );
+	}
+
+	out_corpus.m_glyphGridSide = GLYPH_GRID_SIDE;
+	out_corpus.m_glyphs.resize( GLYPH_GRID_SIDE * GLYPH_GRID_SIDE );
+	for ( int cellIndex = 0; cellIndex < GLYPH_GRID_SIDE * GLYPH_GRID_SIDE; cellIndex++ )
+		out_corpus.m_glyphs[ cellIndex ] = GLYPHS[ ( cellIndex * 7 + ( cellIndex / GLYPH_GRID_SIDE ) * 13 ) % ( sizeof( GLYPHS ) - 1 ) ];
+}
+
+
+//--------------------------------------------------------------------------------------------------------------
+static unsigned int FormatCombatLogWithStringf( const FormatBenchCorpus& corpus )
+{
+	unsigned int hash = BENCH_HASH_SEED;
+	for ( unsigned int valueIndex = 1; valueIndex < corpus.m_names.size(); valueIndex++ )
+	{
+		std::string message = Stringf( "%s hits %s for %d damage!", corpus.m_names[ valueIndex - 1 ].c_str(), corpus.m_names[ valueIndex ].c_str(), corpus.m_ints[ valueIndex ] );
+		HashBenchText( hash, message.c_str(), message.size() );
+	}
+	return hash;
+}
+static unsigned int FormatFloatsWithStringf( const FormatBenchCorpus& corpus )
+{
+	unsigned int hash = BENCH_HASH_SEED;
+	for ( float value : corpus.m_floats )
+	{
+		std::string text = Stringf( "%.3f", value );
+		HashBenchText( hash, text.c_str(), text.size() );
+	}
+	return hash;
+}
+static unsigned int FormatSaveAttributesWithToString( const FormatBenchCorpus& corpus ) //What WriteXMLAttribute did.
+{
+	unsigned int hash = BENCH_HASH_SEED;
+	for ( unsigned int valueIndex = 0; valueIndex < corpus.m_ints.size(); valueIndex++ )
+	{
+		std::string texts[] = {
+			GetTypedObjectAsString( corpus.m_ints[ valueIndex ] ),
+			GetTypedObjectAsString( corpus.m_floats[ valueIndex ] ),
+			GetTypedObjectAsString( corpus.m_vectors[ valueIndex ] ),
+			GetTypedObjectAsString( corpus.m_colors[ valueIndex ] )
+		};
+		for ( const std::string& text : texts )
+			HashBenchText( hash, text.c_str(), text.size() );
+	}
+	return hash;
+}
+static unsigned int FormatGlyphGridByChars( const FormatBenchCorpus& corpus ) //How map dumps used to build TileData, a += per glyph.
+{
+	static const int NUM_TABS = 2;
+	std::string gridAsString = "\n";
+	std::string tabString = "";
+	for ( int numTab = 0; numTab < NUM_TABS; ++numTab )
+		tabString += '\t';
+
+	for ( int y = corpus.m_glyphGridSide - 1; y >= 0; y-- )
+	{
+		gridAsString += tabString;
+		for ( int x = 0; x < corpus.m_glyphGridSide; x++ )
+			gridAsString += corpus.m_glyphs[ ( y * corpus.m_glyphGridSide ) + x ];
+		gridAsString += '\n';
+	}
+	for ( int numTab = 0; numTab < NUM_TABS - 1; ++numTab )
+		gridAsString += '\t';
+
+	unsigned int hash = BENCH_HASH_SEED;
+	HashBenchText( hash, gridAsString.c_str(), gridAsString.size() );
+	return hash;
+}
+
+
+//--------------------------------------------------------------------------------------------------------------
+static FormatBuffer s_formatBenchBuffer; //Reused across messages and passes, as a long-lived producer would keep one.
+static unsigned int FormatCombatLogWithStringFormat( const FormatBenchCorpus& corpus )
+{
+	unsigned int hash = BENCH_HASH_SEED;
+	for ( unsigned int valueIndex = 1; valueIndex < corpus.m_names.size(); valueIndex++ )
+	{
+		s_formatBenchBuffer.Clear();
+		AppendFormat( s_formatBenchBuffer, CHECKED_FORMAT( "{} hits {} for {} damage!", corpus.m_names[ valueIndex - 1 ], corpus.m_names[ valueIndex ], corpus.m_ints[ valueIndex ] ) );
+		HashBenchText( hash, s_formatBenchBuffer.GetCString(), s_formatBenchBuffer.GetLength() );
+	}
+	return hash;
+}
+static unsigned int FormatFloatsWithStringFormat( const FormatBenchCorpus& corpus )
+{
+	unsigned int hash = BENCH_HASH_SEED;
+	for ( float value : corpus.m_floats )
+	{
+		s_formatBenchBuffer.Clear();
+		AppendFloat( s_formatBenchBuffer, value, 3 );
+		HashBenchText( hash, s_formatBenchBuffer.GetCString(), s_formatBenchBuffer.GetLength() );
+	}
+	return hash;
+}
+static unsigned int FormatSaveAttributesWithStringFormat( const FormatBenchCorpus& corpus )
+{
+	unsigned int hash = BENCH_HASH_SEED;
+	for ( unsigned int valueIndex = 0; valueIndex < corpus.m_ints.size(); valueIndex++ )
+	{
+		InlineFormatBuffer< 64 > texts[ 4 ]; //As WriteXMLAttribute now does.
+		AppendXMLAttributeValue( texts[ 0 ], corpus.m_ints[ valueIndex ] );
+		AppendXMLAttributeValue( texts[ 1 ], corpus.m_floats[ valueIndex ] );
+		AppendXMLAttributeValue( texts[ 2 ], corpus.m_vectors[ valueIndex ] );
+		AppendXMLAttributeValue( texts[ 3 ], corpus.m_colors[ valueIndex ] );
+		for ( const FormatBuffer& text : texts )
+			HashBenchText( hash, text.GetCString(), text.GetLength() );
+	}
+	return hash;
+}
+static unsigned int FormatGlyphGridWithStringFormat( const FormatBenchCorpus& corpus ) //Reserved once and each row filled in place, as Map::AppendAsString does.
+{
+	static const int NUM_TABS = 2;
+	const int numCharsPerRow = NUM_TABS + corpus.m_glyphGridSide + 1;
+
+	s_formatBenchBuffer.Clear();
+	s_formatBenchBuffer.Reserve( 1 + ( numCharsPerRow * corpus.m_glyphGridSide ) + NUM_TABS - 1 );
+	s_formatBenchBuffer.Append( '\n' );
+	for ( int y = corpus.m_glyphGridSide - 1; y >= 0; y-- )
+	{
+		char* row = s_formatBenchBuffer.Extend( numCharsPerRow );
+		memset( row, '\t', NUM_TABS );
+		row += NUM_TABS;
+		for ( int x = 0; x < corpus.m_glyphGridSide; x++ )
+			*row++ = corpus.m_glyphs[ ( y * corpus.m_glyphGridSide ) + x ];
+		*row = '\n';
+	}
+	s_formatBenchBuffer.AppendRepeated( '\t', NUM_TABS - 1 );
+
+	unsigned int hash = BENCH_HASH_SEED;
+	HashBenchText( hash, s_formatBenchBuffer.GetCString(), s_formatBenchBuffer.GetLength() );
+	return hash;
+}
+
+
+//--------------------------------------------------------------------------------------------------------------
+STATIC bool EngineBenches::BenchmarkFormatting( const std::string& reportPath, int numIterations )
+{
+	struct FormatBenchCase
+	{
+		const char* m_name;
+		int m_numMessagesPerPass;
+		FormatBenchPass m_oldPass;
+		FormatBenchPass m_newPass;
+	};
+
+	if ( numIterations < 1 )
+		numIterations = 1;
+
+	FormatBenchCorpus corpus;
+	BuildFormatBenchCorpus( corpus );
+	const int numValues = (int)corpus.m_ints.size();
+
+	const FormatBenchCase CASES[] =
+	{
+		{ "Combat log (Stringf)", numValues - 1, FormatCombatLogWithStringf, FormatCombatLogWithStringFormat },
+		{ "%.3f floats (Stringf)", numValues, FormatFloatsWithStringf, FormatFloatsWithStringFormat },
+		{ "Save attributes (ToString)", numValues * 4, FormatSaveAttributesWithToString, FormatSaveAttributesWithStringFormat },
+		{ "Glyph grid (+= per glyph)", 1, FormatGlyphGridByChars, FormatGlyphGridWithStringFormat }
+	};
+
+	bool didAllMatch = true;
+	BenchReport report;
+	AppendFormat( report.GetText(), CHECKED_FORMAT( "Headless formatbench: {} values per case, {}x{} glyph grid, {} iterations, ms per pass and allocations per message\n",
+													numValues, corpus.m_glyphGridSide, corpus.m_glyphGridSide, numIterations ) );
+
+	for ( const FormatBenchCase& benchCase : CASES )
+	{
+		double seconds[ 2 ];
+		int numAllocations[ 2 ];
+		unsigned int hashes[ 2 ];
+		seconds[ 0 ] = TimeRepeatedBenchPass( benchCase.m_oldPass, corpus, numIterations, numAllocations[ 0 ], hashes[ 0 ] ); //Warming also grows s_formatBenchBuffer to its working size.
+		seconds[ 1 ] = TimeRepeatedBenchPass( benchCase.m_newPass, corpus, numIterations, numAllocations[ 1 ], hashes[ 1 ] );
+
+		bool doHashesMatch = ( hashes[ 0 ] == hashes[ 1 ] );
+		didAllMatch &= doHashesMatch;
+
+		AppendFormat( report.GetText(), CHECKED_FORMAT( "{:-27} old ms: {:8.3}, allocs/msg: {:6.2} | StringFormat ms: {:8.3}, allocs/msg: {:6.2} | speedup: {:5.1}x, text {}\n",
+														benchCase.m_name,
+														seconds[ 0 ] * 1000.0, (double)numAllocations[ 0 ] / benchCase.m_numMessagesPerPass,
+														seconds[ 1 ] * 1000.0, (double)numAllocations[ 1 ] / benchCase.m_numMessagesPerPass,
+														CalcSpeedup( seconds[ 0 ], seconds[ 1 ] ), doHashesMatch ? "matched" : "DIFFERED" ) );
+	}
+
+	return report.Finish( reportPath, didAllMatch );
+}
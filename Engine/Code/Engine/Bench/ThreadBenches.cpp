@@ -0,0 +1,353 @@
+#include "Engine/Bench/EngineBenches.hpp"
+#include "Engine/Bench/BenchCommon.hpp"
+#include "Engine/Core/TheConsole.hpp"
+#include "Engine/Jobs/JobSystem.hpp"
+#include "Engine/Jobs/RingQueues.hpp"
+#include "Engine/Renderer/Rgba.hpp"
+#include "Engine/EngineCommon.hpp"
+
+#include <deque>
+#include <math.h>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+
+//--------------------------------------------------------------------------------------------------------------
+struct JobBenchComputeKernel //Enough math per index that the work, not the scheduling, dominates.
+{
+	std::vector< float >* m_outputs;
+
+	void operator()( unsigned int index ) const
+	{
+		float value = (float)index;
+		for ( int step = 0; step < 64; step++ )
+			value = sqrtf( value * 1.0001f + (float)step );
+		( *m_outputs )[ index ] = value;
+	}
+};
+
+
+//--------------------------------------------------------------------------------------------------------------
+struct JobBenchEmptyKernel //One per job at a grain of 1, so the time is all scheduling overhead.
+{
+	std::vector< unsigned int >* m_outputs;
+
+	void operator()( unsigned int index ) const { ( *m_outputs )[ index ] = index; }
+};
+
+
+//--------------------------------------------------------------------------------------------------------------
+struct JobBenchCaveStep //The game of life cave rule on a byte grid, read from one buffer and written to the other so cells update in parallel.
+{
+	const std::vector< byte_t >* m_cells; //1 for air, the living type, else 0.
+	std::vector< byte_t >* m_nextCells;
+	int m_side;
+
+	void operator()( unsigned int cellIndex ) const
+	{
+		int cellX = (int)cellIndex % m_side;
+		int cellY = (int)cellIndex / m_side;
+
+		unsigned int numLivingNeighbors = 0;
+		for ( int y = cellY - 1; y <= cellY + 1; y++ )
+		{
+			for ( int x = cellX - 1; x <= cellX + 1; x++ )
+			{
+				bool isNeighbor = ( x != cellX || y != cellY ) && x >= 0 && y >= 0 && x < m_side && y < m_side;
+				if ( isNeighbor )
+					numLivingNeighbors += ( *m_cells )[ ( y * m_side ) + x ];
+			}
+		}
+
+		byte_t isAlive = ( *m_cells )[ cellIndex ];
+		if ( isAlive )
+			( *m_nextCells )[ cellIndex ] = ( numLivingNeighbors == 2 || numLivingNeighbors == 3 ) ? 1 : 0; //Else solitude or overpopulation.
+		else
+			( *m_nextCells )[ cellIndex ] = ( numLivingNeighbors == 3 ) ? 1 : 0; //Procreation.
+	}
+};
+
+
+//--------------------------------------------------------------------------------------------------------------
+static unsigned int RunJobBenchCaveGeneration( int side, int numSteps, double& out_seconds ) //Returns a hash of the cells, which must not depend on thread count.
+{
+	std::vector< byte_t > cells( side * side );
+	std::vector< byte_t > nextCells( side * side );
+	unsigned int state = 12345u;
+	for ( byte_t& cell : cells )
+	{
+		state = ( state * 1664525u ) + 1013904223u;
+		cell = ( ( state >> 16 ) % 2 == 0 ) ? 1 : 0;
+	}
+
+	BenchTimer timer;
+	for ( int stepNumber = 1; stepNumber <= numSteps; stepNumber++ )
+	{
+		JobBenchCaveStep step = { &cells, &nextCells, side };
+		ParallelFor( (unsigned int)cells.size(), 0, step );
+		cells.swap( nextCells );
+	}
+	out_seconds = timer.GetElapsedSeconds();
+
+	unsigned int hash = BENCH_HASH_SEED;
+	HashBenchText( hash, (const char*)cells.data(), cells.size() );
+	return hash;
+}
+
+
+//--------------------------------------------------------------------------------------------------------------
+STATIC bool EngineBenches::BenchmarkJobs( const std::string& reportPath, int numIterations )
+{
+	static const unsigned int NUM_COMPUTE_INDICES = 1 << 20;
+	static const unsigned int NUM_EMPTY_JOBS = 100000;
+	static const int CAVE_SIDE = 512;
+	static const int NUM_CAVE_STEPS = 5;
+
+	if ( numIterations < 1 )
+		numIterations = 1;
+
+	std::vector< int > threadCounts; //Powers of two, then every core.
+	int maxNumThreads = (int)std::thread::hardware_concurrency();
+	for ( int numThreads = 1; numThreads < maxNumThreads; numThreads *= 2 )
+		threadCounts.push_back( numThreads );
+	threadCounts.push_back( ( maxNumThreads > 1 ) ? maxNumThreads : 1 );
+
+	std::vector< float > computeOutputs( NUM_COMPUTE_INDICES );
+	std::vector< unsigned int > emptyOutputs( NUM_EMPTY_JOBS );
+	JobBenchComputeKernel computeKernel = { &computeOutputs };
+	JobBenchEmptyKernel emptyKernel = { &emptyOutputs };
+
+	BenchReport report;
+	report.Printf( "Headless jobbench: %u compute indices, %u single-index jobs, %d steps of a %dx%d cave, best of %d\n",
+				   NUM_COMPUTE_INDICES, NUM_EMPTY_JOBS, NUM_CAVE_STEPS, CAVE_SIDE, CAVE_SIDE, numIterations );
+
+	JobSystem* previousJobSystem = g_theJobSystem;
+	double serialComputeSeconds = 0.0;
+	double serialCaveSeconds = 0.0;
+	unsigned int serialCaveHash = 0;
+	bool didAllMatch = true;
+
+	for ( int numThreads : threadCounts )
+	{
+		g_theJobSystem = new JobSystem( numThreads - 1 ); //The calling thread is the other one.
+
+		BenchTiming computeTiming;
+		BenchTiming emptyTiming;
+		BenchTiming caveTiming;
+		unsigned int caveHash = 0;
+		for ( int iteration = 0; iteration < numIterations; iteration++ )
+		{
+			BenchTimer timer;
+			ParallelFor( NUM_COMPUTE_INDICES, 0, computeKernel );
+			computeTiming.AddPass( timer.GetElapsedSeconds() );
+
+			timer.Restart();
+			ParallelFor( NUM_EMPTY_JOBS, 1, emptyKernel );
+			emptyTiming.AddPass( timer.GetElapsedSeconds() );
+
+			double caveSeconds;
+			caveHash = RunJobBenchCaveGeneration( CAVE_SIDE, NUM_CAVE_STEPS, caveSeconds );
+			caveTiming.AddPass( caveSeconds );
+		}
+
+		double bestComputeSeconds = computeTiming.GetBestSeconds();
+		double bestEmptySeconds = emptyTiming.GetBestSeconds();
+		double bestCaveSeconds = caveTiming.GetBestSeconds();
+		if ( numThreads == 1 )
+		{
+			serialComputeSeconds = bestComputeSeconds;
+			serialCaveSeconds = bestCaveSeconds;
+			serialCaveHash = caveHash;
+		}
+		bool doesCaveMatch = ( caveHash == serialCaveHash );
+		didAllMatch = didAllMatch && doesCaveMatch;
+
+		unsigned int numJobsStolen = 0;
+		for ( unsigned int threadIndex = 0; threadIndex < g_theJobSystem->GetNumThreads(); threadIndex++ )
+			numJobsStolen += g_theJobSystem->GetNumJobsStolenByThread( threadIndex );
+
+		report.Printf( "%2d threads: compute %8.3f ms (%5.2fx), %6.0f ns per job, cave %8.3f ms (%5.2fx) %s, %u steals\n",
+					   numThreads, bestComputeSeconds * 1000.0, CalcSpeedup( serialComputeSeconds, bestComputeSeconds ),
+					   ( bestEmptySeconds / NUM_EMPTY_JOBS ) * 1000000000.0,
+					   bestCaveSeconds * 1000.0, CalcSpeedup( serialCaveSeconds, bestCaveSeconds ), doesCaveMatch ? "matches" : "DIFFERS", numJobsStolen );
+
+		delete g_theJobSystem;
+		g_theJobSystem = previousJobSystem;
+	}
+
+	return report.Finish( reportPath, didAllMatch );
+}
+
+
+
+//--------------------------------------------------------------------------------------------------------------
+enum QueueBenchKind { QUEUE_BENCH_MPSC_RING, QUEUE_BENCH_SPSC_RING, QUEUE_BENCH_LOCKED_DEQUE, NUM_QUEUE_BENCH_KINDS };
+static const char* s_QUEUE_BENCH_KIND_NAMES[ NUM_QUEUE_BENCH_KINDS ] = { "MpscRingQueue", "SpscRingQueue", "mutex + deque" };
+static const unsigned int QUEUE_BENCH_CAPACITY = 4096;
+
+
+//--------------------------------------------------------------------------------------------------------------
+struct QueueBenchQueues //Each run gets fresh ones, so no kind starts warm.
+{
+	QueueBenchQueues() : m_mpscRing( QUEUE_BENCH_CAPACITY ), m_spscRing( QUEUE_BENCH_CAPACITY ) {}
+
+	MpscRingQueue< unsigned int > m_mpscRing;
+	SpscRingQueue< unsigned int > m_spscRing;
+	std::mutex m_dequeMutex;
+	std::deque< unsigned int > m_deque;
+};
+
+
+//--------------------------------------------------------------------------------------------------------------
+static void RunQueueBenchProducer( QueueBenchKind kind, QueueBenchQueues* queues, unsigned int numValues )
+{
+	for ( unsigned int value = 1; value <= numValues; value++ )
+	{
+		if ( kind == QUEUE_BENCH_MPSC_RING )
+		{
+			while ( !queues->m_mpscRing.TryPush( value ) )
+				std::this_thread::yield();
+		}
+		else if ( kind == QUEUE_BENCH_SPSC_RING )
+		{
+			while ( !queues->m_spscRing.TryPush( value ) )
+				std::this_thread::yield();
+		}
+		else
+		{
+			std::lock_guard< std::mutex > lock( queues->m_dequeMutex );
+			queues->m_deque.push_back( value );
+		}
+	}
+}
+
+
+//--------------------------------------------------------------------------------------------------------------
+static double TimeQueueBench( QueueBenchKind kind, int numProducers, unsigned int numValuesPerProducer, uint64_t& out_sum )
+{
+	QueueBenchQueues* queues = new QueueBenchQueues();
+	std::vector< std::thread > producers;
+	uint64_t numValuesLeft = (uint64_t)numProducers * numValuesPerProducer;
+	out_sum = 0;
+
+	BenchTimer timer;
+	for ( int producerIndex = 0; producerIndex < numProducers; producerIndex++ )
+		producers.push_back( std::thread( RunQueueBenchProducer, kind, queues, numValuesPerProducer ) );
+
+	while ( numValuesLeft > 0 ) //This thread is the one consumer.
+	{
+		unsigned int value = 0;
+		bool didPop;
+		if ( kind == QUEUE_BENCH_MPSC_RING )
+		{
+			didPop = queues->m_mpscRing.TryPop( value );
+		}
+		else if ( kind == QUEUE_BENCH_SPSC_RING )
+		{
+			didPop = queues->m_spscRing.TryPop( value );
+		}
+		else
+		{
+			std::lock_guard< std::mutex > lock( queues->m_dequeMutex );
+			didPop = !queues->m_deque.empty();
+			if ( didPop )
+			{
+				value = queues->m_deque.front();
+				queues->m_deque.pop_front();
+			}
+		}
+
+		if ( didPop )
+		{
+			out_sum += value;
+			--numValuesLeft;
+		}
+		else
+		{
+			std::this_thread::yield();
+		}
+	}
+
+	for ( std::thread& producer : producers )
+		producer.join();
+	double seconds = timer.GetElapsedSeconds();
+
+	delete queues;
+	return seconds;
+}
+
+
+//--------------------------------------------------------------------------------------------------------------
+struct QueueBenchConsoleKernel
+{
+	void operator()( unsigned int index ) const { g_theConsole->Printf( "Worker line %u", index ); }
+};
+
+
+//--------------------------------------------------------------------------------------------------------------
+STATIC bool EngineBenches::BenchmarkQueues( const std::string& reportPath, int numIterations )
+{
+	static const unsigned int NUM_VALUES_PER_PRODUCER = 1000000;
+	static const unsigned int NUM_CONSOLE_LINES = 100000;
+
+	if ( numIterations < 1 )
+		numIterations = 1;
+
+	int maxNumProducers = (int)std::thread::hardware_concurrency() - 1; //Leaving a core for the consumer.
+	if ( maxNumProducers < 1 )
+		maxNumProducers = 1;
+
+	BenchReport report;
+	report.Printf( "Headless queuebench: %u values per producer, one consumer, best of %d\n", NUM_VALUES_PER_PRODUCER, numIterations );
+	bool didAllSum = true;
+
+	for ( int numProducers = 1; numProducers <= maxNumProducers; numProducers *= 2 )
+	{
+		for ( int kindIndex = 0; kindIndex < NUM_QUEUE_BENCH_KINDS; kindIndex++ )
+		{
+			if ( kindIndex == QUEUE_BENCH_SPSC_RING && numProducers > 1 )
+				continue;
+
+			BenchTiming timing;
+			uint64_t sum = 0;
+			for ( int iteration = 0; iteration < numIterations; iteration++ )
+				timing.AddPass( TimeQueueBench( (QueueBenchKind)kindIndex, numProducers, NUM_VALUES_PER_PRODUCER, sum ) );
+			double bestSeconds = timing.GetBestSeconds();
+
+			uint64_t expectedSum = (uint64_t)numProducers * ( (uint64_t)NUM_VALUES_PER_PRODUCER * ( NUM_VALUES_PER_PRODUCER + 1 ) / 2 );
+			didAllSum = didAllSum && ( sum == expectedSum );
+			double numMegaValuesPerSecond = ( (double)NUM_VALUES_PER_PRODUCER * numProducers / bestSeconds ) / 1000000.0;
+			report.Printf( "%2d producers, %-14s %8.3f ms, %7.2f M values/s%s\n", numProducers, s_QUEUE_BENCH_KIND_NAMES[ kindIndex ],
+						   bestSeconds * 1000.0, numMegaValuesPerSecond, ( sum == expectedSum ) ? "" : " LOST VALUES" );
+		}
+	}
+
+	//What the console pays per line now, drained in batches as TheEngine's Update would.
+	TheConsole* previousConsole = g_theConsole;
+	g_theConsole = new TheConsole( 0.0, 0.0, 0.0, 0.0, false, Rgba(), false, .25f, 0.3, nullptr ); //Never rendered, as in the HeadlessRunner ctor.
+	BenchTimer timer;
+	for ( unsigned int lineIndex = 0; lineIndex < NUM_CONSOLE_LINES; lineIndex++ )
+		g_theConsole->Printf( "Main line %u", lineIndex );
+	g_theConsole->DrainPendingMessages();
+	double mainThreadSeconds = timer.GetElapsedSeconds();
+
+	JobSystem* previousJobSystem = g_theJobSystem;
+	g_theJobSystem = new JobSystem();
+	QueueBenchConsoleKernel consoleKernel;
+	timer.Restart();
+	ParallelFor( NUM_CONSOLE_LINES, 0, consoleKernel );
+	g_theConsole->DrainPendingMessages();
+	double workerSeconds = timer.GetElapsedSeconds();
+	unsigned int numThreads = g_theJobSystem->GetNumThreads();
+	delete g_theJobSystem;
+	g_theJobSystem = previousJobSystem;
+	delete g_theConsole;
+	g_theConsole = previousConsole;
+
+	report.Printf( "Console Printf, main thread: %6.0f ns per line\n", ( mainThreadSeconds / NUM_CONSOLE_LINES ) * 1000000000.0 );
+	report.Printf( "Console Printf, %u job threads: %6.0f ns per line, lines the ring dropped are noted in the log\n",
+				   numThreads, ( workerSeconds / NUM_CONSOLE_LINES ) * 1000000000.0 );
+
+	return report.Finish( reportPath, didAllSum );
+}
@@ -1,6 +1,6 @@
 #include "Engine/Core/Command.hpp"
 #include "Engine/Renderer/Rgba.hpp"
-#include "Engine/String/StringUtils.hpp"
+#include "Engine/String/StringParsing.hpp"
 
 
 //--------------------------------------------------------------------------------------------------------------
@@ -8,43 +8,23 @@ Command::Command( const std::string& fullCommandString )
 	: m_currentArgsListPos( 0 )
 {
 	//Split fullCommandString, e.g. "SetColor .5 .5 .3 .2" into name "SetColor" and argsString/argsList.
-	m_commandName = "";
-	m_argsString = "";
-	char commandName[ 80 ];
-	char argsString[ 400 ];
-
-	int scanForNameResult = sscanf_s( fullCommandString.c_str(), "%s", commandName, _countof( commandName ) );
-	if ( scanForNameResult < 1 ) //Didn't match all args or returned -1 for EOF.
-	{
-		DebuggerPrintf( "Sscanf_s Failure for Name in Command()" );
-	}
-	else
+	StringTokenizer commandTokens( fullCommandString );
+	StringView commandName;
+	if ( !commandTokens.Next( commandName ) )
 	{
-		m_commandName = commandName;
+		DebuggerPrintf( "Command() found no name in \"%s\"\n", fullCommandString.c_str() );
+		return;
 	}
-	
-	//WARNING: if the args contain chars not in this regex, will cut off!!! The karat means up to and excluding what follows it.
-	int scanForArgsResult = sscanf_s( fullCommandString.c_str(), "%*s %[^\n]", argsString, _countof(argsString) );
-	if ( scanForArgsResult < 1 ) //Didn't match all args or returned -1 for EOF.
-	{
-		DebuggerPrintf( "Sscanf_s Found No Args in Command()\n\n" );
-	}
-	else
-	{
-		m_argsString = argsString;
-
-		std::string currentFormat = "%s";
-		char nextArg[ 80 ];
-		scanForArgsResult = sscanf_s( m_argsString.c_str(), currentFormat.c_str(), nextArg, _countof(nextArg) );
-		while ( scanForArgsResult > 0 ) //Until we no longer match.
-		{
-			m_argsList.push_back( nextArg );
+	m_commandName = commandName.ToString();
 
-			currentFormat.insert( 0, "%*s " );
+	//The rest of the first line, then split on whitespace into m_argsList.
+	StringView argsString = commandTokens.GetRemaining();
+	argsString = argsString.GetSubstring( 0, argsString.Find( '\n' ) ).GetTrimmed();
+	m_argsString = argsString.ToString();
 
-			scanForArgsResult = sscanf_s( m_argsString.c_str(), currentFormat.c_str(), nextArg, _countof(nextArg) );
-		}
-	}
+	StringView arg;
+	for ( StringTokenizer argTokens( argsString ); argTokens.Next( arg ); )
+		m_argsList.push_back( arg.ToString() );
 }
 
 
@@ -107,11 +87,10 @@ bool Command::GetNextColor( Rgba* out, Rgba defaultValue )
 //--------------------------------------------------------------------------------------------------------------
 bool Command::GetNextFloat( float* out, float defaultValue )
 {
-	std::string arg;
-	bool doesArgExist = GetNextString( &arg, nullptr ); //Check m_argsList for another.
+	bool doesArgExist = ( m_currentArgsListPos < m_argsList.size() );
 	if ( doesArgExist )
 	{
-		bool successfullyParsedAsFloat = ParseFloat( out, arg.c_str() );
+		bool successfullyParsedAsFloat = ParseFloat( out, m_argsList[ m_currentArgsListPos++ ].c_str() );
 		if ( successfullyParsedAsFloat )
 			return true;
 	}
@@ -125,11 +104,10 @@ bool Command::GetNextFloat( float* out, float defaultValue )
 //--------------------------------------------------------------------------------------------------------------
 bool Command::GetNextInt( int* out, int defaultValue )
 {
-	std::string arg;
-	bool doesArgExist = GetNextString( &arg, nullptr ); //Check m_argsList for another.
+	bool doesArgExist = ( m_currentArgsListPos < m_argsList.size() );
 	if ( doesArgExist )
 	{
-		bool successfullyParsedAsInt = ParseInt( out, arg.c_str() );
+		bool successfullyParsedAsInt = ParseInt( out, m_argsList[ m_currentArgsListPos++ ].c_str() );
 		if ( successfullyParsedAsInt )
 			return true;
 	}
@@ -161,14 +139,10 @@ bool Command::GetNextChar( char* out, char defaultValue )
 //--------------------------------------------------------------------------------------------------------------
 bool Command::ParseColor( Rgba* out, const char* arg ) const
 {
-	unsigned char r;
-	unsigned char g;
-	unsigned char b;
-	unsigned char a;
-	int scanResult = sscanf_s( arg, " %hhu %hhu %hhu %hhu ", &r, &g, &b, &a ); //hhu means uint.
-	if ( scanResult == 4 ) //4 matches.
+	Rgba color; //Opaque, for when arg leaves alpha off.
+	if ( ::ParseRgba( arg, color ) )
 	{
-		*out = Rgba( r, g, b, a );
+		*out = color;
 		return true;
 	}
 
@@ -179,30 +153,15 @@ bool Command::ParseColor( Rgba* out, const char* arg ) const
 //--------------------------------------------------------------------------------------------------------------
 bool Command::ParseFloat( float* out, const char* arg ) const
 {
-	float f;
-	int scanResult = sscanf_s( arg, " %f ", &f );
-	if ( scanResult == 1 ) //4 matches.
-	{
-		*out = f;
-		return true;
-	}
-
-	return false;
+	//As sscanf's " %f " did, any trailing junk is ignored.
+	return ParseFloatPrefix( StringView( arg ).GetTrimmed(), *out ) > 0;
 }
 
 
 //--------------------------------------------------------------------------------------------------------------
 bool Command::ParseInt( int* out, const char* arg ) const
 {
-	int i;
-	int scanResult = sscanf_s( arg, " %d ", &i );
-	if ( scanResult == 1 ) //4 matches.
-	{
-		*out = i;
-		return true;
-	}
-
-	return false;
+	return ParseIntPrefix( StringView( arg ).GetTrimmed(), *out ) > 0;
 }
 
 
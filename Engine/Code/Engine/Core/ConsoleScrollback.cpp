@@ -0,0 +1,183 @@
+#include "Engine/Core/ConsoleScrollback.hpp"
+#include "Engine/Error/ErrorWarningAssert.hpp"
+#include "Engine/EngineCommon.hpp"
+#include <ctype.h>
+#include <limits.h>
+#include <stdlib.h>
+#include <string.h>
+
+
+//--------------------------------------------------------------------------------------------------------------
+STATIC const unsigned int ConsoleScrollback::s_DEFAULT_CAPACITY_LINES = 2048;
+STATIC const unsigned int ConsoleScrollback::s_MAX_LINE_CHARS;
+static const unsigned int MAX_PALETTE_COLORS = 256; //What a byte indexes.
+
+
+//--------------------------------------------------------------------------------------------------------------
+TrigramSignature::TrigramSignature( const StringView& text )
+{
+	m_bits[ 0 ] = m_bits[ 1 ] = m_bits[ 2 ] = m_bits[ 3 ] = 0;
+	for ( size_t charIndex = 0; charIndex + 3 <= text.GetLength(); charIndex++ )
+	{
+		unsigned int trigramHash = ( tolower( (unsigned char)text[ charIndex ] ) * 961u )
+			^ ( tolower( (unsigned char)text[ charIndex + 1 ] ) * 31u ) ^ tolower( (unsigned char)text[ charIndex + 2 ] );
+		trigramHash = ( trigramHash * 2654435761u ) >> 24; //Top byte of a multiplicative hash, so nearby trigrams spread out.
+		m_bits[ trigramHash >> 6 ] |= ( 1ull << ( trigramHash & 63 ) );
+	}
+}
+
+
+//--------------------------------------------------------------------------------------------------------------
+bool TrigramSignature::Covers( const TrigramSignature& other ) const
+{
+	for ( int wordIndex = 0; wordIndex < 4; wordIndex++ )
+		if ( ( m_bits[ wordIndex ] & other.m_bits[ wordIndex ] ) != other.m_bits[ wordIndex ] )
+			return false;
+	return true;
+}
+
+
+//--------------------------------------------------------------------------------------------------------------
+ConsoleSearch::ConsoleSearch( const std::string& term )
+	: m_lowercaseTerm( term )
+{
+	for ( char& c : m_lowercaseTerm )
+		c = (char)tolower( (unsigned char)c );
+	m_signature = TrigramSignature( m_lowercaseTerm );
+}
+
+
+//--------------------------------------------------------------------------------------------------------------
+ConsoleScrollback::ConsoleScrollback( unsigned int capacityLines /*= s_DEFAULT_CAPACITY_LINES*/ )
+	: m_chars( new char[ capacityLines * s_MAX_LINE_CHARS ] )
+	, m_lines( new LineInfo[ capacityLines ] )
+	, m_capacityLines( capacityLines )
+	, m_oldestSlotIndex( 0 )
+	, m_numLines( 0 )
+	, m_numLinesEverAdded( 0 )
+{
+	GUARANTEE_OR_DIE( capacityLines > 0, "ConsoleScrollback needs room for at least one line!" );
+}
+
+
+//--------------------------------------------------------------------------------------------------------------
+ConsoleScrollback::~ConsoleScrollback()
+{
+	delete[] m_chars;
+	delete[] m_lines;
+}
+
+
+//--------------------------------------------------------------------------------------------------------------
+void ConsoleScrollback::AddLine( const StringView& text, const Rgba& color )
+{
+	unsigned int slotIndex;
+	if ( m_numLines < m_capacityLines )
+	{
+		slotIndex = GetSlotIndex( m_numLines );
+		++m_numLines;
+	}
+	else
+	{
+		slotIndex = m_oldestSlotIndex; //Overwrite the oldest, and the next oldest becomes line 0.
+		m_oldestSlotIndex = ( m_oldestSlotIndex + 1 ) % m_capacityLines;
+	}
+
+	size_t numChars = ( text.GetLength() < s_MAX_LINE_CHARS ) ? text.GetLength() : s_MAX_LINE_CHARS;
+	memcpy( &m_chars[ slotIndex * s_MAX_LINE_CHARS ], text.GetData(), numChars );
+	m_lines[ slotIndex ].m_length = (unsigned short)numChars;
+	m_lines[ slotIndex ].m_colorIndex = InternColor( color );
+	m_lines[ slotIndex ].m_signature = TrigramSignature( StringView( &m_chars[ slotIndex * s_MAX_LINE_CHARS ], numChars ) );
+	++m_numLinesEverAdded;
+}
+
+
+//--------------------------------------------------------------------------------------------------------------
+void ConsoleScrollback::Clear()
+{
+	m_oldestSlotIndex = 0;
+	m_numLines = 0;
+	++m_numLinesEverAdded; //Not strictly a line, but whoever caches by it needs to know.
+}
+
+
+//--------------------------------------------------------------------------------------------------------------
+StringView ConsoleScrollback::GetLineText( unsigned int lineIndex ) const
+{
+	ASSERT_OR_DIE( lineIndex < m_numLines, "ConsoleScrollback line index out of range!" );
+	unsigned int slotIndex = GetSlotIndex( lineIndex );
+	return StringView( &m_chars[ slotIndex * s_MAX_LINE_CHARS ], m_lines[ slotIndex ].m_length );
+}
+
+
+//--------------------------------------------------------------------------------------------------------------
+bool ConsoleScrollback::DoesLineMatch( unsigned int lineIndex, const ConsoleSearch& search ) const
+{
+	if ( search.IsEmpty() )
+		return false;
+
+	if ( !m_lines[ GetSlotIndex( lineIndex ) ].m_signature.Covers( search.m_signature ) )
+		return false; //Missing one of the term's trigrams, so no need to read the text.
+
+	StringView text = GetLineText( lineIndex );
+	const std::string& term = search.m_lowercaseTerm;
+	for ( size_t startIndex = 0; startIndex + term.size() <= text.GetLength(); startIndex++ )
+	{
+		size_t termIndex = 0;
+		while ( termIndex < term.size() && tolower( (unsigned char)text[ startIndex + termIndex ] ) == term[ termIndex ] )
+			++termIndex;
+		if ( termIndex == term.size() )
+			return true;
+	}
+	return false;
+}
+
+
+//--------------------------------------------------------------------------------------------------------------
+unsigned int ConsoleScrollback::CountMatchingLines( const ConsoleSearch& search, int* out_newestMatchingLineIndex /*= nullptr*/ ) const
+{
+	unsigned int numMatchingLines = 0;
+	int newestMatchingLineIndex = -1;
+	for ( unsigned int lineIndex = 0; lineIndex < m_numLines; lineIndex++ )
+	{
+		if ( DoesLineMatch( lineIndex, search ) )
+		{
+			++numMatchingLines;
+			newestMatchingLineIndex = (int)lineIndex;
+		}
+	}
+
+	if ( out_newestMatchingLineIndex != nullptr )
+		*out_newestMatchingLineIndex = newestMatchingLineIndex;
+	return numMatchingLines;
+}
+
+
+//--------------------------------------------------------------------------------------------------------------
+unsigned char ConsoleScrollback::InternColor( const Rgba& color )
+{
+	//Compares alpha too, unlike Rgba::operator==, so a faded color stays faded.
+	unsigned int nearestIndex = 0;
+	int nearestDistance = INT_MAX;
+	for ( unsigned int paletteIndex = 0; paletteIndex < m_palette.size(); paletteIndex++ )
+	{
+		const Rgba& candidate = m_palette[ paletteIndex ];
+		int distance = abs( candidate.red - color.red ) + abs( candidate.green - color.green )
+			+ abs( candidate.blue - color.blue ) + abs( candidate.alphaOpacity - color.alphaOpacity );
+		if ( distance == 0 )
+			return (unsigned char)paletteIndex;
+		if ( distance < nearestDistance )
+		{
+			nearestDistance = distance;
+			nearestIndex = paletteIndex;
+		}
+	}
+
+	if ( m_palette.size() < MAX_PALETTE_COLORS )
+	{
+		m_palette.push_back( color );
+		return (unsigned char)( m_palette.size() - 1 );
+	}
+
+	return (unsigned char)nearestIndex;
+}
@@ -0,0 +1,87 @@
+#pragma once
+
+
+#include "Engine/Renderer/Rgba.hpp"
+#include "Engine/String/StringView.hpp"
+#include <stdint.h>
+#include <string>
+#include <vector>
+
+
+//-----------------------------------------------------------------------------
+struct TrigramSignature //Which of 256 buckets a line's lowercase three-char runs hash into.
+{
+	TrigramSignature() { m_bits[ 0 ] = m_bits[ 1 ] = m_bits[ 2 ] = m_bits[ 3 ] = 0; }
+	explicit TrigramSignature( const StringView& text );
+	bool Covers( const TrigramSignature& other ) const; //False means text with other's trigrams can't be in this line.
+
+	uint64_t m_bits[ 4 ];
+};
+
+
+//-----------------------------------------------------------------------------
+class ConsoleSearch //A term prepared once to test against many lines.
+{
+public:
+	ConsoleSearch( const std::string& term ); //Matched case-insensitively.
+	const std::string& GetLowercaseTerm() const { return m_lowercaseTerm; }
+	bool IsEmpty() const { return m_lowercaseTerm.empty(); }
+
+
+private:
+	friend class ConsoleScrollback;
+	std::string m_lowercaseTerm;
+	TrigramSignature m_signature; //All zero for terms under three chars, which every line covers.
+};
+
+
+//-----------------------------------------------------------------------------
+// TheConsole's history: a fixed number of fixed-size lines in one block, allocated once. Once full, each new
+// line overwrites the oldest, so a long session costs no more memory or time per line than a short one.
+// Lines store a palette index rather than their Rgba, since a session only ever prints in a handful of colors.
+// Each line's trigram signature is taken as it's added, so a search skips most non-matching lines unread.
+//-----------------------------------------------------------------------------
+class ConsoleScrollback
+{
+public:
+	ConsoleScrollback( unsigned int capacityLines = s_DEFAULT_CAPACITY_LINES );
+	~ConsoleScrollback();
+
+	void AddLine( const StringView& text, const Rgba& color ); //Truncated past s_MAX_LINE_CHARS.
+	void Clear();
+
+	unsigned int GetNumLines() const { return m_numLines; }
+	unsigned int GetCapacityLines() const { return m_capacityLines; }
+	unsigned int GetNumLinesEverAdded() const { return m_numLinesEverAdded; } //Changes whenever the contents do, so callers can cache by it.
+	StringView GetLineText( unsigned int lineIndex ) const; //0 is the oldest line still held.
+	const Rgba& GetLineColor( unsigned int lineIndex ) const { return m_palette[ m_lines[ GetSlotIndex( lineIndex ) ].m_colorIndex ]; }
+
+	bool DoesLineMatch( unsigned int lineIndex, const ConsoleSearch& search ) const;
+	unsigned int CountMatchingLines( const ConsoleSearch& search, int* out_newestMatchingLineIndex = nullptr ) const; //-1 if none match.
+
+	static const unsigned int s_DEFAULT_CAPACITY_LINES;
+	static const unsigned int s_MAX_LINE_CHARS = 256;
+
+
+private:
+	struct LineInfo
+	{
+		TrigramSignature m_signature;
+		unsigned short m_length;
+		unsigned char m_colorIndex;
+	};
+
+	ConsoleScrollback( const ConsoleScrollback& );
+	void operator=( const ConsoleScrollback& );
+
+	unsigned int GetSlotIndex( unsigned int lineIndex ) const { return ( m_oldestSlotIndex + lineIndex ) % m_capacityLines; }
+	unsigned char InternColor( const Rgba& color ); //Past 256 colors, the nearest already interned.
+
+	char* m_chars; //s_MAX_LINE_CHARS per slot.
+	LineInfo* m_lines;
+	unsigned int m_capacityLines;
+	unsigned int m_oldestSlotIndex;
+	unsigned int m_numLines;
+	unsigned int m_numLinesEverAdded;
+	std::vector< Rgba > m_palette;
+};
@@ -1,15 +1,20 @@
 #include "Engine/Core/TheConsole.hpp"
+#include <ctype.h>
 #include <stdarg.h>
+#include <string.h>
 #include "Engine/Input/TheInput.hpp"
 #include "Engine/Renderer/BitmapFont.hpp"
 #include "Engine/Math/MathUtils.hpp"
 #include "Engine/EngineCommon.hpp"
 #include "Engine/Core/Command.hpp"
+#include "Engine/Time/Profiler.hpp"
 
 
 //--------------------------------------------------------------------------------------------------------------
 TheConsole* g_theConsole = nullptr;
 STATIC Rgba TheConsole::DEFAULT_COLOR;
+STATIC const unsigned int TheConsole::s_PENDING_MESSAGE_CAPACITY = 1024;
+static unsigned int s_numPrintedLines = 0; //Numbered as they're drained, so in the order the scrollback gets them.
 
 
 //--------------------------------------------------------------------------------------------------------------
@@ -87,6 +92,7 @@ void FindString( Command& args )
 	else
 	{
 		g_theConsole->ShouldPulseSearchResults( true, phraseToSearch );
+		g_theConsole->ReportSearchResults();
 	}
 }
 
@@ -94,24 +100,97 @@ void FindString( Command& args )
 //-----------------------------------------------------------------------------------------------
 void TheConsole::Printf( const char* messageFormat, ... )
 {
-	static unsigned int numInvocation = 0;
-	//Duplicating code from DebuggerPrintf() because it appears I'd need to do the same thing just to pass it to Stringf().
-	
-	const int MESSAGE_MAX_LENGTH = 2048;
-	char messageLiteral[ MESSAGE_MAX_LENGTH ];
+	InlineFormatBuffer< 256 > messageLiteral;
 	va_list variableArgumentList;
 	va_start( variableArgumentList, messageFormat );
-	vsnprintf_s( messageLiteral, MESSAGE_MAX_LENGTH, _TRUNCATE, messageFormat, variableArgumentList );
+	messageLiteral.AppendVPrintf( messageFormat, variableArgumentList );
 	va_end( variableArgumentList );
-	messageLiteral[ MESSAGE_MAX_LENGTH - 1 ] = '\0'; // In case vsnprintf overran (doesn't auto-terminate)
 
-	ROADMAP( "Make it push back a bool--probably turn into m_storedText into a container of structs--that flag whether up/down skips it." );
-	std::string finalMessage = std::to_string( ++numInvocation );
-	finalMessage += ": ";
-	finalMessage += messageLiteral;
-	m_storedText.push_back( std::pair< std::string, Rgba>( finalMessage, m_currentColor ) );
+	Print( messageLiteral.GetView() );
+}
+
+
+//-----------------------------------------------------------------------------------------------
+void TheConsole::Print( const StringView& message, const Rgba& color )
+{
+	ConsoleMessage pendingMessage;
+	pendingMessage.m_color = color;
+	pendingMessage.m_length = (unsigned short)( ( message.GetLength() < sizeof( pendingMessage.m_text ) ) ? message.GetLength() : sizeof( pendingMessage.m_text ) );
+	memcpy( pendingMessage.m_text, message.GetData(), pendingMessage.m_length );
+
+	if ( m_pendingMessages.TryPush( pendingMessage ) )
+		return;
+
+	if ( !IsOwningThread() )
+	{
+		m_numDroppedMessages.fetch_add( 1, std::memory_order_relaxed ); //Can't wait on the main thread, which may be waiting on this one.
+		return;
+	}
+
+	DrainPendingMessages();
+	m_pendingMessages.TryPush( pendingMessage );
+}
+
+
+//-----------------------------------------------------------------------------------------------
+void TheConsole::DrainPendingMessages()
+{
+	ROADMAP( "Flag lines that up/down history should skip, now that lines are structs in ConsoleScrollback." );
+	ConsoleMessage pendingMessage;
+	bool didAddLines = false;
+	while ( m_pendingMessages.TryPop( pendingMessage ) )
+	{
+		InlineFormatBuffer< ConsoleScrollback::s_MAX_LINE_CHARS + 1 > finalMessage; //"4294967295: " and a full m_text fill a line exactly, plus the terminator.
+		AppendUnsignedInt( finalMessage, ++s_numPrintedLines );
+		finalMessage.Append( ": ", 2 );
+		finalMessage.Append( pendingMessage.m_text, pendingMessage.m_length );
+		m_scrollback.AddLine( finalMessage.GetView(), pendingMessage.m_color );
+		didAddLines = true;
+	}
+
+	unsigned int numDroppedMessages = m_numDroppedMessages.exchange( 0, std::memory_order_relaxed );
+	if ( numDroppedMessages > 0 )
+	{
+		static const char DROPPED_NOTICE_FORMAT[] = "(%u lines from other threads dropped, the console ring was full.)";
+		InlineFormatBuffer< sizeof( DROPPED_NOTICE_FORMAT ) - 2 + 10 > droppedNotice; //%u becomes up to 10 digits, sizeof already counts the terminator.
+		droppedNotice.AppendPrintf( DROPPED_NOTICE_FORMAT, numDroppedMessages );
+		m_scrollback.AddLine( droppedNotice.GetView(), Rgba::RED );
+		didAddLines = true;
+	}
+
+	if ( didAddLines )
+		m_newestStoredTextIndexToRender = 0;
+}
+
+
+//-----------------------------------------------------------------------------------------------
+void TheConsole::ClearConsoleLog()
+{
+	ConsoleMessage discardedMessage;
+	while ( m_pendingMessages.TryPop( discardedMessage ) ) //Printed before the clear, so cleared too.
+	{
+	}
+
+	m_scrollback.Clear();
+	m_replacerPos = 0;
+}
+
+
+//--------------------------------------------------------------------------------------------------------------
+void TheConsole::ReportSearchResults()
+{
+	DrainPendingMessages(); //So lines printed this frame count too.
+
+	int newestMatchingLineIndex;
+	unsigned int numMatchingLines = m_scrollback.CountMatchingLines( m_searchResultToPulse, &newestMatchingLineIndex );
+	if ( numMatchingLines == 0 )
+	{
+		Printf( "No lines contain \"%s\".", m_searchResultToPulse.GetLowercaseTerm().c_str() );
+		return;
+	}
 
-	m_newestStoredTextIndexToRender = 0; // (int)m_storedText.size();
+	Printf( "%u of the last %u lines contain \"%s\", the newest being %u lines back.", numMatchingLines, m_scrollback.GetNumLines(),
+			m_searchResultToPulse.GetLowercaseTerm().c_str(), m_scrollback.GetNumLines() - 1 - (unsigned int)newestMatchingLineIndex );
 }
 
 
@@ -119,6 +198,8 @@ void TheConsole::Printf( const char* messageFormat, ... )
 //--------------------------------------------------------------------------------------------------------------
 void TheConsole::Render() //Recall up is +y.
 {
+	PROFILE_SCOPE( "TheConsole::Render" );
+
 	if ( !m_isVisible )
 		return;
 
@@ -152,7 +233,7 @@ void TheConsole::Render() //Recall up is +y.
 	//Sizes for the log: for each stored line of text add heightOfOneLinePx under the max, at which point cut the log off.
 	Vector2f currentLogBoxBottomRight = Vector2f( currentPromptBoxBottomRight.x, m_currentPromptBoxTopLeft.y + ( spacingPx * 2.f ) );
 	float totalHeightOfLinesInLogPx = 0.f;
-	for ( m_storedLinesToShowCount = 0; m_storedLinesToShowCount < m_storedText.size(); m_storedLinesToShowCount++ )
+	for ( m_storedLinesToShowCount = 0; m_storedLinesToShowCount < m_scrollback.GetNumLines(); m_storedLinesToShowCount++ )
 	{
 		if ( totalHeightOfLinesInLogPx + heightOfOneLinePx < m_maxConsoleHeightAsScreenPercentage )
 			totalHeightOfLinesInLogPx += heightOfOneLinePx;
@@ -184,19 +265,50 @@ void TheConsole::Render() //Recall up is +y.
 
 	//Print text from earlier stored entries: walk from the oldest one shown to the end, iterating forward.
 	if ( m_storedLinesToShowCount <= 0 ) return; //No stored text lines to print.
-	auto storedTextIterEnd = m_storedText.cend(); //This is the newest, bottom-most stored text line shown.
-	auto storedTextIterStart = m_storedText.cend() - m_storedLinesToShowCount; //This is the oldest.
-	if ( m_storedLinesToShowCount + m_newestStoredTextIndexToRender <= m_storedText.size() )
+	unsigned int endLineIndex = m_scrollback.GetNumLines(); //One past the newest, bottom-most stored text line shown.
+	if ( m_storedLinesToShowCount + m_newestStoredTextIndexToRender <= m_scrollback.GetNumLines() )
+		endLineIndex -= m_newestStoredTextIndexToRender;
+	unsigned int startLineIndex = endLineIndex - m_storedLinesToShowCount;
+	Vector2f topLeftInLog = Vector2f( consoleX + spacingPx * 2.f, m_currentLogBoxTopLeft.y - spacingPx - consoleY );
+	bool isPulsing = m_shouldPulseSearchResult && !m_searchResultToPulse.IsEmpty();
+
+	//Lines that stay put are laid out only when new lines arrive or the view moves, instead of every frame.
+	if ( !m_isLineQuadCacheValid || m_lineQuadCacheNumLinesEverAdded != m_scrollback.GetNumLinesEverAdded()
+		|| m_lineQuadCacheEndLineIndex != endLineIndex || m_lineQuadCacheNumLines != m_storedLinesToShowCount
+		|| m_lineQuadCacheTopLeft != topLeftInLog )
 	{
-		storedTextIterEnd -= m_newestStoredTextIndexToRender;
-		storedTextIterStart -= m_newestStoredTextIndexToRender;
+		m_lineQuadCache.Clear();
+		Vector2f positionInLog = topLeftInLog;
+		for ( unsigned int lineIndex = startLineIndex; lineIndex < endLineIndex; lineIndex++ )
+		{
+			if ( !isPulsing || !m_scrollback.DoesLineMatch( lineIndex, m_searchResultToPulse ) )
+				g_theRenderer->AppendTextProportional2D( m_lineQuadCache, positionInLog, m_scrollback.GetLineText( lineIndex ), m_currentScale, m_currentFont, m_scrollback.GetLineColor( lineIndex ) );
+			positionInLog.y -= heightOfOneLinePx; //Move caret down to next line.
+		}
+
+		m_isLineQuadCacheValid = true;
+		m_lineQuadCacheNumLinesEverAdded = m_scrollback.GetNumLinesEverAdded();
+		m_lineQuadCacheEndLineIndex = endLineIndex;
+		m_lineQuadCacheNumLines = m_storedLinesToShowCount;
+		m_lineQuadCacheTopLeft = topLeftInLog;
 	}
-	Vector2f positionInLog = Vector2f( consoleX + spacingPx * 2.f, m_currentLogBoxTopLeft.y - spacingPx - consoleY );
-	for ( auto storedTextIter = storedTextIterStart; storedTextIter != storedTextIterEnd; ++storedTextIter )
+	g_theRenderer->DrawTextQuadCache( m_lineQuadCache );
+
+	if ( !isPulsing )
+		return;
+
+	//Search results fade every frame, so they're left out of the cache and drawn here. Only visible lines are searched.
+	byte_t searchResultAlpha = static_cast<byte_t>( RangeMap( m_caretAlphaCounter, 0.f, 1.f, 0.f, 255.f ) );
+	Vector2f positionInLog = topLeftInLog;
+	for ( unsigned int lineIndex = startLineIndex; lineIndex < endLineIndex; lineIndex++ )
 	{
-		std::pair< std::string, Rgba > storedLine = *storedTextIter;
-		g_theRenderer->DrawTextProportional2D( positionInLog, storedLine.first, m_currentScale, m_currentFont, storedLine.second );
-		positionInLog.y -= heightOfOneLinePx; //Move caret down to next line.
+		if ( m_scrollback.DoesLineMatch( lineIndex, m_searchResultToPulse ) )
+		{
+			Rgba lineColor = m_scrollback.GetLineColor( lineIndex );
+			lineColor.alphaOpacity = searchResultAlpha;
+			g_theRenderer->DrawTextProportional2D( positionInLog, m_scrollback.GetLineText( lineIndex ), m_currentScale, m_currentFont, lineColor );
+		}
+		positionInLog.y -= heightOfOneLinePx;
 	}
 }
 
@@ -230,6 +342,8 @@ void TheConsole::RunCommand( const std::string& fullCommandString )
 //--------------------------------------------------------------------------------------------------------------
 void TheConsole::Update( float deltaSeconds )
 {
+	DrainPendingMessages();
+
 	if ( g_theInput->WasKeyPressedOnce( KEY_TO_OPEN_CONSOLE ) )
 		m_isVisible = !m_isVisible;
 
@@ -244,24 +358,9 @@ void TheConsole::Update( float deltaSeconds )
 		{
 			if ( mouseWheelDelta < 0 && m_newestStoredTextIndexToRender - 1 >= 0 )
 				m_newestStoredTextIndexToRender--;
-			else if ( mouseWheelDelta > 0 && m_storedLinesToShowCount + m_newestStoredTextIndexToRender + 1 <= (int)m_storedText.size() )
+			else if ( mouseWheelDelta > 0 && m_storedLinesToShowCount + m_newestStoredTextIndexToRender + 1 <= m_scrollback.GetNumLines() )
 				m_newestStoredTextIndexToRender++;
 		}
-
-		//Search result pulse update.
-		if ( m_shouldPulseSearchResult && m_searchResultToPulse != "" )
-		{
-			auto storedTextIterEnd = m_storedText.end();
-			for ( auto storedTextIter = m_storedText.begin(); storedTextIter != storedTextIterEnd; ++storedTextIter )
-			{
-				std::pair< std::string, Rgba >& currentLine = *storedTextIter;
-				std::string currentLineLowercase = GetAsLowercase( currentLine.first );
-				if ( currentLineLowercase.find( m_searchResultToPulse ) != std::string::npos )
-				{
-					currentLine.second.alphaOpacity = static_cast<unsigned char>( RangeMap( m_caretAlphaCounter, 0.f, 1.f, 0.f, 255.f ) );
-				}
-			}
-		}
 	}
 
 }
@@ -299,30 +398,30 @@ void TheConsole::UpdatePromptForKeydown( unsigned char ch )
 		if ( m_replacerPos - 1 >= 0 )
 		{
 			m_replacerPos--;
-			m_currentPromptString = m_storedText[ m_replacerPos ].first;
+			m_currentPromptString = m_scrollback.GetLineText( m_replacerPos ).ToString();
 			m_caretPosInInputString = m_currentPromptString.size();
 		}
 		else
 		{
-			if ( m_storedText.size() > 0 )
+			if ( m_scrollback.GetNumLines() > 0 )
 			{
-				m_currentPromptString = m_storedText[ m_replacerPos ].first;
+				m_currentPromptString = m_scrollback.GetLineText( m_replacerPos ).ToString();
 				m_caretPosInInputString = m_currentPromptString.size();
 			}
 		}
 		break;
 	case VK_DOWN:
-		if ( m_replacerPos + 1 < (int)m_storedText.size() )
+		if ( m_replacerPos + 1 < (int)m_scrollback.GetNumLines() )
 		{
 			m_replacerPos++;
-			m_currentPromptString = m_storedText[ m_replacerPos ].first;
+			m_currentPromptString = m_scrollback.GetLineText( m_replacerPos ).ToString();
 			m_caretPosInInputString = m_currentPromptString.size();
 		}
 		else
 		{
-			if ( m_storedText.size() > 0 )
+			if ( m_scrollback.GetNumLines() > 0 )
 			{
-				m_currentPromptString = m_storedText[ m_replacerPos ].first;
+				m_currentPromptString = m_scrollback.GetLineText( m_replacerPos ).ToString();
 				m_caretPosInInputString = m_currentPromptString.size();
 			}
 		}
@@ -349,7 +448,7 @@ void TheConsole::LowerShownLines()
 //--------------------------------------------------------------------------------------------------------------
 void TheConsole::RaiseShownLines()
 {
-	if ( m_storedLinesToShowCount + m_newestStoredTextIndexToRender + 1 <= (int)m_storedText.size() )
+	if ( m_storedLinesToShowCount + m_newestStoredTextIndexToRender + 1 <= m_scrollback.GetNumLines() )
 		m_newestStoredTextIndexToRender++;
 }
 
@@ -357,30 +456,16 @@ void TheConsole::RaiseShownLines()
 //--------------------------------------------------------------------------------------------------------------
 void TheConsole::ShouldPulseSearchResults( bool newVal, const std::string& term )
 {
-	if ( m_searchResultToPulse != "" &&  m_searchResultToPulse != term )
-	{
-		//Cleanup transparencies.
-		auto storedTextIterEnd = m_storedText.end();
-		for ( auto storedTextIter = m_storedText.begin(); storedTextIter != storedTextIterEnd; ++storedTextIter )
-		{
-			std::pair< std::string, Rgba >& currentLine = *storedTextIter;
-			std::string currentLineLowercase = GetAsLowercase( currentLine.first );
-			if ( currentLineLowercase.find( m_searchResultToPulse ) != std::string::npos )
-			{
-				currentLine.second.alphaOpacity = 255;
-			}
-		}
-	}
-
 	m_shouldPulseSearchResult = newVal; 
-	m_searchResultToPulse = GetAsLowercase( term );
+	m_searchResultToPulse = ConsoleSearch( term );
+	m_isLineQuadCacheValid = false; //Which lines it holds depends on the search.
 }
 
 
 //--------------------------------------------------------------------------------------------------------------
 void TheConsole::UpdatePromptForChar( unsigned char ch )
 {
-	unsigned int indexOfNewestStoredText = ( m_storedText.size() > 0 ) ? m_storedText.size() - 1 : 0;
+	unsigned int indexOfNewestStoredText = ( m_scrollback.GetNumLines() > 0 ) ? m_scrollback.GetNumLines() - 1 : 0;
 	switch ( ch )
 	{
 		case VK_ENTER: 
@@ -426,10 +511,12 @@ void TheConsole::AttemptAutocomplete( const std::map< std::string, ConsoleComman
 	const std::string originalLastAutocompleteInput = m_lastAutocompleteInput; //Each recursion iteration will have its own, no fear of overwriting.
 	unsigned int consoleIndex = 0; //Can't index into a map but by keys, yet we need index below nonetheless.
 	auto candidateIterEnd = s_theConsoleCommands.cend();
-	auto candidateIterStart = ( lastResultIter == nullptr ) ? s_theConsoleCommands.cbegin() : *lastResultIter; //Begin after the last result.
+	auto candidateIterStart = ( lastResultIter == nullptr ) ? s_theConsoleCommands.lower_bound( m_currentPromptString ) : *lastResultIter; //Keys are sorted, so this is the first that could share the prefix.
 	for ( auto candidateIter = candidateIterStart; candidateIter != candidateIterEnd; ++candidateIter, ++consoleIndex )
 	{
 		const std::string& candidateName = candidateIter->first;
+		if ( candidateName.compare( 0, m_currentPromptString.size(), m_currentPromptString ) > 0 )
+			break; //Sorted past every name with the prefix, so no later one can match either.
 		if ( candidateName == m_currentPromptString )
 		{
 			//Because full the command matches, presume user wants the next.
@@ -7,6 +7,11 @@
 #include "Engine/Renderer/Rgba.hpp"
 #include "Engine/Math/AABB2.hpp"
 #include "Engine/Renderer/TheRenderer.hpp"
+#include "Engine/String/StringFormat.hpp"
+#include "Engine/Core/ConsoleScrollback.hpp"
+#include "Engine/Jobs/RingQueues.hpp"
+#include <atomic>
+#include <thread>
 
 
 //--------------------------------------------------------------------------------------------------------------
@@ -33,6 +38,21 @@ void SetColor( Command& args );
 void FindString( Command& args );
 
 
+//--------------------------------------------------------------------------------------------------------------
+struct ConsoleMessage //One slot of TheConsole's pending ring, so printing from any thread never allocates.
+{
+	Rgba m_color;
+	unsigned short m_length;
+	char m_text[ ConsoleScrollback::s_MAX_LINE_CHARS - 12 ]; //Leaves room for the "4294967295: " line number.
+};
+
+
+//--------------------------------------------------------------------------------------------------------------
+// Print, Printf, and Format may be called from any thread: they copy the line into a lock-free ring, and the thread
+// that constructed the console moves them into the scrollback at the top of each Update. If the ring fills, that
+// thread drains it on the spot, while other threads drop the line and it's counted in the log instead.
+// Other threads print in the constructor's text color unless they pass one, as SetTextColor only affects its own thread.
+// Everything else, e.g. SetTextColor and RunCommand, is for the constructing thread only.
 //--------------------------------------------------------------------------------------------------------------
 class TheConsole
 {
@@ -42,23 +62,28 @@ public:
 				bool showPromptBox = true,
 				const Rgba& textColor = Rgba(), bool isVisible = false, float textScale = .25f,
 				double maxConsoleHeightCoverageNormalized = 0.3, BitmapFont* font = g_theRenderer->GetDefaultFont() )
-		: m_currentColor( textColor )
-		, m_isVisible( isVisible )
-		, m_currentScale( textScale )
+		: m_pendingMessages( s_PENDING_MESSAGE_CAPACITY )
+		, m_numDroppedMessages( 0 )
+		, m_owningThreadID( std::this_thread::get_id() )
+		, m_otherThreadColor( textColor )
 		, m_consoleX( consoleX )
 		, m_consoleY( consoleY )
 		, m_consoleWidth( consoleWidth )
 		, m_maxConsoleHeightAsScreenPercentage( screenHeight * maxConsoleHeightCoverageNormalized )
+		, m_showPromptBox( showPromptBox )
 		, m_currentFont( font )
 		, m_hasFontChanged( false )
+		, m_currentColor( textColor )
+		, m_currentScale( textScale )
+		, m_isVisible( isVisible )
+		, m_shouldPulseSearchResult( false )
+		, m_searchResultToPulse( "" )
 		, m_caretAlphaCounter( 0.f )
 		, m_replacerPos( 0 )
 		, m_caretPosInInputString( 0 )
 		, m_newestStoredTextIndexToRender( 0 )
 		, m_storedLinesToShowCount( 0 )
-		, m_shouldPulseSearchResult( false )
-		, m_searchResultToPulse( "" )
-		, m_showPromptBox( showPromptBox )
+		, m_isLineQuadCacheValid( false )
 	{
 		DEFAULT_COLOR = m_currentColor;
 
@@ -71,8 +96,12 @@ public:
 	void RegisterCommand( const std::string& name, ConsoleCommandCallback* cb );
 	void RunCommand( const std::string& fullCommandString );
 	void Printf( const char* format, ... ); //Trigger this on VK_ENTER from command prompt.
+	void Print( const StringView& message ) { Print( message, IsOwningThread() ? m_currentColor : m_otherThreadColor ); } //As is, no formatting.
+	void Print( const StringView& message, const Rgba& color ); //For other threads, which shouldn't touch SetTextColor.
+	void DrainPendingMessages(); //Update calls this, so only needed to see lines printed since in the same frame.
+	template< typename... Args > void Format( const char* format, const Args&... args ); //AppendFormat's {} syntax, so CHECKED_FORMAT works.
 	void SetTextColor( const Rgba& newColor = DEFAULT_COLOR ) { m_currentColor = newColor; }
-	void SetFont( BitmapFont* newFont ) { m_currentFont = newFont; m_hasFontChanged = true; }
+	void SetFont( BitmapFont* newFont ) { m_currentFont = newFont; m_hasFontChanged = true; m_isLineQuadCacheValid = false; }
 	void ShowConsole() { m_isVisible = true; }
 	void HideConsole() { m_isVisible = false; }
 	bool IsVisible() const { return m_isVisible; }
@@ -84,17 +113,24 @@ public:
 	void LowerShownLines();
 	void RaiseShownLines();
 
-	void ClearConsoleLog() { m_storedText.clear(); m_replacerPos = 0; }
+	void ClearConsoleLog();
 	void ShouldPulseSearchResults( bool newVal, const std::string& term );
+	void ReportSearchResults(); //Prints how many held lines match the current search, not just the visible ones.
 	void AttemptAutocomplete( const std::map< std::string, ConsoleCommandCallback* >::const_iterator* indexOfLastResult = nullptr );
 	void ShowPrompt() { m_showPromptBox = true; }
 	void HidePrompt() { m_showPromptBox = false; }
 
 	static Rgba DEFAULT_COLOR;
+	static const unsigned int s_PENDING_MESSAGE_CAPACITY; //Lines printed per frame before the constructing thread drains early.
 
 private:
+	bool IsOwningThread() const { return std::this_thread::get_id() == m_owningThreadID; }
 
-	std::vector< std::pair< std::string, Rgba > > m_storedText;
+	ConsoleScrollback m_scrollback;
+	MpscRingQueue< ConsoleMessage > m_pendingMessages;
+	std::atomic< unsigned int > m_numDroppedMessages; //By other threads, since the last drain.
+	std::thread::id m_owningThreadID;
+	const Rgba m_otherThreadColor; //The constructor's text color, since other threads mustn't read m_currentColor while SetTextColor writes it.
 
 	Vector2f m_currentLogBoxTopLeft;
 	Vector2f m_currentPromptBoxTopLeft;
@@ -113,7 +149,7 @@ private:
 	float m_currentScale;
 	bool m_isVisible;
 	bool m_shouldPulseSearchResult;
-	std::string m_searchResultToPulse;
+	ConsoleSearch m_searchResultToPulse;
 	std::string m_lastAutocompleteInput;
 
 	float m_caretAlphaCounter;
@@ -121,4 +157,22 @@ private:
 	int m_caretPosInInputString;
 	int m_newestStoredTextIndexToRender; //i.e. bottom-most.
 	unsigned int m_storedLinesToShowCount;
-};
\ No newline at end of file
+
+	//The visible log lines' glyph quads, rebuilt only when what they were built from changes, not every frame.
+	TextQuadCache m_lineQuadCache;
+	bool m_isLineQuadCacheValid; //False on font or search changes, which the keys below don't catch.
+	unsigned int m_lineQuadCacheNumLinesEverAdded;
+	unsigned int m_lineQuadCacheEndLineIndex;
+	unsigned int m_lineQuadCacheNumLines;
+	Vector2f m_lineQuadCacheTopLeft;
+};
+
+
+//--------------------------------------------------------------------------------------------------------------
+template< typename... Args >
+inline void TheConsole::Format( const char* format, const Args&... args )
+{
+	InlineFormatBuffer< 256 > message;
+	AppendFormat( message, format, args... );
+	Print( message.GetView() );
+}
@@ -0,0 +1,346 @@
+#include "Engine/FileUtils/Compression.hpp"
+
+#include "Engine/FileUtils/Writers/BinaryWriter.hpp"
+#include "Engine/FileUtils/Readers/BinaryReader.hpp"
+#include "Engine/Math/MathUtils.hpp"
+
+#include <string.h>
+
+
+//--------------------------------------------------------------------------------------------------------------
+static const size_t RLE_MAX_LITERAL_RUN = 128; //Control byte 0-127: that many plus one literal bytes follow.
+static const size_t RLE_MAX_REPEAT_RUN = 129; //Control byte 128-255: the next byte repeats (control - 126) times.
+static const size_t RLE_MIN_REPEAT_RUN = 3; //A run of two costs the same either way, so stays literal.
+
+static const size_t LZ_MIN_MATCH = 4;
+static const size_t LZ_MAX_OFFSET = 65535;
+static const unsigned int LZ_HASH_BITS = 12;
+static const uint32_t LZ_NO_POSITION = 0xFFFFFFFF;
+static const byte_t LZ_NIBBLE_MAX = 15; //Token nibbles saturate here, and the rest of the length follows in 255-capped bytes.
+
+static const uint32_t MAX_BLOCK_BYTES = 256 * 1024 * 1024; //Far past any save section, so a corrupt size fails the read, not the allocation.
+
+
+//--------------------------------------------------------------------------------------------------------------
+const char* GetCompressionCodecName( CompressionCodec codec )
+{
+	switch ( codec )
+	{
+		case COMPRESSION_CODEC_NONE: return "None";
+		case COMPRESSION_CODEC_RLE: return "RLE";
+		case COMPRESSION_CODEC_LZ: return "LZ";
+		default: return "Unknown";
+	}
+}
+
+
+//--------------------------------------------------------------------------------------------------------------
+unsigned int CalcBlockChecksum( const void* data, size_t numBytes ) //FNV-1a.
+{
+	const byte_t* bytes = (const byte_t*)data;
+	unsigned int checksum = 2166136261u;
+	for ( size_t byteIndex = 0; byteIndex < numBytes; byteIndex++ )
+	{
+		checksum ^= bytes[ byteIndex ];
+		checksum *= 16777619u;
+	}
+	return checksum;
+}
+
+
+//--------------------------------------------------------------------------------------------------------------
+void CompressRLE( const byte_t* source, size_t numSourceBytes, std::vector< byte_t >& out_compressed )
+{
+	size_t position = 0;
+	while ( position < numSourceBytes )
+	{
+		size_t runLength = 1;
+		while ( position + runLength < numSourceBytes && runLength < RLE_MAX_REPEAT_RUN && source[ position + runLength ] == source[ position ] )
+			++runLength;
+
+		if ( runLength >= RLE_MIN_REPEAT_RUN )
+		{
+			out_compressed.push_back( (byte_t)( runLength + 126 ) );
+			out_compressed.push_back( source[ position ] );
+			position += runLength;
+			continue;
+		}
+
+		//Literals until the next run worth encoding.
+		size_t literalStart = position;
+		while ( position < numSourceBytes && position - literalStart < RLE_MAX_LITERAL_RUN )
+		{
+			bool startsRun = ( position + 2 < numSourceBytes ) && source[ position ] == source[ position + 1 ] && source[ position ] == source[ position + 2 ];
+			if ( startsRun )
+				break;
+			++position;
+		}
+
+		out_compressed.push_back( (byte_t)( position - literalStart - 1 ) );
+		out_compressed.insert( out_compressed.end(), source + literalStart, source + position );
+	}
+}
+
+
+//--------------------------------------------------------------------------------------------------------------
+bool DecompressRLE( const byte_t* source, size_t numSourceBytes, byte_t* dest, size_t numDestBytes )
+{
+	size_t sourcePosition = 0;
+	size_t destPosition = 0;
+	while ( sourcePosition < numSourceBytes )
+	{
+		byte_t control = source[ sourcePosition++ ];
+		if ( control < 128 )
+		{
+			size_t numLiterals = (size_t)control + 1;
+			if ( sourcePosition + numLiterals > numSourceBytes || destPosition + numLiterals > numDestBytes )
+				return false;
+
+			memcpy( dest + destPosition, source + sourcePosition, numLiterals );
+			sourcePosition += numLiterals;
+			destPosition += numLiterals;
+		}
+		else
+		{
+			size_t runLength = (size_t)control - 126;
+			if ( sourcePosition >= numSourceBytes || destPosition + runLength > numDestBytes )
+				return false;
+
+			memset( dest + destPosition, source[ sourcePosition++ ], runLength );
+			destPosition += runLength;
+		}
+	}
+
+	return destPosition == numDestBytes;
+}
+
+
+//--------------------------------------------------------------------------------------------------------------
+static void WriteLZLengthTail( std::vector< byte_t >& out_compressed, size_t length ) //What didn't fit in the token's nibble.
+{
+	length -= LZ_NIBBLE_MAX;
+	while ( length >= 255 )
+	{
+		out_compressed.push_back( 255 );
+		length -= 255;
+	}
+	out_compressed.push_back( (byte_t)length );
+}
+
+
+//--------------------------------------------------------------------------------------------------------------
+static void WriteLZSequence( std::vector< byte_t >& out_compressed, const byte_t* literals, size_t numLiterals, size_t matchOffset, size_t matchLength )
+{
+	//Token: literal count in the high nibble, match length past the minimum in the low. The last sequence has no match.
+	size_t matchLengthCode = ( matchLength > 0 ) ? ( matchLength - LZ_MIN_MATCH ) : 0;
+	byte_t token = (byte_t)( ( GetMin( numLiterals, (size_t)LZ_NIBBLE_MAX ) << 4 ) | GetMin( matchLengthCode, (size_t)LZ_NIBBLE_MAX ) );
+	out_compressed.push_back( token );
+
+	if ( numLiterals >= LZ_NIBBLE_MAX )
+		WriteLZLengthTail( out_compressed, numLiterals );
+	out_compressed.insert( out_compressed.end(), literals, literals + numLiterals );
+
+	if ( matchLength == 0 )
+		return;
+
+	out_compressed.push_back( (byte_t)( matchOffset & 0xFF ) );
+	out_compressed.push_back( (byte_t)( matchOffset >> 8 ) );
+	if ( matchLengthCode >= LZ_NIBBLE_MAX )
+		WriteLZLengthTail( out_compressed, matchLengthCode );
+}
+
+
+//--------------------------------------------------------------------------------------------------------------
+void CompressLZ( const byte_t* source, size_t numSourceBytes, std::vector< byte_t >& out_compressed )
+{
+	//Greedy: each 4-byte sequence is hashed to where it was last seen, and any match found there is extended as far as it goes.
+	uint32_t lastPositionForHash[ 1 << LZ_HASH_BITS ];
+	memset( lastPositionForHash, 0xFF, sizeof( lastPositionForHash ) );
+
+	size_t literalStart = 0;
+	size_t position = 0;
+	while ( position + LZ_MIN_MATCH <= numSourceBytes )
+	{
+		uint32_t sequence;
+		memcpy( &sequence, source + position, sizeof( sequence ) );
+		uint32_t hash = ( sequence * 2654435761u ) >> ( 32 - LZ_HASH_BITS );
+
+		uint32_t candidate = lastPositionForHash[ hash ];
+		lastPositionForHash[ hash ] = (uint32_t)position;
+
+		bool isMatch = ( candidate != LZ_NO_POSITION ) && ( position - candidate <= LZ_MAX_OFFSET )
+			&& memcmp( source + candidate, source + position, LZ_MIN_MATCH ) == 0;
+		if ( !isMatch )
+		{
+			++position;
+			continue;
+		}
+
+		size_t matchLength = LZ_MIN_MATCH;
+		while ( position + matchLength < numSourceBytes && source[ candidate + matchLength ] == source[ position + matchLength ] )
+			++matchLength;
+
+		WriteLZSequence( out_compressed, source + literalStart, position - literalStart, position - candidate, matchLength );
+		position += matchLength;
+		literalStart = position;
+	}
+
+	WriteLZSequence( out_compressed, source + literalStart, numSourceBytes - literalStart, 0, 0 );
+}
+
+
+//--------------------------------------------------------------------------------------------------------------
+static bool ReadLZLengthTail( const byte_t* source, size_t numSourceBytes, size_t& inout_sourcePosition, size_t& inout_length )
+{
+	byte_t lengthByte;
+	do
+	{
+		if ( inout_sourcePosition >= numSourceBytes )
+			return false;
+		lengthByte = source[ inout_sourcePosition++ ];
+		inout_length += lengthByte;
+	} while ( lengthByte == 255 );
+
+	return true;
+}
+
+
+//--------------------------------------------------------------------------------------------------------------
+bool DecompressLZ( const byte_t* source, size_t numSourceBytes, byte_t* dest, size_t numDestBytes )
+{
+	size_t sourcePosition = 0;
+	size_t destPosition = 0;
+	while ( sourcePosition < numSourceBytes )
+	{
+		byte_t token = source[ sourcePosition++ ];
+
+		size_t numLiterals = token >> 4;
+		if ( numLiterals == LZ_NIBBLE_MAX && !ReadLZLengthTail( source, numSourceBytes, sourcePosition, numLiterals ) )
+			return false;
+		if ( sourcePosition + numLiterals > numSourceBytes || destPosition + numLiterals > numDestBytes )
+			return false;
+
+		memcpy( dest + destPosition, source + sourcePosition, numLiterals );
+		sourcePosition += numLiterals;
+		destPosition += numLiterals;
+
+		if ( sourcePosition == numSourceBytes )
+			break; //The last sequence is literals only.
+
+		if ( sourcePosition + 2 > numSourceBytes )
+			return false;
+		size_t matchOffset = source[ sourcePosition ] | ( (size_t)source[ sourcePosition + 1 ] << 8 );
+		sourcePosition += 2;
+
+		size_t matchLength = token & 0x0F;
+		if ( matchLength == LZ_NIBBLE_MAX && !ReadLZLengthTail( source, numSourceBytes, sourcePosition, matchLength ) )
+			return false;
+		matchLength += LZ_MIN_MATCH;
+
+		if ( matchOffset == 0 || matchOffset > destPosition || destPosition + matchLength > numDestBytes )
+			return false;
+
+		//Forward byte copy on purpose: an offset shorter than the match repeats the bytes it just wrote.
+		const byte_t* matchSource = dest + destPosition - matchOffset;
+		for ( size_t matchIndex = 0; matchIndex < matchLength; matchIndex++ )
+			dest[ destPosition + matchIndex ] = matchSource[ matchIndex ];
+		destPosition += matchLength;
+	}
+
+	return destPosition == numDestBytes;
+}
+
+
+//--------------------------------------------------------------------------------------------------------------
+CompressionCodec WriteCompressedBlock( BinaryWriter& writer, const void* rawData, size_t numRawBytes )
+{
+	const byte_t* rawBytes = (const byte_t*)rawData;
+
+	std::vector< byte_t > rleBytes;
+	std::vector< byte_t > lzBytes;
+	CompressRLE( rawBytes, numRawBytes, rleBytes );
+	CompressLZ( rawBytes, numRawBytes, lzBytes );
+
+	CompressionCodec codec = COMPRESSION_CODEC_NONE;
+	const byte_t* storedBytes = rawBytes;
+	size_t numStoredBytes = numRawBytes;
+	if ( rleBytes.size() < numStoredBytes )
+	{
+		codec = COMPRESSION_CODEC_RLE;
+		storedBytes = rleBytes.data();
+		numStoredBytes = rleBytes.size();
+	}
+	if ( lzBytes.size() < numStoredBytes )
+	{
+		codec = COMPRESSION_CODEC_LZ;
+		storedBytes = lzBytes.data();
+		numStoredBytes = lzBytes.size();
+	}
+
+	writer.Write<byte_t>( (byte_t)codec );
+	writer.Write<uint32_t>( (uint32_t)numRawBytes );
+	writer.Write<uint32_t>( (uint32_t)numStoredBytes );
+	writer.Write<uint32_t>( CalcBlockChecksum( rawBytes, numRawBytes ) );
+	if ( numStoredBytes > 0 )
+		writer.WriteBytes( storedBytes, numStoredBytes );
+
+	return codec;
+}
+
+
+//--------------------------------------------------------------------------------------------------------------
+static uint64_t CalcMaxDecodedBytes( CompressionCodec codec, uint32_t numStoredBytes ) //The most raw bytes a codec can get from that many stored.
+{
+	switch ( codec )
+	{
+		case COMPRESSION_CODEC_NONE: return numStoredBytes;
+		case COMPRESSION_CODEC_RLE: return ( ( numStoredBytes / 2 ) + 1 ) * (uint64_t)RLE_MAX_REPEAT_RUN; //Two stored bytes per repeat run.
+		case COMPRESSION_CODEC_LZ: return numStoredBytes * (uint64_t)256; //Each length tail byte adds at most 255, plus what the token and offset encode.
+		default: return 0;
+	}
+}
+
+
+//--------------------------------------------------------------------------------------------------------------
+bool ReadCompressedBlock( BinaryReader& reader, std::vector< byte_t >& out_rawBytes )
+{
+	byte_t codecAsByte = 0;
+	uint32_t numRawBytes = 0;
+	uint32_t numStoredBytes = 0;
+	uint32_t checksum = 0;
+	if ( !reader.Read<byte_t>( &codecAsByte ) || !reader.Read<uint32_t>( &numRawBytes ) || !reader.Read<uint32_t>( &numStoredBytes ) || !reader.Read<uint32_t>( &checksum ) )
+		return false;
+
+	//Sizes come straight from the file, so check them before allocating for them.
+	if ( numRawBytes > MAX_BLOCK_BYTES || numStoredBytes > MAX_BLOCK_BYTES || numRawBytes > CalcMaxDecodedBytes( (CompressionCodec)codecAsByte, numStoredBytes ) )
+		return false;
+
+	//Straight from the mapping or buffer when the reader can, else copied.
+	std::vector< byte_t > copiedStoredBytes;
+	const byte_t* storedBytes = (const byte_t*)reader.ReadBytesInPlace( numStoredBytes );
+	if ( storedBytes == nullptr && numStoredBytes > 0 )
+	{
+		copiedStoredBytes.resize( numStoredBytes );
+		if ( reader.ReadBytes( copiedStoredBytes.data(), numStoredBytes ) != numStoredBytes )
+			return false;
+		storedBytes = copiedStoredBytes.data();
+	}
+
+	out_rawBytes.resize( numRawBytes );
+	byte_t* dest = out_rawBytes.empty() ? nullptr : out_rawBytes.data();
+
+	bool didDecode;
+	switch ( (CompressionCodec)codecAsByte )
+	{
+		case COMPRESSION_CODEC_NONE:
+			didDecode = ( numStoredBytes == numRawBytes );
+			if ( didDecode && numRawBytes > 0 )
+				memcpy( dest, storedBytes, numRawBytes );
+			break;
+		case COMPRESSION_CODEC_RLE: didDecode = DecompressRLE( storedBytes, numStoredBytes, dest, numRawBytes ); break;
+		case COMPRESSION_CODEC_LZ: didDecode = DecompressLZ( storedBytes, numStoredBytes, dest, numRawBytes ); break;
+		default: didDecode = false; break;
+	}
+
+	return didDecode && ( CalcBlockChecksum( dest, numRawBytes ) == checksum );
+}
@@ -0,0 +1,39 @@
+#pragma once
+
+
+#include "Engine/EngineCommon.hpp"
+#include <vector>
+
+
+//-----------------------------------------------------------------------------
+class BinaryWriter;
+class BinaryReader;
+
+
+//-----------------------------------------------------------------------------
+enum CompressionCodec //Stored in each block header: append new codecs, never renumber.
+{
+	COMPRESSION_CODEC_NONE = 0,
+	COMPRESSION_CODEC_RLE = 1, //PackBits-style runs, best on planes like a map's long stretches of stone and air.
+	COMPRESSION_CODEC_LZ = 2, //LZ77 with 64KB back-references, for repeated structure like entity records.
+	NUM_COMPRESSION_CODECS
+};
+const char* GetCompressionCodecName( CompressionCodec codec );
+
+
+//-----------------------------------------------------------------------------
+// Block layout: uint8 codec, uint32 raw size, uint32 stored size, uint32 checksum of the raw bytes, then the stored bytes.
+// Writing tries every codec and keeps whichever stores smallest, so incompressible data costs only the 13-byte header.
+//-----------------------------------------------------------------------------
+CompressionCodec WriteCompressedBlock( BinaryWriter& writer, const void* rawData, size_t numRawBytes ); //Returns the codec it chose.
+bool ReadCompressedBlock( BinaryReader& reader, std::vector< byte_t >& out_rawBytes ); //False on an unknown codec, implausible sizes, truncation, or checksum mismatch.
+unsigned int CalcBlockChecksum( const void* data, size_t numBytes );
+
+
+//-----------------------------------------------------------------------------
+// The codecs alone. Compressors append to out_compressed, decompressors fail rather than write past numDestBytes.
+//-----------------------------------------------------------------------------
+void CompressRLE( const byte_t* source, size_t numSourceBytes, std::vector< byte_t >& out_compressed );
+bool DecompressRLE( const byte_t* source, size_t numSourceBytes, byte_t* dest, size_t numDestBytes );
+void CompressLZ( const byte_t* source, size_t numSourceBytes, std::vector< byte_t >& out_compressed );
+bool DecompressLZ( const byte_t* source, size_t numSourceBytes, byte_t* dest, size_t numDestBytes );
@@ -2,6 +2,12 @@
 #include "Engine/String/StringUtils.hpp"
 #include <cstdio>
 #include <io.h>
+#include <sys/stat.h>
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+#endif
 
 //--------------------------------------------------------------------------------------------------------------
 bool LoadBinaryFileIntoBuffer( const std::string& filePath, std::vector< unsigned char >& out_buffer )
@@ -62,6 +68,67 @@ bool SaveBufferToBinaryFile( const std::string& filePath, const std::vector< uns
 }
 
 
+//--------------------------------------------------------------------------------------------------------------
+bool SaveBufferToBinaryFileAtomically( const std::string& filePath, const std::vector< unsigned char >& buffer )
+{
+	//A crash mid-write only ever loses the temp file, never the last good copy at filePath.
+	const std::string tempFilePath = filePath + ".tmp";
+	FILE* file;
+	errno_t err = fopen_s( &file, tempFilePath.c_str(), "wb" );
+	if ( err != 0 ) return false;
+
+	size_t numBytesWritten = buffer.empty() ? 0 : fwrite( &buffer[ 0 ], 1, buffer.size(), file );
+	bool didWrite = ( numBytesWritten == buffer.size() ) && ( fflush( file ) == 0 );
+	fclose( file );
+
+	if ( didWrite )
+	{
+#ifdef _WIN32
+		didWrite = MoveFileExA( tempFilePath.c_str(), filePath.c_str(), MOVEFILE_REPLACE_EXISTING | MOVEFILE_WRITE_THROUGH ) != 0;
+#else
+		didWrite = rename( tempFilePath.c_str(), filePath.c_str() ) == 0;
+#endif
+	}
+
+	if ( !didWrite )
+		remove( tempFilePath.c_str() );
+	return didWrite;
+}
+
+
+//--------------------------------------------------------------------------------------------------------------
+bool AppendBufferToBinaryFile( const std::string& filePath, const std::vector< unsigned char >& buffer )
+{
+	FILE* file;
+	errno_t err = fopen_s( &file, filePath.c_str(), "ab" );
+	if ( err != 0 ) return false;
+
+	size_t numBytesWritten = buffer.empty() ? 0 : fwrite( &buffer[ 0 ], 1, buffer.size(), file );
+	fclose( file );
+
+	return numBytesWritten == buffer.size();
+}
+
+
+//--------------------------------------------------------------------------------------------------------------
+bool GetFileModifiedTimeAndSize( const std::string& filePath, int64_t& out_modifiedTime, size_t& out_numBytes )
+{
+#ifdef _WIN32
+	struct __stat64 fileStatus;
+	if ( _stat64( filePath.c_str(), &fileStatus ) != 0 )
+		return false;
+#else
+	struct stat fileStatus;
+	if ( stat( filePath.c_str(), &fileStatus ) != 0 )
+		return false;
+#endif
+
+	out_modifiedTime = (int64_t)fileStatus.st_mtime;
+	out_numBytes = (size_t)fileStatus.st_size;
+	return true;
+}
+
+
 //--------------------------------------------------------------------------------------------------------------
 bool SaveFloatsToTextFile( const std::string& filePath, const std::vector < float > & buffer )
 {
@@ -1,6 +1,7 @@
 #pragma once
 
 
+#include <stdint.h>
 #include <string>
 #include <vector>
 
@@ -9,6 +10,9 @@
 bool LoadBinaryFileIntoBuffer( const std::string& filePath, std::vector< unsigned char >& out_buffer );
 bool LoadFloatsFromTextFileIntoBuffer( const std::string& filePath, std::vector< float >& out_buffer );
 bool SaveBufferToBinaryFile( const std::string& filePath, const std::vector< unsigned char >& buffer );
+bool SaveBufferToBinaryFileAtomically( const std::string& filePath, const std::vector< unsigned char >& buffer ); //Via a temp file renamed over filePath.
+bool AppendBufferToBinaryFile( const std::string& filePath, const std::vector< unsigned char >& buffer ); //Creates the file if needed.
+bool GetFileModifiedTimeAndSize( const std::string& filePath, int64_t& out_modifiedTime, size_t& out_numBytes ); //False if the file can't be found.
 bool SaveFloatsToTextFile( const std::string& filePath, const std::vector < float > & buffer );
 std::vector< std::string > EnumerateFilesInDirectory( const std::string& relativeDirectoryPath, const std::string& filePattern );
 unsigned int CountFilesInDirectory( const std::string& relativeDirectoryPath, const std::string& filePattern );
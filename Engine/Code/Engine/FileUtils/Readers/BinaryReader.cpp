@@ -3,12 +3,35 @@
 bool BinaryReader::ReadString( std::string& out_string )
 {
 	//Because we wrote a length and the buffer, we need to read a length, then the buffer.
-	size_t bufferLength;
+	uint32_t bufferLength; //Must match the uint32_t WriteString used, size_t is 8 bytes on x64.
 	if ( false == Read<uint32_t>( &bufferLength ) )
 		return false;
 
 	out_string.resize( bufferLength );// = new char[ bufferLength ];
 
 									  //Write the size and then the content.
-	return ReadBytes( (void*)out_string.data(), bufferLength ) == bufferLength;
+	bool didRead = ReadBytes( (void*)out_string.data(), bufferLength ) == bufferLength;
+
+	if ( bufferLength > 0 )
+		out_string.resize( bufferLength - 1 ); //Drop the written null terminator, else == against literals fails.
+
+	return didRead;
+}
+
+
+//--------------------------------------------------------------------------------------------------------------
+size_t BinaryReader::SkipBytes( const size_t numBytes )
+{
+	byte_t scratch[ 256 ];
+	size_t numBytesSkipped = 0;
+	while ( numBytesSkipped < numBytes )
+	{
+		size_t numBytesToRead = ( numBytes - numBytesSkipped < sizeof( scratch ) ) ? ( numBytes - numBytesSkipped ) : sizeof( scratch );
+		size_t numBytesRead = ReadBytes( scratch, numBytesToRead );
+		numBytesSkipped += numBytesRead;
+
+		if ( numBytesRead < numBytesToRead )
+			break; //Hit the end.
+	}
+	return numBytesSkipped;
 }
\ No newline at end of file
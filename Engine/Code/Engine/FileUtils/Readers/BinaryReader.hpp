@@ -1,5 +1,6 @@
 #pragma once
 #include <string>
+#include <type_traits>
 
 
 #include "Engine/Memory/ByteUtils.hpp"
@@ -14,6 +15,8 @@ public:
 	void SetEndianMode( EndianMode newMode ) { m_endianMode = newMode; }
 
 	virtual size_t ReadBytes( void* out_value, const size_t numBytes ) = 0;
+	virtual size_t SkipBytes( const size_t numBytes ); //Default reads into scratch space, override if the source can seek.
+	virtual const void* ReadBytesInPlace( const size_t /*numBytes*/ ) { return nullptr; } //Zero-copy for sources already in memory. Nullptr means use ReadBytes, nothing was consumed.
 	bool ReadString( std::string& out_string );
 	template <typename ArrayDataType> bool Read( ArrayDataType* out_value )
 	{
@@ -28,6 +31,20 @@ public:
 
 		return numBytesRead == dataSize;
 	}
+	template <typename ArrayDataType> bool ReadArray( ArrayDataType* out_values, const size_t numValues )
+	{
+		static_assert( std::is_arithmetic< ArrayDataType >::value || std::is_enum< ArrayDataType >::value,
+					   "ReadArray swaps whole elements, so read structs per member or gather them into arrays of one." );
+
+		//One ReadBytes for the whole array, then one swap pass over it only if the file's endianness is foreign.
+		size_t dataSize = sizeof( ArrayDataType ) * numValues;
+		size_t numBytesRead = ReadBytes( out_values, dataSize );
+
+		if ( sizeof( ArrayDataType ) > 1 && GetLocalMachineEndianness() != m_endianMode )
+			ByteSwapArray( out_values, sizeof( ArrayDataType ), numBytesRead / sizeof( ArrayDataType ) );
+
+		return numBytesRead == dataSize;
+	}
 
 
 private:
@@ -0,0 +1,38 @@
+#include "Engine/FileUtils/Readers/BufferBinaryReader.hpp"
+#include <string.h>
+
+
+//--------------------------------------------------------------------------------------------------------------
+size_t BufferBinaryReader::ReadBytes( void* out_value, const size_t numBytes )
+{
+	size_t numBytesToRead = SkipBytes( numBytes );
+	memcpy( out_value, m_data + m_offset - numBytesToRead, numBytesToRead );
+	return numBytesToRead;
+}
+
+
+//--------------------------------------------------------------------------------------------------------------
+size_t BufferBinaryReader::SkipBytes( const size_t numBytes )
+{
+	size_t numBytesToSkip = numBytes;
+	if ( numBytesToSkip > GetNumBytesRemaining() )
+	{
+		numBytesToSkip = GetNumBytesRemaining();
+		m_didOverrun = true;
+	}
+
+	m_offset += numBytesToSkip;
+	return numBytesToSkip;
+}
+
+
+//--------------------------------------------------------------------------------------------------------------
+const void* BufferBinaryReader::ReadBytesInPlace( const size_t numBytes )
+{
+	if ( numBytes > GetNumBytesRemaining() )
+		return nullptr; //Left for ReadBytes to flag the overrun.
+
+	const void* bytesInPlace = m_data + m_offset;
+	m_offset += numBytes;
+	return bytesInPlace;
+}
@@ -0,0 +1,34 @@
+#pragma once
+
+
+#include "Engine/FileUtils/Readers/BinaryReader.hpp"
+
+
+class BufferBinaryReader : public BinaryReader //Reads out of memory it doesn't own, e.g. one section of a file already loaded whole.
+{
+public:
+	BufferBinaryReader( const void* data, size_t numBytes, EndianMode endianMode = LITTLE_ENDIAN )
+		: BinaryReader( endianMode )
+		, m_data( (const byte_t*)data )
+		, m_numBytes( numBytes )
+		, m_offset( 0 )
+		, m_didOverrun( false )
+	{
+	}
+	virtual size_t ReadBytes( void* out_value, const size_t numBytes ) override;
+	virtual size_t SkipBytes( const size_t numBytes ) override;
+	virtual const void* ReadBytesInPlace( const size_t numBytes ) override;
+
+	const byte_t* GetCurrentPointer() const { return m_data + m_offset; } //For carving out sub-readers without copying.
+	size_t GetNumBytesRemaining() const { return m_numBytes - m_offset; }
+	size_t GetOffset() const { return m_offset; }
+	bool IsAtEnd() const { return m_offset == m_numBytes; }
+	bool DidOverrun() const { return m_didOverrun; } //Set once any read or skip asked for more than was left.
+
+
+private:
+	const byte_t* m_data;
+	size_t m_numBytes;
+	size_t m_offset;
+	bool m_didOverrun;
+};
@@ -0,0 +1,162 @@
+#include "Engine/FileUtils/Readers/MappedFileReader.hpp"
+#include <string.h>
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+
+//--------------------------------------------------------------------------------------------------------------
+MappedFileReader::MappedFileReader( EndianMode endianMode /*= LITTLE_ENDIAN*/ )
+	: BinaryReader( endianMode )
+	, m_data( nullptr )
+	, m_numBytes( 0 )
+	, m_offset( 0 )
+	, m_isOpen( false )
+#ifdef _WIN32
+	, m_fileHandle( INVALID_HANDLE_VALUE )
+	, m_mappingHandle( nullptr )
+#else
+	, m_fileDescriptor( -1 )
+#endif
+{
+}
+
+
+#ifdef _WIN32
+//--------------------------------------------------------------------------------------------------------------
+bool MappedFileReader::open( const char* fileName )
+{
+	close();
+
+	m_fileHandle = CreateFileA( fileName, GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr );
+	if ( m_fileHandle == INVALID_HANDLE_VALUE )
+		return false;
+
+	LARGE_INTEGER fileSize;
+	if ( !GetFileSizeEx( m_fileHandle, &fileSize ) )
+	{
+		close();
+		return false;
+	}
+
+	m_numBytes = (size_t)fileSize.QuadPart;
+	m_isOpen = true;
+	if ( m_numBytes == 0 )
+		return true; //Windows refuses to map an empty file, but it's still a valid, empty read.
+
+	m_mappingHandle = CreateFileMappingA( m_fileHandle, nullptr, PAGE_READONLY, 0, 0, nullptr );
+	if ( m_mappingHandle != nullptr )
+		m_data = (const byte_t*)MapViewOfFile( m_mappingHandle, FILE_MAP_READ, 0, 0, 0 );
+
+	if ( m_data == nullptr )
+	{
+		close();
+		return false;
+	}
+
+	return true;
+}
+
+
+//--------------------------------------------------------------------------------------------------------------
+void MappedFileReader::close()
+{
+	if ( m_data != nullptr )
+		UnmapViewOfFile( m_data );
+	if ( m_mappingHandle != nullptr )
+		CloseHandle( m_mappingHandle );
+	if ( m_fileHandle != INVALID_HANDLE_VALUE )
+		CloseHandle( m_fileHandle );
+
+	m_data = nullptr;
+	m_mappingHandle = nullptr;
+	m_fileHandle = INVALID_HANDLE_VALUE;
+	m_numBytes = m_offset = 0;
+	m_isOpen = false;
+}
+#else
+//--------------------------------------------------------------------------------------------------------------
+bool MappedFileReader::open( const char* fileName )
+{
+	close();
+
+	m_fileDescriptor = ::open( fileName, O_RDONLY );
+	if ( m_fileDescriptor < 0 )
+		return false;
+
+	struct stat fileStats;
+	if ( fstat( m_fileDescriptor, &fileStats ) != 0 )
+	{
+		close();
+		return false;
+	}
+
+	m_numBytes = (size_t)fileStats.st_size;
+	m_isOpen = true;
+	if ( m_numBytes == 0 )
+		return true; //mmap rejects a zero length.
+
+	void* mapping = mmap( nullptr, m_numBytes, PROT_READ, MAP_PRIVATE, m_fileDescriptor, 0 );
+	if ( mapping == MAP_FAILED )
+	{
+		close();
+		return false;
+	}
+
+	m_data = (const byte_t*)mapping;
+	return true;
+}
+
+
+//--------------------------------------------------------------------------------------------------------------
+void MappedFileReader::close()
+{
+	if ( m_data != nullptr )
+		munmap( (void*)m_data, m_numBytes );
+	if ( m_fileDescriptor >= 0 )
+		::close( m_fileDescriptor );
+
+	m_data = nullptr;
+	m_fileDescriptor = -1;
+	m_numBytes = m_offset = 0;
+	m_isOpen = false;
+}
+#endif
+
+
+//--------------------------------------------------------------------------------------------------------------
+size_t MappedFileReader::ReadBytes( void* out_value, const size_t numBytes )
+{
+	size_t numBytesToRead = SkipBytes( numBytes );
+	if ( numBytesToRead > 0 )
+		memcpy( out_value, m_data + m_offset - numBytesToRead, numBytesToRead );
+	return numBytesToRead;
+}
+
+
+//--------------------------------------------------------------------------------------------------------------
+size_t MappedFileReader::SkipBytes( const size_t numBytes )
+{
+	size_t numBytesToSkip = ( numBytes < GetNumBytesRemaining() ) ? numBytes : GetNumBytesRemaining();
+	m_offset += numBytesToSkip;
+	return numBytesToSkip;
+}
+
+
+//--------------------------------------------------------------------------------------------------------------
+const void* MappedFileReader::ReadBytesInPlace( const size_t numBytes )
+{
+	if ( numBytes > GetNumBytesRemaining() || m_data == nullptr )
+		return nullptr;
+
+	const void* bytesInPlace = m_data + m_offset;
+	m_offset += numBytes;
+	return bytesInPlace;
+}
@@ -0,0 +1,46 @@
+#pragma once
+
+
+#include "Engine/FileUtils/Readers/BinaryReader.hpp"
+
+
+//-----------------------------------------------------------------------------
+// Maps the whole file read-only instead of fread'ing it. Pages only come in when first touched, so a huge save
+// whose later sections are never read costs nothing for them, and ReadBytesInPlace hands out fixed-layout
+// sections (e.g. a map's glyph plane) straight from the mapping without a copy.
+//-----------------------------------------------------------------------------
+class MappedFileReader : public BinaryReader
+{
+public:
+	MappedFileReader( EndianMode endianMode = LITTLE_ENDIAN );
+	~MappedFileReader() { close(); }
+	bool open( const char* fileName );
+	void close(); //Invalidates every pointer handed out by GetData() and ReadBytesInPlace().
+	bool IsOpen() const { return m_isOpen; }
+
+	virtual size_t ReadBytes( void* out_value, const size_t numBytes ) override;
+	virtual size_t SkipBytes( const size_t numBytes ) override;
+	virtual const void* ReadBytesInPlace( const size_t numBytes ) override;
+
+	const byte_t* GetData() const { return m_data; } //Nullptr for an empty file.
+	size_t GetNumBytes() const { return m_numBytes; }
+	size_t GetOffset() const { return m_offset; }
+	size_t GetNumBytesRemaining() const { return m_numBytes - m_offset; }
+	void SetOffset( size_t newOffset ) { m_offset = ( newOffset < m_numBytes ) ? newOffset : m_numBytes; }
+
+
+private:
+	MappedFileReader( const MappedFileReader& ); //The mapping has one owner.
+	void operator=( const MappedFileReader& );
+
+	const byte_t* m_data;
+	size_t m_numBytes;
+	size_t m_offset;
+	bool m_isOpen;
+#ifdef _WIN32
+	void* m_fileHandle;
+	void* m_mappingHandle;
+#else
+	int m_fileDescriptor;
+#endif
+};
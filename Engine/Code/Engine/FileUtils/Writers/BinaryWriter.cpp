@@ -1 +1,23 @@
 #include "Engine/FileUtils/Writers/BinaryWriter.hpp"
+
+
+//--------------------------------------------------------------------------------------------------------------
+bool BinaryWriter::WriteArrayByteSwapped( const void* values, size_t elementSize, size_t numValues )
+{
+	byte_t swappedChunk[ 4096 ];
+	const size_t numValuesPerChunk = sizeof( swappedChunk ) / elementSize;
+	const byte_t* sourceBytes = (const byte_t*)values;
+
+	while ( numValues > 0 )
+	{
+		size_t numValuesInChunk = ( numValues < numValuesPerChunk ) ? numValues : numValuesPerChunk;
+		size_t numChunkBytes = numValuesInChunk * elementSize;
+		CopyByteSwapped( swappedChunk, sourceBytes, elementSize, numValuesInChunk );
+		if ( WriteBytes( swappedChunk, numChunkBytes ) != numChunkBytes )
+			return false;
+
+		sourceBytes += numChunkBytes;
+		numValues -= numValuesInChunk;
+	}
+	return true;
+}
@@ -1,5 +1,6 @@
 #pragma once
 #include <string.h>
+#include <type_traits>
 
 
 #include "Engine/Memory/ByteUtils.hpp"
@@ -12,6 +13,7 @@ public:
 		//Intel CPUs are Little-endian, hence the default.
 		//Wii, PS3, 360 were Big-endian; PS4, XB1 seem to be Little-endian.
 	void SetEndianMode( EndianMode newMode ) { m_endianMode = newMode; }
+	EndianMode GetEndianMode() const { return m_endianMode; }
 	
 	virtual size_t WriteBytes( const void* sourceData, const size_t numBytes ) = 0;
 	bool WriteString( const char* string ) //Handles nullptr, empty strings "", and normal strings.
@@ -43,8 +45,21 @@ public:
 		unsigned int numBytesWritten = WriteBytes( &dataCopy, dataSize );
 		return numBytesWritten == dataSize;
 	}
+	template <typename ArrayDataType> bool WriteArray( const ArrayDataType* values, const size_t numValues )
+	{
+		static_assert( std::is_arithmetic< ArrayDataType >::value || std::is_enum< ArrayDataType >::value,
+					   "WriteArray swaps whole elements, so write structs per member or gather them into arrays of one." );
+
+		size_t dataSize = sizeof( ArrayDataType ) * numValues;
+		if ( sizeof( ArrayDataType ) == 1 || GetLocalMachineEndianness() == m_endianMode )
+			return WriteBytes( values, dataSize ) == dataSize; //Native order needs no copy at all.
+
+		return WriteArrayByteSwapped( values, sizeof( ArrayDataType ), numValues );
+	}
 
 
 private:
+	bool WriteArrayByteSwapped( const void* values, size_t elementSize, size_t numValues ); //Swaps through a stack chunk, as values is const.
+
 	EndianMode m_endianMode;
 };
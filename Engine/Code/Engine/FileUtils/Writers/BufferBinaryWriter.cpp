@@ -0,0 +1,10 @@
+#include "Engine/FileUtils/Writers/BufferBinaryWriter.hpp"
+
+
+//--------------------------------------------------------------------------------------------------------------
+size_t BufferBinaryWriter::WriteBytes( const void* sourceData, const size_t numBytes )
+{
+	const unsigned char* sourceBytes = (const unsigned char*)sourceData;
+	m_buffer.insert( m_buffer.end(), sourceBytes, sourceBytes + numBytes );
+	return numBytes;
+}
@@ -0,0 +1,32 @@
+#pragma once
+
+
+#include "Engine/FileUtils/Writers/BinaryWriter.hpp"
+#include <string.h>
+#include <vector>
+
+
+class BufferBinaryWriter : public BinaryWriter //Accumulates into memory, e.g. to assemble a file and write it with one SaveBufferToBinaryFile.
+{
+public:
+	BufferBinaryWriter( EndianMode endianMode = LITTLE_ENDIAN ) : BinaryWriter( endianMode ) {}
+	virtual size_t WriteBytes( const void* sourceData, const size_t numBytes ) override;
+
+	const std::vector< unsigned char >& GetBuffer() const { return m_buffer; }
+	std::vector< unsigned char >& GetBuffer() { return m_buffer; }
+	size_t GetNumBytesWritten() const { return m_buffer.size(); }
+	void Clear() { m_buffer.clear(); } //Keeps capacity, so a reused scratch writer stops allocating.
+
+	template <typename ArrayDataType> void OverwriteAt( size_t offset, const ArrayDataType& value ) //e.g. to backpatch a size written as a placeholder.
+	{
+		ArrayDataType dataCopy = value;
+		if ( GetLocalMachineEndianness() != GetEndianMode() )
+			ByteSwap( &dataCopy, sizeof( ArrayDataType ) );
+
+		memcpy( &m_buffer[ offset ], &dataCopy, sizeof( ArrayDataType ) );
+	}
+
+
+private:
+	std::vector< unsigned char > m_buffer;
+};
@@ -0,0 +1,409 @@
+#include "Engine/FileUtils/XMLPullReader.hpp"
+
+#include <stdlib.h>
+
+
+//--------------------------------------------------------------------------------------------------------------
+XMLPullReader::XMLPullReader()
+	: m_start( "" )
+	, m_cursor( m_start )
+	, m_end( m_start )
+	, m_event( XML_PULL_EVENT_END_OF_DOCUMENT )
+	, m_eventDepth( 0 )
+	, m_isEndOfSelfClosingPending( false )
+	, m_errorDescription( nullptr )
+	, m_errorPosition( nullptr )
+{
+}
+
+
+//--------------------------------------------------------------------------------------------------------------
+XMLPullReader::XMLPullReader( const char* text, size_t numChars )
+	: m_start( text )
+	, m_cursor( text )
+	, m_end( text + numChars )
+	, m_event( XML_PULL_EVENT_END_OF_DOCUMENT )
+	, m_eventDepth( 0 )
+	, m_isEndOfSelfClosingPending( false )
+	, m_errorDescription( nullptr )
+	, m_errorPosition( nullptr )
+{
+}
+
+
+//--------------------------------------------------------------------------------------------------------------
+bool XMLPullReader::open( const char* fileName )
+{
+	close();
+	if ( !m_mappedFile.open( fileName ) )
+		return false;
+
+	m_start = ( m_mappedFile.GetData() != nullptr ) ? (const char*)m_mappedFile.GetData() : "";
+	m_cursor = m_start;
+	m_end = m_start + m_mappedFile.GetNumBytes();
+
+	if ( m_end - m_cursor >= 3 && memcmp( m_cursor, "\xEF\xBB\xBF", 3 ) == 0 )
+		m_cursor += 3; //UTF-8 byte order mark.
+
+	return true;
+}
+
+
+//--------------------------------------------------------------------------------------------------------------
+void XMLPullReader::close()
+{
+	m_mappedFile.close();
+
+	m_start = "";
+	m_cursor = m_start;
+	m_end = m_start;
+	m_event = XML_PULL_EVENT_END_OF_DOCUMENT;
+	m_eventDepth = 0;
+	m_isEndOfSelfClosingPending = false;
+	m_name = StringView();
+	m_text = StringView();
+	m_attributes.clear();
+	m_openElementNames.clear();
+	m_errorDescription = nullptr;
+	m_errorPosition = nullptr;
+}
+
+
+//--------------------------------------------------------------------------------------------------------------
+XMLPullEvent XMLPullReader::SetError( const char* description )
+{
+	m_errorDescription = description;
+	m_errorPosition = m_cursor;
+	m_cursor = m_end;
+	m_event = XML_PULL_EVENT_ERROR;
+	return m_event;
+}
+
+
+//--------------------------------------------------------------------------------------------------------------
+int XMLPullReader::GetErrorLineNumber() const
+{
+	if ( m_errorPosition == nullptr )
+		return 0;
+
+	int lineNumber = 1; //Counted only now, so error-free reads never pay for it.
+	for ( const char* scan = m_start; scan < m_errorPosition; scan++ )
+		if ( *scan == '\n' )
+			++lineNumber;
+	return lineNumber;
+}
+
+
+//--------------------------------------------------------------------------------------------------------------
+bool XMLPullReader::SkipPast( const char* terminator )
+{
+	size_t terminatorLength = strlen( terminator );
+	for ( ; m_cursor + terminatorLength <= m_end; m_cursor++ )
+	{
+		if ( *m_cursor == terminator[ 0 ] && memcmp( m_cursor, terminator, terminatorLength ) == 0 )
+		{
+			m_cursor += terminatorLength;
+			return true;
+		}
+	}
+
+	m_cursor = m_end;
+	return false;
+}
+
+
+//--------------------------------------------------------------------------------------------------------------
+StringView XMLPullReader::ReadName()
+{
+	const char* nameStart = m_cursor;
+	while ( m_cursor < m_end && !StringView::IsWhitespace( *m_cursor ) && *m_cursor != '>' && *m_cursor != '/' && *m_cursor != '=' )
+		++m_cursor;
+	return StringView( nameStart, m_cursor - nameStart );
+}
+
+
+//--------------------------------------------------------------------------------------------------------------
+XMLPullEvent XMLPullReader::Next()
+{
+	if ( m_event == XML_PULL_EVENT_ERROR )
+		return m_event;
+
+	if ( m_isEndOfSelfClosingPending ) //m_name is still the self-closed element's.
+	{
+		m_isEndOfSelfClosingPending = false;
+		m_eventDepth = (int)m_openElementNames.size();
+		m_openElementNames.pop_back();
+		m_event = XML_PULL_EVENT_END_ELEMENT;
+		return m_event;
+	}
+
+	while ( m_cursor < m_end )
+	{
+		if ( *m_cursor != '<' )
+		{
+			const char* textStart = m_cursor;
+			const char* textEnd = (const char*)memchr( m_cursor, '<', m_end - m_cursor );
+			m_cursor = ( textEnd != nullptr ) ? textEnd : m_end;
+
+			m_text = StringView( textStart, m_cursor - textStart ).GetTrimmed();
+			if ( m_text.IsEmpty() || m_openElementNames.empty() )
+				continue; //Our data files keep notes outside their root elements, which xmlParser also tolerates.
+
+			m_eventDepth = (int)m_openElementNames.size();
+			m_event = XML_PULL_EVENT_TEXT;
+			return m_event;
+		}
+
+		StringView remaining( m_cursor, m_end - m_cursor );
+		if ( remaining.StartsWith( "<!--" ) )
+		{
+			if ( !SkipPast( "-->" ) )
+				return SetError( "Unterminated comment" );
+		}
+		else if ( remaining.StartsWith( "<![CDATA[" ) )
+		{
+			const char* cdataStart = m_cursor + 9;
+			if ( !SkipPast( "]]>" ) )
+				return SetError( "Unterminated CDATA section" );
+
+			m_text = StringView( cdataStart, ( m_cursor - 3 ) - cdataStart );
+			m_eventDepth = (int)m_openElementNames.size();
+			m_event = XML_PULL_EVENT_TEXT;
+			return m_event;
+		}
+		else if ( remaining.StartsWith( "<?" ) )
+		{
+			if ( !SkipPast( "?>" ) )
+				return SetError( "Unterminated processing instruction" );
+		}
+		else if ( remaining.StartsWith( "<!" ) ) //DOCTYPE and the like, which our data never nests brackets inside.
+		{
+			if ( !SkipPast( ">" ) )
+				return SetError( "Unterminated declaration" );
+		}
+		else if ( remaining.StartsWith( "</" ) )
+		{
+			return ReadEndTag();
+		}
+		else
+		{
+			return ReadStartTag();
+		}
+	}
+
+	if ( !m_openElementNames.empty() )
+		return SetError( "Missing end tag" );
+
+	m_eventDepth = 0;
+	m_event = XML_PULL_EVENT_END_OF_DOCUMENT;
+	return m_event;
+}
+
+
+//--------------------------------------------------------------------------------------------------------------
+XMLPullEvent XMLPullReader::ReadStartTag()
+{
+	++m_cursor; //'<'
+	m_name = ReadName();
+	if ( m_name.IsEmpty() )
+		return SetError( "Missing tag name" );
+
+	m_attributes.clear();
+	for ( ;; )
+	{
+		SkipWhitespace();
+		if ( m_cursor >= m_end )
+			return SetError( "Unterminated start tag" );
+
+		if ( *m_cursor == '>' )
+		{
+			++m_cursor;
+			break;
+		}
+
+		if ( *m_cursor == '/' )
+		{
+			if ( m_cursor + 1 >= m_end || m_cursor[ 1 ] != '>' )
+				return SetError( "Expected > after / in start tag" );
+			m_cursor += 2;
+			m_isEndOfSelfClosingPending = true;
+			break;
+		}
+
+		XMLPullAttribute attribute;
+		attribute.m_name = ReadName();
+		if ( attribute.m_name.IsEmpty() )
+			return SetError( "Missing attribute name" );
+
+		SkipWhitespace();
+		if ( m_cursor >= m_end || *m_cursor != '=' )
+			return SetError( "Expected = after attribute name" );
+		++m_cursor;
+		SkipWhitespace();
+
+		if ( m_cursor >= m_end || ( *m_cursor != '"' && *m_cursor != '\'' ) )
+			return SetError( "Expected quoted attribute value" );
+		char quote = *m_cursor++;
+		const char* valueStart = m_cursor;
+		const char* valueEnd = (const char*)memchr( m_cursor, quote, m_end - m_cursor );
+		if ( valueEnd == nullptr )
+			return SetError( "Unterminated attribute value" );
+
+		attribute.m_rawValue = StringView( valueStart, valueEnd - valueStart );
+		m_cursor = valueEnd + 1;
+		m_attributes.push_back( attribute );
+	}
+
+	m_openElementNames.push_back( m_name );
+	m_eventDepth = (int)m_openElementNames.size();
+	m_event = XML_PULL_EVENT_START_ELEMENT;
+	return m_event;
+}
+
+
+//--------------------------------------------------------------------------------------------------------------
+XMLPullEvent XMLPullReader::ReadEndTag()
+{
+	m_cursor += 2; //"</"
+	m_name = ReadName();
+	SkipWhitespace();
+	if ( m_cursor >= m_end || *m_cursor != '>' )
+		return SetError( "Unterminated end tag" );
+	++m_cursor;
+
+	if ( m_openElementNames.empty() || m_openElementNames.back() != m_name )
+		return SetError( "End tag doesn't match its start tag" );
+
+	m_attributes.clear();
+	m_eventDepth = (int)m_openElementNames.size();
+	m_openElementNames.pop_back();
+	m_event = XML_PULL_EVENT_END_ELEMENT;
+	return m_event;
+}
+
+
+//--------------------------------------------------------------------------------------------------------------
+bool XMLPullReader::NextChildElement( int parentDepth )
+{
+	for ( ;; )
+	{
+		switch ( Next() )
+		{
+		case XML_PULL_EVENT_START_ELEMENT:
+			if ( m_eventDepth == parentDepth + 1 )
+				return true;
+			break; //A grandchild, which the caller didn't ask for.
+		case XML_PULL_EVENT_END_ELEMENT:
+			if ( m_eventDepth <= parentDepth )
+				return false;
+			break;
+		case XML_PULL_EVENT_TEXT:
+			break;
+		default:
+			return false;
+		}
+	}
+}
+
+
+//--------------------------------------------------------------------------------------------------------------
+bool XMLPullReader::SkipElement()
+{
+	if ( m_event != XML_PULL_EVENT_START_ELEMENT )
+		return false;
+
+	int elementDepth = m_eventDepth;
+	for ( ;; )
+	{
+		XMLPullEvent event = Next();
+		if ( event == XML_PULL_EVENT_END_ELEMENT && m_eventDepth == elementDepth )
+			return true;
+		if ( event == XML_PULL_EVENT_END_OF_DOCUMENT || event == XML_PULL_EVENT_ERROR )
+			return false;
+	}
+}
+
+
+//--------------------------------------------------------------------------------------------------------------
+bool XMLPullReader::FindAttribute( const StringView& attributeName, StringView& out_rawValue ) const
+{
+	for ( const XMLPullAttribute& attribute : m_attributes ) //Linear, like xmlParser's: elements carry a handful at most.
+	{
+		if ( attribute.m_name == attributeName )
+		{
+			out_rawValue = attribute.m_rawValue;
+			return true;
+		}
+	}
+	return false;
+}
+
+
+//--------------------------------------------------------------------------------------------------------------
+void XMLPullReader::ReadText( std::string& out_text ) const
+{
+	DecodeXMLEntities( m_text, out_text );
+}
+
+
+//--------------------------------------------------------------------------------------------------------------
+void DecodeXMLEntities( const StringView& rawValue, std::string& out_decoded )
+{
+	out_decoded.clear();
+	if ( rawValue.Find( '&' ) == StringView::npos )
+	{
+		out_decoded.assign( rawValue.GetData(), rawValue.GetLength() );
+		return;
+	}
+
+	static const struct { const char* m_entity; char m_character; } s_ENTITIES[] =
+	{
+		{ "&lt;", '<' }, { "&gt;", '>' }, { "&amp;", '&' }, { "&quot;", '"' }, { "&apos;", '\'' }
+	};
+
+	out_decoded.reserve( rawValue.GetLength() );
+	for ( size_t index = 0; index < rawValue.GetLength(); )
+	{
+		StringView remaining = rawValue.GetSubstring( index );
+		bool didDecode = false;
+
+		if ( remaining[ 0 ] == '&' && remaining.GetLength() > 3 && remaining[ 1 ] == '#' )
+		{
+			size_t semicolonIndex = remaining.Find( ';' );
+			if ( semicolonIndex != StringView::npos && semicolonIndex < 12 )
+			{
+				char digits[ 12 ];
+				memcpy( digits, remaining.GetData() + 2, semicolonIndex - 2 );
+				digits[ semicolonIndex - 2 ] = '\0';
+				bool isHex = ( digits[ 0 ] == 'x' || digits[ 0 ] == 'X' );
+				long codePoint = strtol( isHex ? digits + 1 : digits, nullptr, isHex ? 16 : 10 );
+				out_decoded += (char)codePoint; //Our data is ASCII, as xmlParser's non-wide build also assumes.
+				index += semicolonIndex + 1;
+				didDecode = true;
+			}
+		}
+		else if ( remaining[ 0 ] == '&' )
+		{
+			for ( const auto& entity : s_ENTITIES )
+			{
+				if ( remaining.StartsWith( entity.m_entity ) )
+				{
+					out_decoded += entity.m_character;
+					index += strlen( entity.m_entity );
+					didDecode = true;
+					break;
+				}
+			}
+		}
+
+		if ( !didDecode )
+			out_decoded += rawValue[ index++ ];
+	}
+}
+
+
+//--------------------------------------------------------------------------------------------------------------
+void ParseXMLPullValue( const StringView& rawValue, std::string& out_value )
+{
+	DecodeXMLEntities( rawValue, out_value );
+}
@@ -0,0 +1,114 @@
+#pragma once
+
+
+#include "Engine/FileUtils/Readers/MappedFileReader.hpp"
+#include "Engine/String/StringParsing.hpp"
+#include <vector>
+
+
+//-----------------------------------------------------------------------------
+enum XMLPullEvent
+{
+	XML_PULL_EVENT_START_ELEMENT, //GetName() and the attribute accessors are valid until the next call to Next().
+	XML_PULL_EVENT_END_ELEMENT, //Also sent right after a self-closing element's start, so every start has an end.
+	XML_PULL_EVENT_TEXT, //GetText(), trimmed. Whitespace-only runs between elements are skipped.
+	XML_PULL_EVENT_END_OF_DOCUMENT,
+	XML_PULL_EVENT_ERROR //Sticky. GetErrorDescription() and GetErrorLineNumber() say what and where.
+};
+
+
+//-----------------------------------------------------------------------------
+struct XMLPullAttribute
+{
+	StringView m_name;
+	StringView m_rawValue; //Still entity-encoded, e.g. &amp;, which the typed readers decode.
+};
+
+
+//-----------------------------------------------------------------------------
+// Streams through XML without building a DOM: each Next() steps to the following start tag, end tag, or text, and
+// every name, value, and text it hands out is a StringView into the source buffer, so nothing is copied or
+// allocated per node. The only heap use is two arrays reused across elements, sized by the widest element and the depth.
+// Comments, processing instructions, DOCTYPE, and text outside any element are skipped, and like xmlParser it
+// allows several top-level elements. CDATA sections come through as text, not decoded.
+//-----------------------------------------------------------------------------
+class XMLPullReader
+{
+public:
+	XMLPullReader();
+	XMLPullReader( const char* text, size_t numChars ); //Doesn't copy: text must outlive the reader.
+	bool open( const char* fileName ); //Maps the file, so even a huge save never sits in the heap.
+	void close();
+
+	XMLPullEvent Next();
+	bool NextChildElement( int parentDepth ); //Skips to parentDepth's next child start, false at parentDepth's end or on error.
+	bool SkipElement(); //From a start event to its end event, past any children.
+
+	XMLPullEvent GetEvent() const { return m_event; }
+	int GetDepth() const { return m_eventDepth; } //1 for the root element's events, its children 2, and so on.
+	const StringView& GetName() const { return m_name; } //Of the element starting or ending.
+	const StringView& GetText() const { return m_text; }
+	void ReadText( std::string& out_text ) const; //Decoded.
+
+	int GetNumAttributes() const { return (int)m_attributes.size(); }
+	const XMLPullAttribute& GetAttribute( int attributeIndex ) const { return m_attributes[ attributeIndex ]; }
+	bool FindAttribute( const StringView& attributeName, StringView& out_rawValue ) const;
+	template< typename ValueType > ValueType ReadAttribute( const StringView& attributeName, const ValueType& defaultValue ) const;
+
+	const char* GetErrorDescription() const { return m_errorDescription; }
+	int GetErrorLineNumber() const;
+
+
+private:
+	XMLPullReader( const XMLPullReader& ); //Views point into m_mappedFile.
+	void operator=( const XMLPullReader& );
+
+	XMLPullEvent SetError( const char* description );
+	bool SkipPast( const char* terminator );
+	void SkipWhitespace() { while ( m_cursor < m_end && StringView::IsWhitespace( *m_cursor ) ) ++m_cursor; }
+	StringView ReadName();
+	XMLPullEvent ReadStartTag();
+	XMLPullEvent ReadEndTag();
+
+	MappedFileReader m_mappedFile;
+	const char* m_start;
+	const char* m_cursor;
+	const char* m_end;
+
+	XMLPullEvent m_event;
+	int m_eventDepth;
+	bool m_isEndOfSelfClosingPending;
+	StringView m_name;
+	StringView m_text;
+	std::vector< XMLPullAttribute > m_attributes;
+	std::vector< StringView > m_openElementNames; //To match each end tag against its start.
+	const char* m_errorDescription;
+	const char* m_errorPosition;
+};
+
+
+//-----------------------------------------------------------------------------
+void DecodeXMLEntities( const StringView& rawValue, std::string& out_decoded );
+void ParseXMLPullValue( const StringView& rawValue, std::string& out_value ); //Decoded, the one type whose values hold entities.
+
+
+//-----------------------------------------------------------------------------
+template< typename ValueType > //Numbers, vectors, and colors parse straight from the source buffer, see SetTypeFromStringView.
+inline void ParseXMLPullValue( const StringView& rawValue, ValueType& out_value )
+{
+	SetTypeFromStringView( out_value, rawValue );
+}
+
+
+//-----------------------------------------------------------------------------
+template< typename ValueType >
+inline ValueType XMLPullReader::ReadAttribute( const StringView& attributeName, const ValueType& defaultValue ) const
+{
+	ValueType outValue = defaultValue;
+
+	StringView rawValue;
+	if ( FindAttribute( attributeName, rawValue ) )
+		ParseXMLPullValue( rawValue, outValue );
+
+	return outValue;
+}
@@ -4,6 +4,10 @@
 
 
 #include "Engine/FileUtils/XMLUtils.hpp"
+#include "Engine/FileUtils/XMLPullReader.hpp"
+#include "Engine/FileUtils/Readers/BinaryReader.hpp"
+#include "Engine/FileUtils/Writers/BinaryWriter.hpp"
+#include "Engine/Error/ErrorWarningAssert.hpp"
 
 
 
@@ -139,3 +143,310 @@ bool GetXMLNodeByNameSearchingFromPosition( const XMLNode& parentNode, const std
 
 	return wasFound;
 }
+
+
+
+///----------------------------------------------------------
+/// Serializes a parsed tree so it can be rebuilt later 
+/// without lexing the XML text again.
+///----------------------------------------------------------
+bool WriteXMLNodeToBinary( BinaryWriter& writer, const XMLNode& node )
+{
+	bool didWrite = writer.WriteString( node.getName() );
+
+	didWrite &= writer.Write< uint32_t >( node.nAttribute() );
+	for ( int attributeIndex = 0; attributeIndex < node.nAttribute(); attributeIndex++ )
+	{
+		didWrite &= writer.WriteString( node.getAttributeName( attributeIndex ) );
+		didWrite &= writer.WriteString( node.getAttributeValue( attributeIndex ) );
+	}
+
+	didWrite &= writer.Write< uint32_t >( node.nText() );
+	for ( int textIndex = 0; textIndex < node.nText(); textIndex++ )
+		didWrite &= writer.WriteString( node.getText( textIndex ) );
+
+	didWrite &= writer.Write< uint32_t >( node.nChildNode() );
+	for ( int childIndex = 0; childIndex < node.nChildNode() && didWrite; childIndex++ )
+		didWrite &= WriteXMLNodeToBinary( writer, node.getChildNode( childIndex ) );
+
+	return didWrite;
+}
+
+
+
+///----------------------------------------------------------
+/// Reads a string WriteString wrote, in place when the reader
+/// allows it, else into scratchString.
+///----------------------------------------------------------
+static const char* ReadStringForXMLNode( BinaryReader& reader, std::string& scratchString )
+{
+	uint32_t bufferLength; //Includes the null terminator WriteString wrote, zero only for nullptr.
+	if ( !reader.Read< uint32_t >( &bufferLength ) )
+		return nullptr;
+
+	if ( bufferLength == 0 )
+		return "";
+
+	const char* inPlaceString = static_cast< const char* >( reader.ReadBytesInPlace( bufferLength ) );
+	if ( inPlaceString != nullptr )
+		return ( inPlaceString[ bufferLength - 1 ] == '\0' ) ? inPlaceString : nullptr;
+
+	scratchString.resize( bufferLength );
+	if ( reader.ReadBytes( &scratchString[ 0 ], bufferLength ) != bufferLength )
+		return nullptr;
+	scratchString[ bufferLength - 1 ] = '\0';
+	return scratchString.c_str();
+}
+
+
+
+///----------------------------------------------------------
+/// 
+///----------------------------------------------------------
+static bool ReadXMLNodeContents( BinaryReader& reader, XMLNode& node, std::string& scratchName, std::string& scratchValue )
+{
+	uint32_t numAttributes;
+	if ( !reader.Read< uint32_t >( &numAttributes ) )
+		return false;
+	for ( uint32_t attributeIndex = 0; attributeIndex < numAttributes; attributeIndex++ )
+	{
+		const char* attributeName = ReadStringForXMLNode( reader, scratchName );
+		if ( attributeName == nullptr )
+			return false;
+		const char* attributeValue = ReadStringForXMLNode( reader, scratchValue ); //Separate scratch, so attributeName survives.
+		if ( attributeValue == nullptr )
+			return false;
+		node.addAttribute( attributeName, attributeValue );
+	}
+
+	uint32_t numTexts;
+	if ( !reader.Read< uint32_t >( &numTexts ) )
+		return false;
+	for ( uint32_t textIndex = 0; textIndex < numTexts; textIndex++ )
+	{
+		const char* text = ReadStringForXMLNode( reader, scratchValue );
+		if ( text == nullptr )
+			return false;
+		node.addText( text );
+	}
+
+	uint32_t numChildren;
+	if ( !reader.Read< uint32_t >( &numChildren ) )
+		return false;
+	for ( uint32_t childIndex = 0; childIndex < numChildren; childIndex++ )
+	{
+		const char* childName = ReadStringForXMLNode( reader, scratchName );
+		if ( childName == nullptr )
+			return false;
+		XMLNode childNode = node.addChild( childName );
+		if ( !ReadXMLNodeContents( reader, childNode, scratchName, scratchValue ) )
+			return false;
+	}
+
+	return true;
+}
+
+
+
+///----------------------------------------------------------
+/// Inverse of WriteXMLNodeToBinary. On failure out_topNode
+/// holds whatever was read before the bad data.
+///----------------------------------------------------------
+bool ReadXMLNodeFromBinary( BinaryReader& reader, XMLNode& out_topNode )
+{
+	std::string scratchName;
+	std::string scratchValue;
+
+	const char* topNodeName = ReadStringForXMLNode( reader, scratchName );
+	if ( topNodeName == nullptr )
+		return false;
+
+	out_topNode = XMLNode::createXMLTopNode( topNodeName );
+	return ReadXMLNodeContents( reader, out_topNode, scratchName, scratchValue );
+}
+
+
+///----------------------------------------------------------
+/// Skips any other top-level elements, which our data files
+/// sometimes keep notes in.
+///----------------------------------------------------------
+bool FindXMLPullRootElement( XMLPullReader& reader, const char* rootTag )
+{
+	while ( reader.NextChildElement( 0 ) )
+	{
+		if ( reader.GetName() == rootTag )
+			return true;
+		if ( !reader.SkipElement() )
+			return false;
+	}
+	return false;
+}
+
+
+
+///----------------------------------------------------------
+/// 
+///----------------------------------------------------------
+static void AddXMLPullAttributes( const XMLPullReader& reader, XMLNode& node, std::string& scratchName, std::string& scratchValue )
+{
+	for ( int attributeIndex = 0; attributeIndex < reader.GetNumAttributes(); attributeIndex++ )
+	{
+		const XMLPullAttribute& attribute = reader.GetAttribute( attributeIndex );
+		scratchName.assign( attribute.m_name.GetData(), attribute.m_name.GetLength() ); //xmlParser wants terminated strings, and copies them.
+		DecodeXMLEntities( attribute.m_rawValue, scratchValue );
+		node.addAttribute( scratchName.c_str(), scratchValue.c_str() );
+	}
+}
+
+
+
+///----------------------------------------------------------
+void AddXMLAttributesFromPullReader( const XMLPullReader& reader, XMLNode& node )
+{
+	std::string scratchName;
+	std::string scratchValue;
+	AddXMLPullAttributes( reader, node, scratchName, scratchValue );
+}
+
+
+
+///----------------------------------------------------------
+/// 
+///----------------------------------------------------------
+static bool ReadXMLPullElementContents( XMLPullReader& reader, XMLNode& node, std::string& scratchName, std::string& scratchValue )
+{
+	AddXMLPullAttributes( reader, node, scratchName, scratchValue );
+
+	for ( ;; )
+	{
+		switch ( reader.Next() )
+		{
+		case XML_PULL_EVENT_START_ELEMENT:
+		{
+			scratchName.assign( reader.GetName().GetData(), reader.GetName().GetLength() );
+			XMLNode childNode = node.addChild( scratchName.c_str() );
+			if ( !ReadXMLPullElementContents( reader, childNode, scratchName, scratchValue ) )
+				return false;
+			break;
+		}
+		case XML_PULL_EVENT_TEXT:
+			reader.ReadText( scratchValue );
+			node.addText( scratchValue.c_str() );
+			break;
+		case XML_PULL_EVENT_END_ELEMENT: //Ours, since each child above consumed its own.
+			return true;
+		default:
+			return false;
+		}
+	}
+}
+
+
+
+///----------------------------------------------------------
+/// Counterpart to ReadXMLNodeFromBinary for XML text. Leaves
+/// the reader on the element's end event, so the caller can
+/// carry on streaming past it.
+///----------------------------------------------------------
+bool ReadXMLNodeFromPullReader( XMLPullReader& reader, XMLNode& out_topNode )
+{
+	if ( reader.GetEvent() != XML_PULL_EVENT_START_ELEMENT )
+		return false;
+
+	std::string scratchName( reader.GetName().GetData(), reader.GetName().GetLength() );
+	std::string scratchValue;
+
+	out_topNode = XMLNode::createXMLTopNode( scratchName.c_str() );
+	return ReadXMLPullElementContents( reader, out_topNode, scratchName, scratchValue );
+}
+
+
+
+///----------------------------------------------------------
+/// The file is mapped rather than read into the heap, and
+/// only rootTag's tree is built, in the one pass.
+///----------------------------------------------------------
+bool ParseXMLFileWithPullReader( const std::string& filePath, const char* rootTag, XMLNode& out_root )
+{
+	XMLPullReader reader;
+	if ( !reader.open( filePath.c_str() ) )
+	{
+		DebuggerPrintf( "ParseXMLFileWithPullReader() failed to open %s!\n", filePath.c_str() );
+		return false;
+	}
+
+	if ( FindXMLPullRootElement( reader, rootTag ) && ReadXMLNodeFromPullReader( reader, out_root ) )
+		return true;
+
+	if ( reader.GetEvent() == XML_PULL_EVENT_ERROR )
+		DebuggerPrintf( "ParseXMLFileWithPullReader() stopped at line %d of %s: %s\n", reader.GetErrorLineNumber(), filePath.c_str(), reader.GetErrorDescription() );
+	else
+		DebuggerPrintf( "ParseXMLFileWithPullReader() found no <%s> in %s!\n", rootTag, filePath.c_str() );
+	return false;
+}
+
+
+///----------------------------------------------------------
+/// What std::to_string and the ToString()s print, minus their
+/// temporary strings.
+///----------------------------------------------------------
+void AppendXMLAttributeValue( FormatBuffer& inout_buffer, int value )
+{
+	AppendInt( inout_buffer, value );
+}
+
+
+///----------------------------------------------------------
+void AppendXMLAttributeValue( FormatBuffer& inout_buffer, float value )
+{
+	AppendFloat( inout_buffer, value );
+}
+
+
+///----------------------------------------------------------
+void AppendXMLAttributeValue( FormatBuffer& inout_buffer, char value )
+{
+	inout_buffer.Append( value );
+}
+
+
+///----------------------------------------------------------
+void AppendXMLAttributeValue( FormatBuffer& inout_buffer, const std::string& value )
+{
+	inout_buffer.Append( value.c_str(), value.size() );
+}
+
+
+///----------------------------------------------------------
+void AppendXMLAttributeValue( FormatBuffer& inout_buffer, const Vector2i& value )
+{
+	AppendFormat( inout_buffer, CHECKED_FORMAT( "{},{}", value.x, value.y ) );
+}
+
+
+///----------------------------------------------------------
+void AppendXMLAttributeValue( FormatBuffer& inout_buffer, const Vector2f& value )
+{
+	AppendFormat( inout_buffer, CHECKED_FORMAT( "{},{}", value.x, value.y ) );
+}
+
+
+///----------------------------------------------------------
+void AppendXMLAttributeValue( FormatBuffer& inout_buffer, const Rgba& value )
+{
+	AppendFormat( inout_buffer, CHECKED_FORMAT( "{},{},{},{}", value.red, value.green, value.blue, value.alphaOpacity ) );
+}
+
+
+///----------------------------------------------------------
+void AppendXMLAttributeValue( FormatBuffer& inout_buffer, const Interval<int>& value )
+{
+	AppendFormat( inout_buffer, CHECKED_FORMAT( "{}~{}", value.minInclusive, value.maxInclusive ) );
+}
+
+
+///----------------------------------------------------------
+void AppendXMLAttributeValue( FormatBuffer& inout_buffer, const Interval<float>& value )
+{
+	AppendFormat( inout_buffer, CHECKED_FORMAT( "{}~{}", value.minInclusive, value.maxInclusive ) );
+}
@@ -10,6 +10,13 @@
 #include <string>
 #include "ThirdParty/Parsers/xmlparser/xmlParser.h"
 #include "Engine/String/StringUtils.hpp"
+#include "Engine/String/StringParsing.hpp"
+#include "Engine/String/StringFormat.hpp"
+
+
+class BinaryWriter;
+class BinaryReader;
+class XMLPullReader;
 
 
 //================================================================================================================================
@@ -19,6 +26,31 @@ std::string			GetXMLErrorDescForErrorCode( XMLError xmlErrorCode );
 bool				GetXMLNodeByNameSearchingFromPosition( const XMLNode& parentNode, const std::string& childName, int& position_inout, XMLNode& childNode_out );
 std::string			GetXMLAttributeAsString( const XMLNode& node, const std::string& attributeName, bool& wasAttributePresent_out );
 void				DestroyXMLDocument( XMLNode& xmlDocumentToDestroy );
+bool				WriteXMLNodeToBinary( BinaryWriter& writer, const XMLNode& node ); //Name, attributes, text, then children recursively. Comments are dropped.
+bool				ReadXMLNodeFromBinary( BinaryReader& reader, XMLNode& out_topNode ); //Rebuilds a top node without any text parsing.
+bool				FindXMLPullRootElement( XMLPullReader& reader, const char* rootTag ); //Steps to the first top-level element named rootTag, as openFileHelper's tag does.
+void				AddXMLAttributesFromPullReader( const XMLPullReader& reader, XMLNode& node ); //The current start event's, decoded.
+bool				ReadXMLNodeFromPullReader( XMLPullReader& reader, XMLNode& out_topNode ); //From the start event the reader is on through its end, so only that element's tree is built.
+bool				ParseXMLFileWithPullReader( const std::string& filePath, const char* rootTag, XMLNode& out_root ); //openFileHelper's tree from a mapped file, false on any error.
+
+
+//================================================================================================================================
+// The text WriteXMLAttribute saves each type as, appended rather than returned, the inverse of SetTypeFromStringView.
+// Each writes exactly what GetTypedObjectAsString would, so saves stay byte-identical.
+//================================================================================================================================
+void				AppendXMLAttributeValue( FormatBuffer& inout_buffer, int value );
+void				AppendXMLAttributeValue( FormatBuffer& inout_buffer, float value );
+void				AppendXMLAttributeValue( FormatBuffer& inout_buffer, char value );
+void				AppendXMLAttributeValue( FormatBuffer& inout_buffer, const std::string& value );
+void				AppendXMLAttributeValue( FormatBuffer& inout_buffer, const Vector2i& value );
+void				AppendXMLAttributeValue( FormatBuffer& inout_buffer, const Vector2f& value );
+void				AppendXMLAttributeValue( FormatBuffer& inout_buffer, const Rgba& value );
+void				AppendXMLAttributeValue( FormatBuffer& inout_buffer, const Interval<int>& value );
+void				AppendXMLAttributeValue( FormatBuffer& inout_buffer, const Interval<float>& value );
+template< typename ValueType > void AppendXMLAttributeValue( FormatBuffer& inout_buffer, const ValueType& value )
+{
+	inout_buffer.Append( GetTypedObjectAsString( value ) ); //Types without an overload above still go through ToString().
+}
 
 
 ///-----------------------------------------------------------------------------------
@@ -27,10 +59,10 @@ void				DestroyXMLDocument( XMLNode& xmlDocumentToDestroy );
 template< typename ValueType >
 ValueType GetXMLAttributeOfType( const XMLNode& node, const std::string& propertyName, bool& wasPropertyPresent_out )
 {
-	ValueType	outValue;
+	ValueType	outValue = ValueType();
 	std::string	valueAsString = GetXMLAttributeAsString( node, propertyName, wasPropertyPresent_out );
 	
-	SetTypeFromUnwrappedString( outValue, valueAsString );
+	SetTypeFromStringView( outValue, StringView( valueAsString ) );
 	return outValue;
 }
 
@@ -41,11 +73,22 @@ ValueType GetXMLAttributeOfType( const XMLNode& node, const std::string& propert
 template< typename ValueType >
 ValueType ReadXMLAttribute( const XMLNode& node, const std::string& propertyName, const ValueType& defaultValue )
 {
+	//The usual case, a plain attribute, parses right out of xmlParser's text without copying it to a std::string.
+	const char* attributeValue = node.getAttribute( propertyName.c_str() );
+	if ( attributeValue != nullptr )
+	{
+		node.markUsed();
+		ValueType outValue = defaultValue;
+		SetTypeFromStringView( outValue, StringView( attributeValue ) );
+		return outValue;
+	}
+
 	bool		wasPropertyPresent = false;
+	std::string	valueAsString = GetXMLAttributeAsString( node, propertyName, wasPropertyPresent ); //Child node text or value.
 
-	ValueType	outValue = GetXMLAttributeOfType< ValueType >( node, propertyName, wasPropertyPresent );
-	if ( !wasPropertyPresent )
-		outValue = defaultValue;
+	ValueType	outValue = defaultValue;
+	if ( wasPropertyPresent )
+		SetTypeFromStringView( outValue, StringView( valueAsString ) );
 
 	return outValue;
 }
@@ -60,9 +103,10 @@ void WriteXMLAttribute( XMLNode& node, const std::string& propertyName, const Va
 	if ( value == defaultValue )
 		return;
 
-	std::string	valueAsString = GetTypedObjectAsString( value );
-	
-	node.addAttribute( propertyName.c_str(), valueAsString.c_str() );
+	InlineFormatBuffer< 64 > valueAsString; //addAttribute copies it, so a stack buffer does.
+	AppendXMLAttributeValue( valueAsString, value );
+
+	node.addAttribute( propertyName.c_str(), valueAsString.GetCString() );
 }
 
 
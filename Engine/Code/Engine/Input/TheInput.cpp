@@ -17,12 +17,15 @@ const int TheInput::WM_RIGHT_MOUSE_BUTTON = 0x02;
 
 //--------------------------------------------------------------------------------------------------------------
 TheInput::TheInput()
-	: m_mouseWheelDelta( 0 )
+	: m_areKeyEdgesHeld( false )
+	, m_mouseWheelDelta( 0 )
 {
 	for ( int keyIndex = 0; keyIndex < NUM_KEYS; ++keyIndex )
 	{
 		m_keys[ keyIndex ].m_isKeyDown = false;
 		m_keys[ keyIndex ].m_didKeyJustChange = false;
+		m_keys[ keyIndex ].m_wasPressRestored = false;
+		m_wasKeyJustPressedWhileHeld[ keyIndex ] = false;
 	}
 	for ( int mouseButtonIndex = 0; mouseButtonIndex < NUM_MOUSE_BUTTONS; ++mouseButtonIndex )
 	{
@@ -42,6 +45,7 @@ void TheInput::SetKeyDownStatus( unsigned char asKey, bool isNowDown )
 	if ( asKey >= NUM_KEYS ) return;
 
 	m_keys[ asKey ].m_didKeyJustChange = ( m_keys[ asKey ].m_isKeyDown != isNowDown ? true : false );
+	m_keys[ asKey ].m_wasPressRestored = false;
 	m_keys[ asKey ].m_isKeyDown = isNowDown;
 }
 
@@ -74,7 +78,7 @@ bool TheInput::WasKeyJustPressed( unsigned char keyID ) const
 //--------------------------------------------------------------------------------------------------------------
 bool TheInput::WasKeyPressedOnce( unsigned char keyID ) const
 {
-	return m_keys[ keyID ].m_didKeyJustChange && m_keys[ keyID ].m_isKeyDown;
+	return m_keys[ keyID ].m_didKeyJustChange && ( m_keys[ keyID ].m_isKeyDown || m_keys[ keyID ].m_wasPressRestored );
 }
 
 
@@ -252,11 +256,55 @@ int TheInput::GetMouseButtonIndexFromWindowsMouseButtonEvent( int windowsMouseBu
 
 
 //--------------------------------------------------------------------------------------------------------------
-void TheInput::Update()
+void TheInput::ClearKeyEdges()
 {
-	//Keyboard.
 	for ( int keyIndex = 0; keyIndex < NUM_KEYS; ++keyIndex )
+	{
 		m_keys[ keyIndex ].m_didKeyJustChange = false;
+		m_keys[ keyIndex ].m_wasPressRestored = false;
+	}
+}
+
+
+//--------------------------------------------------------------------------------------------------------------
+void TheInput::HoldKeyEdges()
+{
+	//Kept aside rather than left in m_keys, so per-frame readers like TheConsole don't see them again next frame.
+	for ( int keyIndex = 0; keyIndex < NUM_KEYS; ++keyIndex )
+	{
+		if ( WasKeyPressedOnce( (unsigned char)keyIndex ) )
+		{
+			m_wasKeyJustPressedWhileHeld[ keyIndex ] = true;
+			m_areKeyEdgesHeld = true;
+		}
+	}
+}
+
+
+//--------------------------------------------------------------------------------------------------------------
+void TheInput::RestoreHeldKeyEdges()
+{
+	if ( !m_areKeyEdgesHeld )
+		return;
+
+	for ( int keyIndex = 0; keyIndex < NUM_KEYS; ++keyIndex )
+	{
+		if ( m_wasKeyJustPressedWhileHeld[ keyIndex ] ) //Even if let go since, or a tap shorter than a step would never reach one.
+		{
+			m_keys[ keyIndex ].m_didKeyJustChange = true;
+			m_keys[ keyIndex ].m_wasPressRestored = true;
+		}
+		m_wasKeyJustPressedWhileHeld[ keyIndex ] = false;
+	}
+	m_areKeyEdgesHeld = false;
+}
+
+
+//--------------------------------------------------------------------------------------------------------------
+void TheInput::Update()
+{
+	//Keyboard.
+	ClearKeyEdges();
 
 	//Controller updates, drop-ins/outs.
 	XINPUT_STATE xboxControllerState;
@@ -22,6 +22,7 @@ struct KeyButtonState
 {
 	bool m_isKeyDown;
 	bool m_didKeyJustChange;
+	bool m_wasPressRestored; //By RestoreHeldKeyEdges, so it still counts as a press if the key was let go meanwhile.
 };
 
 
@@ -40,6 +41,11 @@ public:
 	TheInput();
 	void Update();
 
+	//For updates that don't run once a frame, so each sees a press exactly once.
+	void ClearKeyEdges(); //After the first of several updates in a frame.
+	void HoldKeyEdges(); //After a frame that ran no update, to be restored before the next one that does.
+	void RestoreHeldKeyEdges();
+
 
 	//Keyboard.
 	void SetKeyDownStatus( unsigned char asKey, bool isNowDown ); //Used by WinMain key callback.
@@ -91,6 +97,8 @@ public:
 private:
 	static const int NUM_KEYS = 250;
 	KeyButtonState m_keys[ NUM_KEYS ];
+	bool m_wasKeyJustPressedWhileHeld[ NUM_KEYS ];
+	bool m_areKeyEdgesHeld;
 
 	static const int WM_LEFT_MOUSE_BUTTON;
 	static const int WM_RIGHT_MOUSE_BUTTON;
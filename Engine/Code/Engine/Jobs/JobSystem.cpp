@@ -0,0 +1,472 @@
+#include "Engine/Jobs/JobSystem.hpp"
+
+
+#include "Engine/Core/TheConsole.hpp"
+#include "Engine/Error/ErrorWarningAssert.hpp"
+#include "Engine/Time/Profiler.hpp"
+#include "Engine/EngineCommon.hpp"
+
+
+//--------------------------------------------------------------------------------------------------------------
+JobSystem* g_theJobSystem = nullptr;
+STATIC const unsigned int JobSystem::s_DEQUE_CAPACITY = 4096;
+STATIC const unsigned int JobSystem::s_JOBS_PER_THREAD_FOR_DEFAULT_GRAIN = 4; //Enough slack for stealing to even out uneven ranges.
+STATIC const int JobSystem::s_NUM_IDLE_SPINS_BEFORE_SLEEP = 256;
+
+
+//--------------------------------------------------------------------------------------------------------------
+static thread_local const JobSystem* t_owningJobSystem = nullptr;
+static thread_local unsigned int t_threadIndex = 0;
+
+
+//--------------------------------------------------------------------------------------------------------------
+// Chase-Lev deque over a fixed ring. Only the owner touches the bottom, so its push and pop need no lock, and
+// thieves race each other, and the owner for the last job, with one compare-exchange on the top.
+// Indices only ever grow, wrapping as unsigned ints, so their difference is the size even after overflow.
+//--------------------------------------------------------------------------------------------------------------
+class WorkStealingDeque
+{
+public:
+	WorkStealingDeque();
+	~WorkStealingDeque() { delete[] m_slots; }
+
+	bool Push( const Job& job ); //Owner only. False when full.
+	bool Pop( Job& out_job ); //Owner only, newest first.
+	bool Steal( Job& out_job ); //Any thread, oldest first. False when empty or when another thread won the race.
+
+
+private:
+	struct JobSlot //Atomic fields, since a thief may read a slot just as it's recycled, though it then loses the CAS and discards it.
+	{
+		std::atomic< JobFunction* > m_function;
+		std::atomic< void* > m_userData;
+		std::atomic< unsigned int > m_rangeBegin;
+		std::atomic< unsigned int > m_rangeEnd;
+		std::atomic< JobCounter* > m_counter;
+		std::atomic< const JobCounter* > m_dependency;
+	};
+
+	void WriteSlot( unsigned int index, const Job& job );
+	void ReadSlot( unsigned int index, Job& out_job ) const;
+
+	std::atomic< unsigned int > m_top;
+	char m_topPadding[ 64 - sizeof( std::atomic< unsigned int > ) ]; //Thieves hammer m_top, the owner m_bottom: keep them on separate lines.
+	std::atomic< unsigned int > m_bottom;
+	char m_bottomPadding[ 64 - sizeof( std::atomic< unsigned int > ) ];
+	JobSlot* m_slots;
+};
+
+
+//--------------------------------------------------------------------------------------------------------------
+WorkStealingDeque::WorkStealingDeque()
+	: m_top( 0 )
+	, m_bottom( 0 )
+	, m_slots( new JobSlot[ JobSystem::s_DEQUE_CAPACITY ] )
+{
+}
+
+
+//--------------------------------------------------------------------------------------------------------------
+void WorkStealingDeque::WriteSlot( unsigned int index, const Job& job )
+{
+	JobSlot& slot = m_slots[ index % JobSystem::s_DEQUE_CAPACITY ];
+	slot.m_function.store( job.m_function, std::memory_order_relaxed );
+	slot.m_userData.store( job.m_userData, std::memory_order_relaxed );
+	slot.m_rangeBegin.store( job.m_rangeBegin, std::memory_order_relaxed );
+	slot.m_rangeEnd.store( job.m_rangeEnd, std::memory_order_relaxed );
+	slot.m_counter.store( job.m_counter, std::memory_order_relaxed );
+	slot.m_dependency.store( job.m_dependency, std::memory_order_relaxed );
+}
+
+
+//--------------------------------------------------------------------------------------------------------------
+void WorkStealingDeque::ReadSlot( unsigned int index, Job& out_job ) const
+{
+	const JobSlot& slot = m_slots[ index % JobSystem::s_DEQUE_CAPACITY ];
+	out_job.m_function = slot.m_function.load( std::memory_order_relaxed );
+	out_job.m_userData = slot.m_userData.load( std::memory_order_relaxed );
+	out_job.m_rangeBegin = slot.m_rangeBegin.load( std::memory_order_relaxed );
+	out_job.m_rangeEnd = slot.m_rangeEnd.load( std::memory_order_relaxed );
+	out_job.m_counter = slot.m_counter.load( std::memory_order_relaxed );
+	out_job.m_dependency = slot.m_dependency.load( std::memory_order_relaxed );
+}
+
+
+//--------------------------------------------------------------------------------------------------------------
+bool WorkStealingDeque::Push( const Job& job )
+{
+	unsigned int bottom = m_bottom.load( std::memory_order_relaxed );
+	unsigned int top = m_top.load( std::memory_order_acquire );
+	if ( (int)( bottom - top ) >= (int)JobSystem::s_DEQUE_CAPACITY )
+		return false;
+
+	WriteSlot( bottom, job );
+	std::atomic_thread_fence( std::memory_order_release ); //The slot must be visible before the bottom that exposes it.
+	m_bottom.store( bottom + 1, std::memory_order_relaxed );
+	return true;
+}
+
+
+//--------------------------------------------------------------------------------------------------------------
+bool WorkStealingDeque::Pop( Job& out_job )
+{
+	unsigned int bottom = m_bottom.load( std::memory_order_relaxed ) - 1;
+	m_bottom.store( bottom, std::memory_order_relaxed ); //Reserve the newest slot first, then see whether a thief got there too.
+	std::atomic_thread_fence( std::memory_order_seq_cst );
+	unsigned int top = m_top.load( std::memory_order_relaxed );
+
+	if ( (int)( bottom - top ) < 0 )
+	{
+		m_bottom.store( bottom + 1, std::memory_order_relaxed ); //Was empty.
+		return false;
+	}
+
+	ReadSlot( bottom, out_job );
+	if ( bottom != top )
+		return true; //More than one was left, so no thief can be after this one.
+
+	bool didWin = m_top.compare_exchange_strong( top, top + 1, std::memory_order_seq_cst, std::memory_order_relaxed ); //The last job: race the thieves for it.
+	m_bottom.store( bottom + 1, std::memory_order_relaxed );
+	return didWin;
+}
+
+
+//--------------------------------------------------------------------------------------------------------------
+bool WorkStealingDeque::Steal( Job& out_job )
+{
+	unsigned int top = m_top.load( std::memory_order_acquire );
+	std::atomic_thread_fence( std::memory_order_seq_cst );
+	unsigned int bottom = m_bottom.load( std::memory_order_acquire );
+
+	if ( (int)( bottom - top ) <= 0 )
+		return false;
+
+	ReadSlot( top, out_job );
+	return m_top.compare_exchange_strong( top, top + 1, std::memory_order_seq_cst, std::memory_order_relaxed );
+}
+
+
+//--------------------------------------------------------------------------------------------------------------
+JobSystem::JobSystem( int numWorkerThreads /*= -1*/ )
+	: m_numQueuedJobs( 0 )
+	, m_numSleepingWorkers( 0 )
+	, m_isShuttingDown( false )
+	, m_numSharedJobs( 0 )
+	, m_numBlockedJobs( 0 )
+	, m_numJobsRunByOtherThreads( 0 )
+	, m_previousOwningJobSystem( t_owningJobSystem )
+	, m_previousThreadIndex( t_threadIndex )
+{
+	if ( numWorkerThreads < 0 )
+	{
+		int numCores = (int)std::thread::hardware_concurrency(); //0 if unknown.
+		numWorkerThreads = ( numCores > 1 ) ? ( numCores - 1 ) : 0;
+	}
+
+	for ( int threadIndex = 0; threadIndex <= numWorkerThreads; threadIndex++ )
+	{
+		WorkerState* worker = new WorkerState();
+		worker->m_deque = new WorkStealingDeque();
+		worker->m_numJobsRun.store( 0 );
+		worker->m_numJobsStolen.store( 0 );
+		m_workers.push_back( worker );
+	}
+
+	t_owningJobSystem = this;
+	t_threadIndex = 0;
+
+	for ( int threadIndex = 1; threadIndex <= numWorkerThreads; threadIndex++ ) //After every deque exists, since workers steal from all of them.
+		m_threads.push_back( std::thread( &JobSystem::RunWorker, this, (unsigned int)threadIndex ) );
+}
+
+
+//--------------------------------------------------------------------------------------------------------------
+JobSystem::~JobSystem()
+{
+	while ( m_numQueuedJobs.load() > 0 || m_numBlockedJobs.load() > 0 )
+	{
+		if ( !RunOneJob() )
+			std::this_thread::yield();
+	}
+
+	{
+		std::lock_guard< std::mutex > lock( m_sleepMutex );
+		m_isShuttingDown.store( true );
+	}
+	m_wakeCondition.notify_all();
+
+	for ( std::thread& thread : m_threads )
+		thread.join();
+
+	for ( WorkerState* worker : m_workers )
+	{
+		delete worker->m_deque;
+		delete worker;
+	}
+
+	if ( t_owningJobSystem == this ) //Else a bench's temporary system would leave the main thread out of g_theJobSystem's deques.
+	{
+		t_owningJobSystem = m_previousOwningJobSystem;
+		t_threadIndex = m_previousThreadIndex;
+	}
+}
+
+
+//--------------------------------------------------------------------------------------------------------------
+int JobSystem::GetThisThreadsIndex() const
+{
+	return ( t_owningJobSystem == this ) ? (int)t_threadIndex : -1;
+}
+
+
+//--------------------------------------------------------------------------------------------------------------
+unsigned int JobSystem::CalcDefaultGrainSize( unsigned int numIndices ) const
+{
+	unsigned int numRanges = GetNumThreads() * s_JOBS_PER_THREAD_FOR_DEFAULT_GRAIN;
+	unsigned int grainSize = numIndices / numRanges;
+	return ( grainSize > 0 ) ? grainSize : 1;
+}
+
+
+//--------------------------------------------------------------------------------------------------------------
+void JobSystem::QueueJob( const Job& job )
+{
+	if ( job.m_counter != nullptr )
+		job.m_counter->m_numUnfinishedJobs.fetch_add( 1, std::memory_order_relaxed );
+	m_numQueuedJobs.fetch_add( 1 );
+
+	int threadIndex = GetThisThreadsIndex();
+	if ( threadIndex >= 0 && m_workers[ threadIndex ]->m_deque->Push( job ) )
+		return;
+
+	std::lock_guard< std::mutex > lock( m_sharedJobsMutex );
+	m_sharedJobs.push_back( job );
+	m_numSharedJobs.fetch_add( 1, std::memory_order_release );
+}
+
+
+//--------------------------------------------------------------------------------------------------------------
+void JobSystem::WakeWorkers( unsigned int numJobsQueued )
+{
+	if ( numJobsQueued == 0 || m_numSleepingWorkers.load() == 0 )
+		return; //Seq_cst against RunWorker's increment, so either it sees the queued jobs or this sees it sleeping.
+
+	std::lock_guard< std::mutex > lock( m_sleepMutex );
+	if ( numJobsQueued == 1 )
+		m_wakeCondition.notify_one();
+	else
+		m_wakeCondition.notify_all();
+}
+
+
+//--------------------------------------------------------------------------------------------------------------
+void JobSystem::Run( const Job& job )
+{
+	QueueJob( job );
+	WakeWorkers( 1 );
+}
+
+
+//--------------------------------------------------------------------------------------------------------------
+bool JobSystem::TakeJob( Job& out_job )
+{
+	int threadIndex = GetThisThreadsIndex();
+	if ( threadIndex >= 0 && m_workers[ threadIndex ]->m_deque->Pop( out_job ) )
+		return true;
+
+	if ( m_numSharedJobs.load( std::memory_order_acquire ) > 0 )
+	{
+		std::lock_guard< std::mutex > lock( m_sharedJobsMutex );
+		if ( !m_sharedJobs.empty() )
+		{
+			out_job = m_sharedJobs.front();
+			m_sharedJobs.pop_front();
+			m_numSharedJobs.fetch_sub( 1, std::memory_order_relaxed );
+			return true;
+		}
+	}
+
+	unsigned int numWorkers = GetNumThreads();
+	unsigned int firstVictimIndex = ( threadIndex >= 0 ) ? ( threadIndex + 1 ) : 0; //Each thread starts with a different victim.
+	for ( unsigned int victimNum = 0; victimNum < numWorkers; victimNum++ )
+	{
+		unsigned int victimIndex = ( firstVictimIndex + victimNum ) % numWorkers;
+		if ( (int)victimIndex == threadIndex )
+			continue;
+
+		if ( m_workers[ victimIndex ]->m_deque->Steal( out_job ) )
+		{
+			if ( threadIndex >= 0 )
+			{
+				std::atomic< unsigned int >& numJobsStolen = m_workers[ threadIndex ]->m_numJobsStolen;
+				numJobsStolen.store( numJobsStolen.load( std::memory_order_relaxed ) + 1, std::memory_order_relaxed );
+			}
+			return true;
+		}
+	}
+
+	return false;
+}
+
+
+//--------------------------------------------------------------------------------------------------------------
+bool JobSystem::RunOneJob()
+{
+	Job job;
+	if ( !TakeJob( job ) )
+		return false;
+
+	if ( job.m_dependency != nullptr && !job.m_dependency->IsDone() && BlockJob( job ) )
+		return false;
+
+	m_numQueuedJobs.fetch_sub( 1 );
+	{
+		PROFILE_SCOPE( "Job" );
+		job.m_function( job.m_userData, job.m_rangeBegin, job.m_rangeEnd );
+	}
+	if ( job.m_counter != nullptr )
+	{
+		bool wasLastJob = ( job.m_counter->m_numUnfinishedJobs.fetch_sub( 1 ) == 1 ); //Seq_cst, see BlockJob.
+		if ( wasLastJob && m_numBlockedJobs.load() > 0 )
+			ReleaseBlockedJobs();
+	}
+
+	int threadIndex = GetThisThreadsIndex();
+	if ( threadIndex >= 0 )
+	{
+		std::atomic< unsigned int >& numJobsRun = m_workers[ threadIndex ]->m_numJobsRun;
+		numJobsRun.store( numJobsRun.load( std::memory_order_relaxed ) + 1, std::memory_order_relaxed );
+	}
+	else
+	{
+		m_numJobsRunByOtherThreads.fetch_add( 1, std::memory_order_relaxed );
+	}
+
+	return true;
+}
+
+
+//--------------------------------------------------------------------------------------------------------------
+bool JobSystem::BlockJob( const Job& job )
+{
+	std::lock_guard< std::mutex > lock( m_sharedJobsMutex );
+
+	//Seq_cst against RunOneJob's counter decrement then blocked count load: either this sees the dependency done,
+	//or the thread finishing it sees this job blocked and releases it.
+	m_numBlockedJobs.fetch_add( 1 );
+	if ( job.m_dependency->m_numUnfinishedJobs.load() == 0 )
+	{
+		m_numBlockedJobs.fetch_sub( 1 );
+		return false;
+	}
+
+	m_blockedJobs.push_back( job );
+	m_numQueuedJobs.fetch_sub( 1 ); //No longer work a sleeper should wake for.
+	return true;
+}
+
+
+//--------------------------------------------------------------------------------------------------------------
+void JobSystem::ReleaseBlockedJobs()
+{
+	unsigned int numJobsReleased = 0;
+	{
+		std::lock_guard< std::mutex > lock( m_sharedJobsMutex );
+		for ( size_t blockedIndex = 0; blockedIndex < m_blockedJobs.size(); )
+		{
+			if ( !m_blockedJobs[ blockedIndex ].m_dependency->IsDone() )
+			{
+				++blockedIndex;
+				continue;
+			}
+
+			m_numQueuedJobs.fetch_add( 1 ); //Before it's takeable, since RunOneJob counts it back down.
+			m_sharedJobs.push_back( m_blockedJobs[ blockedIndex ] );
+			m_numSharedJobs.fetch_add( 1, std::memory_order_release );
+			m_numBlockedJobs.fetch_sub( 1 );
+			m_blockedJobs[ blockedIndex ] = m_blockedJobs.back();
+			m_blockedJobs.pop_back();
+			++numJobsReleased;
+		}
+	}
+
+	WakeWorkers( numJobsReleased );
+}
+
+
+//--------------------------------------------------------------------------------------------------------------
+void JobSystem::WaitForCounter( const JobCounter& counter )
+{
+	while ( !counter.IsDone() )
+	{
+		if ( !RunOneJob() )
+			std::this_thread::yield(); //What's left is running elsewhere, or waiting on a dependency.
+	}
+}
+
+
+//--------------------------------------------------------------------------------------------------------------
+void JobSystem::RunWorker( unsigned int threadIndex )
+{
+	t_owningJobSystem = this;
+	t_threadIndex = threadIndex;
+
+	int numIdleSpins = 0;
+	while ( !m_isShuttingDown.load( std::memory_order_relaxed ) )
+	{
+		if ( RunOneJob() )
+		{
+			numIdleSpins = 0;
+			continue;
+		}
+
+		if ( ++numIdleSpins < s_NUM_IDLE_SPINS_BEFORE_SLEEP )
+		{
+			std::this_thread::yield();
+			continue;
+		}
+
+		m_numSleepingWorkers.fetch_add( 1 );
+		{
+			std::unique_lock< std::mutex > lock( m_sleepMutex );
+			while ( m_numQueuedJobs.load() == 0 && !m_isShuttingDown.load() )
+				m_wakeCondition.wait( lock );
+		}
+		m_numSleepingWorkers.fetch_sub( 1 );
+		numIdleSpins = 0;
+	}
+}
+
+
+//--------------------------------------------------------------------------------------------------------------
+unsigned int JobSystem::GetNumJobsRunByThread( unsigned int threadIndex ) const
+{
+	ASSERT_OR_DIE( threadIndex < GetNumThreads(), "JobSystem thread index out of range!" );
+	return m_workers[ threadIndex ]->m_numJobsRun.load( std::memory_order_relaxed );
+}
+
+
+//--------------------------------------------------------------------------------------------------------------
+unsigned int JobSystem::GetNumJobsStolenByThread( unsigned int threadIndex ) const
+{
+	ASSERT_OR_DIE( threadIndex < GetNumThreads(), "JobSystem thread index out of range!" );
+	return m_workers[ threadIndex ]->m_numJobsStolen.load( std::memory_order_relaxed );
+}
+
+
+//--------------------------------------------------------------------------------------------------------------
+void JobStats( Command& /*args*/ )
+{
+	if ( g_theJobSystem == nullptr )
+	{
+		g_theConsole->Print( "No job system is running." );
+		return;
+	}
+
+	for ( unsigned int threadIndex = 0; threadIndex < g_theJobSystem->GetNumThreads(); threadIndex++ )
+	{
+		g_theConsole->Format( CHECKED_FORMAT( "Job thread {}: {} jobs run, {} stolen.", threadIndex,
+											  g_theJobSystem->GetNumJobsRunByThread( threadIndex ), g_theJobSystem->GetNumJobsStolenByThread( threadIndex ) ) );
+	}
+	g_theConsole->Format( CHECKED_FORMAT( "Other threads: {} jobs run.", g_theJobSystem->GetNumJobsRunByOtherThreads() ) );
+}
@@ -0,0 +1,178 @@
+#pragma once
+
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+
+//-----------------------------------------------------------------------------
+class Command;
+class WorkStealingDeque;
+typedef void ( JobFunction )( void* userData, unsigned int rangeBegin, unsigned int rangeEnd );
+
+
+//-----------------------------------------------------------------------------
+class JobCounter //How many of a batch's jobs haven't finished. Wait on it, or make later jobs depend on it.
+{
+public:
+	JobCounter() : m_numUnfinishedJobs( 0 ) {}
+	bool IsDone() const { return m_numUnfinishedJobs.load( std::memory_order_acquire ) == 0; }
+
+
+private:
+	friend class JobSystem;
+	JobCounter( const JobCounter& ); //Jobs point at it, so it stays put until they finish.
+	void operator=( const JobCounter& );
+
+	std::atomic< int > m_numUnfinishedJobs;
+};
+
+
+//-----------------------------------------------------------------------------
+struct Job
+{
+	Job( JobFunction* function, void* userData, JobCounter* counter = nullptr, const JobCounter* dependency = nullptr, unsigned int rangeBegin = 0, unsigned int rangeEnd = 0 )
+		: m_function( function ), m_userData( userData ), m_rangeBegin( rangeBegin ), m_rangeEnd( rangeEnd ), m_counter( counter ), m_dependency( dependency ) {}
+	Job() : m_function( nullptr ), m_userData( nullptr ), m_rangeBegin( 0 ), m_rangeEnd( 0 ), m_counter( nullptr ), m_dependency( nullptr ) {}
+
+	JobFunction* m_function;
+	void* m_userData; //Must outlive the job, which is why ParallelFor waits before returning.
+	unsigned int m_rangeBegin;
+	unsigned int m_rangeEnd;
+	JobCounter* m_counter; //Counted up when queued and down once m_function returns. May be null.
+	const JobCounter* m_dependency; //The job isn't started until this is done. May be null.
+};
+
+
+//-----------------------------------------------------------------------------
+// A thread pool where each thread keeps its own deque of jobs: it pushes and pops the newest at one end without
+// contention, and idle threads steal the oldest from the other end, which tend to be the biggest remaining pieces.
+// The thread that constructs it counts as thread 0 and runs jobs only while waiting, so it's never left idle.
+// Threads the system doesn't own, e.g. BackgroundSaver's, queue to a shared locked list instead.
+// A job whose dependency isn't done yet is parked aside, uncounted, so workers sleep rather than spin on it, and
+// is put back in line when the last job of a counter finishes.
+// Systems may nest, e.g. a bench's temporary one: the constructing thread's index in the outer one is restored on
+// destruction, so destroy them on that thread, newest first.
+//-----------------------------------------------------------------------------
+class JobSystem
+{
+public:
+	JobSystem( int numWorkerThreads = -1 ); //-1 for one per core besides the constructing thread's.
+	~JobSystem(); //Runs everything still queued or blocked, then joins the workers.
+
+	void Run( const Job& job );
+	void WaitForCounter( const JobCounter& counter ); //Runs queued jobs meanwhile, so it's safe to call from inside a job.
+	bool RunOneJob(); //False if nothing was ready to run.
+	template < typename IndexFunction > void ParallelFor( unsigned int numIndices, unsigned int grainSize, const IndexFunction& function );
+
+	unsigned int GetNumThreads() const { return (unsigned int)m_workers.size(); } //Including the constructing thread.
+	unsigned int GetNumJobsRunByThread( unsigned int threadIndex ) const;
+	unsigned int GetNumJobsStolenByThread( unsigned int threadIndex ) const;
+	unsigned int GetNumJobsRunByOtherThreads() const { return m_numJobsRunByOtherThreads.load( std::memory_order_relaxed ); } //Those this doesn't own, while waiting.
+
+	static const unsigned int s_DEQUE_CAPACITY; //Per thread. Past this, jobs spill to the shared list.
+	static const unsigned int s_JOBS_PER_THREAD_FOR_DEFAULT_GRAIN; //A grainSize of 0 cuts work into this many ranges per thread.
+	static const int s_NUM_IDLE_SPINS_BEFORE_SLEEP;
+
+
+private:
+	struct WorkerState
+	{
+		WorkStealingDeque* m_deque;
+		std::atomic< unsigned int > m_numJobsRun; //Written only by the owning thread.
+		std::atomic< unsigned int > m_numJobsStolen;
+	};
+
+	JobSystem( const JobSystem& ); //Owns threads.
+	void operator=( const JobSystem& );
+
+	void QueueJob( const Job& job ); //Doesn't wake anyone, so a batch can wake once.
+	void WakeWorkers( unsigned int numJobsQueued );
+	bool TakeJob( Job& out_job );
+	bool BlockJob( const Job& job ); //False if its dependency finished meanwhile, so the caller should run it after all.
+	void ReleaseBlockedJobs(); //Requeues those whose dependency is now done.
+	void RunWorker( unsigned int threadIndex );
+	int GetThisThreadsIndex() const; //-1 for threads this doesn't own.
+	unsigned int CalcDefaultGrainSize( unsigned int numIndices ) const;
+
+	std::vector< WorkerState* > m_workers; //[0] is the constructing thread's.
+	std::vector< std::thread > m_threads;
+	std::atomic< int > m_numQueuedJobs; //Across every deque and the shared list, so sleepers know when to wake. Excludes blocked jobs.
+	std::atomic< int > m_numSleepingWorkers;
+	std::atomic< bool > m_isShuttingDown;
+
+	std::mutex m_sharedJobsMutex; //Guards m_sharedJobs and m_blockedJobs.
+	std::deque< Job > m_sharedJobs; //From threads without a deque, overflow, and jobs released from m_blockedJobs.
+	std::atomic< int > m_numSharedJobs; //So takers can skip the lock while it's empty.
+	std::vector< Job > m_blockedJobs; //Taken before their dependency was done.
+	std::atomic< int > m_numBlockedJobs; //So finishing counters can skip the lock while it's empty.
+	std::atomic< unsigned int > m_numJobsRunByOtherThreads;
+
+	std::mutex m_sleepMutex;
+	std::condition_variable m_wakeCondition;
+
+	const JobSystem* m_previousOwningJobSystem; //The constructing thread's, restored by the destructor.
+	unsigned int m_previousThreadIndex;
+};
+
+
+//-----------------------------------------------------------------------------
+extern JobSystem* g_theJobSystem;
+void JobStats( Command& args ); //Console command printing each thread's jobs run and stolen.
+
+
+//-----------------------------------------------------------------------------
+template < typename IndexFunction >
+void RunIndexFunctionOverRange( void* userData, unsigned int rangeBegin, unsigned int rangeEnd )
+{
+	const IndexFunction& function = *(const IndexFunction*)userData;
+	for ( unsigned int index = rangeBegin; index < rangeEnd; index++ )
+		function( index );
+}
+
+
+//-----------------------------------------------------------------------------
+// Calls function( index ) for every index below numIndices, grainSize indices to a job, and returns once all have.
+// Indices may run in any order and on any thread, so function must only write what belongs to its index.
+// A grainSize of 0 picks one from the thread count. The calling thread runs the first range itself, then helps out.
+//-----------------------------------------------------------------------------
+template < typename IndexFunction >
+void JobSystem::ParallelFor( unsigned int numIndices, unsigned int grainSize, const IndexFunction& function )
+{
+	if ( numIndices == 0 )
+		return;
+	if ( grainSize == 0 )
+		grainSize = CalcDefaultGrainSize( numIndices );
+
+	JobCounter counter;
+	unsigned int numJobsQueued = 0;
+	for ( unsigned int rangeBegin = grainSize; rangeBegin < numIndices; rangeBegin += grainSize )
+	{
+		unsigned int rangeEnd = ( numIndices - rangeBegin > grainSize ) ? ( rangeBegin + grainSize ) : numIndices;
+		QueueJob( Job( &RunIndexFunctionOverRange< IndexFunction >, (void*)&function, &counter, nullptr, rangeBegin, rangeEnd ) );
+		++numJobsQueued;
+	}
+	WakeWorkers( numJobsQueued );
+
+	RunIndexFunctionOverRange< IndexFunction >( (void*)&function, 0, ( numIndices > grainSize ) ? grainSize : numIndices );
+	WaitForCounter( counter );
+}
+
+
+//-----------------------------------------------------------------------------
+template < typename IndexFunction >
+void ParallelFor( unsigned int numIndices, unsigned int grainSize, const IndexFunction& function ) //Runs serially when there's no g_theJobSystem, e.g. in tools.
+{
+	if ( g_theJobSystem != nullptr )
+	{
+		g_theJobSystem->ParallelFor( numIndices, grainSize, function );
+		return;
+	}
+
+	for ( unsigned int index = 0; index < numIndices; index++ )
+		function( index );
+}
@@ -0,0 +1,175 @@
+#pragma once
+
+
+#include "Engine/Error/ErrorWarningAssert.hpp"
+#include <atomic>
+
+
+//-----------------------------------------------------------------------------
+// Bounded lock-free FIFOs over a power-of-two ring, allocated once. Neither ever blocks or allocates after
+// construction: a push into a full ring fails, and the caller decides whether to drop, retry, or drain.
+// T is copied in and out, so keep it plain data.
+//-----------------------------------------------------------------------------
+
+
+//-----------------------------------------------------------------------------
+// One producer thread, one consumer thread. Each index is written by only one side, so a push or pop is a load
+// of the other side's index and a store of its own.
+//-----------------------------------------------------------------------------
+template < typename T >
+class SpscRingQueue
+{
+public:
+	SpscRingQueue( unsigned int capacity );
+	~SpscRingQueue() { delete[] m_slots; }
+
+	bool TryPush( const T& value ); //Producer only.
+	bool TryPop( T& out_value ); //Consumer only.
+	unsigned int GetCapacity() const { return m_mask + 1; }
+
+
+private:
+	SpscRingQueue( const SpscRingQueue& );
+	void operator=( const SpscRingQueue& );
+
+	T* m_slots;
+	unsigned int m_mask;
+	std::atomic< unsigned int > m_head; //Next to pop, written by the consumer.
+	char m_headPadding[ 64 ]; //Keeps the two sides' indices off each other's cache line.
+	std::atomic< unsigned int > m_tail; //Next to push, written by the producer.
+};
+
+
+//-----------------------------------------------------------------------------
+template < typename T >
+SpscRingQueue< T >::SpscRingQueue( unsigned int capacity )
+	: m_slots( new T[ capacity ] )
+	, m_mask( capacity - 1 )
+	, m_head( 0 )
+	, m_tail( 0 )
+{
+	GUARANTEE_OR_DIE( capacity > 0 && ( capacity & ( capacity - 1 ) ) == 0, "SpscRingQueue capacity must be a power of two!" );
+}
+
+
+//-----------------------------------------------------------------------------
+template < typename T >
+bool SpscRingQueue< T >::TryPush( const T& value )
+{
+	unsigned int tail = m_tail.load( std::memory_order_relaxed );
+	if ( tail - m_head.load( std::memory_order_acquire ) > m_mask )
+		return false; //Full.
+
+	m_slots[ tail & m_mask ] = value;
+	m_tail.store( tail + 1, std::memory_order_release );
+	return true;
+}
+
+
+//-----------------------------------------------------------------------------
+template < typename T >
+bool SpscRingQueue< T >::TryPop( T& out_value )
+{
+	unsigned int head = m_head.load( std::memory_order_relaxed );
+	if ( head == m_tail.load( std::memory_order_acquire ) )
+		return false; //Empty.
+
+	out_value = m_slots[ head & m_mask ];
+	m_head.store( head + 1, std::memory_order_release );
+	return true;
+}
+
+
+//-----------------------------------------------------------------------------
+// Any number of producer threads, one consumer thread. Producers claim a slot by bumping m_tail with a CAS, and
+// each slot's sequence number says whose turn it is: equal to the claim's position when free to write, one past
+// it once written, and a lap ahead once consumed. So a slow producer holds up only the consumer, never the others.
+//-----------------------------------------------------------------------------
+template < typename T >
+class MpscRingQueue
+{
+public:
+	MpscRingQueue( unsigned int capacity );
+	~MpscRingQueue() { delete[] m_slots; }
+
+	bool TryPush( const T& value ); //Any thread.
+	bool TryPop( T& out_value ); //Consumer only. Also false while the oldest slot is claimed but still being written.
+	unsigned int GetCapacity() const { return m_mask + 1; }
+
+
+private:
+	struct Slot
+	{
+		std::atomic< unsigned int > m_sequence;
+		T m_value;
+	};
+
+	MpscRingQueue( const MpscRingQueue& );
+	void operator=( const MpscRingQueue& );
+
+	Slot* m_slots;
+	unsigned int m_mask;
+	std::atomic< unsigned int > m_tail; //Next to claim, contended by producers.
+	char m_tailPadding[ 64 ];
+	unsigned int m_head; //Next to pop, the consumer's alone.
+};
+
+
+//-----------------------------------------------------------------------------
+template < typename T >
+MpscRingQueue< T >::MpscRingQueue( unsigned int capacity )
+	: m_slots( new Slot[ capacity ] )
+	, m_mask( capacity - 1 )
+	, m_tail( 0 )
+	, m_head( 0 )
+{
+	GUARANTEE_OR_DIE( capacity > 0 && ( capacity & ( capacity - 1 ) ) == 0, "MpscRingQueue capacity must be a power of two!" );
+	for ( unsigned int slotIndex = 0; slotIndex < capacity; slotIndex++ )
+		m_slots[ slotIndex ].m_sequence.store( slotIndex, std::memory_order_relaxed );
+}
+
+
+//-----------------------------------------------------------------------------
+template < typename T >
+bool MpscRingQueue< T >::TryPush( const T& value )
+{
+	unsigned int position = m_tail.load( std::memory_order_relaxed );
+	Slot* slot;
+	for ( ;; )
+	{
+		slot = &m_slots[ position & m_mask ];
+		int lapDifference = (int)( slot->m_sequence.load( std::memory_order_acquire ) - position );
+		if ( lapDifference == 0 )
+		{
+			if ( m_tail.compare_exchange_weak( position, position + 1, std::memory_order_relaxed ) )
+				break;
+		}
+		else if ( lapDifference < 0 )
+		{
+			return false; //Still holds last lap's value, so the ring is full.
+		}
+		else
+		{
+			position = m_tail.load( std::memory_order_relaxed ); //Another producer claimed it first.
+		}
+	}
+
+	slot->m_value = value;
+	slot->m_sequence.store( position + 1, std::memory_order_release );
+	return true;
+}
+
+
+//-----------------------------------------------------------------------------
+template < typename T >
+bool MpscRingQueue< T >::TryPop( T& out_value )
+{
+	Slot& slot = m_slots[ m_head & m_mask ];
+	if ( slot.m_sequence.load( std::memory_order_acquire ) != m_head + 1 )
+		return false;
+
+	out_value = slot.m_value;
+	slot.m_sequence.store( m_head + m_mask + 1, std::memory_order_release ); //Free for the producer one lap on.
+	++m_head;
+	return true;
+}
@@ -37,14 +37,14 @@ template < typename IntervalElement > std::string Interval<IntervalElement>::ToS
 
 
 //--------------------------------------------------------------------------------------------------------------
-template <> std::string Interval<float>::ToString() const
+template <> inline std::string Interval<float>::ToString() const
 {
 	return Stringf( "%f~%f", minInclusive, maxInclusive );
 }
 
 
 //--------------------------------------------------------------------------------------------------------------
-template <> std::string Interval<int>::ToString() const
+template <> inline std::string Interval<int>::ToString() const
 {
 	return Stringf( "%d~%d", minInclusive, maxInclusive );
 }
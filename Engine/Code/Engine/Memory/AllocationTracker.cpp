@@ -0,0 +1,520 @@
+#include "Engine/Memory/AllocationTracker.hpp"
+#include "Engine/Core/Command.hpp"
+#include "Engine/Core/TheConsole.hpp"
+#include "Engine/Error/ErrorWarningAssert.hpp"
+#include "Engine/FileUtils/FileUtils.hpp"
+#include "Engine/String/StringUtils.hpp"
+#include "Engine/EngineCommon.hpp"
+
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+#include <DbgHelp.h>
+#pragma comment( lib, "dbghelp" ) //Symbols for reports only, never during tracking.
+
+#include <algorithm>
+#include <mutex>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <vector>
+
+
+//--------------------------------------------------------------------------------------------------------------
+static const unsigned int TRACKED_ALLOCATION_TABLE_BITS = 20;
+static const unsigned int CALL_SITE_TABLE_BITS = 14;
+static const unsigned int MAX_CALLSTACK_FRAMES = 16; //Enough to climb out of std:: and operator new into game code.
+static const unsigned int MAX_PROBES = 256; //Past this a table counts as full, so a miss never walks it all.
+static const unsigned int INVALID_CALL_SITE_INDEX = 0xFFFFFFFF;
+static const uintptr_t EMPTY_SLOT = 0; //Ends a probe.
+static const uintptr_t FREED_SLOT = 1; //Doesn't end a probe, since a later slot may hold the address sought, but may be reused.
+
+
+//--------------------------------------------------------------------------------------------------------------
+STATIC std::atomic<bool> AllocationTracker::s_isTracking( false );
+STATIC const unsigned int AllocationTracker::s_MAX_TRACKED_ALLOCATIONS = 1 << TRACKED_ALLOCATION_TABLE_BITS;
+STATIC const unsigned int AllocationTracker::s_MAX_CALL_SITES = 1 << CALL_SITE_TABLE_BITS;
+STATIC const unsigned int AllocationTracker::s_NUM_CONSOLE_REPORT_SITES = 12;
+STATIC const char* AllocationTracker::s_DEFAULT_REPORT_FILENAME = "MemoryReport.txt";
+STATIC const char* AllocationTracker::s_SHUTDOWN_REPORT_FILENAME = "MemoryLeaks.txt";
+
+
+//--------------------------------------------------------------------------------------------------------------
+struct TrackedAllocation
+{
+	std::atomic< uintptr_t > m_address; //EMPTY_SLOT, FREED_SLOT, or the block's.
+	size_t m_numBytes;
+	unsigned int m_callSiteIndex;
+};
+
+
+//--------------------------------------------------------------------------------------------------------------
+struct CallSite
+{
+	std::atomic< unsigned int > m_hash; //0 until claimed.
+	std::atomic< bool > m_isPublished; //Set after m_tag and m_frames are written, so others may compare against them.
+	const char* m_tag;
+	unsigned int m_numFrames;
+	void* m_frames[ MAX_CALLSTACK_FRAMES ];
+	std::atomic< intptr_t > m_numLiveBytes;
+	std::atomic< intptr_t > m_numLiveAllocations;
+	std::atomic< size_t > m_numTotalAllocations;
+	intptr_t m_snapshotLiveBytes;
+	intptr_t m_snapshotLiveAllocations;
+};
+
+
+//--------------------------------------------------------------------------------------------------------------
+static TrackedAllocation* s_trackedAllocations = nullptr; //Both calloc'd on the first StartTracking, never freed.
+static CallSite* s_callSites = nullptr;
+static AllocationTrackingMode s_trackingMode = TRACK_CALLSTACKS;
+static std::atomic< unsigned int > s_numDroppedAllocations( 0 );
+static std::mutex s_trackerMutex; //Taken by Start/Stop, snapshots, and reports, never by the hooks.
+static thread_local const char* t_currentTag = nullptr;
+static thread_local bool t_isWritingReport = false; //So a report's own strings aren't billed to whatever called it.
+
+
+//--------------------------------------------------------------------------------------------------------------
+STATIC const char* AllocationTracker::GetCurrentTag()
+{
+	return t_currentTag;
+}
+
+
+//--------------------------------------------------------------------------------------------------------------
+STATIC void AllocationTracker::SetCurrentTag( const char* tagName )
+{
+	t_currentTag = tagName;
+}
+
+
+//--------------------------------------------------------------------------------------------------------------
+static inline unsigned int GetFirstTrackedAllocationSlot( const void* ptr ) //Fibonacci hashing, keeping the well-mixed high bits.
+{
+	unsigned int hash = (unsigned int)( (uintptr_t)ptr >> 3 ) * 2654435761u;
+	return hash >> ( 32 - TRACKED_ALLOCATION_TABLE_BITS );
+}
+
+
+//--------------------------------------------------------------------------------------------------------------
+static unsigned int HashCallSite( const char* tag, void* const* frames, unsigned int numFrames ) //FNV-1a, never 0.
+{
+	unsigned int hash = 2166136261u;
+	uintptr_t tagAddress = (uintptr_t)tag;
+	hash = ( hash ^ (unsigned int)tagAddress ) * 16777619u;
+	for ( unsigned int frameIndex = 0; frameIndex < numFrames; frameIndex++ )
+		hash = ( hash ^ (unsigned int)(uintptr_t)frames[ frameIndex ] ) * 16777619u;
+
+	return ( hash != 0 ) ? hash : 1;
+}
+
+
+//--------------------------------------------------------------------------------------------------------------
+static bool DoesCallSiteMatch( const CallSite& site, const char* tag, void* const* frames, unsigned int numFrames )
+{
+	if ( site.m_tag != tag || site.m_numFrames != numFrames )
+		return false;
+
+	return memcmp( site.m_frames, frames, numFrames * sizeof( void* ) ) == 0;
+}
+
+
+//--------------------------------------------------------------------------------------------------------------
+static unsigned int FindOrAddCallSite()
+{
+	const char* tag = t_currentTag;
+	void* frames[ MAX_CALLSTACK_FRAMES ];
+	unsigned int numFrames = 0;
+	if ( s_trackingMode == TRACK_CALLSTACKS )
+		numFrames = CaptureStackBackTrace( 1, MAX_CALLSTACK_FRAMES, frames, nullptr ); //Skipping only this, the rest is trimmed when reported.
+
+	unsigned int hash = HashCallSite( tag, frames, numFrames );
+	unsigned int siteIndex = hash & ( AllocationTracker::s_MAX_CALL_SITES - 1 );
+
+	for ( unsigned int probeNum = 0; probeNum < MAX_PROBES; probeNum++ )
+	{
+		CallSite& site = s_callSites[ siteIndex ];
+		unsigned int siteHash = site.m_hash.load( std::memory_order_acquire );
+
+		if ( siteHash == 0 )
+		{
+			if ( site.m_hash.compare_exchange_strong( siteHash, hash, std::memory_order_acq_rel ) )
+			{
+				site.m_tag = tag;
+				site.m_numFrames = numFrames;
+				memcpy( site.m_frames, frames, numFrames * sizeof( void* ) );
+				site.m_isPublished.store( true, std::memory_order_release );
+				return siteIndex;
+			}
+			//Another thread claimed it first, and siteHash now holds its hash, which may well be this one.
+		}
+
+		if ( siteHash == hash )
+		{
+			while ( !site.m_isPublished.load( std::memory_order_acquire ) )
+			{
+				//Its claimer is between two stores, so this is never long.
+			}
+
+			if ( DoesCallSiteMatch( site, tag, frames, numFrames ) )
+				return siteIndex;
+		}
+
+		siteIndex = ( siteIndex + 1 ) & ( AllocationTracker::s_MAX_CALL_SITES - 1 );
+	}
+
+	return INVALID_CALL_SITE_INDEX;
+}
+
+
+//--------------------------------------------------------------------------------------------------------------
+STATIC void AllocationTracker::OnAllocate( void* ptr, size_t numBytes )
+{
+	if ( t_isWritingReport || ( ptr == nullptr ) )
+		return;
+
+	unsigned int callSiteIndex = FindOrAddCallSite();
+	if ( callSiteIndex == INVALID_CALL_SITE_INDEX )
+	{
+		s_numDroppedAllocations.fetch_add( 1, std::memory_order_relaxed );
+		return;
+	}
+
+	unsigned int slotIndex = GetFirstTrackedAllocationSlot( ptr );
+	for ( unsigned int probeNum = 0; probeNum < MAX_PROBES; probeNum++ )
+	{
+		TrackedAllocation& slot = s_trackedAllocations[ slotIndex ];
+		uintptr_t address = slot.m_address.load( std::memory_order_relaxed );
+
+		if ( ( address == EMPTY_SLOT || address == FREED_SLOT ) && slot.m_address.compare_exchange_strong( address, (uintptr_t)ptr, std::memory_order_relaxed ) )
+		{
+			slot.m_numBytes = numBytes; //No one can free ptr before this returns it, so these needn't be atomic.
+			slot.m_callSiteIndex = callSiteIndex;
+
+			CallSite& site = s_callSites[ callSiteIndex ];
+			site.m_numLiveBytes.fetch_add( (intptr_t)numBytes, std::memory_order_relaxed );
+			site.m_numLiveAllocations.fetch_add( 1, std::memory_order_relaxed );
+			site.m_numTotalAllocations.fetch_add( 1, std::memory_order_relaxed );
+			return;
+		}
+
+		slotIndex = ( slotIndex + 1 ) & ( s_MAX_TRACKED_ALLOCATIONS - 1 );
+	}
+
+	s_numDroppedAllocations.fetch_add( 1, std::memory_order_relaxed );
+}
+
+
+//--------------------------------------------------------------------------------------------------------------
+STATIC void AllocationTracker::OnFree( void* ptr )
+{
+	if ( ptr == nullptr )
+		return;
+
+	unsigned int slotIndex = GetFirstTrackedAllocationSlot( ptr );
+	for ( unsigned int probeNum = 0; probeNum < MAX_PROBES; probeNum++ )
+	{
+		TrackedAllocation& slot = s_trackedAllocations[ slotIndex ];
+		uintptr_t address = slot.m_address.load( std::memory_order_relaxed );
+
+		if ( address == EMPTY_SLOT )
+			return; //Allocated before tracking started, or dropped.
+
+		if ( address == (uintptr_t)ptr )
+		{
+			CallSite& site = s_callSites[ slot.m_callSiteIndex ];
+			site.m_numLiveBytes.fetch_sub( (intptr_t)slot.m_numBytes, std::memory_order_relaxed );
+			site.m_numLiveAllocations.fetch_sub( 1, std::memory_order_relaxed );
+			slot.m_address.store( FREED_SLOT, std::memory_order_relaxed );
+			return;
+		}
+
+		slotIndex = ( slotIndex + 1 ) & ( s_MAX_TRACKED_ALLOCATIONS - 1 );
+	}
+}
+
+
+//--------------------------------------------------------------------------------------------------------------
+STATIC void AllocationTracker::StartTracking( AllocationTrackingMode mode )
+{
+	std::lock_guard< std::mutex > lock( s_trackerMutex );
+	s_isTracking.store( false );
+
+	if ( s_trackedAllocations == nullptr )
+	{
+		s_trackedAllocations = (TrackedAllocation*)calloc( s_MAX_TRACKED_ALLOCATIONS, sizeof( TrackedAllocation ) ); //Not new, which is what's being tracked.
+		s_callSites = (CallSite*)calloc( s_MAX_CALL_SITES, sizeof( CallSite ) );
+		GUARANTEE_OR_DIE( s_trackedAllocations != nullptr && s_callSites != nullptr, "AllocationTracker failed to calloc its tables!" );
+	}
+	else //A hook still running on another thread may miscount one block, which a debugging aid can live with.
+	{
+		memset( s_trackedAllocations, 0, s_MAX_TRACKED_ALLOCATIONS * sizeof( TrackedAllocation ) );
+		memset( s_callSites, 0, s_MAX_CALL_SITES * sizeof( CallSite ) );
+	}
+
+	s_trackingMode = mode;
+	s_numDroppedAllocations.store( 0 );
+	s_isTracking.store( true );
+}
+
+
+//--------------------------------------------------------------------------------------------------------------
+STATIC void AllocationTracker::StopTracking()
+{
+	s_isTracking.store( false ); //operator delete stops looking blocks up too, so what's left is stale until the next start clears it.
+}
+
+
+//--------------------------------------------------------------------------------------------------------------
+STATIC void AllocationTracker::TakeSnapshot()
+{
+	std::lock_guard< std::mutex > lock( s_trackerMutex );
+	if ( s_callSites == nullptr )
+		return;
+
+	for ( unsigned int siteIndex = 0; siteIndex < s_MAX_CALL_SITES; siteIndex++ )
+	{
+		CallSite& site = s_callSites[ siteIndex ];
+		site.m_snapshotLiveBytes = site.m_numLiveBytes.load( std::memory_order_relaxed );
+		site.m_snapshotLiveAllocations = site.m_numLiveAllocations.load( std::memory_order_relaxed );
+	}
+}
+
+
+//--------------------------------------------------------------------------------------------------------------
+static void LoadSymbolsOnce() //DbgHelp isn't thread-safe, so this and its other calls stay under s_trackerMutex.
+{
+	static bool s_areSymbolsLoaded = false;
+	if ( s_areSymbolsLoaded )
+		return;
+
+	SymSetOptions( SYMOPT_UNDNAME | SYMOPT_DEFERRED_LOADS | SYMOPT_LOAD_LINES );
+	SymInitialize( GetCurrentProcess(), nullptr, TRUE );
+	s_areSymbolsLoaded = true;
+}
+
+
+//--------------------------------------------------------------------------------------------------------------
+static std::string GetFrameDescription( void* frame, bool* out_isInternal ) //Internal frames are the allocator's and std::'s.
+{
+	HANDLE process = GetCurrentProcess();
+
+	char symbolBytes[ sizeof( SYMBOL_INFO ) + MAX_SYM_NAME ];
+	SYMBOL_INFO* symbol = (SYMBOL_INFO*)symbolBytes;
+	symbol->SizeOfStruct = sizeof( SYMBOL_INFO );
+	symbol->MaxNameLen = MAX_SYM_NAME;
+
+	DWORD64 symbolDisplacement = 0;
+	if ( !SymFromAddr( process, (DWORD64)(uintptr_t)frame, &symbolDisplacement, symbol ) )
+	{
+		*out_isInternal = false;
+		return Stringf( "0x%p", frame );
+	}
+
+	const char* name = symbol->Name;
+	*out_isInternal = ( strncmp( name, "std::", 5 ) == 0 ) || ( strncmp( name, "operator new", 12 ) == 0 ) || ( strncmp( name, "AllocationTracker::", 19 ) == 0 );
+
+	IMAGEHLP_LINE64 line;
+	line.SizeOfStruct = sizeof( IMAGEHLP_LINE64 );
+	DWORD lineDisplacement = 0;
+	if ( !SymGetLineFromAddr64( process, (DWORD64)(uintptr_t)frame, &lineDisplacement, &line ) )
+		return name;
+
+	const char* filename = strrchr( line.FileName, '\\' );
+	return Stringf( "%s (%s:%u)", name, ( filename != nullptr ) ? filename + 1 : line.FileName, line.LineNumber );
+}
+
+
+//--------------------------------------------------------------------------------------------------------------
+static std::string GetCallSiteDescription( const CallSite& site, bool withFullCallstack ) //Else just the first frame outside std:: and new.
+{
+	std::string description = Stringf( "[%s]", ( site.m_tag != nullptr ) ? site.m_tag : "untagged" );
+	if ( site.m_numFrames == 0 )
+		return description;
+
+	LoadSymbolsOnce();
+	bool hasReachedCaller = false;
+	for ( unsigned int frameIndex = 0; frameIndex < site.m_numFrames; frameIndex++ )
+	{
+		bool isInternal;
+		std::string frameDescription = GetFrameDescription( site.m_frames[ frameIndex ], &isInternal );
+		if ( !hasReachedCaller && isInternal )
+			continue;
+
+		hasReachedCaller = true;
+		if ( !withFullCallstack )
+			return description + " " + frameDescription;
+
+		description += "\n\t\t" + frameDescription;
+	}
+
+	return description;
+}
+
+
+//--------------------------------------------------------------------------------------------------------------
+struct CallSiteReportRow
+{
+	unsigned int m_callSiteIndex;
+	intptr_t m_numBytes; //Live, or gained since the snapshot.
+	intptr_t m_numAllocations;
+};
+static bool IsRowLarger( const CallSiteReportRow& first, const CallSiteReportRow& second ) { return first.m_numBytes > second.m_numBytes; }
+
+
+//--------------------------------------------------------------------------------------------------------------
+static std::string BuildReport( unsigned int maxNumSites, bool isSnapshotDiff, bool withFullCallstacks ) //Call under s_trackerMutex.
+{
+	if ( s_callSites == nullptr )
+		return "No allocations have been tracked. Run MemTrackStart first.\n";
+
+	std::vector< CallSiteReportRow > rows;
+	intptr_t numTotalLiveBytes = 0;
+	intptr_t numTotalLiveAllocations = 0;
+	unsigned int numSites = 0;
+
+	for ( unsigned int siteIndex = 0; siteIndex < AllocationTracker::s_MAX_CALL_SITES; siteIndex++ )
+	{
+		const CallSite& site = s_callSites[ siteIndex ];
+		if ( !site.m_isPublished.load( std::memory_order_acquire ) )
+			continue;
+
+		++numSites;
+		CallSiteReportRow row;
+		row.m_callSiteIndex = siteIndex;
+		row.m_numBytes = site.m_numLiveBytes.load( std::memory_order_relaxed );
+		row.m_numAllocations = site.m_numLiveAllocations.load( std::memory_order_relaxed );
+		numTotalLiveBytes += row.m_numBytes;
+		numTotalLiveAllocations += row.m_numAllocations;
+
+		if ( isSnapshotDiff )
+		{
+			row.m_numBytes -= site.m_snapshotLiveBytes;
+			row.m_numAllocations -= site.m_snapshotLiveAllocations;
+		}
+		if ( row.m_numBytes > 0 )
+			rows.push_back( row );
+	}
+
+	std::sort( rows.begin(), rows.end(), IsRowLarger );
+	if ( rows.size() > maxNumSites )
+		rows.resize( maxNumSites );
+
+	std::string report = Stringf( "Tracked: %d KB live in %d blocks across %u call sites, %u allocations dropped.\n",
+								  (int)( numTotalLiveBytes / 1024 ), (int)numTotalLiveAllocations, numSites, s_numDroppedAllocations.load() );
+	report += isSnapshotDiff ? "Grown since the snapshot:\n" : "Most live bytes:\n";
+
+	for ( const CallSiteReportRow& row : rows )
+	{
+		const CallSite& site = s_callSites[ row.m_callSiteIndex ];
+		report += Stringf( isSnapshotDiff ? "\t+%d B in +%d blocks, %u made in all: " : "\t%d B in %d blocks, %u made in all: ",
+						   (int)row.m_numBytes, (int)row.m_numAllocations, (unsigned int)site.m_numTotalAllocations.load( std::memory_order_relaxed ) );
+		report += GetCallSiteDescription( site, withFullCallstacks );
+		report += "\n";
+	}
+
+	return report;
+}
+
+
+//--------------------------------------------------------------------------------------------------------------
+STATIC std::string AllocationTracker::GetLiveReport( unsigned int maxNumSites )
+{
+	std::lock_guard< std::mutex > lock( s_trackerMutex );
+	t_isWritingReport = true;
+	std::string report = BuildReport( maxNumSites, false, false );
+	t_isWritingReport = false;
+	return report;
+}
+
+
+//--------------------------------------------------------------------------------------------------------------
+STATIC std::string AllocationTracker::GetSnapshotDiffReport( unsigned int maxNumSites )
+{
+	std::lock_guard< std::mutex > lock( s_trackerMutex );
+	t_isWritingReport = true;
+	std::string report = BuildReport( maxNumSites, true, false );
+	t_isWritingReport = false;
+	return report;
+}
+
+
+//--------------------------------------------------------------------------------------------------------------
+STATIC bool AllocationTracker::WriteLiveReportToFile( const std::string& filePath )
+{
+	std::lock_guard< std::mutex > lock( s_trackerMutex );
+	t_isWritingReport = true;
+	std::string report = BuildReport( s_MAX_CALL_SITES, false, true );
+	std::vector< unsigned char > buffer( report.begin(), report.end() );
+	bool didSave = SaveBufferToBinaryFile( filePath, buffer );
+	t_isWritingReport = false;
+	return didSave;
+}
+
+
+//--------------------------------------------------------------------------------------------------------------
+static void PrintReportToConsole( const std::string& report ) //One Print per line, as the console doesn't wrap on '\n'.
+{
+	size_t lineStart = 0;
+	while ( lineStart < report.size() )
+	{
+		size_t lineEnd = report.find( '\n', lineStart );
+		if ( lineEnd == std::string::npos )
+			lineEnd = report.size();
+
+		g_theConsole->Print( StringView( report.c_str() + lineStart, lineEnd - lineStart ) );
+		lineStart = lineEnd + 1;
+	}
+}
+
+
+//--------------------------------------------------------------------------------------------------------------
+void MemTrackStart( Command& args )
+{
+	std::string modeName;
+	std::string defaultModeName = "callstacks";
+	args.GetNextString( &modeName, &defaultModeName );
+
+	AllocationTrackingMode mode = ( modeName == "tags" ) ? TRACK_TAGS_ONLY : TRACK_CALLSTACKS;
+	AllocationTracker::StartTracking( mode );
+	g_theConsole->Printf( "Allocation tracking started by %s. MemTrackReport [filename] lists live blocks, MemTrackSnapshot then MemTrackDiff what grew.",
+						  ( mode == TRACK_TAGS_ONLY ) ? "tag" : "callstack" );
+}
+
+
+//--------------------------------------------------------------------------------------------------------------
+void MemTrackStop( Command& /*args*/ )
+{
+	AllocationTracker::StopTracking();
+	g_theConsole->Printf( "Allocation tracking stopped." );
+}
+
+
+//--------------------------------------------------------------------------------------------------------------
+void MemTrackReport( Command& args )
+{
+	PrintReportToConsole( AllocationTracker::GetLiveReport( AllocationTracker::s_NUM_CONSOLE_REPORT_SITES ) );
+
+	std::string filename;
+	std::string defaultFilename = AllocationTracker::s_DEFAULT_REPORT_FILENAME;
+	args.GetNextString( &filename, &defaultFilename );
+
+	if ( AllocationTracker::WriteLiveReportToFile( filename ) )
+		g_theConsole->Printf( "Every call site, with callstacks, written to %s.", filename.c_str() );
+	else
+		g_theConsole->Printf( "Failed to write %s!", filename.c_str() );
+}
+
+
+//--------------------------------------------------------------------------------------------------------------
+void MemTrackSnapshot( Command& /*args*/ )
+{
+	AllocationTracker::TakeSnapshot();
+	g_theConsole->Printf( "Allocation snapshot taken. MemTrackDiff lists the call sites that have grown since." );
+}
+
+
+//--------------------------------------------------------------------------------------------------------------
+void MemTrackDiff( Command& /*args*/ )
+{
+	PrintReportToConsole( AllocationTracker::GetSnapshotDiffReport( AllocationTracker::s_NUM_CONSOLE_REPORT_SITES ) );
+}
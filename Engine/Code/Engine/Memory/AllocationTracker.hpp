@@ -0,0 +1,91 @@
+#pragma once
+
+
+#include <atomic>
+#include <stddef.h>
+#include <string>
+
+
+//-----------------------------------------------------------------------------
+class Command;
+
+
+//-----------------------------------------------------------------------------
+// Usage: MEMORY_TAG( "Pathfinding" ); at the top of a block to bill what it allocates to that tag until the block exits.
+// Tags cost a thread_local store whether or not tracking runs. Define DISABLE_ALLOCATION_TRACKER to compile them,
+// and the tracker's hooks in operator new and delete, out entirely.
+//-----------------------------------------------------------------------------
+#define MEMORY_TAG_CONCAT_INNER( prefix, line ) prefix##line
+#define MEMORY_TAG_CONCAT( prefix, line ) MEMORY_TAG_CONCAT_INNER( prefix, line )
+
+#if defined( DISABLE_ALLOCATION_TRACKER )
+#define MEMORY_TAG( tagName )
+#else
+#define MEMORY_TAG( tagName ) MemoryTagScope MEMORY_TAG_CONCAT( memoryTagScope_, __LINE__ )( tagName )
+#endif
+
+
+//-----------------------------------------------------------------------------
+enum AllocationTrackingMode
+{
+	TRACK_TAGS_ONLY, //Sites are just the innermost MEMORY_TAG, cheap enough to leave on through a play session.
+	TRACK_CALLSTACKS, //Sites are the tag plus the caller's stack, for finding which line leaks.
+	NUM_ALLOCATION_TRACKING_MODES
+};
+
+
+//-----------------------------------------------------------------------------
+// While tracking, operator new records each block's size and call site in a lock-free table keyed by address,
+// and every site keeps running live and total counts. Reports list the sites holding the most live bytes, and a
+// snapshot lets a later diff list only what has grown since, which is what a leak looks like over a soak run.
+// Nothing in the tracker goes through operator new, and its tables are allocated once and never freed.
+//-----------------------------------------------------------------------------
+class AllocationTracker
+{
+public:
+	static void StartTracking( AllocationTrackingMode mode ); //Discards anything tracked before.
+	static void StopTracking(); //Reports still work after, but blocks freed since stay listed.
+	static bool IsTracking() { return s_isTracking.load( std::memory_order_relaxed ); }
+
+	static void OnAllocate( void* ptr, size_t numBytes ); //Called by operator new, only while IsTracking().
+	static void OnFree( void* ptr ); //Called by operator delete while IsTracking(), before the block can be reused.
+
+	static void TakeSnapshot(); //Remembers every site's live counts for GetSnapshotDiffReport.
+	static std::string GetLiveReport( unsigned int maxNumSites ); //Sites by live bytes, most first.
+	static std::string GetSnapshotDiffReport( unsigned int maxNumSites ); //Sites by live bytes gained since TakeSnapshot.
+	static bool WriteLiveReportToFile( const std::string& filePath ); //Every site, with full callstacks.
+
+	static const char* GetCurrentTag();
+	static void SetCurrentTag( const char* tagName ); //Use MEMORY_TAG rather than calling this.
+
+	static const unsigned int s_MAX_TRACKED_ALLOCATIONS; //Past this, or a long probe, new blocks are counted as dropped.
+	static const unsigned int s_MAX_CALL_SITES;
+	static const unsigned int s_NUM_CONSOLE_REPORT_SITES;
+	static const char* s_DEFAULT_REPORT_FILENAME;
+	static const char* s_SHUTDOWN_REPORT_FILENAME;
+
+
+private:
+	static std::atomic<bool> s_isTracking;
+};
+
+
+//-----------------------------------------------------------------------------
+class MemoryTagScope
+{
+public:
+	MemoryTagScope( const char* tagName ) : m_previousTag( AllocationTracker::GetCurrentTag() ) { AllocationTracker::SetCurrentTag( tagName ); }
+	~MemoryTagScope() { AllocationTracker::SetCurrentTag( m_previousTag ); }
+
+
+private:
+	const char* m_previousTag; //Tags nest, so the outer one resumes once this scope exits.
+};
+
+
+//-----------------------------------------------------------------------------
+void MemTrackStart( Command& args ); //[tags|callstacks], defaulting to callstacks.
+void MemTrackStop( Command& args );
+void MemTrackReport( Command& args ); //Prints the top sites, and writes them all to [filename].
+void MemTrackSnapshot( Command& args );
+void MemTrackDiff( Command& args );
@@ -1,5 +1,10 @@
 #include "Engine/Memory/ByteUtils.hpp"
 
+#include <intrin.h>
+#include <immintrin.h>
+#include <stdlib.h>
+#include <string.h>
+
 
 EndianMode GetLocalMachineEndianness()
 {
@@ -14,4 +19,166 @@ EndianMode GetLocalMachineEndianness()
 	//If first byte is the least significant, we know it's little-endian: the "little end" was first.
 	return ( data.bdata[ 0 ] == 0X01 ) ? LITTLE_ENDIAN : BIG_ENDIAN;
 	//End Method 2.
-}
\ No newline at end of file
+}
+
+
+//--------------------------------------------------------------------------------------------------------------
+static ByteSwapPath DetectBestByteSwapPath()
+{
+	int cpuInfo[ 4 ]; //EAX, EBX, ECX, EDX.
+	__cpuid( cpuInfo, 0 );
+	int maxFunctionID = cpuInfo[ 0 ];
+
+	__cpuid( cpuInfo, 1 );
+	bool hasSSSE3 = ( cpuInfo[ 2 ] & ( 1 << 9 ) ) != 0;
+	bool hasOSXSAVE = ( cpuInfo[ 2 ] & ( 1 << 27 ) ) != 0;
+	bool hasAVX = ( cpuInfo[ 2 ] & ( 1 << 28 ) ) != 0;
+
+	//AVX2 also needs the OS to save the YMM registers on a context switch, which XCR0 bits 1 and 2 say.
+	bool hasAVX2 = false;
+	if ( maxFunctionID >= 7 && hasOSXSAVE && hasAVX && ( _xgetbv( 0 ) & 6 ) == 6 )
+	{
+		__cpuidex( cpuInfo, 7, 0 );
+		hasAVX2 = ( cpuInfo[ 1 ] & ( 1 << 5 ) ) != 0;
+	}
+
+	if ( hasAVX2 )
+		return BYTE_SWAP_PATH_AVX2;
+	return hasSSSE3 ? BYTE_SWAP_PATH_SSSE3 : BYTE_SWAP_PATH_SCALAR;
+}
+
+
+//--------------------------------------------------------------------------------------------------------------
+ByteSwapPath GetBestByteSwapPath()
+{
+	static const ByteSwapPath s_bestPath = DetectBestByteSwapPath();
+	return s_bestPath;
+}
+
+
+//--------------------------------------------------------------------------------------------------------------
+const char* GetByteSwapPathName( ByteSwapPath path )
+{
+	switch ( path )
+	{
+	case BYTE_SWAP_PATH_SCALAR: return "scalar";
+	case BYTE_SWAP_PATH_SSSE3: return "SSSE3";
+	case BYTE_SWAP_PATH_AVX2: return "AVX2";
+	default: return GetByteSwapPathName( GetBestByteSwapPath() );
+	}
+}
+
+
+//--------------------------------------------------------------------------------------------------------------
+static void CopyByteSwappedScalar( byte_t* out_swapped, const byte_t* source, size_t elementSize, size_t numElements )
+{
+	//memcpy in and out, as elements in a file buffer needn't be aligned.
+	switch ( elementSize )
+	{
+	case 2:
+		for ( size_t elementIndex = 0; elementIndex < numElements; elementIndex++, source += 2, out_swapped += 2 )
+		{
+			unsigned short value;
+			memcpy( &value, source, 2 );
+			value = _byteswap_ushort( value );
+			memcpy( out_swapped, &value, 2 );
+		}
+		break;
+	case 4:
+		for ( size_t elementIndex = 0; elementIndex < numElements; elementIndex++, source += 4, out_swapped += 4 )
+		{
+			unsigned long value;
+			memcpy( &value, source, 4 );
+			value = _byteswap_ulong( value );
+			memcpy( out_swapped, &value, 4 );
+		}
+		break;
+	case 8:
+		for ( size_t elementIndex = 0; elementIndex < numElements; elementIndex++, source += 8, out_swapped += 8 )
+		{
+			unsigned __int64 value;
+			memcpy( &value, source, 8 );
+			value = _byteswap_uint64( value );
+			memcpy( out_swapped, &value, 8 );
+		}
+		break;
+	default:
+		if ( out_swapped != source )
+			memcpy( out_swapped, source, elementSize * numElements );
+		for ( size_t elementIndex = 0; elementIndex < numElements; elementIndex++, out_swapped += elementSize )
+			ByteSwap( out_swapped, elementSize );
+		break;
+	}
+}
+
+
+//--------------------------------------------------------------------------------------------------------------
+static void GetByteSwapShuffleMask( size_t elementSize, byte_t out_mask[ 16 ] ) //Byte i of the result comes from byte out_mask[ i ].
+{
+	for ( size_t byteIndex = 0; byteIndex < 16; byteIndex++ )
+		out_mask[ byteIndex ] = (byte_t)( ( byteIndex - ( byteIndex % elementSize ) ) + ( elementSize - 1 - ( byteIndex % elementSize ) ) );
+}
+
+
+//--------------------------------------------------------------------------------------------------------------
+static size_t CopyByteSwappedSSSE3( byte_t* out_swapped, const byte_t* source, size_t elementSize, size_t numBytes ) //Returns the bytes it did, a multiple of 16.
+{
+	byte_t maskBytes[ 16 ];
+	GetByteSwapShuffleMask( elementSize, maskBytes );
+	const __m128i mask = _mm_loadu_si128( (const __m128i*)maskBytes );
+
+	size_t byteIndex = 0;
+	for ( ; byteIndex + 16 <= numBytes; byteIndex += 16 )
+	{
+		__m128i chunk = _mm_loadu_si128( (const __m128i*)( source + byteIndex ) );
+		_mm_storeu_si128( (__m128i*)( out_swapped + byteIndex ), _mm_shuffle_epi8( chunk, mask ) );
+	}
+	return byteIndex;
+}
+
+
+//--------------------------------------------------------------------------------------------------------------
+static size_t CopyByteSwappedAVX2( byte_t* out_swapped, const byte_t* source, size_t elementSize, size_t numBytes ) //Returns the bytes it did, a multiple of 32.
+{
+	byte_t maskBytes[ 16 ];
+	GetByteSwapShuffleMask( elementSize, maskBytes );
+	const __m128i laneMask = _mm_loadu_si128( (const __m128i*)maskBytes );
+	const __m256i mask = _mm256_broadcastsi128_si256( laneMask ); //vpshufb shuffles within each 16-byte lane.
+
+	size_t byteIndex = 0;
+	for ( ; byteIndex + 32 <= numBytes; byteIndex += 32 )
+	{
+		__m256i chunk = _mm256_loadu_si256( (const __m256i*)( source + byteIndex ) );
+		_mm256_storeu_si256( (__m256i*)( out_swapped + byteIndex ), _mm256_shuffle_epi8( chunk, mask ) );
+	}
+	return byteIndex;
+}
+
+
+//--------------------------------------------------------------------------------------------------------------
+void CopyByteSwapped( void* out_swapped, const void* source, size_t elementSize, size_t numElements, ByteSwapPath path /*= BYTE_SWAP_PATH_BEST*/ )
+{
+	if ( elementSize <= 1 )
+	{
+		if ( out_swapped != source )
+			memcpy( out_swapped, source, numElements );
+		return;
+	}
+
+	ByteSwapPath bestPath = GetBestByteSwapPath();
+	if ( path == BYTE_SWAP_PATH_BEST || path > bestPath )
+		path = bestPath;
+
+	byte_t* outBytes = (byte_t*)out_swapped;
+	const byte_t* sourceBytes = (const byte_t*)source;
+	size_t numBytes = elementSize * numElements;
+	size_t numBytesDone = 0;
+
+	bool isShuffleSize = ( elementSize == 2 || elementSize == 4 || elementSize == 8 ); //Elements that tile a lane evenly.
+	if ( isShuffleSize && path == BYTE_SWAP_PATH_AVX2 )
+		numBytesDone = CopyByteSwappedAVX2( outBytes, sourceBytes, elementSize, numBytes );
+	if ( isShuffleSize && path >= BYTE_SWAP_PATH_SSSE3 )
+		numBytesDone += CopyByteSwappedSSSE3( outBytes + numBytesDone, sourceBytes + numBytesDone, elementSize, numBytes - numBytesDone );
+
+	CopyByteSwappedScalar( outBytes + numBytesDone, sourceBytes + numBytesDone, elementSize, ( numBytes - numBytesDone ) / elementSize );
+}
@@ -51,3 +51,26 @@ static inline void ByteSwap( void* data, const size_t dataSize )
 		dataArray[ lastIndex - byteIndex ] = temp;
 	}
 }
+
+
+//-----------------------------------------------------------------------------
+enum ByteSwapPath //Which CopyByteSwapped kernel runs. Only benchmarks need to pick one.
+{
+	BYTE_SWAP_PATH_BEST = 0, //The widest the CPU supports, from CPUID on first use.
+	BYTE_SWAP_PATH_SCALAR,
+	BYTE_SWAP_PATH_SSSE3, //16 bytes per pshufb.
+	BYTE_SWAP_PATH_AVX2 //32 bytes per vpshufb.
+};
+extern ByteSwapPath GetBestByteSwapPath();
+extern const char* GetByteSwapPathName( ByteSwapPath path );
+
+
+//-----------------------------------------------------------------------------
+//Array version of ByteSwap: reverses each of numElements elementSize-byte values. out_swapped may be source itself.
+//Sizes 2, 4, and 8 go through the SIMD kernels, other sizes and the tails through the scalar loop.
+//A path the CPU lacks falls back to the best one it has.
+extern void CopyByteSwapped( void* out_swapped, const void* source, size_t elementSize, size_t numElements, ByteSwapPath path = BYTE_SWAP_PATH_BEST );
+static inline void ByteSwapArray( void* data, const size_t elementSize, const size_t numElements )
+{
+	CopyByteSwapped( data, data, elementSize, numElements );
+}
@@ -0,0 +1,253 @@
+#include "Engine/Memory/FrameAllocator.hpp"
+
+
+#include "Engine/Core/TheConsole.hpp"
+#include "Engine/Error/ErrorWarningAssert.hpp"
+#include "Engine/EngineCommon.hpp"
+#include <stdlib.h>
+
+
+//--------------------------------------------------------------------------------------------------------------
+FrameAllocator* g_theFrameAllocator = nullptr;
+STATIC const size_t FrameAllocator::s_DEFAULT_CAPACITY_BYTES_PER_FRAME = 1024 * 1024;
+STATIC const size_t FrameAllocator::s_DEFAULT_ALIGNMENT = 16;
+static const size_t MIN_OVERFLOW_CHUNK_BYTES = 64 * 1024;
+static thread_local bool t_isFrameAllocatorThread = false; //Only the thread that made g_theFrameAllocator may bump it.
+
+
+//--------------------------------------------------------------------------------------------------------------
+LinearArena::LinearArena( size_t capacityBytes )
+	: m_bytes( (byte_t*)malloc( capacityBytes ) ) //Not new, so it stays out of GetMemoryStats, as the traffic it replaces should.
+	, m_capacityBytes( capacityBytes )
+	, m_numBytesUsed( 0 )
+	, m_peakBytesUsed( 0 )
+	, m_overflowChunks( nullptr )
+	, m_numOverflowBytesUsed( 0 )
+	, m_numOverflowChunks( 0 )
+{
+	GUARANTEE_OR_DIE( m_bytes != nullptr, "LinearArena failed to malloc its buffer!" );
+}
+
+
+//--------------------------------------------------------------------------------------------------------------
+LinearArena::~LinearArena()
+{
+	Reset();
+	free( m_bytes );
+}
+
+
+//--------------------------------------------------------------------------------------------------------------
+void* LinearArena::Allocate( size_t numBytes, size_t alignment )
+{
+	if ( m_overflowChunks != nullptr ) //Once over, stay over until Reset, so Release always sees the newest block on top.
+		return AllocateFromOverflow( numBytes, alignment );
+
+	byte_t* start = AlignUp( m_bytes + m_numBytesUsed, alignment );
+	if ( start + numBytes > m_bytes + m_capacityBytes )
+		return AllocateFromOverflow( numBytes, alignment );
+
+	m_numBytesUsed = ( start + numBytes ) - m_bytes;
+	if ( GetNumBytesUsed() > m_peakBytesUsed )
+		m_peakBytesUsed = GetNumBytesUsed();
+	return start;
+}
+
+
+//--------------------------------------------------------------------------------------------------------------
+void* LinearArena::AllocateFromOverflow( size_t numBytes, size_t alignment )
+{
+	OverflowChunk* chunk = m_overflowChunks;
+	if ( chunk != nullptr )
+	{
+		byte_t* chunkBytes = (byte_t*)( chunk + 1 );
+		byte_t* start = AlignUp( chunkBytes + chunk->m_numBytesUsed, alignment );
+		if ( start + numBytes <= chunkBytes + chunk->m_capacityBytes )
+		{
+			size_t newNumBytesUsed = ( start + numBytes ) - chunkBytes;
+			m_numOverflowBytesUsed += newNumBytesUsed - chunk->m_numBytesUsed;
+			chunk->m_numBytesUsed = newNumBytesUsed;
+			if ( GetNumBytesUsed() > m_peakBytesUsed )
+				m_peakBytesUsed = GetNumBytesUsed();
+			return start;
+		}
+	}
+
+	size_t chunkCapacityBytes = m_capacityBytes / 4;
+	if ( chunkCapacityBytes < MIN_OVERFLOW_CHUNK_BYTES )
+		chunkCapacityBytes = MIN_OVERFLOW_CHUNK_BYTES;
+	if ( chunkCapacityBytes < numBytes + alignment )
+		chunkCapacityBytes = numBytes + alignment;
+
+	chunk = (OverflowChunk*)malloc( sizeof( OverflowChunk ) + chunkCapacityBytes );
+	GUARANTEE_OR_DIE( chunk != nullptr, "LinearArena failed to malloc an overflow chunk!" );
+	chunk->m_next = m_overflowChunks;
+	chunk->m_capacityBytes = chunkCapacityBytes;
+	chunk->m_numBytesUsed = 0;
+	m_overflowChunks = chunk;
+	++m_numOverflowChunks;
+
+	return AllocateFromOverflow( numBytes, alignment ); //Fits now.
+}
+
+
+//--------------------------------------------------------------------------------------------------------------
+bool LinearArena::Release( void* ptr, size_t numBytes )
+{
+	byte_t* releasedBytes = (byte_t*)ptr;
+
+	if ( m_overflowChunks != nullptr )
+	{
+		OverflowChunk* chunk = m_overflowChunks;
+		byte_t* chunkBytes = (byte_t*)( chunk + 1 );
+		if ( releasedBytes + numBytes != chunkBytes + chunk->m_numBytesUsed )
+			return false;
+
+		size_t newNumBytesUsed = releasedBytes - chunkBytes;
+		m_numOverflowBytesUsed -= chunk->m_numBytesUsed - newNumBytesUsed;
+		chunk->m_numBytesUsed = newNumBytesUsed;
+		return true;
+	}
+
+	if ( releasedBytes + numBytes != m_bytes + m_numBytesUsed )
+		return false; //Not the newest, so it waits for Reset.
+
+	m_numBytesUsed = releasedBytes - m_bytes;
+	return true;
+}
+
+
+//--------------------------------------------------------------------------------------------------------------
+void LinearArena::Reset( size_t minCapacityBytes /*= 0*/ )
+{
+	while ( m_overflowChunks != nullptr )
+	{
+		OverflowChunk* next = m_overflowChunks->m_next;
+		free( m_overflowChunks );
+		m_overflowChunks = next;
+	}
+
+	if ( m_capacityBytes < minCapacityBytes )
+	{
+		while ( m_capacityBytes < minCapacityBytes )
+			m_capacityBytes *= 2;
+
+		free( m_bytes ); //Nothing in it survives a Reset, so no realloc copy.
+		m_bytes = (byte_t*)malloc( m_capacityBytes );
+		GUARANTEE_OR_DIE( m_bytes != nullptr, "LinearArena failed to malloc its grown buffer!" );
+	}
+
+	m_numBytesUsed = 0;
+	m_peakBytesUsed = 0;
+	m_numOverflowBytesUsed = 0;
+	m_numOverflowChunks = 0;
+}
+
+
+//--------------------------------------------------------------------------------------------------------------
+bool LinearArena::Owns( const void* ptr ) const
+{
+	const byte_t* bytePtr = (const byte_t*)ptr;
+	if ( bytePtr >= m_bytes && bytePtr < m_bytes + m_capacityBytes )
+		return true;
+
+	for ( const OverflowChunk* chunk = m_overflowChunks; chunk != nullptr; chunk = chunk->m_next )
+	{
+		const byte_t* chunkBytes = (const byte_t*)( chunk + 1 );
+		if ( bytePtr >= chunkBytes && bytePtr < chunkBytes + chunk->m_capacityBytes )
+			return true;
+	}
+
+	return false;
+}
+
+
+//--------------------------------------------------------------------------------------------------------------
+FrameAllocator::FrameAllocator( size_t capacityBytesPerFrame /*= s_DEFAULT_CAPACITY_BYTES_PER_FRAME*/ )
+	: m_evenFrameArena( capacityBytesPerFrame )
+	, m_oddFrameArena( capacityBytesPerFrame )
+	, m_currentArena( &m_evenFrameArena )
+	, m_previousArena( &m_oddFrameArena )
+	, m_frameNumber( 0 )
+	, m_highWaterBytes( 0 )
+	, m_numOverflowedFrames( 0 )
+{
+	t_isFrameAllocatorThread = true;
+}
+
+
+//--------------------------------------------------------------------------------------------------------------
+FrameAllocator::~FrameAllocator()
+{
+	t_isFrameAllocatorThread = false;
+}
+
+
+//--------------------------------------------------------------------------------------------------------------
+void FrameAllocator::BeginFrame()
+{
+	const LinearArena& finishedArena = *m_currentArena;
+	if ( finishedArena.GetPeakBytesUsed() > m_highWaterBytes )
+		m_highWaterBytes = finishedArena.GetPeakBytesUsed();
+
+	if ( finishedArena.GetNumOverflowChunks() > 0 )
+	{
+		++m_numOverflowedFrames;
+		DebuggerPrintf( "FrameAllocator: frame %u peaked at %u KB, past its %u KB, in %d overflow chunks. Growing both arenas to fit.\n",
+						m_frameNumber, (unsigned int)( finishedArena.GetPeakBytesUsed() / 1024 ), (unsigned int)( finishedArena.GetCapacityBytes() / 1024 ),
+						finishedArena.GetNumOverflowChunks() );
+	}
+
+	LinearArena* olderArena = m_previousArena;
+	m_previousArena = m_currentArena;
+	m_currentArena = olderArena;
+	m_currentArena->Reset( m_highWaterBytes ); //Its allocations are two frames old now.
+	++m_frameNumber;
+}
+
+
+//--------------------------------------------------------------------------------------------------------------
+void* FrameAllocator::Allocate( size_t numBytes, size_t alignment /*= s_DEFAULT_ALIGNMENT*/ )
+{
+	return m_currentArena->Allocate( numBytes, alignment );
+}
+
+
+//--------------------------------------------------------------------------------------------------------------
+void* FrameAllocate( size_t numBytes, size_t alignment )
+{
+	if ( ( g_theFrameAllocator == nullptr ) || !t_isFrameAllocatorThread )
+		return malloc( numBytes ); //Job threads get the heap, as the arenas aren't locked.
+
+	return g_theFrameAllocator->Allocate( numBytes, alignment );
+}
+
+
+//--------------------------------------------------------------------------------------------------------------
+void FrameDeallocate( void* ptr, size_t numBytes )
+{
+	if ( ( g_theFrameAllocator == nullptr ) || !t_isFrameAllocatorThread || !g_theFrameAllocator->Owns( ptr ) )
+	{
+		free( ptr ); //Came from FrameAllocate's malloc, before the allocator existed or on another thread.
+		return;
+	}
+
+	g_theFrameAllocator->Deallocate( ptr, numBytes );
+}
+
+
+//--------------------------------------------------------------------------------------------------------------
+void FrameMemory( Command& /*args*/ )
+{
+	if ( g_theFrameAllocator == nullptr )
+	{
+		g_theConsole->Print( "No frame allocator is running." );
+		return;
+	}
+
+	g_theConsole->Format( CHECKED_FORMAT( "Frame memory: {} KB of {} KB used this frame, {} KB high water, {} frames overflowed.",
+										  (unsigned int)( g_theFrameAllocator->GetNumBytesUsedThisFrame() / 1024 ),
+										  (unsigned int)( g_theFrameAllocator->GetCapacityBytes() / 1024 ),
+										  (unsigned int)( g_theFrameAllocator->GetHighWaterBytes() / 1024 ),
+										  g_theFrameAllocator->GetNumOverflowedFrames() ) );
+}
@@ -0,0 +1,130 @@
+#pragma once
+
+
+#include <stddef.h>
+#include <vector>
+
+
+//-----------------------------------------------------------------------------
+class Command;
+typedef unsigned char byte_t;
+
+
+//-----------------------------------------------------------------------------
+// Bump allocator: Allocate() just advances an offset, and Reset() frees everything at once.
+// Past its capacity it chains overflow chunks off the heap rather than failing, and remembers how far over it went.
+//-----------------------------------------------------------------------------
+class LinearArena
+{
+public:
+	LinearArena( size_t capacityBytes );
+	~LinearArena();
+
+	void* Allocate( size_t numBytes, size_t alignment );
+	bool Release( void* ptr, size_t numBytes ); //Only takes back the newest allocation, e.g. a local vector's buffer as it goes out of scope.
+	void Reset( size_t minCapacityBytes = 0 ); //Frees overflow chunks, and grows to minCapacityBytes so the next use needn't overflow.
+	bool Owns( const void* ptr ) const;
+
+	size_t GetCapacityBytes() const { return m_capacityBytes; }
+	size_t GetNumBytesUsed() const { return m_numBytesUsed + m_numOverflowBytesUsed; }
+	size_t GetPeakBytesUsed() const { return m_peakBytesUsed; } //Since the last Reset.
+	int GetNumOverflowChunks() const { return m_numOverflowChunks; }
+
+
+private:
+	struct OverflowChunk
+	{
+		OverflowChunk* m_next;
+		size_t m_capacityBytes; //Not counting this header.
+		size_t m_numBytesUsed;
+	};
+
+	LinearArena( const LinearArena& );
+	void operator=( const LinearArena& );
+
+	void* AllocateFromOverflow( size_t numBytes, size_t alignment );
+	static byte_t* AlignUp( byte_t* ptr, size_t alignment ) { return (byte_t*)( ( (size_t)ptr + alignment - 1 ) & ~( alignment - 1 ) ); }
+
+	byte_t* m_bytes;
+	size_t m_capacityBytes;
+	size_t m_numBytesUsed;
+	size_t m_peakBytesUsed;
+	OverflowChunk* m_overflowChunks; //Newest first, the only one still being bumped.
+	size_t m_numOverflowBytesUsed; //Across every chunk, including alignment padding.
+	int m_numOverflowChunks;
+};
+
+
+//-----------------------------------------------------------------------------
+// Two LinearArenas that trade places each BeginFrame(), so scratch data made during one frame stays valid through
+// the next, then is dropped wholesale. For per-frame temporaries like neighbor lists and HUD strings,
+// which otherwise each cost a trip through the tracking operator new. Only the constructing thread draws from it:
+// elsewhere, e.g. in jobs, FrameAllocate falls back to the heap, so frame memory must never be handed across threads.
+//-----------------------------------------------------------------------------
+class FrameAllocator
+{
+public:
+	FrameAllocator( size_t capacityBytesPerFrame = s_DEFAULT_CAPACITY_BYTES_PER_FRAME );
+	~FrameAllocator();
+
+	void BeginFrame(); //Resets the older arena and makes it current.
+	void* Allocate( size_t numBytes, size_t alignment = s_DEFAULT_ALIGNMENT );
+	void Deallocate( void* ptr, size_t numBytes ) { m_currentArena->Release( ptr, numBytes ); }
+	bool Owns( const void* ptr ) const { return m_currentArena->Owns( ptr ) || m_previousArena->Owns( ptr ); }
+
+	unsigned int GetFrameNumber() const { return m_frameNumber; }
+	size_t GetNumBytesUsedThisFrame() const { return m_currentArena->GetNumBytesUsed(); }
+	size_t GetCapacityBytes() const { return m_currentArena->GetCapacityBytes(); }
+	size_t GetHighWaterBytes() const { return m_highWaterBytes; } //Largest single frame so far.
+	int GetNumOverflowedFrames() const { return m_numOverflowedFrames; }
+
+	static const size_t s_DEFAULT_CAPACITY_BYTES_PER_FRAME;
+	static const size_t s_DEFAULT_ALIGNMENT;
+
+
+private:
+	LinearArena m_evenFrameArena;
+	LinearArena m_oddFrameArena;
+	LinearArena* m_currentArena;
+	LinearArena* m_previousArena; //Still holding last frame's allocations.
+	unsigned int m_frameNumber;
+	size_t m_highWaterBytes;
+	int m_numOverflowedFrames;
+};
+
+
+//-----------------------------------------------------------------------------
+extern FrameAllocator* g_theFrameAllocator;
+
+
+//-----------------------------------------------------------------------------
+// What the STL adapter calls, safe before g_theFrameAllocator exists or after it's gone, when they use the heap.
+//-----------------------------------------------------------------------------
+void* FrameAllocate( size_t numBytes, size_t alignment );
+void FrameDeallocate( void* ptr, size_t numBytes );
+void FrameMemory( Command& args ); //Console command printing usage, high water, and overflows.
+
+
+//-----------------------------------------------------------------------------
+// Lets std containers draw from the frame allocator, e.g. FrameVector< Cell* > neighbors;
+// Anything allocated this way must be gone by the end of the next frame, so never keep one in a member.
+//-----------------------------------------------------------------------------
+template < typename T >
+class FrameStlAllocator
+{
+public:
+	typedef T value_type;
+
+	FrameStlAllocator() {}
+	template < typename U > FrameStlAllocator( const FrameStlAllocator< U >& ) {}
+
+	T* allocate( size_t count ) { return (T*)FrameAllocate( count * sizeof( T ), alignof( T ) ); }
+	void deallocate( T* ptr, size_t count ) { FrameDeallocate( ptr, count * sizeof( T ) ); }
+
+	template < typename U > bool operator==( const FrameStlAllocator< U >& ) const { return true; }
+	template < typename U > bool operator!=( const FrameStlAllocator< U >& ) const { return false; }
+};
+
+
+//-----------------------------------------------------------------------------
+template < typename T > using FrameVector = std::vector< T, FrameStlAllocator< T > >;
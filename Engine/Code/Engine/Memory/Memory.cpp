@@ -1,22 +1,89 @@
 #include "Engine/Error/ErrorWarningAssert.hpp"
 #include "Engine/Memory/Memory.hpp"
+#include "Engine/Memory/AllocationTracker.hpp"
+#include "Engine/Memory/SlabAllocator.hpp"
+
+#include <atomic>
+#include <stdlib.h>
+
+
+//--------------------------------------------------------------------------------------------------------------
+struct ThreadMemoryStats //Only its own thread writes it, so plain loads and stores suffice, atomic only so GetMemoryStats can read.
+{
+	std::atomic< intptr_t > m_numLiveAllocations; //Pointer-sized, as 64-bit atomics on Win32 take a locked cmpxchg8b even to load.
+	std::atomic< intptr_t > m_numLiveBytes;
+	std::atomic< size_t > m_numAllocationCalls;
+	ThreadMemoryStats* m_next;
+};
+
+
+//--------------------------------------------------------------------------------------------------------------
+static std::atomic< ThreadMemoryStats* > s_allThreadStats( nullptr ); //Never freed, so a finished thread's counts still add in.
+static thread_local ThreadMemoryStats* t_threadStats = nullptr;
+static const size_t BLOCK_HEADER_BYTES = 8; //Holds a size_t, padded so doubles stay 8-byte aligned on Win32 too.
+
+
+//--------------------------------------------------------------------------------------------------------------
+static ThreadMemoryStats* GetThreadStats()
+{
+	if ( t_threadStats != nullptr )
+		return t_threadStats;
+
+	ThreadMemoryStats* stats = (ThreadMemoryStats*)calloc( 1, sizeof( ThreadMemoryStats ) ); //Not new, which is what's asking.
+	stats->m_next = s_allThreadStats.load( std::memory_order_relaxed );
+	while ( !s_allThreadStats.compare_exchange_weak( stats->m_next, stats, std::memory_order_release, std::memory_order_relaxed ) )
+	{
+	}
+
+	t_threadStats = stats;
+	return stats;
+}
 
 
 //--------------------------------------------------------------------------------------------------------------
-int g_numberOfAllocations = 0;
-int g_totalAllocatedBytes = 0;
+template < typename T >
+static inline void AddToThreadCounter( std::atomic< T >& counter, T amount )
+{
+	counter.store( counter.load( std::memory_order_relaxed ) + amount, std::memory_order_relaxed ); //No lock prefix, unlike fetch_add.
+}
+
+
+//--------------------------------------------------------------------------------------------------------------
+MemoryStats GetMemoryStats()
+{
+	MemoryStats totals = { 0, 0, 0 };
+	for ( ThreadMemoryStats* stats = s_allThreadStats.load( std::memory_order_acquire ); stats != nullptr; stats = stats->m_next )
+	{
+		totals.m_numLiveAllocations += stats->m_numLiveAllocations.load( std::memory_order_relaxed );
+		totals.m_numLiveBytes += stats->m_numLiveBytes.load( std::memory_order_relaxed );
+		totals.m_numAllocationCalls += stats->m_numAllocationCalls.load( std::memory_order_relaxed );
+	}
+	return totals; //A block freed on another thread than made it leaves one thread negative, but the sum is right.
+}
 
 
 //--------------------------------------------------------------------------------------------------------------
 void* operator new( size_t numBytes )
 {
-	size_t* ptr = (size_t*)malloc( numBytes + sizeof( size_t ) );
-	//DebuggerPrintf( "Alloc %p of %u bytes.\n", ptr, numBytes );
-	++g_numberOfAllocations;
-	g_totalAllocatedBytes += numBytes;
+	size_t numBlockBytes = numBytes + BLOCK_HEADER_BYTES;
+#if defined( DISABLE_SLAB_ALLOCATOR )
+	unsigned char* block = (unsigned char*)malloc( numBlockBytes );
+#else
+	unsigned char* block = (unsigned char*)( SlabAllocator::IsSmall( numBlockBytes ) ? SlabAllocator::Allocate( numBlockBytes ) : malloc( numBlockBytes ) );
+#endif
+	//DebuggerPrintf( "Alloc %p of %u bytes.\n", block, numBytes );
+
+	ThreadMemoryStats* stats = GetThreadStats();
+	AddToThreadCounter< intptr_t >( stats->m_numLiveAllocations, 1 );
+	AddToThreadCounter< intptr_t >( stats->m_numLiveBytes, (intptr_t)numBytes );
+	AddToThreadCounter< size_t >( stats->m_numAllocationCalls, 1 );
 
-	*ptr = numBytes;
-	ptr++;
+	unsigned char* ptr = block + BLOCK_HEADER_BYTES;
+	( (size_t*)ptr )[ -1 ] = numBytes;
+#if !defined( DISABLE_ALLOCATION_TRACKER )
+	if ( AllocationTracker::IsTracking() )
+		AllocationTracker::OnAllocate( ptr, numBytes );
+#endif
 	return ptr;
 }
 
@@ -24,12 +91,35 @@ void* operator new( size_t numBytes )
 //--------------------------------------------------------------------------------------------------------------
 void operator delete( void* ptr )
 {
-	size_t* ptrSize = (size_t*)ptr;
-	--ptrSize;
-	size_t numBytes = *ptrSize;
+	if ( ptr == nullptr )
+		return;
 
-	--g_numberOfAllocations;
-	g_totalAllocatedBytes -= numBytes;
+#if !defined( DISABLE_ALLOCATION_TRACKER )
+	if ( AllocationTracker::IsTracking() )
+		AllocationTracker::OnFree( ptr );
+#endif
 
-	free( ptrSize ); //Free knows how to free the entire malloc, it's not tied to the size_t.
+	size_t numBytes = ( (size_t*)ptr )[ -1 ];
+	unsigned char* block = (unsigned char*)ptr - BLOCK_HEADER_BYTES;
+
+	ThreadMemoryStats* stats = GetThreadStats();
+	AddToThreadCounter< intptr_t >( stats->m_numLiveAllocations, -1 );
+	AddToThreadCounter< intptr_t >( stats->m_numLiveBytes, -(intptr_t)numBytes );
+
+#if defined( DISABLE_SLAB_ALLOCATOR )
+	free( block ); //Free knows how to free the entire malloc, it's not tied to the size_t.
+#else
+	size_t numBlockBytes = numBytes + BLOCK_HEADER_BYTES;
+	if ( SlabAllocator::IsSmall( numBlockBytes ) )
+		SlabAllocator::Free( block, numBlockBytes );
+	else
+		free( block ); //Free knows how to free the entire malloc, it's not tied to the size_t.
+#endif
+}
+
+
+//--------------------------------------------------------------------------------------------------------------
+void operator delete( void* ptr, size_t /*numBytes*/ )
+{
+	operator delete( ptr ); //The header's size is the one new saw, so trust it over the caller's.
 }
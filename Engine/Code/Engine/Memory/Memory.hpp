@@ -1,13 +1,27 @@
 #pragma once
 
 
+#include <stddef.h>
+#include <stdint.h>
+
+
+//--------------------------------------------------------------------------------------------------------------
+// Global operator new takes blocks up to SlabAllocator::s_MAX_BLOCK_BYTES from its size classes, and malloc past that.
+// #define DISABLE_SLAB_ALLOCATOR to send everything to malloc, e.g. to compare, or for a leak checker that hooks malloc.
+// Either way each block is preceded by its size, which keeps the stats and picks the size class on delete.
 //--------------------------------------------------------------------------------------------------------------
-extern int g_numberOfAllocations;
-extern int g_totalAllocatedBytes;
+struct MemoryStats
+{
+	int64_t m_numLiveAllocations;
+	int64_t m_numLiveBytes;
+	size_t m_numAllocationCalls; //Never decremented, so differences measure heap traffic rather than live blocks. Wraps, as size_t math does.
+};
+MemoryStats GetMemoryStats(); //Sums every thread's counters, so call it to report, not per allocation.
 
 
 //--------------------------------------------------------------------------------------------------------------
 void* operator new( size_t numBytes );
 void* operator new[]( size_t numBytes );
 void operator delete( void* ptr );
+void operator delete( void* ptr, size_t numBytes ); //C++14 sized delete, else the library's would free slab blocks to malloc.
 void operator delete[]( void* ptr );
@@ -0,0 +1,275 @@
+#include "Engine/Memory/SlabAllocator.hpp"
+
+
+#include "Engine/EngineCommon.hpp"
+#include <atomic>
+#include <stdlib.h>
+#include <thread>
+
+
+//--------------------------------------------------------------------------------------------------------------
+// Nothing here may call operator new, which is built on this, and everything must be usable before static init,
+// since other translation units' static constructors allocate. So: plain arrays and atomics, zero-initialized.
+//--------------------------------------------------------------------------------------------------------------
+struct FreeBlock
+{
+	FreeBlock* m_next;
+};
+
+
+//--------------------------------------------------------------------------------------------------------------
+struct CentralFreeList
+{
+	std::atomic_flag m_lock; //Zero-initialized static storage is clear.
+	FreeBlock* m_head;
+	char m_padding[ 64 - sizeof( std::atomic_flag ) - sizeof( FreeBlock* ) ]; //One cache line per class, so classes never contend.
+};
+
+
+//--------------------------------------------------------------------------------------------------------------
+struct ThreadFreeList
+{
+	FreeBlock* m_head;
+	unsigned int m_numBlocks;
+};
+
+
+//--------------------------------------------------------------------------------------------------------------
+struct ThreadCache
+{
+	ThreadFreeList m_freeLists[ SlabAllocator::s_NUM_SIZE_CLASSES ];
+	bool m_hasExitHandler;
+	bool m_hasThreadExited; //Set once FlushThreadCache ran, after which this thread goes straight to the central lists.
+};
+
+
+//--------------------------------------------------------------------------------------------------------------
+static CentralFreeList s_centralFreeLists[ SlabAllocator::s_NUM_SIZE_CLASSES ];
+static std::atomic< size_t > s_numSlabBytesReserved( 0 );
+static thread_local ThreadCache t_threadCache; //Trivially constructed, so no per-access init guard.
+
+
+//--------------------------------------------------------------------------------------------------------------
+static inline size_t GetSizeClassIndex( size_t numBytes )
+{
+	return ( numBytes - 1 ) / SlabAllocator::s_SIZE_CLASS_GRANULARITY;
+}
+
+
+//--------------------------------------------------------------------------------------------------------------
+static inline size_t GetBlockBytes( size_t sizeClassIndex )
+{
+	return ( sizeClassIndex + 1 ) * SlabAllocator::s_SIZE_CLASS_GRANULARITY;
+}
+
+
+//--------------------------------------------------------------------------------------------------------------
+static inline unsigned int GetNumBlocksPerBatch( size_t sizeClassIndex ) //How many move between a thread and the central list at once.
+{
+	unsigned int numBlocks = (unsigned int)( 4096 / GetBlockBytes( sizeClassIndex ) );
+	return ( numBlocks < 8 ) ? 8 : numBlocks;
+}
+
+
+//--------------------------------------------------------------------------------------------------------------
+static void LockCentralFreeList( CentralFreeList& freeList )
+{
+	for ( int numSpins = 0; freeList.m_lock.test_and_set( std::memory_order_acquire ); numSpins++ )
+	{
+		if ( numSpins >= 64 )
+			std::this_thread::yield(); //Held only for list splices and the odd slab malloc, so spinning first is usually enough.
+	}
+}
+
+
+//--------------------------------------------------------------------------------------------------------------
+static void UnlockCentralFreeList( CentralFreeList& freeList )
+{
+	freeList.m_lock.clear( std::memory_order_release );
+}
+
+
+//--------------------------------------------------------------------------------------------------------------
+static FreeBlock* CarveNewSlab( size_t sizeClassIndex ) //Returns the slab's blocks as a list. Called under the class's lock.
+{
+	const size_t blockBytes = GetBlockBytes( sizeClassIndex );
+	unsigned char* slabBytes = (unsigned char*)malloc( SlabAllocator::s_SLAB_BYTES );
+	if ( slabBytes == nullptr )
+		return nullptr;
+	s_numSlabBytesReserved.fetch_add( SlabAllocator::s_SLAB_BYTES, std::memory_order_relaxed );
+
+	unsigned char* firstBlock = (unsigned char*)( ( (size_t)slabBytes + 15 ) & ~(size_t)15 ); //malloc only promises 8 on x86.
+	size_t numBlocks = ( slabBytes + SlabAllocator::s_SLAB_BYTES - firstBlock ) / blockBytes;
+
+	for ( size_t blockIndex = 0; blockIndex < numBlocks - 1; blockIndex++ )
+		( (FreeBlock*)( firstBlock + ( blockIndex * blockBytes ) ) )->m_next = (FreeBlock*)( firstBlock + ( ( blockIndex + 1 ) * blockBytes ) );
+	( (FreeBlock*)( firstBlock + ( ( numBlocks - 1 ) * blockBytes ) ) )->m_next = nullptr;
+
+	return (FreeBlock*)firstBlock;
+}
+
+
+//--------------------------------------------------------------------------------------------------------------
+static void FlushThreadCache()
+{
+	for ( size_t sizeClassIndex = 0; sizeClassIndex < SlabAllocator::s_NUM_SIZE_CLASSES; sizeClassIndex++ )
+	{
+		ThreadFreeList& threadList = t_threadCache.m_freeLists[ sizeClassIndex ];
+		if ( threadList.m_head == nullptr )
+			continue;
+
+		FreeBlock* tail = threadList.m_head;
+		while ( tail->m_next != nullptr )
+			tail = tail->m_next;
+
+		CentralFreeList& centralList = s_centralFreeLists[ sizeClassIndex ];
+		LockCentralFreeList( centralList );
+		tail->m_next = centralList.m_head;
+		centralList.m_head = threadList.m_head;
+		UnlockCentralFreeList( centralList );
+
+		threadList.m_head = nullptr;
+		threadList.m_numBlocks = 0;
+	}
+
+	t_threadCache.m_hasThreadExited = true;
+}
+
+
+//--------------------------------------------------------------------------------------------------------------
+struct ThreadCacheExitHandler //Its thread_local destructor hands a finished thread's cached blocks back to everyone.
+{
+	~ThreadCacheExitHandler() { FlushThreadCache(); }
+};
+static thread_local ThreadCacheExitHandler t_threadCacheExitHandler;
+
+
+//--------------------------------------------------------------------------------------------------------------
+static inline void EnsureThreadCacheExitHandler() //Before this thread first caches a block, whether by allocating or freeing.
+{
+	if ( !t_threadCache.m_hasExitHandler )
+	{
+		t_threadCache.m_hasExitHandler = true;
+		(void)&t_threadCacheExitHandler; //First use constructs it, which registers its destructor for this thread's exit.
+	}
+}
+
+
+//--------------------------------------------------------------------------------------------------------------
+static FreeBlock* RefillThreadFreeList( size_t sizeClassIndex ) //Returns one block for the caller, caching up to a batch more.
+{
+	EnsureThreadCacheExitHandler();
+
+	const unsigned int numBlocksWanted = GetNumBlocksPerBatch( sizeClassIndex ) + 1;
+	CentralFreeList& centralList = s_centralFreeLists[ sizeClassIndex ];
+
+	LockCentralFreeList( centralList );
+	if ( centralList.m_head == nullptr )
+		centralList.m_head = CarveNewSlab( sizeClassIndex );
+
+	FreeBlock* batchHead = centralList.m_head;
+	FreeBlock* batchTail = batchHead;
+	unsigned int numBlocksTaken = ( batchHead != nullptr ) ? 1 : 0;
+	while ( ( batchTail != nullptr ) && ( numBlocksTaken < numBlocksWanted ) && ( batchTail->m_next != nullptr ) )
+	{
+		batchTail = batchTail->m_next;
+		++numBlocksTaken;
+	}
+	if ( batchTail != nullptr )
+	{
+		centralList.m_head = batchTail->m_next;
+		batchTail->m_next = nullptr;
+	}
+	UnlockCentralFreeList( centralList );
+
+	if ( batchHead == nullptr )
+		return nullptr; //Out of memory.
+
+	if ( !t_threadCache.m_hasThreadExited )
+	{
+		ThreadFreeList& threadList = t_threadCache.m_freeLists[ sizeClassIndex ];
+		threadList.m_head = batchHead->m_next;
+		threadList.m_numBlocks = numBlocksTaken - 1;
+	}
+	else if ( batchHead->m_next != nullptr ) //Late allocation during thread teardown: give the rest straight back.
+	{
+		LockCentralFreeList( centralList );
+		batchTail->m_next = centralList.m_head;
+		centralList.m_head = batchHead->m_next;
+		UnlockCentralFreeList( centralList );
+	}
+
+	return batchHead;
+}
+
+
+//--------------------------------------------------------------------------------------------------------------
+static void ReturnBatchToCentral( ThreadFreeList& threadList, size_t sizeClassIndex ) //Keeps a thread that only frees from hoarding.
+{
+	const unsigned int numBlocksToReturn = GetNumBlocksPerBatch( sizeClassIndex );
+
+	FreeBlock* batchHead = threadList.m_head;
+	FreeBlock* batchTail = batchHead;
+	for ( unsigned int blockIndex = 1; blockIndex < numBlocksToReturn; blockIndex++ )
+		batchTail = batchTail->m_next;
+
+	threadList.m_head = batchTail->m_next;
+	threadList.m_numBlocks -= numBlocksToReturn;
+
+	CentralFreeList& centralList = s_centralFreeLists[ sizeClassIndex ];
+	LockCentralFreeList( centralList );
+	batchTail->m_next = centralList.m_head;
+	centralList.m_head = batchHead;
+	UnlockCentralFreeList( centralList );
+}
+
+
+//--------------------------------------------------------------------------------------------------------------
+STATIC void* SlabAllocator::Allocate( size_t numBytes )
+{
+	size_t sizeClassIndex = GetSizeClassIndex( numBytes );
+	ThreadFreeList& threadList = t_threadCache.m_freeLists[ sizeClassIndex ];
+
+	FreeBlock* block = threadList.m_head;
+	if ( block == nullptr )
+		return RefillThreadFreeList( sizeClassIndex );
+
+	threadList.m_head = block->m_next;
+	--threadList.m_numBlocks;
+	return block;
+}
+
+
+//--------------------------------------------------------------------------------------------------------------
+STATIC void SlabAllocator::Free( void* block, size_t numBytes )
+{
+	size_t sizeClassIndex = GetSizeClassIndex( numBytes );
+	FreeBlock* freedBlock = (FreeBlock*)block;
+
+	if ( t_threadCache.m_hasThreadExited )
+	{
+		CentralFreeList& centralList = s_centralFreeLists[ sizeClassIndex ];
+		LockCentralFreeList( centralList );
+		freedBlock->m_next = centralList.m_head;
+		centralList.m_head = freedBlock;
+		UnlockCentralFreeList( centralList );
+		return;
+	}
+
+	EnsureThreadCacheExitHandler(); //A thread that only frees, e.g. a worker freeing the main thread's blocks, would otherwise leak its lists.
+
+	ThreadFreeList& threadList = t_threadCache.m_freeLists[ sizeClassIndex ];
+	freedBlock->m_next = threadList.m_head;
+	threadList.m_head = freedBlock;
+	++threadList.m_numBlocks;
+
+	if ( threadList.m_numBlocks >= 2 * GetNumBlocksPerBatch( sizeClassIndex ) )
+		ReturnBatchToCentral( threadList, sizeClassIndex );
+}
+
+
+//--------------------------------------------------------------------------------------------------------------
+STATIC size_t SlabAllocator::GetNumSlabBytesReserved()
+{
+	return s_numSlabBytesReserved.load( std::memory_order_relaxed );
+}
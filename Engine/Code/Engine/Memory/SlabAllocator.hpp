@@ -0,0 +1,25 @@
+#pragma once
+
+
+#include <stddef.h>
+
+
+//-----------------------------------------------------------------------------
+// Size-class allocator for small blocks, e.g. PathNodes and std::map nodes, which malloc handles generically and slowly.
+// Each class carves 64KB slabs into equal blocks. A thread keeps its own free list per class, so most allocations
+// and frees touch no lock; it trades blocks with a spinlocked central list per class only in batches.
+// Slabs are never handed back to malloc, so memory stays with the size class that first needed it.
+//-----------------------------------------------------------------------------
+class SlabAllocator
+{
+public:
+	static bool IsSmall( size_t numBytes ) { return numBytes <= s_MAX_BLOCK_BYTES; }
+	static void* Allocate( size_t numBytes ); //numBytes must be IsSmall and nonzero. Blocks are 16-byte aligned.
+	static void Free( void* block, size_t numBytes ); //numBytes as it was passed to Allocate.
+	static size_t GetNumSlabBytesReserved();
+
+	static const size_t s_MAX_BLOCK_BYTES = 256;
+	static const size_t s_SIZE_CLASS_GRANULARITY = 16;
+	static const size_t s_NUM_SIZE_CLASSES = s_MAX_BLOCK_BYTES / s_SIZE_CLASS_GRANULARITY;
+	static const size_t s_SLAB_BYTES = 64 * 1024;
+};
@@ -0,0 +1,96 @@
+#pragma once
+
+
+#include <cstring>
+
+
+//-----------------------------------------------------------------------------
+// Vector of trivially-copyable elements (pointers, ints, PODs) that keeps the first INLINE_CAPACITY of them inside the object.
+// Only spills to the heap past that, so typical small collections (e.g. an NPC's inventory) never allocate.
+//-----------------------------------------------------------------------------
+template < typename T, unsigned int INLINE_CAPACITY >
+class SmallVector
+{
+public:
+	typedef T* iterator;
+	typedef const T* const_iterator;
+
+	SmallVector() : m_data( m_inlineData ), m_size( 0 ), m_capacity( INLINE_CAPACITY ) {}
+	SmallVector( const SmallVector& other ) : m_data( m_inlineData ), m_size( 0 ), m_capacity( INLINE_CAPACITY ) { *this = other; }
+	~SmallVector() { if ( IsOnHeap() ) delete[] m_data; }
+
+	SmallVector& operator=( const SmallVector& other )
+	{
+		if ( this == &other )
+			return *this;
+
+		clear();
+		reserve( other.m_size );
+		memcpy( m_data, other.m_data, other.m_size * sizeof( T ) );
+		m_size = other.m_size;
+		return *this;
+	}
+
+	unsigned int size() const { return m_size; }
+	unsigned int capacity() const { return m_capacity; }
+	bool empty() const { return m_size == 0; }
+	bool IsOnHeap() const { return m_data != m_inlineData; }
+
+	T& operator[]( unsigned int index ) { return m_data[ index ]; }
+	const T& operator[]( unsigned int index ) const { return m_data[ index ]; }
+	T& front() { return m_data[ 0 ]; }
+	const T& front() const { return m_data[ 0 ]; }
+	T& back() { return m_data[ m_size - 1 ]; }
+	const T& back() const { return m_data[ m_size - 1 ]; }
+
+	iterator begin() { return m_data; }
+	iterator end() { return m_data + m_size; }
+	const_iterator begin() const { return m_data; }
+	const_iterator end() const { return m_data + m_size; }
+
+	void push_back( const T& value )
+	{
+		if ( m_size == m_capacity )
+			reserve( m_capacity * 2 );
+		m_data[ m_size++ ] = value;
+	}
+
+	void pop_back() { --m_size; }
+	void clear() { m_size = 0; } //Keeps any heap buffer, like std::vector.
+
+	void erase( iterator where ) //Order-preserving.
+	{
+		memmove( where, where + 1, ( end() - ( where + 1 ) ) * sizeof( T ) );
+		--m_size;
+	}
+
+	iterator find( const T& value )
+	{
+		for ( iterator iter = begin(); iter != end(); ++iter )
+			if ( *iter == value )
+				return iter;
+		return end();
+	}
+
+	void reserve( unsigned int newCapacity )
+	{
+		if ( newCapacity <= m_capacity )
+			return;
+
+		T* newData = new T[ newCapacity ];
+		memcpy( newData, m_data, m_size * sizeof( T ) );
+
+		if ( IsOnHeap() )
+			delete[] m_data;
+
+		m_data = newData;
+		m_capacity = newCapacity;
+	}
+
+
+private:
+	T* m_data; //Points at m_inlineData until the first overflow.
+	unsigned int m_size;
+	unsigned int m_capacity;
+	T m_inlineData[ INLINE_CAPACITY ];
+};
@@ -0,0 +1,372 @@
+#include "Engine/Metrics/Metrics.hpp"
+#include "Engine/Core/Command.hpp"
+#include "Engine/Core/TheConsole.hpp"
+#include "Engine/Error/ErrorWarningAssert.hpp"
+#include "Engine/FileUtils/FileUtils.hpp"
+#include "Engine/String/StringUtils.hpp"
+#include "Engine/EngineCommon.hpp"
+
+#include <atomic>
+#include <math.h>
+#include <mutex>
+#include <string.h>
+#include <vector>
+
+
+//--------------------------------------------------------------------------------------------------------------
+static const unsigned int MAX_METRICS = 256;
+static const unsigned int MAX_HISTOGRAMS = 64; //Fewer, since each costs a row of buckets in every thread's block.
+static const unsigned int NUM_HISTOGRAM_BUCKETS = 32; //The last starts at 2^30 microseconds, about 18 minutes.
+
+
+//--------------------------------------------------------------------------------------------------------------
+STATIC const unsigned int Metrics::s_MAX_METRICS = MAX_METRICS;
+STATIC const unsigned int Metrics::s_MAX_HISTOGRAMS = MAX_HISTOGRAMS;
+STATIC const unsigned int Metrics::s_NUM_HISTOGRAM_BUCKETS = NUM_HISTOGRAM_BUCKETS;
+STATIC const double Metrics::s_MERGE_INTERVAL_SECONDS = 1.0;
+STATIC const char* Metrics::s_DEFAULT_REPORT_FILENAME = "Metrics.txt";
+
+
+//--------------------------------------------------------------------------------------------------------------
+struct MetricInfo
+{
+	const char* m_name;
+	MetricType m_type;
+	unsigned int m_slotIndex; //Into its type's arrays, e.g. a thread block's m_histogramBuckets.
+};
+
+
+//--------------------------------------------------------------------------------------------------------------
+struct MetricThreadBlock //Only its own thread writes, with plain relaxed stores. Merge reads it from wherever.
+{
+	MetricThreadBlock()
+	{
+		for ( unsigned int counterIndex = 0; counterIndex < MAX_METRICS; counterIndex++ )
+			m_counterValues[ counterIndex ].store( 0, std::memory_order_relaxed );
+		for ( unsigned int histogramIndex = 0; histogramIndex < MAX_HISTOGRAMS; histogramIndex++ )
+		{
+			for ( unsigned int bucketIndex = 0; bucketIndex < NUM_HISTOGRAM_BUCKETS; bucketIndex++ )
+				m_histogramBuckets[ histogramIndex ][ bucketIndex ].store( 0, std::memory_order_relaxed );
+			m_histogramSumSeconds[ histogramIndex ].store( 0.0, std::memory_order_relaxed );
+		}
+	}
+
+	std::atomic< uint64_t > m_counterValues[ MAX_METRICS ];
+	std::atomic< uint64_t > m_histogramBuckets[ MAX_HISTOGRAMS ][ NUM_HISTOGRAM_BUCKETS ];
+	std::atomic< double > m_histogramSumSeconds[ MAX_HISTOGRAMS ];
+};
+
+
+//--------------------------------------------------------------------------------------------------------------
+struct MergedHistogram
+{
+	uint64_t m_bucketCounts[ NUM_HISTOGRAM_BUCKETS ];
+	uint64_t m_count;
+	double m_sumSeconds;
+};
+
+
+//--------------------------------------------------------------------------------------------------------------
+static std::mutex s_metricsMutex; //Taken to register, merge, and report, never to record.
+static MetricInfo s_metrics[ MAX_METRICS ];
+static unsigned int s_numMetrics = 0;
+static unsigned int s_numSlotsOfType[ NUM_METRIC_TYPES ] = { 0, 0, 0 };
+static std::vector< MetricThreadBlock* > s_threadBlocks; //Never freed: threads may still be writing at exit.
+static thread_local MetricThreadBlock* t_threadBlock = nullptr;
+static std::atomic< double > s_gaugeValues[ MAX_METRICS ];
+
+static uint64_t s_mergedCounterTotals[ MAX_METRICS ];
+static double s_mergedCounterRates[ MAX_METRICS ]; //Per second, between the last two merges.
+static MergedHistogram s_mergedHistograms[ MAX_HISTOGRAMS ];
+static double s_lastMergeSeconds = 0.0;
+static double s_streamIntervalSeconds = 0.0;
+static double s_lastStreamSeconds = 0.0;
+static std::string s_streamNameFilter;
+
+
+//--------------------------------------------------------------------------------------------------------------
+static MetricThreadBlock* GetThreadBlock()
+{
+	if ( t_threadBlock == nullptr )
+	{
+		std::lock_guard< std::mutex > lock( s_metricsMutex );
+		t_threadBlock = new MetricThreadBlock();
+		s_threadBlocks.push_back( t_threadBlock );
+	}
+
+	return t_threadBlock;
+}
+
+
+//--------------------------------------------------------------------------------------------------------------
+static MetricID RegisterMetric( const char* name, MetricType type )
+{
+	std::lock_guard< std::mutex > lock( s_metricsMutex );
+
+	for ( MetricID metricID = 0; metricID < s_numMetrics; metricID++ )
+	{
+		if ( strcmp( s_metrics[ metricID ].m_name, name ) != 0 )
+			continue;
+
+		GUARANTEE_OR_DIE( s_metrics[ metricID ].m_type == type, Stringf( "Metric %s was already registered as another type!", name ) );
+		return metricID;
+	}
+
+	unsigned int maxSlots = ( type == METRIC_TYPE_HISTOGRAM ) ? MAX_HISTOGRAMS : MAX_METRICS;
+	GUARANTEE_OR_DIE( s_numMetrics < MAX_METRICS && s_numSlotsOfType[ type ] < maxSlots, Stringf( "Out of room to register metric %s!", name ) );
+
+	MetricInfo& info = s_metrics[ s_numMetrics ];
+	info.m_name = name;
+	info.m_type = type;
+	info.m_slotIndex = s_numSlotsOfType[ type ]++;
+	return s_numMetrics++;
+}
+
+
+//--------------------------------------------------------------------------------------------------------------
+STATIC MetricID Metrics::RegisterCounter( const char* name )
+{
+	return RegisterMetric( name, METRIC_TYPE_COUNTER );
+}
+
+
+//--------------------------------------------------------------------------------------------------------------
+STATIC MetricID Metrics::RegisterGauge( const char* name )
+{
+	return RegisterMetric( name, METRIC_TYPE_GAUGE );
+}
+
+
+//--------------------------------------------------------------------------------------------------------------
+STATIC MetricID Metrics::RegisterHistogram( const char* name )
+{
+	return RegisterMetric( name, METRIC_TYPE_HISTOGRAM );
+}
+
+
+//--------------------------------------------------------------------------------------------------------------
+STATIC void Metrics::AddToCounter( MetricID counterID, uint64_t amount /*= 1*/ )
+{
+	ASSERT_OR_DIE( s_metrics[ counterID ].m_type == METRIC_TYPE_COUNTER, "Metrics::AddToCounter given a non-counter!" );
+
+	std::atomic< uint64_t >& value = GetThreadBlock()->m_counterValues[ s_metrics[ counterID ].m_slotIndex ];
+	value.store( value.load( std::memory_order_relaxed ) + amount, std::memory_order_relaxed ); //No other writer, so no locked add.
+}
+
+
+//--------------------------------------------------------------------------------------------------------------
+STATIC void Metrics::SetGauge( MetricID gaugeID, double value )
+{
+	ASSERT_OR_DIE( s_metrics[ gaugeID ].m_type == METRIC_TYPE_GAUGE, "Metrics::SetGauge given a non-gauge!" );
+
+	s_gaugeValues[ s_metrics[ gaugeID ].m_slotIndex ].store( value, std::memory_order_relaxed );
+}
+
+
+//--------------------------------------------------------------------------------------------------------------
+STATIC void Metrics::RecordSeconds( MetricID histogramID, double seconds )
+{
+	ASSERT_OR_DIE( s_metrics[ histogramID ].m_type == METRIC_TYPE_HISTOGRAM, "Metrics::RecordSeconds given a non-histogram!" );
+
+	int bucketIndex;
+	frexp( seconds * 1000000.0, &bucketIndex ); //Microseconds as a fraction in [.5,1) times 2^bucketIndex, so under 2^bucketIndex.
+	if ( bucketIndex < 0 )
+		bucketIndex = 0;
+	else if ( bucketIndex >= (int)NUM_HISTOGRAM_BUCKETS )
+		bucketIndex = NUM_HISTOGRAM_BUCKETS - 1;
+
+	MetricThreadBlock* block = GetThreadBlock();
+	unsigned int slotIndex = s_metrics[ histogramID ].m_slotIndex;
+	std::atomic< uint64_t >& bucketCount = block->m_histogramBuckets[ slotIndex ][ bucketIndex ];
+	bucketCount.store( bucketCount.load( std::memory_order_relaxed ) + 1, std::memory_order_relaxed );
+	std::atomic< double >& sumSeconds = block->m_histogramSumSeconds[ slotIndex ];
+	sumSeconds.store( sumSeconds.load( std::memory_order_relaxed ) + seconds, std::memory_order_relaxed );
+}
+
+
+//--------------------------------------------------------------------------------------------------------------
+STATIC void Metrics::Merge()
+{
+	std::lock_guard< std::mutex > lock( s_metricsMutex );
+
+	double nowSeconds = GetCurrentTimeSeconds();
+	double elapsedSeconds = nowSeconds - s_lastMergeSeconds;
+
+	//Thread blocks are never reset, so each merge re-sums them all rather than draining them.
+	for ( unsigned int counterIndex = 0; counterIndex < s_numSlotsOfType[ METRIC_TYPE_COUNTER ]; counterIndex++ )
+	{
+		uint64_t total = 0;
+		for ( const MetricThreadBlock* block : s_threadBlocks )
+			total += block->m_counterValues[ counterIndex ].load( std::memory_order_relaxed );
+
+		s_mergedCounterRates[ counterIndex ] = ( elapsedSeconds > 0.0 ) ? ( ( total - s_mergedCounterTotals[ counterIndex ] ) / elapsedSeconds ) : 0.0;
+		s_mergedCounterTotals[ counterIndex ] = total;
+	}
+
+	for ( unsigned int histogramIndex = 0; histogramIndex < s_numSlotsOfType[ METRIC_TYPE_HISTOGRAM ]; histogramIndex++ )
+	{
+		MergedHistogram& merged = s_mergedHistograms[ histogramIndex ];
+		merged.m_count = 0;
+		merged.m_sumSeconds = 0.0;
+		for ( unsigned int bucketIndex = 0; bucketIndex < NUM_HISTOGRAM_BUCKETS; bucketIndex++ )
+			merged.m_bucketCounts[ bucketIndex ] = 0;
+
+		for ( const MetricThreadBlock* block : s_threadBlocks )
+		{
+			for ( unsigned int bucketIndex = 0; bucketIndex < NUM_HISTOGRAM_BUCKETS; bucketIndex++ )
+			{
+				uint64_t bucketCount = block->m_histogramBuckets[ histogramIndex ][ bucketIndex ].load( std::memory_order_relaxed );
+				merged.m_bucketCounts[ bucketIndex ] += bucketCount;
+				merged.m_count += bucketCount;
+			}
+			merged.m_sumSeconds += block->m_histogramSumSeconds[ histogramIndex ].load( std::memory_order_relaxed );
+		}
+	}
+
+	s_lastMergeSeconds = nowSeconds;
+}
+
+
+//--------------------------------------------------------------------------------------------------------------
+static double CalcPercentileUpperBoundMs( const MergedHistogram& histogram, double percentile ) //Exact to within its bucket.
+{
+	uint64_t rankToReach = (uint64_t)ceil( histogram.m_count * percentile );
+	uint64_t countSoFar = 0;
+	for ( unsigned int bucketIndex = 0; bucketIndex < NUM_HISTOGRAM_BUCKETS; bucketIndex++ )
+	{
+		countSoFar += histogram.m_bucketCounts[ bucketIndex ];
+		if ( countSoFar >= rankToReach && countSoFar > 0 )
+			return ldexp( 1.0, bucketIndex ) / 1000.0;
+	}
+	return 0.0;
+}
+
+
+//--------------------------------------------------------------------------------------------------------------
+STATIC std::string Metrics::GetReport( const char* nameFilter /*= nullptr*/ )
+{
+	std::lock_guard< std::mutex > lock( s_metricsMutex );
+
+	//Every line is <type> <name> then key=value pairs, so reports from different runs diff and grep cleanly.
+	std::string report = Stringf( "# metrics merged at %.3f seconds\n", s_lastMergeSeconds );
+	for ( MetricID metricID = 0; metricID < s_numMetrics; metricID++ )
+	{
+		const MetricInfo& info = s_metrics[ metricID ];
+		if ( nameFilter != nullptr && strstr( info.m_name, nameFilter ) == nullptr )
+			continue;
+
+		switch ( info.m_type )
+		{
+		case METRIC_TYPE_COUNTER:
+			report += Stringf( "counter %s total=%llu per_second=%.1f\n", info.m_name,
+							   (unsigned long long)s_mergedCounterTotals[ info.m_slotIndex ], s_mergedCounterRates[ info.m_slotIndex ] );
+			break;
+		case METRIC_TYPE_GAUGE:
+			report += Stringf( "gauge %s value=%g\n", info.m_name, s_gaugeValues[ info.m_slotIndex ].load( std::memory_order_relaxed ) );
+			break;
+		case METRIC_TYPE_HISTOGRAM:
+		{
+			const MergedHistogram& histogram = s_mergedHistograms[ info.m_slotIndex ];
+			double meanMs = ( histogram.m_count > 0 ) ? ( histogram.m_sumSeconds * 1000.0 / histogram.m_count ) : 0.0;
+			report += Stringf( "histogram %s count=%llu mean_ms=%.4f p50_ms<=%.4f p90_ms<=%.4f p99_ms<=%.4f max_ms<=%.4f\n", info.m_name,
+							   (unsigned long long)histogram.m_count, meanMs,
+							   CalcPercentileUpperBoundMs( histogram, .5 ), CalcPercentileUpperBoundMs( histogram, .9 ),
+							   CalcPercentileUpperBoundMs( histogram, .99 ), CalcPercentileUpperBoundMs( histogram, 1.0 ) );
+			break;
+		}
+		}
+	}
+
+	return report;
+}
+
+
+//--------------------------------------------------------------------------------------------------------------
+STATIC bool Metrics::WriteReportToFile( const std::string& filePath )
+{
+	std::string report = GetReport();
+	std::vector< unsigned char > buffer( report.begin(), report.end() );
+	return SaveBufferToBinaryFile( filePath, buffer );
+}
+
+
+//--------------------------------------------------------------------------------------------------------------
+STATIC void Metrics::SetStreamInterval( double seconds, const std::string& nameFilter )
+{
+	s_streamIntervalSeconds = seconds;
+	s_streamNameFilter = nameFilter;
+	s_lastStreamSeconds = GetCurrentTimeSeconds();
+}
+
+
+//--------------------------------------------------------------------------------------------------------------
+static void PrintReportLines( const std::string& report )
+{
+	size_t lineStart = 0;
+	while ( lineStart < report.size() )
+	{
+		size_t lineEnd = report.find( '\n', lineStart );
+		if ( lineEnd == std::string::npos )
+			lineEnd = report.size();
+		g_theConsole->Print( StringView( report.c_str() + lineStart, lineEnd - lineStart ) );
+		lineStart = lineEnd + 1;
+	}
+}
+
+
+//--------------------------------------------------------------------------------------------------------------
+STATIC void Metrics::Update()
+{
+	double nowSeconds = GetCurrentTimeSeconds();
+	bool shouldStream = ( s_streamIntervalSeconds > 0.0 ) && ( nowSeconds - s_lastStreamSeconds >= s_streamIntervalSeconds );
+	if ( shouldStream || nowSeconds - s_lastMergeSeconds >= s_MERGE_INTERVAL_SECONDS )
+		Merge();
+
+	if ( shouldStream && g_theConsole != nullptr )
+	{
+		s_lastStreamSeconds = nowSeconds;
+		PrintReportLines( GetReport( s_streamNameFilter.empty() ? nullptr : s_streamNameFilter.c_str() ) );
+	}
+}
+
+
+//--------------------------------------------------------------------------------------------------------------
+void MetricsPrint( Command& args )
+{
+	std::string nameFilter;
+	args.GetNextString( &nameFilter );
+
+	Metrics::Merge();
+	PrintReportLines( Metrics::GetReport( nameFilter.empty() ? nullptr : nameFilter.c_str() ) );
+}
+
+
+//--------------------------------------------------------------------------------------------------------------
+void MetricsStream( Command& args )
+{
+	float intervalSeconds;
+	args.GetNextFloat( &intervalSeconds, 1.f );
+	std::string nameFilter;
+	args.GetNextString( &nameFilter );
+
+	Metrics::SetStreamInterval( intervalSeconds, nameFilter );
+	if ( intervalSeconds > 0.f )
+		g_theConsole->Printf( "Printing metrics every %.2f seconds. Usage: MetricsStream [seconds] [nameFilter], 0 to stop.", intervalSeconds );
+	else
+		g_theConsole->Printf( "Stopped printing metrics." );
+}
+
+
+//--------------------------------------------------------------------------------------------------------------
+void MetricsExport( Command& args )
+{
+	std::string filename;
+	std::string defaultFilename = Metrics::s_DEFAULT_REPORT_FILENAME;
+	args.GetNextString( &filename, &defaultFilename );
+
+	Metrics::Merge();
+	if ( Metrics::WriteReportToFile( filename ) )
+		g_theConsole->Printf( "Metrics written to %s.", filename.c_str() );
+	else
+		g_theConsole->Printf( "Metrics failed to write %s!", filename.c_str() );
+}
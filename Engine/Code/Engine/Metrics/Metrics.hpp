@@ -0,0 +1,73 @@
+#pragma once
+
+
+#include "Engine/Time/Time.hpp"
+#include <stdint.h>
+#include <string>
+
+
+//-----------------------------------------------------------------------------
+class Command;
+typedef unsigned int MetricID;
+const MetricID INVALID_METRIC_ID = 0xffffffff;
+
+
+//-----------------------------------------------------------------------------
+enum MetricType
+{
+	METRIC_TYPE_COUNTER, //Only goes up, e.g. paths computed. Reported with its rate since the last merge.
+	METRIC_TYPE_GAUGE, //A level set outright, e.g. living entities.
+	METRIC_TYPE_HISTOGRAM, //Durations, counted into fixed power-of-two buckets of microseconds.
+	NUM_METRIC_TYPES
+};
+
+
+//-----------------------------------------------------------------------------
+// Counters and histograms accumulate into a block per thread, so recording from jobs or the save thread never
+// contends. Merge sums every thread's block into the totals that reports read, and Update does so periodically.
+// Gauges are one shared value each, since only the latest matters. Names aren't copied, so use string literals,
+// dotted by subsystem, e.g. "game.paths_computed".
+//-----------------------------------------------------------------------------
+class Metrics
+{
+public:
+	static MetricID RegisterCounter( const char* name ); //Registering a name again returns its first ID.
+	static MetricID RegisterGauge( const char* name );
+	static MetricID RegisterHistogram( const char* name );
+
+	static void AddToCounter( MetricID counterID, uint64_t amount = 1 );
+	static void SetGauge( MetricID gaugeID, double value );
+	static void RecordSeconds( MetricID histogramID, double seconds );
+
+	static void Update(); //Once a frame. Merges every s_MERGE_INTERVAL_SECONDS, and prints to TheConsole while streaming.
+	static void Merge(); //Now, rather than waiting on Update, e.g. right before a report.
+	static std::string GetReport( const char* nameFilter = nullptr ); //As of the last merge, one metric per line.
+	static bool WriteReportToFile( const std::string& filePath );
+	static void SetStreamInterval( double seconds, const std::string& nameFilter ); //0 stops streaming.
+
+	static const unsigned int s_MAX_METRICS;
+	static const unsigned int s_MAX_HISTOGRAMS;
+	static const unsigned int s_NUM_HISTOGRAM_BUCKETS; //Bucket n counts durations under 2^n microseconds, the last all longer.
+	static const double s_MERGE_INTERVAL_SECONDS;
+	static const char* s_DEFAULT_REPORT_FILENAME;
+};
+
+
+//-----------------------------------------------------------------------------
+class MetricTimerScope //Records how long it was alive into a histogram.
+{
+public:
+	MetricTimerScope( MetricID histogramID ) : m_histogramID( histogramID ), m_startSeconds( GetCurrentTimeSeconds() ) {}
+	~MetricTimerScope() { Metrics::RecordSeconds( m_histogramID, GetCurrentTimeSeconds() - m_startSeconds ); }
+
+
+private:
+	MetricID m_histogramID;
+	double m_startSeconds;
+};
+
+
+//-----------------------------------------------------------------------------
+void MetricsPrint( Command& args ); //[nameFilter], matching any part of a name.
+void MetricsStream( Command& args ); //[seconds] [nameFilter], 0 seconds to stop.
+void MetricsExport( Command& args ); //[filename]
@@ -2,7 +2,7 @@
 #include "Engine/Math/MathUtils.hpp"
 #include "Engine/Renderer/Skeleton.hpp"
 #include "Engine/FileUtils/Writers/FileBinaryWriter.hpp"
-#include "Engine/FileUtils/Readers/FileBinaryReader.hpp"
+#include "Engine/FileUtils/Readers/MappedFileReader.hpp"
 
 
 //--------------------------------------------------------------------------------------------------------------
@@ -125,12 +125,7 @@ bool AnimationSequence::WriteToStream( BinaryWriter& writer )
 		{
 			Matrix4x4f& transform = *( startingKeyframeForJoint + keyframeIndex ); //Pointer arithmetic.
 			didWrite = writer.Write<uint32_t>( transform.GetOrdering() );
-			for ( int matrixEntry = 0; matrixEntry < 16; matrixEntry++ )
-			{
-				didWrite = writer.Write<float>( transform[ matrixEntry ] ); //As in MeshBuilder: per primitive, not per struct, for Endian!
-				if ( !didWrite )
-					break;
-			}
+			didWrite = writer.WriteArray( transform.m_data, 16 ); //As in MeshBuilder: an array of primitives, not the struct, for Endian!
 		}
 	}
 
@@ -143,7 +138,7 @@ bool AnimationSequence::ReadFromFile( const char* filename, int endianMode )
 {
 	bool didRead = false;
 
-	FileBinaryReader reader;
+	MappedFileReader reader;
 	reader.SetEndianMode( (EndianMode)endianMode );
 
 	didRead = reader.open( filename );
@@ -198,7 +193,7 @@ bool AnimationSequence::ReadFromStream( BinaryReader& reader )
 	m_keyframes = new Matrix4x4f[ m_numKeyframesPerJoint * m_numJoints ];
 
 	uint32_t matrixOrdering;
-	//As in MeshBuilder: per primitive, not per struct, for Endian conversion support!
+	//As in MeshBuilder: an array of primitives, not the struct, for Endian conversion support!
 	for ( unsigned int jointIndex = 0; jointIndex < m_numJoints; jointIndex++ )
 	{
 		Matrix4x4f* startingKeyframeForJoint = GetKeyframesForJoint( jointIndex );
@@ -207,12 +202,7 @@ bool AnimationSequence::ReadFromStream( BinaryReader& reader )
 			didRead = reader.Read<uint32_t>( &matrixOrdering );
 			Matrix4x4f currentKeyframeTransform( static_cast<Ordering>( matrixOrdering ) );
 
-			for ( int elementIndex = 0; elementIndex < 16; elementIndex++ )
-			{
-				didRead = reader.Read<float>( &currentKeyframeTransform[ elementIndex ] );
-				if ( !didRead )
-					break;
-			}
+			didRead = reader.ReadArray( currentKeyframeTransform.m_data, 16 );
 
 
 			Matrix4x4f* jointKeyframe = startingKeyframeForJoint + keyframeIndex; //Pointer arithmetic.
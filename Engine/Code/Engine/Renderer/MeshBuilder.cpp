@@ -6,8 +6,9 @@
 #include "Engine/FileUtils/Writers/BinaryWriter.hpp"
 #include "Engine/FileUtils/Writers/FileBinaryWriter.hpp"
 #include "Engine/FileUtils/Readers/BinaryReader.hpp"
-#include "Engine/FileUtils/Readers/FileBinaryReader.hpp"
+#include "Engine/FileUtils/Readers/MappedFileReader.hpp"
 #include "Engine/Memory/BitUtils.hpp"
+#include <stddef.h>
 
 
 //--------------------------------------------------------------------------------------------------------------
@@ -380,143 +381,56 @@ bool MeshBuilder::WriteToStream( BinaryWriter& writer ) //Can have a bunch of me
 
 
 //--------------------------------------------------------------------------------------------------------------
-bool MeshBuilder::WriteVertices( BinaryWriter& writer )
+// Each attribute is stored as one run across every vertex, so reads and writes gather it into a flat array of 4-byte
+// words and move the whole run with one ReadArray/WriteArray, rather than a virtual call and endian check per float.
+// The table lists, in file order, where each word of an attribute sits in a Vertex3D_Superset.
+//--------------------------------------------------------------------------------------------------------------
+#define VERTEX_WORD( member, wordIndex ) ( offsetof( Vertex3D_Superset, member ) + ( ( wordIndex ) * sizeof( uint32_t ) ) )
+struct MeshVertexAttributeWords
 {
-	bool didWrite = false;
+	MeshVertexAttributeBitIndex m_attribute;
+	bool m_areBytes; //Color's one word is four byte channels, which never swap.
+	unsigned int m_numWords;
+	size_t m_wordOffsets[ 8 ];
+};
+static const MeshVertexAttributeWords s_VERTEX_ATTRIBUTE_WORDS[ NUM_MESH_VERTEX_ATTRIBUTES ] =
+{
+	{ MESH_VERTEX_ATTRIBUTE_POSITION, false, 3, { VERTEX_WORD( m_position, 0 ), VERTEX_WORD( m_position, 1 ), VERTEX_WORD( m_position, 2 ) } },
+	{ MESH_VERTEX_ATTRIBUTE_COLOR, true, 1, { VERTEX_WORD( m_color, 0 ) } },
+	{ MESH_VERTEX_ATTRIBUTE_UV0, false, 2, { VERTEX_WORD( m_texCoords0, 0 ), VERTEX_WORD( m_texCoords0, 1 ) } },
+	{ MESH_VERTEX_ATTRIBUTE_UV1, false, 2, { VERTEX_WORD( m_texCoords1, 0 ), VERTEX_WORD( m_texCoords1, 1 ) } },
+	{ MESH_VERTEX_ATTRIBUTE_UV2, false, 2, { VERTEX_WORD( m_texCoords2, 0 ), VERTEX_WORD( m_texCoords2, 1 ) } },
+	{ MESH_VERTEX_ATTRIBUTE_UV3, false, 2, { VERTEX_WORD( m_texCoords3, 0 ), VERTEX_WORD( m_texCoords3, 1 ) } },
+	{ MESH_VERTEX_ATTRIBUTE_TANGENT, false, 3, { VERTEX_WORD( m_tangent, 1 ), VERTEX_WORD( m_tangent, 0 ), VERTEX_WORD( m_tangent, 2 ) } }, //y first, as files always had it.
+	{ MESH_VERTEX_ATTRIBUTE_BITANGENT, false, 3, { VERTEX_WORD( m_bitangent, 0 ), VERTEX_WORD( m_bitangent, 1 ), VERTEX_WORD( m_bitangent, 2 ) } },
+	{ MESH_VERTEX_ATTRIBUTE_NORMAL, false, 3, { VERTEX_WORD( m_normal, 0 ), VERTEX_WORD( m_normal, 1 ), VERTEX_WORD( m_normal, 2 ) } },
+	{ MESH_VERTEX_ATTRIBUTE_SKINWEIGHTS, false, 8, { VERTEX_WORD( m_jointIndices, 0 ), VERTEX_WORD( m_jointIndices, 1 ), VERTEX_WORD( m_jointIndices, 2 ), VERTEX_WORD( m_jointIndices, 3 ),
+													 VERTEX_WORD( m_boneWeights, 0 ), VERTEX_WORD( m_boneWeights, 1 ), VERTEX_WORD( m_boneWeights, 2 ), VERTEX_WORD( m_boneWeights, 3 ) } }
+};
+#undef VERTEX_WORD
 
-	//The problem: ( writer.WriteBytes( m_currentVertices.data(), verticesCount ) == verticesCount );
-		//Only writes # bytes == # vertices, but sizeof a vertex != 1 byte.
-		//Furthermore, for Endian mode conversion, need to write member by member, not struct by struct.
 
-	//Loop bounds just used so we have some point at which we know to exit.
-	for ( unsigned int attributeIndex = 0; attributeIndex < Vertex3D_Superset::DEFINITION.GetNumAttributes(); attributeIndex++ )
+//--------------------------------------------------------------------------------------------------------------
+bool MeshBuilder::WriteVertices( BinaryWriter& writer )
+{
+	bool didWrite = true;
+	std::vector< uint32_t > words; //Reused across attributes.
+
+	for ( const MeshVertexAttributeWords& attribute : s_VERTEX_ATTRIBUTE_WORDS )
 	{
-		switch ( attributeIndex )
-		{
-		case MESH_VERTEX_ATTRIBUTE_POSITION:
-			if ( GET_BIT_AT_BITFIELD_INDEX_MASKED( m_currentVertexDataMask, MESH_VERTEX_ATTRIBUTE_POSITION ) != 0 )
-			{
-				//By writing per-member, supports Endian conversions.
-				for ( const Vertex3D_Superset& vertex : m_currentVertices )
-				{
-					didWrite = writer.Write<float>( vertex.m_position.x );
-					didWrite = writer.Write<float>( vertex.m_position.y );
-					didWrite = writer.Write<float>( vertex.m_position.z );
-				}
-			}
-			break;
-		case MESH_VERTEX_ATTRIBUTE_COLOR:
-			if ( GET_BIT_AT_BITFIELD_INDEX_MASKED( m_currentVertexDataMask, MESH_VERTEX_ATTRIBUTE_COLOR ) != 0 )
-			{
-				//By writing per-member, supports Endian conversions.
-				for ( const Vertex3D_Superset& vertex : m_currentVertices )
-				{
-					didWrite = writer.Write<byte_t>( vertex.m_color.red );
-					didWrite = writer.Write<byte_t>( vertex.m_color.green );
-					didWrite = writer.Write<byte_t>( vertex.m_color.blue );
-					didWrite = writer.Write<byte_t>( vertex.m_color.alphaOpacity );
-				}
-			}
-			break;
-		case MESH_VERTEX_ATTRIBUTE_UV0:
-			if ( GET_BIT_AT_BITFIELD_INDEX_MASKED( m_currentVertexDataMask, MESH_VERTEX_ATTRIBUTE_UV0 ) != 0 )
-			{
-				//By writing per-member, supports Endian conversions.
-				for ( const Vertex3D_Superset& vertex : m_currentVertices )
-				{
-					didWrite = writer.Write<float>( vertex.m_texCoords0.x );
-					didWrite = writer.Write<float>( vertex.m_texCoords0.y );
-				}
-			}
-			break;
-		case MESH_VERTEX_ATTRIBUTE_UV1:
-			if ( GET_BIT_AT_BITFIELD_INDEX_MASKED( m_currentVertexDataMask, MESH_VERTEX_ATTRIBUTE_UV1 ) != 0 )
-			{
-				//By writing per-member, supports Endian conversions.
-				for ( const Vertex3D_Superset& vertex : m_currentVertices )
-				{
-					didWrite = writer.Write<float>( vertex.m_texCoords1.x );
-					didWrite = writer.Write<float>( vertex.m_texCoords1.y );
-				}
-			}
-			break;
-		case MESH_VERTEX_ATTRIBUTE_UV2:
-			if ( GET_BIT_AT_BITFIELD_INDEX_MASKED( m_currentVertexDataMask, MESH_VERTEX_ATTRIBUTE_UV2 ) != 0 )
-			{
-				//By writing per-member, supports Endian conversions.
-				for ( const Vertex3D_Superset& vertex : m_currentVertices )
-				{
-					didWrite = writer.Write<float>( vertex.m_texCoords2.x );
-					didWrite = writer.Write<float>( vertex.m_texCoords2.y );
-				}
-			}
-			break;
-		case MESH_VERTEX_ATTRIBUTE_UV3:
-			if ( GET_BIT_AT_BITFIELD_INDEX_MASKED( m_currentVertexDataMask, MESH_VERTEX_ATTRIBUTE_UV3 ) != 0 )
-			{
-				//By writing per-member, supports Endian conversions.
-				for ( const Vertex3D_Superset& vertex : m_currentVertices )
-				{
-					didWrite = writer.Write<float>( vertex.m_texCoords3.x );
-					didWrite = writer.Write<float>( vertex.m_texCoords3.y );
-				}
-			}
-			break;
-		case MESH_VERTEX_ATTRIBUTE_TANGENT:
-			if ( GET_BIT_AT_BITFIELD_INDEX_MASKED( m_currentVertexDataMask, MESH_VERTEX_ATTRIBUTE_TANGENT ) != 0 )
-			{
-				//By writing per-member, supports Endian conversions.
-				for ( const Vertex3D_Superset& vertex : m_currentVertices )
-				{
-					didWrite = writer.Write<float>( vertex.m_tangent.y );
-					didWrite = writer.Write<float>( vertex.m_tangent.x );
-					didWrite = writer.Write<float>( vertex.m_tangent.z );
-				}
-			}
-			break;
-		case MESH_VERTEX_ATTRIBUTE_BITANGENT:
-			if ( GET_BIT_AT_BITFIELD_INDEX_MASKED( m_currentVertexDataMask, MESH_VERTEX_ATTRIBUTE_BITANGENT ) != 0 )
-			{
-				//By writing per-member, supports Endian conversions.
-				for ( const Vertex3D_Superset& vertex : m_currentVertices )
-				{
-					didWrite = writer.Write<float>( vertex.m_bitangent.x );
-					didWrite = writer.Write<float>( vertex.m_bitangent.y );
-					didWrite = writer.Write<float>( vertex.m_bitangent.z );
-				}
-			}
-			break;
-		case MESH_VERTEX_ATTRIBUTE_NORMAL:
-			if ( GET_BIT_AT_BITFIELD_INDEX_MASKED( m_currentVertexDataMask, MESH_VERTEX_ATTRIBUTE_NORMAL ) != 0 )
-			{
-				//By writing per-member, supports Endian conversions.
-				for ( const Vertex3D_Superset& vertex : m_currentVertices )
-				{
-					didWrite = writer.Write<float>( vertex.m_normal.x );
-					didWrite = writer.Write<float>( vertex.m_normal.y );
-					didWrite = writer.Write<float>( vertex.m_normal.z );
-				}
-			}
-			break;
-		case MESH_VERTEX_ATTRIBUTE_SKINWEIGHTS:
-			if ( GET_BIT_AT_BITFIELD_INDEX_MASKED( m_currentVertexDataMask, MESH_VERTEX_ATTRIBUTE_SKINWEIGHTS ) != 0 )
-			{
-				//By writing per-member, supports Endian conversions.
-				for ( Vertex3D_Superset& vertex : m_currentVertices )
-				{
-					didWrite = writer.Write<uint32_t>( vertex.m_jointIndices.x );
-					didWrite = writer.Write<uint32_t>( vertex.m_jointIndices.y );
-					didWrite = writer.Write<uint32_t>( vertex.m_jointIndices.z );
-					didWrite = writer.Write<uint32_t>( vertex.m_jointIndices.w );
-
-					didWrite = writer.Write<float>( vertex.m_boneWeights.x );
-					didWrite = writer.Write<float>( vertex.m_boneWeights.y );
-					didWrite = writer.Write<float>( vertex.m_boneWeights.z );
-					didWrite = writer.Write<float>( vertex.m_boneWeights.w );
-				}
-			}
-		}
-		
+		if ( GET_BIT_AT_BITFIELD_INDEX_MASKED( m_currentVertexDataMask, attribute.m_attribute ) == 0 )
+			continue;
+
+		words.resize( m_currentVertices.size() * attribute.m_numWords );
+		uint32_t* word = words.data();
+		for ( const Vertex3D_Superset& vertex : m_currentVertices )
+			for ( unsigned int wordIndex = 0; wordIndex < attribute.m_numWords; wordIndex++ )
+				memcpy( word++, (const byte_t*)&vertex + attribute.m_wordOffsets[ wordIndex ], sizeof( uint32_t ) );
+
+		if ( attribute.m_areBytes )
+			didWrite &= writer.WriteArray( (const byte_t*)words.data(), words.size() * sizeof( uint32_t ) );
+		else
+			didWrite &= writer.WriteArray( words.data(), words.size() );
 	}
 
 	return didWrite;
@@ -526,37 +440,26 @@ bool MeshBuilder::WriteVertices( BinaryWriter& writer )
 //--------------------------------------------------------------------------------------------------------------
 bool MeshBuilder::WriteIndices( BinaryWriter& writer )
 {
-	bool didWrite = false;
-
-	//The problem: ( writer.WriteBytes( m_currentIndices.data(), indicesCount ) == indicesCount );
-	//Only reads # bytes == # indices, but sizeof(uint) != 1 byte.
-	//Furthermore, for Endian mode conversion, need to read member by member, not struct by struct.
-
-	for ( unsigned int index : m_currentIndices )
-		didWrite = writer.Write<uint32_t>( index );
-
-	return didWrite;
+	static_assert( sizeof( unsigned int ) == sizeof( uint32_t ), "Indices go out as they sit in memory." );
+	return writer.WriteArray( m_currentIndices.data(), m_currentIndices.size() );
 }
 
 
 //--------------------------------------------------------------------------------------------------------------
 bool MeshBuilder::WriteDrawInstructions( BinaryWriter& writer )
 {	
-	bool didWrite = false; 
-
-	//The problem: ( writer.WriteBytes( m_currentInstructions.data(), instructionCount ) == instructionCount );
-		//Only writes # bytes == # instructions, but sizeof an instruction != 1 byte.
-		//Furthermore, for Endian mode conversion, need to write member by member, not struct by struct.
-
+	//Four words per instruction, gathered per member since the struct itself may pad or reorder.
+	std::vector< uint32_t > words( m_currentInstructions.size() * 4 );
+	uint32_t* word = words.data();
 	for ( const DrawInstruction& instruction : m_currentInstructions )
 	{
-		didWrite = writer.Write<uint32_t>( instruction.m_type );
-		didWrite = writer.Write<uint32_t>( instruction.m_startIndex );
-		didWrite = writer.Write<uint32_t>( instruction.m_count );
-		didWrite = writer.Write<uint32_t>( instruction.m_usingIndexBuffer );
+		*word++ = instruction.m_type;
+		*word++ = instruction.m_startIndex;
+		*word++ = instruction.m_count;
+		*word++ = instruction.m_usingIndexBuffer;
 	}
 
-	return didWrite;
+	return writer.WriteArray( words.data(), words.size() );
 }
 
 //--------------------------------------------------------------------------------------------------------------
@@ -674,7 +577,7 @@ bool MeshBuilder::ReadFromFile( const char* filename, int endianMode )
 {
 	bool didRead = false;
 
-	FileBinaryReader reader;
+	MappedFileReader reader; //Per-float Read<T>s become memcpys out of the mapping instead of locked freads.
 	reader.SetEndianMode( (EndianMode)endianMode );
 
 	didRead = reader.open( filename );
@@ -737,142 +640,24 @@ bool MeshBuilder::ReadFromStream( BinaryReader& reader )
 //--------------------------------------------------------------------------------------------------------------
 bool MeshBuilder::ReadVertices( BinaryReader& reader )
 {
-	bool didRead = false;
-
-	//The problem: ( writer.WriteBytes( m_currentVertices.data(), verticesCount ) == verticesCount );
-	//Only reads # bytes == # vertices, but sizeof a vertex != 1 byte.
-	//Furthermore, for Endian mode conversion, need to read member by member, not struct by struct.
+	bool didRead = true;
+	std::vector< uint32_t > words; //Reused across attributes.
 
-	//Loop bounds just used so we have some point at which we know to exit.
-	for ( unsigned int attributeIndex = 0; attributeIndex < Vertex3D_Superset::DEFINITION.GetNumAttributes(); attributeIndex++ )
+	for ( const MeshVertexAttributeWords& attribute : s_VERTEX_ATTRIBUTE_WORDS )
 	{
-		switch ( attributeIndex )
-		{
-		case MESH_VERTEX_ATTRIBUTE_POSITION:
-			if ( GET_BIT_AT_BITFIELD_INDEX_MASKED( m_currentVertexDataMask, MESH_VERTEX_ATTRIBUTE_POSITION ) != 0 )
-			{
-				//By reading per-member, supports Endian conversions.
-				for ( Vertex3D_Superset& vertex : m_currentVertices )
-				{
-					didRead = reader.Read<float>( &vertex.m_position.x );
-					didRead = reader.Read<float>( &vertex.m_position.y );
-					didRead = reader.Read<float>( &vertex.m_position.z );
-				}
-			}
-			break;
-		case MESH_VERTEX_ATTRIBUTE_COLOR:
-			if ( GET_BIT_AT_BITFIELD_INDEX_MASKED( m_currentVertexDataMask, MESH_VERTEX_ATTRIBUTE_COLOR ) != 0 )
-			{
-				//By reading per-member, supports Endian conversions.
-				for ( Vertex3D_Superset& vertex : m_currentVertices )
-				{
-					didRead = reader.Read<byte_t>( &vertex.m_color.red );
-					didRead = reader.Read<byte_t>( &vertex.m_color.green );
-					didRead = reader.Read<byte_t>( &vertex.m_color.blue );
-					didRead = reader.Read<byte_t>( &vertex.m_color.alphaOpacity );
-				}
-			}
-			break;
-		case MESH_VERTEX_ATTRIBUTE_UV0:
-			if ( GET_BIT_AT_BITFIELD_INDEX_MASKED( m_currentVertexDataMask, MESH_VERTEX_ATTRIBUTE_UV0 ) != 0 )
-			{
-				//By reading per-member, supports Endian conversions.
-				for ( Vertex3D_Superset& vertex : m_currentVertices )
-				{
-					didRead = reader.Read<float>( &vertex.m_texCoords0.x );
-					didRead = reader.Read<float>( &vertex.m_texCoords0.y );
-				}
-			}
-			break;
-		case MESH_VERTEX_ATTRIBUTE_UV1:
-			if ( GET_BIT_AT_BITFIELD_INDEX_MASKED( m_currentVertexDataMask, MESH_VERTEX_ATTRIBUTE_UV1 ) != 0 )
-			{
-				//By reading per-member, supports Endian conversions.
-				for ( Vertex3D_Superset& vertex : m_currentVertices )
-				{
-					didRead = reader.Read<float>( &vertex.m_texCoords1.x );
-					didRead = reader.Read<float>( &vertex.m_texCoords1.y );
-				}
-			}
-			break;
-		case MESH_VERTEX_ATTRIBUTE_UV2:
-			if ( GET_BIT_AT_BITFIELD_INDEX_MASKED( m_currentVertexDataMask, MESH_VERTEX_ATTRIBUTE_UV2 ) != 0 )
-			{
-				//By reading per-member, supports Endian conversions.
-				for ( Vertex3D_Superset& vertex : m_currentVertices )
-				{
-					didRead = reader.Read<float>( &vertex.m_texCoords2.x );
-					didRead = reader.Read<float>( &vertex.m_texCoords2.y );
-				}
-			}
-			break;
-		case MESH_VERTEX_ATTRIBUTE_UV3:
-			if ( GET_BIT_AT_BITFIELD_INDEX_MASKED( m_currentVertexDataMask, MESH_VERTEX_ATTRIBUTE_UV3 ) != 0 )
-			{
-				//By reading per-member, supports Endian conversions.
-				for ( Vertex3D_Superset& vertex : m_currentVertices )
-				{
-					didRead = reader.Read<float>( &vertex.m_texCoords3.x );
-					didRead = reader.Read<float>( &vertex.m_texCoords3.y );
-				}
-			}
-			break;
-		case MESH_VERTEX_ATTRIBUTE_TANGENT:
-			if ( GET_BIT_AT_BITFIELD_INDEX_MASKED( m_currentVertexDataMask, MESH_VERTEX_ATTRIBUTE_TANGENT ) != 0 )
-			{
-				//By reading per-member, supports Endian conversions.
-				for ( Vertex3D_Superset& vertex : m_currentVertices )
-				{
-					didRead = reader.Read<float>( &vertex.m_tangent.y );
-					didRead = reader.Read<float>( &vertex.m_tangent.x );
-					didRead = reader.Read<float>( &vertex.m_tangent.z );
-				}
-			}
-			break;
-		case MESH_VERTEX_ATTRIBUTE_BITANGENT:
-			if ( GET_BIT_AT_BITFIELD_INDEX_MASKED( m_currentVertexDataMask, MESH_VERTEX_ATTRIBUTE_BITANGENT ) != 0 )
-			{
-				//By writing per-member, supports Endian conversions.
-				for ( Vertex3D_Superset& vertex : m_currentVertices )
-				{
-					didRead = reader.Read<float>( &vertex.m_bitangent.x );
-					didRead = reader.Read<float>( &vertex.m_bitangent.y );
-					didRead = reader.Read<float>( &vertex.m_bitangent.z );
-				}
-			}
-			break;
-		case MESH_VERTEX_ATTRIBUTE_NORMAL:
-			if ( GET_BIT_AT_BITFIELD_INDEX_MASKED( m_currentVertexDataMask, MESH_VERTEX_ATTRIBUTE_NORMAL ) != 0 )
-			{
-				//By reading per-member, supports Endian conversions.
-				for ( Vertex3D_Superset& vertex : m_currentVertices )
-				{
-					didRead = reader.Read<float>( &vertex.m_normal.x );
-					didRead = reader.Read<float>( &vertex.m_normal.y );
-					didRead = reader.Read<float>( &vertex.m_normal.z );
-				}
-			}
-			break;
-		case MESH_VERTEX_ATTRIBUTE_SKINWEIGHTS:
-			if ( GET_BIT_AT_BITFIELD_INDEX_MASKED( m_currentVertexDataMask, MESH_VERTEX_ATTRIBUTE_SKINWEIGHTS ) != 0 )
-			{
-				//By reading per-member, supports Endian conversions.
-				for ( Vertex3D_Superset& vertex : m_currentVertices )
-				{
-					didRead = reader.Read<uint32_t>( &vertex.m_jointIndices.x );
-					didRead = reader.Read<uint32_t>( &vertex.m_jointIndices.y );
-					didRead = reader.Read<uint32_t>( &vertex.m_jointIndices.z );
-					didRead = reader.Read<uint32_t>( &vertex.m_jointIndices.w );
-
-					didRead = reader.Read<float>( &vertex.m_boneWeights.x );
-					didRead = reader.Read<float>( &vertex.m_boneWeights.y );
-					didRead = reader.Read<float>( &vertex.m_boneWeights.z );
-					didRead = reader.Read<float>( &vertex.m_boneWeights.w );
-				}
-			}
-			break;
-		}
+		if ( GET_BIT_AT_BITFIELD_INDEX_MASKED( m_currentVertexDataMask, attribute.m_attribute ) == 0 )
+			continue;
 
+		words.resize( m_currentVertices.size() * attribute.m_numWords );
+		if ( attribute.m_areBytes )
+			didRead &= reader.ReadArray( (byte_t*)words.data(), words.size() * sizeof( uint32_t ) );
+		else
+			didRead &= reader.ReadArray( words.data(), words.size() );
+
+		const uint32_t* word = words.data();
+		for ( Vertex3D_Superset& vertex : m_currentVertices )
+			for ( unsigned int wordIndex = 0; wordIndex < attribute.m_numWords; wordIndex++ )
+				memcpy( (byte_t*)&vertex + attribute.m_wordOffsets[ wordIndex ], word++, sizeof( uint32_t ) );
 	}
 
 	return didRead;
@@ -882,37 +667,23 @@ bool MeshBuilder::ReadVertices( BinaryReader& reader )
 //--------------------------------------------------------------------------------------------------------------
 bool MeshBuilder::ReadIndices( BinaryReader& reader )
 {
-	bool didRead = false;
-
-	//The problem: ( reader.ReadBytes( m_currentIndices.data(), indicesCount ) == indicesCount );
-		//Only reads # bytes == # indices, but sizeof(uint) != 1 byte.
-		//Furthermore, for Endian mode conversion, need to read member by member, not struct by struct.
-
-	for ( unsigned int& index : m_currentIndices )
-		didRead = reader.Read<uint32_t>( &index );
-
-	return didRead;
+	return reader.ReadArray( m_currentIndices.data(), m_currentIndices.size() );
 }
 
 
-
-
-
 //--------------------------------------------------------------------------------------------------------------
 bool MeshBuilder::ReadDrawInstructions( BinaryReader& reader )
 {
-	bool didRead = false;
-
-	//The problem: ( reader.ReadBytes( m_currentInstructions.data(), instructionsCount ) == instructionsCount );
-		//Only reads # bytes == # instructions, but sizeof an instruction != 1 byte.
-		//Furthermore, for Endian mode conversion, need to read member by member, not struct by struct.
+	std::vector< uint32_t > words( m_currentInstructions.size() * 4 );
+	bool didRead = reader.ReadArray( words.data(), words.size() );
 
+	const uint32_t* word = words.data();
 	for ( DrawInstruction& instruction : m_currentInstructions )
 	{
-		didRead = reader.Read<PrimitiveType>( &instruction.m_type );
-		didRead = reader.Read<uint32_t>( &instruction.m_startIndex );
-		didRead = reader.Read<uint32_t>( &instruction.m_count );
-		didRead = reader.Read<uint32_t>( &instruction.m_usingIndexBuffer );
+		instruction.m_type = (PrimitiveType)*word++;
+		instruction.m_startIndex = *word++;
+		instruction.m_count = *word++;
+		instruction.m_usingIndexBuffer = *word++;
 	}
 
 	return didRead;
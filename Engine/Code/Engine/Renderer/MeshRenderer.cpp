@@ -15,6 +15,7 @@
 #include "Engine/Renderer/Rgba.hpp"
 #include "Engine/Renderer/Sampler.hpp"
 #include "Engine/Renderer/Texture.hpp"
+#include "Engine/Renderer/TheRenderer.hpp"
 
 //--------------------------------------------------------------------------------------------------------------
 STATIC std::map< std::string, MeshRenderer* >		MeshRenderer::s_meshRendererRegistry;
@@ -223,6 +224,7 @@ void MeshRenderer::Render( Mesh* mesh, Material* material )
 			glDrawElements( GL_TRIANGLES, currentInstruction.m_count, GL_UNSIGNED_INT, (GLvoid*)currentInstruction.m_startIndex ); //Vertex grouping rule, # indices, uint, &loc[0] or 0 for bound.
 		else
 			glDrawArrays( GL_TRIANGLES, currentInstruction.m_startIndex, currentInstruction.m_count ); //Vertex grouping rule, start index into bound array, # vertexes to include.
+		g_theRenderer->CountDrawCall( currentInstruction.m_count );
 	}
 
 	material->Unbind();
@@ -1,6 +1,6 @@
 #include "Engine/Renderer/Skeleton.hpp"
 #include "Engine/FileUtils/Writers/FileBinaryWriter.hpp"
-#include "Engine/FileUtils/Readers/FileBinaryReader.hpp"
+#include "Engine/FileUtils/Readers/MappedFileReader.hpp"
 #include "Game/GameCommon.hpp"
 
 
@@ -182,23 +182,15 @@ bool Skeleton::WriteToStream( BinaryWriter& writer )
 			break;
 	}
 
-	for ( int parentJointIndex : m_indicesOfParentJoints )
-	{
-		didWrite = writer.Write<int>( parentJointIndex );
-		if ( !didWrite )
-			break;
-	}
+	didWrite = writer.WriteArray( m_indicesOfParentJoints.data(), m_indicesOfParentJoints.size() );
 
 	//Only writing one of the transforms because we can read it back and invert it to get the other!
 	for ( Matrix4x4f& transform : m_globalJointBoneToModelSpaceTransforms )
 	{
 		didWrite = writer.Write<uint32_t>( transform.GetOrdering() );
-		for ( int matrixEntry = 0; matrixEntry < 16; matrixEntry++ )
-		{
-			didWrite = writer.Write<float>( transform[ matrixEntry ] ); //As in MeshBuilder: per primitive, not per struct, for Endian!
-			if ( !didWrite )
-				break;
-		}
+		didWrite = writer.WriteArray( transform.m_data, 16 ); //As in MeshBuilder: an array of primitives, not the struct, for Endian!
+		if ( !didWrite )
+			break;
 	}
 
 	return didWrite;
@@ -210,7 +202,7 @@ bool Skeleton::ReadFromFile( const char* filename, int endianMode )
 {
 	bool didRead = false;
 
-	FileBinaryReader reader;
+	MappedFileReader reader;
 	reader.SetEndianMode( (EndianMode)endianMode );
 
 	didRead = reader.open( filename );
@@ -268,28 +260,18 @@ bool Skeleton::ReadFromStream( BinaryReader& reader )
 			break;
 	}
 
-	for ( unsigned int jointIndex = 0; jointIndex < jointCount; jointIndex++ )
-	{
-		didRead = reader.Read<int32_t>( &m_indicesOfParentJoints[ jointIndex ] );
-		if ( !didRead )
-			break;
-	}
+	didRead = reader.ReadArray( m_indicesOfParentJoints.data(), jointCount );
 
 	ReconstructLocalTransformHierarchy();
 
 	uint32_t matrixOrdering;
-	//As in MeshBuilder: per primitive, not per struct, for Endian conversion support!
+	//As in MeshBuilder: an array of primitives, not the struct, for Endian conversion support!
 	for ( unsigned int jointIndex = 0; jointIndex < jointCount; jointIndex++ )
 	{
 		didRead = reader.Read<uint32_t>( &matrixOrdering );
 		Matrix4x4f currentTransform( static_cast<Ordering>( matrixOrdering ) );
 
-		for ( int elementIndex = 0; elementIndex < 16; elementIndex++ )
-		{
-			didRead = reader.Read<float>( &currentTransform[ elementIndex ] );
-			if ( !didRead )
-				break;
-		}
+		didRead = reader.ReadArray( currentTransform.m_data, 16 );
 
 		m_globalJointBoneToModelSpaceTransforms[ jointIndex ] = currentTransform;
 		currentTransform.GetInverseAssumingOrthonormality( currentTransform );
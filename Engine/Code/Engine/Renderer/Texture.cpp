@@ -18,7 +18,7 @@
 
 
 //---------------------------------------------------------------------------
-STATIC std::map< std::string, Texture* >	Texture::s_textureRegistry;
+STATIC NameMap< Texture* >	Texture::s_textureRegistry;
 
 
 //---------------------------------------------------------------------------
@@ -173,19 +173,21 @@ Texture::Texture( unsigned int width, unsigned int height, TextureFormat format
 //
 STATIC Texture* Texture::GetTextureByPath( const std::string& imageFilePath )
 {
-	if ( s_textureRegistry.find(imageFilePath) == s_textureRegistry.end() ) return nullptr;
-	else return s_textureRegistry[ imageFilePath ];
+	Texture** found = s_textureRegistry.FindByText( imageFilePath );
+	return ( found != nullptr ) ? *found : nullptr;
 }
 
 
 //---------------------------------------------------------------------------
 Texture* Texture::CreateTextureFromBytes( const std::string& textureName, const unsigned char* imageData, const Vector2i& textureSize, unsigned int numComponents )
 {
-	if ( s_textureRegistry.count( textureName ) > 0 ) return s_textureRegistry[ textureName ];
+	Texture** found = s_textureRegistry.FindByText( textureName );
+	if ( found != nullptr ) return *found;
 	else
 	{
-		s_textureRegistry[ textureName ] = new Texture( imageData, textureSize, numComponents );
-		return s_textureRegistry[ textureName ];
+		Texture* newTexture = new Texture( imageData, textureSize, numComponents );
+		s_textureRegistry.Insert( Name( textureName ), newTexture );
+		return newTexture;
 	}
 }
 
@@ -193,11 +195,13 @@ Texture* Texture::CreateTextureFromBytes( const std::string& textureName, const
 //--------------------------------------------------------------------------------------------------------------
 STATIC Texture* Texture::CreateTextureFromNoData( const std::string& textureName, unsigned int width, unsigned int height, TextureFormat format )
 {
-	if ( s_textureRegistry.count( textureName ) > 0 ) return s_textureRegistry[ textureName ];
+	Texture** found = s_textureRegistry.FindByText( textureName );
+	if ( found != nullptr ) return *found;
 	else
 	{
-		s_textureRegistry[ textureName ] = new Texture( width, height, format );
-		return s_textureRegistry[ textureName ];
+		Texture* newTexture = new Texture( width, height, format );
+		s_textureRegistry.Insert( Name( textureName ), newTexture );
+		return newTexture;
 	}
 }
 
@@ -209,18 +213,19 @@ STATIC Texture* Texture::CreateTextureFromNoData( const std::string& textureName
 //
 STATIC Texture* Texture::CreateOrGetTexture( const std::string& imageFilePath )
 {
-	if ( s_textureRegistry.find( imageFilePath ) != s_textureRegistry.end() ) 
-		return s_textureRegistry[ imageFilePath ];
+	Texture** found = s_textureRegistry.FindByText( imageFilePath );
+	if ( found != nullptr ) 
+		return *found;
 
 	FILE *f = fopen( imageFilePath.c_str(), "rb" );
 
 	if ( f == nullptr ) 
 		return nullptr;
-	else 
-		s_textureRegistry[ imageFilePath ] = new Texture( imageFilePath );
 
 	fclose( f );
 
-	return s_textureRegistry[ imageFilePath ];
+	Texture* newTexture = new Texture( imageFilePath );
+	s_textureRegistry.Insert( Name( imageFilePath ), newTexture );
+	return newTexture;
 }
 
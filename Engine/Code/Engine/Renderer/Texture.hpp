@@ -1,7 +1,7 @@
 #pragma once
 
 
-#include <map>
+#include "Engine/String/NameMap.hpp"
 
 #include "Engine/Math/Vector2.hpp"
 
@@ -32,7 +32,7 @@ private:
 	Texture( const unsigned char* imageData, const Vector2i& textureSizeInTexels, unsigned int numComponents ); //Called by CreateFromBytes.
 	Texture( unsigned int width, unsigned int height, TextureFormat format ); //Called by CreateFromNoData.
 
-	static std::map<std::string, Texture*> s_textureRegistry;
+	static NameMap<Texture*> s_textureRegistry; //By path, or by name for those made from bytes or no data.
 	unsigned int m_openglTextureID;
 	Vector2i m_sizeInTexels;
 };
\ No newline at end of file
@@ -23,6 +23,7 @@
 #include "Engine/Math/Matrix4x4.hpp"
 #include "Engine/Core/TheConsole.hpp"
 #include "Engine/Core/Command.hpp"
+#include "Engine/Time/Profiler.hpp"
 
 //SD3
 #include "Engine/Renderer/Sampler.hpp"
@@ -34,6 +35,7 @@
 #include "Engine/Renderer/ShaderProgram.hpp"
 #include "Engine/Input/TheInput.hpp" //For light piloting in UpdateLights.
 #include "Engine/Math/Camera3D.hpp" //For light piloting in UpdateLights.
+#include "Engine/Memory/FrameAllocator.hpp"
 #include <memory>
 
 //AES
@@ -1159,6 +1161,8 @@ TheRenderer::TheRenderer( double screenWidth, double screenHeight )
 	, m_defaultProportionalFont( nullptr )
 	, m_defaultSampler( nullptr )
 	, m_defaultTexture( nullptr )
+	, m_drawCallsMetric( Metrics::RegisterCounter( "renderer.draw_calls" ) )
+	, m_vertexesDrawnMetric( Metrics::RegisterCounter( "renderer.vertexes_drawn" ) )
 {
 	SetScreenDimensions( screenWidth, screenHeight );
 
@@ -1329,6 +1333,7 @@ void TheRenderer::DrawVbo_PCT( unsigned int vboID, int numVerts, VertexGroupingR
 	glTexCoordPointer( 2, GL_FLOAT, sizeof( Vertex3D_PCT ), (const GLvoid*)offsetof( Vertex3D_PCT, m_texCoords ) );
 
 	glDrawArrays( GetOpenGLVertexGroupingRule( vertexGroupingRule ), 0, numVerts );
+	CountDrawCall( numVerts );
 
 	glDisableClientState( GL_VERTEX_ARRAY );
 	glDisableClientState( GL_COLOR_ARRAY );
@@ -1962,16 +1967,87 @@ void TheRenderer::DrawTextProportional3D( const Vector3f& lowerLeftOriginPos, co
 
 
 //--------------------------------------------------------------------------------------------------------------
-void TheRenderer::DrawTextProportional2D( const Vector2f& lowerLeftOriginPos, const std::string& inputText, float scale /*= .25f*/, const BitmapFont* font /*= nullptr*/, const Rgba& tint /*= Rgba()*/, bool drawDropShadow /*= true*/, const Rgba& shadowColor /*=Rgba::BLACK*/ )
+template < typename VertexVector >
+static void AppendTexturedQuad( VertexVector& inout_vertexes, const AABB2f& bounds, const AABB2f& texCoords, const Rgba& tint )
 {
-	if ( font == nullptr )
-		font = m_defaultProportionalFont;
+	//Same corners and texel flip as the textured 2D DrawAABB.
+	inout_vertexes.push_back( Vertex3D_PCT( Vector3f( bounds.mins.x, bounds.mins.y, 0.f ), Vector2f( texCoords.mins.x, texCoords.maxs.y ), tint ) );
+	inout_vertexes.push_back( Vertex3D_PCT( Vector3f( bounds.maxs.x, bounds.mins.y, 0.f ), Vector2f( texCoords.maxs.x, texCoords.maxs.y ), tint ) );
+	inout_vertexes.push_back( Vertex3D_PCT( Vector3f( bounds.maxs.x, bounds.maxs.y, 0.f ), Vector2f( texCoords.maxs.x, texCoords.mins.y ), tint ) );
+	inout_vertexes.push_back( Vertex3D_PCT( Vector3f( bounds.mins.x, bounds.maxs.y, 0.f ), Vector2f( texCoords.mins.x, texCoords.mins.y ), tint ) );
+}
+
+
+//--------------------------------------------------------------------------------------------------------------
+static void FlushGlyphQuads( FrameVector< Vertex3D_PCT >& inout_vertexes, const Texture* texture )
+{
+	if ( inout_vertexes.empty() )
+		return;
+
+	g_theRenderer->BindTexture( texture );
+	g_theRenderer->DrawVertexArray_PCT( VertexGroupingRule::AS_QUADS, inout_vertexes.data(), (unsigned int)inout_vertexes.size() ); //Unbinds after.
+	inout_vertexes.clear();
+}
+
+
+//--------------------------------------------------------------------------------------------------------------
+struct DrawGlyphPages //Draws each run of same-page quads as soon as the page changes.
+{
+	DrawGlyphPages() : m_batchTexture( nullptr ) {}
+	void OnPageChange( FrameVector< Vertex3D_PCT >& inout_vertexes, const Texture* nextTexture ) { FlushGlyphQuads( inout_vertexes, m_batchTexture ); m_batchTexture = nextTexture; }
+	void OnFinish( FrameVector< Vertex3D_PCT >& inout_vertexes ) { FlushGlyphQuads( inout_vertexes, m_batchTexture ); }
+
+	const Texture* m_batchTexture;
+};
+
+
+//--------------------------------------------------------------------------------------------------------------
+struct CacheGlyphPages //Records where each run of same-page quads starts, to draw them all later.
+{
+	CacheGlyphPages( TextQuadCache& cache ) : m_cache( cache ) {}
+	void OnPageChange( std::vector< Vertex3D_PCT >& inout_vertexes, const Texture* nextTexture );
+	void OnFinish( std::vector< Vertex3D_PCT >& inout_vertexes );
+
+	TextQuadCache& m_cache;
+};
+
+
+//--------------------------------------------------------------------------------------------------------------
+void CacheGlyphPages::OnPageChange( std::vector< Vertex3D_PCT >& inout_vertexes, const Texture* nextTexture )
+{
+	OnFinish( inout_vertexes );
+	if ( !m_cache.m_batches.empty() && m_cache.m_batches.back().m_texture == nextTexture )
+		return; //Same page as the end of the text appended before, so one draw covers both.
+
+	TextQuadBatch batch;
+	batch.m_texture = nextTexture;
+	batch.m_firstVertex = (unsigned int)inout_vertexes.size();
+	batch.m_numVertexes = 0;
+	m_cache.m_batches.push_back( batch );
+}
 
+
+//--------------------------------------------------------------------------------------------------------------
+void CacheGlyphPages::OnFinish( std::vector< Vertex3D_PCT >& inout_vertexes )
+{
+	if ( !m_cache.m_batches.empty() )
+		m_cache.m_batches.back().m_numVertexes = (unsigned int)inout_vertexes.size() - m_cache.m_batches.back().m_firstVertex;
+}
+
+
+//--------------------------------------------------------------------------------------------------------------
+template < typename VertexVector, typename GlyphPageHandler >
+static void AppendGlyphQuadsProportional2D( VertexVector& inout_vertexes, GlyphPageHandler& pageHandler, const Vector2f& lowerLeftOriginPos, const StringView& inputText,
+											float scale, const BitmapFont* font, const Rgba& tint, bool drawDropShadow, const Rgba& shadowColor )
+{
 	Vector2f cursor = lowerLeftOriginPos; //Assuming its the lower-left.
 
 	const Glyph* previousGlyph = nullptr; //For kerning check.
 
-	for ( unsigned int charIndex = 0; charIndex < inputText.size(); charIndex++ )
+	//Quads on the same page as the one before go in the same run, and pageHandler hears whenever the page changes.
+	const Texture* batchTexture = nullptr;
+
+	for ( unsigned int charIndex = 0; charIndex < inputText.GetLength(); charIndex++ )
 	{
 		char c = inputText[ charIndex ];
 		const Glyph* currentGlyph = font->GetGlyphForChar( c ); //Use m_fontGlyphs.
@@ -2000,6 +2076,11 @@ void TheRenderer::DrawTextProportional2D( const Vector2f& lowerLeftOriginPos, co
 		AABB2f texCoords = font->GetTexCoordsForGlyph( currentGlyph->m_id );
 
 		Texture* texture = font->GetFontTexture( currentGlyph->m_page );
+		if ( texture != batchTexture )
+		{
+			pageHandler.OnPageChange( inout_vertexes, texture );
+			batchTexture = texture;
+		}
 
 		if ( drawDropShadow )
 		{
@@ -2007,19 +2088,60 @@ void TheRenderer::DrawTextProportional2D( const Vector2f& lowerLeftOriginPos, co
 			Vector2f shadowOffset = Vector2f( DROP_SHADOW_OFFSET, -DROP_SHADOW_OFFSET );
 			shadowRenderBounds.mins += shadowOffset;
 			shadowRenderBounds.maxs += shadowOffset;
-			g_theRenderer->DrawAABB( VertexGroupingRule::AS_QUADS, shadowRenderBounds, *texture, texCoords, shadowColor );
+			AppendTexturedQuad( inout_vertexes, shadowRenderBounds, texCoords, shadowColor );
 		}
-		DrawAABB( VertexGroupingRule::AS_QUADS, renderBounds, *texture, texCoords, tint );
+		AppendTexturedQuad( inout_vertexes, renderBounds, texCoords, tint );
 
 		cursor.x += ( currentGlyph->m_xadvance * scale ); //Move to next glyph.
 
 		previousGlyph = currentGlyph; //For next kerning check.
 	}
+
+	pageHandler.OnFinish( inout_vertexes );
 }
 
 
 //--------------------------------------------------------------------------------------------------------------
-void TheRenderer::DrawTextMonospaced2D( const Vector2f& originPos, const std::string& inputText, float cellHeight, const Rgba& tint /*= Rgba()*/, const FixedBitmapFont* font /*= nullptr*/, float cellAspect /*= 1.f */, bool drawDropShadow /*= true*/ )
+void TheRenderer::DrawTextProportional2D( const Vector2f& lowerLeftOriginPos, const StringView& inputText, float scale /*= .25f*/, const BitmapFont* font /*= nullptr*/, const Rgba& tint /*= Rgba()*/, bool drawDropShadow /*= true*/, const Rgba& shadowColor /*=Rgba::BLACK*/ )
+{
+	if ( font == nullptr )
+		font = m_defaultProportionalFont;
+
+	//One draw per run of glyphs on the same page rather than one per quad. Each shadow still precedes its glyph, so overlaps layer as before.
+	FrameVector< Vertex3D_PCT > vertexes;
+	vertexes.reserve( inputText.GetLength() * ( drawDropShadow ? 8 : 4 ) );
+	DrawGlyphPages pageHandler;
+	AppendGlyphQuadsProportional2D( vertexes, pageHandler, lowerLeftOriginPos, inputText, scale, font, tint, drawDropShadow, shadowColor );
+}
+
+
+//--------------------------------------------------------------------------------------------------------------
+void TheRenderer::AppendTextProportional2D( TextQuadCache& inout_cache, const Vector2f& lowerLeftOriginPos, const StringView& inputText, float scale /*= .25f*/, const BitmapFont* font /*= nullptr*/, const Rgba& tint /*= Rgba()*/, bool drawDropShadow /*= true*/, const Rgba& shadowColor /*=Rgba::BLACK*/ )
+{
+	if ( font == nullptr )
+		font = m_defaultProportionalFont;
+
+	CacheGlyphPages pageHandler( inout_cache );
+	AppendGlyphQuadsProportional2D( inout_cache.m_vertexes, pageHandler, lowerLeftOriginPos, inputText, scale, font, tint, drawDropShadow, shadowColor );
+}
+
+
+//--------------------------------------------------------------------------------------------------------------
+void TheRenderer::DrawTextQuadCache( const TextQuadCache& cache )
+{
+	for ( const TextQuadBatch& batch : cache.m_batches )
+	{
+		if ( batch.m_numVertexes == 0 )
+			continue;
+
+		BindTexture( batch.m_texture );
+		DrawVertexArray_PCT( VertexGroupingRule::AS_QUADS, &cache.m_vertexes[ batch.m_firstVertex ], batch.m_numVertexes ); //Unbinds after.
+	}
+}
+
+
+//--------------------------------------------------------------------------------------------------------------
+void TheRenderer::DrawTextMonospaced2D( const Vector2f& originPos, const StringView& inputText, float cellHeight, const Rgba& tint /*= Rgba()*/, const FixedBitmapFont* font /*= nullptr*/, float cellAspect /*= 1.f */, bool drawDropShadow /*= true*/ )
 {
 	if ( font == nullptr ) 
 		font = m_defaultMonospaceFont;
@@ -2027,13 +2149,15 @@ void TheRenderer::DrawTextMonospaced2D( const Vector2f& originPos, const std::st
 	Vector2f glyphBottomLeft = originPos; //Treated as the upper/lower-left.
 	Vector2f cellSize( cellAspect * cellHeight, cellHeight );
 
-	for ( int stringIndex = 0; stringIndex < (int)inputText.size( ); stringIndex++ )
+	FrameVector< Vertex3D_PCT > vertexes; //One page, so one draw for the whole string.
+	vertexes.reserve( inputText.GetLength() * ( drawDropShadow ? 8 : 4 ) );
+
+	for ( int stringIndex = 0; stringIndex < (int)inputText.GetLength(); stringIndex++ )
 	{
 		AABB2f texCoords = font->GetTexCoordsForGlyph( inputText[ stringIndex ] ); //this is returning (topLeftX, topLeftY, bottomRightX, bottomRightY).
 
 		Vector2f glyphTopRight = glyphBottomLeft + cellSize;
 		AABB2f renderBounds = AABB2f( glyphBottomLeft, glyphTopRight );
-		Texture* fontTexture = font->GetFontTexture();
 
 		if ( drawDropShadow )
 		{
@@ -2041,12 +2165,14 @@ void TheRenderer::DrawTextMonospaced2D( const Vector2f& originPos, const std::st
 			Vector2f shadowOffset = Vector2f( DROP_SHADOW_OFFSET, -DROP_SHADOW_OFFSET );
 			shadowRenderBounds.mins += shadowOffset;
 			shadowRenderBounds.maxs += shadowOffset;
-			g_theRenderer->DrawAABB( VertexGroupingRule::AS_QUADS, shadowRenderBounds, *fontTexture, texCoords, Rgba::BLACK );
+			AppendTexturedQuad( vertexes, shadowRenderBounds, texCoords, Rgba::BLACK );
 		}
-		g_theRenderer->DrawAABB( VertexGroupingRule::AS_QUADS, renderBounds, *fontTexture, texCoords, tint );
+		AppendTexturedQuad( vertexes, renderBounds, texCoords, tint );
 
 		glyphBottomLeft.x += cellSize.x;
 	}
+
+	FlushGlyphQuads( vertexes, font->GetFontTexture() );
 }
 
 
@@ -2088,6 +2214,7 @@ void TheRenderer::DrawVertexArray_PCT( const int vertexGroupingRule, const std::
 	glTexCoordPointer( 2, GL_FLOAT, sizeof( Vertex3D_PCT ), &vertexArrayData[ 0 ].m_texCoords );
 
 	glDrawArrays( GetOpenGLVertexGroupingRule( vertexGroupingRule ), 0, vertexArraySize );
+	CountDrawCall( vertexArraySize );
 
 	glDisableClientState( GL_VERTEX_ARRAY );
 	glDisableClientState( GL_COLOR_ARRAY );
@@ -2111,6 +2238,7 @@ void TheRenderer::DrawVertexArray_PCT( const int vertexGroupingRule, const Verte
 	glTexCoordPointer( 2, GL_FLOAT, sizeof( Vertex3D_PCT ), &vertexArrayData[ 0 ].m_texCoords );
 
 	glDrawArrays( GetOpenGLVertexGroupingRule( vertexGroupingRule ), 0, vertexArraySize );
+	CountDrawCall( vertexArraySize );
 
 	glDisableClientState( GL_VERTEX_ARRAY );
 	glDisableClientState( GL_COLOR_ARRAY );
@@ -2993,6 +3121,8 @@ void TheRenderer::ApplyAnimationToSkeleton( int numAnimation, int numSkeleton )
 //--------------------------------------------------------------------------------------------------------------
 void TheRenderer::PostRenderStep()
 {
+	PROFILE_SCOPE( "TheRenderer::PostRenderStep" );
+
 	if ( !g_animationPaused )
 		ApplyAnimationToSkeleton( g_lastAnimationSelected, g_lastSkeletonSelected );
 
@@ -3009,6 +3139,8 @@ void TheRenderer::PostRenderStep()
 //--------------------------------------------------------------------------------------------------------------
 void TheRenderer::PreRenderStep()
 {
+	PROFILE_SCOPE( "TheRenderer::PreRenderStep" );
+
 	g_theRenderer->ClearScreenToColor( Rgba::DARK_GRAY ); //BG color of FBOs-off world.
 	g_theRenderer->ClearScreenDepthBuffer();
 
@@ -4,6 +4,8 @@
 //For default arguments.
 #include "Engine/EngineCommon.hpp"
 #include "Engine/Renderer/Vertexes.hpp"
+#include "Engine/Metrics/Metrics.hpp"
+#include "Engine/String/StringView.hpp"
 #include <string>
 #include <vector>
 #include <memory>
@@ -30,6 +32,25 @@ class Camera3D;
 extern TheRenderer* g_theRenderer;
 
 
+//-----------------------------------------------------------------------------
+struct TextQuadBatch
+{
+	const Texture* m_texture;
+	unsigned int m_firstVertex;
+	unsigned int m_numVertexes;
+};
+
+
+//-----------------------------------------------------------------------------
+struct TextQuadCache //Glyph quads laid out once by AppendTextProportional2D, then redrawn as is until the text changes.
+{
+	void Clear() { m_vertexes.clear(); m_batches.clear(); } //Keeps the capacity, so refilling doesn't allocate.
+
+	std::vector< Vertex3D_PCT > m_vertexes;
+	std::vector< TextQuadBatch > m_batches; //One draw each, merged across strings on the same font page.
+};
+
+
 //-----------------------------------------------------------------------------
 class TheRenderer
 {
@@ -105,8 +126,10 @@ public:
 	void DrawCylinder( const int vertexGroupingRule, const Vector3f& centerPos, float radius, float height, float numSlices, float numSidesPerSlice, const Rgba& tint = Rgba(), float lineThickness = 1.0f );
 
 	void DrawTextProportional3D( const Vector3f &lowerLeftOriginPos, const std::string& inputText, const Vector3f& textPlaneUpDir, const Vector3f& textPlaneRightDir, float scale = .25f, const BitmapFont* font = nullptr, const Rgba& tint = Rgba(), bool drawDropShadow = true, const Rgba& shadowColor = Rgba::BLACK );
-	void DrawTextProportional2D( const Vector2f& originPos, const std::string& inputText, float scale = .25f, const BitmapFont* font = nullptr, const Rgba& tint = Rgba(), bool drawDropShadow = true, const Rgba& shadowColor = Rgba::BLACK );
-	void DrawTextMonospaced2D( const Vector2f& startBottomLeft, const std::string& asciiText, float cellHeight, const Rgba& tint = Rgba(), const FixedBitmapFont* font = nullptr, float cellAspect = 1.f, bool drawDropShadow = true );
+	void DrawTextProportional2D( const Vector2f& originPos, const StringView& inputText, float scale = .25f, const BitmapFont* font = nullptr, const Rgba& tint = Rgba(), bool drawDropShadow = true, const Rgba& shadowColor = Rgba::BLACK );
+	void AppendTextProportional2D( TextQuadCache& inout_cache, const Vector2f& originPos, const StringView& inputText, float scale = .25f, const BitmapFont* font = nullptr, const Rgba& tint = Rgba(), bool drawDropShadow = true, const Rgba& shadowColor = Rgba::BLACK );
+	void DrawTextQuadCache( const TextQuadCache& cache );
+	void DrawTextMonospaced2D( const Vector2f& startBottomLeft, const StringView& asciiText, float cellHeight, const Rgba& tint = Rgba(), const FixedBitmapFont* font = nullptr, float cellAspect = 1.f, bool drawDropShadow = true );
 	void DrawTextInBox2D( const AABB2f& textboxBounds, const Rgba& textboxColor, const std::string& text, int alignmentHorizontal = -1, int alignmentVertical = 1, float textScale = .25f, const BitmapFont* font = nullptr, const Rgba& tint = Rgba(), bool drawDropShadow = true, const Rgba& shadowColor = Rgba::BLACK );
 
 	void DrawAxes( float length, float lineThickness = 1.f, float alphaOpacity = 1.f, bool drawZ = false );
@@ -116,6 +139,7 @@ public:
 	void DrawVertexArray_PCT( const int vertexGroupingRule, const Vertex3D_PCT* vertexArrayData, unsigned int vertexArraySize );
 
 	void DrawVbo_PCT( unsigned int vboID, int numVerts, VertexGroupingRule vertexGroupingRule );
+	void CountDrawCall( unsigned int numVertexes ) { Metrics::AddToCounter( m_drawCallsMetric ); Metrics::AddToCounter( m_vertexesDrawnMetric, numVertexes ); } //For whoever calls glDraw* directly.
 
 	//SD3 A7 - FBO
 
@@ -204,5 +228,8 @@ private:
 	double m_screenWidth, m_screenHeight;
 	unsigned int m_screenWidthAsUnsignedInt, m_screenHeightAsUnsignedInt;
 
+	MetricID m_drawCallsMetric;
+	MetricID m_vertexesDrawnMetric;
+
 	static const float DROP_SHADOW_OFFSET;
 };
\ No newline at end of file
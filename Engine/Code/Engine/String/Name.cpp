@@ -0,0 +1,72 @@
+#include "Engine/String/Name.hpp"
+#include "Engine/String/NameMap.hpp"
+#include "Engine/Error/ErrorWarningAssert.hpp"
+#include "Engine/String/StringUtils.hpp"
+#include "Engine/EngineCommon.hpp"
+
+#include <mutex>
+
+
+//--------------------------------------------------------------------------------------------------------------
+static NameMap< NameEntry* >* s_internTable = nullptr; //Made on first intern, since static Names may intern before main.
+static std::mutex& GetInternTableMutex()
+{
+	static std::mutex s_internTableMutex; //Likewise.
+	return s_internTableMutex;
+}
+
+
+//--------------------------------------------------------------------------------------------------------------
+NameID HashName( const StringView& text )
+{
+	NameID hash = 2166136261u;
+	for ( size_t charIndex = 0; charIndex < text.GetLength(); charIndex++ )
+		hash = ( hash ^ static_cast<unsigned char>( text[ charIndex ] ) ) * 16777619u;
+
+	return ( hash == 0 ) ? 1 : hash;
+}
+
+
+//--------------------------------------------------------------------------------------------------------------
+STATIC const NameEntry* Name::Intern( const StringView& text )
+{
+	if ( text.GetLength() == 0 )
+		return nullptr;
+
+	NameID id = HashName( text ); //Outside the lock.
+
+	std::lock_guard< std::mutex > lock( GetInternTableMutex() );
+	if ( s_internTable == nullptr )
+		s_internTable = new NameMap< NameEntry* >();
+
+	NameEntry** found = s_internTable->Find( id );
+	if ( found != nullptr )
+	{
+		const std::string& foundText = ( *found )->m_text;
+		GUARANTEE_OR_DIE( foundText.size() == text.GetLength() && foundText.compare( 0, foundText.size(), text.GetData(), text.GetLength() ) == 0,
+						  Stringf( "Name hash collision: \"%s\" and \"%s\" share an ID, rename one!", foundText.c_str(), std::string( text.GetData(), text.GetLength() ).c_str() ) );
+		return *found;
+	}
+
+	NameEntry* newEntry = new NameEntry();
+	newEntry->m_id = id;
+	newEntry->m_text.assign( text.GetData(), text.GetLength() );
+	s_internTable->Insert( id, newEntry );
+	return newEntry;
+}
+
+
+//--------------------------------------------------------------------------------------------------------------
+const std::string& Name::GetString() const
+{
+	static const std::string s_emptyString;
+	return ( m_entry != nullptr ) ? m_entry->m_text : s_emptyString;
+}
+
+
+//--------------------------------------------------------------------------------------------------------------
+STATIC unsigned int Name::GetNumInterned()
+{
+	std::lock_guard< std::mutex > lock( GetInternTableMutex() );
+	return ( s_internTable != nullptr ) ? s_internTable->GetSize() : 0;
+}
@@ -0,0 +1,63 @@
+#pragma once
+
+
+#include "Engine/String/StringView.hpp"
+#include <stdint.h>
+#include <string>
+
+
+//-----------------------------------------------------------------------------
+typedef uint32_t NameID; //32-bit FNV-1a of the text, never 0, which NameMap keeps for its empty slots.
+
+
+//-----------------------------------------------------------------------------
+constexpr NameID HashNameFNV1a( const char* text, NameID hash )
+{
+	return ( *text == '\0' ) ? hash : HashNameFNV1a( text + 1, ( hash ^ static_cast<unsigned char>( *text ) ) * 16777619u );
+}
+constexpr NameID HashName( const char* text ) //Compile-time on literals, e.g. a switch case or static const.
+{
+	return ( HashNameFNV1a( text, 2166136261u ) == 0 ) ? 1 : HashNameFNV1a( text, 2166136261u );
+}
+NameID HashName( const StringView& text ); //The same hash, at runtime, on text that needn't be terminated.
+
+
+//-----------------------------------------------------------------------------
+struct NameEntry //One per distinct text, allocated on first intern and kept for the rest of the run.
+{
+	NameID m_id;
+	std::string m_text;
+};
+
+
+//-----------------------------------------------------------------------------
+// An interned string: every Name with the same text points at one shared NameEntry, so a Name costs a pointer,
+// copying one never allocates, and comparing two is a pointer compare. Constructing one from text hashes it and
+// looks it up in the global table. Loading interns on the main thread, but the table is locked anyway so Names stay
+// safe to build inside JobSystem jobs; that costs one uncontended lock per construction, never per copy or compare.
+// Two different texts with the same hash die at intern time, so a NameID identifies its text for the whole run.
+//-----------------------------------------------------------------------------
+class Name
+{
+public:
+	Name() : m_entry( nullptr ) {}
+	Name( const char* text ) : m_entry( Intern( StringView( text ) ) ) {}
+	Name( const std::string& text ) : m_entry( Intern( StringView( text ) ) ) {}
+	explicit Name( const StringView& text ) : m_entry( Intern( text ) ) {}
+
+	NameID GetID() const { return ( m_entry != nullptr ) ? m_entry->m_id : HashName( "" ); }
+	const std::string& GetString() const;
+	const char* GetCString() const { return GetString().c_str(); }
+	bool IsEmpty() const { return m_entry == nullptr; }
+
+	bool operator==( const Name& other ) const { return m_entry == other.m_entry; }
+	bool operator!=( const Name& other ) const { return m_entry != other.m_entry; }
+
+	static unsigned int GetNumInterned();
+
+
+private:
+	static const NameEntry* Intern( const StringView& text ); //nullptr for "", so the empty Name needs no table.
+
+	const NameEntry* m_entry;
+};
@@ -0,0 +1,197 @@
+#pragma once
+
+
+#include "Engine/String/Name.hpp"
+#include <vector>
+
+
+//-----------------------------------------------------------------------------
+// Open-addressing hash map from NameID to T, for registries that used to key a std::map by std::string.
+// One flat array of slots, probed linearly from the ID's Fibonacci hash, so a lookup is usually one cache line
+// and never a string compare. Grows at 3/4 full. Removal shifts later probes back rather than leaving tombstones.
+// Iteration order is arbitrary: registries whose order matters, e.g. menus or seeded random picks, stay std::map.
+// Keys inserted as Names keep their text, so FindByText can look up raw text without interning it first.
+//-----------------------------------------------------------------------------
+template < typename T >
+class NameMap
+{
+public:
+	NameMap() : m_numEntries( 0 ), m_shift( 32 ) {}
+
+	T* Find( NameID id );
+	const T* Find( NameID id ) const { return const_cast< NameMap* >( this )->Find( id ); }
+	T* Find( const Name& name ) { return Find( name.GetID() ); }
+	T* FindByText( const StringView& text ); //No lock or allocation, so a miss is as cheap as a hit. Intern only to insert.
+	bool Insert( NameID id, const T& value ) { return Insert( id, Name(), value ); } //False, leaving the present value, if id is already in.
+	bool Insert( const Name& name, const T& value ) { return Insert( name.GetID(), name, value ); }
+	bool Remove( NameID id );
+	void Clear();
+
+	unsigned int GetSize() const { return m_numEntries; }
+	bool IsEmpty() const { return m_numEntries == 0; }
+
+	template < typename Visitor > void ForEach( Visitor& visitor ) const; //visitor( NameID, const T& ) per entry.
+
+
+private:
+	static const NameID EMPTY_SLOT_ID = 0;
+
+	struct Slot
+	{
+		Slot() : m_id( EMPTY_SLOT_ID ), m_name(), m_value() {}
+		NameID m_id;
+		Name m_name; //Empty when inserted by bare NameID, e.g. the intern table's own entries.
+		T m_value;
+	};
+
+	Slot* FindSlot( NameID id );
+	bool Insert( NameID id, const Name& name, const T& value );
+
+	unsigned int GetHomeSlotIndex( NameID id ) const { return static_cast<unsigned int>( ( id * 2654435769u ) >> m_shift ); }
+	unsigned int GetMask() const { return static_cast<unsigned int>( m_slots.size() - 1 ); }
+	void Grow();
+
+	std::vector< Slot > m_slots; //Power-of-two many, or none until the first insert.
+	unsigned int m_numEntries;
+	unsigned int m_shift; //32 minus log2 of the slot count, so the hash's top bits pick the slot.
+};
+
+
+//-----------------------------------------------------------------------------
+template < typename T >
+typename NameMap< T >::Slot* NameMap< T >::FindSlot( NameID id )
+{
+	if ( m_numEntries == 0 )
+		return nullptr;
+
+	for ( unsigned int slotIndex = GetHomeSlotIndex( id ); ; slotIndex = ( slotIndex + 1 ) & GetMask() )
+	{
+		Slot& slot = m_slots[ slotIndex ];
+		if ( slot.m_id == id )
+			return &slot;
+		if ( slot.m_id == EMPTY_SLOT_ID )
+			return nullptr;
+	}
+}
+
+
+//-----------------------------------------------------------------------------
+template < typename T >
+T* NameMap< T >::Find( NameID id )
+{
+	Slot* slot = FindSlot( id );
+	return ( slot != nullptr ) ? &slot->m_value : nullptr;
+}
+
+
+//-----------------------------------------------------------------------------
+template < typename T >
+T* NameMap< T >::FindByText( const StringView& text )
+{
+	Slot* slot = FindSlot( HashName( text ) );
+	if ( slot == nullptr )
+		return nullptr;
+
+	if ( !slot->m_name.IsEmpty() && StringView( slot->m_name.GetString() ) != text )
+		return nullptr; //Another text with the same ID, which interning this one would report.
+
+	return &slot->m_value;
+}
+
+
+//-----------------------------------------------------------------------------
+template < typename T >
+bool NameMap< T >::Insert( NameID id, const Name& name, const T& value )
+{
+	if ( ( m_numEntries + 1 ) * 4 > m_slots.size() * 3 )
+		Grow();
+
+	for ( unsigned int slotIndex = GetHomeSlotIndex( id ); ; slotIndex = ( slotIndex + 1 ) & GetMask() )
+	{
+		Slot& slot = m_slots[ slotIndex ];
+		if ( slot.m_id == id )
+			return false;
+		if ( slot.m_id == EMPTY_SLOT_ID )
+		{
+			slot.m_id = id;
+			slot.m_name = name;
+			slot.m_value = value;
+			++m_numEntries;
+			return true;
+		}
+	}
+}
+
+
+//-----------------------------------------------------------------------------
+template < typename T >
+bool NameMap< T >::Remove( NameID id )
+{
+	if ( m_numEntries == 0 )
+		return false;
+
+	unsigned int holeIndex = GetHomeSlotIndex( id );
+	while ( m_slots[ holeIndex ].m_id != id )
+	{
+		if ( m_slots[ holeIndex ].m_id == EMPTY_SLOT_ID )
+			return false;
+		holeIndex = ( holeIndex + 1 ) & GetMask();
+	}
+
+	//Pull back any later entry in the run whose home slot doesn't lie between the hole and it, else Find would stop short.
+	for ( unsigned int slotIndex = ( holeIndex + 1 ) & GetMask(); m_slots[ slotIndex ].m_id != EMPTY_SLOT_ID; slotIndex = ( slotIndex + 1 ) & GetMask() )
+	{
+		unsigned int homeIndex = GetHomeSlotIndex( m_slots[ slotIndex ].m_id );
+		unsigned int distanceFromHome = ( slotIndex - homeIndex ) & GetMask();
+		unsigned int distanceFromHole = ( slotIndex - holeIndex ) & GetMask();
+		if ( distanceFromHome >= distanceFromHole )
+		{
+			m_slots[ holeIndex ] = m_slots[ slotIndex ];
+			holeIndex = slotIndex;
+		}
+	}
+
+	m_slots[ holeIndex ] = Slot();
+	--m_numEntries;
+	return true;
+}
+
+
+//-----------------------------------------------------------------------------
+template < typename T >
+void NameMap< T >::Clear()
+{
+	m_slots.clear();
+	m_numEntries = 0;
+	m_shift = 32;
+}
+
+
+//-----------------------------------------------------------------------------
+template < typename T >
+void NameMap< T >::Grow()
+{
+	std::vector< Slot > oldSlots;
+	oldSlots.swap( m_slots );
+
+	m_slots.resize( oldSlots.empty() ? 16 : oldSlots.size() * 2 );
+	m_shift = 32;
+	for ( size_t numSlots = m_slots.size(); numSlots > 1; numSlots >>= 1 )
+		--m_shift;
+
+	m_numEntries = 0;
+	for ( const Slot& oldSlot : oldSlots )
+		if ( oldSlot.m_id != EMPTY_SLOT_ID )
+			Insert( oldSlot.m_id, oldSlot.m_name, oldSlot.m_value );
+}
+
+
+//-----------------------------------------------------------------------------
+template < typename T >
+template < typename Visitor >
+void NameMap< T >::ForEach( Visitor& visitor ) const
+{
+	for ( const Slot& slot : m_slots )
+		if ( slot.m_id != EMPTY_SLOT_ID )
+			visitor( slot.m_id, slot.m_value );
+}
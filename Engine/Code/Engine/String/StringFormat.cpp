@@ -0,0 +1,434 @@
+#include "Engine/String/StringFormat.hpp"
+
+#include "Engine/Error/ErrorWarningAssert.hpp"
+#include "Engine/Memory/FrameAllocator.hpp"
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+
+//--------------------------------------------------------------------------------------------------------------
+static const char s_DIGIT_PAIRS[] = //Two digits per lookup halves the divides.
+	"00010203040506070809101112131415161718192021222324252627282930313233343536373839"
+	"40414243444546474849505152535455565758596061626364656667686970717273747576777879"
+	"8081828384858687888990919293949596979899";
+static const double s_POWERS_OF_TEN[] = { 1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9 };
+static const int s_MAX_FAST_DECIMAL_PLACES = 9;
+static const double s_MAX_FAST_SCALED_FLOAT = 9007199254740992.0; //2^53, past which doubles skip integers.
+static const int s_MAX_INTEGER_CHARS = 24; //A 64-bit value in decimal, with sign.
+
+
+//--------------------------------------------------------------------------------------------------------------
+FormatBuffer::FormatBuffer()
+	: m_chars( &m_emptyStorage )
+	, m_length( 0 )
+	, m_capacity( 1 )
+	, m_isOnHeap( false )
+	, m_emptyStorage( '\0' )
+{
+}
+
+
+//--------------------------------------------------------------------------------------------------------------
+FormatBuffer::FormatBuffer( char* storage, size_t numStorageChars )
+	: m_chars( storage )
+	, m_length( 0 )
+	, m_capacity( numStorageChars )
+	, m_isOnHeap( false )
+	, m_emptyStorage( '\0' )
+{
+	if ( m_capacity == 0 )
+	{
+		m_chars = &m_emptyStorage;
+		m_capacity = 1;
+	}
+	m_chars[ 0 ] = '\0';
+}
+
+
+//--------------------------------------------------------------------------------------------------------------
+FormatBuffer::~FormatBuffer()
+{
+	if ( m_isOnHeap )
+		delete[] m_chars;
+}
+
+
+//--------------------------------------------------------------------------------------------------------------
+void FormatBuffer::Reserve( size_t numChars )
+{
+	if ( numChars < m_capacity )
+		return;
+
+	size_t newCapacity = m_capacity * 2;
+	if ( newCapacity < numChars + 1 )
+		newCapacity = numChars + 1;
+
+	char* newChars = new char[ newCapacity ];
+	memcpy( newChars, m_chars, m_length + 1 );
+	if ( m_isOnHeap )
+		delete[] m_chars;
+
+	m_chars = newChars;
+	m_capacity = newCapacity;
+	m_isOnHeap = true;
+}
+
+
+//--------------------------------------------------------------------------------------------------------------
+char* FormatBuffer::Extend( size_t numChars )
+{
+	Reserve( m_length + numChars );
+	char* newChars = m_chars + m_length;
+	m_length += numChars;
+	m_chars[ m_length ] = '\0';
+	return newChars;
+}
+
+
+//--------------------------------------------------------------------------------------------------------------
+void FormatBuffer::Append( const char* chars, size_t numChars )
+{
+	memcpy( Extend( numChars ), chars, numChars );
+}
+
+
+//--------------------------------------------------------------------------------------------------------------
+void FormatBuffer::AppendRepeated( char c, size_t count )
+{
+	memset( Extend( count ), c, count );
+}
+
+
+//--------------------------------------------------------------------------------------------------------------
+void FormatBuffer::AppendPrintf( const char* format, ... )
+{
+	va_list variableArgumentList;
+	va_start( variableArgumentList, format );
+	AppendVPrintf( format, variableArgumentList );
+	va_end( variableArgumentList );
+}
+
+
+//--------------------------------------------------------------------------------------------------------------
+void FormatBuffer::AppendVPrintf( const char* format, va_list args )
+{
+	va_list argsForRetry;
+	va_copy( argsForRetry, args );
+
+	//Try the room already there first, and only on overflow grow to the exact size vsnprintf reports.
+	size_t numFreeChars = m_capacity - m_length;
+	int numChars = vsnprintf( m_chars + m_length, numFreeChars, format, args );
+	if ( numChars >= 0 && (size_t)numChars >= numFreeChars )
+	{
+		Reserve( m_length + numChars );
+		vsnprintf( m_chars + m_length, numChars + 1, format, argsForRetry );
+	}
+	va_end( argsForRetry );
+
+	if ( numChars > 0 )
+		m_length += numChars;
+	m_chars[ m_length ] = '\0'; //Also undoes any partial write from a bad format.
+}
+
+
+//--------------------------------------------------------------------------------------------------------------
+static char* WriteDecimalBackwards( char* end, uint64_t value ) //Returns where the digits start.
+{
+	while ( value >= 100 )
+	{
+		const char* pair = &s_DIGIT_PAIRS[ ( value % 100 ) * 2 ];
+		value /= 100;
+		*--end = pair[ 1 ];
+		*--end = pair[ 0 ];
+	}
+	if ( value >= 10 )
+	{
+		const char* pair = &s_DIGIT_PAIRS[ value * 2 ];
+		*--end = pair[ 1 ];
+		*--end = pair[ 0 ];
+	}
+	else
+	{
+		*--end = (char)( '0' + value );
+	}
+	return end;
+}
+
+
+//--------------------------------------------------------------------------------------------------------------
+static char* WriteHexBackwards( char* end, uint64_t value, bool isUppercase )
+{
+	const char* digits = isUppercase ? "0123456789ABCDEF" : "0123456789abcdef";
+	do
+	{
+		*--end = digits[ value & 0xF ];
+		value >>= 4;
+	} while ( value != 0 );
+	return end;
+}
+
+
+//--------------------------------------------------------------------------------------------------------------
+static inline uint64_t GetMagnitude( int64_t value )
+{
+	return ( value < 0 ) ? ( 0ull - (uint64_t)value ) : (uint64_t)value; //Safe for INT64_MIN.
+}
+
+
+//--------------------------------------------------------------------------------------------------------------
+void AppendInt( FormatBuffer& inout_buffer, int64_t value )
+{
+	char digits[ s_MAX_INTEGER_CHARS ];
+	char* end = digits + s_MAX_INTEGER_CHARS;
+	char* start = WriteDecimalBackwards( end, GetMagnitude( value ) );
+	if ( value < 0 )
+		*--start = '-';
+	inout_buffer.Append( start, end - start );
+}
+
+
+//--------------------------------------------------------------------------------------------------------------
+void AppendUnsignedInt( FormatBuffer& inout_buffer, uint64_t value )
+{
+	char digits[ s_MAX_INTEGER_CHARS ];
+	char* end = digits + s_MAX_INTEGER_CHARS;
+	char* start = WriteDecimalBackwards( end, value );
+	inout_buffer.Append( start, end - start );
+}
+
+
+//--------------------------------------------------------------------------------------------------------------
+void AppendFloat( FormatBuffer& inout_buffer, double value, int numDecimalPlaces /*= 6*/ )
+{
+	if ( numDecimalPlaces < 0 )
+		numDecimalPlaces = 6;
+
+	//Scale to an integer count of the last place and round it, which is exact until the scaled value nears 2^53.
+	//Anything past that, NaN or infinity, or near enough a tie that the scaling's own rounding could decide it,
+	//goes to the CRT, so the text always matches printf's.
+	double magnitude = fabs( value );
+	bool canUseFastPath = ( numDecimalPlaces <= s_MAX_FAST_DECIMAL_PLACES ) && ( magnitude == magnitude );
+	double scaled = canUseFastPath ? magnitude * s_POWERS_OF_TEN[ numDecimalPlaces ] : 0.0;
+	canUseFastPath = canUseFastPath && ( scaled < s_MAX_FAST_SCALED_FLOAT );
+
+	double scaledWhole = floor( scaled );
+	double scaledFraction = scaled - scaledWhole;
+	canUseFastPath = canUseFastPath && ( fabs( scaledFraction - 0.5 ) > ( scaled * 1e-15 ) + 1e-9 );
+
+	if ( !canUseFastPath )
+	{
+		inout_buffer.AppendPrintf( "%.*f", numDecimalPlaces, value );
+		return;
+	}
+
+	uint64_t rounded = (uint64_t)scaledWhole + ( ( scaledFraction > 0.5 ) ? 1 : 0 );
+	uint64_t placeValue = (uint64_t)s_POWERS_OF_TEN[ numDecimalPlaces ];
+	uint64_t wholePart = rounded / placeValue;
+	uint64_t fractionPart = rounded % placeValue;
+
+	char digits[ s_MAX_INTEGER_CHARS + s_MAX_FAST_DECIMAL_PLACES + 2 ];
+	char* end = digits + sizeof( digits );
+	char* start = end;
+	if ( numDecimalPlaces > 0 )
+	{
+		char* fractionStart = WriteDecimalBackwards( end, fractionPart );
+		start = end - numDecimalPlaces;
+		memset( start, '0', fractionStart - start ); //Leading zeros, e.g. the 0s of .05.
+		*--start = '.';
+	}
+	start = WriteDecimalBackwards( start, wholePart );
+	if ( signbit( value ) )
+		*--start = '-'; //Also for -0.0 and negatives that round to zero, as printf does.
+
+	inout_buffer.Append( start, end - start );
+}
+
+
+//--------------------------------------------------------------------------------------------------------------
+struct FormatSpec
+{
+	FormatSpec() : m_width( 0 ), m_precision( -1 ), m_isLeftAligned( false ), m_isZeroPadded( false ), m_hexType( '\0' ) {}
+
+	int m_width;
+	int m_precision; //-1 for the type's default.
+	bool m_isLeftAligned;
+	bool m_isZeroPadded;
+	char m_hexType; //'x' or 'X', else '\0'.
+};
+
+
+//--------------------------------------------------------------------------------------------------------------
+static const char* ReadFormatSpec( const char* specStart, FormatSpec& out_spec ) //From just past the ':', returns just past the '}'.
+{
+	const char* cursor = specStart;
+	for ( ; *cursor == '-' || *cursor == '0'; ++cursor )
+		( *cursor == '-' ) ? ( out_spec.m_isLeftAligned = true ) : ( out_spec.m_isZeroPadded = true );
+
+	for ( ; *cursor >= '0' && *cursor <= '9'; ++cursor )
+		out_spec.m_width = ( out_spec.m_width * 10 ) + ( *cursor - '0' );
+
+	if ( *cursor == '.' )
+	{
+		out_spec.m_precision = 0;
+		for ( ++cursor; *cursor >= '0' && *cursor <= '9'; ++cursor )
+			out_spec.m_precision = ( out_spec.m_precision * 10 ) + ( *cursor - '0' );
+	}
+
+	if ( *cursor == 'x' || *cursor == 'X' )
+		out_spec.m_hexType = *cursor++;
+	else if ( *cursor == 'f' )
+		++cursor;
+
+	while ( *cursor != '}' && *cursor != '\0' ) //Unknown spec chars, which CHECKED_FORMAT would have refused.
+		++cursor;
+	return ( *cursor == '}' ) ? cursor + 1 : cursor;
+}
+
+
+//--------------------------------------------------------------------------------------------------------------
+static void AppendPadded( FormatBuffer& inout_buffer, const char* chars, size_t numChars, const FormatSpec& spec, bool isNumber )
+{
+	size_t numPadChars = ( (size_t)spec.m_width > numChars ) ? ( spec.m_width - numChars ) : 0;
+	if ( numPadChars == 0 )
+	{
+		inout_buffer.Append( chars, numChars );
+	}
+	else if ( spec.m_isLeftAligned )
+	{
+		inout_buffer.Append( chars, numChars );
+		inout_buffer.AppendRepeated( ' ', numPadChars );
+	}
+	else if ( spec.m_isZeroPadded && isNumber )
+	{
+		bool hasSign = ( numChars > 0 ) && ( chars[ 0 ] == '-' );
+		if ( hasSign )
+			inout_buffer.Append( '-' ); //Zeros go between the sign and the digits, as printf does.
+		inout_buffer.AppendRepeated( '0', numPadChars );
+		inout_buffer.Append( chars + hasSign, numChars - hasSign );
+	}
+	else
+	{
+		inout_buffer.AppendRepeated( ' ', numPadChars );
+		inout_buffer.Append( chars, numChars );
+	}
+}
+
+
+//--------------------------------------------------------------------------------------------------------------
+static void AppendFormatArg( FormatBuffer& inout_buffer, const FormatArg& arg, const FormatSpec& spec )
+{
+	char integerChars[ s_MAX_INTEGER_CHARS ];
+	char* end = integerChars + s_MAX_INTEGER_CHARS;
+	char* start = end;
+
+	switch ( arg.m_type )
+	{
+	case FormatArg::TYPE_SIGNED:
+	case FormatArg::TYPE_UNSIGNED:
+	{
+		bool isNegative = ( arg.m_type == FormatArg::TYPE_SIGNED ) && ( arg.m_signed < 0 );
+		if ( spec.m_hexType != '\0' )
+		{
+			//Two's complement for negatives, as %x prints them: at the argument's width, or int's for those printf promotes.
+			size_t numBytes = ( arg.m_numBytes < sizeof( int ) ) ? sizeof( int ) : arg.m_numBytes;
+			uint64_t bits = ( numBytes < sizeof( uint64_t ) ) ? ( arg.m_unsigned & ( ( 1ull << ( numBytes * 8 ) ) - 1 ) ) : arg.m_unsigned;
+			start = WriteHexBackwards( end, bits, spec.m_hexType == 'X' );
+		}
+		else
+		{
+			start = WriteDecimalBackwards( end, isNegative ? GetMagnitude( arg.m_signed ) : arg.m_unsigned );
+			if ( isNegative )
+				*--start = '-';
+		}
+		AppendPadded( inout_buffer, start, end - start, spec, true );
+		return;
+	}
+	case FormatArg::TYPE_FLOATING:
+	{
+		if ( spec.m_width == 0 )
+		{
+			AppendFloat( inout_buffer, arg.m_floating, spec.m_precision );
+			return;
+		}
+
+		InlineFormatBuffer< 64 > floatChars;
+		AppendFloat( floatChars, arg.m_floating, spec.m_precision );
+		AppendPadded( inout_buffer, floatChars.GetCString(), floatChars.GetLength(), spec, true );
+		return;
+	}
+	case FormatArg::TYPE_CHAR:
+		AppendPadded( inout_buffer, &arg.m_char, 1, spec, false );
+		return;
+	case FormatArg::TYPE_BOOL:
+		AppendPadded( inout_buffer, arg.m_bool ? "true" : "false", arg.m_bool ? 4 : 5, spec, false );
+		return;
+	case FormatArg::TYPE_STRING:
+	{
+		size_t numChars = arg.m_numChars;
+		if ( spec.m_precision >= 0 && (size_t)spec.m_precision < numChars )
+			numChars = spec.m_precision; //As %.3s does.
+		AppendPadded( inout_buffer, arg.m_chars, numChars, spec, false );
+		return;
+	}
+	}
+}
+
+
+//--------------------------------------------------------------------------------------------------------------
+void AppendFormatArgs( FormatBuffer& inout_buffer, const char* format, const FormatArg* args, int numArgs )
+{
+	int nextArgIndex = 0;
+	const char* literalStart = format;
+	const char* cursor = format;
+
+	while ( *cursor != '\0' )
+	{
+		if ( *cursor != '{' && *cursor != '}' )
+		{
+			++cursor;
+			continue;
+		}
+
+		inout_buffer.Append( literalStart, cursor - literalStart );
+
+		if ( cursor[ 0 ] == cursor[ 1 ] ) //"{{" or "}}".
+		{
+			inout_buffer.Append( *cursor );
+			cursor += 2;
+		}
+		else if ( *cursor == '}' ) //Stray, kept as is.
+		{
+			inout_buffer.Append( *cursor++ );
+		}
+		else
+		{
+			FormatSpec spec;
+			if ( cursor[ 1 ] == ':' )
+				cursor = ReadFormatSpec( cursor + 2, spec );
+			else
+				cursor += ( cursor[ 1 ] == '}' ) ? 2 : 1;
+
+			if ( nextArgIndex < numArgs )
+				AppendFormatArg( inout_buffer, args[ nextArgIndex++ ], spec );
+			else
+				inout_buffer.Append( "{?}", 3 ); //More placeholders than arguments, visible rather than fatal.
+		}
+
+		literalStart = cursor;
+	}
+
+	inout_buffer.Append( literalStart, cursor - literalStart );
+}
+
+
+//--------------------------------------------------------------------------------------------------------------
+StringView CopyToFrameMemory( const StringView& text )
+{
+	ASSERT_OR_DIE( g_theFrameAllocator != nullptr, "CopyToFrameMemory needs g_theFrameAllocator, which TheEngine::Startup creates!" );
+
+	char* chars = (char*)FrameAllocate( text.GetLength() + 1, 1 ); //Not the allocator directly, which only its own thread may touch.
+	memcpy( chars, text.GetData(), text.GetLength() );
+	chars[ text.GetLength() ] = '\0';
+	return StringView( chars, text.GetLength() );
+}
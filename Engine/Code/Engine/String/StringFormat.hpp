@@ -0,0 +1,192 @@
+#pragma once
+
+
+#include "Engine/String/StringView.hpp"
+#include <stdarg.h>
+#include <stdint.h>
+#include <string>
+
+
+//-----------------------------------------------------------------------------
+// A growable char buffer to format into, always null-terminated. It starts in storage the caller lends it,
+// usually a stack array via InlineFormatBuffer, and only moves to the heap if the text outgrows that, so
+// nothing is ever truncated. Clear() keeps the capacity, so a buffer kept across calls stops allocating once warm.
+//-----------------------------------------------------------------------------
+class FormatBuffer
+{
+public:
+	FormatBuffer(); //Heap only, from the first append.
+	FormatBuffer( char* storage, size_t numStorageChars ); //storage must outlive the buffer, and holds numStorageChars - 1 chars before spilling.
+	~FormatBuffer();
+
+	void Append( const char* chars, size_t numChars );
+	void Append( const StringView& text ) { Append( text.GetData(), text.GetLength() ); }
+	void Append( char c ) { Reserve( m_length + 1 ); m_chars[ m_length++ ] = c; m_chars[ m_length ] = '\0'; }
+	void AppendRepeated( char c, size_t count );
+	void AppendPrintf( const char* format, ... ); //Old printf syntax, for format strings built at runtime.
+	void AppendVPrintf( const char* format, va_list args );
+	char* Extend( size_t numChars ); //Grows the length and returns where the new chars go, for callers that fill them in place.
+
+	void Reserve( size_t numChars ); //Room for numChars plus the terminator.
+	void Clear() { m_length = 0; m_chars[ 0 ] = '\0'; }
+
+	const char* GetCString() const { return m_chars; }
+	size_t GetLength() const { return m_length; }
+	bool IsEmpty() const { return m_length == 0; }
+	StringView GetView() const { return StringView( m_chars, m_length ); }
+	std::string ToString() const { return std::string( m_chars, m_length ); }
+
+
+private:
+	FormatBuffer( const FormatBuffer& );
+	void operator=( const FormatBuffer& );
+
+	char* m_chars;
+	size_t m_length;
+	size_t m_capacity; //Counting the terminator.
+	bool m_isOnHeap;
+	char m_emptyStorage; //So even a default buffer has somewhere to put its terminator.
+};
+
+
+//-----------------------------------------------------------------------------
+template< size_t NUM_INLINE_CHARS >
+class InlineFormatBuffer : public FormatBuffer
+{
+public:
+	InlineFormatBuffer() : FormatBuffer( m_inlineStorage, NUM_INLINE_CHARS ) {}
+
+
+private:
+	char m_inlineStorage[ NUM_INLINE_CHARS ];
+};
+
+
+//-----------------------------------------------------------------------------
+// One argument to AppendFormat with its type erased, so the formatting code is compiled once rather than per call site.
+// Pointers other than strings are deleted on purpose, as they'd otherwise silently print as bools.
+//-----------------------------------------------------------------------------
+struct FormatArg
+{
+	enum Type { TYPE_SIGNED, TYPE_UNSIGNED, TYPE_FLOATING, TYPE_CHAR, TYPE_BOOL, TYPE_STRING };
+
+	FormatArg( char value ) : m_type( TYPE_CHAR ), m_char( value ) {}
+	FormatArg( signed char value ) : m_type( TYPE_SIGNED ), m_numBytes( sizeof( value ) ), m_signed( value ) {}
+	FormatArg( unsigned char value ) : m_type( TYPE_UNSIGNED ), m_numBytes( sizeof( value ) ), m_unsigned( value ) {} //byte_t prints as a number, as %hhu did.
+	FormatArg( short value ) : m_type( TYPE_SIGNED ), m_numBytes( sizeof( value ) ), m_signed( value ) {}
+	FormatArg( unsigned short value ) : m_type( TYPE_UNSIGNED ), m_numBytes( sizeof( value ) ), m_unsigned( value ) {}
+	FormatArg( int value ) : m_type( TYPE_SIGNED ), m_numBytes( sizeof( value ) ), m_signed( value ) {}
+	FormatArg( unsigned int value ) : m_type( TYPE_UNSIGNED ), m_numBytes( sizeof( value ) ), m_unsigned( value ) {}
+	FormatArg( long value ) : m_type( TYPE_SIGNED ), m_numBytes( sizeof( value ) ), m_signed( value ) {}
+	FormatArg( unsigned long value ) : m_type( TYPE_UNSIGNED ), m_numBytes( sizeof( value ) ), m_unsigned( value ) {}
+	FormatArg( long long value ) : m_type( TYPE_SIGNED ), m_numBytes( sizeof( value ) ), m_signed( value ) {}
+	FormatArg( unsigned long long value ) : m_type( TYPE_UNSIGNED ), m_numBytes( sizeof( value ) ), m_unsigned( value ) {}
+	FormatArg( float value ) : m_type( TYPE_FLOATING ), m_floating( value ) {}
+	FormatArg( double value ) : m_type( TYPE_FLOATING ), m_floating( value ) {}
+	FormatArg( bool value ) : m_type( TYPE_BOOL ), m_bool( value ) {}
+	FormatArg( const char* value ) : m_type( TYPE_STRING ), m_chars( value ? value : "(null)" ), m_numChars( strlen( m_chars ) ) {}
+	FormatArg( const std::string& value ) : m_type( TYPE_STRING ), m_chars( value.c_str() ), m_numChars( value.size() ) {}
+	FormatArg( const StringView& value ) : m_type( TYPE_STRING ), m_chars( value.GetData() ), m_numChars( value.GetLength() ) {}
+	template< typename T > FormatArg( const T* value ) = delete;
+
+	Type m_type;
+	unsigned char m_numBytes; //Integers only: the argument's own width, so {:x} of a negative masks to it as %x does.
+	union
+	{
+		int64_t m_signed;
+		uint64_t m_unsigned;
+		double m_floating;
+		char m_char;
+		bool m_bool;
+	};
+	const char* m_chars;
+	size_t m_numChars;
+};
+
+
+//-----------------------------------------------------------------------------
+// Appends format with each {} replaced by the next argument, e.g. "{} hits {} for {} damage!". A spec after a colon,
+// in printf's order, can pad, align, set float precision, or ask for hex: {:5}, {:-12}, {:03}, {:.2}, {:x}, {:08X}.
+// {{ and }} are literal braces. Floats default to six places, as %f does, and every value prints as printf would.
+// Wrap literal formats in CHECKED_FORMAT to have the compiler match the {} count to the arguments.
+//-----------------------------------------------------------------------------
+void AppendFormatArgs( FormatBuffer& inout_buffer, const char* format, const FormatArg* args, int numArgs );
+void AppendInt( FormatBuffer& inout_buffer, int64_t value );
+void AppendUnsignedInt( FormatBuffer& inout_buffer, uint64_t value );
+void AppendFloat( FormatBuffer& inout_buffer, double value, int numDecimalPlaces = 6 ); //What "%.*f" prints.
+
+
+//-----------------------------------------------------------------------------
+inline void AppendFormat( FormatBuffer& inout_buffer, const char* format )
+{
+	AppendFormatArgs( inout_buffer, format, nullptr, 0 );
+}
+
+
+//-----------------------------------------------------------------------------
+template< typename... Args >
+inline void AppendFormat( FormatBuffer& inout_buffer, const char* format, const Args&... args )
+{
+	const FormatArg formatArgs[] = { FormatArg( args )... };
+	AppendFormatArgs( inout_buffer, format, formatArgs, sizeof...( Args ) );
+}
+
+
+//-----------------------------------------------------------------------------
+template< typename... Args > //For callers that keep a std::string anyway. Stringf's replacement, minus its 2048-char limit.
+inline std::string Format( const char* format, const Args&... args )
+{
+	InlineFormatBuffer< 256 > buffer;
+	AppendFormat( buffer, format, args... );
+	return buffer.ToString();
+}
+
+
+//-----------------------------------------------------------------------------
+StringView CopyToFrameMemory( const StringView& text ); //Null-terminated, in g_theFrameAllocator, so valid through the next frame. Main thread only: FrameAllocate gives other threads heap memory, which this never frees.
+
+
+//-----------------------------------------------------------------------------
+template< typename... Args > //For text drawn once and dropped, e.g. HUD readouts, so it never reaches the heap as a Stringf would.
+inline StringView FrameFormat( const char* format, const Args&... args )
+{
+	InlineFormatBuffer< 256 > buffer;
+	AppendFormat( buffer, format, args... );
+	return CopyToFrameMemory( buffer.GetView() );
+}
+
+
+//-----------------------------------------------------------------------------
+// Compile-time format checking. CountFormatPlaceholders walks a literal in a constant expression, giving -1 for an
+// unmatched brace or a spec AppendFormat can't read, so CHECKED_FORMAT can static_assert on it:
+//
+//     AppendFormat( buffer, CHECKED_FORMAT( "{} hits {} for {} damage!", instigatorName, targetName, damage ) );
+//-----------------------------------------------------------------------------
+constexpr int CountFormatPlaceholders( const char* format, int numFound = 0 );
+constexpr bool IsFormatSpecChar( char c )
+{
+	return ( c >= '0' && c <= '9' ) || c == '-' || c == '.' || c == 'x' || c == 'X' || c == 'f';
+}
+constexpr int CountFormatPlaceholdersInSpec( const char* spec, int numFound ) //From just past "{:" through its "}".
+{
+	return ( *spec == '}' ) ? CountFormatPlaceholders( spec + 1, numFound )
+		: IsFormatSpecChar( *spec ) ? CountFormatPlaceholdersInSpec( spec + 1, numFound )
+		: -1;
+}
+constexpr int CountFormatPlaceholders( const char* format, int numFound /*= 0*/ )
+{
+	return ( *format == '\0' ) ? numFound
+		: ( format[ 0 ] == '{' && format[ 1 ] == '{' ) ? CountFormatPlaceholders( format + 2, numFound )
+		: ( format[ 0 ] == '}' && format[ 1 ] == '}' ) ? CountFormatPlaceholders( format + 2, numFound )
+		: ( format[ 0 ] == '{' && format[ 1 ] == '}' ) ? CountFormatPlaceholders( format + 2, numFound + 1 )
+		: ( format[ 0 ] == '{' && format[ 1 ] == ':' ) ? CountFormatPlaceholdersInSpec( format + 2, numFound + 1 )
+		: ( format[ 0 ] == '{' || format[ 0 ] == '}' ) ? -1
+		: CountFormatPlaceholders( format + 1, numFound );
+}
+template< typename... Args > char ( &CountFormatArgs( const Args&... ) )[ sizeof...( Args ) ]; //Only ever inside sizeof.
+template< bool IS_FORMAT_VALID > inline int CheckFormat()
+{
+	static_assert( IS_FORMAT_VALID, "Format string is malformed or its {} count doesn't match its arguments." );
+	return 0;
+}
+#define CHECKED_FORMAT( format, ... ) ( CheckFormat< CountFormatPlaceholders( format ) == (int)sizeof( CountFormatArgs( __VA_ARGS__ ) ) >(), format ), __VA_ARGS__
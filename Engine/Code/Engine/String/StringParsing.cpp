@@ -0,0 +1,411 @@
+#include "Engine/String/StringParsing.hpp"
+
+#include <stdint.h>
+#include <stdlib.h>
+
+
+//--------------------------------------------------------------------------------------------------------------
+static const double s_EXACT_POWERS_OF_TEN[] = //Every power of ten a double holds exactly.
+{
+	1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+	1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22
+};
+static const int s_MAX_EXACT_POWER_OF_TEN = 22;
+static const uint64_t s_MAX_EXACT_MANTISSA = 1ull << 53;
+static const int s_MAX_MANTISSA_DIGITS = 19; //Still fits a uint64_t.
+
+
+//--------------------------------------------------------------------------------------------------------------
+static inline bool IsDigit( char c )
+{
+	return c >= '0' && c <= '9';
+}
+
+
+//--------------------------------------------------------------------------------------------------------------
+static inline bool ReadSign( const char*& cursor, const char* end ) //True for '-'.
+{
+	if ( cursor < end && ( *cursor == '-' || *cursor == '+' ) )
+		return *cursor++ == '-';
+	return false;
+}
+
+
+//--------------------------------------------------------------------------------------------------------------
+size_t ParseIntPrefix( const StringView& text, int& out_value )
+{
+	const char* cursor = text.begin();
+	const char* end = text.end();
+	bool isNegative = ReadSign( cursor, end );
+
+	const uint32_t maxMagnitude = isNegative ? 2147483648u : 2147483647u;
+	const char* digitsStart = cursor;
+	uint32_t magnitude = 0;
+	for ( ; cursor < end && IsDigit( *cursor ); ++cursor )
+	{
+		uint32_t digit = *cursor - '0';
+		if ( magnitude > ( maxMagnitude - digit ) / 10 )
+			return 0; //Overflow, which atoi leaves undefined.
+		magnitude = ( magnitude * 10 ) + digit;
+	}
+	if ( cursor == digitsStart )
+		return 0;
+
+	out_value = isNegative ? (int)( 0u - magnitude ) : (int)magnitude;
+	return cursor - text.begin();
+}
+
+
+//--------------------------------------------------------------------------------------------------------------
+static inline bool AccumulateMantissaDigit( char digit, uint64_t& inout_mantissa, int& inout_numSignificantDigits, bool& inout_didDropDigits ) //False if dropped.
+{
+	if ( inout_mantissa == 0 && digit == '0' )
+		return true; //Leading zeros aren't significant.
+
+	if ( inout_numSignificantDigits < s_MAX_MANTISSA_DIGITS )
+	{
+		inout_mantissa = ( inout_mantissa * 10 ) + ( digit - '0' );
+		++inout_numSignificantDigits;
+		return true;
+	}
+
+	inout_didDropDigits |= ( digit != '0' );
+	return false;
+}
+
+
+//--------------------------------------------------------------------------------------------------------------
+size_t ParseFloatPrefix( const StringView& text, float& out_value )
+{
+	const char* cursor = text.begin();
+	const char* end = text.end();
+	bool isNegative = ReadSign( cursor, end );
+
+	uint64_t mantissa = 0;
+	int numSignificantDigits = 0;
+	int decimalExponent = 0;
+	bool didDropDigits = false;
+	bool sawDigit = false;
+
+	for ( ; cursor < end && IsDigit( *cursor ); ++cursor )
+	{
+		sawDigit = true;
+		if ( !AccumulateMantissaDigit( *cursor, mantissa, numSignificantDigits, didDropDigits ) )
+			++decimalExponent;
+	}
+
+	if ( cursor < end && *cursor == '.' && ( sawDigit || ( cursor + 1 < end && IsDigit( cursor[ 1 ] ) ) ) )
+	{
+		for ( ++cursor; cursor < end && IsDigit( *cursor ); ++cursor )
+		{
+			sawDigit = true;
+			if ( AccumulateMantissaDigit( *cursor, mantissa, numSignificantDigits, didDropDigits ) )
+				--decimalExponent;
+		}
+	}
+
+	if ( !sawDigit )
+		return 0;
+
+	if ( cursor < end && ( *cursor == 'e' || *cursor == 'E' ) )
+	{
+		const char* exponentCursor = cursor + 1;
+		bool isExponentNegative = ReadSign( exponentCursor, end );
+		if ( exponentCursor < end && IsDigit( *exponentCursor ) ) //Else the 'e' isn't part of the number.
+		{
+			int exponent = 0;
+			for ( ; exponentCursor < end && IsDigit( *exponentCursor ); ++exponentCursor )
+				if ( exponent < 100000 ) //Far past any float's range already.
+					exponent = ( exponent * 10 ) + ( *exponentCursor - '0' );
+
+			decimalExponent += isExponentNegative ? -exponent : exponent;
+			cursor = exponentCursor;
+		}
+	}
+
+	size_t numCharsUsed = cursor - text.begin();
+
+	double value;
+	if ( mantissa == 0 )
+	{
+		value = 0.0;
+	}
+	else if ( !didDropDigits && mantissa <= s_MAX_EXACT_MANTISSA && decimalExponent >= -s_MAX_EXACT_POWER_OF_TEN && decimalExponent <= s_MAX_EXACT_POWER_OF_TEN )
+	{
+		//Both operands are exact, so the one rounding in the multiply or divide is the correct one.
+		value = ( decimalExponent < 0 ) ? ( mantissa / s_EXACT_POWERS_OF_TEN[ -decimalExponent ] ) : ( mantissa * s_EXACT_POWERS_OF_TEN[ decimalExponent ] );
+	}
+	else
+	{
+		//Past 19 digits or 1e22, which no data file holds: strtod gets it right, on a null-terminated copy without the sign.
+		const char* digitsStart = ( text[ 0 ] == '-' || text[ 0 ] == '+' ) ? text.begin() + 1 : text.begin();
+		std::string digits( digitsStart, cursor );
+		value = strtod( digits.c_str(), nullptr );
+	}
+
+	out_value = (float)( isNegative ? -value : value );
+	return numCharsUsed;
+}
+
+
+//--------------------------------------------------------------------------------------------------------------
+static inline void SkipWhitespace( const char*& cursor, const char* end )
+{
+	while ( cursor < end && StringView::IsWhitespace( *cursor ) )
+		++cursor;
+}
+
+
+//--------------------------------------------------------------------------------------------------------------
+static inline bool IsAtEnd( const char*& cursor, const char* end ) //Past any trailing whitespace.
+{
+	SkipWhitespace( cursor, end );
+	return cursor == end;
+}
+
+
+//--------------------------------------------------------------------------------------------------------------
+static bool ReadInt( const char*& cursor, const char* end, int& out_value )
+{
+	SkipWhitespace( cursor, end );
+	size_t numCharsUsed = ParseIntPrefix( StringView( cursor, end - cursor ), out_value );
+	cursor += numCharsUsed;
+	return numCharsUsed > 0;
+}
+
+
+//--------------------------------------------------------------------------------------------------------------
+static bool ReadFloat( const char*& cursor, const char* end, float& out_value )
+{
+	SkipWhitespace( cursor, end );
+	size_t numCharsUsed = ParseFloatPrefix( StringView( cursor, end - cursor ), out_value );
+	cursor += numCharsUsed;
+	return numCharsUsed > 0;
+}
+
+
+//--------------------------------------------------------------------------------------------------------------
+static bool ReadSeparator( const char*& cursor, const char* end, char separator )
+{
+	SkipWhitespace( cursor, end );
+	if ( cursor < end && *cursor == separator )
+	{
+		++cursor;
+		return true;
+	}
+	return false;
+}
+
+
+//--------------------------------------------------------------------------------------------------------------
+bool ParseInt( const StringView& text, int& out_value )
+{
+	const char* cursor = text.begin();
+	return ReadInt( cursor, text.end(), out_value ) && IsAtEnd( cursor, text.end() );
+}
+
+
+//--------------------------------------------------------------------------------------------------------------
+bool ParseFloat( const StringView& text, float& out_value )
+{
+	const char* cursor = text.begin();
+	return ReadFloat( cursor, text.end(), out_value ) && IsAtEnd( cursor, text.end() );
+}
+
+
+//--------------------------------------------------------------------------------------------------------------
+bool ParseVector2i( const StringView& text, Vector2i& out_value )
+{
+	const char* cursor = text.begin();
+	const char* end = text.end();
+	return ReadInt( cursor, end, out_value.x ) && ReadSeparator( cursor, end, ',' ) && ReadInt( cursor, end, out_value.y ) && IsAtEnd( cursor, end );
+}
+
+
+//--------------------------------------------------------------------------------------------------------------
+bool ParseVector2f( const StringView& text, Vector2f& out_value )
+{
+	const char* cursor = text.begin();
+	const char* end = text.end();
+	return ReadFloat( cursor, end, out_value.x ) && ReadSeparator( cursor, end, ',' ) && ReadFloat( cursor, end, out_value.y ) && IsAtEnd( cursor, end );
+}
+
+
+//--------------------------------------------------------------------------------------------------------------
+bool ParseRgba( const StringView& text, Rgba& out_value )
+{
+	const char* cursor = text.begin();
+	const char* end = text.end();
+	byte_t* channels[] = { &out_value.red, &out_value.green, &out_value.blue, &out_value.alphaOpacity };
+	const int numChannels = _countof( channels );
+
+	for ( int channelIndex = 0; channelIndex < numChannels; channelIndex++ )
+	{
+		if ( channelIndex > 0 )
+		{
+			if ( channelIndex == numChannels - 1 && IsAtEnd( cursor, end ) )
+				return true; //Alpha is optional.
+			ReadSeparator( cursor, end, ',' ); //Else whitespace alone separates them.
+		}
+
+		int channel;
+		if ( !ReadInt( cursor, end, channel ) || channel < 0 || channel > 255 )
+			return false;
+		*channels[ channelIndex ] = (byte_t)channel;
+	}
+
+	return IsAtEnd( cursor, end );
+}
+
+
+//--------------------------------------------------------------------------------------------------------------
+bool ParseIntRange( const StringView& text, Interval<int>& out_value )
+{
+	const char* cursor = text.begin();
+	const char* end = text.end();
+	if ( !ReadInt( cursor, end, out_value.minInclusive ) )
+		return false;
+
+	if ( IsAtEnd( cursor, end ) )
+	{
+		out_value.maxInclusive = out_value.minInclusive;
+		return true;
+	}
+
+	return ReadSeparator( cursor, end, '~' ) && ReadInt( cursor, end, out_value.maxInclusive ) && IsAtEnd( cursor, end );
+}
+
+
+//--------------------------------------------------------------------------------------------------------------
+bool ParseFloatRange( const StringView& text, Interval<float>& out_value )
+{
+	const char* cursor = text.begin();
+	const char* end = text.end();
+	if ( !ReadFloat( cursor, end, out_value.minInclusive ) )
+		return false;
+
+	if ( IsAtEnd( cursor, end ) )
+	{
+		out_value.maxInclusive = out_value.minInclusive;
+		return true;
+	}
+
+	return ReadSeparator( cursor, end, '~' ) && ReadFloat( cursor, end, out_value.maxInclusive ) && IsAtEnd( cursor, end );
+}
+
+
+//--------------------------------------------------------------------------------------------------------------
+StringTokenizer::StringTokenizer( const StringView& text, const char* delimiters /*= " \t\r\n"*/, bool shouldKeepEmptyTokens /*= false*/ )
+	: m_cursor( text.begin() )
+	, m_end( text.end() )
+	, m_delimiters( delimiters )
+	, m_singleDelimiter( ( delimiters[ 0 ] != '\0' && delimiters[ 1 ] == '\0' ) ? delimiters[ 0 ] : '\0' )
+	, m_shouldKeepEmptyTokens( shouldKeepEmptyTokens )
+	, m_isDone( false )
+{
+}
+
+
+//--------------------------------------------------------------------------------------------------------------
+bool StringTokenizer::Next( StringView& out_token )
+{
+	if ( m_isDone )
+		return false;
+
+	if ( !m_shouldKeepEmptyTokens )
+	{
+		while ( m_cursor < m_end && StringView::IsOneOf( *m_cursor, m_delimiters ) )
+			++m_cursor;
+
+		if ( m_cursor == m_end )
+		{
+			m_isDone = true;
+			return false;
+		}
+	}
+
+	const char* tokenStart = m_cursor;
+	if ( m_singleDelimiter != '\0' ) //memchr far outruns testing each char, e.g. when splitting lines.
+	{
+		const char* delimiter = (const char*)memchr( m_cursor, m_singleDelimiter, m_end - m_cursor );
+		m_cursor = ( delimiter != nullptr ) ? delimiter : m_end;
+	}
+	else
+	{
+		while ( m_cursor < m_end && !StringView::IsOneOf( *m_cursor, m_delimiters ) )
+			++m_cursor;
+	}
+	out_token = StringView( tokenStart, m_cursor - tokenStart );
+
+	if ( m_cursor < m_end )
+		++m_cursor; //Past the delimiter.
+	else
+		m_isDone = true;
+
+	return true;
+}
+
+
+//--------------------------------------------------------------------------------------------------------------
+void SetTypeFromStringView( int& out_value, const StringView& text )
+{
+	out_value = 0;
+	ParseInt( text, out_value ); //Any leading number stands, as with atoi.
+}
+
+
+//--------------------------------------------------------------------------------------------------------------
+void SetTypeFromStringView( float& out_value, const StringView& text )
+{
+	out_value = 0.f;
+	ParseFloat( text, out_value );
+}
+
+
+//--------------------------------------------------------------------------------------------------------------
+void SetTypeFromStringView( char& out_value, const StringView& text )
+{
+	out_value = text.IsEmpty() ? '\0' : text[ 0 ];
+}
+
+
+//--------------------------------------------------------------------------------------------------------------
+void SetTypeFromStringView( std::string& out_value, const StringView& text )
+{
+	out_value.assign( text.GetData(), text.GetLength() );
+}
+
+
+//--------------------------------------------------------------------------------------------------------------
+void SetTypeFromStringView( Vector2i& out_value, const StringView& text )
+{
+	ParseVector2i( text, out_value );
+}
+
+
+//--------------------------------------------------------------------------------------------------------------
+void SetTypeFromStringView( Vector2f& out_value, const StringView& text )
+{
+	ParseVector2f( text, out_value );
+}
+
+
+//--------------------------------------------------------------------------------------------------------------
+void SetTypeFromStringView( Rgba& out_value, const StringView& text )
+{
+	ParseRgba( text, out_value );
+}
+
+
+//--------------------------------------------------------------------------------------------------------------
+void SetTypeFromStringView( Interval<int>& out_value, const StringView& text )
+{
+	ParseIntRange( text, out_value );
+}
+
+
+//--------------------------------------------------------------------------------------------------------------
+void SetTypeFromStringView( Interval<float>& out_value, const StringView& text )
+{
+	ParseFloatRange( text, out_value );
+}
@@ -0,0 +1,81 @@
+#pragma once
+
+
+#include "Engine/Math/Interval.hpp"
+#include "Engine/Math/Vector2.hpp"
+#include "Engine/Renderer/Rgba.hpp"
+#include "Engine/String/StringUtils.hpp"
+#include "Engine/String/StringView.hpp"
+
+
+//-----------------------------------------------------------------------------
+// Number parsing in the manner of C++17's from_chars: no locale, no null terminator needed, no leading whitespace
+// skipped, and no allocation. Each reads the number at the very start of text and returns the chars it used,
+// or 0 with out_value untouched when there's no number there or an int would overflow.
+//-----------------------------------------------------------------------------
+size_t ParseIntPrefix( const StringView& text, int& out_value ); //Optional sign, then decimal digits.
+size_t ParseFloatPrefix( const StringView& text, float& out_value ); //Optional sign, digits with an optional '.', optional exponent, e.g. ".5" or "-2e3".
+
+
+//-----------------------------------------------------------------------------
+// Whole-text parsers: whitespace around the value is fine, anything else fails.
+// Each field is written as soon as it parses, so on failure out_value holds whatever came before the problem.
+//-----------------------------------------------------------------------------
+bool ParseInt( const StringView& text, int& out_value );
+bool ParseFloat( const StringView& text, float& out_value );
+bool ParseVector2i( const StringView& text, Vector2i& out_value ); //"x,y", as Vector2i::ToString writes.
+bool ParseVector2f( const StringView& text, Vector2f& out_value );
+bool ParseRgba( const StringView& text, Rgba& out_value ); //"r,g,b" or "r,g,b,a" in 0-255, commas or spaces between. No alpha keeps out_value's.
+bool ParseIntRange( const StringView& text, Interval<int>& out_value ); //"min~max", or one number for both.
+bool ParseFloatRange( const StringView& text, Interval<float>& out_value );
+
+
+//-----------------------------------------------------------------------------
+// Hands out each token of a view as a view into it, so splitting never allocates, unlike SplitString.
+// By default tokens are runs of non-whitespace. With shouldKeepEmptyTokens, every delimiter ends a token,
+// so "a,,b" gives "a", "", "b", and "" gives one empty token, as SplitString does.
+//
+//     StringView token;
+//     for ( StringTokenizer tokens( argsString ); tokens.Next( token ); )
+//-----------------------------------------------------------------------------
+class StringTokenizer
+{
+public:
+	StringTokenizer( const StringView& text, const char* delimiters = " \t\r\n", bool shouldKeepEmptyTokens = false );
+
+	bool Next( StringView& out_token );
+	StringView GetRemaining() const { return StringView( m_cursor, m_end - m_cursor ); } //Right after the last token's delimiter.
+
+
+private:
+	const char* m_cursor;
+	const char* m_end;
+	const char* m_delimiters;
+	char m_singleDelimiter; //'\0' unless m_delimiters holds just one.
+	bool m_shouldKeepEmptyTokens;
+	bool m_isDone;
+};
+
+
+//-----------------------------------------------------------------------------
+// Typed conversion straight from a view, giving what SetTypeFromUnwrappedString gives for the same text as a
+// std::string, e.g. atoi's rules for ints (trailing junk ignored, 0 if no number), minus the string.
+// Compound types keep out_value's fields that don't parse, so callers start it at their default.
+//-----------------------------------------------------------------------------
+void SetTypeFromStringView( int& out_value, const StringView& text );
+void SetTypeFromStringView( float& out_value, const StringView& text );
+void SetTypeFromStringView( char& out_value, const StringView& text );
+void SetTypeFromStringView( std::string& out_value, const StringView& text );
+void SetTypeFromStringView( Vector2i& out_value, const StringView& text );
+void SetTypeFromStringView( Vector2f& out_value, const StringView& text );
+void SetTypeFromStringView( Rgba& out_value, const StringView& text );
+void SetTypeFromStringView( Interval<int>& out_value, const StringView& text );
+void SetTypeFromStringView( Interval<float>& out_value, const StringView& text );
+
+
+//-----------------------------------------------------------------------------
+template< typename ValueType > //Anything else still goes through its string constructor.
+inline void SetTypeFromStringView( ValueType& out_value, const StringView& text )
+{
+	SetTypeFromUnwrappedString( out_value, text.ToString() );
+}
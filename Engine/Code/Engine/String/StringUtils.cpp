@@ -2,6 +2,7 @@
 
 #include "Engine/EngineCommon.hpp"
 #include "Engine/String/StringUtils.hpp"
+#include "Engine/String/StringFormat.hpp"
 #include <stdarg.h>
 
 
@@ -12,14 +13,13 @@ const int STRINGF_STACK_LOCAL_TEMP_LENGTH = 2048;
 //-----------------------------------------------------------------------------------------------
 const std::string Stringf( const char* format, ... )
 {
-	char textLiteral[ STRINGF_STACK_LOCAL_TEMP_LENGTH ];
+	InlineFormatBuffer< STRINGF_STACK_LOCAL_TEMP_LENGTH > textLiteral; //Spills to the heap past the stack array, rather than truncating.
 	va_list variableArgumentList;
 	va_start( variableArgumentList, format );
-	vsnprintf_s( textLiteral, STRINGF_STACK_LOCAL_TEMP_LENGTH, _TRUNCATE, format, variableArgumentList );	
+	textLiteral.AppendVPrintf( format, variableArgumentList );
 	va_end( variableArgumentList );
-	textLiteral[ STRINGF_STACK_LOCAL_TEMP_LENGTH - 1 ] = '\0'; // In case vsnprintf overran (doesn't auto-terminate)
 
-	return std::string( textLiteral );
+	return textLiteral.ToString();
 }
 
 
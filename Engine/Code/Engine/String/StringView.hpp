@@ -0,0 +1,77 @@
+#pragma once
+
+
+#include <string>
+#include <string.h>
+
+
+//-----------------------------------------------------------------------------
+// A non-owning window onto chars that live elsewhere, e.g. a mapped file, so slicing one never allocates.
+// Not null-terminated: pass GetData() to C functions only alongside GetLength().
+//-----------------------------------------------------------------------------
+class StringView
+{
+public:
+	StringView() : m_data( "" ), m_length( 0 ) {}
+	StringView( const char* data, size_t length ) : m_data( data ), m_length( length ) {}
+	StringView( const char* cString ) : m_data( cString ), m_length( strlen( cString ) ) {}
+	StringView( const std::string& str ) : m_data( str.c_str() ), m_length( str.size() ) {} //Only until str changes.
+
+	const char* GetData() const { return m_data; }
+	size_t GetLength() const { return m_length; }
+	bool IsEmpty() const { return m_length == 0; }
+	const char* begin() const { return m_data; }
+	const char* end() const { return m_data + m_length; }
+	char operator[]( size_t index ) const { return m_data[ index ]; }
+
+	bool operator==( const StringView& other ) const { return ( m_length == other.m_length ) && ( memcmp( m_data, other.m_data, m_length ) == 0 ); }
+	bool operator!=( const StringView& other ) const { return !( *this == other ); }
+	bool StartsWith( const StringView& prefix ) const { return ( prefix.m_length <= m_length ) && ( memcmp( m_data, prefix.m_data, prefix.m_length ) == 0 ); }
+
+	size_t Find( char c, size_t startIndex = 0 ) const
+	{
+		for ( size_t index = startIndex; index < m_length; index++ )
+			if ( m_data[ index ] == c )
+				return index;
+		return npos;
+	}
+	StringView GetSubstring( size_t startIndex, size_t length = npos ) const //Clamped to this view.
+	{
+		if ( startIndex > m_length )
+			startIndex = m_length;
+		if ( length > m_length - startIndex )
+			length = m_length - startIndex;
+		return StringView( m_data + startIndex, length );
+	}
+	StringView GetTrimmed() const //Without leading or trailing spaces, tabs, or newlines.
+	{
+		size_t startIndex = 0;
+		size_t endIndex = m_length;
+		while ( startIndex < endIndex && IsWhitespace( m_data[ startIndex ] ) )
+			++startIndex;
+		while ( endIndex > startIndex && IsWhitespace( m_data[ endIndex - 1 ] ) )
+			--endIndex;
+		return StringView( m_data + startIndex, endIndex - startIndex );
+	}
+	StringView GetTrimmed( const char* charsToTrim ) const //e.g. "\t\r" for rows whose spaces matter.
+	{
+		size_t startIndex = 0;
+		size_t endIndex = m_length;
+		while ( startIndex < endIndex && IsOneOf( m_data[ startIndex ], charsToTrim ) )
+			++startIndex;
+		while ( endIndex > startIndex && IsOneOf( m_data[ endIndex - 1 ], charsToTrim ) )
+			--endIndex;
+		return StringView( m_data + startIndex, endIndex - startIndex );
+	}
+
+	std::string ToString() const { return std::string( m_data, m_length ); }
+	static bool IsWhitespace( char c ) { return c == ' ' || c == '\t' || c == '\n' || c == '\r'; }
+	static bool IsOneOf( char c, const char* chars ) { return c != '\0' && strchr( chars, c ) != nullptr; } //strchr alone matches '\0'.
+
+	static const size_t npos = (size_t)-1;
+
+
+private:
+	const char* m_data;
+	size_t m_length;
+};
@@ -8,12 +8,21 @@
 #include "Game/TheGame.hpp"
 
 //Major Utils
+#include "Engine/Jobs/JobSystem.hpp"
+#include "Engine/Memory/AllocationTracker.hpp"
+#include "Engine/Memory/FrameAllocator.hpp"
+#include "Engine/Metrics/Metrics.hpp"
+#include "Engine/Time/FrameClock.hpp"
+#include "Engine/Time/FrameProfiler.hpp"
 #include "Engine/Time/Time.hpp"
+#include "Engine/Time/Profiler.hpp"
 #include "Engine/Tools/FBXUtils.hpp"
 
 
 //--------------------------------------------------------------------------------------------------------------
 TheEngine* g_theEngine = nullptr;
+static MetricID s_frameSecondsMetric = INVALID_METRIC_ID;
+static MetricID s_frameWorkSecondsMetric = INVALID_METRIC_ID;
 
 
 //--------------------------------------------------------------------------------------------------------------
@@ -38,6 +47,25 @@ static void RegisterConsoleCommands()
 	//AES A5
 	g_theConsole->RegisterCommand( "AnimationLoadFromFile", AnimationLoadFromFile );
 	g_theConsole->RegisterCommand( "AnimationSaveLastAnimationMade", AnimationSaveLastAnimationMade );
+
+	//Profiling
+	g_theConsole->RegisterCommand( "ProfilerStart", ProfilerStart );
+	g_theConsole->RegisterCommand( "ProfilerStop", ProfilerStop );
+	g_theConsole->RegisterCommand( "ProfilerOverlay", ProfilerOverlay );
+	g_theConsole->RegisterCommand( "ProfilerOverlayExport", ProfilerOverlayExport );
+	g_theConsole->RegisterCommand( "FrameMemory", FrameMemory );
+	g_theConsole->RegisterCommand( "MemTrackStart", MemTrackStart );
+	g_theConsole->RegisterCommand( "MemTrackStop", MemTrackStop );
+	g_theConsole->RegisterCommand( "MemTrackReport", MemTrackReport );
+	g_theConsole->RegisterCommand( "MemTrackSnapshot", MemTrackSnapshot );
+	g_theConsole->RegisterCommand( "MemTrackDiff", MemTrackDiff );
+	g_theConsole->RegisterCommand( "JobStats", JobStats );
+	g_theConsole->RegisterCommand( "Metrics", MetricsPrint );
+	g_theConsole->RegisterCommand( "MetricsStream", MetricsStream );
+	g_theConsole->RegisterCommand( "MetricsExport", MetricsExport );
+	g_theConsole->RegisterCommand( "FrameStats", FrameStats );
+	g_theConsole->RegisterCommand( "FrameLimit", FrameLimit );
+	g_theConsole->RegisterCommand( "FixedStep", FixedStep );
 }
 
 
@@ -48,6 +76,11 @@ void TheEngine::Startup( double screenWidth, double screenHeight )
 	//	Allocation/Constructor Calls
 	//-----------------------------------------------------------------------------
 
+	g_theFrameAllocator = new FrameAllocator(); //Before anything that might draw from it, even during startup.
+	g_theJobSystem = new JobSystem(); //Here on the main thread, which becomes its thread 0.
+	s_frameSecondsMetric = Metrics::RegisterHistogram( "engine.frame_seconds" );
+	s_frameWorkSecondsMetric = Metrics::RegisterHistogram( "engine.frame_work_seconds" );
+
 	//Make sure Renderer ctor comes first so that default texture gets ID of 1. Args configure FBO dimensions.
 	g_theRenderer = new TheRenderer( screenWidth, screenHeight );
 	g_theDebugRenderCommands = new std::list< DebugRenderCommand* >();
@@ -73,6 +106,7 @@ void TheEngine::Startup( double screenWidth, double screenHeight )
 	//-----------------------------------------------------------------------------
 
 	SeedWindowsRNG();
+	g_theFrameClock = new FrameClock(); //Last, so the first frame's delta doesn't include startup.
 
 	g_theRenderer->PreGameStartup();
 	g_theGame->Startup();
@@ -83,11 +117,18 @@ void TheEngine::Startup( double screenWidth, double screenHeight )
 //--------------------------------------------------------------------------------------------------------------
 void TheEngine::RunFrame()
 {
+	FrameProfiler::BeginFrame(); //First, so the last frame's total includes TheApp's FlipAndPresent.
+	g_theFrameAllocator->BeginFrame(); //Frees whatever the frame before last left in it.
 
 	g_theAudio->Update();
 	//	if ( g_theInput->WasKeyPressedOnce( 'X' ) ) g_theAudio->StopChannel( g_bgMusicChannel );
 
-	this->Update( CalcDeltaSeconds() );
+	g_theFrameClock->BeginFrame(); //Waits out the frame limit.
+	Metrics::RecordSeconds( s_frameSecondsMetric, g_theFrameClock->GetLastFrameSeconds() );
+	Metrics::RecordSeconds( s_frameWorkSecondsMetric, g_theFrameClock->GetLastWorkSeconds() );
+	Metrics::Update(); //Merges, and streams to the console, at most once a second.
+
+	this->Update( g_theFrameClock->GetDeltaSeconds() );
 
 	this->Render();
 }
@@ -96,6 +137,8 @@ void TheEngine::RunFrame()
 //--------------------------------------------------------------------------------------------------------------
 void TheEngine::Update( float deltaSeconds )
 {
+	PROFILE_SCOPE( "TheEngine::Update" );
+
 	if ( g_theInput->WasKeyPressedOnce( KEY_TO_TOGGLE_DEBUG_INFO ) ) 
 		g_inDebugMode = !g_inDebugMode;
 
@@ -105,12 +148,39 @@ void TheEngine::Update( float deltaSeconds )
 		//Update uniforms for shader timers, scene MVP, and lights.
 
 	ROADMAP( "Explore passing in 0 to freeze, or other values to rewind, slow, etc." );
-	g_theGame->Update( deltaSeconds );
+	if ( g_theFrameClock->IsFixedStep() )
+		UpdateGameInFixedSteps();
+	else
+	{
+		g_theInput->RestoreHeldKeyEdges(); //In case fixed steps were just turned off.
+		g_theGame->Update( deltaSeconds );
+	}
 
 	UpdateDebugCommands( deltaSeconds );
 }
 
 
+//--------------------------------------------------------------------------------------------------------------
+void TheEngine::UpdateGameInFixedSteps()
+{
+	//A press has to reach exactly one step: the first that runs, or the next frame's if none runs this frame.
+	while ( g_theFrameClock->StepFixed() )
+	{
+		bool isFirstStep = ( g_theFrameClock->GetNumStepsThisFrame() == 1 );
+		if ( isFirstStep )
+			g_theInput->RestoreHeldKeyEdges();
+
+		g_theGame->Update( g_theFrameClock->GetFixedStepSeconds() );
+
+		if ( isFirstStep )
+			g_theInput->ClearKeyEdges();
+	}
+
+	if ( g_theFrameClock->GetNumStepsThisFrame() == 0 )
+		g_theInput->HoldKeyEdges();
+}
+
+
 //--------------------------------------------------------------------------------------------------------------
 void TheEngine::RenderDebug3D()
 {
@@ -130,9 +200,39 @@ void TheEngine::RenderDebug2D()
 }
 
 
+//--------------------------------------------------------------------------------------------------------------
+void TheEngine::RenderProfilerOverlay()
+{
+	const float LINE_HEIGHT = 12.f;
+	const float CHAR_ASPECT = .75f;
+	const Vector2f TOP_LEFT( 10.f, 890.f ); //SetupView2D's ortho is 1600x900, up is +y.
+
+	std::vector< std::string > lines;
+	FrameProfiler::GetReportLines( lines );
+
+	size_t longestLineChars = 0;
+	for ( const std::string& line : lines )
+		longestLineChars = ( line.size() > longestLineChars ) ? line.size() : longestLineChars;
+
+	Rgba bgColor = Rgba::BLACK;
+	bgColor.alphaOpacity = 172;
+	g_theRenderer->SetBlendFunc( 0x0302, 0x0303 ); //GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA, as TheConsole does.
+	g_theRenderer->DrawAABB( TheRenderer::AS_QUADS, AABB2f( TOP_LEFT.x - 4.f, TOP_LEFT.y - ( LINE_HEIGHT * lines.size() ) - 4.f,
+		TOP_LEFT.x + ( LINE_HEIGHT * CHAR_ASPECT * longestLineChars ) + 4.f, TOP_LEFT.y + 4.f ), bgColor );
+
+	for ( size_t lineIndex = 0; lineIndex < lines.size(); lineIndex++ )
+	{
+		Vector2f lineBottomLeft( TOP_LEFT.x, TOP_LEFT.y - ( LINE_HEIGHT * ( lineIndex + 1 ) ) );
+		g_theRenderer->DrawTextMonospaced2D( lineBottomLeft, lines[ lineIndex ], LINE_HEIGHT, ( lineIndex == 0 ) ? Rgba::CYAN : Rgba::WHITE, nullptr, CHAR_ASPECT, false );
+	}
+}
+
+
 //--------------------------------------------------------------------------------------------------------------
 void TheEngine::Render()
 {
+	PROFILE_SCOPE( "TheEngine::Render" );
+
 	g_theRenderer->PreRenderStep();
 
 	//-----------------------------------------------------------------------------
@@ -151,6 +251,9 @@ void TheEngine::Render()
 	//-----------------------------------------------------------------------------
 	g_theRenderer->PostRenderStep();
 
+	if ( FrameProfiler::IsEnabled() )
+		this->RenderProfilerOverlay();
+
 	g_theConsole->Render();
 
 	//Main_Win32 should call TheApp's FlipAndPresent() next.
@@ -166,17 +269,30 @@ void TheEngine::Shutdown()
 
 	//-----------------------------------------------------------------------------
 	delete g_theGame;
+	delete g_theJobSystem; //After TheGame, so nothing it queued is left running.
 	delete g_theInput;
 	delete g_theRenderer;
 	delete g_theDebugRenderCommands;
 	delete g_theConsole;
+	delete g_theFrameAllocator;
+	delete g_theFrameClock;
 
 	//-----------------------------------------------------------------------------
 	g_theGame = nullptr;
+	g_theJobSystem = nullptr;
 	g_theInput = nullptr;
 	g_theRenderer = nullptr;
 	g_theDebugRenderCommands = nullptr;
 	g_theConsole = nullptr;
+	g_theFrameAllocator = nullptr;
+	g_theFrameClock = nullptr;
+
+	//-----------------------------------------------------------------------------
+	if ( AllocationTracker::IsTracking() ) //Every subsystem is gone, so whatever's still live leaked.
+	{
+		AllocationTracker::WriteLiveReportToFile( AllocationTracker::s_SHUTDOWN_REPORT_FILENAME );
+		AllocationTracker::StopTracking();
+	}
 }
 
 
@@ -13,9 +13,11 @@ public:
 private:
 	void Render();
 	void Update( float deltaSeconds );
+	void UpdateGameInFixedSteps();
 
 	void RenderDebug3D();
 	void RenderDebug2D();
+	void RenderProfilerOverlay();
 };
 
 
@@ -0,0 +1,238 @@
+#include "Engine/Time/FrameClock.hpp"
+#include "Engine/Time/Time.hpp"
+#include "Engine/Time/Profiler.hpp"
+#include "Engine/Core/Command.hpp"
+#include "Engine/Core/TheConsole.hpp"
+#include "Engine/EngineCommon.hpp"
+
+#include <algorithm>
+#include <math.h>
+
+
+#define WIN32_LEAN_AND_MEAN
+#include <Windows.h>
+#include <mmsystem.h>
+#pragma comment( lib, "winmm" ) //timeBeginPeriod, so Sleep( 1 ) sleeps about 1ms instead of a whole 15.6ms tick.
+
+
+//--------------------------------------------------------------------------------------------------------------
+FrameClock* g_theFrameClock = nullptr;
+
+STATIC const float FrameClock::s_DEFAULT_FRAME_LIMIT = 60.f; //What CalcDeltaSeconds used to spin to.
+STATIC const float FrameClock::s_MAX_DELTA_SECONDS = 1.f;
+STATIC const unsigned int FrameClock::s_MAX_STEPS_PER_FRAME = 8;
+STATIC const unsigned int FrameClock::s_NUM_TRACKED_FRAMES;
+static const double SLEEP_MARGIN_SECONDS = 0.002; //Sleep( 1 ) can overshoot by this much, so yield for the last bit.
+static const float SMOOTHING_WEIGHT = 0.1f; //Of the newest delta, per frame.
+
+
+//--------------------------------------------------------------------------------------------------------------
+FrameClock::FrameClock()
+	: m_frameBeganTicks( GetCurrentTimeTicks() )
+	, m_frameNumber( 0 )
+	, m_deltaSeconds( 0.f )
+	, m_smoothedDeltaSeconds( 0.f )
+	, m_lastFrameSeconds( 0.0 )
+	, m_lastWorkSeconds( 0.0 )
+	, m_frameLimit( s_DEFAULT_FRAME_LIMIT )
+	, m_fixedStepSeconds( 0.0 )
+	, m_accumulatedSeconds( 0.0 )
+	, m_numStepsThisFrame( 0 )
+	, m_numStepsDropped( 0 )
+{
+	timeBeginPeriod( 1 );
+	for ( unsigned int frameIndex = 0; frameIndex < s_NUM_TRACKED_FRAMES; frameIndex++ )
+		m_frameSecondsHistory[ frameIndex ] = m_workSecondsHistory[ frameIndex ] = 0.f;
+}
+
+
+//--------------------------------------------------------------------------------------------------------------
+FrameClock::~FrameClock()
+{
+	timeEndPeriod( 1 );
+}
+
+
+//--------------------------------------------------------------------------------------------------------------
+void FrameClock::BeginFrame()
+{
+	m_lastWorkSeconds = ConvertTicksToSeconds( GetCurrentTimeTicks() - m_frameBeganTicks );
+
+	if ( m_frameLimit > 0.f )
+		WaitForFrameLimit();
+
+	uint64_t nowTicks = GetCurrentTimeTicks();
+	m_lastFrameSeconds = ConvertTicksToSeconds( nowTicks - m_frameBeganTicks );
+	m_frameBeganTicks = nowTicks;
+
+	unsigned int historyIndex = static_cast<unsigned int>( m_frameNumber % s_NUM_TRACKED_FRAMES );
+	m_frameSecondsHistory[ historyIndex ] = static_cast<float>( m_lastFrameSeconds );
+	m_workSecondsHistory[ historyIndex ] = static_cast<float>( m_lastWorkSeconds );
+
+	m_deltaSeconds = static_cast<float>( m_lastFrameSeconds < s_MAX_DELTA_SECONDS ? m_lastFrameSeconds : s_MAX_DELTA_SECONDS );
+	if ( m_frameNumber == 0 )
+		m_smoothedDeltaSeconds = m_deltaSeconds;
+	else
+		m_smoothedDeltaSeconds += ( m_deltaSeconds - m_smoothedDeltaSeconds ) * SMOOTHING_WEIGHT;
+
+	if ( IsFixedStep() )
+		m_accumulatedSeconds += m_deltaSeconds;
+	m_numStepsThisFrame = 0;
+
+	++m_frameNumber;
+}
+
+
+//--------------------------------------------------------------------------------------------------------------
+void FrameClock::WaitForFrameLimit()
+{
+	PROFILE_SCOPE( "FrameClock::WaitForFrameLimit" );
+
+	double targetSeconds = 1.0 / m_frameLimit;
+	for ( ;; )
+	{
+		double remainingSeconds = targetSeconds - ConvertTicksToSeconds( GetCurrentTimeTicks() - m_frameBeganTicks );
+		if ( remainingSeconds <= 0.0 )
+			return;
+
+		if ( remainingSeconds > SLEEP_MARGIN_SECONDS )
+			Sleep( 1 ); //Gives the core back, unlike spinning.
+		else
+			Sleep( 0 ); //Just yields, to land close to the target.
+	}
+}
+
+
+//--------------------------------------------------------------------------------------------------------------
+void FrameClock::SetFrameLimit( float framesPerSecond )
+{
+	m_frameLimit = ( framesPerSecond > 0.f ) ? framesPerSecond : 0.f;
+}
+
+
+//--------------------------------------------------------------------------------------------------------------
+void FrameClock::SetFixedStepRate( float stepsPerSecond )
+{
+	m_fixedStepSeconds = ( stepsPerSecond > 0.f ) ? ( 1.0 / stepsPerSecond ) : 0.0;
+	m_accumulatedSeconds = 0.0;
+}
+
+
+//--------------------------------------------------------------------------------------------------------------
+bool FrameClock::StepFixed()
+{
+	if ( !IsFixedStep() || m_accumulatedSeconds < m_fixedStepSeconds )
+		return false;
+
+	if ( m_numStepsThisFrame >= s_MAX_STEPS_PER_FRAME )
+	{
+		//Falling behind: catching up would make this frame longer still, so the sim slows down instead.
+		double numBehind = floor( m_accumulatedSeconds / m_fixedStepSeconds );
+		m_numStepsDropped += static_cast<uint64_t>( numBehind );
+		m_accumulatedSeconds -= numBehind * m_fixedStepSeconds;
+		return false;
+	}
+
+	m_accumulatedSeconds -= m_fixedStepSeconds;
+	++m_numStepsThisFrame;
+	return true;
+}
+
+
+//--------------------------------------------------------------------------------------------------------------
+float FrameClock::GetInterpolationAlpha() const
+{
+	if ( !IsFixedStep() )
+		return 1.f; //The state is always the current one.
+
+	return static_cast<float>( m_accumulatedSeconds / m_fixedStepSeconds );
+}
+
+
+//--------------------------------------------------------------------------------------------------------------
+unsigned int FrameClock::GetNumTrackedFrames() const
+{
+	return ( m_frameNumber < s_NUM_TRACKED_FRAMES ) ? static_cast<unsigned int>( m_frameNumber ) : s_NUM_TRACKED_FRAMES;
+}
+
+
+//--------------------------------------------------------------------------------------------------------------
+float FrameClock::GetFrameTimePercentileMs( float percentile ) const
+{
+	return CalcPercentileMs( m_frameSecondsHistory, GetNumTrackedFrames(), percentile );
+}
+
+
+//--------------------------------------------------------------------------------------------------------------
+float FrameClock::GetWorkTimePercentileMs( float percentile ) const
+{
+	return CalcPercentileMs( m_workSecondsHistory, GetNumTrackedFrames(), percentile );
+}
+
+
+//--------------------------------------------------------------------------------------------------------------
+STATIC float FrameClock::CalcPercentileMs( const float* secondsHistory, unsigned int numTracked, float percentile )
+{
+	if ( numTracked == 0 )
+		return 0.f;
+
+	float sortedSeconds[ s_NUM_TRACKED_FRAMES ]; //A copy, since the history stays in frame order.
+	std::copy( secondsHistory, secondsHistory + numTracked, sortedSeconds );
+
+	float clampedPercentile = ( percentile < 0.f ) ? 0.f : ( ( percentile > 100.f ) ? 100.f : percentile );
+	unsigned int rankIndex = static_cast<unsigned int>( ( clampedPercentile / 100.f ) * ( numTracked - 1 ) + 0.5f );
+	std::nth_element( sortedSeconds, sortedSeconds + rankIndex, sortedSeconds + numTracked );
+	return sortedSeconds[ rankIndex ] * 1000.f;
+}
+
+
+//--------------------------------------------------------------------------------------------------------------
+void FrameStats( Command& /*args*/ )
+{
+	const FrameClock& clock = *g_theFrameClock;
+	float p50Ms = clock.GetFrameTimePercentileMs( 50.f );
+	g_theConsole->Printf( "Last %u frames: p50 %.2fms (%.1f FPS), p99 %.2fms, max %.2fms. Work p50 %.2fms, p99 %.2fms.",
+		clock.GetNumTrackedFrames(), p50Ms, ( p50Ms > 0.f ) ? 1000.f / p50Ms : 0.f,
+		clock.GetFrameTimePercentileMs( 99.f ), clock.GetFrameTimePercentileMs( 100.f ),
+		clock.GetWorkTimePercentileMs( 50.f ), clock.GetWorkTimePercentileMs( 99.f ) );
+
+	if ( clock.GetFrameLimit() > 0.f )
+		g_theConsole->Printf( "Frame limit %.1f FPS.", clock.GetFrameLimit() );
+	else
+		g_theConsole->Printf( "No frame limit." );
+
+	g_theConsole->Printf( "Smoothed delta %.2fms, last frame %.2fms.", clock.GetSmoothedDeltaSeconds() * 1000.f, clock.GetLastFrameSeconds() * 1000.0 );
+
+	if ( clock.IsFixedStep() )
+		g_theConsole->Printf( "Fixed step of %.2fms, %llu steps dropped so far.", clock.GetFixedStepSeconds() * 1000.f, clock.GetNumStepsDropped() );
+	else
+		g_theConsole->Printf( "Variable step, one update per frame." );
+}
+
+
+//--------------------------------------------------------------------------------------------------------------
+void FrameLimit( Command& args )
+{
+	float framesPerSecond;
+	args.GetNextFloat( &framesPerSecond, FrameClock::s_DEFAULT_FRAME_LIMIT );
+
+	g_theFrameClock->SetFrameLimit( framesPerSecond );
+	if ( framesPerSecond > 0.f )
+		g_theConsole->Printf( "Frame limit set to %.1f FPS. Usage: FrameLimit [framesPerSecond], 0 for unlimited.", framesPerSecond );
+	else
+		g_theConsole->Printf( "Frame limit removed." );
+}
+
+
+//--------------------------------------------------------------------------------------------------------------
+void FixedStep( Command& args )
+{
+	float stepsPerSecond;
+	args.GetNextFloat( &stepsPerSecond, 0.f );
+
+	g_theFrameClock->SetFixedStepRate( stepsPerSecond );
+	if ( stepsPerSecond > 0.f )
+		g_theConsole->Printf( "Game now updates %.1f times a second. Usage: FixedStep [stepsPerSecond], 0 for variable.", stepsPerSecond );
+	else
+		g_theConsole->Printf( "Game now updates once a frame by its delta." );
+}
@@ -0,0 +1,84 @@
+#pragma once
+
+
+#include <stdint.h>
+
+
+//-----------------------------------------------------------------------------
+class Command;
+class FrameClock;
+
+
+//-----------------------------------------------------------------------------
+extern FrameClock* g_theFrameClock;
+
+
+//-----------------------------------------------------------------------------
+// Paces and measures the main loop. BeginFrame waits out the frame limit, if any, then takes the frame's delta
+// from the tick counter. In fixed-step mode the delta goes into an accumulator instead, and the game updates
+// once per StepFixed() that returns true, always by GetFixedStepSeconds(), however fast frames render.
+// GetInterpolationAlpha() is for rendering that blends between the last two steps, which the game doesn't do yet.
+//-----------------------------------------------------------------------------
+class FrameClock
+{
+public:
+	FrameClock();
+	~FrameClock();
+
+	void BeginFrame(); //Once a frame, before any update.
+	float GetDeltaSeconds() const { return m_deltaSeconds; } //Clamped to s_MAX_DELTA_SECONDS, so a breakpoint doesn't lurch the sim.
+	float GetSmoothedDeltaSeconds() const { return m_smoothedDeltaSeconds; }
+	double GetLastFrameSeconds() const { return m_lastFrameSeconds; } //Unclamped, including any wait for the limit.
+	double GetLastWorkSeconds() const { return m_lastWorkSeconds; } //Just the frame's updating and rendering.
+	uint64_t GetFrameNumber() const { return m_frameNumber; }
+
+	void SetFrameLimit( float framesPerSecond ); //0 to run unlimited.
+	float GetFrameLimit() const { return m_frameLimit; }
+
+	void SetFixedStepRate( float stepsPerSecond ); //0 to return to one variable update per frame.
+	bool IsFixedStep() const { return m_fixedStepSeconds > 0.0; }
+	float GetFixedStepSeconds() const { return static_cast<float>( m_fixedStepSeconds ); }
+	bool StepFixed(); //Loop on it: each true takes one step's worth from the accumulator.
+	unsigned int GetNumStepsThisFrame() const { return m_numStepsThisFrame; }
+	uint64_t GetNumStepsDropped() const { return m_numStepsDropped; }
+	float GetInterpolationAlpha() const; //0 at the last step's state, up to 1 at the next one's.
+
+	unsigned int GetNumTrackedFrames() const;
+	float GetFrameTimePercentileMs( float percentile ) const; //Over the last s_NUM_TRACKED_FRAMES, e.g. 99 for p99.
+	float GetWorkTimePercentileMs( float percentile ) const;
+
+	static const float s_DEFAULT_FRAME_LIMIT;
+	static const float s_MAX_DELTA_SECONDS;
+	static const unsigned int s_MAX_STEPS_PER_FRAME; //Past this, the rest is dropped, so a slow step can't snowball.
+	static const unsigned int s_NUM_TRACKED_FRAMES = 256;
+
+
+private:
+	FrameClock( const FrameClock& );
+	void operator=( const FrameClock& );
+
+	void WaitForFrameLimit();
+	static float CalcPercentileMs( const float* secondsHistory, unsigned int numTracked, float percentile );
+
+	uint64_t m_frameBeganTicks;
+	uint64_t m_frameNumber;
+	float m_deltaSeconds;
+	float m_smoothedDeltaSeconds;
+	double m_lastFrameSeconds;
+	double m_lastWorkSeconds;
+	float m_frameLimit;
+
+	double m_fixedStepSeconds;
+	double m_accumulatedSeconds;
+	unsigned int m_numStepsThisFrame;
+	uint64_t m_numStepsDropped;
+
+	float m_frameSecondsHistory[ s_NUM_TRACKED_FRAMES ];
+	float m_workSecondsHistory[ s_NUM_TRACKED_FRAMES ];
+};
+
+
+//-----------------------------------------------------------------------------
+void FrameStats( Command& args );
+void FrameLimit( Command& args ); //[framesPerSecond], 0 for unlimited.
+void FixedStep( Command& args ); //[stepsPerSecond], 0 for variable.
@@ -0,0 +1,268 @@
+#include "Engine/Time/FrameProfiler.hpp"
+#include "Engine/Time/Time.hpp"
+#include "Engine/Core/Command.hpp"
+#include "Engine/Core/TheConsole.hpp"
+#include "Engine/Error/ErrorWarningAssert.hpp"
+#include "Engine/FileUtils/FileUtils.hpp"
+#include "Engine/String/StringUtils.hpp"
+#include "Engine/EngineCommon.hpp"
+
+#include <string.h>
+
+
+//--------------------------------------------------------------------------------------------------------------
+STATIC const unsigned int FrameProfiler::s_WINDOW_FRAMES = 120;
+STATIC const unsigned int FrameProfiler::s_MAX_ZONES = 256;
+STATIC const unsigned int FrameProfiler::s_MAX_DEPTH = 32;
+STATIC const char* FrameProfiler::s_DEFAULT_REPORT_FILENAME = "FrameProfile.txt";
+STATIC bool FrameProfiler::s_isEnabled = false;
+STATIC thread_local bool FrameProfiler::s_isRecordingOnThisThread = false;
+
+static const unsigned int NO_ZONE = 0xffffffff;
+static const int REPORT_NAME_COLUMN_CHARS = 44;
+
+
+//--------------------------------------------------------------------------------------------------------------
+struct FrameProfileZone
+{
+	FrameProfileZone( const char* name, unsigned int parentIndex, unsigned int depth )
+		: m_name( name )
+		, m_parentIndex( parentIndex )
+		, m_firstChildIndex( NO_ZONE )
+		, m_nextSiblingIndex( NO_ZONE )
+		, m_depth( depth )
+		, m_ticksThisFrame( 0 )
+		, m_callsThisFrame( 0 )
+		, m_msHistory( FrameProfiler::s_WINDOW_FRAMES, 0.f )
+		, m_callsHistory( FrameProfiler::s_WINDOW_FRAMES, 0 )
+	{
+	}
+
+	const char* m_name; //Not copied, as with ProfileSample.
+	unsigned int m_parentIndex;
+	unsigned int m_firstChildIndex;
+	unsigned int m_nextSiblingIndex; //Children stay in the order they were first entered.
+	unsigned int m_depth;
+	uint64_t m_ticksThisFrame;
+	unsigned int m_callsThisFrame;
+	std::vector< float > m_msHistory; //Ring, indexed alongside s_historyIndex.
+	std::vector< unsigned int > m_callsHistory;
+};
+
+
+//--------------------------------------------------------------------------------------------------------------
+static bool s_isEnabledNextFrame = false;
+static std::vector< FrameProfileZone > s_zones; //0 is the whole frame. Reserved up front, so never reallocates.
+static std::vector< unsigned int > s_openZoneIndices; //Stack, the root at the bottom.
+static std::vector< uint64_t > s_openZoneStartTicks;
+static unsigned int s_numUntrackedZonesOpen = 0; //Over s_MAX_ZONES or s_MAX_DEPTH, or inside one that was.
+static unsigned int s_historyIndex = 0; //Where the frame now running will go.
+static unsigned int s_numFramesInHistory = 0;
+
+
+//--------------------------------------------------------------------------------------------------------------
+STATIC void FrameProfiler::SetEnabled( bool isEnabled )
+{
+	s_isEnabledNextFrame = isEnabled;
+}
+
+
+//--------------------------------------------------------------------------------------------------------------
+static void CloseFrameIntoHistory( uint64_t nowTicks )
+{
+	s_zones[ 0 ].m_ticksThisFrame += nowTicks - s_openZoneStartTicks[ 0 ];
+
+	for ( FrameProfileZone& zone : s_zones )
+	{
+		zone.m_msHistory[ s_historyIndex ] = static_cast<float>( ConvertTicksToSeconds( zone.m_ticksThisFrame ) * 1000.0 );
+		zone.m_callsHistory[ s_historyIndex ] = zone.m_callsThisFrame;
+		zone.m_ticksThisFrame = 0;
+		zone.m_callsThisFrame = 0;
+	}
+
+	s_historyIndex = ( s_historyIndex + 1 ) % FrameProfiler::s_WINDOW_FRAMES;
+	if ( s_numFramesInHistory < FrameProfiler::s_WINDOW_FRAMES )
+		++s_numFramesInHistory;
+}
+
+
+//--------------------------------------------------------------------------------------------------------------
+STATIC void FrameProfiler::BeginFrame()
+{
+	ASSERT_OR_DIE( s_openZoneIndices.size() <= 1 && s_numUntrackedZonesOpen == 0, "FrameProfiler::BeginFrame() called inside a zone!" );
+
+	uint64_t nowTicks = GetCurrentTimeTicks();
+	if ( s_isEnabled )
+		CloseFrameIntoHistory( nowTicks );
+
+	if ( s_isEnabledNextFrame && !s_isEnabled ) //Starting over, since the frames in between went unrecorded.
+	{
+		s_zones.clear();
+		s_zones.reserve( s_MAX_ZONES );
+		s_zones.push_back( FrameProfileZone( "Frame", NO_ZONE, 0 ) );
+		s_openZoneIndices.reserve( s_MAX_DEPTH );
+		s_openZoneStartTicks.reserve( s_MAX_DEPTH );
+		s_historyIndex = 0;
+		s_numFramesInHistory = 0;
+	}
+	s_isEnabled = s_isEnabledNextFrame;
+	s_isRecordingOnThisThread = s_isEnabled;
+
+	s_openZoneIndices.clear();
+	s_openZoneStartTicks.clear();
+	if ( s_isEnabled )
+	{
+		s_openZoneIndices.push_back( 0 );
+		s_openZoneStartTicks.push_back( nowTicks );
+		s_zones[ 0 ].m_callsThisFrame = 1;
+	}
+}
+
+
+//--------------------------------------------------------------------------------------------------------------
+static unsigned int FindOrAddChildZone( unsigned int parentIndex, const char* zoneName )
+{
+	unsigned int lastChildIndex = NO_ZONE;
+	for ( unsigned int childIndex = s_zones[ parentIndex ].m_firstChildIndex; childIndex != NO_ZONE; childIndex = s_zones[ childIndex ].m_nextSiblingIndex )
+	{
+		const char* childName = s_zones[ childIndex ].m_name;
+		if ( childName == zoneName || strcmp( childName, zoneName ) == 0 ) //The same literal isn't always the same pointer.
+			return childIndex;
+		lastChildIndex = childIndex;
+	}
+
+	if ( s_zones.size() >= FrameProfiler::s_MAX_ZONES )
+		return NO_ZONE;
+
+	unsigned int newIndex = s_zones.size();
+	s_zones.push_back( FrameProfileZone( zoneName, parentIndex, s_zones[ parentIndex ].m_depth + 1 ) );
+	if ( lastChildIndex == NO_ZONE )
+		s_zones[ parentIndex ].m_firstChildIndex = newIndex;
+	else
+		s_zones[ lastChildIndex ].m_nextSiblingIndex = newIndex;
+	return newIndex;
+}
+
+
+//--------------------------------------------------------------------------------------------------------------
+STATIC void FrameProfiler::EnterZone( const char* zoneName )
+{
+	if ( s_numUntrackedZonesOpen > 0 || s_openZoneIndices.size() >= s_MAX_DEPTH )
+	{
+		++s_numUntrackedZonesOpen;
+		return;
+	}
+
+	unsigned int zoneIndex = FindOrAddChildZone( s_openZoneIndices.back(), zoneName );
+	if ( zoneIndex == NO_ZONE )
+	{
+		++s_numUntrackedZonesOpen;
+		return;
+	}
+
+	++s_zones[ zoneIndex ].m_callsThisFrame;
+	s_openZoneIndices.push_back( zoneIndex );
+	s_openZoneStartTicks.push_back( GetCurrentTimeTicks() ); //Last, so the lookup isn't billed to the zone.
+}
+
+
+//--------------------------------------------------------------------------------------------------------------
+STATIC void FrameProfiler::ExitZone()
+{
+	if ( s_numUntrackedZonesOpen > 0 )
+	{
+		--s_numUntrackedZonesOpen;
+		return;
+	}
+
+	uint64_t nowTicks = GetCurrentTimeTicks();
+	s_zones[ s_openZoneIndices.back() ].m_ticksThisFrame += nowTicks - s_openZoneStartTicks.back();
+	s_openZoneIndices.pop_back();
+	s_openZoneStartTicks.pop_back();
+}
+
+
+//--------------------------------------------------------------------------------------------------------------
+static void AppendZoneReportLines( unsigned int zoneIndex, std::vector< std::string >& out_lines )
+{
+	const FrameProfileZone& zone = s_zones[ zoneIndex ];
+	unsigned int lastFrameIndex = ( s_historyIndex + FrameProfiler::s_WINDOW_FRAMES - 1 ) % FrameProfiler::s_WINDOW_FRAMES;
+
+	float minMs = zone.m_msHistory[ lastFrameIndex ];
+	float maxMs = minMs;
+	double totalMs = 0.0;
+	double totalCalls = 0.0;
+	for ( unsigned int frameNum = 0; frameNum < s_numFramesInHistory; frameNum++ )
+	{
+		unsigned int frameIndex = ( lastFrameIndex + FrameProfiler::s_WINDOW_FRAMES - frameNum ) % FrameProfiler::s_WINDOW_FRAMES;
+		float ms = zone.m_msHistory[ frameIndex ];
+		minMs = ( ms < minMs ) ? ms : minMs;
+		maxMs = ( ms > maxMs ) ? ms : maxMs;
+		totalMs += ms;
+		totalCalls += zone.m_callsHistory[ frameIndex ];
+	}
+
+	std::string indentedName( zone.m_depth * 2, ' ' );
+	indentedName += zone.m_name;
+	out_lines.push_back( Stringf( "%-*s %8.3f %8.3f %8.3f %8.3f %7.1f", REPORT_NAME_COLUMN_CHARS, indentedName.c_str(),
+								  zone.m_msHistory[ lastFrameIndex ], minMs, totalMs / s_numFramesInHistory, maxMs, totalCalls / s_numFramesInHistory ) );
+
+	for ( unsigned int childIndex = zone.m_firstChildIndex; childIndex != NO_ZONE; childIndex = s_zones[ childIndex ].m_nextSiblingIndex )
+		AppendZoneReportLines( childIndex, out_lines );
+}
+
+
+//--------------------------------------------------------------------------------------------------------------
+STATIC void FrameProfiler::GetReportLines( std::vector< std::string >& out_lines )
+{
+	out_lines.push_back( Stringf( "%-*s %8s %8s %8s %8s %7s", REPORT_NAME_COLUMN_CHARS, Stringf( "Zone, over %u frames", s_numFramesInHistory ).c_str(),
+								  "last_ms", "min_ms", "avg_ms", "max_ms", "calls" ) );
+	if ( s_numFramesInHistory > 0 )
+		AppendZoneReportLines( 0, out_lines );
+}
+
+
+//--------------------------------------------------------------------------------------------------------------
+STATIC bool FrameProfiler::WriteReportToFile( const std::string& filePath )
+{
+	std::vector< std::string > lines;
+	GetReportLines( lines );
+
+	std::string report;
+	for ( const std::string& line : lines )
+		report += line + "\n";
+
+	std::vector< unsigned char > buffer( report.begin(), report.end() );
+	return SaveBufferToBinaryFile( filePath, buffer );
+}
+
+
+//--------------------------------------------------------------------------------------------------------------
+void ProfilerOverlay( Command& /*args*/ )
+{
+	FrameProfiler::SetEnabled( !s_isEnabledNextFrame );
+	if ( s_isEnabledNextFrame )
+		g_theConsole->Printf( "Profiler overlay on. Run ProfilerOverlayExport [filename] to save what it shows." );
+	else
+		g_theConsole->Printf( "Profiler overlay off." );
+}
+
+
+//--------------------------------------------------------------------------------------------------------------
+void ProfilerOverlayExport( Command& args )
+{
+	if ( !FrameProfiler::IsEnabled() )
+	{
+		g_theConsole->Printf( "The profiler overlay isn't running. Usage: ProfilerOverlay, then ProfilerOverlayExport [filename]" );
+		return;
+	}
+
+	std::string filename;
+	std::string defaultFilename = FrameProfiler::s_DEFAULT_REPORT_FILENAME;
+	args.GetNextString( &filename, &defaultFilename );
+
+	if ( FrameProfiler::WriteReportToFile( filename ) )
+		g_theConsole->Printf( "Frame profile written to %s.", filename.c_str() );
+	else
+		g_theConsole->Printf( "Frame profile failed to write %s!", filename.c_str() );
+}
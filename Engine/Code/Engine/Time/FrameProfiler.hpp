@@ -0,0 +1,46 @@
+#pragma once
+
+
+#include <string>
+#include <vector>
+
+
+//-----------------------------------------------------------------------------
+class Command;
+
+
+//-----------------------------------------------------------------------------
+// Folds the PROFILE_SCOPE zones one thread enters each frame into a tree, keyed by each zone's name under its
+// parent, so a zone entered a hundred times a frame is one row with a call count. Every zone keeps its total for
+// each of the last s_WINDOW_FRAMES frames, for min/avg/max. Only the thread calling BeginFrame records, and only
+// while enabled. Pure data: TheEngine draws GetReportLines as its overlay, HeadlessRunner writes them to a file.
+//-----------------------------------------------------------------------------
+class FrameProfiler
+{
+public:
+	static void SetEnabled( bool isEnabled ); //Takes effect at the next BeginFrame, so no zone is left half open.
+	static bool IsEnabled() { return s_isEnabled; }
+	static bool IsRecordingOnThisThread() { return s_isRecordingOnThisThread; }
+	static void BeginFrame(); //Outside any zone. Ends the last frame, which is the tree's root zone.
+
+	static void EnterZone( const char* zoneName );
+	static void ExitZone();
+
+	static void GetReportLines( std::vector< std::string >& out_lines ); //A header, then one zone per line, children indented.
+	static bool WriteReportToFile( const std::string& filePath );
+
+	static const unsigned int s_WINDOW_FRAMES;
+	static const unsigned int s_MAX_ZONES; //Zones past this, or nested past s_MAX_DEPTH, are billed to their parent.
+	static const unsigned int s_MAX_DEPTH;
+	static const char* s_DEFAULT_REPORT_FILENAME;
+
+
+private:
+	static bool s_isEnabled;
+	static thread_local bool s_isRecordingOnThisThread;
+};
+
+
+//-----------------------------------------------------------------------------
+void ProfilerOverlay( Command& args ); //Toggles the overlay and the recording behind it.
+void ProfilerOverlayExport( Command& args ); //[filename]
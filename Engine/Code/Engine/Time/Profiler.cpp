@@ -0,0 +1,219 @@
+#include "Engine/Time/Profiler.hpp"
+#include "Engine/Time/Time.hpp"
+#include "Engine/Core/Command.hpp"
+#include "Engine/Core/TheConsole.hpp"
+#include "Engine/FileUtils/FileUtils.hpp"
+#include "Engine/String/StringUtils.hpp"
+#include "Engine/EngineCommon.hpp"
+
+#include <mutex>
+#include <thread>
+#include <vector>
+
+
+//--------------------------------------------------------------------------------------------------------------
+STATIC std::atomic<bool> Profiler::s_isCapturing( false );
+STATIC const unsigned int Profiler::s_MAX_SAMPLES_PER_THREAD = 64 * 1024;
+STATIC const char* Profiler::s_DEFAULT_TRACE_FILENAME = "ProfileCapture.trace.json";
+
+
+//--------------------------------------------------------------------------------------------------------------
+struct ProfileThreadBuffer
+{
+	ProfileThreadBuffer( unsigned int threadIndex )
+		: m_threadIndex( threadIndex )
+		, m_nextSampleIndex( 0 )
+		, m_numSamples( 0 )
+		, m_currentDepth( 0 )
+		, m_isWriting( false )
+		, m_samples( Profiler::s_MAX_SAMPLES_PER_THREAD )
+	{
+	}
+
+	unsigned int m_threadIndex; //Chrome trace "tid".
+	unsigned int m_nextSampleIndex;
+	unsigned int m_numSamples;
+	unsigned int m_currentDepth;
+	std::atomic<bool> m_isWriting; //Set around EndZone's write, so StopCapture can wait it out before anyone reads the ring.
+	std::vector< ProfileSample > m_samples; //Ring buffer, allocated once on the thread's first zone.
+};
+
+
+//--------------------------------------------------------------------------------------------------------------
+static std::mutex s_threadBuffersMutex; //Only taken on a thread's first zone and by Start/Stop/Export.
+static std::vector< ProfileThreadBuffer* > s_threadBuffers; //Never freed: threads may still be writing at exit.
+static thread_local ProfileThreadBuffer* t_threadBuffer = nullptr;
+
+
+//--------------------------------------------------------------------------------------------------------------
+static ProfileThreadBuffer* GetThreadBuffer()
+{
+	if ( t_threadBuffer == nullptr )
+	{
+		std::lock_guard< std::mutex > lock( s_threadBuffersMutex );
+		t_threadBuffer = new ProfileThreadBuffer( s_threadBuffers.size() );
+		s_threadBuffers.push_back( t_threadBuffer );
+	}
+
+	return t_threadBuffer;
+}
+
+
+//--------------------------------------------------------------------------------------------------------------
+void ProfileScope::Begin( const char* zoneName )
+{
+	m_depth = Profiler::BeginZone();
+	m_zoneName = zoneName;
+	m_startSeconds = GetCurrentTimeSeconds(); //Last, so BeginZone's cost isn't billed to the zone.
+}
+
+
+//--------------------------------------------------------------------------------------------------------------
+STATIC unsigned int Profiler::BeginZone()
+{
+	return GetThreadBuffer()->m_currentDepth++;
+}
+
+
+//--------------------------------------------------------------------------------------------------------------
+STATIC void Profiler::EndZone( const char* zoneName, double startSeconds, unsigned int depth )
+{
+	double endSeconds = GetCurrentTimeSeconds();
+
+	ProfileThreadBuffer* buffer = GetThreadBuffer();
+	buffer->m_currentDepth = depth;
+
+	//Both seq_cst, pairing with StopCapture's: either this sees the stop and writes nothing, or StopCapture waits for it.
+	buffer->m_isWriting.store( true );
+	if ( !s_isCapturing.load() )
+	{
+		buffer->m_isWriting.store( false, std::memory_order_release );
+		return; //Opened during a capture that has since stopped, and may already be exporting.
+	}
+
+	ProfileSample& sample = buffer->m_samples[ buffer->m_nextSampleIndex ];
+	sample.m_zoneName = zoneName;
+	sample.m_startSeconds = startSeconds;
+	sample.m_endSeconds = endSeconds;
+	sample.m_depth = depth;
+
+	buffer->m_nextSampleIndex = ( buffer->m_nextSampleIndex + 1 ) % s_MAX_SAMPLES_PER_THREAD;
+	if ( buffer->m_numSamples < s_MAX_SAMPLES_PER_THREAD )
+		++buffer->m_numSamples;
+
+	buffer->m_isWriting.store( false, std::memory_order_release );
+}
+
+
+//--------------------------------------------------------------------------------------------------------------
+STATIC void Profiler::StartCapture()
+{
+	StopCapture(); //So no thread is mid-write while the rings are reset below.
+
+	std::lock_guard< std::mutex > lock( s_threadBuffersMutex );
+
+	for ( ProfileThreadBuffer* buffer : s_threadBuffers )
+	{
+		buffer->m_nextSampleIndex = 0;
+		buffer->m_numSamples = 0; //Depth is left alone, scopes already open will still close.
+	}
+
+	s_isCapturing.store( true );
+}
+
+
+//--------------------------------------------------------------------------------------------------------------
+STATIC void Profiler::StopCapture()
+{
+	s_isCapturing.store( false );
+
+	//Job threads may still be closing scopes. Once each is past any write it began, the rings hold still for export.
+	std::lock_guard< std::mutex > lock( s_threadBuffersMutex );
+	for ( const ProfileThreadBuffer* buffer : s_threadBuffers )
+	{
+		while ( buffer->m_isWriting.load() )
+			std::this_thread::yield();
+	}
+}
+
+
+//--------------------------------------------------------------------------------------------------------------
+STATIC unsigned int Profiler::GetNumCapturedSamples()
+{
+	std::lock_guard< std::mutex > lock( s_threadBuffersMutex );
+
+	unsigned int numSamples = 0;
+	for ( const ProfileThreadBuffer* buffer : s_threadBuffers )
+		numSamples += buffer->m_numSamples;
+
+	return numSamples;
+}
+
+
+//--------------------------------------------------------------------------------------------------------------
+STATIC bool Profiler::ExportChromeTrace( const std::string& filePath )
+{
+	std::string json = "{\"traceEvents\":[\n";
+	bool isFirstEvent = true;
+
+	{
+		std::lock_guard< std::mutex > lock( s_threadBuffersMutex );
+
+		for ( const ProfileThreadBuffer* buffer : s_threadBuffers )
+		{
+			//Oldest sample first: once the ring has wrapped, that's the one about to be overwritten next.
+			unsigned int firstSampleIndex = ( buffer->m_numSamples < s_MAX_SAMPLES_PER_THREAD ) ? 0 : buffer->m_nextSampleIndex;
+
+			for ( unsigned int sampleNum = 0; sampleNum < buffer->m_numSamples; sampleNum++ )
+			{
+				const ProfileSample& sample = buffer->m_samples[ ( firstSampleIndex + sampleNum ) % s_MAX_SAMPLES_PER_THREAD ];
+
+				//"X" is a complete event: start timestamp plus duration, both in microseconds.
+				json += Stringf( "%s{\"name\":\"%s\",\"ph\":\"X\",\"ts\":%.3f,\"dur\":%.3f,\"pid\":0,\"tid\":%u,\"args\":{\"depth\":%u}}",
+								 isFirstEvent ? "" : ",\n",
+								 sample.m_zoneName,
+								 sample.m_startSeconds * 1000000.0,
+								 ( sample.m_endSeconds - sample.m_startSeconds ) * 1000000.0,
+								 buffer->m_threadIndex,
+								 sample.m_depth );
+				isFirstEvent = false;
+			}
+		}
+	}
+
+	json += "\n],\"displayTimeUnit\":\"ms\"}\n";
+
+	std::vector< unsigned char > buffer( json.begin(), json.end() );
+	return SaveBufferToBinaryFile( filePath, buffer );
+}
+
+
+//--------------------------------------------------------------------------------------------------------------
+void ProfilerStart( Command& /*args*/ )
+{
+	Profiler::StartCapture();
+	g_theConsole->Printf( "Profiler capture started. Run ProfilerStop [filename] to export it." );
+}
+
+
+//--------------------------------------------------------------------------------------------------------------
+void ProfilerStop( Command& args )
+{
+	if ( !Profiler::IsCapturing() )
+	{
+		g_theConsole->Printf( "No profiler capture is running. Usage: ProfilerStart, then ProfilerStop [filename]" );
+		return;
+	}
+
+	Profiler::StopCapture();
+
+	std::string filename;
+	std::string defaultFilename = Profiler::s_DEFAULT_TRACE_FILENAME;
+	args.GetNextString( &filename, &defaultFilename );
+
+	unsigned int numSamples = Profiler::GetNumCapturedSamples();
+	if ( Profiler::ExportChromeTrace( filename ) )
+		g_theConsole->Printf( "Profiler capture of %u zones exported to %s.", numSamples, filename.c_str() );
+	else
+		g_theConsole->Printf( "Profiler failed to write %s!", filename.c_str() );
+}
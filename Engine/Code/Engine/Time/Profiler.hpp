@@ -0,0 +1,102 @@
+#pragma once
+
+
+#include "Engine/Time/FrameProfiler.hpp"
+#include <atomic>
+#include <string>
+
+
+//-----------------------------------------------------------------------------
+class Command;
+
+
+//-----------------------------------------------------------------------------
+// Usage: PROFILE_SCOPE( "Agent::Update" ); at the top of any block to time it until the block exits.
+// The same zones feed FrameProfiler's overlay. While neither records, a scope costs one relaxed atomic load and a
+// thread-local flag check. Define DISABLE_PROFILER to compile them out entirely.
+//-----------------------------------------------------------------------------
+#define PROFILE_SCOPE_CONCAT_INNER( prefix, line ) prefix##line
+#define PROFILE_SCOPE_CONCAT( prefix, line ) PROFILE_SCOPE_CONCAT_INNER( prefix, line )
+
+#if defined( DISABLE_PROFILER )
+#define PROFILE_SCOPE( zoneName )
+#else
+#define PROFILE_SCOPE( zoneName ) ProfileScope PROFILE_SCOPE_CONCAT( profileScope_, __LINE__ )( zoneName )
+#endif
+
+
+//-----------------------------------------------------------------------------
+struct ProfileSample
+{
+	const char* m_zoneName; //Not copied, so it must outlive the capture: use string literals.
+	double m_startSeconds;
+	double m_endSeconds;
+	unsigned int m_depth;
+};
+
+
+//-----------------------------------------------------------------------------
+class Profiler //Each thread records into its own ring buffer, so zones never contend on a lock.
+{
+public:
+	static void StartCapture(); //Discards any previous capture.
+	static void StopCapture(); //Returns once no thread is still writing a sample, so the capture can be read safely.
+	static bool IsCapturing() { return s_isCapturing.load( std::memory_order_relaxed ); }
+	static unsigned int GetNumCapturedSamples(); //This and the export read the rings, so only after StopCapture.
+	static bool ExportChromeTrace( const std::string& filePath ); //Open in chrome://tracing.
+
+	static unsigned int BeginZone(); //Returns the zone's nesting depth on this thread.
+	static void EndZone( const char* zoneName, double startSeconds, unsigned int depth );
+
+	static const unsigned int s_MAX_SAMPLES_PER_THREAD; //Oldest samples are overwritten past this.
+	static const char* s_DEFAULT_TRACE_FILENAME;
+
+
+private:
+	static std::atomic<bool> s_isCapturing;
+};
+
+
+//-----------------------------------------------------------------------------
+class ProfileScope
+{
+public:
+	ProfileScope( const char* zoneName );
+	~ProfileScope();
+
+
+private:
+	void Begin( const char* zoneName );
+
+	const char* m_zoneName; //Stays nullptr if no capture was running when the scope opened.
+	bool m_isInFrameProfile; //Likewise for FrameProfiler, which may be toggled between open and close.
+	double m_startSeconds;
+	unsigned int m_depth;
+};
+
+
+//-----------------------------------------------------------------------------
+inline ProfileScope::ProfileScope( const char* zoneName )
+	: m_zoneName( nullptr )
+	, m_isInFrameProfile( FrameProfiler::IsRecordingOnThisThread() )
+{
+	if ( m_isInFrameProfile )
+		FrameProfiler::EnterZone( zoneName );
+	if ( Profiler::IsCapturing() )
+		Begin( zoneName );
+}
+
+
+//-----------------------------------------------------------------------------
+inline ProfileScope::~ProfileScope()
+{
+	if ( m_zoneName != nullptr )
+		Profiler::EndZone( m_zoneName, m_startSeconds, m_depth );
+	if ( m_isInFrameProfile )
+		FrameProfiler::ExitZone();
+}
+
+
+//-----------------------------------------------------------------------------
+void ProfilerStart( Command& args );
+void ProfilerStop( Command& args );
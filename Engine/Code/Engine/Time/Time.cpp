@@ -15,64 +15,46 @@ void SeedWindowsRNG()
 }
 
 //--------------------------------------------------------------------------------------------------------------
-double InitializeTime( LARGE_INTEGER& out_initialTime )
+struct TimeEpoch
 {
-	LARGE_INTEGER countsPerSecond;
-	QueryPerformanceFrequency( &countsPerSecond );
-	QueryPerformanceCounter( &out_initialTime );
+	TimeEpoch()
+	{
+		LARGE_INTEGER countsPerSecond;
+		QueryPerformanceFrequency( &countsPerSecond );
+		QueryPerformanceCounter( &m_initialCount );
+		m_secondsPerCount = 1.0 / static_cast<double>( countsPerSecond.QuadPart );
+	}
 
-	return ( 1.0 / static_cast<double>( countsPerSecond.QuadPart ) );
+	LARGE_INTEGER m_initialCount;
+	double m_secondsPerCount;
+};
+static const TimeEpoch& GetTimeEpoch()
+{
+	static TimeEpoch s_epoch; //Note static implies lifetime beyond function call, and construction on the first.
+	return s_epoch;
 }
 
 
 //--------------------------------------------------------------------------------------------------------------
-double GetCurrentTimeSeconds()
+uint64_t GetCurrentTimeTicks()
 {
-	static LARGE_INTEGER initialTime; //Note static implies lifetime beyond function call.
-	static double secondsPerCount = InitializeTime( initialTime ); //Never called again due to static.
+	const TimeEpoch& epoch = GetTimeEpoch(); //First, so the very first call reads after the epoch, not before.
 	LARGE_INTEGER currentCount;
-	
 	QueryPerformanceCounter( &currentCount );
-	
-	LONGLONG elapsedCountsSinceInitialTime = currentCount.QuadPart - initialTime.QuadPart;
-	double currentSeconds = static_cast<double>(elapsedCountsSinceInitialTime) * secondsPerCount;
-	
-	return currentSeconds;
+
+	return static_cast<uint64_t>( currentCount.QuadPart - epoch.m_initialCount.QuadPart );
 }
 
 
 //--------------------------------------------------------------------------------------------------------------
-float CalcDeltaSeconds()
+double ConvertTicksToSeconds( uint64_t ticks )
 {
-	/* Records on Performance: Alienware m17x R2, GTX 980M
-		Release build mode with below loop
-			30 FPS - Unplugged any mode
-			80-90 FPS - Plugged power saver
-			90-120+ FPS - Plugged balanced or high performance
-		Release build mode without below loop
-			30 FPS - Unplugged any mode
-			140-150 FPS - Plugged power saver
-			500-600 FPS - Plugged balanced or high performance
-	*/
-
-	static double s_timeLastFrameBegan = GetCurrentTimeSeconds(); //Called only once due static.
-	double timeThisFrameBegan = GetCurrentTimeSeconds();
-
-	float deltaSeconds = static_cast<float>( timeThisFrameBegan - s_timeLastFrameBegan );
-
-	const double FRAMES_PER_SECOND = 60.0;
-	const double SECONDS_PER_FRAME = 1.0 / FRAMES_PER_SECOND;
-	const float MAX_DELTA = 1.0f;
-
-	while ( deltaSeconds < SECONDS_PER_FRAME )
-	{
-		ROADMAP( "Replace with more sophisticated framerate timer system." );
-		Sleep( 0 );
-		//Further apart because s_timeLastFrameBegan isn't updated:
-		deltaSeconds = static_cast<float>( GetCurrentTimeSeconds() - s_timeLastFrameBegan );
-	}
+	return static_cast<double>( ticks ) * GetTimeEpoch().m_secondsPerCount;
+}
 
-	s_timeLastFrameBegan = timeThisFrameBegan;
 
-	return GetMin( deltaSeconds, MAX_DELTA );
+//--------------------------------------------------------------------------------------------------------------
+double GetCurrentTimeSeconds()
+{
+	return ConvertTicksToSeconds( GetCurrentTimeTicks() );
 }
@@ -1,7 +1,11 @@
 #pragma once
 
 
+#include <stdint.h>
+
+
 //-----------------------------------------------------------------------------------------------
 void SeedWindowsRNG();
+uint64_t GetCurrentTimeTicks(); //Monotonic performance counter ticks since the first call, for exact differences.
+double ConvertTicksToSeconds( uint64_t ticks );
 double GetCurrentTimeSeconds();
-float CalcDeltaSeconds();
\ No newline at end of file
@@ -7,7 +7,10 @@
 #include "Game/Inventory.hpp"
 #include "Game/Cell.hpp"
 #include "Game/Features/Feature.hpp"
-#include "Game/CombatSystem.hpp"
+#include "Engine/Time/Profiler.hpp"
+#include "Engine/Memory/AllocationTracker.hpp"
+#include "Engine/FileUtils/Writers/BinaryWriter.hpp"
+#include "Engine/FileUtils/Readers/BinaryReader.hpp"
 
 
 //--------------------------------------------------------------------------------------------------------------
@@ -20,9 +23,13 @@ Agent::Agent( EntityType entityType )
 	, m_damageBonus( s_DEFAULT_DAMAGE_BONUS )
 	, m_numMonstersKilled( 0 )
 	, m_unequippedItems( new Inventory() )
+	, m_occupiedEquipmentSlots( 0 )
 {
 	for ( int slotIndex = 0; slotIndex < NUM_EQUIPMENT_SLOTS; slotIndex++ )
 		m_equippedItems[ slotIndex ] = nullptr;
+
+	for ( int itemType = 0; itemType < NUM_ITEM_TYPES; itemType++ )
+		m_equippedSlotsByItemType[ itemType ] = 0;
 }
 
 
@@ -37,9 +44,13 @@ Agent::Agent( const Agent& other )
 	, m_damageBonus( other.m_damageBonus )
 	, m_numMonstersKilled( other.m_numMonstersKilled )
 	, m_unequippedItems( new Inventory( *other.m_unequippedItems ) )
+	, m_occupiedEquipmentSlots( other.m_occupiedEquipmentSlots )
 {
 	for ( int slotIndex = 0; slotIndex < NUM_EQUIPMENT_SLOTS; slotIndex++ )
 		m_equippedItems[ slotIndex ] = other.m_equippedItems[ slotIndex ];
+
+	for ( int itemType = 0; itemType < NUM_ITEM_TYPES; itemType++ )
+		m_equippedSlotsByItemType[ itemType ] = other.m_equippedSlotsByItemType[ itemType ];
 }
 
 
@@ -85,6 +96,8 @@ bool Agent::MoveOneStep( const Vector2i& positionDelta )
 //--------------------------------------------------------------------------------------------------------------
 void Agent::UpdateFieldOfView()
 {
+	PROFILE_SCOPE( "Agent::UpdateFieldOfView" );
+	MEMORY_TAG( "FieldOfView" );
 	FieldOfView::CalculateFieldOfViewForAgent( this, m_viewRadius, m_map, true, m_visibleAgents, m_visibleItems, m_visibleFeatures );
 }
 
@@ -97,6 +110,8 @@ void Agent::SetOccupiedCellsAgentTo( Agent* agent )
 	for ( int cellY = positionMins.y; cellY < positionMaxs.y; cellY++ )
 		for ( int cellX = positionMins.x; cellX < positionMaxs.x; cellX++ )
 			m_map->GetCellForPosition( MapPosition( cellX, cellY ) ).m_occupyingAgent = agent;
+
+	m_map->GetHazards().OnAgentOccupancyChanged( this, agent != nullptr );
 }
 
 
@@ -117,24 +132,12 @@ bool Agent::Render()
 //--------------------------------------------------------------------------------------------------------------
 float Agent::Update( float deltaSeconds )
 {
-	UNREFERENCED( deltaSeconds );
-	static bool hasBeenBurned = false;
+	PROFILE_SCOPE( "Agent::Update" );
+	MEMORY_TAG( "Agents" );
 
-	//Apply damage if standing in lava during turn--call this function at end of update to be most lenient.
-	if ( m_map->GetCellForPosition( GetPositionMins() ).m_cellType == CELL_TYPE_LAVA )
-	{
-		if ( !IsInvincible() )
-		{
-			SubtractHealthDelta( LAVA_DAMAGE_PER_TURN );
-			if ( IsPlayer() )
-				g_theConsole->Printf( "You take %d damage for walking on lava.%s",
-									  LAVA_DAMAGE_PER_TURN,
-									  hasBeenBurned ? "" : " Pinching yourself wouldn't work either, then." );
+	UNREFERENCED( deltaSeconds );
 
-			CombatSystem::PlayHurtSound( this );
-			hasBeenBurned = true;
-		}
-	}
+	//Lava damage and water/lava slow are applied map-wide once per time slice by HazardSystem, see TheGame::UpdatePlayedMapSimulation.
 
 	return DEFAULT_TURN_COOLDOWN;
 }
@@ -207,9 +210,9 @@ void Agent::PrintStatusOnFaction( FactionID factionID )
 
 	FactionRelationship* relation = m_faction.CreateOrGetRelationshipWithFaction( factionID );
 	g_theConsole->Printf( "%s now %d toward %s-faction agents.", 
-						  m_name.c_str(), 
+						  m_name.GetCString(), 
 						  relation->m_relationshipValue, 
-						  relation->m_towardsThisFactionName.c_str() );
+						  relation->m_towardsThisFactionName.GetCString() );
 	g_theConsole->ShowConsole();
 }
 
@@ -272,6 +275,59 @@ void Agent::PopulateFromXMLNode( const XMLNode& instanceDataNode, Map* map )
 }
 
 
+//--------------------------------------------------------------------------------------------------------------
+void Agent::WriteToBinary( BinaryWriter& writer ) const
+{
+	GameEntity::WriteToBinary( writer );
+
+	writer.Write<EntityID>( ( m_targetEnemy != nullptr ) ? m_targetEnemy->GetEntityID() : 0 ); //0 reads back as nullptr below.
+	writer.Write<int>( m_numMonstersKilled );
+	writer.Write<int>( m_damageBonus );
+	writer.Write<int>( m_viewRadius );
+	writer.Write<bitfield_int>( m_traversalProperties );
+
+	//Unlike the XML, equipment is restored on load, so each equipped item is written in full.
+	writer.Write<bitfield_int>( m_occupiedEquipmentSlots );
+	for ( int slotIndex = 0; slotIndex < NUM_EQUIPMENT_SLOTS; slotIndex++ )
+		if ( IsEquipmentSlotOccupied( (EquipmentSlot)slotIndex ) )
+			m_equippedItems[ slotIndex ]->WriteBinaryRecord( writer );
+
+	m_unequippedItems->WriteToBinary( writer );
+}
+
+
+//--------------------------------------------------------------------------------------------------------------
+void Agent::PopulateFromBinary( BinaryReader& reader, Map* map )
+{
+	GameEntity::PopulateFromBinary( reader, map );
+	if ( m_map != nullptr )
+		SetOccupiedCellsAgentTo( this );
+
+	EntityID targetEnemyID = 0;
+	reader.Read<EntityID>( &targetEnemyID );
+	m_targetEnemy = (Agent*)targetEnemyID; //TRICK, fix in ResolveEntityPointer.
+	reader.Read<int>( &m_numMonstersKilled );
+	reader.Read<int>( &m_damageBonus );
+	reader.Read<int>( &m_viewRadius );
+	reader.Read<bitfield_int>( &m_traversalProperties );
+
+	bitfield_int savedEquipmentSlots = 0;
+	reader.Read<bitfield_int>( &savedEquipmentSlots );
+	for ( int slotIndex = 0; slotIndex < NUM_EQUIPMENT_SLOTS; slotIndex++ )
+	{
+		SetEquippedItem( (EquipmentSlot)slotIndex, nullptr ); //Drop anything the blueprint clone came with.
+
+		if ( GET_BIT_AT_BITFIELD_INDEX_MASKED( savedEquipmentSlots, slotIndex ) != 0 )
+			SetEquippedItem( (EquipmentSlot)slotIndex, Item::CreateFromBinaryRecord( reader, nullptr ) );
+	}
+
+	//The clone's inventory shares the blueprint's item pointers, so start over rather than push onto it.
+	delete m_unequippedItems;
+	m_unequippedItems = new Inventory();
+	m_unequippedItems->PopulateFromBinary( reader );
+}
+
+
 //-------------------------------------------------------------------------------------
 void Agent::PopulateFactionsFromXMLNode( const XMLNode& agentNode )
 {
@@ -299,7 +355,7 @@ void Agent::PopulateFactionsFromXMLNode( const XMLNode& agentNode )
 		m_faction.RestoreFromXMLNode( rawFactionsNode );
 
 	GUARANTEE_RECOVERABLE( hasFactionAttribute || hasSingleFactionElement || hasMultipleFactionsElement,
-						   Stringf( "%s has no faction attribute, <Faction> element, or <Factions> element detected!", m_name.c_str() ) );
+						   Stringf( "%s has no faction attribute, <Faction> element, or <Factions> element detected!", m_name.GetCString() ) );
 }
 
 
@@ -313,14 +369,18 @@ void Agent::RemoveRelationsWithEntity( const Agent* agentToRemove )
 //--------------------------------------------------------------------------------------------------------------
 Item* Agent::GetBestOfEquippedItemType( ItemType type ) const
 {
+	bitfield_int slotsOfType = m_equippedSlotsByItemType[ type ];
+	if ( slotsOfType == 0 )
+		return nullptr; //The common case for unarmed/unarmored NPCs.
+
 	Item* currentBest = nullptr;
 	for ( unsigned int slotIndex = 0; slotIndex < NUM_EQUIPMENT_SLOTS; slotIndex++ )
 	{
-		Item* candidate = m_equippedItems[ slotIndex ];
-
-		if ( ( candidate == nullptr ) || ( candidate->GetItemType() != type ) )
+		if ( GET_BIT_AT_BITFIELD_INDEX_MASKED( slotsOfType, slotIndex ) == 0 )
 			continue;
 
+		Item* candidate = m_equippedItems[ slotIndex ];
+
 		if ( currentBest == nullptr || currentBest < candidate  )
 			currentBest = candidate;
 	}
@@ -334,7 +394,7 @@ std::vector< Item* > Agent::GetEquipmentAndItems() const
 	std::vector< Item* > m_items;
 	m_items.insert( m_items.end(), m_unequippedItems->GetItems().begin(), m_unequippedItems->GetItems().end() );
 	for ( unsigned int slotIndex = 0; slotIndex < NUM_EQUIPMENT_SLOTS; slotIndex++ )
-		if ( m_equippedItems[ slotIndex ] != nullptr )
+		if ( IsEquipmentSlotOccupied( (EquipmentSlot)slotIndex ) )
 			m_items.push_back( m_equippedItems[ slotIndex ] );
 
 	return m_items;
@@ -360,9 +420,9 @@ bool Agent::AutoEquipItem( Item* grabbedItem )
 		//Second, check all of this agent's slots for an empty one, add to first one found.
 		for ( EquipmentSlot validSlot : validSlots ) //Means the first slot listed in its XML has highest priority.
 		{
-			if ( m_equippedItems[ validSlot ] == nullptr )
+			if ( !IsEquipmentSlotOccupied( validSlot ) )
 			{
-				m_equippedItems[ validSlot ] = grabbedItem;
+				SetEquippedItem( validSlot, grabbedItem );
 
 				if ( IsPlayer() )
 					g_theConsole->Printf( "You pick up and equip the %s to your %s.",
@@ -388,7 +448,7 @@ bool Agent::AutoEquipItem( Item* grabbedItem )
 				{
 					Item* itemBeingUnequipped = m_equippedItems[ validSlot ];
 					m_unequippedItems->PushItem( itemBeingUnequipped );
-					m_equippedItems[ validSlot ] = grabbedItem;
+					SetEquippedItem( validSlot, grabbedItem );
 
 					if ( IsPlayer() )
 						g_theConsole->Printf( "You pick up and equip the %s to your %s, storing away your %s.",
@@ -412,6 +472,24 @@ bool Agent::AutoEquipItem( Item* grabbedItem )
 }
 
 
+//--------------------------------------------------------------------------------------------------------------
+void Agent::SetEquippedItem( EquipmentSlot slot, Item* item )
+{
+	Item* previousItem = m_equippedItems[ slot ];
+	if ( previousItem != nullptr )
+		m_equippedSlotsByItemType[ previousItem->GetItemType() ] &= ~GET_BIT_AT_BITFIELD_INDEX( slot );
+
+	m_equippedItems[ slot ] = item;
+
+	if ( item != nullptr )
+	{
+		m_occupiedEquipmentSlots |= GET_BIT_AT_BITFIELD_INDEX( slot );
+		m_equippedSlotsByItemType[ item->GetItemType() ] |= GET_BIT_AT_BITFIELD_INDEX( slot );
+	}
+	else m_occupiedEquipmentSlots &= ~GET_BIT_AT_BITFIELD_INDEX( slot );
+}
+
+
 //--------------------------------------------------------------------------------------------------------------
 void Agent::PickUpItemAndAutoEquip()
 {
@@ -443,36 +521,34 @@ void Agent::PickUpItemAndAutoEquip()
 //--------------------------------------------------------------------------------------------------------------
 bool Agent::UseLastAcquiredPotion()
 {
+	static const Name SIGNAL_DREAM_POTION_NAME( "Potion of a Signal Dream" ); //Interned once, so each check is a pointer compare.
+	static const Name WELLNESS_DREAM_POTION_NAME( "Potion of a Wellness Dream" );
+	static const Name NIGHTMARE_POTION_NAME( "Potion of a Nightmare" );
 
 	bool hadPotion = false;
 
-	std::vector< Item* > unequippedItems = m_unequippedItems->GetItems();
-	if ( unequippedItems.size() == 0 )
+	if ( m_unequippedItems->GetCount() == 0 )
 		return hadPotion;
 
-	for ( unsigned int itemIndex = unequippedItems.size() - 1; itemIndex > 0; itemIndex-- )
+	Item* item = m_unequippedItems->GetLastAcquiredItemOfType( ITEM_TYPE_POTION ); //Bucketed, so no scan past weapons and armor.
+	if ( item != nullptr )
 	{
-		Item* item = unequippedItems[ itemIndex ];
-
-		if ( item->GetItemType() != ITEM_TYPE_POTION )
-			continue;
-
 		hadPotion = true;
 
-		if ( item->GetName() == "Potion of a Signal Dream" )
+		if ( item->GetInternedName() == SIGNAL_DREAM_POTION_NAME )
 		{
 			int delta = GetRandomIntInRange( 3, 5 );
 			g_theConsole->Printf( "The signal dream gave you %d points of increased perception!", delta );
 			m_viewRadius += delta;
 			UpdateFieldOfView();
 		}
-		else if ( item->GetName() == "Potion of a Wellness Dream" )
+		else if ( item->GetInternedName() == WELLNESS_DREAM_POTION_NAME )
 		{
 			int delta = GetRandomIntInRange( 5, 10 );
 			g_theConsole->Printf( "The wellness dream healed you %d points!", delta );
 			AddHealthDelta( delta );
 		}
-		else if ( item->GetName() == "Potion of a Nightmare" )
+		else if ( item->GetInternedName() == NIGHTMARE_POTION_NAME )
 		{
 			g_theConsole->Printf( "The nightmare granted you its power for +1 damage on all attacks!" );
 			m_color = m_color + ( Rgba::RED * Rgba::GRAY );
@@ -482,8 +558,6 @@ bool Agent::UseLastAcquiredPotion()
 		}
 
 		m_unequippedItems->EraseItem( item );
-
-		break;
 	}
 
 	g_theConsole->ShowConsole();
@@ -567,7 +641,7 @@ void Agent::Die()
 //--------------------------------------------------------------------------------------------------------------
 void Agent::ToggleAdjacentFeatures()
 {
-	std::vector< Cell* > neighbors;
+	FrameVector< Cell* > neighbors;
 	m_map->GetAdjacentNeighborCells( GetPositionMins(), 1.f, false, neighbors );
 
 	for ( Cell* cell : neighbors )
@@ -44,7 +44,8 @@ public:
 	bool DoesNotHarmFaction( FactionID faction );
 	void AdjustFactionStatus( Agent* instigator, FactionAction action );
 	FactionID GetFactionID() const;
-	std::string GetFactionName() const { return m_faction.GetName(); }
+	Faction& GetFaction() { return m_faction; }
+	const std::string& GetFactionName() const { return m_faction.GetName(); }
 	
 	int GetNumKills() const { return m_numMonstersKilled; }
 	void AddKill() { ++m_numMonstersKilled; }
@@ -56,6 +57,8 @@ public:
 	void WriteEquipmentToXMLNode( XMLNode &out_agentNode );
 
 	virtual void PopulateFromXMLNode( const XMLNode& instanceDataNode, Map* map ) override;
+	virtual void WriteToBinary( BinaryWriter& writer ) const override; //Faction excluded, it's saved in its own section.
+	virtual void PopulateFromBinary( BinaryReader& reader, Map* map ) override;
 	void RemoveRelationsWithEntity( const Agent* agentToRemove ); //Usually when they die.
 
 	Item* GetBestOfEquippedItemType( ItemType type ) const;
@@ -73,12 +76,16 @@ protected:
 	void Agent::PrintStatusOnFaction( FactionID factionID );
 	void PopulateFactionsFromXMLNode( const XMLNode& agentNode );
 	bool AutoEquipItem( Item* grabbedItem );
+	void SetEquippedItem( EquipmentSlot slot, Item* item ); //Keeps the slot bitsets below in sync.
+	bool IsEquipmentSlotOccupied( EquipmentSlot slot ) const { return GET_BIT_AT_BITFIELD_INDEX_MASKED( m_occupiedEquipmentSlots, slot ) != 0; }
 	Faction m_faction; //Doesn't need to be a pointer, if you have reason to do factionless agent could here via nullptr though.
 
 	static const bitfield_int s_DEFAULT_TRAVERSAL_PROPERTIES = BLOCKED_BY_AGENTS | BLOCKED_BY_SOLIDS | SLOWED_BY_WATER | SLOWED_BY_LAVA;
 	bitfield_int m_traversalProperties;
 	Inventory* m_unequippedItems;
 	Item* m_equippedItems[ NUM_EQUIPMENT_SLOTS ];
+	bitfield_int m_occupiedEquipmentSlots;
+	bitfield_int m_equippedSlotsByItemType[ NUM_ITEM_TYPES ]; //e.g. which slots hold weapons, so best-of-type checks skip the rest.
 	int m_numMonstersKilled;
 	int m_damageBonus; //Added to every attack.
 	int m_viewRadius;
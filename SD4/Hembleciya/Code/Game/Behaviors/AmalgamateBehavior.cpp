@@ -1,5 +1,7 @@
 #include "Game/Behaviors/AmalgamateBehavior.hpp"
 #include "Engine/FileUtils/XMLUtils.hpp"
+#include "Engine/FileUtils/Writers/BinaryWriter.hpp"
+#include "Engine/FileUtils/Readers/BinaryReader.hpp"
 #include "Engine/Math/MathUtils.hpp"
 #include "Game/Agent.hpp"
 #include "Game/Pathfinding/Pathfinder.hpp"
@@ -117,3 +119,17 @@ void AmalgamateBehavior::WriteToXMLNode( XMLNode& behaviorsNode )
 	WriteXMLAttribute( behaviorNode, "maxDistAwayToAmalgamate", m_maxDistAwayToAmalgamate, s_DEFAULT_MAX_DIST_AWAY_TO_AMALGAMATE );
 	WriteXMLAttribute( behaviorNode, "maxHealthFractionNeededToActivate", m_maxHealthFractionNeededToActivate, s_DEFAULT_MAX_HEALTH_FRACTION_NEEDED_TO_ACTIVATE );
 }
+
+
+//--------------------------------------------------------------------------------------------------------------
+void AmalgamateBehavior::WriteToBinary( BinaryWriter& writer ) const
+{
+	writer.Write<bool>( m_hasFused );
+}
+
+
+//--------------------------------------------------------------------------------------------------------------
+void AmalgamateBehavior::PopulateFromBinary( BinaryReader& reader )
+{
+	reader.Read<bool>( &m_hasFused );
+}
@@ -15,6 +15,8 @@ class AmalgamateBehavior : public Behavior
 	virtual CooldownSeconds Run() override;
 	virtual Behavior* CreateClone() const override { return new AmalgamateBehavior( *this ); }
 	virtual void WriteToXMLNode( XMLNode& behaviorsNode ) override;
+	virtual void WriteToBinary( BinaryWriter& writer ) const override;
+	virtual void PopulateFromBinary( BinaryReader& reader ) override;
 
 	float m_maxDistAwayToAmalgamate;
 	float m_maxHealthFractionNeededToActivate;
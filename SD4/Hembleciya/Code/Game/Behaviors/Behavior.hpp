@@ -5,6 +5,9 @@
 #include "Game/GameCommon.hpp"
 struct XMLNode;
 class Agent;
+class GameEntity;
+class BinaryWriter;
+class BinaryReader;
 
 
 class Behavior
@@ -23,6 +26,11 @@ public:
 	virtual Behavior* CreateClone() const = 0;
 	virtual void WriteToXMLNode( XMLNode& behaviorsNode );
 
+	//Binary saves hold only runtime state, tuning values come back with the clone of the NPC's blueprint.
+	virtual void WriteToBinary( BinaryWriter& /*writer*/ ) const {}
+	virtual void PopulateFromBinary( BinaryReader& /*reader*/ ) {}
+	virtual void ResolvePointersToEntities( std::map< EntityID, GameEntity* >& /*loadedEntities*/ ) {}
+
 protected:
 
 	Agent* m_agent;
@@ -1,9 +1,12 @@
 #include "Game/Behaviors/DreamBehavior.hpp"
 #include "Engine/FileUtils/XMLUtils.hpp"
+#include "Engine/FileUtils/Writers/BinaryWriter.hpp"
+#include "Engine/FileUtils/Readers/BinaryReader.hpp"
 #include "Engine/Math/MathUtils.hpp"
 #include "Game/Agent.hpp"
 #include "Game/Pathfinding/Pathfinder.hpp"
 #include "Game/Map.hpp"
+#include "Game/Features/Feature.hpp"
 #include "Engine/Audio/TheAudio.hpp"
 #include "Engine/Core/TheConsole.hpp"
 
@@ -15,11 +18,71 @@ STATIC const Rgba			DreamBehavior::s_DEFAULT_DREAM_TINT = Rgba();
 STATIC const float			DreamBehavior::s_DEFAULT_MAX_HEALTH_FRACTION_NEEDED_TO_ACTIVATE = .25f;
 
 
+//--------------------------------------------------------------------------------------------------------------
+bool DreamCell::operator==( const DreamCell& other ) const
+{
+	return ( m_cellType == other.m_cellType )
+		&& ( m_parsedMapGlyph == other.m_parsedMapGlyph )
+		&& ( m_color == other.m_color )
+		&& ( m_color.alphaOpacity == other.m_color.alphaOpacity ) //Rgba::operator== skips alpha.
+		&& ( m_occupyingFeature == other.m_occupyingFeature );
+}
+
+
+//--------------------------------------------------------------------------------------------------------------
+DreamLayout::DreamLayout( const char* tileDataString, const std::string& dreamName, const Rgba& dreamTint, bool shouldTint )
+	: m_name( dreamName )
+{
+	Map* parsedDream = Map::CreateFromTileDataStringWithNewlines( tileDataString, dreamName );
+
+	m_size = parsedDream->GetDimensions();
+	ROADMAP( "Substitute this for an actual given (S)tart tile." );
+	m_spawn = m_size / 2;
+
+	const std::vector< Cell >& parsedCells = parsedDream->GetCells();
+	m_cells.reserve( parsedCells.size() );
+	m_footprintOffsets.reserve( parsedCells.size() );
+	for ( const Cell& parsedCell : parsedCells )
+	{
+		DreamCell dreamCell( parsedCell );
+
+		//Recolorize cells. Maybe make more robust later?
+		if ( shouldTint )
+		{
+			if ( dreamCell.m_cellType == CELL_TYPE_AIR )
+				dreamCell.m_color = Rgba::BLACK;
+			else
+			{
+				Vector4i modulation = Vector4i( GetRandomIntLessThan( 256 ), 255 );
+				dreamCell.m_color = dreamTint * Rgba( modulation );
+			}
+		}
+
+		m_cells.push_back( dreamCell );
+		m_footprintOffsets.push_back( parsedCell.m_position - m_spawn );
+	}
+
+	delete parsedDream; //Only needed the parse, the layout keeps just what gets swapped.
+}
+
+
+//--------------------------------------------------------------------------------------------------------------
+bool DreamLayout::IsPositionInDream( const Vector2i& dreamPos ) const
+{
+	if ( dreamPos.x < 0 || dreamPos.y < 0 )
+		return false;
+
+	if ( dreamPos.x >= m_size.x || dreamPos.y >= m_size.y )
+		return false;
+
+	return true;
+}
+
+
 //--------------------------------------------------------------------------------------------------------------
 DreamBehavior::DreamBehavior( const XMLNode& behaviorNode )
 	: Behavior( behaviorNode )
 	, m_isDreaming( false )
-	, m_dreamMap( nullptr )
 	, m_dreamTint( s_DEFAULT_DREAM_TINT )
 	, m_maxHealthFractionNeededToActivate( s_DEFAULT_MAX_HEALTH_FRACTION_NEEDED_TO_ACTIVATE )
 	, m_dreamMapSpawnPositionInRealMap( MapPosition::ZERO )
@@ -31,35 +94,20 @@ DreamBehavior::DreamBehavior( const XMLNode& behaviorNode )
 	m_maxHealthFractionNeededToActivate = ReadXMLAttribute( behaviorNode, "maxHealthFractionNeededToActivate", m_maxHealthFractionNeededToActivate );
 
 	m_isDreaming = ( ReadXMLAttribute( behaviorNode, "isDreaming", 0 ) > 0 ) ? true : false;
-	m_dreamMap = Map::CreateFromTileDataStringWithNewlines( mapString, dreamName );
 	m_dreamMapSpawnPositionInRealMap = ReadXMLAttribute( behaviorNode, "dreamMapSpawnPositionInRealMap", MapPosition::ZERO );
 
-	//Recolorize cells. Maybe make more robust later?
-	std::string colorString = s_DEFAULT_DREAM_TINT.ToString();
-	colorString = ReadXMLAttribute( behaviorNode, "color", colorString );
-	sscanf_s( colorString.c_str(), "%hhu,%hhu,%hhu", &m_dreamTint.red, &m_dreamTint.green, &m_dreamTint.blue );
+	m_dreamTint = ReadXMLAttribute( behaviorNode, "color", s_DEFAULT_DREAM_TINT );
 
-	if ( !m_isDreaming )
-	{
-		std::vector< Cell >& dreamCells = m_dreamMap->GetCells();
-		for ( Cell& dreamCell : dreamCells )
-		{
-			if ( dreamCell.m_cellType == CELL_TYPE_AIR )
-				dreamCell.m_color = Rgba::BLACK;
-			else
-			{
-				Vector4i modulation = Vector4i( GetRandomIntLessThan( 256 ), 255 );
-				dreamCell.m_color = m_dreamTint * Rgba( modulation );
-			}
-		}
-	}
+	//A save made mid-dream holds the real map's cells in its text, so those keep their real colors.
+	m_dreamLayout = std::shared_ptr< const DreamLayout >( new DreamLayout( mapString, dreamName, m_dreamTint, !m_isDreaming ) );
 }
 
 
 //--------------------------------------------------------------------------------------------------------------
-DreamBehavior::DreamBehavior( const DreamBehavior& other ) //Has a pointer, needs deep copy.
+DreamBehavior::DreamBehavior( const DreamBehavior& other ) //Shares the layout, copies only the sparse overlay.
 	: Behavior( other )
-	, m_dreamMap( new Map( *other.m_dreamMap ) )
+	, m_dreamLayout( other.m_dreamLayout )
+	, m_swappedDreamCells( other.m_swappedDreamCells )
 	, m_dreamTint( other.m_dreamTint )
 	, m_isDreaming( other.m_isDreaming )
 	, m_maxHealthFractionNeededToActivate( other.m_maxHealthFractionNeededToActivate )
@@ -76,7 +124,8 @@ inline void DreamBehavior::operator=( const Behavior& copyFrom )
 	const Behavior* asPointer = &copyFrom;
 	const DreamBehavior* other = dynamic_cast<const DreamBehavior*>( asPointer );
 
-	m_dreamMap = new Map( *other->m_dreamMap );
+	m_dreamLayout = other->m_dreamLayout;
+	m_swappedDreamCells = other->m_swappedDreamCells;
 	m_dreamTint = other->m_dreamTint;
 	m_isDreaming = other->m_isDreaming;
 	m_maxHealthFractionNeededToActivate = other->m_maxHealthFractionNeededToActivate;
@@ -96,11 +145,50 @@ DreamBehavior::~DreamBehavior()
 			ROADMAP( "Drop Corresponding Item @ m_agent's Pos, Read ItemFactory Name From XML!" );
 		}
 	}
-	if ( m_dreamMap != nullptr )
+	//m_dreamLayout is shared, the last clone holding it frees it.
+}
+
+
+//--------------------------------------------------------------------------------------------------------------
+const DreamCell& DreamBehavior::GetDreamCell( int dreamCellIndex ) const
+{
+	std::map< int, DreamCell >::const_iterator swappedIter = m_swappedDreamCells.find( dreamCellIndex );
+	if ( swappedIter != m_swappedDreamCells.end() )
+		return swappedIter->second;
+
+	return m_dreamLayout->m_cells[ dreamCellIndex ];
+}
+
+
+//--------------------------------------------------------------------------------------------------------------
+void DreamBehavior::SetDreamCell( int dreamCellIndex, const DreamCell& newState )
+{
+	if ( newState == m_dreamLayout->m_cells[ dreamCellIndex ] )
+		m_swappedDreamCells.erase( dreamCellIndex ); //Back in sync with the shared layout, so drop our private copy.
+	else
+		m_swappedDreamCells[ dreamCellIndex ] = newState;
+}
+
+
+//--------------------------------------------------------------------------------------------------------------
+bool DreamBehavior::DoesFootprintOverlapAnotherDream( Map* map ) const
+{
+	for ( const Vector2i& footprintOffset : m_dreamLayout->m_footprintOffsets )
 	{
-		delete m_dreamMap;
-		m_dreamMap = nullptr;
+		Vector2i dreamCellPositionInRealMap = m_dreamMapSpawnPositionInRealMap + footprintOffset;
+
+		if ( !map->IsPositionOnMap( dreamCellPositionInRealMap ) ) //Will be on map for hidden ones, hence below check.
+			continue;
+
+		const Cell& realCell = map->GetCellForPosition( dreamCellPositionInRealMap );
+		if ( realCell.m_isHidden )
+			continue;
+
+		if ( realCell.m_cellType == CELL_TYPE_DREAM )
+			return true;
 	}
+
+	return false;
 }
 
 
@@ -118,31 +206,19 @@ UtilityValue DreamBehavior::CalcUtility()
 	Vector2i displacement = m_agent->GetTargetEnemy()->GetPositionMins() - m_agent->GetPositionMins();
 	Vector2i myAgentDreamMapSpawnPos = GetSpawnInDreamMap();
 	Vector2i playerDreamMapPos = myAgentDreamMapSpawnPos + displacement;
-	if ( !m_dreamMap->IsPositionOnMap( playerDreamMapPos ) )
+	if ( !m_dreamLayout->IsPositionInDream( playerDreamMapPos ) )
 		return NO_UTILITY_VALUE; //Player not yet in range.
 
-	if ( m_dreamMap->IsSolidAtPosition( playerDreamMapPos ) )
+	const DreamCell& playerDreamCell = GetDreamCell( m_dreamLayout->GetIndexForPosition( playerDreamMapPos ) );
+	bool doesFeatureBlock = ( playerDreamCell.m_occupyingFeature != nullptr ) && playerDreamCell.m_occupyingFeature->DoesCurrentlyBlockMovement();
+	if ( doesFeatureBlock || IsTypeSolid( playerDreamCell.m_cellType ) )
 		return NO_UTILITY_VALUE; //Don't spawn player in on a wall.
 
 	//By this point we know we have the player in range and can bring the dream map around them without getting them stuck.
 	//So, check for other dreams already happening around the NPC. If one exists, don't create a new one. 
 	//(Breaks the swapping/saving systems to have 2+ dreams going at once!).
-
-	Map* map = m_agent->GetMap();
-	Vector2i spawnInDreamMap = GetSpawnInDreamMap();
-	for ( Cell& dreamCell : m_dreamMap->GetCells() )
-	{
-		Vector2i displacementInDreamAndRealMap = dreamCell.m_position - spawnInDreamMap;
-		Vector2i dreamCellPositionInRealMap = m_dreamMapSpawnPositionInRealMap + displacementInDreamAndRealMap;
-
-		if ( !map->IsPositionOnMap( dreamCellPositionInRealMap ) //Will be on map for hidden ones, hence below check.
-			 || map->GetCellForPosition( dreamCellPositionInRealMap ).m_isHidden )
-			continue;
-
-		Cell& realCell = map->GetCellForPosition( dreamCellPositionInRealMap );
-		if ( realCell.m_cellType == CELL_TYPE_DREAM )
-			return NO_UTILITY_VALUE; //Stop before we make a big mistake swapping maps with another dream.
-	}
+	if ( DoesFootprintOverlapAnotherDream( m_agent->GetMap() ) )
+		return NO_UTILITY_VALUE; //Stop before we make a big mistake swapping maps with another dream.
 
 	return MIN_UTILITY_VALUE + HIGH_UTILITY_VALUE;
 }
@@ -160,7 +236,7 @@ CooldownSeconds DreamBehavior::Run()
 		g_theConsole->SetTextColor( Rgba::YELLOW );
 		g_theConsole->Printf( "%s draws you into its dream: \"%s\"!",
 							  m_agent->GetName().c_str(),
-							  m_dreamMap->GetMapName().c_str() );
+							  m_dreamLayout->m_name.c_str() );
 		g_theConsole->SetTextColor();
 		g_theConsole->ShowConsole();
 	}
@@ -179,33 +255,17 @@ bool DreamBehavior::OverwriteMap()
 		m_dreamMapSpawnPositionInRealMap = m_agent->GetPositionMins(); //Where the agent was when the dream behavior ran the first time.
 
 	int numItemsLostToDream = 0;
-	Cell tempCell( -Vector2i::ONE );
 	Map* map = m_agent->GetMap();
-	Vector2i spawnInDreamMap = GetSpawnInDreamMap();
 
 	//First, at least for now--if we're starting a swap--test to be sure a dream doesn't already exist there.
-	if ( m_isDreaming )
-	{
-		for ( Cell& dreamCell : m_dreamMap->GetCells() )
-		{
-			Vector2i displacementInDreamAndRealMap = dreamCell.m_position - spawnInDreamMap;
-			Vector2i dreamCellPositionInRealMap = m_dreamMapSpawnPositionInRealMap + displacementInDreamAndRealMap;
-
-			if ( !map->IsPositionOnMap( dreamCellPositionInRealMap ) //Will be on map for hidden ones, hence below check.
-				 || map->GetCellForPosition( dreamCellPositionInRealMap ).m_isHidden )
-				continue;
+	if ( m_isDreaming && DoesFootprintOverlapAnotherDream( map ) )
+		return false; //Stop before we make a big mistake swapping maps with another dream.
 
-			Cell& realCell = map->GetCellForPosition( dreamCellPositionInRealMap );
-			if ( realCell.m_cellType == CELL_TYPE_DREAM )
-				return false; //Stop before we make a big mistake swapping maps with another dream.
-		}
-	}
-
-	//Actual overwriting loop.
-	for ( Cell& dreamCell : m_dreamMap->GetCells() )
+	//Actual overwriting loop. Only cells left differing from the shared layout get written into the overlay.
+	const std::vector< Vector2i >& footprintOffsets = m_dreamLayout->m_footprintOffsets;
+	for ( unsigned int dreamCellIndex = 0; dreamCellIndex < footprintOffsets.size(); dreamCellIndex++ )
 	{
-		Vector2i displacementInDreamAndRealMap = dreamCell.m_position - spawnInDreamMap;
-		Vector2i dreamCellPositionInRealMap = m_dreamMapSpawnPositionInRealMap + displacementInDreamAndRealMap;
+		Vector2i dreamCellPositionInRealMap = m_dreamMapSpawnPositionInRealMap + footprintOffsets[ dreamCellIndex ];
 
 		if ( !map->IsPositionOnMap( dreamCellPositionInRealMap ) //Will be on map for hidden ones, hence below check.
 			 || map->GetCellForPosition( dreamCellPositionInRealMap ).m_isHidden )
@@ -222,17 +282,20 @@ bool DreamBehavior::OverwriteMap()
 			}
 		}
 
-		tempCell = realCell;
+		DreamCell realCellState( realCell );
 		if ( m_isDreaming )
-			tempCell.m_parsedMapGlyph = GetGlyphForCellType( realCell.m_cellType ); //If we save while a dream is laid down, we want to write the correct value out.
-		tempCell.m_position = dreamCell.m_position; //Need it like this so that, when we break the dream, same math above works.
+			realCellState.m_parsedMapGlyph = GetGlyphForCellType( realCell.m_cellType ); //If we save while a dream is laid down, we want to write the correct value out.
+
+		const DreamCell& dreamCell = GetDreamCell( dreamCellIndex );
 		realCell.m_cellType = dreamCell.m_cellType;
 		realCell.m_color = dreamCell.m_color;
 		realCell.m_parsedMapGlyph = dreamCell.m_parsedMapGlyph;
 		realCell.m_occupyingFeature = dreamCell.m_occupyingFeature; //?
-		dreamCell = tempCell;
+		SetDreamCell( dreamCellIndex, realCellState );
 	}
 
+	map->GetHazards().RefreshHazardCells( map ); //Dreams can lay down or wash away lava and water.
+
 	if ( numItemsLostToDream > 0 )
 	{
 		g_theConsole->Printf( "The shattered dream took away %d items with it!", numItemsLostToDream );
@@ -250,10 +313,35 @@ bool DreamBehavior::OverwriteMap()
 //--------------------------------------------------------------------------------------------------------------
 Vector2i DreamBehavior::GetSpawnInDreamMap() const
 {
-	ROADMAP( "Substitute this for an actual given (S)tart tile." );
-		//At that point, just return that location instead of this temp one.
-	
-	return m_dreamMap->GetDimensions() / 2; 
+	return m_dreamLayout->m_spawn;
+}
+
+
+//--------------------------------------------------------------------------------------------------------------
+void DreamBehavior::AppendDreamAsString( FormatBuffer& inout_buffer, int numTabs ) const
+{
+	//Same layout as Map::AppendAsString( buffer, map, true, numTabs ), but reading through the overlay.
+	const Vector2i& dreamSize = m_dreamLayout->m_size;
+	const int numCharsPerRow = numTabs + dreamSize.x + 1;
+	const int numTrailingTabs = ( numTabs > 0 ) ? numTabs - 1 : 0;
+	inout_buffer.Reserve( inout_buffer.GetLength() + 1 + ( numCharsPerRow * dreamSize.y ) + numTrailingTabs );
+
+	inout_buffer.Append( '\n' ); //Start off on the next line after the data element.
+
+	//Iterate strings' rows in reverse, else comes out upside down.
+	for ( int y = dreamSize.y - 1; y >= 0; y-- )
+	{
+		char* row = inout_buffer.Extend( numCharsPerRow );
+		memset( row, '\t', numTabs ); //Start newline with tabbing.
+		row += numTabs;
+
+		for ( int x = 0; x < dreamSize.x; x++ )
+			*row++ = GetDreamCell( m_dreamLayout->GetIndexForPosition( Vector2i( x, y ) ) ).m_parsedMapGlyph;
+
+		*row = '\n';
+	}
+
+	inout_buffer.AppendRepeated( '\t', numTrailingTabs ); //Indent next line normally else it seems to override.
 }
 
 
@@ -263,11 +351,98 @@ void DreamBehavior::WriteToXMLNode( XMLNode& behaviorsNode )
 	Behavior::WriteToXMLNode( behaviorsNode );
 	XMLNode behaviorNode = behaviorsNode.getChildNode( m_name.c_str() );
 
-	WriteXMLAttribute( behaviorNode, "name", m_dreamMap->GetMapName(), s_DEFAULT_DREAM_NAME );
+	WriteXMLAttribute( behaviorNode, "name", m_dreamLayout->m_name, s_DEFAULT_DREAM_NAME );
 	WriteXMLAttribute( behaviorNode, "isDreaming", m_isDreaming ? 1 : 0, 0 );
 	WriteXMLAttribute( behaviorNode, "dreamMapSpawnPositionInRealMap", m_dreamMapSpawnPositionInRealMap, MapPosition::ZERO );
 	WriteXMLAttribute( behaviorNode, "maxHealthFractionNeededToActivate", m_maxHealthFractionNeededToActivate, s_DEFAULT_MAX_HEALTH_FRACTION_NEEDED_TO_ACTIVATE );
 	WriteXMLAttribute( behaviorNode, "color", m_dreamTint, s_DEFAULT_DREAM_TINT );
-	std::string dreamMapAsString = Map::GetAsString( m_dreamMap, true, 5 );
-	behaviorNode.addText( dreamMapAsString.c_str() );
-}
\ No newline at end of file
+	FormatBuffer dreamMapAsString;
+	AppendDreamAsString( dreamMapAsString, 5 );
+	behaviorNode.addText( dreamMapAsString.GetCString() );
+}
+
+
+//--------------------------------------------------------------------------------------------------------------
+void DreamBehavior::WriteToBinary( BinaryWriter& writer ) const
+{
+	writer.Write<bool>( m_isDreaming );
+	writer.Write<int>( m_dreamMapSpawnPositionInRealMap.x );
+	writer.Write<int>( m_dreamMapSpawnPositionInRealMap.y );
+
+	//Just the overlay, rather than AppendDreamAsString(), so the load keeps sharing the template's layout instead of reparsing.
+	writer.Write<uint32_t>( m_swappedDreamCells.size() );
+	for ( const std::pair< const int, DreamCell >& swappedCell : m_swappedDreamCells )
+	{
+		const DreamCell& dreamCell = swappedCell.second;
+		writer.Write<int>( swappedCell.first );
+		writer.Write<byte_t>( (byte_t)dreamCell.m_cellType );
+		writer.Write<char>( dreamCell.m_parsedMapGlyph );
+		writer.Write<byte_t>( dreamCell.m_color.red );
+		writer.Write<byte_t>( dreamCell.m_color.green );
+		writer.Write<byte_t>( dreamCell.m_color.blue );
+		writer.Write<byte_t>( dreamCell.m_color.alphaOpacity );
+		writer.Write<EntityID>( ( dreamCell.m_occupyingFeature != nullptr ) ? dreamCell.m_occupyingFeature->GetEntityID() : 0 );
+	}
+}
+
+
+//--------------------------------------------------------------------------------------------------------------
+void DreamBehavior::PopulateFromBinary( BinaryReader& reader )
+{
+	reader.Read<bool>( &m_isDreaming );
+	reader.Read<int>( &m_dreamMapSpawnPositionInRealMap.x );
+	reader.Read<int>( &m_dreamMapSpawnPositionInRealMap.y );
+
+	m_swappedDreamCells.clear();
+	uint32_t numSwappedCells = 0;
+	reader.Read<uint32_t>( &numSwappedCells );
+	for ( uint32_t swappedCellNum = 0; swappedCellNum < numSwappedCells; swappedCellNum++ )
+	{
+		int dreamCellIndex = 0;
+		byte_t cellTypeAsByte = CELL_TYPE_AIR;
+		EntityID featureID = 0;
+		DreamCell dreamCell;
+		reader.Read<int>( &dreamCellIndex );
+		reader.Read<byte_t>( &cellTypeAsByte );
+		reader.Read<char>( &dreamCell.m_parsedMapGlyph );
+		reader.Read<byte_t>( &dreamCell.m_color.red );
+		reader.Read<byte_t>( &dreamCell.m_color.green );
+		reader.Read<byte_t>( &dreamCell.m_color.blue );
+		reader.Read<byte_t>( &dreamCell.m_color.alphaOpacity );
+		reader.Read<EntityID>( &featureID );
+
+		if ( dreamCellIndex < 0 || dreamCellIndex >= (int)m_dreamLayout->m_cells.size() )
+			continue; //Layout changed since the save.
+
+		dreamCell.m_cellType = (CellType)cellTypeAsByte;
+		dreamCell.m_occupyingFeature = (Feature*)featureID; //TRICK, fix in ResolvePointersToEntities as Agent does.
+		m_swappedDreamCells[ dreamCellIndex ] = dreamCell;
+	}
+}
+
+
+//--------------------------------------------------------------------------------------------------------------
+void DreamBehavior::ResolvePointersToEntities( std::map< EntityID, GameEntity* >& loadedEntities )
+{
+	Map* map = m_agent->GetMap();
+	const std::vector< Vector2i >& footprintOffsets = m_dreamLayout->m_footprintOffsets;
+
+	for ( std::pair< const int, DreamCell >& swappedCell : m_swappedDreamCells )
+	{
+		DreamCell& dreamCell = swappedCell.second;
+		if ( dreamCell.m_occupyingFeature != nullptr )
+		{
+			std::map< EntityID, GameEntity* >::iterator featureIter = loadedEntities.find( (EntityID)dreamCell.m_occupyingFeature );
+			dreamCell.m_occupyingFeature = ( featureIter != loadedEntities.end() ) ? (Feature*)featureIter->second : nullptr;
+		}
+
+		if ( !m_isDreaming || map == nullptr )
+			continue;
+
+		//The terrain section has the dream's cell types, but its colors and features were rebuilt as if it were the real map.
+		const DreamCell& layoutCell = m_dreamLayout->m_cells[ swappedCell.first ];
+		Cell& realCell = map->GetCellForPosition( m_dreamMapSpawnPositionInRealMap + footprintOffsets[ swappedCell.first ] );
+		realCell.m_color = layoutCell.m_color;
+		realCell.m_occupyingFeature = layoutCell.m_occupyingFeature;
+	}
+}
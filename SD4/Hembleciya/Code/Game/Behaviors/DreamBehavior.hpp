@@ -4,17 +4,58 @@
 #include "Game/Behaviors/Behavior.hpp"
 #include "Game/GameCommon.hpp"
 #include "Game/Cell.hpp"
+#include <memory>
+#include <map>
+#include <vector>
 
 
 //-----------------------------------------------------------------------------
+class Feature;
 class Map;
+class FormatBuffer;
+
+
+//-----------------------------------------------------------------------------
+struct DreamCell //The only parts of a Cell that a dream swaps with the real map.
+{
+	DreamCell() : m_cellType( CELL_TYPE_AIR ), m_parsedMapGlyph( CELL_TYPE_AIR ), m_occupyingFeature( nullptr ) {}
+	DreamCell( const Cell& cell ) 
+		: m_cellType( cell.m_cellType )
+		, m_parsedMapGlyph( cell.m_parsedMapGlyph )
+		, m_color( cell.m_color )
+		, m_occupyingFeature( cell.m_occupyingFeature ) 
+	{
+	}
+	bool operator==( const DreamCell& other ) const;
+
+	CellType m_cellType;
+	char m_parsedMapGlyph;
+	Rgba m_color;
+	Feature* m_occupyingFeature;
+};
+
+
+//-----------------------------------------------------------------------------
+struct DreamLayout //Parsed once per NPC template, then shared read-only by every clone's DreamBehavior.
+{
+	DreamLayout( const char* tileDataString, const std::string& dreamName, const Rgba& dreamTint, bool shouldTint );
+
+	bool IsPositionInDream( const Vector2i& dreamPos ) const;
+	int GetIndexForPosition( const Vector2i& dreamPos ) const { return dreamPos.x + ( dreamPos.y * m_size.x ); }
+
+	std::string m_name;
+	Vector2i m_size;
+	Vector2i m_spawn;
+	std::vector< DreamCell > m_cells; //Row-major like Map::m_cells.
+	std::vector< Vector2i > m_footprintOffsets; //Each cell's displacement from m_spawn, precomputed for the per-turn overlap test.
+};
 
 
 //-----------------------------------------------------------------------------
 class DreamBehavior : public Behavior
 {
 	DreamBehavior( const XMLNode& behaviorNode );
-	DreamBehavior( const DreamBehavior& other ); //Has a pointer, needs deep copy.
+	DreamBehavior( const DreamBehavior& other ); //Shares the layout, copies only the sparse overlay.
 	~DreamBehavior();
 	virtual inline void operator=( const Behavior& other ) override;
 
@@ -24,15 +65,23 @@ class DreamBehavior : public Behavior
 	virtual CooldownSeconds Run() override;
 
 	bool OverwriteMap();
+	bool DoesFootprintOverlapAnotherDream( Map* map ) const;
+	const DreamCell& GetDreamCell( int dreamCellIndex ) const;
+	void SetDreamCell( int dreamCellIndex, const DreamCell& newState );
+	void AppendDreamAsString( FormatBuffer& inout_buffer, int numTabs ) const;
 
 	virtual Behavior* CreateClone() const override { return new DreamBehavior( *this );	}
 	virtual void WriteToXMLNode( XMLNode& behaviorsNode ) override;
+	virtual void WriteToBinary( BinaryWriter& writer ) const override;
+	virtual void PopulateFromBinary( BinaryReader& reader ) override;
+	virtual void ResolvePointersToEntities( std::map< EntityID, GameEntity* >& loadedEntities ) override;
 
 	Vector2i GetSpawnInDreamMap() const;
 
 	bool m_isDreaming;
 	float m_maxHealthFractionNeededToActivate;
-	Map* m_dreamMap;
+	std::shared_ptr< const DreamLayout > m_dreamLayout;
+	std::map< int, DreamCell > m_swappedDreamCells; //Sparse copy-on-write overlay: only cells differing from m_dreamLayout.
 	Rgba m_dreamTint;
 	MapPosition m_dreamMapSpawnPositionInRealMap; //Where the agent was when the dream behavior ran the first time.
 		//The agent may move around before it gets broken, so map restore can't use its position. Need this.
@@ -44,7 +93,7 @@ class DreamBehavior : public Behavior
 };
 
 /*
-	Read the below into a map stored on this DreamBehavior via m_dreamMap = Map::Initialize( behaviorNode.getText() );
+	Read the below into a DreamLayout shared by all clones of the template, with swapped cells kept in m_swappedDreamCells.
 		For CalcUtility(), check if targetEnemy is the player, if so,
 			if m_targetEnemy.position - agent.position
 			else return zero.
@@ -1,5 +1,7 @@
 #include "Game/Behaviors/WanderBehavior.hpp"
 #include "Engine/FileUtils/XMLUtils.hpp"
+#include "Engine/FileUtils/Writers/BinaryWriter.hpp"
+#include "Engine/FileUtils/Readers/BinaryReader.hpp"
 #include "Engine/Math/MathUtils.hpp"
 #include "Engine/Core/TheConsole.hpp"
 #include "Game/Agent.hpp"
@@ -70,3 +72,19 @@ void WanderBehavior::WriteToXMLNode( XMLNode& behaviorsNode )
 	WriteXMLAttribute( behaviorNode, "chanceToGoStraight", m_chanceToGoStraight, s_DEFAULT_CHANCE_TO_GO_STRAIGHT );
 	WriteXMLAttribute( behaviorNode, "chanceToRest", m_chanceToRest, s_DEFAULT_CHANCE_TO_REST );
 }
+
+
+//--------------------------------------------------------------------------------------------------------------
+void WanderBehavior::WriteToBinary( BinaryWriter& writer ) const
+{
+	writer.Write<int>( (int)m_currentDirection ); //Else a loaded NPC would head off in its blueprint template's direction.
+}
+
+
+//--------------------------------------------------------------------------------------------------------------
+void WanderBehavior::PopulateFromBinary( BinaryReader& reader )
+{
+	int directionAsInt = (int)m_currentDirection;
+	reader.Read<int>( &directionAsInt );
+	m_currentDirection = (MapDirection)directionAsInt;
+}
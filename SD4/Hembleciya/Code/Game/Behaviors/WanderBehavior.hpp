@@ -15,6 +15,8 @@ class WanderBehavior : public Behavior
 	virtual CooldownSeconds Run() override;
 	virtual Behavior* CreateClone() const override { return new WanderBehavior( *this ); }
 	virtual void WriteToXMLNode( XMLNode& behaviorsNode ) override;
+	virtual void WriteToBinary( BinaryWriter& writer ) const override;
+	virtual void PopulateFromBinary( BinaryReader& reader ) override;
 
 	MapDirection m_currentDirection;
 	float m_chanceToGoStraight;
@@ -8,6 +8,7 @@
 #include "Engine/Error/ErrorWarningAssert.hpp"
 #include "Game/Map.hpp"
 #include "Engine/FileUtils/XMLUtils.hpp"
+#include "Engine/Time/Profiler.hpp"
 
 //--------------------------------------------------------------------------------------------------------------
 STATIC std::map< std::string, BiomeBlueprint* > BiomeBlueprint::s_loadedBiomeBlueprintsRegistry = std::map< std::string, BiomeBlueprint* >();
@@ -38,29 +39,23 @@ BiomeBlueprint::~BiomeBlueprint()
 
 
 //--------------------------------------------------------------------------------------------------------------
-STATIC void BiomeBlueprint::LoadAllBiomeBlueprints()
+STATIC void BiomeBlueprint::LoadBiomeBlueprintFromXML( const char* xmlFilename, const XMLNode& blueprintRoot )
 {
-	std::vector< std::string > m_biomeFiles = EnumerateFilesInDirectory( "Data/XML/Biomes", "*.Biome.xml" );
-
-	for ( unsigned int biomeBlueprintIndex = 0; biomeBlueprintIndex < m_biomeFiles.size(); biomeBlueprintIndex++ )
-	{
-		const char* xmlFilename = m_biomeFiles[ biomeBlueprintIndex ].c_str();
-		XMLNode blueprintRoot = XMLNode::openFileHelper( xmlFilename, "BiomeBlueprint" );
-		
-		BiomeBlueprint* newBiomeBlueprint = new BiomeBlueprint( blueprintRoot );
-		GetBiomeNameFromXML( xmlFilename, blueprintRoot, newBiomeBlueprint->m_name );
-		
-		if ( s_loadedBiomeBlueprintsRegistry.find( newBiomeBlueprint->m_name ) != s_loadedBiomeBlueprintsRegistry.end() )
-			ERROR_AND_DIE( Stringf( "Found duplicate Biome name %s in LoadBiomeBlueprints!", newBiomeBlueprint->m_name.c_str() ) );
-		
-		s_loadedBiomeBlueprintsRegistry.insert( std::pair< std::string, BiomeBlueprint* >( newBiomeBlueprint->m_name, newBiomeBlueprint ) );
-	}
+	BiomeBlueprint* newBiomeBlueprint = new BiomeBlueprint( blueprintRoot );
+	GetBiomeNameFromXML( xmlFilename, blueprintRoot, newBiomeBlueprint->m_name );
+	
+	if ( s_loadedBiomeBlueprintsRegistry.find( newBiomeBlueprint->m_name ) != s_loadedBiomeBlueprintsRegistry.end() )
+		ERROR_AND_DIE( Stringf( "Found duplicate Biome name %s in LoadBiomeBlueprints!", newBiomeBlueprint->m_name.c_str() ) );
+	
+	s_loadedBiomeBlueprintsRegistry.insert( std::pair< std::string, BiomeBlueprint* >( newBiomeBlueprint->m_name, newBiomeBlueprint ) );
 }
 
 
 //--------------------------------------------------------------------------------------------------------------
 Map* BiomeBlueprint::InitializeBlueprint()
 {
+	PROFILE_SCOPE( "BiomeBlueprint::InitializeBlueprint" );
+
 	if ( m_processes.size() == 0 )
 		ERROR_AND_DIE( "Called InitializeBlueprint() before pushing any processes!\nPlease ensure generator= name matches a GeneratorRegistration name!" );
 
@@ -76,6 +71,8 @@ Map* BiomeBlueprint::InitializeBlueprint()
 //--------------------------------------------------------------------------------------------------------------
 bool BiomeBlueprint::FullyGenerateBlueprint( Map* map )
 {
+	PROFILE_SCOPE( "BiomeBlueprint::FullyGenerateBlueprint" );
+
 	bool success = false;
 
 	for ( BiomeGenerationProcess* process : m_processes )
@@ -85,6 +82,7 @@ bool BiomeBlueprint::FullyGenerateBlueprint( Map* map )
 		
 		for ( int& currentStep = map->GetCurrentGeneratorStepNum(); currentStep <= process->m_numGeneratorSteps; currentStep++ )
 		{
+			PROFILE_SCOPE( "Generator::GenerateOneStep" );
 			success = m_currentActiveGenerator->GenerateOneStep( map, currentStep, process );
 			if ( !success )
 				DebuggerPrintf( "%s::GenerateStep returned false for map %s, step %d!",
@@ -108,6 +106,8 @@ bool BiomeBlueprint::FullyGenerateBlueprint( Map* map )
 //--------------------------------------------------------------------------------------------------------------
 bool BiomeBlueprint::PartiallyGenerateBlueprint( Map* map, bool areStepsInfinite )
 {
+	PROFILE_SCOPE( "BiomeBlueprint::PartiallyGenerateBlueprint" );
+
 	bool success = false;
 
 	if ( m_currentActiveProcess < 0 || m_currentActiveProcess >= m_processes.size() )
@@ -177,9 +177,7 @@ void BiomeBlueprint::PreviousProcess()
 //--------------------------------------------------------------------------------------------------------------
 void BiomeBlueprint::PopulateFromXMLNode( const XMLNode& blueprintNode )
 {
-	std::string sizeString;
-	sizeString = ReadXMLAttribute( blueprintNode, "size", sizeString );
-	sscanf_s( sizeString.c_str(), "%d,%d", &m_size.x, &m_size.y );
+	m_size = ReadXMLAttribute( blueprintNode, "size", m_size );
 
 	for ( int i = 0; i < blueprintNode.nChildNode(); )
 	{
@@ -21,10 +21,8 @@ public:
 	}
 	~BiomeBlueprint();
 
-	static void LoadAllBiomeBlueprints(); //ALL the level has to call, because this fixes the directory to load from and loads all from "Data/Environments", etc.
-		//Ask engine for all the files in a preordained relative directory (the active working directory).
-		//Use OpenXMLDocument, construct the new blueprint, and store it in a static registry like textures.
-		//Now Game code doesn't have to tell everything to load this and that--this function grabs it all at once.
+	static void LoadBiomeBlueprintFromXML( const char* xmlFilename, const XMLNode& blueprintRoot ); //BlueprintCache finds the files and hands each root here.
+		//Constructs the new blueprint and stores it in a static registry like textures.
 		//And this doesn't actually create the generators yet--could be 300 of them--just lightweight GenerationProcesses into m_procs through GenRegistrations.
 	static bool ClearRegistry()
 	{
@@ -10,5 +10,5 @@ const char* BiomeGenerationProcess::STEPS_ATTRIBUTE_NAME = "steps";
 BiomeGenerationProcess::BiomeGenerationProcess( const XMLNode& generationProcessNode )
 {
 	m_generatorName = ReadXMLAttribute( generationProcessNode, GENERATOR_ATTRIBUTE_NAME, m_generatorName );
-	sscanf_s( generationProcessNode.getAttribute( STEPS_ATTRIBUTE_NAME ), "%d", &m_numGeneratorSteps );
+	m_numGeneratorSteps = ReadXMLAttribute( generationProcessNode, STEPS_ATTRIBUTE_NAME, 0 );
 }
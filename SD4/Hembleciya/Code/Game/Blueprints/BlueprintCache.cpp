@@ -0,0 +1,238 @@
+#include "Game/Blueprints/BlueprintCache.hpp"
+
+#include "Engine/FileUtils/FileUtils.hpp"
+#include "Engine/FileUtils/Compression.hpp"
+#include "Engine/FileUtils/Writers/BufferBinaryWriter.hpp"
+#include "Engine/FileUtils/Readers/BufferBinaryReader.hpp"
+#include "Engine/Time/Profiler.hpp"
+#include "Engine/Time/Time.hpp"
+
+#include "Game/Biomes/BiomeBlueprint.hpp"
+#include "Game/FactionSystem.hpp"
+#include "Game/Items/ItemFactory.hpp"
+#include "Game/NPCs/NPCFactory.hpp"
+#include "Game/Features/FeatureFactory.hpp"
+
+
+//--------------------------------------------------------------------------------------------------------------
+STATIC const char* BlueprintCache::s_CACHE_FILE_PATH = "Data/XML/Blueprints.Cache.bin";
+STATIC const char BlueprintCache::s_MAGIC[ 4 ] = { 'H', 'M', 'B', 'P' };
+STATIC const uint32_t BlueprintCache::s_VERSION = 1;
+STATIC bool BlueprintCache::s_wasLastLoadFromCache = false;
+STATIC double BlueprintCache::s_lastLoadSeconds = 0.0;
+
+
+//--------------------------------------------------------------------------------------------------------------
+struct BlueprintKindInfo
+{
+	const char* m_directory;
+	const char* m_filePattern;
+	const char* m_rootTag;
+};
+static const BlueprintKindInfo s_BLUEPRINT_KIND_INFOS[ NUM_BLUEPRINT_KINDS ] =
+{
+	{ "Data/XML/Biomes", "*.Biome.xml", "BiomeBlueprint" },
+	{ "Data/XML/Factions", "*.Faction.xml", "Factions" },
+	{ "Data/XML/Items", "*.Item.xml", "ItemBlueprints" },
+	{ "Data/XML/NPCs", "*.NPC.xml", "NPCBlueprints" },
+	{ "Data/XML/Features", "*.Feature.xml", "FeatureBlueprints" }
+};
+
+
+//--------------------------------------------------------------------------------------------------------------
+STATIC void BlueprintCache::LoadAllBlueprints()
+{
+	PROFILE_SCOPE( "BlueprintCache::LoadAllBlueprints" );
+	double startSeconds = GetCurrentTimeSeconds();
+
+	BlueprintCache cache;
+	s_wasLastLoadFromCache = cache.ReadFromFile( s_CACHE_FILE_PATH );
+	if ( !s_wasLastLoadFromCache )
+		cache.ParseSourceFiles();
+
+	if ( ( !s_wasLastLoadFromCache || cache.m_hasStaleTimestamps ) && !cache.WriteToFile( s_CACHE_FILE_PATH ) )
+		DebuggerPrintf( "BlueprintCache failed to write %s, the next launch will parse the XML again.\n", s_CACHE_FILE_PATH );
+
+	cache.RegisterBlueprints();
+
+	s_lastLoadSeconds = GetCurrentTimeSeconds() - startSeconds;
+	DebuggerPrintf( "BlueprintCache loaded %u blueprint files from %s in %.3f ms.\n",
+					cache.GetNumSourceFiles(), s_wasLastLoadFromCache ? "the cache" : "XML", s_lastLoadSeconds * 1000.0 );
+}
+
+
+//--------------------------------------------------------------------------------------------------------------
+STATIC bool BlueprintCache::FindSourceFiles( std::vector< BlueprintSourceFile >& out_sourceFiles )
+{
+	out_sourceFiles.clear();
+
+	for ( int kindIndex = 0; kindIndex < NUM_BLUEPRINT_KINDS; kindIndex++ )
+	{
+		const BlueprintKindInfo& kindInfo = s_BLUEPRINT_KIND_INFOS[ kindIndex ];
+		std::vector< std::string > filePaths = EnumerateFilesInDirectory( kindInfo.m_directory, kindInfo.m_filePattern );
+
+		for ( const std::string& filePath : filePaths )
+		{
+			BlueprintSourceFile sourceFile;
+			sourceFile.m_kind = (BlueprintKind)kindIndex;
+			sourceFile.m_path = filePath;
+
+			size_t numBytes;
+			if ( !GetFileModifiedTimeAndSize( filePath, sourceFile.m_modifiedTime, numBytes ) )
+				return false;
+			sourceFile.m_numBytes = (uint32_t)numBytes;
+
+			out_sourceFiles.push_back( sourceFile );
+		}
+	}
+
+	return true;
+}
+
+
+//--------------------------------------------------------------------------------------------------------------
+STATIC bool BlueprintCache::HashSourceFile( const std::string& path, uint32_t& out_contentHash )
+{
+	std::vector< unsigned char > fileBytes;
+	if ( !LoadBinaryFileIntoBuffer( path, fileBytes ) )
+		return false;
+
+	out_contentHash = CalcBlockChecksum( fileBytes.data(), fileBytes.size() );
+	return true;
+}
+
+
+//--------------------------------------------------------------------------------------------------------------
+void BlueprintCache::ParseSourceFiles()
+{
+	PROFILE_SCOPE( "BlueprintCache::ParseSourceFiles" );
+
+	m_hasStaleTimestamps = false;
+	FindSourceFiles( m_sourceFiles );
+
+	for ( BlueprintSourceFile& sourceFile : m_sourceFiles )
+	{
+		HashSourceFile( sourceFile.m_path, sourceFile.m_contentHash );
+
+		const char* rootTag = s_BLUEPRINT_KIND_INFOS[ sourceFile.m_kind ].m_rootTag;
+		if ( !ParseXMLFileWithPullReader( sourceFile.m_path, rootTag, sourceFile.m_root ) )
+			ERROR_AND_DIE( Stringf( "BlueprintCache failed to parse <%s> from %s, see the output window for where.", rootTag, sourceFile.m_path.c_str() ) );
+	}
+}
+
+
+//--------------------------------------------------------------------------------------------------------------
+void BlueprintCache::WriteToBuffer( BufferBinaryWriter& writer ) const
+{
+	writer.WriteBytes( s_MAGIC, sizeof( s_MAGIC ) );
+	writer.Write< uint32_t >( s_VERSION );
+
+	//The whole source table comes first, so a stale cache is rejected before any tree is rebuilt.
+	writer.Write< uint32_t >( m_sourceFiles.size() );
+	for ( const BlueprintSourceFile& sourceFile : m_sourceFiles )
+	{
+		writer.Write< uint8_t >( (uint8_t)sourceFile.m_kind );
+		writer.WriteString( sourceFile.m_path.c_str() );
+		writer.Write< int64_t >( sourceFile.m_modifiedTime );
+		writer.Write< uint32_t >( sourceFile.m_numBytes );
+		writer.Write< uint32_t >( sourceFile.m_contentHash );
+	}
+
+	for ( const BlueprintSourceFile& sourceFile : m_sourceFiles )
+		WriteXMLNodeToBinary( writer, sourceFile.m_root );
+}
+
+
+//--------------------------------------------------------------------------------------------------------------
+bool BlueprintCache::WriteToFile( const std::string& cachePath ) const
+{
+	PROFILE_SCOPE( "BlueprintCache::WriteToFile" );
+
+	BufferBinaryWriter writer;
+	WriteToBuffer( writer );
+	return SaveBufferToBinaryFileAtomically( cachePath, writer.GetBuffer() );
+}
+
+
+//--------------------------------------------------------------------------------------------------------------
+bool BlueprintCache::ReadFromFile( const std::string& cachePath )
+{
+	PROFILE_SCOPE( "BlueprintCache::ReadFromFile" );
+
+	m_sourceFiles.clear();
+	m_hasStaleTimestamps = false;
+
+	std::vector< BlueprintSourceFile > currentSourceFiles;
+	if ( !FindSourceFiles( currentSourceFiles ) )
+		return false;
+
+	std::vector< unsigned char > cacheBytes;
+	if ( !LoadBinaryFileIntoBuffer( cachePath, cacheBytes ) || cacheBytes.empty() )
+		return false;
+	BufferBinaryReader reader( cacheBytes.data(), cacheBytes.size() );
+
+	char magic[ 4 ];
+	uint32_t version = 0;
+	uint32_t numSourceFiles = 0;
+	reader.ReadBytes( magic, sizeof( magic ) );
+	reader.Read< uint32_t >( &version );
+	reader.Read< uint32_t >( &numSourceFiles );
+	if ( reader.DidOverrun() || memcmp( magic, s_MAGIC, sizeof( magic ) ) != 0 || version != s_VERSION || numSourceFiles != currentSourceFiles.size() )
+		return false; //Also catches any blueprint file added or removed.
+
+	for ( BlueprintSourceFile& currentFile : currentSourceFiles )
+	{
+		uint8_t cachedKind = NUM_BLUEPRINT_KINDS;
+		std::string cachedPath;
+		int64_t cachedModifiedTime = 0;
+		uint32_t cachedNumBytes = 0;
+		reader.Read< uint8_t >( &cachedKind );
+		reader.ReadString( cachedPath );
+		reader.Read< int64_t >( &cachedModifiedTime );
+		reader.Read< uint32_t >( &cachedNumBytes );
+		reader.Read< uint32_t >( &currentFile.m_contentHash );
+
+		if ( reader.DidOverrun() || cachedKind != currentFile.m_kind || cachedPath != currentFile.m_path || cachedNumBytes != currentFile.m_numBytes )
+			return false;
+
+		if ( cachedModifiedTime != currentFile.m_modifiedTime )
+		{
+			uint32_t currentContentHash;
+			if ( !HashSourceFile( currentFile.m_path, currentContentHash ) || currentContentHash != currentFile.m_contentHash )
+				return false;
+			m_hasStaleTimestamps = true;
+		}
+	}
+
+	for ( BlueprintSourceFile& currentFile : currentSourceFiles )
+	{
+		if ( !ReadXMLNodeFromBinary( reader, currentFile.m_root ) || reader.DidOverrun() )
+		{
+			DebuggerPrintf( "BlueprintCache found %s corrupt, rebuilding it from XML.\n", cachePath.c_str() );
+			return false;
+		}
+	}
+
+	m_sourceFiles.swap( currentSourceFiles );
+	return true;
+}
+
+
+//--------------------------------------------------------------------------------------------------------------
+void BlueprintCache::RegisterBlueprints() const
+{
+	PROFILE_SCOPE( "BlueprintCache::RegisterBlueprints" );
+
+	for ( const BlueprintSourceFile& sourceFile : m_sourceFiles ) //Sorted by kind already, so factions and items precede the NPCs that use them.
+	{
+		switch ( sourceFile.m_kind )
+		{
+		case BLUEPRINT_KIND_BIOME: BiomeBlueprint::LoadBiomeBlueprintFromXML( sourceFile.m_path.c_str(), sourceFile.m_root ); break;
+		case BLUEPRINT_KIND_FACTION: Faction::LoadFactionsFromXML( sourceFile.m_root ); break;
+		case BLUEPRINT_KIND_ITEM: ItemFactory::LoadItemBlueprintsFromXML( sourceFile.m_root ); break;
+		case BLUEPRINT_KIND_NPC: NPCFactory::LoadNPCBlueprintsFromXML( sourceFile.m_root ); break;
+		case BLUEPRINT_KIND_FEATURE: FeatureFactory::LoadFeatureBlueprintsFromXML( sourceFile.m_root ); break;
+		default: ERROR_AND_DIE( "BlueprintCache::RegisterBlueprints found an unknown BlueprintKind!" );
+		}
+	}
+}
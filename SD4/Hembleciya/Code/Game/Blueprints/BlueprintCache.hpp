@@ -0,0 +1,76 @@
+#pragma once
+
+
+#include "Game/GameCommon.hpp"
+#include "Engine/FileUtils/XMLUtils.hpp"
+#include <string>
+#include <vector>
+
+
+//-----------------------------------------------------------------------------
+class BufferBinaryWriter;
+
+
+//-----------------------------------------------------------------------------
+enum BlueprintKind //Also the load order, see TheGame::Startup. Stored in the cache: append only.
+{
+	BLUEPRINT_KIND_BIOME,
+	BLUEPRINT_KIND_FACTION,
+	BLUEPRINT_KIND_ITEM,
+	BLUEPRINT_KIND_NPC,
+	BLUEPRINT_KIND_FEATURE,
+	NUM_BLUEPRINT_KINDS
+};
+
+
+//-----------------------------------------------------------------------------
+struct BlueprintSourceFile
+{
+	BlueprintSourceFile() : m_kind( NUM_BLUEPRINT_KINDS ), m_modifiedTime( 0 ), m_numBytes( 0 ), m_contentHash( 0 ) {}
+
+	BlueprintKind m_kind;
+	std::string m_path;
+	int64_t m_modifiedTime;
+	uint32_t m_numBytes;
+	uint32_t m_contentHash; //Only checked once the timestamp moves, e.g. after a checkout that left the contents alone.
+	XMLNode m_root; //The element named by the kind's root tag, parsed from m_path or rebuilt from the cache.
+};
+
+
+//-----------------------------------------------------------------------------
+// Every blueprint XML file's element tree, kept in one binary file so later launches read that once and skip
+// opening and lexing each XML file. Keyed on each source's timestamp, size, and content hash, so editing,
+// adding, or removing any blueprint file rebuilds the cache from the XML on the next launch.
+// The trees, not the built blueprints, are cached: generator processes and behaviors only know how to build themselves from XML.
+//-----------------------------------------------------------------------------
+class BlueprintCache
+{
+public:
+	BlueprintCache() : m_hasStaleTimestamps( false ) {}
+
+	static void LoadAllBlueprints(); //Fills every blueprint registry, from the cache if it's current, else from XML and rewrites it.
+	static bool WasLastLoadFromCache() { return s_wasLastLoadFromCache; }
+	static double GetLastLoadSeconds() { return s_lastLoadSeconds; }
+
+	void ParseSourceFiles(); //Streams each file through XMLPullReader into its tree. Dies on malformed XML, as openFileHelper always has.
+	bool ReadFromFile( const std::string& cachePath ); //False if missing, corrupt, or any source changed.
+	bool WriteToFile( const std::string& cachePath ) const;
+	void WriteToBuffer( BufferBinaryWriter& writer ) const;
+	void RegisterBlueprints() const; //Hands each root to its kind's loader, in BlueprintKind order.
+	unsigned int GetNumSourceFiles() const { return m_sourceFiles.size(); }
+
+	static const char* s_CACHE_FILE_PATH;
+
+
+private:
+	static bool FindSourceFiles( std::vector< BlueprintSourceFile >& out_sourceFiles ); //Timestamps and sizes only, no reads.
+	static bool HashSourceFile( const std::string& path, uint32_t& out_contentHash );
+
+	std::vector< BlueprintSourceFile > m_sourceFiles;
+	bool m_hasStaleTimestamps; //Some source's time moved but its hash matched, rewrite so next launch needn't hash it.
+
+	static const char s_MAGIC[ 4 ];
+	static const uint32_t s_VERSION;
+	static bool s_wasLastLoadFromCache;
+	static double s_lastLoadSeconds;
+};
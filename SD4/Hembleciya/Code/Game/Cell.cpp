@@ -75,7 +75,7 @@ void Cell::SetHasBeenSeenBefore()
 
 
 //--------------------------------------------------------------------------------------------------------------
-std::vector< Item* >& Cell::GetItems()
+const InventoryItemList& Cell::GetItems() const
 {
 	return m_occupyingItems->GetItems();
 }
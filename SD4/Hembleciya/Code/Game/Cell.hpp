@@ -3,11 +3,10 @@
 #include "Engine/Math/Vector2.hpp"
 #include "Engine/Renderer/Rgba.hpp"
 #include "Game/GameCommon.hpp"
+#include "Game/Inventory.hpp" //For InventoryItemList.
 
 
 //-----------------------------------------------------------------------------
-class Inventory;
-class Item;
 class Feature;
 
 
@@ -50,7 +49,7 @@ public:
 	bool HasBeenSeenBefore() const { return m_hasBeenSeenBefore; }
 	bool m_isHidden; //Will never be seen, e.g. because it's surrounded by solid cells.
 
-	std::vector< Item* >& GetItems();
+	const InventoryItemList& GetItems() const;
 	bool HasItems() const { return HasMoreItemsThan( 0 ); }
 	bool HasMoreItemsThan( unsigned int amount ) const;
 	void PushItem( Item* item ); //Forbids duplicates.
@@ -6,6 +6,7 @@
 #include "Engine/Audio/TheAudio.hpp"
 #include "Game/FactionSystem.hpp"
 #include "Engine/Core/TheConsole.hpp"
+#include "Engine/Time/Profiler.hpp"
 
 
 //--------------------------------------------------------------------------------------------------------------
@@ -54,13 +55,15 @@ STATIC void CombatSystem::PlayHurtSound( Agent* victim )
 //--------------------------------------------------------------------------------------------------------------
 STATIC void CombatSystem::PerformAttack( AttackData& attackData )
 {
+	PROFILE_SCOPE( "CombatSystem::PerformAttack" );
+
 	if ( GetRandomChance( attackData.chanceToHit ) == false )
 	{
 		if ( attackData.target->IsCurrentlySeen() || attackData.instigator->IsCurrentlySeen() )
 			if ( attackData.instigator->IsPlayer() )
-				g_theConsole->Printf( "Your attack missed %s!", attackData.target->GetName().c_str() );
+				g_theConsole->Format( CHECKED_FORMAT( "Your attack missed {}!", attackData.target->GetName() ) );
 			else
-				g_theConsole->Printf( "The attack by %s missed!", attackData.instigator->GetName().c_str() );
+				g_theConsole->Format( CHECKED_FORMAT( "The attack by {} missed!", attackData.instigator->GetName() ) );
 		attackData.didAttackHit = false;
 		attackData.damageDealt = 0;
 		return;
@@ -68,8 +71,8 @@ STATIC void CombatSystem::PerformAttack( AttackData& attackData )
 
 	if ( attackData.target->IsPlayer() && attackData.target->IsInvincible() )
 	{
-		g_theConsole->Printf( "The attack by %s bounces off you like it was nothing.",
-							  attackData.instigator->GetName().c_str() );
+		g_theConsole->Format( CHECKED_FORMAT( "The attack by {} bounces off you like it was nothing.",
+							  attackData.instigator->GetName() ) );
 		g_theConsole->ShowConsole();
 
 		attackData.didAttackHit = false;
@@ -102,7 +105,7 @@ STATIC void CombatSystem::PerformAttack( AttackData& attackData )
 	{
 		attackData.damageDealt = static_cast<int>( attackData.target->GetHealth() ) - 1;
 		if ( isPlayerAndHealthy || attackData.target->IsCurrentlySeen() )
-			g_theConsole->Printf( "Fatal attack survived, 1 health left!" );
+			g_theConsole->Print( "Fatal attack survived, 1 health left!" );
 	}
 
 	//Actually apply damage.
@@ -123,10 +126,10 @@ void CombatSystem::ReportAttackResult( AttackData &attackData )
 	//Note the player is not marked visible.
 	if ( attackData.instigator->IsCurrentlySeen() && attackData.target->IsCurrentlySeen() )
 	{
-		g_theConsole->Printf( "%s hits %s for %d damage!",
-								  attackData.instigator->GetName().c_str(),
-								  attackData.target->GetName().c_str(),
-								  attackData.damageDealt );
+		g_theConsole->Format( CHECKED_FORMAT( "{} hits {} for {} damage!",
+								  attackData.instigator->GetName(),
+								  attackData.target->GetName(),
+								  attackData.damageDealt ) );
 
 		PlayAttackSound( attackData.instigator );
 		PlayHurtSound( attackData.target );
@@ -137,15 +140,15 @@ void CombatSystem::ReportAttackResult( AttackData &attackData )
 		{
 			if ( attackData.instigator->IsPlayer() )
 			{
-				g_theConsole->Printf( "You hit %s for %d damage!",
-												  attackData.target->GetName().c_str(),
-												  attackData.damageDealt );
+				g_theConsole->Format( CHECKED_FORMAT( "You hit {} for {} damage!",
+												  attackData.target->GetName(),
+												  attackData.damageDealt ) );
 			}
 			else if ( !attackData.target->IsPlayer() ) //Player message handled below.
 			{
-				g_theConsole->Printf( "%s hits for %d damage!",
-													attackData.instigator->GetName().c_str(),
-													attackData.damageDealt );
+				g_theConsole->Format( CHECKED_FORMAT( "{} hits for {} damage!",
+													attackData.instigator->GetName(),
+													attackData.damageDealt ) );
 			}
 			PlayAttackSound( attackData.instigator );
 		}
@@ -153,15 +156,15 @@ void CombatSystem::ReportAttackResult( AttackData &attackData )
 		{
 			if ( attackData.target->IsPlayer() )
 			{
-				g_theConsole->Printf( "You were hit by %s for %d damage!",
-									  attackData.instigator->GetName().c_str(),
-									  attackData.damageDealt );
+				g_theConsole->Format( CHECKED_FORMAT( "You were hit by {} for {} damage!",
+									  attackData.instigator->GetName(),
+									  attackData.damageDealt ) );
 			}
 			else if ( !attackData.instigator->IsPlayer() ) //Player message handled above.
 			{
-				g_theConsole->Printf( "%s was hit for %d damage!",
-											attackData.target->GetName().c_str(),
-											attackData.damageDealt );
+				g_theConsole->Format( CHECKED_FORMAT( "{} was hit for {} damage!",
+											attackData.target->GetName(),
+											attackData.damageDealt ) );
 			}
 			PlayHurtSound( attackData.target );
 		}
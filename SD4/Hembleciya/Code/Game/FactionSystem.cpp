@@ -1,11 +1,13 @@
 #include "Game/FactionSystem.hpp"
 #include "Engine/FileUtils/FileUtils.hpp"
 #include "Engine/FileUtils/XMLUtils.hpp"
+#include "Engine/FileUtils/Writers/BinaryWriter.hpp"
+#include "Engine/FileUtils/Readers/BinaryReader.hpp"
 #include "Game/Agent.hpp"
 
 
 //--------------------------------------------------------------------------------------------------------------
-STATIC std::map< std::string, Faction* > Faction::s_factionRegistry;
+STATIC NameMap< Faction* > Faction::s_factionRegistry;
 STATIC FactionID Faction::s_BASE_FACTION_ID = 1;
 STATIC float Faction::s_EXTRAPOLATION_RATIO = .3f; //How much a between-agents status delta alters the agent's view of the other's Faction overall.
 
@@ -24,11 +26,23 @@ float Faction::CalcExtrapolationRatio( FactionID instigatorFaction )
 
 
 //--------------------------------------------------------------------------------------------------------------
-STATIC std::string Faction::GetNameForFactionID( FactionID factionID )
+struct FactionWithIDFinder //The registry is keyed by name, so a lookup by ID visits every entry.
 {
-	for ( std::pair< const std::string, Faction* >& faction : s_factionRegistry )
-		if ( faction.second->GetID() == factionID )
-			return faction.second->GetName();
+	FactionWithIDFinder( FactionID factionID ) : m_factionID( factionID ), m_found( nullptr ) {}
+	void operator()( NameID /*nameID*/, Faction* faction ) { if ( faction->GetID() == m_factionID ) m_found = faction; }
+
+	FactionID m_factionID;
+	Faction* m_found;
+};
+
+
+//--------------------------------------------------------------------------------------------------------------
+STATIC Name Faction::GetNameForFactionID( FactionID factionID )
+{
+	FactionWithIDFinder finder( factionID );
+	s_factionRegistry.ForEach( finder );
+	if ( finder.m_found != nullptr )
+		return finder.m_found->m_name;
 	
 	ERROR_AND_DIE( "Did not find faction in global registry! Verify it's in Faction or NPC XML files?" );
 }
@@ -55,16 +69,19 @@ void Faction::RemoveRelationsWithEntity( const Agent* agentToRemove )
 void Faction::ResolvePointersToEntities( std::map< EntityID, GameEntity* >& loadedEntities )
 {
 	//Handle that trick performed down in RestoreFromXMLNode. Note the value's already parsed in that function.
-	for ( std::pair< EntityID, FactionRelationship* > relation : m_agentRelations )
+	//Map keys can't be reassigned in place, so rekey from saved IDs to the new entity IDs by rebuilding the map.
+	std::map< EntityID, FactionRelationship* > resolvedAgentRelations;
+	for ( std::pair< const EntityID, FactionRelationship* >& relation : m_agentRelations )
 	{
 		std::map< EntityID, GameEntity* >::iterator relationTargetIter = loadedEntities.find( relation.first );
 		GUARANTEE_OR_DIE( relationTargetIter != loadedEntities.end(), "Referenced relationTargetID not found in loaded entities!" );
 
 		Agent* relationTarget = (Agent*)relationTargetIter->second;
-		relation.first = relationTarget->GetEntityID();
 		relation.second->m_towardsThisFactionName = relationTarget->GetFactionName();
 		relation.second->m_factionID = relationTarget->GetFactionID();
+		resolvedAgentRelations.insert( std::pair< EntityID, FactionRelationship* >( relationTarget->GetEntityID(), relation.second ) );
 	}
+	m_agentRelations.swap( resolvedAgentRelations );
 }
 
 
@@ -127,10 +144,10 @@ void Faction::RestoreFromXMLNode( const XMLNode& factionsNode )
 //--------------------------------------------------------------------------------------------------------------
 void Faction::WriteToXMLNode( XMLNode& out_agentNode )
 {
-	if ( m_name == "" )
+	if ( m_name.IsEmpty() )
 		return;
 
-	WriteXMLAttribute( out_agentNode, "faction", m_name, std::string() );
+	WriteXMLAttribute( out_agentNode, "faction", m_name.GetString(), std::string() );
 
 	XMLNode factionsNode = out_agentNode.addChild( "Factions" );
 
@@ -139,7 +156,7 @@ void Faction::WriteToXMLNode( XMLNode& out_agentNode )
 	for ( std::pair< FactionID, FactionRelationship* > relation : m_factionRelations )
 	{
 		XMLNode relationNode = factionRelationsNode.addChild( "FactionRelation" );
-		WriteXMLAttribute( relationNode, "faction", relation.second->m_towardsThisFactionName, std::string() );
+		WriteXMLAttribute( relationNode, "faction", relation.second->m_towardsThisFactionName.GetString(), std::string() );
 		WriteXMLAttribute( relationNode, "value", relation.second->m_relationshipValue, 0 );
 	}
 
@@ -154,6 +171,84 @@ void Faction::WriteToXMLNode( XMLNode& out_agentNode )
 }
 
 
+//--------------------------------------------------------------------------------------------------------------
+void Faction::WriteToBinary( BinaryWriter& writer ) const
+{
+	writer.WriteString( m_name.GetCString() );
+
+	//Faction relations by name, since FactionIDs depend on the order factions were loaded in.
+	writer.Write<uint32_t>( m_factionRelations.size() );
+	for ( const std::pair< const FactionID, FactionRelationship* >& relation : m_factionRelations )
+	{
+		writer.WriteString( relation.second->m_towardsThisFactionName.GetCString() );
+		writer.Write<int>( relation.second->m_relationshipValue );
+	}
+
+	writer.Write<uint32_t>( m_agentRelations.size() );
+	for ( const std::pair< const EntityID, FactionRelationship* >& relation : m_agentRelations )
+	{
+		writer.Write<EntityID>( relation.first );
+		writer.Write<int>( relation.second->m_relationshipValue );
+	}
+}
+
+
+//--------------------------------------------------------------------------------------------------------------
+void Faction::RestoreFromBinary( BinaryReader& reader )
+{
+	DeleteAllRelations(); //Else we'd keep the blueprint's relations under the saved ones.
+
+	std::string nameString;
+	reader.ReadString( nameString );
+	m_name = nameString;
+	if ( !m_name.IsEmpty() )
+		m_factionID = Faction::CreateOrGetFaction( nameString )->GetID();
+
+	uint32_t numFactionRelations = 0;
+	reader.Read<uint32_t>( &numFactionRelations );
+	std::string factionString;
+	for ( uint32_t relationIndex = 0; relationIndex < numFactionRelations; relationIndex++ )
+	{
+		int relationValue = 0;
+		reader.ReadString( factionString );
+		reader.Read<int>( &relationValue );
+		if ( factionString == "" )
+			continue;
+
+		FactionID factionID = Faction::CreateOrGetFaction( factionString )->GetID();
+		FactionRelationship* relation = new FactionRelationship( factionString, factionID, relationValue );
+		m_factionRelations.insert( std::pair< FactionID, FactionRelationship* >( factionID, relation ) );
+	}
+
+	uint32_t numAgentRelations = 0;
+	reader.Read<uint32_t>( &numAgentRelations );
+	for ( uint32_t relationIndex = 0; relationIndex < numAgentRelations; relationIndex++ )
+	{
+		//Set to actual values in Faction::ResolveEntityPointers.
+		EntityID unresolvedEntityID = 0;
+		int relationshipValue = 0;
+		reader.Read<EntityID>( &unresolvedEntityID );
+		reader.Read<int>( &relationshipValue );
+
+		FactionRelationship* relation = new FactionRelationship( "", -1, relationshipValue );
+		m_agentRelations.insert( std::pair< EntityID, FactionRelationship* >( unresolvedEntityID, relation ) );
+	}
+}
+
+
+//--------------------------------------------------------------------------------------------------------------
+void Faction::DeleteAllRelations()
+{
+	for ( auto iter = m_factionRelations.begin(); iter != m_factionRelations.end(); ++iter )
+		delete iter->second;
+	for ( auto iter = m_agentRelations.begin(); iter != m_agentRelations.end(); ++iter )
+		delete iter->second;
+
+	m_factionRelations.clear();
+	m_agentRelations.clear();
+}
+
+
 //--------------------------------------------------------------------------------------------------------------
 int Faction::GetStatusValueForFaction( FactionID factionID ) const
 {
@@ -225,7 +320,7 @@ void Faction::AdjustFactionStatus( Agent* instigator, FactionAction action ) //I
 //--------------------------------------------------------------------------------------------------------------
 FactionRelationship* Faction::AddNewlyMetFaction( FactionID factionID )
 {
-	std::string newFactionName = Faction::GetNameForFactionID( factionID );
+	Name newFactionName = Faction::GetNameForFactionID( factionID );
 	FactionRelationship* newRelation = new FactionRelationship( newFactionName, factionID, FACTION_STATUS_NEUTRAL );
 	m_factionRelations.insert( std::pair< FactionID, FactionRelationship* >( factionID, newRelation ) );
 	return newRelation;
@@ -242,26 +337,18 @@ FactionRelationship* Faction::AddNewlyMetAgent( EntityID agentID )
 
 
 //--------------------------------------------------------------------------------------------------------------
-void Faction::LoadAllFactions()
+void Faction::LoadFactionsFromXML( const XMLNode& factionsRoot )
 {
 	//Note we may have more than one Faction in a file.
-	std::vector< std::string > m_factionFiles = EnumerateFilesInDirectory( "Data/XML/Factions", "*.Faction.xml" );
-
-	for ( unsigned int factionFileIndex = 0; factionFileIndex < m_factionFiles.size(); factionFileIndex++ )
+	for ( int factionIndex = 0; factionIndex < factionsRoot.nChildNode(); factionIndex++ )
 	{
-		const char* xmlFilename = m_factionFiles[ factionFileIndex ].c_str();
-		XMLNode factionsRoot = XMLNode::openFileHelper( xmlFilename, "Factions" );
-
-		for ( int factionIndex = 0; factionIndex < factionsRoot.nChildNode(); factionIndex++ )
-		{
-			XMLNode factionNode = factionsRoot.getChildNode( factionIndex );
+		XMLNode factionNode = factionsRoot.getChildNode( factionIndex );
 
-			std::string factionName;
-			factionName = ReadXMLAttribute( factionNode, "name", factionName );
+		std::string factionName;
+		factionName = ReadXMLAttribute( factionNode, "name", factionName );
 
-			Faction* newFaction = CreateOrGetFaction( factionName );
-			newFaction->PopulateFromXMLNode( factionNode );
-		}
+		Faction* newFaction = CreateOrGetFaction( factionName );
+		newFaction->PopulateFromXMLNode( factionNode );
 	}
 
 }
@@ -270,15 +357,13 @@ void Faction::LoadAllFactions()
 //--------------------------------------------------------------------------------------------------------------
 Faction* Faction::CreateOrGetFaction( const std::string& factionName )
 {
-	//Not .find(), because it will compare both fields, and we only want uniqueness limited to the string name.
-	for ( std::map< std::string, Faction* >::iterator factionIter = s_factionRegistry.begin(); factionIter != s_factionRegistry.end(); ++factionIter )
-	{
-		if ( strcmp( factionIter->first.c_str(), factionName.c_str() ) == 0 ) //Because XMLNode doesn't do null-termination, std::string does.
-			return factionIter->second;
-	}
+	Name name( factionName.c_str() ); //Up to the first null, since names read from XML can carry a trailing one.
+	Faction** found = s_factionRegistry.Find( name );
+	if ( found != nullptr )
+		return *found;
 	
-	Faction* newFaction = new Faction( factionName );
-	s_factionRegistry.insert( std::pair< std::string, Faction* >( factionName, newFaction ) );
+	Faction* newFaction = new Faction( name.GetString() );
+	s_factionRegistry.Insert( name, newFaction );
 	return newFaction;
 }
 
@@ -3,10 +3,13 @@
 
 #include <map>
 #include "Game/GameCommon.hpp"
+#include "Engine/String/NameMap.hpp"
 
 
 //-----------------------------------------------------------------------------
 struct XMLNode;
+class BinaryWriter;
+class BinaryReader;
 class Agent;
 class GameEntity;
 
@@ -45,7 +48,7 @@ enum FactionStatus
 //-----------------------------------------------------------------------------
 struct FactionRelationship
 {
-	FactionRelationship( const std::string& towardThisFactionName, int factionID, int relationshipValue )
+	FactionRelationship( const Name& towardThisFactionName, int factionID, int relationshipValue )
 		: m_towardsThisFactionName( towardThisFactionName )
 		, m_factionID( factionID )
 		, m_relationshipValue( relationshipValue )
@@ -54,7 +57,7 @@ struct FactionRelationship
 
 	int m_relationshipValue; //Confer FactionStatus for intervals.
 	FactionID m_factionID;
-	std::string m_towardsThisFactionName; //Redundant for self-reference purposes, e.g. printing table of all these.
+	Name m_towardsThisFactionName; //Redundant for self-reference purposes, e.g. printing table of all these.
 };
 
 
@@ -66,7 +69,8 @@ public:
 	Faction( const std::string& name ) //Need to match the factionID of the global faction, despite being another instance.
 		: m_name( name )
 	{
-		m_factionID = ( s_factionRegistry.count( name ) != 0 ) ? s_factionRegistry.at( name )->m_factionID : s_BASE_FACTION_ID++;
+		Faction** registered = s_factionRegistry.Find( m_name );
+		m_factionID = ( registered != nullptr ) ? ( *registered )->m_factionID : s_BASE_FACTION_ID++;
 	}
 	Faction( const Faction& other ) //Being wary about pointers to Relationships being copied shallowly...
 		: m_name( other.m_name )
@@ -86,6 +90,7 @@ public:
 	void PopulateFromXMLNode( const XMLNode& factionNode ); //From non-capture NPC files.
 	void RestoreFromXMLNode( const XMLNode& factionsNode ); //From state captures.
 	void CloneAndOverwriteMyFactionFromXML( const XMLNode& myFactionNode );
+	void RestoreFromBinary( BinaryReader& reader ); //From binary state captures, replacing all relations.
 
 	~Faction()
 	{
@@ -95,7 +100,7 @@ public:
 			delete iter->second;
 	}
 	
-	std::string GetName() const { return m_name; }
+	const std::string& GetName() const { return m_name.GetString(); }
 	FactionID GetID() const { return m_factionID; }
 	int GetStatusValueForFaction( FactionID factionID ) const;
 	FactionRelationship* CreateOrGetRelationshipWithFaction( FactionID factionID );
@@ -105,17 +110,19 @@ public:
 	void AdjustFactionStatus( Agent* instigator, FactionAction action );
 
 	//-----------------------------------------------------------------------------
-	static void LoadAllFactions();
+	static void LoadFactionsFromXML( const XMLNode& factionsRoot ); //One file's root, from BlueprintCache.
 	static Faction* CreateOrGetFaction( const std::string& name );
 	void WriteToXMLNode( XMLNode& out_agentNode );
+	void WriteToBinary( BinaryWriter& writer ) const;
 	void ResolvePointersToEntities( std::map< EntityID, GameEntity* >& loadedEntities );
 	void RemoveRelationsWithEntity( const Agent* agentToRemove );
 
 
 private:
 	float CalcExtrapolationRatio( FactionID instigatorFaction );
-	static std::string GetNameForFactionID( FactionID factionID );
-	std::string m_name;
+	static Name GetNameForFactionID( FactionID factionID );
+	void DeleteAllRelations();
+	Name m_name;
 	FactionID m_factionID;
 
 	//Containers kept by value, not pointer, so each entity develops their own world-views.
@@ -123,7 +130,7 @@ private:
 	std::map< EntityID, FactionRelationship* > m_agentRelations;
 
 	//-----------------------------------------------------------------------------
-	static std::map< std::string, Faction* > s_factionRegistry;
+	static NameMap< Faction* > s_factionRegistry;
 	static FactionID s_BASE_FACTION_ID;
 	static float s_EXTRAPOLATION_RATIO;
 };
@@ -3,7 +3,10 @@
 #include "Game/FieldOfView/FieldOfView.hpp"
 #include "Game/Map.hpp"
 #include "Engine/Renderer/TheRenderer.hpp"
+#include "Game/Features/FeatureFactory.hpp"
 #include "Engine/Core/TheConsole.hpp"
+#include "Engine/FileUtils/Writers/BinaryWriter.hpp"
+#include "Engine/FileUtils/Readers/BinaryReader.hpp"
 
 
 //--------------------------------------------------------------------------------------------------------------
@@ -113,6 +116,67 @@ void Feature::WriteToXMLNode( XMLNode& out_entityDataNode )
 }
 
 
+//--------------------------------------------------------------------------------------------------------------
+void Feature::WriteToBinary( BinaryWriter& writer ) const
+{
+	GameEntity::WriteToBinary( writer );
+
+	writer.Write<byte_t>( (byte_t)m_featureState ); //Blocking flags and glyphs come from the blueprint.
+}
+
+
+//--------------------------------------------------------------------------------------------------------------
+void Feature::PopulateFromBinary( BinaryReader& reader, Map* map )
+{
+	GameEntity::PopulateFromBinary( reader, map );
+
+	if ( m_map != nullptr )
+	{
+		Cell& cell = m_map->GetCellForPosition( GetPositionMins() );
+		cell.m_occupyingFeature = this;
+	}
+
+	byte_t featureStateAsByte = 0;
+	reader.Read<byte_t>( &featureStateAsByte );
+	m_featureState = (FeatureState)featureStateAsByte;
+}
+
+
+//--------------------------------------------------------------------------------------------------------------
+void Feature::WriteBinaryRecord( BinaryWriter& writer ) const
+{
+	writer.Write<byte_t>( (byte_t)m_featureType );
+	writer.WriteString( m_name.GetCString() );
+	WriteToBinary( writer );
+}
+
+
+//--------------------------------------------------------------------------------------------------------------
+STATIC Feature* Feature::CreateFromBinaryRecord( BinaryReader& reader, Map* map )
+{
+	byte_t featureTypeAsByte = NUM_FEATURE_TYPES;
+	std::string factoryName;
+	reader.Read<byte_t>( &featureTypeAsByte );
+	reader.ReadString( factoryName );
+
+	FeatureType featureType = (FeatureType)featureTypeAsByte;
+	if ( featureType >= NUM_FEATURE_TYPES )
+		return nullptr;
+
+	FeatureFactoryCategory& registry = FeatureFactory::GetRegistryForFeatureType( featureType );
+	FeatureFactoryCategory::iterator found = registry.find( factoryName );
+	if ( found == registry.end() )
+	{
+		DebuggerPrintf( "Feature::CreateFromBinaryRecord() failed to find FeatureFactory for %s!", factoryName.c_str() );
+		return nullptr;
+	}
+
+	Feature* newFeature = found->second->CreateFeature();
+	newFeature->PopulateFromBinary( reader, map );
+	return newFeature;
+}
+
+
 //--------------------------------------------------------------------------------------------------------------
 char Feature::GetGlyph() const
 {
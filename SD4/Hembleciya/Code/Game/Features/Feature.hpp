@@ -58,6 +58,9 @@ public:
 	}
 	Feature( const Feature& other, Map* map = nullptr, const XMLNode& instanceDataNode = XMLNode::emptyNode() );
 	virtual void WriteToXMLNode( XMLNode& out_entityDataNode ) override;
+	virtual void WriteToBinary( BinaryWriter& writer ) const override;
+	void WriteBinaryRecord( BinaryWriter& writer ) const; //Type and factory name, then WriteToBinary.
+	static Feature* CreateFromBinaryRecord( BinaryReader& reader, Map* map ); //Nullptr if the factory's gone, leaving the rest unread.
 	void ResolvePointersToEntities( std::map< EntityID, GameEntity* >& ) override {}
 	void SetOccupiedCellsFeatureTo( Feature* feature );
 	virtual bool AttachToMapAtPosition( Map* map, const MapPosition& position ) override;
@@ -73,6 +76,7 @@ public:
 
 private:
 	virtual void PopulateFromXMLNode( const XMLNode& featureBlueprintNode, Map* map ) override;
+	virtual void PopulateFromBinary( BinaryReader& reader, Map* map ) override;
 
 	FeatureType m_featureType;
 	FeatureState m_featureState;
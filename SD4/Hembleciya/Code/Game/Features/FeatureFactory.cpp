@@ -26,34 +26,26 @@ void FeatureFactory::SetFeatureType( FeatureType type )
 
 
 //--------------------------------------------------------------------------------------------------------------
-STATIC void FeatureFactory::LoadAllFeatureBlueprints()
+STATIC void FeatureFactory::LoadFeatureBlueprintsFromXML( const XMLNode& blueprintsRoot )
 {
 	//Note we may have more than one Feature in a file.
-	std::vector< std::string > m_factoryFiles = EnumerateFilesInDirectory( "Data/XML/Features", "*.Feature.xml" );
-
-	for ( unsigned int factoryFileIndex = 0; factoryFileIndex < m_factoryFiles.size(); factoryFileIndex++ )
+	for ( int featureBlueprintIndex = 0; featureBlueprintIndex < blueprintsRoot.nChildNode(); featureBlueprintIndex++ )
 	{
-		const char* xmlFilename = m_factoryFiles[ factoryFileIndex ].c_str();
-		XMLNode blueprintsRoot = XMLNode::openFileHelper( xmlFilename, "FeatureBlueprints" );
-
-		for ( int featureBlueprintIndex = 0; featureBlueprintIndex < blueprintsRoot.nChildNode(); featureBlueprintIndex++ )
-		{
-			XMLNode featureBlueprintNode = blueprintsRoot.getChildNode( featureBlueprintIndex );
+		XMLNode featureBlueprintNode = blueprintsRoot.getChildNode( featureBlueprintIndex );
 
-			FeatureFactory* newFactory = new FeatureFactory( featureBlueprintNode ); //Each FeatureFactory corresponds to a FeatureBlueprint element.
-			newFactory->m_name = ReadXMLAttribute( featureBlueprintNode, "name", newFactory->m_name );
+		FeatureFactory* newFactory = new FeatureFactory( featureBlueprintNode ); //Each FeatureFactory corresponds to a FeatureBlueprint element.
+		newFactory->m_name = ReadXMLAttribute( featureBlueprintNode, "name", newFactory->m_name );
 
-			std::string featureTypeAsString;
-			featureTypeAsString = ReadXMLAttribute( featureBlueprintNode, "type", featureTypeAsString );
-			newFactory->SetFeatureType( GetFeatureTypeForString( featureTypeAsString ) );
+		std::string featureTypeAsString;
+		featureTypeAsString = ReadXMLAttribute( featureBlueprintNode, "type", featureTypeAsString );
+		newFactory->SetFeatureType( GetFeatureTypeForString( featureTypeAsString ) );
 
-			FeatureFactoryCategory& categoryRegistry = s_featureFactoryRegistry[ newFactory->m_factoryFeatureType ];
+		FeatureFactoryCategory& categoryRegistry = s_featureFactoryRegistry[ newFactory->m_factoryFeatureType ];
 
-			if ( categoryRegistry.find( newFactory->m_name ) != categoryRegistry.end() )
-				ERROR_AND_DIE( Stringf( "Found duplicate Feature factory type/name %s in LoadAllFeatureBlueprints!", newFactory->m_name.c_str() ) );
+		if ( categoryRegistry.find( newFactory->m_name ) != categoryRegistry.end() )
+			ERROR_AND_DIE( Stringf( "Found duplicate Feature factory type/name %s in LoadFeatureBlueprintsFromXML!", newFactory->m_name.c_str() ) );
 
-			categoryRegistry.insert( std::pair< std::string, FeatureFactory* >( newFactory->m_name, newFactory ) );
-		}
+		categoryRegistry.insert( std::pair< std::string, FeatureFactory* >( newFactory->m_name, newFactory ) );
 	}
 }
 
@@ -22,7 +22,7 @@ class FeatureFactory
 {
 public:
 	FeatureFactory( const XMLNode& featureBlueprintNode ) { PopulateFromXMLNode( featureBlueprintNode ); }
-	static void LoadAllFeatureBlueprints();
+	static void LoadFeatureBlueprintsFromXML( const XMLNode& blueprintsRoot ); //One file's root, from BlueprintCache.
 	Feature* CreateFeature( Map* map = nullptr, const XMLNode& featureInstanceNode = XMLNode::emptyNode() );
 	static FeatureFactoryCategory& GetRegistryForFeatureType( FeatureType type ) { return s_featureFactoryRegistry[ type ]; }
 	static FeatureFactory* GetRandomFactoryForFeatureType( FeatureType type );
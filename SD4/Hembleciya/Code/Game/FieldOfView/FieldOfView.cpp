@@ -1,5 +1,7 @@
 #include "Game/FieldOfView/FieldOfView.hpp"
 #include "Engine/Math/MathUtils.hpp"
+#include "Engine/Memory/FrameAllocator.hpp"
+#include "Engine/Metrics/Metrics.hpp"
 #include "Game/Agent.hpp"
 #include "Game/Items/Item.hpp"
 #include "Game/Features/Feature.hpp"
@@ -28,9 +30,10 @@ void FieldOfView::CalculateFieldOfViewForAgent( Agent* agentOrigin, int viewRadi
 		map->GetCellForPosition( agentOrigin->GetPositionMins() ).SetSeen(); //Else player appears at half-alpha.
 	}
 
-	std::vector< MapPosition > potentiallyViewedCells;
 	MapPosition agentPos = agentOrigin->GetPositionMins();
 	int viewRadiusSquared = viewRadius * viewRadius;
+	FrameVector< MapPosition > potentiallyViewedCells; //Every agent rebuilds this each turn, so it never touches the heap.
+	potentiallyViewedCells.reserve( 4 * viewRadiusSquared );
 	switch ( s_fovType )
 	{
 		case FOV_BASIC:
@@ -87,6 +90,9 @@ void FieldOfView::CalculateFieldOfViewForAgent( Agent* agentOrigin, int viewRadi
 		}
 		case FOV_RAYCAST: break;
 	}
+
+	static const MetricID s_fovCellsVisitedMetric = Metrics::RegisterCounter( "game.fov_cells_visited" );
+	Metrics::AddToCounter( s_fovCellsVisitedMetric, potentiallyViewedCells.size() );
 }
 
 
@@ -115,7 +121,7 @@ void FieldOfView::UpdateFromSeenCell( Map* map, const MapPosition& cellPosToTest
 	if ( seenCell.HasItems() )
 	{
 		float distanceToCell = CalcDistSquaredBetweenPoints( agentOriginPosition, cellPosition );
-		std::vector< Item* >& itemsInCell = seenCell.GetItems();
+		const InventoryItemList& itemsInCell = seenCell.GetItems();
 
 		if ( isPlayer )
 		{
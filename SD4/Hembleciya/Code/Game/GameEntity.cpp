@@ -6,6 +6,8 @@
 #include "Engine/FileUtils/XMLUtils.hpp"
 #include "Engine/String/StringUtils.hpp"
 #include "Engine/Math/MathUtils.hpp"
+#include "Engine/FileUtils/Writers/BinaryWriter.hpp"
+#include "Engine/FileUtils/Readers/BinaryReader.hpp"
 
 
 //--------------------------------------------------------------------------------------------------------------
@@ -53,13 +55,12 @@ void GameEntity::PopulateFromXMLNode( const XMLNode& instanceDataNode, Map* map
 {
 	m_map = map;
 
-	m_name = ReadXMLAttribute( instanceDataNode, "name", m_name );
+	m_name = ReadXMLAttribute( instanceDataNode, "name", m_name.GetString() );
 	m_glyph = ReadXMLAttribute( instanceDataNode, "glyph", m_glyph );
 	m_maxHealth = ReadXMLAttribute( instanceDataNode, "maxHealth", m_maxHealth );
 	m_health = ReadXMLAttribute( instanceDataNode, "health", m_maxHealth ); //Defaults to the max.
 	
-	std::string colorString = ReadXMLAttribute( instanceDataNode, "color", std::string() );
-	sscanf_s( colorString.c_str(), "%hhu,%hhu,%hhu", &m_color.red, &m_color.green, &m_color.blue );
+	m_color = ReadXMLAttribute( instanceDataNode, "color", m_color ); //Saves written by Rgba::ToString carry alpha too, as binary saves do.
 
 	MapPosition savedPosition = ReadXMLAttribute( instanceDataNode, "position", GetPositionMins() );
 	m_positionBounds->AddOffset( savedPosition );
@@ -173,14 +174,54 @@ void GameEntity::WriteToXMLNode( XMLNode& out_gameEntityNode )
 {
 	const std::string default = "";
 
-	WriteXMLAttribute( out_gameEntityNode, "name", m_name, default );
+	WriteXMLAttribute( out_gameEntityNode, "name", m_name.GetString(), default );
 	WriteXMLAttribute( out_gameEntityNode, "health", m_health, m_maxHealth );
 	WriteXMLAttribute( out_gameEntityNode, "color", m_color, Rgba() );
 
-	Vector2i pos = GetPositionMins();
-	WriteXMLAttribute( out_gameEntityNode, "position", Stringf( "%d,%d", pos.x, pos.y ), default );
+	InlineFormatBuffer< 32 > position;
+	AppendXMLAttributeValue( position, GetPositionMins() );
+	out_gameEntityNode.addAttribute( "position", position.GetCString() );
 
 	WriteXMLAttribute( out_gameEntityNode, "savedId", m_entityID, s_INVALID_ID );
 
 	//Visibility taken care of by the player's <VisibilityData> map, and NPCs won't use has-seen.
 }
+
+
+//--------------------------------------------------------------------------------------------------------------
+void GameEntity::WriteToBinary( BinaryWriter& writer ) const
+{
+	writer.Write<EntityID>( m_entityID ); //Read back into m_savedID, as with the XML savedId.
+	writer.Write<int>( m_maxHealth );
+	writer.Write<int>( m_health );
+
+	writer.Write<byte_t>( m_color.red );
+	writer.Write<byte_t>( m_color.green );
+	writer.Write<byte_t>( m_color.blue );
+	writer.Write<byte_t>( m_color.alphaOpacity );
+
+	MapPosition pos = GetPositionMins();
+	writer.Write<int>( pos.x );
+	writer.Write<int>( pos.y );
+}
+
+
+//--------------------------------------------------------------------------------------------------------------
+void GameEntity::PopulateFromBinary( BinaryReader& reader, Map* map )
+{
+	m_map = map;
+
+	reader.Read<EntityID>( &m_savedID );
+	reader.Read<int>( &m_maxHealth ); //Overrides the factory's random roll, unlike the XML path.
+	reader.Read<int>( &m_health );
+
+	reader.Read<byte_t>( &m_color.red );
+	reader.Read<byte_t>( &m_color.green );
+	reader.Read<byte_t>( &m_color.blue );
+	reader.Read<byte_t>( &m_color.alphaOpacity );
+
+	MapPosition savedPosition;
+	reader.Read<int>( &savedPosition.x );
+	reader.Read<int>( &savedPosition.y );
+	SetPositionMins( savedPosition );
+}
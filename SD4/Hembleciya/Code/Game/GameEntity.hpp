@@ -3,11 +3,14 @@
 #include "Game/GameCommon.hpp"
 #include "Engine/Core/Entity.hpp"
 #include "Engine/FileUtils/XMLUtils.hpp"
+#include "Engine/String/Name.hpp"
 
 
 //-----------------------------------------------------------------------------
 class Map;
 struct XMLNode;
+class BinaryWriter;
+class BinaryReader;
 
 
 //-----------------------------------------------------------------------------
@@ -29,11 +32,14 @@ public:
 	void SetCurrentMap( Map* map ) { m_map = map; }
 	virtual bool AttachToMapAtPosition( Map* map, const MapPosition& newPosMins );
 	MapPosition GetPositionMins() const { return m_positionBounds->mins; }
+	MapPosition GetPositionMaxs() const { return m_positionBounds->maxs; } //Exclusive.
 	void SetPositionMins( const MapPosition& newMins );
 	Map* GetMap() const { return m_map; }
-	std::string GetName() const { return m_name; }
+	const std::string& GetName() const { return m_name.GetString(); }
+	const Name& GetInternedName() const { return m_name; } //Compare against a static const Name rather than GetName() == "...".
 	EntityID GetSavedID() const { return m_savedID; }
 	EntityID GetEntityID() const { return m_entityID; }
+	EntityType GetEntityType() const { return m_entityType; }
 	int GetHealth() const { return m_health; }
 	int GetMaxHealth() const { return m_maxHealth; }
 	void SetMaxHealth( int newMaxHealth ) { m_maxHealth = newMaxHealth; }
@@ -54,6 +60,8 @@ public:
 
 	virtual void WriteToXMLNode( XMLNode& out_gameEntityNode );	
 	virtual void PopulateFromXMLNode( const XMLNode& instanceDataNode, Map* map );
+	virtual void WriteToBinary( BinaryWriter& writer ) const; //Instance state only, the factory named by the save record supplies the rest.
+	virtual void PopulateFromBinary( BinaryReader& reader, Map* map );
 	virtual void ResolvePointersToEntities( std::map< EntityID, GameEntity* >& loadedEntities ) = 0;
 
 	static const EntityID s_INVALID_ID;
@@ -66,7 +74,7 @@ protected:
 	char m_glyph;
 	Rgba m_color;
 //	Rgba m_backgroundColor;
-	std::string m_name;
+	Name m_name;
 	EntityID m_entityID;
 	EntityID m_savedID;
 	int m_health; //Float for use as an expiration timer -= deltaSeconds.
@@ -1,5 +1,6 @@
 #include "Game/Generators/CellularAutomataGenerator.hpp"
 
+#include "Engine/Jobs/JobSystem.hpp"
 #include "Engine/Math/MathUtils.hpp"
 #include "Game/GameCommon.hpp"
 #include "Game/Map.hpp"
@@ -36,18 +37,21 @@ Map* CellularAutomataGenerator::CreateMapAndInitializeCells( const Vector2i& siz
 
 
 //--------------------------------------------------------------------------------------------------------------
-static void RunGameOfLifeStep( Map* map, int /*currentStepNumber*/, CellType livingType, CellType deadType )
+struct GameOfLifeCellRule //Reads only m_cellType and writes only its own cell's m_nextCellType, so cells can update in parallel.
 {
-	//Automata Rules @ bitstorm.org
+	Map* m_map;
+	CellType m_livingType;
+	CellType m_deadType;
 
-	std::vector<Cell>& cells = map->GetCells();
-	for ( unsigned int cellIndex = 0; cellIndex < cells.size(); cellIndex++ )
+	void operator()( unsigned int cellIndex ) const
 	{
-		Cell& currentCell = cells[ cellIndex ];
+		//Automata Rules @ bitstorm.org
+
+		Cell& currentCell = m_map->GetCells()[ cellIndex ];
 		CellType& newType = currentCell.m_nextCellType;
-		unsigned int numLivingNeighbors = map->GetNumNeighborsAroundCellOfType( currentCell.m_position, livingType, 1.f );
+		unsigned int numLivingNeighbors = m_map->GetNumNeighborsAroundCellOfType( currentCell.m_position, m_livingType, 1.f );
 
-		if ( currentCell.m_cellType == livingType )
+		if ( currentCell.m_cellType == m_livingType )
 		{
 			switch ( numLivingNeighbors )
 			{
@@ -58,48 +62,68 @@ static void RunGameOfLifeStep( Map* map, int /*currentStepNumber*/, CellType liv
 			case 1: //Solitude.
 			case 4: //Overpopulation.
 			default: //Overpopulation.
-				newType = deadType;
-				continue;
+				newType = m_deadType;
+				return;
 			}
 		}
 		else
 		{
 			if ( numLivingNeighbors == 3 ) //Procreation!
 			{
-				newType = livingType;
-				continue;
+				newType = m_livingType;
+				return;
 			}
 		}
 		newType = currentCell.m_cellType; //Stay same.
 	}
+};
+
+
+//--------------------------------------------------------------------------------------------------------------
+static void RunGameOfLifeStep( Map* map, int /*currentStepNumber*/, CellType livingType, CellType deadType )
+{
+	GameOfLifeCellRule rule = { map, livingType, deadType };
+	ParallelFor( (unsigned int)map->GetCells().size(), 0, rule );
 }
 
 
 //--------------------------------------------------------------------------------------------------------------
-static void RunModifiedRulesStep( Map* map, int currentStepNumber, CellType livingType, CellType deadType )
+struct ModifiedCellRule
 {
-	int numInitialPasses = ( GetRandomChance( .5f ) ? 3 : 4 );
-	bool inFirstPhase = ( currentStepNumber <= numInitialPasses );
+	Map* m_map;
+	CellType m_livingType;
+	CellType m_deadType;
+	bool m_inFirstPhase;
 
-	std::vector<Cell>& cells = map->GetCells();
-	for ( unsigned int cellIndex = 0; cellIndex < cells.size(); cellIndex++ )
+	void operator()( unsigned int cellIndex ) const
 	{
-		Cell& currentCell = cells[ cellIndex ];
+		Cell& currentCell = m_map->GetCells()[ cellIndex ];
 		CellType& newType = currentCell.m_nextCellType;
 
-		if ( map->GetNumNeighborsAroundCellOfType( currentCell.m_position, deadType, 1.f ) >= 5 )
+		if ( m_map->GetNumNeighborsAroundCellOfType( currentCell.m_position, m_deadType, 1.f ) >= 5 )
 		{
-			newType = inFirstPhase ? livingType : deadType; //Close off inaccessible tiny holes in first phase, open up passages in second.
-			continue;
+			newType = m_inFirstPhase ? m_livingType : m_deadType; //Close off inaccessible tiny holes in first phase, open up passages in second.
+			return;
 		}
-		if ( inFirstPhase && ( map->GetNumNeighborsAroundCellOfType( currentCell.m_position, deadType, 2.f ) <= 2 ) )
+		if ( m_inFirstPhase && ( m_map->GetNumNeighborsAroundCellOfType( currentCell.m_position, m_deadType, 2.f ) <= 2 ) )
 		{
-			newType = livingType; //Open things up more in first phase that are close to already open areas.
-			continue;
+			newType = m_livingType; //Open things up more in first phase that are close to already open areas.
+			return;
 		}
 
 		newType = currentCell.m_cellType; //Stay same.
 	}
+};
+
+
+//--------------------------------------------------------------------------------------------------------------
+static void RunModifiedRulesStep( Map* map, int currentStepNumber, CellType livingType, CellType deadType )
+{
+	int numInitialPasses = ( GetRandomChance( .5f ) ? 3 : 4 ); //Rolled here on the calling thread, so the rand() stream and the map stay deterministic.
+	bool inFirstPhase = ( currentStepNumber <= numInitialPasses );
+
+	ModifiedCellRule rule = { map, livingType, deadType, inFirstPhase };
+	ParallelFor( (unsigned int)map->GetCells().size(), 0, rule );
 }
 
 
@@ -6,6 +6,7 @@
 #include "Game/Map.hpp"
 
 #include "Engine/Error/ErrorWarningAssert.hpp"
+#include "Engine/Time/Profiler.hpp"
 
 
 STATIC std::map< std::string, GeneratorRegistration* >* GeneratorRegistration::s_generatorRegistry = nullptr;
@@ -25,6 +26,8 @@ Map* Generator::CreateMapAndInitializeCells( const Vector2i& size, const std::st
 //--------------------------------------------------------------------------------------------------------------
 void Generator::FinalizeMap( Map* map )
 {
+	PROFILE_SCOPE( "Generator::FinalizeMap" );
+
 	Vector2i mapSize = map->GetDimensions();
 
 	//Ensure the perimeter is solid wall.
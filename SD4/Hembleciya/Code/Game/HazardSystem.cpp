@@ -0,0 +1,132 @@
+#include "Game/HazardSystem.hpp"
+#include "Game/Agent.hpp"
+#include "Game/Map.hpp"
+#include "Game/CombatSystem.hpp"
+#include "Engine/Core/TheConsole.hpp"
+#include "Engine/Time/Profiler.hpp"
+
+
+//--------------------------------------------------------------------------------------------------------------
+STATIC const float HazardSystem::s_SLOWED_TURN_COOLDOWN_MULTIPLIER = 2.f;
+
+
+//--------------------------------------------------------------------------------------------------------------
+void HazardSystem::RefreshHazardCells( Map* map )
+{
+	PROFILE_SCOPE( "HazardSystem::RefreshHazardCells" );
+
+	std::vector< Cell >& cells = map->GetCells();
+
+	m_hazardCellIndices.clear();
+	for ( unsigned int cellIndex = 0; cellIndex < cells.size(); cellIndex++ )
+		if ( IsHazardType( cells[ cellIndex ].m_cellType ) )
+			m_hazardCellIndices.push_back( cellIndex );
+
+	//Terrain may have changed under agents that haven't moved, so rebuild overlaps from the hazard cells' occupants.
+	m_overlaps.clear();
+
+	for ( int cellIndex : m_hazardCellIndices )
+	{
+		Agent* occupyingAgent = cells[ cellIndex ].m_occupyingAgent;
+		if ( ( occupyingAgent != nullptr ) && ( FindOverlapForAgent( occupyingAgent ) == m_overlaps.end() ) )
+			OnAgentOccupancyChanged( occupyingAgent, true );
+	}
+}
+
+
+//--------------------------------------------------------------------------------------------------------------
+void HazardSystem::OnAgentOccupancyChanged( Agent* agent, bool isOccupying )
+{
+	std::vector< HazardOverlap >::iterator overlapIter = FindOverlapForAgent( agent );
+
+	if ( !isOccupying )
+	{
+		if ( overlapIter != m_overlaps.end() )
+			m_overlaps.erase( overlapIter );
+		return;
+	}
+
+	HazardOverlap overlap( agent );
+	Map* map = agent->GetMap();
+	MapPosition positionMins = agent->GetPositionMins();
+	MapPosition positionMaxs = agent->GetPositionMaxs();
+	for ( int cellY = positionMins.y; cellY < positionMaxs.y; cellY++ )
+	{
+		for ( int cellX = positionMins.x; cellX < positionMaxs.x; cellX++ )
+		{
+			CellType cellType = map->GetCellForPosition( MapPosition( cellX, cellY ) ).m_cellType;
+			if ( cellType == CELL_TYPE_LAVA )
+				++overlap.m_numLavaCells;
+			else if ( cellType == CELL_TYPE_WATER )
+				++overlap.m_numWaterCells;
+		}
+	}
+
+	bool isOverlappingHazard = ( overlap.m_numLavaCells > 0 ) || ( overlap.m_numWaterCells > 0 );
+	if ( !isOverlappingHazard )
+	{
+		if ( overlapIter != m_overlaps.end() )
+			m_overlaps.erase( overlapIter );
+	}
+	else if ( overlapIter != m_overlaps.end() )
+		*overlapIter = overlap;
+	else
+		m_overlaps.push_back( overlap );
+}
+
+
+//--------------------------------------------------------------------------------------------------------------
+void HazardSystem::ApplyHazardsForTimeSlice()
+{
+	PROFILE_SCOPE( "HazardSystem::ApplyHazardsForTimeSlice" );
+
+	static bool hasBeenBurned = false;
+
+	for ( HazardOverlap& overlap : m_overlaps )
+	{
+		Agent* agent = overlap.m_agent;
+		if ( !agent->IsAlive() )
+			continue; //Left for TheGame::DestroyDeadGameplayEntities, whose Die() removes it from m_overlaps.
+
+		if ( ( overlap.m_numLavaCells == 0 ) || agent->IsInvincible() )
+			continue;
+
+		agent->SubtractHealthDelta( LAVA_DAMAGE_PER_TURN );
+		if ( agent->IsPlayer() )
+		{
+			g_theConsole->Format( CHECKED_FORMAT( "You take {} damage for walking on lava.{}",
+								  LAVA_DAMAGE_PER_TURN,
+								  hasBeenBurned ? "" : " Pinching yourself wouldn't work either, then." ) );
+			hasBeenBurned = true;
+		}
+
+		CombatSystem::PlayHurtSound( agent );
+	}
+}
+
+
+//--------------------------------------------------------------------------------------------------------------
+float HazardSystem::GetTurnCooldownMultiplierForAgent( const Agent* agent )
+{
+	std::vector< HazardOverlap >::iterator overlapIter = FindOverlapForAgent( agent );
+	if ( overlapIter == m_overlaps.end() )
+		return 1.f;
+
+	//From the counts, which are current as of the agent's last move, not from the last time slice.
+	bitfield_int traversalProperties = agent->GetTraversalProperties();
+	bool isSlowedByLava = ( overlapIter->m_numLavaCells > 0 ) && ( GET_BIT_WITHOUT_INDEX_MASKED( traversalProperties, TraversalProperties::SLOWED_BY_LAVA ) != 0 );
+	bool isSlowedByWater = ( overlapIter->m_numWaterCells > 0 ) && ( GET_BIT_WITHOUT_INDEX_MASKED( traversalProperties, TraversalProperties::SLOWED_BY_WATER ) != 0 );
+
+	return ( isSlowedByLava || isSlowedByWater ) ? s_SLOWED_TURN_COOLDOWN_MULTIPLIER : 1.f;
+}
+
+
+//--------------------------------------------------------------------------------------------------------------
+std::vector< HazardOverlap >::iterator HazardSystem::FindOverlapForAgent( const Agent* agent )
+{
+	for ( std::vector< HazardOverlap >::iterator overlapIter = m_overlaps.begin(); overlapIter != m_overlaps.end(); ++overlapIter )
+		if ( overlapIter->m_agent == agent )
+			return overlapIter;
+
+	return m_overlaps.end();
+}
@@ -0,0 +1,46 @@
+#pragma once
+
+
+#include <vector>
+#include "Game/GameCommon.hpp"
+
+
+//-----------------------------------------------------------------------------
+class Agent;
+class Map;
+
+
+//-----------------------------------------------------------------------------
+struct HazardOverlap
+{
+	HazardOverlap( Agent* agent ) : m_agent( agent ), m_numLavaCells( 0 ), m_numWaterCells( 0 ) {}
+
+	Agent* m_agent;
+	int m_numLavaCells; //Counts, not bools, so multi-cell agents only take damage once per slice.
+	int m_numWaterCells;
+};
+
+
+//-----------------------------------------------------------------------------
+class HazardSystem //Owned by each Map. Tracks lava/water cells and who stands in them, so nothing probes the map per agent per turn.
+{
+public:
+	static bool IsHazardType( CellType type ) { return ( type == CELL_TYPE_LAVA ) || ( type == CELL_TYPE_WATER ); }
+
+	void RefreshHazardCells( Map* map ); //Full rescan after generation, loading, or terrain swaps like dreams.
+	void OnAgentOccupancyChanged( Agent* agent, bool isOccupying ); //Called from the occupancy layer whenever an agent enters or leaves its cells.
+	void ApplyHazardsForTimeSlice(); //One batched pass: lava damage for every overlapping agent.
+	float GetTurnCooldownMultiplierForAgent( const Agent* agent ); //2x while on a cell that slows it, matching the pathfinding cost of slowed cells.
+
+	const std::vector< int >& GetHazardCellIndices() const { return m_hazardCellIndices; }
+	unsigned int GetNumOverlappingAgents() const { return m_overlaps.size(); }
+
+
+private:
+	std::vector< HazardOverlap >::iterator FindOverlapForAgent( const Agent* agent );
+
+	std::vector< int > m_hazardCellIndices; //Compact list, rebuilt only by RefreshHazardCells.
+	std::vector< HazardOverlap > m_overlaps; //Usually a handful of agents, so linear search beats a map.
+
+	static const float s_SLOWED_TURN_COOLDOWN_MULTIPLIER;
+};
@@ -0,0 +1,915 @@
+#include "Game/Headless/HeadlessRunner.hpp"
+
+#include "Engine/Audio/TheAudio.hpp"
+#include "Engine/Bench/BenchCommon.hpp"
+#include "Engine/Bench/EngineBenches.hpp"
+#include "Engine/Core/Command.hpp"
+#include "Engine/Core/TheConsole.hpp"
+#include "Engine/FileUtils/FileUtils.hpp"
+#include "Engine/FileUtils/Compression.hpp"
+#include "Engine/FileUtils/Readers/BufferBinaryReader.hpp"
+#include "Engine/FileUtils/Writers/BufferBinaryWriter.hpp"
+#include "Engine/Jobs/JobSystem.hpp"
+#include "Engine/Memory/AllocationTracker.hpp"
+#include "Engine/Memory/FrameAllocator.hpp"
+#include "Engine/Memory/Memory.hpp"
+#include "Engine/Metrics/Metrics.hpp"
+#include "Engine/String/StringUtils.hpp"
+#include "Engine/Time/FrameProfiler.hpp"
+#include "Engine/Time/Time.hpp"
+
+#include "Game/Agent.hpp"
+#include "Game/GameEntity.hpp"
+#include "Game/Map.hpp"
+#include "Game/Biomes/BiomeBlueprint.hpp"
+#include "Game/Items/Item.hpp"
+#include "Game/Saves/BinarySaveGame.hpp"
+#include "Game/Saves/SaveJournal.hpp"
+#include "Game/Saves/BackgroundSaver.hpp"
+#include "Game/Blueprints/BlueprintCache.hpp"
+
+#include <map>
+#include <stdlib.h>
+#include <time.h>
+
+
+//--------------------------------------------------------------------------------------------------------------
+STATIC const int HeadlessJournal::s_VERSION = 1;
+STATIC const float HeadlessRunner::s_DELTA_SECONDS = 1.f / 60.f; //Matches FrameClock's default frame limit, so agents see frame-like deltas.
+STATIC const int HeadlessRunner::s_MAX_UPDATES_PER_TURN = 10000;
+STATIC const int HeadlessRunner::s_DEFAULT_NUM_TURNS = 1000;
+STATIC const int HeadlessRunner::s_DEFAULT_NUM_SAVE_BENCH_ITERATIONS = 20;
+STATIC const int HeadlessRunner::s_DEFAULT_NUM_COMPRESS_BENCH_ITERATIONS = 20;
+STATIC const int HeadlessRunner::s_DEFAULT_NUM_BLUEPRINT_BENCH_ITERATIONS = 20;
+STATIC const int HeadlessRunner::s_NUM_SAVE_BENCH_WARMUP_TURNS = 100; //So the save has fights, pickups, and a schedule in it.
+STATIC const int HeadlessRunner::s_NUM_SAVE_BENCH_DELTA_TURNS = 10; //Roughly what an autosave interval touches.
+STATIC const int HeadlessRunner::s_LEAK_CHECK_WARMUP_TURN_DIVISOR = 10; //Snapshot a tenth of the way in, once caches and pools have filled.
+STATIC const unsigned int HeadlessRunner::s_NUM_LEAK_CHECK_REPORT_SITES = 20;
+
+
+//--------------------------------------------------------------------------------------------------------------
+static bool WriteStringToFile( const std::string& filePath, const std::string& contents )
+{
+	std::vector< unsigned char > buffer( contents.begin(), contents.end() );
+	return SaveBufferToBinaryFile( filePath, buffer );
+}
+
+
+//--------------------------------------------------------------------------------------------------------------
+bool HeadlessJournal::WriteToFile( const std::string& journalPath ) const
+{
+	std::string contents = Stringf( "HembleciyaJournal %d\n", s_VERSION );
+
+	if ( m_biomeName.empty() )
+		contents += "save " + m_saveFilename + "\n";
+	else
+		contents += "biome " + m_biomeName + "\n";
+
+	contents += Stringf( "seed %u\n", m_seed );
+	contents += Stringf( "initialHash %08x\n", m_initialStateHash );
+
+	for ( const HeadlessTurnRecord& turn : m_turns )
+		contents += Stringf( "turn %d %d %08x\n", turn.m_action, turn.m_direction, turn.m_stateHash );
+
+	return WriteStringToFile( journalPath, contents );
+}
+
+
+//--------------------------------------------------------------------------------------------------------------
+bool HeadlessJournal::ReadFromFile( const std::string& journalPath )
+{
+	std::vector< unsigned char > buffer;
+	if ( !LoadBinaryFileIntoBuffer( journalPath, buffer ) )
+		return false;
+	buffer.push_back( '\0' );
+
+	std::vector< std::string > lines = SplitString( reinterpret_cast< const char* >( buffer.data() ), '\n', true, false );
+
+	int version = 0;
+	if ( lines.empty() || sscanf_s( lines[ 0 ].c_str(), "HembleciyaJournal %d", &version ) < 1 || version != s_VERSION )
+	{
+		DebuggerPrintf( "HeadlessJournal::ReadFromFile() found no version %d header in %s!\n", s_VERSION, journalPath.c_str() );
+		return false;
+	}
+
+	m_biomeName.clear();
+	m_saveFilename.clear();
+	m_turns.clear();
+
+	for ( unsigned int lineIndex = 1; lineIndex < lines.size(); lineIndex++ )
+	{
+		const std::string& line = lines[ lineIndex ];
+
+		if ( line.compare( 0, 6, "biome " ) == 0 )
+			m_biomeName = line.substr( 6 ); //Biome names contain spaces, so take the rest of the line.
+		else if ( line.compare( 0, 5, "save " ) == 0 )
+			m_saveFilename = line.substr( 5 );
+		else if ( line.compare( 0, 5, "seed " ) == 0 )
+			sscanf_s( line.c_str(), "seed %u", &m_seed );
+		else if ( line.compare( 0, 12, "initialHash " ) == 0 )
+			sscanf_s( line.c_str(), "initialHash %x", &m_initialStateHash );
+		else if ( line.compare( 0, 5, "turn " ) == 0 )
+		{
+			int action = PLAYER_ACTION_UNSPECIFIED;
+			int direction = DIRECTION_NONE;
+			HeadlessTurnRecord turn;
+			if ( sscanf_s( line.c_str(), "turn %d %d %x", &action, &direction, &turn.m_stateHash ) < 3 )
+			{
+				DebuggerPrintf( "HeadlessJournal::ReadFromFile() skipped malformed line %u: %s\n", lineIndex + 1, line.c_str() );
+				continue;
+			}
+			turn.m_action = (PlayerAction)action;
+			turn.m_direction = (MapDirection)direction;
+			m_turns.push_back( turn );
+		}
+	}
+
+	return !( m_biomeName.empty() && m_saveFilename.empty() );
+}
+
+
+//--------------------------------------------------------------------------------------------------------------
+STATIC bool HeadlessRunner::IsHeadlessCommandLine( const std::string& commandLine )
+{
+	return Command( commandLine ).GetCommandName() == "-headless";
+}
+
+
+//--------------------------------------------------------------------------------------------------------------
+STATIC int HeadlessRunner::RunFromCommandLine( const std::string& commandLine )
+{
+	Command args( commandLine );
+
+	std::string mode;
+	std::string journalPath;
+	if ( !args.GetNextString( &mode ) || !args.GetNextString( &journalPath ) )
+	{
+		DebuggerPrintf( "Usage: -headless record|savebench <journalPath|reportPath> <biomeNumber|savePath> [seed] [numTurns|numIterations], or -headless replay <journalPath>\n" );
+		return 1;
+	}
+
+	if ( mode == "compressbench" ) //Runs every biome, so takes no source.
+	{
+		int seed;
+		int numIterations;
+		args.GetNextInt( &seed, (int)time( nullptr ) );
+		args.GetNextInt( &numIterations, s_DEFAULT_NUM_COMPRESS_BENCH_ITERATIONS );
+
+		HeadlessRunner runner;
+		return runner.BenchmarkCompression( journalPath, (unsigned int)seed, numIterations ) ? 0 : 1;
+	}
+
+	if ( EngineBenches::IsBenchMode( mode ) ) //Needs nothing of the game's but xmlbench's default files.
+	{
+		std::vector< std::string > defaultXMLFilePaths;
+		if ( mode == "xmlbench" )
+		{
+			defaultXMLFilePaths.push_back( "Data/XML/Saves/Save000.Save.xml" );
+			std::vector< std::string > npcFilePaths = EnumerateFilesInDirectory( "Data/XML/NPCs", "*.NPC.xml" );
+			defaultXMLFilePaths.insert( defaultXMLFilePaths.end(), npcFilePaths.begin(), npcFilePaths.end() );
+		}
+		return EngineBenches::RunFromCommand( mode, journalPath, args, defaultXMLFilePaths );
+	}
+
+	if ( mode == "hazardcheck" ) //Needs only a bare map, so no HeadlessRunner.
+		return CheckHazardSlows( journalPath ) ? 0 : 1;
+
+	if ( mode == "blueprintbench" ) //Must run before any HeadlessRunner, whose TheGame::Startup is what it times last.
+	{
+		int numIterations;
+		args.GetNextInt( &numIterations, s_DEFAULT_NUM_BLUEPRINT_BENCH_ITERATIONS );
+		return BenchmarkBlueprintLoading( journalPath, numIterations ) ? 0 : 1;
+	}
+
+	HeadlessJournal journal;
+	std::string source;
+	bool wasReplay = ( mode == "replay" );
+	bool isSaveBenchmark = ( mode == "savebench" );
+	bool isLeakCheck = ( mode == "leakcheck" );
+	if ( wasReplay )
+	{
+		if ( !journal.ReadFromFile( journalPath ) )
+			return 1;
+	}
+	else if ( mode == "record" || isSaveBenchmark || isLeakCheck )
+	{
+		if ( !args.GetNextString( &source ) )
+		{
+			DebuggerPrintf( "HeadlessRunner: %s needs a biome number or save path.\n", mode.c_str() );
+			return 1;
+		}
+
+		int seed;
+		args.GetNextInt( &seed, (int)time( nullptr ) );
+		journal.m_seed = (unsigned int)seed;
+	}
+	else
+	{
+		DebuggerPrintf( "HeadlessRunner: unknown mode %s, expected record, replay, savebench, readbench, compressbench, blueprintbench, xmlbench, parsebench, formatbench, swapbench, heapbench, jobbench, queuebench, leakcheck, or hazardcheck.\n", mode.c_str() );
+		return 1;
+	}
+
+	int numTurnsToSimulate; //Or iterations, for savebench.
+	args.GetNextInt( &numTurnsToSimulate, isSaveBenchmark ? s_DEFAULT_NUM_SAVE_BENCH_ITERATIONS : s_DEFAULT_NUM_TURNS );
+
+	HeadlessRunner runner;
+	bool didSucceed = false;
+	FrameProfiler::SetEnabled( true ); //Each update SimulateOneTurn runs counts as a frame.
+
+	if ( wasReplay )
+	{
+		didSucceed = runner.Replay( journal );
+	}
+	else
+	{
+		bool isBiomeNumber = ( source.find_first_not_of( "0123456789" ) == std::string::npos );
+		if ( !isBiomeNumber )
+		{
+			journal.m_saveFilename = source;
+		}
+		else //Same 1-based numbering as TheGame::UpdateMapSelection, resolved now that blueprints have loaded.
+		{
+			int biomeNumber = atoi( source.c_str() );
+			const std::map< std::string, BiomeBlueprint* >& biomes = BiomeBlueprint::GetRegistry();
+			if ( biomeNumber < 1 || biomeNumber > (int)biomes.size() )
+			{
+				DebuggerPrintf( "HeadlessRunner: biome number %d is outside 1-%u.\n", biomeNumber, biomes.size() );
+				return 1;
+			}
+
+			std::map< std::string, BiomeBlueprint* >::const_iterator biomeIter = biomes.cbegin();
+			std::advance( biomeIter, biomeNumber - 1 );
+			journal.m_biomeName = biomeIter->first;
+		}
+
+		if ( isSaveBenchmark )
+			return runner.BenchmarkSaves( journalPath, journal, numTurnsToSimulate ) ? 0 : 1;
+
+		if ( isLeakCheck )
+		{
+			runner.m_leakCheckSnapshotTurn = numTurnsToSimulate / s_LEAK_CHECK_WARMUP_TURN_DIVISOR;
+			AllocationTracker::StartTracking( TRACK_CALLSTACKS );
+		}
+
+		didSucceed = runner.Record( journal, numTurnsToSimulate ) && journal.WriteToFile( journalPath );
+	}
+
+	runner.WriteReport( journalPath + ".report.txt", journal, wasReplay ); //Includes the leak check's diff, so tracking stops only after.
+	Metrics::Merge(); //Nothing calls Metrics::Update headless, so this is the only merge.
+	Metrics::WriteReportToFile( journalPath + ".metrics.txt" );
+	FrameProfiler::WriteReportToFile( journalPath + ".frameprofile.txt" );
+	if ( isLeakCheck )
+	{
+		AllocationTracker::WriteLiveReportToFile( journalPath + ".memory.txt" );
+		AllocationTracker::StopTracking();
+	}
+
+	return didSucceed ? 0 : 1;
+}
+
+
+//--------------------------------------------------------------------------------------------------------------
+STATIC bool HeadlessRunner::BenchmarkBlueprintLoading( const std::string& reportPath, int numIterations )
+{
+	if ( numIterations < 2 )
+		numIterations = 2; //One cold pass, at least one warm.
+
+	BenchTiming xmlTiming;
+	BenchTiming cacheTiming;
+	size_t numCacheBytes = 0;
+	unsigned int numSourceFiles = 0;
+	bool didAllMatch = true;
+
+	//XML goes first each round, so any cold read of the sources is billed to it. Its first pass also writes the cache the rest read.
+	for ( int iteration = 0; iteration < numIterations; iteration++ )
+	{
+		BlueprintCache parsedCache;
+		BenchTimer timer;
+		parsedCache.ParseSourceFiles();
+		xmlTiming.AddPass( timer.GetElapsedSeconds() );
+
+		BufferBinaryWriter parsedWriter;
+		parsedCache.WriteToBuffer( parsedWriter );
+		if ( iteration == 0 && !parsedCache.WriteToFile( BlueprintCache::s_CACHE_FILE_PATH ) )
+		{
+			DebuggerPrintf( "HeadlessRunner: blueprintbench failed to write %s!\n", BlueprintCache::s_CACHE_FILE_PATH );
+			return false;
+		}
+
+		BlueprintCache loadedCache;
+		timer.Restart();
+		bool didRead = loadedCache.ReadFromFile( BlueprintCache::s_CACHE_FILE_PATH );
+		cacheTiming.AddPass( timer.GetElapsedSeconds() );
+
+		BufferBinaryWriter loadedWriter;
+		loadedCache.WriteToBuffer( loadedWriter );
+		didAllMatch &= didRead && ( loadedWriter.GetBuffer() == parsedWriter.GetBuffer() );
+
+		if ( iteration == 0 )
+		{
+			numCacheBytes = parsedWriter.GetNumBytesWritten();
+			numSourceFiles = parsedCache.GetNumSourceFiles();
+		}
+	}
+
+	BenchReport report;
+	report.Printf( "Headless blueprintbench: %u blueprint files, %u cache bytes, %d iterations\n", numSourceFiles, numCacheBytes, numIterations );
+	report.Printf( "XML parse       cold ms: %.3f, warm ms: %.3f\n", xmlTiming.GetColdSeconds() * 1000.0, xmlTiming.GetWarmSeconds() * 1000.0 );
+	report.Printf( "BlueprintCache  cold ms: %.3f, warm ms: %.3f, warm speedup: %.1fx\n",
+				   cacheTiming.GetColdSeconds() * 1000.0,
+				   cacheTiming.GetWarmSeconds() * 1000.0,
+				   CalcSpeedup( xmlTiming.GetWarmSeconds(), cacheTiming.GetWarmSeconds() ) );
+	report.Printf( "Trees: %s\n", didAllMatch ? "matched" : "DIFFERED" );
+
+	{
+		HeadlessRunner runner; //Its TheGame::Startup now finds the cache current, as a second launch would.
+		report.Printf( "TheGame::Startup blueprint load ms: %.3f, from %s\n",
+					   BlueprintCache::GetLastLoadSeconds() * 1000.0,
+					   BlueprintCache::WasLastLoadFromCache() ? "the cache" : "XML" );
+	}
+	report.Printf( "Startup also builds every blueprint from its tree, which costs the same on either path.\n" );
+
+	return report.Finish( reportPath, didAllMatch );
+}
+
+
+//--------------------------------------------------------------------------------------------------------------
+static bool WalkAgentForHazardCheck( Agent& agent, Map& map, const char* agentName, float slowedMultiplier, std::string& inout_report )
+{
+	//Steps one cell at a time the way Agent::MoveOneStep is driven each turn, with no time slice in between.
+	static const int NUM_STEPS = 6;
+	bool didAllMatch = true;
+	for ( int stepNum = 1; stepNum <= NUM_STEPS; stepNum++ )
+	{
+		agent.MoveOneStep( Vector2i( 1, 0 ) );
+
+		bool isOnWater = ( map.GetCellForPosition( agent.GetPositionMins() ).m_cellType == CELL_TYPE_WATER );
+		float expectedMultiplier = isOnWater ? slowedMultiplier : 1.f;
+		float multiplier = map.GetHazards().GetTurnCooldownMultiplierForAgent( &agent );
+		bool doesMatch = ( multiplier == expectedMultiplier );
+		didAllMatch &= doesMatch;
+
+		inout_report += Stringf( "%-8s step %d onto %-5s x%.1f, expected x%.1f, %s\n",
+								 agentName, stepNum, isOnWater ? "water" : "floor", multiplier, expectedMultiplier, doesMatch ? "ok" : "WRONG" );
+	}
+	return didAllMatch;
+}
+
+
+//--------------------------------------------------------------------------------------------------------------
+STATIC bool HeadlessRunner::CheckHazardSlows( const std::string& reportPath )
+{
+	//A floor strip with water at x = 2 to 5, so each walk steps onto floor, across four water cells, then off again.
+	static const int MAP_WIDTH = 8;
+	static const int MAP_HEIGHT = 3;
+	static const float SLOWED_MULTIPLIER = 2.f;
+	Map map( Vector2i( MAP_WIDTH, MAP_HEIGHT ), "hazardcheck" );
+	for ( int cellIndex = 0; cellIndex < MAP_WIDTH * MAP_HEIGHT; cellIndex++ )
+	{
+		int cellX = cellIndex % MAP_WIDTH;
+		map.SetCellTypeForIndex( cellIndex, ( cellX >= 2 && cellX <= 5 ) ? CELL_TYPE_WATER : CELL_TYPE_STONE_FLOOR );
+	}
+	map.GetHazards().RefreshHazardCells( &map );
+
+	std::string report = "Turn cooldown multiplier after each step, no time slice run between steps:\n";
+
+	Agent wader( ENTITY_TYPE_NPC ); //Default traversal properties, which water slows.
+	wader.AttachToMapAtPosition( &map, MapPosition( 0, 0 ) );
+	bool didPass = WalkAgentForHazardCheck( wader, map, "wader", SLOWED_MULTIPLIER, report );
+
+	Player player( ENTITY_TYPE_PLAYER ); //Same walk, one row down, but the player's traversal properties ignore water.
+	player.AttachToMapAtPosition( &map, MapPosition( 0, 1 ) );
+	didPass &= WalkAgentForHazardCheck( player, map, "player", 1.f, report );
+
+	report += didPass ? "PASSED\n" : "FAILED\n";
+	DebuggerPrintf( "%s", report.c_str() );
+	return WriteStringToFile( reportPath, report ) && didPass;
+}
+
+
+//--------------------------------------------------------------------------------------------------------------
+HeadlessRunner::HeadlessRunner()
+	: m_scriptState( 0 )
+	, m_numTurnsSimulated( 0 )
+	, m_firstDivergentTurn( -1 )
+	, m_mapStartupSeconds( 0.0 )
+	, m_simulationSeconds( 0.0 )
+	, m_hashingSeconds( 0.0 )
+	, m_numAllocationCallsDuringTurns( 0 )
+	, m_leakCheckSnapshotTurn( -1 )
+{
+	g_theFrameAllocator = new FrameAllocator();
+	g_theJobSystem = new JobSystem();
+	g_theAudio = new AudioSystem( true );
+	g_theConsole = new TheConsole( 0.0, 0.0, 0.0, 0.0, false, Rgba(), false, .25f, 0.3, nullptr ); //Never rendered, so no font.
+	g_theGame = new TheGame();
+	g_theGame->Startup();
+	g_theGame->SetSimulationTimings( &m_simulationTimings );
+}
+
+
+//--------------------------------------------------------------------------------------------------------------
+HeadlessRunner::~HeadlessRunner()
+{
+	g_theGame->Shutdown();
+	delete g_theGame;
+	delete g_theConsole;
+	delete g_theAudio;
+	delete g_theJobSystem;
+	delete g_theFrameAllocator;
+
+	g_theGame = nullptr;
+	g_theConsole = nullptr;
+	g_theAudio = nullptr;
+	g_theJobSystem = nullptr;
+	g_theFrameAllocator = nullptr;
+}
+
+
+//--------------------------------------------------------------------------------------------------------------
+bool HeadlessRunner::StartSimulation( const HeadlessJournal& journal )
+{
+	double startupStartSeconds = GetCurrentTimeSeconds();
+
+	srand( journal.m_seed ); //In place of SeedWindowsRNG(), so generation and every agent roll repeat.
+	m_scriptState = journal.m_seed;
+	g_mapSimulationTimer = 0.f;
+
+	bool didStart;
+	if ( journal.m_biomeName.empty() )
+		didStart = g_theGame->StartHeadlessGameplayFromSave( journal.m_saveFilename );
+	else
+		didStart = g_theGame->StartHeadlessGameplay( journal.m_biomeName );
+
+	m_mapStartupSeconds = GetCurrentTimeSeconds() - startupStartSeconds;
+	return didStart;
+}
+
+
+//--------------------------------------------------------------------------------------------------------------
+bool HeadlessRunner::Record( HeadlessJournal& inout_journal, int numTurnsToSimulate )
+{
+	if ( !StartSimulation( inout_journal ) )
+		return false;
+
+	inout_journal.m_initialStateHash = CalcStateHash();
+	inout_journal.m_turns.clear();
+
+	for ( int turnIndex = 0; turnIndex < numTurnsToSimulate; turnIndex++ )
+	{
+		if ( turnIndex == m_leakCheckSnapshotTurn )
+			AllocationTracker::TakeSnapshot();
+
+		HeadlessTurnRecord turn;
+		PickScriptedAction( turn.m_action, turn.m_direction );
+
+		bool isPlayerAlive = SimulateOneTurn( turn.m_action, turn.m_direction );
+		turn.m_stateHash = CalcStateHash();
+		inout_journal.m_turns.push_back( turn );
+
+		if ( !isPlayerAlive )
+			break;
+	}
+
+	return true;
+}
+
+
+//--------------------------------------------------------------------------------------------------------------
+bool HeadlessRunner::Replay( const HeadlessJournal& journal )
+{
+	if ( !StartSimulation( journal ) )
+		return false;
+
+	if ( CalcStateHash() != journal.m_initialStateHash )
+	{
+		m_firstDivergentTurn = 0;
+		return false;
+	}
+
+	for ( const HeadlessTurnRecord& turn : journal.m_turns )
+	{
+		SimulateOneTurn( turn.m_action, turn.m_direction );
+
+		if ( CalcStateHash() != turn.m_stateHash )
+		{
+			m_firstDivergentTurn = m_numTurnsSimulated;
+			return false;
+		}
+	}
+
+	return true;
+}
+
+
+//--------------------------------------------------------------------------------------------------------------
+bool HeadlessRunner::SimulateOneTurn( PlayerAction action, MapDirection direction )
+{
+	Player* player = g_theGame->m_player;
+	if ( !player->IsAlive() )
+		return false;
+
+	double turnStartSeconds = GetCurrentTimeSeconds();
+	size_t numAllocationCallsBefore = GetMemoryStats().m_numAllocationCalls;
+
+	//Same loop TheGame::UpdatePlaying runs once per frame, repeated until every agent ahead of the player and the player itself have gone.
+	int numTurnsBefore = player->GetNumTurns();
+	player->SetNextAction( action, direction );
+	for ( int numUpdates = 0; player->IsAlive() && player->GetNumTurns() == numTurnsBefore; numUpdates++ )
+	{
+		GUARANTEE_OR_DIE( numUpdates < s_MAX_UPDATES_PER_TURN, "HeadlessRunner::SimulateOneTurn() never reached the player's turn!" );
+		g_theFrameAllocator->BeginFrame(); //As TheEngine::RunFrame does ahead of each update.
+		FrameProfiler::BeginFrame();
+		g_theGame->UpdateHeadlessSimulation( s_DELTA_SECONDS );
+	}
+	player->SetNextAction( PLAYER_ACTION_UNSPECIFIED ); //Else IsReadyToUpdate() stays true and the player acts again unprompted.
+
+	m_numAllocationCallsDuringTurns += GetMemoryStats().m_numAllocationCalls - numAllocationCallsBefore; //Before clearing the log, which is harness work.
+	g_theConsole->ClearConsoleLog(); //Nobody reads it, and it would otherwise grow every turn of a soak test.
+
+	m_simulationSeconds += GetCurrentTimeSeconds() - turnStartSeconds;
+	++m_numTurnsSimulated;
+
+	return player->IsAlive();
+}
+
+
+//--------------------------------------------------------------------------------------------------------------
+void HeadlessRunner::PickScriptedAction( PlayerAction& out_action, MapDirection& out_direction )
+{
+	m_scriptState = ( m_scriptState * 1664525u ) + 1013904223u; //Numerical Recipes LCG.
+	unsigned int roll = ( m_scriptState >> 16 ) % 100;
+
+	out_direction = DIRECTION_NONE;
+	if ( roll < 85 ) //Mostly wander, which also attacks whatever is in the way.
+	{
+		out_action = PLAYER_ACTION_MOVE;
+		out_direction = (MapDirection)( DIRECTION_UP + ( roll % ( DIRECTION_UP_RIGHT - DIRECTION_UP + 1 ) ) );
+	}
+	else if ( roll < 92 )
+		out_action = PLAYER_ACTION_REST;
+	else if ( roll < 96 )
+		out_action = PLAYER_ACTION_TOGGLE_FEATURE;
+	else
+		out_action = PLAYER_ACTION_USE_ITEM;
+}
+
+
+//--------------------------------------------------------------------------------------------------------------
+unsigned int HeadlessRunner::CalcStateHash()
+{
+	double hashStartSeconds = GetCurrentTimeSeconds();
+
+	unsigned int hash = BENCH_HASH_SEED;
+	HashBenchValue( hash, g_mapSimulationTimer );
+
+	for ( const Cell& cell : g_theGame->m_currentMap->GetCells() )
+		HashBenchValue( hash, cell.m_cellType );
+
+	for ( const GameEntity* entity : g_theGame->m_livingEntities )
+	{
+		HashBenchValue( hash, entity->GetEntityID() );
+		HashBenchValue( hash, entity->GetPositionMins().x );
+		HashBenchValue( hash, entity->GetPositionMins().y );
+		HashBenchValue( hash, entity->GetHealth() );
+	}
+
+	HashBenchValue( hash, g_theGame->m_player->GetHealth() ); //Dead players leave m_livingEntities.
+	HashBenchValue( hash, g_theGame->m_player->GetNumTurns() );
+
+	m_hashingSeconds += GetCurrentTimeSeconds() - hashStartSeconds;
+	return hash;
+}
+
+
+//--------------------------------------------------------------------------------------------------------------
+static unsigned int HashEntityContent( const GameEntity* entity )
+{
+	unsigned int entityHash = BENCH_HASH_SEED;
+	HashBenchValue( entityHash, entity->GetEntityType() );
+	HashBenchValue( entityHash, entity->GetHealth() );
+	HashBenchValue( entityHash, entity->GetMaxHealth() );
+
+	std::string name = entity->GetName();
+	for ( char nameChar : name )
+		HashBenchValue( entityHash, nameChar );
+
+	if ( entity->GetMap() != nullptr ) //Carried items keep stale positions.
+	{
+		HashBenchValue( entityHash, entity->GetPositionMins().x );
+		HashBenchValue( entityHash, entity->GetPositionMins().y );
+	}
+
+	return entityHash;
+}
+
+
+//--------------------------------------------------------------------------------------------------------------
+unsigned int HeadlessRunner::CalcContentHash() const
+{
+	unsigned int hash = BENCH_HASH_SEED;
+	HashBenchValue( hash, g_mapSimulationTimer );
+
+	for ( const Cell& cell : g_theGame->m_currentMap->GetCells() )
+		HashBenchValue( hash, cell.m_cellType );
+
+	//Summed, so the order entities were loaded in doesn't matter.
+	unsigned int entityHashSum = 0;
+	unsigned int numEntities = 0;
+	for ( const GameEntity* entity : g_theGame->m_livingEntities )
+	{
+		if ( entity->GetMap() == nullptr )
+			continue; //Counted through their carrier below.
+
+		entityHashSum += HashEntityContent( entity );
+		++numEntities;
+
+		if ( entity->GetEntityType() != ENTITY_TYPE_NPC && entity->GetEntityType() != ENTITY_TYPE_PLAYER )
+			continue;
+
+		std::vector< Item* > carriedItems = static_cast< const Agent* >( entity )->GetEquipmentAndItems();
+		for ( const Item* carriedItem : carriedItems )
+		{
+			entityHashSum += HashEntityContent( carriedItem ) * 31u; //Else carrying an item would hash like it lying on the map.
+			++numEntities;
+		}
+	}
+	HashBenchValue( hash, entityHashSum );
+	HashBenchValue( hash, numEntities );
+
+	HashBenchValue( hash, g_theGame->m_player->GetNumTurns() );
+	return hash;
+}
+
+
+//--------------------------------------------------------------------------------------------------------------
+static size_t GetFileSizeInBytes( const std::string& filePath )
+{
+	std::vector< unsigned char > buffer;
+	LoadBinaryFileIntoBuffer( filePath, buffer );
+	return buffer.size();
+}
+
+
+//--------------------------------------------------------------------------------------------------------------
+bool HeadlessRunner::BenchmarkSaves( const std::string& reportPath, const HeadlessJournal& journal, int numIterations )
+{
+	if ( !StartSimulation( journal ) || numIterations < 1 )
+		return false;
+
+	for ( int turnIndex = 0; turnIndex < s_NUM_SAVE_BENCH_WARMUP_TURNS; turnIndex++ )
+	{
+		PlayerAction action;
+		MapDirection direction;
+		PickScriptedAction( action, direction );
+		if ( !SimulateOneTurn( action, direction ) )
+			break; //Can't save a dead player, so bench what we have.
+	}
+	if ( !g_theGame->m_player->IsAlive() )
+	{
+		DebuggerPrintf( "HeadlessRunner: the player died during the save benchmark's warmup, try another seed.\n" );
+		return false;
+	}
+
+	const std::string xmlSavePath = reportPath + ".bench.Save.xml";
+	const std::string binarySavePath = reportPath + ".bench" + BinarySaveGame::s_FILE_EXTENSION;
+	const unsigned int savedContentHash = CalcContentHash();
+
+	double xmlSaveSeconds = 0.0;
+	double binarySaveSeconds = 0.0;
+	bool didSave = true;
+	for ( int iteration = 0; iteration < numIterations; iteration++ )
+	{
+		BenchTimer timer;
+		didSave &= g_theGame->SaveGameToFile( xmlSavePath );
+		xmlSaveSeconds += timer.GetElapsedSeconds();
+
+		timer.Restart();
+		didSave &= g_theGame->SaveGameToFile( binarySavePath );
+		binarySaveSeconds += timer.GetElapsedSeconds();
+	}
+
+	//Each load also tears down the previous game, same as TheGame does, and that's billed to both formats alike.
+	double xmlLoadSeconds = 0.0;
+	double binaryLoadSeconds = 0.0;
+	bool didLoad = didSave;
+	bool didXMLRoundTrip = true;
+	bool didBinaryRoundTrip = true;
+	for ( int iteration = 0; didLoad && iteration < numIterations; iteration++ )
+	{
+		BenchTimer timer;
+		didLoad &= g_theGame->StartHeadlessGameplayFromSave( xmlSavePath );
+		xmlLoadSeconds += timer.GetElapsedSeconds();
+		didXMLRoundTrip &= didLoad && ( CalcContentHash() == savedContentHash );
+
+		timer.Restart();
+		didLoad &= g_theGame->StartHeadlessGameplayFromSave( binarySavePath );
+		binaryLoadSeconds += timer.GetElapsedSeconds();
+		didBinaryRoundTrip &= didLoad && ( CalcContentHash() == savedContentHash );
+	}
+
+	//Backgrounded: the main thread only pays for the snapshot, against the whole save it would otherwise block on.
+	double snapshotSeconds = 0.0;
+	double backgroundSaveSeconds = 0.0;
+	bool didBackgroundSave = didLoad;
+	if ( didBackgroundSave )
+	{
+		BackgroundSaver backgroundSaver;
+		BenchTimer timer;
+		backgroundSaver.QueueSave( *g_theGame, reportPath + ".background" + BinarySaveGame::s_FILE_EXTENSION );
+		snapshotSeconds = timer.GetElapsedSeconds();
+		didBackgroundSave = backgroundSaver.WaitForSaves();
+		backgroundSaveSeconds = timer.GetElapsedSeconds();
+	}
+
+	//Journaled: a base, a few more turns, then the delta those turns cost, and that base plus delta loads back the same.
+	SaveJournal saveJournal;
+	const std::string journalSavePath = reportPath + ".journal" + BinarySaveGame::s_FILE_EXTENSION;
+	bool didJournal = didLoad && saveJournal.Save( *g_theGame, journalSavePath );
+	size_t journalBaseNumBytes = saveJournal.GetLastSaveNumBytes();
+	for ( int turnIndex = 0; didJournal && turnIndex < s_NUM_SAVE_BENCH_DELTA_TURNS; turnIndex++ )
+	{
+		PlayerAction action;
+		MapDirection direction;
+		PickScriptedAction( action, direction );
+		didJournal = SimulateOneTurn( action, direction );
+	}
+
+	double deltaSaveSeconds = 0.0;
+	bool didJournalRoundTrip = false;
+	if ( didJournal )
+	{
+		const unsigned int journaledContentHash = CalcContentHash();
+		BenchTimer timer;
+		didJournal = saveJournal.Save( *g_theGame, journalSavePath ) && saveJournal.WasLastSaveDelta();
+		deltaSaveSeconds = timer.GetElapsedSeconds();
+		didJournalRoundTrip = didJournal && g_theGame->StartHeadlessGameplayFromSave( journalSavePath ) && ( CalcContentHash() == journaledContentHash );
+	}
+
+	size_t xmlNumBytes = GetFileSizeInBytes( xmlSavePath );
+	size_t binaryNumBytes = GetFileSizeInBytes( binarySavePath );
+	const char* source = journal.m_biomeName.empty() ? journal.m_saveFilename.c_str() : journal.m_biomeName.c_str();
+
+	BenchReport report;
+	report.Printf( "Headless savebench: %s, seed %u, %d warmup turns, %d iterations\n", source, journal.m_seed, m_numTurnsSimulated, numIterations );
+	report.Printf( "Entities: %u\n", g_theGame->m_livingEntities.size() );
+	report.Printf( "XML    bytes: %u, save ms: %.3f, load ms: %.3f\n", xmlNumBytes, xmlSaveSeconds * 1000.0 / numIterations, xmlLoadSeconds * 1000.0 / numIterations );
+	report.Printf( "Binary bytes: %u, save ms: %.3f, load ms: %.3f\n", binaryNumBytes, binarySaveSeconds * 1000.0 / numIterations, binaryLoadSeconds * 1000.0 / numIterations );
+	report.Printf( "Speedup save: %.1fx, load: %.1fx, size: %.1fx smaller\n",
+				   CalcSpeedup( xmlSaveSeconds, binarySaveSeconds ),
+				   CalcSpeedup( xmlLoadSeconds, binaryLoadSeconds ),
+				   ( binaryNumBytes > 0 ) ? ( (double)xmlNumBytes / (double)binaryNumBytes ) : 0.0 );
+	report.Printf( "Binary round trip: %s\n", didBinaryRoundTrip ? "matched" : "DIFFERED" );
+	report.Printf( "XML round trip: %s\n", didXMLRoundTrip ? "matched" : "differed (XML drops rolled stats and carried item state)" );
+	if ( didBackgroundSave )
+		report.Printf( "Background save main-thread snapshot ms: %.3f, until on disk ms: %.3f\n", snapshotSeconds * 1000.0, backgroundSaveSeconds * 1000.0 );
+	if ( didJournal )
+	{
+		report.Printf( "Journal base bytes: %u, delta bytes after %d turns: %u, delta save ms: %.3f\n",
+					   journalBaseNumBytes, s_NUM_SAVE_BENCH_DELTA_TURNS, saveJournal.GetLastSaveNumBytes(), deltaSaveSeconds * 1000.0 );
+		report.Printf( "Journal round trip: %s\n", didJournalRoundTrip ? "matched" : "DIFFERED" );
+	}
+	else
+	{
+		report.Printf( "Journal skipped, the player died or a journal save failed.\n" );
+	}
+	if ( !didSave || !didLoad )
+		report.Printf( "Save or load FAILED, timings are partial.\n" );
+
+	return report.Finish( reportPath, didSave && didLoad && didBinaryRoundTrip && ( !didJournal || didJournalRoundTrip ) );
+}
+
+
+//--------------------------------------------------------------------------------------------------------------
+static const char* GetSaveChunkName( uint32_t chunkID )
+{
+	switch ( chunkID )
+	{
+		case SAVE_CHUNK_MAP_TERRAIN: return "Terrain";
+		case SAVE_CHUNK_VISIBILITY: return "Visibility";
+		case SAVE_CHUNK_ENTITIES: return "Entities";
+		case SAVE_CHUNK_FACTIONS: return "Factions";
+		case SAVE_CHUNK_SCHEDULER: return "Scheduler";
+		default: return "Unknown";
+	}
+}
+
+
+//--------------------------------------------------------------------------------------------------------------
+bool HeadlessRunner::BenchmarkCompression( const std::string& reportPath, unsigned int seed, int numIterations )
+{
+	if ( numIterations < 1 )
+		numIterations = 1;
+
+	size_t totalRawBytes = 0;
+	size_t totalStoredBytes = 0;
+	double totalDecodeSeconds = 0.0;
+	bool didAllRoundTrip = true;
+
+	BenchReport report;
+	report.Printf( "Headless compressbench: seed %u, %d decode iterations per section\n", seed, numIterations );
+
+	for ( const std::pair< std::string, BiomeBlueprint* >& biome : BiomeBlueprint::GetRegistry() )
+	{
+		HeadlessJournal journal;
+		journal.m_biomeName = biome.first;
+		journal.m_seed = seed;
+		if ( !StartSimulation( journal ) )
+		{
+			report.Printf( "%s: failed to generate, skipped.\n", biome.first.c_str() );
+			didAllRoundTrip = false;
+			continue;
+		}
+
+		BufferBinaryWriter saveWriter;
+		BinarySaveGame::WriteToBuffer( saveWriter, *g_theGame );
+		SaveChunkTable chunks;
+		unsigned int version = 0;
+		BinarySaveGame::ReadChunkTable( saveWriter.GetBuffer().data(), saveWriter.GetNumBytesWritten(), chunks, version );
+
+		report.Printf( "%s:\n", biome.first.c_str() );
+		for ( const SaveChunkTable::value_type& chunk : chunks )
+		{
+			BufferBinaryWriter blockWriter;
+			BenchTimer timer;
+			CompressionCodec codec = WriteCompressedBlock( blockWriter, chunk.second.m_data, chunk.second.m_numBytes );
+			double encodeSeconds = timer.GetElapsedSeconds();
+
+			std::vector< byte_t > decodedBytes;
+			bool didRoundTrip = true;
+			timer.Restart();
+			for ( int iteration = 0; iteration < numIterations; iteration++ )
+			{
+				BufferBinaryReader blockReader( blockWriter.GetBuffer().data(), blockWriter.GetNumBytesWritten() );
+				didRoundTrip &= ReadCompressedBlock( blockReader, decodedBytes );
+			}
+			double decodeSeconds = timer.GetElapsedSeconds() / numIterations;
+
+			didRoundTrip &= ( decodedBytes.size() == chunk.second.m_numBytes )
+				&& ( decodedBytes.empty() || memcmp( decodedBytes.data(), chunk.second.m_data, decodedBytes.size() ) == 0 );
+			didAllRoundTrip &= didRoundTrip;
+
+			report.Printf( "  %-10s raw: %8u, %-4s stored: %8u, ratio: %6.1fx, encode MB/s: %8.1f, decode MB/s: %8.1f%s\n",
+						   GetSaveChunkName( chunk.first ),
+						   chunk.second.m_numBytes,
+						   GetCompressionCodecName( codec ),
+						   blockWriter.GetNumBytesWritten(),
+						   ( blockWriter.GetNumBytesWritten() > 0 ) ? ( (double)chunk.second.m_numBytes / blockWriter.GetNumBytesWritten() ) : 0.0,
+						   CalcMegabytesPerSecond( chunk.second.m_numBytes, encodeSeconds ),
+						   CalcMegabytesPerSecond( chunk.second.m_numBytes, decodeSeconds ),
+						   didRoundTrip ? "" : ", ROUND TRIP FAILED" );
+
+			totalRawBytes += chunk.second.m_numBytes;
+			totalStoredBytes += blockWriter.GetNumBytesWritten();
+			totalDecodeSeconds += decodeSeconds;
+		}
+	}
+
+	report.Printf( "Total raw: %u, stored: %u, ratio: %.1fx, decode MB/s: %.1f\n",
+				   totalRawBytes,
+				   totalStoredBytes,
+				   ( totalStoredBytes > 0 ) ? ( (double)totalRawBytes / totalStoredBytes ) : 0.0,
+				   CalcMegabytesPerSecond( totalRawBytes, totalDecodeSeconds ) );
+	report.Printf( "Round trips: %s\n", didAllRoundTrip ? "matched" : "FAILED" );
+
+	return report.Finish( reportPath, didAllRoundTrip );
+}
+
+
+//--------------------------------------------------------------------------------------------------------------
+bool HeadlessRunner::WriteReport( const std::string& reportPath, const HeadlessJournal& journal, bool wasReplay ) const
+{
+	double turnsPerSecond = ( m_simulationSeconds > 0.0 ) ? ( m_numTurnsSimulated / m_simulationSeconds ) : 0.0;
+	const char* source = journal.m_biomeName.empty() ? journal.m_saveFilename.c_str() : journal.m_biomeName.c_str();
+
+	std::string report;
+	report += Stringf( "Headless %s: %s, seed %u\n", wasReplay ? "replay" : "record", source, journal.m_seed );
+	report += Stringf( "Turns simulated: %d\n", m_numTurnsSimulated );
+	report += Stringf( "Turns per second: %.1f\n", turnsPerSecond );
+	report += Stringf( "Map startup ms: %.3f\n", m_mapStartupSeconds * 1000.0 );
+	report += Stringf( "Simulation ms: %.3f\n", m_simulationSeconds * 1000.0 );
+	report += Stringf( "  Player updates: %d, ms: %.3f\n", m_simulationTimings.m_numPlayerUpdates, m_simulationTimings.m_playerUpdateSeconds * 1000.0 );
+	report += Stringf( "  NPC updates: %d, ms: %.3f\n", m_simulationTimings.m_numNPCUpdates, m_simulationTimings.m_npcUpdateSeconds * 1000.0 );
+	report += Stringf( "  Dead entity cleanup ms: %.3f\n", m_simulationTimings.m_cleanupSeconds * 1000.0 );
+	report += Stringf( "State hashing ms: %.3f\n", m_hashingSeconds * 1000.0 );
+	report += Stringf( "Heap allocations per turn: %.1f\n", ( m_numTurnsSimulated > 0 ) ? ( (double)m_numAllocationCallsDuringTurns / m_numTurnsSimulated ) : 0.0 );
+	report += Stringf( "Frame allocator: %u KB high water, %d frames overflowed\n",
+					   (unsigned int)( g_theFrameAllocator->GetHighWaterBytes() / 1024 ), g_theFrameAllocator->GetNumOverflowedFrames() );
+
+	if ( m_leakCheckSnapshotTurn >= 0 && AllocationTracker::IsTracking() )
+	{
+		report += Stringf( "Leak check, from turn %d on: ", m_leakCheckSnapshotTurn );
+		report += AllocationTracker::GetSnapshotDiffReport( s_NUM_LEAK_CHECK_REPORT_SITES );
+	}
+
+	if ( wasReplay )
+	{
+		if ( m_firstDivergentTurn < 0 )
+			report += Stringf( "Replay matched all %u turns.\n", journal.m_turns.size() );
+		else
+			report += Stringf( "Replay DIVERGED at turn %d.\n", m_firstDivergentTurn );
+	}
+
+	DebuggerPrintf( "%s", report.c_str() );
+	return WriteStringToFile( reportPath, report );
+}
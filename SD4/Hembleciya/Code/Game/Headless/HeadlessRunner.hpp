@@ -0,0 +1,92 @@
+#pragma once
+
+
+#include "Game/GameCommon.hpp"
+#include "Game/Player.hpp"
+#include "Game/TheGame.hpp"
+#include <string>
+#include <vector>
+
+
+//-----------------------------------------------------------------------------
+struct HeadlessTurnRecord
+{
+	PlayerAction m_action;
+	MapDirection m_direction;
+	unsigned int m_stateHash; //Taken after every agent has finished responding to m_action.
+};
+
+
+//-----------------------------------------------------------------------------
+struct HeadlessJournal //Everything needed to reproduce a run bit-exactly: map source, RNG seed, and the player's input each turn.
+{
+	HeadlessJournal() : m_seed( 0 ), m_initialStateHash( 0 ) {}
+
+	bool WriteToFile( const std::string& journalPath ) const;
+	bool ReadFromFile( const std::string& journalPath );
+
+	std::string m_biomeName; //Empty when the run starts from m_saveFilename instead.
+	std::string m_saveFilename;
+	unsigned int m_seed;
+	unsigned int m_initialStateHash;
+	std::vector< HeadlessTurnRecord > m_turns;
+
+	static const int s_VERSION;
+};
+
+
+//-----------------------------------------------------------------------------
+class HeadlessRunner //Drives TheGame's map simulation at full speed without TheRenderer, FMOD, or TheInput.
+{
+public:
+	//Usage: -headless record <journalPath> <biomeNumber|savePath> [seed] [numTurns]
+	//       -headless replay <journalPath>
+	//       -headless savebench <reportPath> <biomeNumber|savePath> [seed] [numIterations]
+	//       -headless compressbench <reportPath> [seed] [numIterations]
+	//       -headless blueprintbench <reportPath> [numIterations]
+	//       -headless leakcheck <journalPath> <biomeNumber|savePath> [seed] [numTurns]
+	//       -headless hazardcheck <reportPath>
+	//       -headless readbench ... queuebench: see EngineBenches, xmlbench defaulting to the save and NPC blueprints.
+	//Biome numbers match the map selection menu. A report, a .metrics.txt, and a .frameprofile.txt are written beside the journal, and for leakcheck a .memory.txt too.
+	static bool IsHeadlessCommandLine( const std::string& commandLine );
+	static int RunFromCommandLine( const std::string& commandLine ); //Returns the process exit code.
+	static bool BenchmarkBlueprintLoading( const std::string& reportPath, int numIterations ); //Blueprint XML vs BlueprintCache, then a real TheGame::Startup.
+	static bool CheckHazardSlows( const std::string& reportPath ); //Walks agents over water on a bare map, false if any step's turn cooldown multiplier is wrong.
+
+	HeadlessRunner(); //Stands up the silent subsystems and TheGame in place of TheEngine::Startup().
+	~HeadlessRunner();
+
+	bool Record( HeadlessJournal& inout_journal, int numTurnsToSimulate ); //Source and seed are read from the journal, turns are written to it.
+	bool Replay( const HeadlessJournal& journal ); //False on the first turn whose state hash differs.
+	bool WriteReport( const std::string& reportPath, const HeadlessJournal& journal, bool wasReplay ) const;
+	bool BenchmarkSaves( const std::string& reportPath, const HeadlessJournal& journal, int numIterations ); //XML vs binary save and load, the files are left beside the report.
+	bool BenchmarkCompression( const std::string& reportPath, unsigned int seed, int numIterations ); //Each save section of every biome's fresh map.
+
+private:
+	bool StartSimulation( const HeadlessJournal& journal );
+	bool SimulateOneTurn( PlayerAction action, MapDirection direction ); //False once the player has died.
+	void PickScriptedAction( PlayerAction& out_action, MapDirection& out_direction );
+	unsigned int CalcStateHash();
+	unsigned int CalcContentHash() const; //Unlike CalcStateHash, ignores entity IDs and order, which a load renumbers.
+
+	unsigned int m_scriptState; //Own LCG so scripted input never disturbs the game's rand() stream.
+	int m_numTurnsSimulated;
+	int m_firstDivergentTurn; //-1 while replay matches, 0 for the initial state, else the 1-based turn.
+	double m_mapStartupSeconds;
+	double m_simulationSeconds;
+	double m_hashingSeconds;
+	uint64_t m_numAllocationCallsDuringTurns; //Through the tracking operator new, i.e. general heap traffic.
+	SimulationTimings m_simulationTimings;
+	int m_leakCheckSnapshotTurn; //-1 unless a leakcheck run, which diffs the allocation tracker against a snapshot taken here.
+
+	static const float s_DELTA_SECONDS;
+	static const int s_MAX_UPDATES_PER_TURN;
+	static const int s_DEFAULT_NUM_TURNS;
+	static const int s_DEFAULT_NUM_SAVE_BENCH_ITERATIONS;
+	static const int s_DEFAULT_NUM_COMPRESS_BENCH_ITERATIONS;
+	static const int s_DEFAULT_NUM_BLUEPRINT_BENCH_ITERATIONS;
+	static const int s_NUM_SAVE_BENCH_WARMUP_TURNS;
+	static const int s_NUM_SAVE_BENCH_DELTA_TURNS;
+	static const int s_LEAK_CHECK_WARMUP_TURN_DIVISOR;
+	static const unsigned int s_NUM_LEAK_CHECK_REPORT_SITES;
+};
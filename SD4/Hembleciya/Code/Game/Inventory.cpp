@@ -2,6 +2,8 @@
 #include "Game/Items/Item.hpp"
 #include "Game/Items/ItemFactory.hpp"
 #include "Engine/FileUtils/XMLUtils.hpp"
+#include "Engine/FileUtils/Writers/BinaryWriter.hpp"
+#include "Engine/FileUtils/Readers/BinaryReader.hpp"
 
 
 //--------------------------------------------------------------------------------------------------------------
@@ -13,6 +15,7 @@ Item* Inventory::PopItem( Map* newMapToAttachTo )
 	Item* item = m_items.back();
 
 	m_items.pop_back(); 
+	GetBucketForItem( item ).pop_back(); //Also the back of its bucket, since buckets keep acquisition order.
 
 	item->SetCurrentMap( newMapToAttachTo );
 
@@ -23,11 +26,34 @@ Item* Inventory::PopItem( Map* newMapToAttachTo )
 //--------------------------------------------------------------------------------------------------------------
 void Inventory::PushItem( Item* item )
 {
-	for ( Item* existingItem : m_items )
-		if ( existingItem == item ) //May be trouble down the line doing shallow compare.
-			return;
+	ASSERT_OR_DIE( item->GetItemType() < NUM_ITEM_TYPES, "Inventory::PushItem given an item without a valid ItemType!" );
+
+	InventoryTypeBucket& bucket = GetBucketForItem( item );
+	if ( bucket.find( item ) != bucket.end() ) //May be trouble down the line doing shallow compare.
+		return;
 
 	m_items.push_back( item );
+	bucket.push_back( item );
+}
+
+
+//--------------------------------------------------------------------------------------------------------------
+bool Inventory::ContainsItem( Item* item ) const
+{
+	const InventoryTypeBucket& bucket = m_itemsByType[ item->GetItemType() ];
+	for ( Item* existingItem : bucket )
+		if ( existingItem == item )
+			return true;
+
+	return false;
+}
+
+
+//--------------------------------------------------------------------------------------------------------------
+Item* Inventory::GetLastAcquiredItemOfType( ItemType type ) const
+{
+	const InventoryTypeBucket& bucket = m_itemsByType[ type ];
+	return bucket.empty() ? nullptr : bucket.back();
 }
 
 
@@ -50,15 +76,13 @@ void Inventory::HideItems()
 //--------------------------------------------------------------------------------------------------------------
 void Inventory::EraseItem( Item* item )
 {
-	for ( std::vector< Item* >::iterator itemIter = m_items.begin(); itemIter != m_items.end(); )
-	{
-		if ( *itemIter == item )
-		{
-			m_items.erase( itemIter );
-			return;
-		}
-		else ++itemIter;
-	}
+	InventoryTypeBucket& bucket = GetBucketForItem( item );
+	InventoryTypeBucket::iterator bucketIter = bucket.find( item );
+	if ( bucketIter == bucket.end() )
+		return; //Not ours, so skip the scan over every other type.
+
+	bucket.erase( bucketIter );
+	m_items.erase( m_items.find( item ) );
 }
 
 
@@ -93,4 +117,28 @@ void Inventory::PopulateFromXMLNode( const XMLNode& inventoryNode )
 		ItemFactory* factory = registry.at( inventoryItemNode.getAttribute( GetAsLowercase( itemTypeAsString ).c_str() ) );
 		PushItem( factory->CreateItem() );
 	}
-}
\ No newline at end of file
+}
+
+
+//--------------------------------------------------------------------------------------------------------------
+void Inventory::WriteToBinary( BinaryWriter& writer ) const
+{
+	writer.Write<uint32_t>( m_items.size() );
+	for ( const Item* item : m_items )
+		item->WriteBinaryRecord( writer );
+}
+
+
+//--------------------------------------------------------------------------------------------------------------
+void Inventory::PopulateFromBinary( BinaryReader& reader )
+{
+	uint32_t numItems = 0;
+	reader.Read<uint32_t>( &numItems );
+
+	for ( uint32_t itemIndex = 0; itemIndex < numItems; itemIndex++ )
+	{
+		Item* item = Item::CreateFromBinaryRecord( reader, nullptr );
+		if ( item != nullptr )
+			PushItem( item );
+	}
+}
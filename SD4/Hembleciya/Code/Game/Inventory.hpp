@@ -1,30 +1,47 @@
 #pragma once
-#include <vector>
+
+
+#include "Engine/Memory/SmallVector.hpp"
+#include "Game/Items/Item.hpp"
+
 
 //-----------------------------------------------------------------------------
-class Item;
 class Map;
 struct XMLNode;
+class BinaryWriter;
+class BinaryReader;
+
+
+//-----------------------------------------------------------------------------
+static const unsigned int INVENTORY_INLINE_CAPACITY = 8; //Covers typical NPC inventories and floor piles without touching the heap.
+static const unsigned int INVENTORY_TYPE_BUCKET_INLINE_CAPACITY = 4;
+typedef SmallVector< Item*, INVENTORY_INLINE_CAPACITY > InventoryItemList;
+typedef SmallVector< Item*, INVENTORY_TYPE_BUCKET_INLINE_CAPACITY > InventoryTypeBucket;
 
 
 //-----------------------------------------------------------------------------
 class Inventory
 {
-	std::vector< Item* > m_items;
+	InventoryItemList m_items; //Acquisition order: PopItem takes the back, the top glyph is the front.
+	InventoryTypeBucket m_itemsByType[ NUM_ITEM_TYPES ]; //Same items, same order, bucketed so per-type queries skip the rest.
 
 public:
 	Inventory() {}
 	Inventory( const XMLNode& inventoryNode ) { PopulateFromXMLNode( inventoryNode ); }
-	Inventory( const Inventory& other )
+	Inventory( const Inventory& other ) : m_items( other.m_items )
 	{
-		for ( Item* item : other.m_items )
-			PushItem( item );
+		for ( int itemType = 0; itemType < NUM_ITEM_TYPES; itemType++ )
+			m_itemsByType[ itemType ] = other.m_itemsByType[ itemType ];
 	}
 
-	std::vector< Item* >& GetItems() { return m_items; }
+	const InventoryItemList& GetItems() const { return m_items; } //Read-only: change it by PushItem, PopItem, and EraseItem, which keep m_itemsByType in step.
+	const InventoryTypeBucket& GetItemsOfType( ItemType type ) const { return m_itemsByType[ type ]; }
+	Item* GetLastAcquiredItemOfType( ItemType type ) const;
+	bool ContainsItem( Item* item ) const; //Scans only the item's type bucket.
 	Item* PopItem( Map* newMapToAttachTo );
 	void PushItem( Item* item ); //Forbids duplicates.
 	unsigned int GetCount() const { return m_items.size(); }
+	unsigned int GetCountOfType( ItemType type ) const { return m_itemsByType[ type ].size(); }
 
 	void ShowItem();
 	void HideItems();
@@ -33,4 +50,10 @@ public:
 
 	void WriteToXMLNode( XMLNode& inventoryNode );
 	void PopulateFromXMLNode( const XMLNode& inventoryNode );
-};
\ No newline at end of file
+	void WriteToBinary( BinaryWriter& writer ) const; //Full item state, unlike the XML's factory names.
+	void PopulateFromBinary( BinaryReader& reader );
+
+
+private:
+	InventoryTypeBucket& GetBucketForItem( Item* item ) { return m_itemsByType[ item->GetItemType() ]; }
+};
@@ -2,7 +2,10 @@
 #include "Game/Behaviors/Behavior.hpp"
 #include "Game/FieldOfView/FieldOfView.hpp"
 #include "Game/Map.hpp"
+#include "Game/Items/ItemFactory.hpp"
 #include "Engine/Renderer/TheRenderer.hpp"
+#include "Engine/FileUtils/Writers/BinaryWriter.hpp"
+#include "Engine/FileUtils/Readers/BinaryReader.hpp"
 
 
 //--------------------------------------------------------------------------------------------------------------
@@ -167,6 +170,76 @@ void Item::WriteToXMLNode( XMLNode& out_entityDataNode )
 }
 
 
+//--------------------------------------------------------------------------------------------------------------
+void Item::WriteToBinary( BinaryWriter& writer ) const
+{
+	GameEntity::WriteToBinary( writer );
+
+	//Valid slots come from the blueprint, only the rolled and modifiable values are instance state.
+	writer.Write<int>( m_weaponDamage );
+	writer.Write<int>( m_armorDefense );
+}
+
+
+//--------------------------------------------------------------------------------------------------------------
+void Item::PopulateFromBinary( BinaryReader& reader, Map* map )
+{
+	GameEntity::PopulateFromBinary( reader, map );
+
+	if ( m_map != nullptr ) //Then we need to occupy a cell's inventory.
+	{
+		Cell& cell = m_map->GetCellForPosition( GetPositionMins() );
+		cell.PushItem( this );
+	}
+
+	reader.Read<int>( &m_weaponDamage ); //Overrides the factory's random roll.
+	reader.Read<int>( &m_armorDefense );
+}
+
+
+//--------------------------------------------------------------------------------------------------------------
+void Item::WriteBinaryRecord( BinaryWriter& writer ) const
+{
+	writer.Write<byte_t>( (byte_t)m_itemType );
+	writer.WriteString( m_name.GetCString() );
+	WriteToBinary( writer );
+}
+
+
+//--------------------------------------------------------------------------------------------------------------
+STATIC Item* Item::CreateFromBinaryRecord( BinaryReader& reader, Map* map )
+{
+	byte_t itemTypeAsByte = NUM_ITEM_TYPES;
+	std::string factoryName;
+	reader.Read<byte_t>( &itemTypeAsByte );
+	reader.ReadString( factoryName );
+
+	ItemType itemType = (ItemType)itemTypeAsByte;
+	ItemFactory* factory = nullptr;
+	if ( itemType < NUM_ITEM_TYPES )
+	{
+		ItemFactoryCategory& registry = ItemFactory::GetRegistryForItemType( itemType );
+		ItemFactoryCategory::iterator found = registry.find( factoryName );
+		if ( found != registry.end() )
+			factory = found->second;
+	}
+
+	if ( factory == nullptr )
+	{
+		DebuggerPrintf( "Item::CreateFromBinaryRecord() failed to find ItemFactory for %s!", factoryName.c_str() );
+
+		//Still read the rest of the record, else everything after it in e.g. an inventory would be misread.
+		Item discardedItem( XMLNode::emptyNode(), nullptr );
+		discardedItem.PopulateFromBinary( reader, nullptr );
+		return nullptr;
+	}
+
+	Item* newItem = factory->CreateItem();
+	newItem->PopulateFromBinary( reader, map );
+	return newItem;
+}
+
+
 //--------------------------------------------------------------------------------------------------------------
 void Item::SetOccupiedCellsItemTo( Item* item )
 {
@@ -70,6 +70,9 @@ public:
 	void Show() { m_isHidden = false; }
 
 	virtual void WriteToXMLNode( XMLNode& out_entityDataNode ) override;
+	virtual void WriteToBinary( BinaryWriter& writer ) const override;
+	void WriteBinaryRecord( BinaryWriter& writer ) const; //Type and factory name, then WriteToBinary.
+	static Item* CreateFromBinaryRecord( BinaryReader& reader, Map* map ); //Nullptr if the factory's gone, but the record is still consumed.
 	int GetWeaponDamage() const { return m_weaponDamage; }
 	int GetArmorDefense() const { return m_armorDefense; }
 	void SetWeaponDamage( int newVal ) { m_weaponDamage = newVal; }
@@ -83,6 +86,7 @@ public:
 	
 private:
 	virtual void PopulateFromXMLNode( const XMLNode& itemBlueprintNode, Map* map ) override;
+	virtual void PopulateFromBinary( BinaryReader& reader, Map* map ) override;
 	virtual void ResolvePointersToEntities( std::map< EntityID, GameEntity* >& loadedEntities ) override;
 
 	ItemType m_itemType;
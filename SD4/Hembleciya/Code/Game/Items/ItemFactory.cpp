@@ -34,34 +34,26 @@ void ItemFactory::SetItemType( ItemType type )
 
 
 //--------------------------------------------------------------------------------------------------------------
-STATIC void ItemFactory::LoadAllItemBlueprints()
+STATIC void ItemFactory::LoadItemBlueprintsFromXML( const XMLNode& blueprintsRoot )
 {
 	//Note we may have more than one Item in a file.
-	std::vector< std::string > m_itemFiles = EnumerateFilesInDirectory( "Data/XML/Items", "*.Item.xml" );
-
-	for ( unsigned int itemFileIndex = 0; itemFileIndex < m_itemFiles.size(); itemFileIndex++ )
+	for ( int itemBlueprintIndex = 0; itemBlueprintIndex < blueprintsRoot.nChildNode(); itemBlueprintIndex++ )
 	{
-		const char* xmlFilename = m_itemFiles[ itemFileIndex ].c_str();
-		XMLNode blueprintsRoot = XMLNode::openFileHelper( xmlFilename, "ItemBlueprints" );
-
-		for ( int itemBlueprintIndex = 0; itemBlueprintIndex < blueprintsRoot.nChildNode(); itemBlueprintIndex++ )
-		{
-			XMLNode itemBlueprintNode = blueprintsRoot.getChildNode( itemBlueprintIndex );
+		XMLNode itemBlueprintNode = blueprintsRoot.getChildNode( itemBlueprintIndex );
 
-			ItemFactory* newFactory = new ItemFactory( itemBlueprintNode ); //Each ItemFactory corresponds to a ItemBlueprint element.
-			newFactory->m_name = ReadXMLAttribute( itemBlueprintNode, "name", newFactory->m_name );
+		ItemFactory* newFactory = new ItemFactory( itemBlueprintNode ); //Each ItemFactory corresponds to a ItemBlueprint element.
+		newFactory->m_name = ReadXMLAttribute( itemBlueprintNode, "name", newFactory->m_name );
 
-			std::string itemTypeAsString;
-			itemTypeAsString = ReadXMLAttribute( itemBlueprintNode, "type", itemTypeAsString );
-			newFactory->SetItemType( GetItemTypeForString( itemTypeAsString ) );
+		std::string itemTypeAsString;
+		itemTypeAsString = ReadXMLAttribute( itemBlueprintNode, "type", itemTypeAsString );
+		newFactory->SetItemType( GetItemTypeForString( itemTypeAsString ) );
 
-			ItemFactoryCategory& categoryRegistry = s_itemFactoryRegistry[ newFactory->m_factoryItemType ];
+		ItemFactoryCategory& categoryRegistry = s_itemFactoryRegistry[ newFactory->m_factoryItemType ];
 
-			if ( categoryRegistry.find( newFactory->m_name ) != categoryRegistry.end() )
-				ERROR_AND_DIE( Stringf( "Found duplicate Item factory type/name %s in LoadAllItemBlueprints!", newFactory->m_name.c_str() ) );
+		if ( categoryRegistry.find( newFactory->m_name ) != categoryRegistry.end() )
+			ERROR_AND_DIE( Stringf( "Found duplicate Item factory type/name %s in LoadItemBlueprintsFromXML!", newFactory->m_name.c_str() ) );
 
-			categoryRegistry.insert( std::pair< std::string, ItemFactory* >( newFactory->m_name, newFactory ) );
-		}
+		categoryRegistry.insert( std::pair< std::string, ItemFactory* >( newFactory->m_name, newFactory ) );
 	}
 }
 
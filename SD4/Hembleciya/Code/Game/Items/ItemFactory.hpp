@@ -22,7 +22,7 @@ class ItemFactory
 {
 public:
 	ItemFactory( const XMLNode& itemBlueprintNode ) { PopulateFromXMLNode( itemBlueprintNode ); }
-	static void LoadAllItemBlueprints();
+	static void LoadItemBlueprintsFromXML( const XMLNode& blueprintsRoot ); //One file's root, from BlueprintCache.
 	Item* CreateItem( Map* map = nullptr, const XMLNode& itemInstanceNode = XMLNode::emptyNode() );
 	static ItemFactoryCategory& GetRegistryForItemType( ItemType type ) { return s_itemFactoryRegistry[ type ]; }
 
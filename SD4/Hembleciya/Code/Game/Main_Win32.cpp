@@ -3,12 +3,14 @@
 
 #include "Game/TheApp.hpp"
 #include "Engine/TheEngine.hpp"
+#include "Game/Headless/HeadlessRunner.hpp"
 
 
 //--------------------------------------------------------------------------------------------------------------
 int WINAPI WinMain( HINSTANCE applicationInstanceHandle, HINSTANCE, LPSTR commandLineString, int )
 {
-	UNREFERENCED_PARAMETER( commandLineString );
+	if ( HeadlessRunner::IsHeadlessCommandLine( commandLineString ) )
+		return HeadlessRunner::RunFromCommandLine( commandLineString ); //No window, renderer, FMOD, or input.
 
 	g_theApp = new TheApp();
 	g_theApp->Startup( applicationInstanceHandle );
@@ -2,9 +2,14 @@
 #include "Engine/Renderer/TheRenderer.hpp"
 #include "Engine/Core/Command.hpp"
 #include "Engine/String/StringUtils.hpp"
+#include "Engine/String/StringParsing.hpp"
+#include "Engine/String/StringFormat.hpp"
 #include "Game/Pathfinding/PathNode.hpp"
 #include "Engine/Math/MathUtils.hpp"
 #include "Engine/FileUtils/XMLUtils.hpp"
+#include "Engine/Time/Profiler.hpp"
+#include "Engine/FileUtils/Writers/BinaryWriter.hpp"
+#include "Engine/FileUtils/Readers/BinaryReader.hpp"
 
 
 //--------------------------------------------------------------------------------------------------------------
@@ -15,8 +20,11 @@ STATIC void Map::ShowMap( Command& /*args*/ )
 
 
 //--------------------------------------------------------------------------------------------------------------
-void Map::GetAdjacentNeighborCells( const MapPosition& centerCellPos, float radiusFromCenterCell, bool includeDiagonals, std::vector< Cell* >& out_neighbors )
+void Map::GetAdjacentNeighborCells( const MapPosition& centerCellPos, float radiusFromCenterCell, bool includeDiagonals, FrameVector< Cell* >& out_neighbors )
 {
+	//One reservation for the most this can add, so a caller's local vector is a single frame allocation it hands straight back.
+	out_neighbors.reserve( out_neighbors.size() + ( (int)radiusFromCenterCell * ( includeDiagonals ? 8 : 4 ) ) );
+
 	//Starts at 1 to exclude the center itself.
 	for ( int currentRadius = 1; currentRadius <= radiusFromCenterCell; currentRadius++  )
 	{
@@ -181,52 +189,69 @@ MapPosition Map::GetRandomMapPosition( bitfield_int blockedProperties )
 void Map::WriteToXMLNode( XMLNode& out_mapNode )
 {
 	WriteXMLAttribute( out_mapNode, "mapName", m_mapName, std::string() );
-	WriteXMLAttribute( out_mapNode, "mapSize", Stringf( "%d,%d", m_size.x, m_size.y ), std::string() );
+	InlineFormatBuffer< 32 > mapSize;
+	AppendXMLAttributeValue( mapSize, m_size );
+	out_mapNode.addAttribute( "mapSize", mapSize.GetCString() );
 
+	FormatBuffer mapDataText; //Shared by both planes, so the second reuses the first's allocation.
+	Map::AppendAsString( mapDataText, this, false, 2 );
 	XMLNode tileDataNode = out_mapNode.addChild( "TileData" );
-	tileDataNode.addText( Map::GetAsString( this, false, 2 ).c_str() );
+	tileDataNode.addText( mapDataText.GetCString() );
 
+	mapDataText.Clear();
+	Map::AppendAsString( mapDataText, this, false, 2, true, true );
 	XMLNode visibilityDataNode = out_mapNode.addChild( "VisibilityData" );
-	visibilityDataNode.addText( Map::GetAsString( this, false, 2, true, true ).c_str() );
+	visibilityDataNode.addText( mapDataText.GetCString() );
 }
 
 
 //--------------------------------------------------------------------------------------------------------------
 STATIC std::string Map::GetAsString( Map* map, bool wasMapFromXML, int numTabs /*= 0*/, bool includeNewlines /*= true */, bool onlyShowKnownCells /*= false*/ )
 {
-	std::string mapAsString = "\n"; //Start off on the next line after the data element.
-	std::string tabString = "";
-	for ( int numTab = 0; numTab < numTabs; ++numTab )
-		tabString += '\t';
+	FormatBuffer mapAsString;
+	AppendAsString( mapAsString, map, wasMapFromXML, numTabs, includeNewlines, onlyShowKnownCells );
+	return mapAsString.ToString();
+}
+
+
+//--------------------------------------------------------------------------------------------------------------
+STATIC void Map::AppendAsString( FormatBuffer& inout_buffer, Map* map, bool wasMapFromXML, int numTabs /*= 0*/, bool includeNewlines /*= true */, bool onlyShowKnownCells /*= false*/ )
+{
+	//Reserve all of it up front, then fill each row in place, rather than growing a char at a time.
+	const int numCharsPerRow = numTabs + map->m_size.x + ( includeNewlines ? 1 : 0 );
+	const int numTrailingTabs = ( numTabs > 0 ) ? numTabs - 1 : 0;
+	inout_buffer.Reserve( inout_buffer.GetLength() + 1 + ( numCharsPerRow * map->m_size.y ) + numTrailingTabs );
+
+	inout_buffer.Append( '\n' ); //Start off on the next line after the data element.
 
 	//Iterate strings' rows in reverse, else comes out upside down.
 	for ( int y = map->m_size.y - 1; y >= 0; y-- )
 	{
-		mapAsString += tabString; //Start newline with tabbing.
+		char* row = inout_buffer.Extend( numCharsPerRow );
+		memset( row, '\t', numTabs ); //Start newline with tabbing.
+		row += numTabs;
 
 		for ( int x = 0; x < map->m_size.x; x++ )
 		{
 			Cell& cell = map->GetCellForPosition( MapPosition( x, y ) );
 			char candidateGlyph = ( wasMapFromXML ) ? cell.m_parsedMapGlyph : GetGlyphForCell( cell, true );
-			mapAsString += ( onlyShowKnownCells && !cell.HasBeenSeenBefore() ) ? '_' : candidateGlyph;
+			*row++ = ( onlyShowKnownCells && !cell.HasBeenSeenBefore() ) ? '_' : candidateGlyph;
 			//e.g. dream maps parse their glyphs, but generated maps do not.
 		}
 
 		if ( includeNewlines )
-			mapAsString += '\n';
+			*row = '\n';
 	}
 
-	if ( numTabs > 0 )
-		for ( int numTab = 0; numTab < numTabs - 1; ++numTab )
-		mapAsString += '\t'; //Indent next line normally else it seems to override.
-
-	return mapAsString;
+	inout_buffer.AppendRepeated( '\t', numTrailingTabs ); //Indent next line normally else it seems to override.
 }
 
 
 //--------------------------------------------------------------------------------------------------------------
 void Map::RefreshCellOccupantVisibility()
 {
+	PROFILE_SCOPE( "Map::RefreshCellOccupantVisibility" );
+
 	for ( Cell& cell : m_cells )
 	{
 		if ( cell.IsCurrentlySeen() )
@@ -311,6 +336,8 @@ Map::Map( const Vector2i& size, const std::string& mapName )
 //--------------------------------------------------------------------------------------------------------------
 void Map::RefreshTraversableCells()
 {
+	PROFILE_SCOPE( "Map::RefreshTraversableCells" );
+
 	for ( int x = 0; x < m_size.x; x++ )
 	{
 		for ( int y = 0; y < m_size.y; y++ )
@@ -320,6 +347,8 @@ void Map::RefreshTraversableCells()
 				m_traversableCells.push_back( currentPos );
 		}
 	}
+
+	m_hazards.RefreshHazardCells( this );
 }
 
 
@@ -338,25 +367,49 @@ void Map::RefreshCellColors() //Right now flops for dream maps because they can
 
 
 //--------------------------------------------------------------------------------------------------------------
-STATIC Map* Map::CreateFromTileDataStringWithNewlines( const char* tileDataString, const std::string& mapName )
+static inline StringView GetMapDataRow( const StringView& line ) //Without the XML's indenting tabs or any '\r'.
+{
+	return line.GetTrimmed( "\t\r" );
+}
+
+
+//--------------------------------------------------------------------------------------------------------------
+static int CountMapDataRows( const char* mapDataString, StringView& out_firstRow )
 {
-	std::vector< std::string > mapRowsStrings = SplitString( tileDataString, '\n', true );
+	int numRows = 0;
+	StringView line;
+	for ( StringTokenizer lines( mapDataString, "\n", true ); lines.Next( line ); numRows++ )
+		if ( numRows == 0 )
+			out_firstRow = GetMapDataRow( line );
+
+	return numRows;
+}
+
 
-	int mapWidth = mapRowsStrings[ 0 ].size();
-	int mapHeight = mapRowsStrings.size();
+//--------------------------------------------------------------------------------------------------------------
+STATIC Map* Map::CreateFromTileDataStringWithNewlines( const char* tileDataString, const std::string& mapName )
+{
+	//Rows are counted first, so each can then go straight into its cells without a vector of row strings.
+	StringView firstRow;
+	int mapHeight = CountMapDataRows( tileDataString, firstRow );
+	int mapWidth = firstRow.GetLength();
 
 	Map* newMap = new Map( Vector2i( mapWidth, mapHeight ), mapName );
 
-	for ( int y = 0; y < mapHeight; y++ )
+	StringView line;
+	int rowIndex = 0;
+	for ( StringTokenizer lines( tileDataString, "\n", true ); lines.Next( line ); rowIndex++ )
 	{
-		//Iterate strings' rows in reverse, else comes out upside down.
-		const std::string& currentMapRowString = mapRowsStrings[ ( mapHeight - 1 ) - y ];
+		//The text's first row is the top, y == mapHeight - 1, else it comes out upside down.
+		StringView currentMapRow = GetMapDataRow( line );
+		int y = ( mapHeight - 1 ) - rowIndex;
 		for ( int x = 0; x < mapWidth; x++ )
 		{
 			Cell& currentCell = newMap->m_cells[ newMap->GetIndexForPosition( Vector2i( x, y ) ) ];
 
-			currentCell.m_parsedMapGlyph = currentMapRowString[ x ];
-			currentCell.m_cellType = GetCellTypeForGlyph( currentMapRowString[ x ] );
+			char glyph = ( x < (int)currentMapRow.GetLength() ) ? currentMapRow[ x ] : '\0'; //A short row's missing cells are dreamt.
+			currentCell.m_parsedMapGlyph = glyph;
+			currentCell.m_cellType = GetCellTypeForGlyph( glyph );
 			currentCell.m_color = GetColorForCellType( currentCell.m_cellType );
 		}
 	}
@@ -370,19 +423,21 @@ STATIC Map* Map::CreateFromTileDataStringWithNewlines( const char* tileDataStrin
 //--------------------------------------------------------------------------------------------------------------
 STATIC Map* Map::InitializeFromVisibilityDataStringWithNewlines( const char* visibilityDataString, Map* tilesReadiedMap )
 {
-	std::vector< std::string > mapRowsStrings = SplitString( visibilityDataString, '\n', true );
+	StringView firstRow;
+	int mapHeight = CountMapDataRows( visibilityDataString, firstRow );
+	int mapWidth = firstRow.GetLength();
 
-	int mapWidth = mapRowsStrings[ 0 ].size();
-	int mapHeight = mapRowsStrings.size();
-
-	for ( int y = 0; y < mapHeight; y++ )
+	StringView line;
+	int rowIndex = 0;
+	for ( StringTokenizer lines( visibilityDataString, "\n", true ); lines.Next( line ); rowIndex++ )
 	{
 		//Could probably iterate forward here, just being consistent:
-		const std::string& currentMapRowString = mapRowsStrings[ ( mapHeight - 1 ) - y ];
-		for ( int x = 0; x < mapWidth; x++ )
+		StringView currentMapRow = GetMapDataRow( line );
+		int y = ( mapHeight - 1 ) - rowIndex;
+		for ( int x = 0; x < mapWidth && x < (int)currentMapRow.GetLength(); x++ )
 		{
 			Cell& currentCell = tilesReadiedMap->m_cells[ tilesReadiedMap->GetIndexForPosition( Vector2i( x, y ) ) ];
-			if ( currentMapRowString[x] != '_' )
+			if ( currentMapRow[ x ] != '_' )
 				currentCell.SetHasBeenSeenBefore();
 		}
 	}
@@ -391,6 +446,113 @@ STATIC Map* Map::InitializeFromVisibilityDataStringWithNewlines( const char* vis
 }
 
 
+//--------------------------------------------------------------------------------------------------------------
+void Map::WriteTerrainToBinary( BinaryWriter& writer ) const
+{
+	writer.WriteString( m_mapName.c_str() );
+	writer.Write<int>( m_size.x );
+	writer.Write<int>( m_size.y );
+
+	//Row-major from y == 0 like m_cells, so unlike TileData there's no reversing, and it goes out in a single write.
+	std::vector< char > glyphPlane( m_cells.size() );
+	for ( unsigned int cellIndex = 0; cellIndex < m_cells.size(); cellIndex++ )
+		glyphPlane[ cellIndex ] = GetGlyphForCell( m_cells[ cellIndex ], true );
+
+	if ( !glyphPlane.empty() )
+		writer.WriteBytes( glyphPlane.data(), glyphPlane.size() );
+}
+
+
+//--------------------------------------------------------------------------------------------------------------
+STATIC Map* Map::CreateFromBinaryTerrain( BinaryReader& reader )
+{
+	std::string mapName;
+	Vector2i mapSize;
+	reader.ReadString( mapName );
+	if ( !reader.Read<int>( &mapSize.x ) || !reader.Read<int>( &mapSize.y ) || mapSize.x <= 0 || mapSize.y <= 0 )
+		return nullptr;
+
+	//Straight out of the mapped save or buffer when the reader can, else copied.
+	unsigned int numCells = mapSize.x * mapSize.y;
+	std::vector< char > copiedGlyphPlane;
+	const char* glyphPlane = (const char*)reader.ReadBytesInPlace( numCells );
+	if ( glyphPlane == nullptr )
+	{
+		copiedGlyphPlane.resize( numCells );
+		if ( reader.ReadBytes( copiedGlyphPlane.data(), numCells ) != numCells )
+			return nullptr;
+		glyphPlane = copiedGlyphPlane.data();
+	}
+
+	Map* newMap = new Map( mapSize, mapName );
+	for ( unsigned int cellIndex = 0; cellIndex < numCells; cellIndex++ )
+	{
+		Cell& currentCell = newMap->m_cells[ cellIndex ];
+		currentCell.m_parsedMapGlyph = glyphPlane[ cellIndex ];
+		currentCell.m_cellType = GetCellTypeForGlyph( glyphPlane[ cellIndex ] );
+		currentCell.m_color = GetColorForCellType( currentCell.m_cellType );
+	}
+
+	return newMap;
+}
+
+
+//--------------------------------------------------------------------------------------------------------------
+void Map::WriteVisibilityToBinary( BinaryWriter& writer ) const
+{
+	unsigned int numBytesPerPlane = ( m_cells.size() + 7 ) / 8;
+	std::vector< byte_t > seenBeforePlane( numBytesPerPlane, 0 );
+	std::vector< byte_t > hiddenPlane( numBytesPerPlane, 0 );
+
+	for ( unsigned int cellIndex = 0; cellIndex < m_cells.size(); cellIndex++ )
+	{
+		byte_t cellBit = (byte_t)GET_BIT_AT_BITFIELD_INDEX( cellIndex % 8 );
+		if ( m_cells[ cellIndex ].HasBeenSeenBefore() )
+			seenBeforePlane[ cellIndex / 8 ] |= cellBit;
+		if ( m_cells[ cellIndex ].m_isHidden )
+			hiddenPlane[ cellIndex / 8 ] |= cellBit;
+	}
+
+	writer.Write<uint32_t>( m_cells.size() );
+	if ( numBytesPerPlane > 0 )
+	{
+		writer.WriteBytes( seenBeforePlane.data(), numBytesPerPlane );
+		writer.WriteBytes( hiddenPlane.data(), numBytesPerPlane );
+	}
+}
+
+
+//--------------------------------------------------------------------------------------------------------------
+bool Map::PopulateVisibilityFromBinary( BinaryReader& reader )
+{
+	uint32_t numCells = 0;
+	if ( !reader.Read<uint32_t>( &numCells ) || numCells != m_cells.size() )
+		return false; //Doesn't match the terrain plane, caller falls back to HideOccludedCells().
+
+	unsigned int numBytesPerPlane = ( numCells + 7 ) / 8;
+	std::vector< byte_t > copiedPlanes;
+	const byte_t* seenBeforePlane = (const byte_t*)reader.ReadBytesInPlace( numBytesPerPlane * 2 );
+	if ( seenBeforePlane == nullptr )
+	{
+		copiedPlanes.resize( numBytesPerPlane * 2 );
+		if ( reader.ReadBytes( copiedPlanes.data(), copiedPlanes.size() ) != copiedPlanes.size() )
+			return false;
+		seenBeforePlane = copiedPlanes.data();
+	}
+	const byte_t* hiddenPlane = seenBeforePlane + numBytesPerPlane; //Written back to back.
+
+	for ( unsigned int cellIndex = 0; cellIndex < m_cells.size(); cellIndex++ )
+	{
+		byte_t cellBit = (byte_t)GET_BIT_AT_BITFIELD_INDEX( cellIndex % 8 );
+		if ( ( seenBeforePlane[ cellIndex / 8 ] & cellBit ) != 0 )
+			m_cells[ cellIndex ].SetHasBeenSeenBefore();
+		m_cells[ cellIndex ].m_isHidden = ( ( hiddenPlane[ cellIndex / 8 ] & cellBit ) != 0 );
+	}
+
+	return true;
+}
+
+
 //--------------------------------------------------------------------------------------------------------------
 void Map::Render()
 { 
@@ -582,7 +744,7 @@ unsigned int Map::CountCellsWithFeaturesAroundCenter( const MapPosition& centerC
 {
 	//Neighbors == all 4 or 8 cells around a given cell. Any results off the edges of the map are considered solid.
 
-	std::vector< Cell* > neighbors;
+	FrameVector< Cell* > neighbors;
 	GetAdjacentNeighborCells( centerCellPos, radiusFromCenterCell, considerDiagonals, neighbors );
 
 	unsigned int numFeatures = 0;
@@ -600,13 +762,28 @@ unsigned int Map::GetNumNeighborsAroundCellOfType( const Vector2i& centerCellPos
 {
 	//Neighbors == all 4 or 8 cells around a given cell. Any results off the edges of the map are considered solid.
 
+	//Visits the same cells as GetAdjacentNeighborCells, but counts in place: map generation calls this from jobs, where there's no frame memory.
+	const MapPosition diagonalOffsets[ 4 ] = { MapPosition( -1, -1 ), MapPosition( 1, 1 ), MapPosition( -1, 1 ), MapPosition( 1, -1 ) };
+	const MapPosition cardinalOffsets[ 4 ] = { MapPosition::UNIT_Y, -MapPosition::UNIT_X, MapPosition::UNIT_X, -MapPosition::UNIT_Y };
+
 	unsigned int numMatches = 0;
-	
-	std::vector< Cell* > neighbors;
-	GetAdjacentNeighborCells( centerCellPos, radiusFromCenterCell, considerDiagonals, neighbors );
-	for ( Cell* cell : neighbors )
-		if ( cell->m_cellType == queriedType )
-			++numMatches;
+
+	for ( int currentRadius = 1; currentRadius <= radiusFromCenterCell; currentRadius++ )
+	{
+		for ( int offsetIndex = 0; offsetIndex < 4; offsetIndex++ )
+		{
+			if ( considerDiagonals )
+			{
+				MapPosition diagonalPos = centerCellPos + diagonalOffsets[ offsetIndex ] * currentRadius;
+				if ( IsPositionOnMap( diagonalPos ) && ( m_cells[ GetIndexForPosition( diagonalPos ) ].m_cellType == queriedType ) )
+					++numMatches;
+			}
+
+			MapPosition cardinalPos = centerCellPos + cardinalOffsets[ offsetIndex ] * currentRadius;
+			if ( IsPositionOnMap( cardinalPos ) && ( m_cells[ GetIndexForPosition( cardinalPos ) ].m_cellType == queriedType ) )
+				++numMatches;
+		}
+	}
 
 	return numMatches;
 }
\ No newline at end of file
@@ -2,12 +2,17 @@
 
 #include "Game/GameCommon.hpp"
 #include "Engine/Math/Vector2.hpp"
+#include "Engine/Memory/FrameAllocator.hpp"
 #include "Game/Cell.hpp"
+#include "Game/HazardSystem.hpp"
 #include <vector>
 #include <string>
 class Command;
 struct PathNode;
 struct XMLNode;
+class BinaryWriter;
+class BinaryReader;
+class FormatBuffer;
 
 
 class Map
@@ -39,6 +44,7 @@ public:
 
 	std::vector< Cell >& GetCells() { return m_cells; }
 	std::vector< MapPosition >& GetTraversableCells() { return m_traversableCells; }
+	HazardSystem& GetHazards() { return m_hazards; }
 	void CopyCellsFromMap( Map* sourceMap );
 
 	inline bool DoesCellMatchType( unsigned int cellIndex, CellType type );
@@ -55,7 +61,7 @@ public:
 	void Render();
 	static void ShowMap( Command& args );
 
-	void GetAdjacentNeighborCells( const MapPosition& centerCellPos, float radiusFromCenterCell, bool includeDiagonals, std::vector< Cell* >& out_neighbors );
+	void GetAdjacentNeighborCells( const MapPosition& centerCellPos, float radiusFromCenterCell, bool includeDiagonals, FrameVector< Cell* >& out_neighbors );
 	void BuildPathNodesForTraversableNeighbors( PathNode* activeNode, const MapPosition& goalPos, std::vector<PathNode*>& out_neighbors, bitfield_int traversalProperties );
 
 	bool DoesPositionSatisfyTraversalProperties( const MapPosition& position, bitfield_int traversalProperties );
@@ -64,14 +70,21 @@ public:
 
 	void WriteToXMLNode( XMLNode& out_mapNode );
 	static std::string GetAsString( Map* map, bool wasMapFromXML, int numTabs = 0, bool includeNewlines = true, bool onlyShowKnownCells = false );
+	static void AppendAsString( FormatBuffer& inout_buffer, Map* map, bool wasMapFromXML, int numTabs = 0, bool includeNewlines = true, bool onlyShowKnownCells = false );
 	void RefreshCellOccupantVisibility();
 
+	void WriteTerrainToBinary( BinaryWriter& writer ) const; //One glyph byte per cell, the same glyphs as TileData.
+	static Map* CreateFromBinaryTerrain( BinaryReader& reader ); //Returns nullptr on a truncated plane.
+	void WriteVisibilityToBinary( BinaryWriter& writer ) const; //Seen-before and hidden bitplanes, 1 bit per cell each.
+	bool PopulateVisibilityFromBinary( BinaryReader& reader );
+
 private:
 	std::string m_mapName;
 	int m_generationStepCount;  //Reset after each m_process in a BiomeBlueprint completes.
 
 	std::vector< Cell > m_cells;
 	std::vector< Vector2i > m_traversableCells;
+	HazardSystem m_hazards;
 
 	Vector2i m_size;
 };
@@ -1,6 +1,10 @@
 #include "Game/NPCs/NPC.hpp"
 #include "Game/Behaviors/Behavior.hpp"
 #include "Game/FieldOfView/FieldOfView.hpp"
+#include "Game/NPCs/NPCFactory.hpp"
+#include "Engine/Time/Profiler.hpp"
+#include "Engine/FileUtils/Writers/BufferBinaryWriter.hpp"
+#include "Engine/FileUtils/Readers/BinaryReader.hpp"
 
 
 //--------------------------------------------------------------------------------------------------------------
@@ -72,6 +76,8 @@ NPC::~NPC()
 //--------------------------------------------------------------------------------------------------------------
 CooldownSeconds NPC::Update( float deltaSeconds )
 {
+	PROFILE_SCOPE( "NPC::Update" );
+
 	UNREFERENCED( deltaSeconds );
 
 	ASSERT_OR_DIE( m_behaviors.size() != 0, "No Behaviors To Use in NPC::Update!" );
@@ -101,6 +107,7 @@ CooldownSeconds NPC::RunCurrentMaxUtilityBehavior()
 			continue;
 
 		//Change this to <= to make the lowest XML behavior element go first instead of topmost.
+		PROFILE_SCOPE( "Behavior::CalcUtility" );
 		UtilityValue currentBehaviorUtility = currentBehavior->CalcUtility();
 		if ( maxUtility < currentBehaviorUtility )
 		{
@@ -111,6 +118,7 @@ CooldownSeconds NPC::RunCurrentMaxUtilityBehavior()
 
 	ASSERT_OR_DIE( winningBehaviorIndex != -1, nullptr );
 
+	PROFILE_SCOPE( "Behavior::Run" );
 	CooldownSeconds durationUntilNextTurn = DEFAULT_TURN_COOLDOWN;
 		
 	durationUntilNextTurn = m_behaviors[ winningBehaviorIndex ]->Run();
@@ -149,4 +157,101 @@ void NPC::WriteToXMLNode( XMLNode& out_entityDataNode )
 	XMLNode behaviorsNode = npcNode.addChild( "Behaviors" );
 	for ( Behavior* behavior : m_behaviors )
 		behavior->WriteToXMLNode( behaviorsNode );
-}
\ No newline at end of file
+}
+
+
+//--------------------------------------------------------------------------------------------------------------
+void NPC::WriteToBinary( BinaryWriter& writer ) const
+{
+	Agent::WriteToBinary( writer );
+
+	//Each behavior's state is length-prefixed, so one since dropped from the blueprint can be skipped on load.
+	BufferBinaryWriter behaviorWriter;
+	writer.Write<uint32_t>( m_behaviors.size() );
+	for ( const Behavior* behavior : m_behaviors )
+	{
+		behaviorWriter.Clear();
+		behavior->WriteToBinary( behaviorWriter );
+
+		writer.WriteString( behavior->GetName().c_str() );
+		writer.Write<uint32_t>( behaviorWriter.GetNumBytesWritten() );
+		if ( behaviorWriter.GetNumBytesWritten() > 0 )
+			writer.WriteBytes( behaviorWriter.GetBuffer().data(), behaviorWriter.GetNumBytesWritten() );
+	}
+}
+
+
+//--------------------------------------------------------------------------------------------------------------
+void NPC::PopulateFromBinary( BinaryReader& reader, Map* map )
+{
+	Agent::PopulateFromBinary( reader, map );
+
+	//Behaviors were already cloned off the factory's template, so just restore their runtime state by name.
+	uint32_t numBehaviors = 0;
+	reader.Read<uint32_t>( &numBehaviors );
+	std::string behaviorName;
+	for ( uint32_t behaviorIndex = 0; behaviorIndex < numBehaviors; behaviorIndex++ )
+	{
+		uint32_t numBehaviorBytes = 0;
+		reader.ReadString( behaviorName );
+		reader.Read<uint32_t>( &numBehaviorBytes );
+
+		Behavior* behavior = FindBehaviorByName( behaviorName );
+		if ( behavior == nullptr )
+		{
+			DebuggerPrintf( "NPC::PopulateFromBinary() found no %s behavior on %s, skipping it!", behaviorName.c_str(), m_name.GetCString() );
+			reader.SkipBytes( numBehaviorBytes );
+			continue;
+		}
+
+		behavior->PopulateFromBinary( reader );
+	}
+}
+
+
+//--------------------------------------------------------------------------------------------------------------
+Behavior* NPC::FindBehaviorByName( const std::string& behaviorName )
+{
+	for ( Behavior* behavior : m_behaviors )
+		if ( behavior->GetName() == behaviorName )
+			return behavior;
+
+	return nullptr;
+}
+
+
+//--------------------------------------------------------------------------------------------------------------
+void NPC::ResolvePointersToEntities( std::map< EntityID, GameEntity* >& loadedEntities )
+{
+	Agent::ResolvePointersToEntities( loadedEntities );
+
+	for ( Behavior* behavior : m_behaviors )
+		behavior->ResolvePointersToEntities( loadedEntities );
+}
+
+
+//--------------------------------------------------------------------------------------------------------------
+void NPC::WriteBinaryRecord( BinaryWriter& writer ) const
+{
+	writer.WriteString( m_name.GetCString() );
+	WriteToBinary( writer );
+}
+
+
+//--------------------------------------------------------------------------------------------------------------
+STATIC NPC* NPC::CreateFromBinaryRecord( BinaryReader& reader, Map* map )
+{
+	std::string factoryName;
+	reader.ReadString( factoryName );
+
+	std::map< std::string, NPCFactory* >::iterator found = NPCFactory::GetRegistry().find( factoryName );
+	if ( found == NPCFactory::GetRegistry().end() )
+	{
+		DebuggerPrintf( "NPC::CreateFromBinaryRecord() failed to find NPCFactory for %s!", factoryName.c_str() );
+		return nullptr;
+	}
+
+	NPC* newNPC = found->second->CreateNPC();
+	newNPC->PopulateFromBinary( reader, map );
+	return newNPC;
+}
@@ -19,11 +19,17 @@ public:
 	std::vector< Behavior* >& GetBehaviors() { return m_behaviors; }
 
 	virtual void WriteToXMLNode( XMLNode& out_entityDataNode ) override;
+	virtual void WriteToBinary( BinaryWriter& writer ) const override;
+	void WriteBinaryRecord( BinaryWriter& writer ) const; //Factory name, then WriteToBinary.
+	static NPC* CreateFromBinaryRecord( BinaryReader& reader, Map* map ); //Nullptr if the factory's gone, leaving the rest unread.
+	virtual void ResolvePointersToEntities( std::map< EntityID, GameEntity* >& loadedEntities ) override;
 
 
 private:
 	virtual void PopulateFromXMLNode( const XMLNode& npcBlueprintNode, Map* map ) override;
 	void PopulateBehaviorsFromXMLNode( const XMLNode& behaviorsNode );
+	virtual void PopulateFromBinary( BinaryReader& reader, Map* map ) override;
+	Behavior* FindBehaviorByName( const std::string& behaviorName );
 
 	void UpdateVisibility();
 	CooldownSeconds RunCurrentMaxUtilityBehavior();
@@ -22,28 +22,20 @@ void NPCFactory::PopulateFromXMLNode( const XMLNode& npcBlueprintNode )
 
 
 //--------------------------------------------------------------------------------------------------------------
-STATIC void NPCFactory::LoadAllNPCBlueprints()
+STATIC void NPCFactory::LoadNPCBlueprintsFromXML( const XMLNode& blueprintsRoot )
 {
 	//Note we may have more than one NPC in a file.
-	std::vector< std::string > m_npcFiles = EnumerateFilesInDirectory( "Data/XML/NPCs", "*.NPC.xml" );
-
-	for ( unsigned int npcFileIndex = 0; npcFileIndex < m_npcFiles.size(); npcFileIndex++ )
+	for ( int npcBlueprintIndex = 0; npcBlueprintIndex < blueprintsRoot.nChildNode(); npcBlueprintIndex++ )
 	{
-		const char* xmlFilename = m_npcFiles[ npcFileIndex ].c_str();
-		XMLNode blueprintsRoot = XMLNode::openFileHelper( xmlFilename, "NPCBlueprints" );
-
-		for ( int npcBlueprintIndex = 0; npcBlueprintIndex < blueprintsRoot.nChildNode(); npcBlueprintIndex++ )
-		{
-			XMLNode npcBlueprintNode = blueprintsRoot.getChildNode( npcBlueprintIndex );
+		XMLNode npcBlueprintNode = blueprintsRoot.getChildNode( npcBlueprintIndex );
 
-			NPCFactory* newFactory = new NPCFactory( npcBlueprintNode ); //Each NPCFactory corresponds to a NPCBlueprint element.
-			newFactory->m_name = ReadXMLAttribute( npcBlueprintNode, "name", newFactory->m_name );
+		NPCFactory* newFactory = new NPCFactory( npcBlueprintNode ); //Each NPCFactory corresponds to a NPCBlueprint element.
+		newFactory->m_name = ReadXMLAttribute( npcBlueprintNode, "name", newFactory->m_name );
 
-			if ( s_npcFactoryRegistry.find( newFactory->m_name ) != s_npcFactoryRegistry.end() )
-				ERROR_AND_DIE( Stringf( "Found duplicate NPC factory type/name %s in LoadNPCBlueprints!", newFactory->m_name.c_str() ) );
+		if ( s_npcFactoryRegistry.find( newFactory->m_name ) != s_npcFactoryRegistry.end() )
+			ERROR_AND_DIE( Stringf( "Found duplicate NPC factory type/name %s in LoadNPCBlueprints!", newFactory->m_name.c_str() ) );
 
-			s_npcFactoryRegistry.insert( std::pair< std::string, NPCFactory* >( newFactory->m_name, newFactory ) );
-		}
+		s_npcFactoryRegistry.insert( std::pair< std::string, NPCFactory* >( newFactory->m_name, newFactory ) );
 	}
 }
 
@@ -13,7 +13,7 @@ class NPCFactory
 {
 public:
 	NPCFactory( const XMLNode& npcBlueprintNode ) { PopulateFromXMLNode( npcBlueprintNode ); }
-	static void LoadAllNPCBlueprints();
+	static void LoadNPCBlueprintsFromXML( const XMLNode& blueprintsRoot ); //One file's root, from BlueprintCache.
 	NPC* CreateNPC( Map* map = nullptr, const XMLNode& npcInstanceNode = XMLNode::emptyNode() );
 	static std::map< std::string, NPCFactory* >& GetRegistry() { return s_npcFactoryRegistry; }
 
@@ -1,18 +1,28 @@
 #include "Game/Pathfinding/Pathfinder.hpp"
 #include "Engine/Renderer/TheRenderer.hpp"
 #include "Game/Map.hpp"
+#include "Engine/Time/Profiler.hpp"
+#include "Engine/Memory/AllocationTracker.hpp"
+#include "Engine/Metrics/Metrics.hpp"
 
 
 //--------------------------------------------------------------------------------------------------------------
 bool Path::Pathfind( int numStepsToTake /*= -1*/ ) //-1 for as many as necessary to hit goal.
 {
+	PROFILE_SCOPE( "Path::Pathfind" );
+	MEMORY_TAG( "Pathfinding" );
+	static const MetricID s_pathsComputedMetric = Metrics::RegisterCounter( "game.paths_computed" ); //Found or not, but not step-limited partial runs.
+
 	m_currentActiveNode = nullptr;
 	int numIteration = 0;
 
 	do
 	{
 		if ( m_openList.empty() )
+		{
+			Metrics::AddToCounter( s_pathsComputedMetric );
 			return false; //NO_PATH, e.g. goal was on the other side of a room-wide wall.
+		}
 
 		//RemoveLowestOpenListNodeWithLowestCostF.
 		m_currentActiveNode = m_openList.begin()->second;
@@ -22,6 +32,7 @@ bool Path::Pathfind( int numStepsToTake /*= -1*/ ) //-1 for as many as necessary
 		m_closedList[ m_currentActiveNode->m_position ] = m_currentActiveNode;
 		if ( m_currentActiveNode->m_position == m_goal )
 		{
+			Metrics::AddToCounter( s_pathsComputedMetric );
 			RecursivelyBuildPathBackToStartFromNode( m_currentActiveNode );
 			return true;
 		}
@@ -8,6 +8,9 @@
 #include "Engine/Audio/TheAudio.hpp"
 #include "Game/CombatSystem.hpp"
 #include "Game/Items/Item.hpp"
+#include "Engine/Time/Profiler.hpp"
+#include "Engine/FileUtils/Writers/BinaryWriter.hpp"
+#include "Engine/FileUtils/Readers/BinaryReader.hpp"
 
 
 //--------------------------------------------------------------------------------------------------------------
@@ -54,7 +57,7 @@ bool Player::ProcessInput()
 	if ( g_theInput->WasKeyPressedOnce( KEY_TO_TOGGLE_GODMODE ) )
 	{
 		m_isInvincible = !m_isInvincible;
-		g_theConsole->Printf( "Invincibility toggled %s.", m_isInvincible ? "on" : "off" );
+		g_theConsole->Format( CHECKED_FORMAT( "Invincibility toggled {}.", m_isInvincible ? "on" : "off" ) );
 		g_theConsole->ShowConsole();
 	}
 	if ( g_theInput->WasKeyPressedOnce( VK_PAGEUP ) )
@@ -200,13 +203,13 @@ void Player::CheckForItems()
 			switch ( item->GetItemType() )
 			{
 			case ITEM_TYPE_WEAPON:
-				g_theConsole->Printf( "You find a %s (+%d) here.", item->GetName().c_str(), item->GetWeaponDamage() );
+				g_theConsole->Format( CHECKED_FORMAT( "You find a {} (+{}) here.", item->GetName(), item->GetWeaponDamage() ) );
 				break;
 			case ITEM_TYPE_ARMOR:
-				g_theConsole->Printf( "You find a %s (+%d) here.", item->GetName().c_str(), item->GetArmorDefense() );
+				g_theConsole->Format( CHECKED_FORMAT( "You find a {} (+{}) here.", item->GetName(), item->GetArmorDefense() ) );
 				break;
 			case ITEM_TYPE_POTION:
-				g_theConsole->Printf( "You find a %s here.", item->GetName().c_str() );
+				g_theConsole->Format( CHECKED_FORMAT( "You find a {} here.", item->GetName() ) );
 				break;
 			default:
 				break;
@@ -221,6 +224,8 @@ void Player::CheckForItems()
 //--------------------------------------------------------------------------------------------------------------
 CooldownSeconds Player::Update( float deltaSeconds )
 {
+	PROFILE_SCOPE( "Player::Update" );
+
 	++m_numTurnsTaken;
 
 	const int NUM_PLAYER_MOVE_SOUNDS = 4;
@@ -281,7 +286,7 @@ CooldownSeconds Player::Update( float deltaSeconds )
 		{
 			if ( AddHealthDelta( 1 ) )
 			{
-				g_theConsole->Printf( "You gain +1 health from resting." );
+				g_theConsole->Print( "You gain +1 health from resting." );
 				g_theConsole->ShowConsole();
 			}
 			secondsUntilNextTurn = DEFAULT_TURN_COOLDOWN * 2.f;
@@ -292,7 +297,7 @@ CooldownSeconds Player::Update( float deltaSeconds )
 			bool usedPotion = UseLastAcquiredPotion();
 			if ( !usedPotion )
 			{
-				g_theConsole->Printf( "No potions to use in inventory." );
+				g_theConsole->Print( "No potions to use in inventory." );
 				g_theConsole->ShowConsole();
 			}
 			secondsUntilNextTurn = DEFAULT_TURN_COOLDOWN;
@@ -325,3 +330,23 @@ void Player::WriteToXMLNode( XMLNode& out_entityDataNode )
 	WriteXMLAttribute( playerNode, "turnsTaken", m_numTurnsTaken, 0 );
 	WriteXMLAttribute( playerNode, "isInvincible", m_isInvincible ? 1 : 0, 0 );
 }
+
+
+//--------------------------------------------------------------------------------------------------------------
+void Player::WriteToBinary( BinaryWriter& writer ) const
+{
+	Agent::WriteToBinary( writer );
+
+	writer.Write<int>( m_numTurnsTaken );
+	writer.Write<bool>( m_isInvincible );
+}
+
+
+//--------------------------------------------------------------------------------------------------------------
+void Player::PopulateFromBinary( BinaryReader& reader, Map* map )
+{
+	Agent::PopulateFromBinary( reader, map );
+
+	reader.Read<int>( &m_numTurnsTaken );
+	reader.Read<bool>( &m_isInvincible );
+}
@@ -26,6 +26,8 @@ public:
 		: Agent( entityType )
 		, m_numTurnsTaken( 0 )
 		, m_isInvincible( false )
+		, m_nextAction( PLAYER_ACTION_UNSPECIFIED )
+		, m_goalDirection( DIRECTION_NONE )
 	{
 		m_health = m_maxHealth = 30;
 		m_glyph = '@';
@@ -43,6 +45,7 @@ public:
 		m_isInvincible = ( ReadXMLAttribute( playerNode, "isInvincible", 0 ) > 0 ) ? true : false;
 	}
 	bool ProcessInput();
+	void SetNextAction( PlayerAction action, MapDirection goalDirection = DIRECTION_NONE ) { m_nextAction = action; m_goalDirection = goalDirection; } //Scripted input, e.g. headless runs.
 	int GetNumTurns() const { return m_numTurnsTaken; }
 
 	virtual bool IsPlayer() const override { return true; }
@@ -50,6 +53,8 @@ public:
 	virtual bool IsReadyToUpdate() const override { return m_nextAction > PLAYER_ACTION_UNSPECIFIED && m_nextAction < NUM_PLAYER_ACTIONS; }
 	virtual CooldownSeconds Update( float deltaSeconds ) override; //Return value == time until next turn, default of one.
 	virtual void WriteToXMLNode( XMLNode& out_entityDataNode ) override;
+	virtual void WriteToBinary( BinaryWriter& writer ) const override;
+	virtual void PopulateFromBinary( BinaryReader& reader, Map* map ) override;
 
 private:
 	bool ProcessMovementKeyboard( bool& out_pressedLeft, bool& out_pressedRight, bool& out_pressedUp, bool& out_pressedDown );
@@ -0,0 +1,126 @@
+#include "Game/Saves/BackgroundSaver.hpp"
+
+#include "Engine/Time/Profiler.hpp"
+#include "Engine/Time/Time.hpp"
+
+#include "Game/Saves/BinarySaveGame.hpp"
+
+
+//--------------------------------------------------------------------------------------------------------------
+BackgroundSaver::BackgroundSaver()
+	: m_lastSnapshotSeconds( 0.0 )
+	, m_hasSavedSinceReset( false )
+	, m_bytesSavedMetric( Metrics::RegisterCounter( "game.bytes_saved" ) )
+	, m_saveWriteSecondsMetric( Metrics::RegisterHistogram( "game.save_write_seconds" ) )
+	, m_hasPendingSave( false )
+	, m_isWriting( false )
+	, m_didSaveFail( false )
+	, m_isShuttingDown( false )
+	, m_workerThread( &BackgroundSaver::RunWorker, this )
+{
+}
+
+
+//--------------------------------------------------------------------------------------------------------------
+BackgroundSaver::~BackgroundSaver()
+{
+	{
+		std::lock_guard< std::mutex > lock( m_mutex );
+		m_isShuttingDown = true;
+	}
+	m_wakeWorkerCondition.notify_one();
+	m_workerThread.join();
+}
+
+
+//--------------------------------------------------------------------------------------------------------------
+void BackgroundSaver::QueueSave( const TheGame& game, const std::string& saveFilePath )
+{
+	PROFILE_SCOPE( "BackgroundSaver::QueueSave" );
+	double startSeconds = GetCurrentTimeSeconds();
+
+	m_snapshotWriter.Clear();
+	BinarySaveGame::WriteToBuffer( m_snapshotWriter, game );
+
+	{
+		std::lock_guard< std::mutex > lock( m_mutex );
+		m_pendingSaveBytes.swap( m_snapshotWriter.GetBuffer() ); //Any superseded snapshot's buffer comes back for reuse.
+		m_pendingSaveFilePath = saveFilePath;
+		m_hasPendingSave = true;
+	}
+	m_wakeWorkerCondition.notify_one();
+
+	m_hasSavedSinceReset = true;
+	m_lastSnapshotSeconds = GetCurrentTimeSeconds() - startSeconds;
+}
+
+
+//--------------------------------------------------------------------------------------------------------------
+bool BackgroundSaver::WaitForSaves()
+{
+	PROFILE_SCOPE( "BackgroundSaver::WaitForSaves" );
+
+	std::unique_lock< std::mutex > lock( m_mutex );
+	m_idleCondition.wait( lock, [ this ]() { return !m_hasPendingSave && !m_isWriting; } );
+
+	bool didAllSucceed = !m_didSaveFail;
+	m_didSaveFail = false;
+	return didAllSucceed;
+}
+
+
+//--------------------------------------------------------------------------------------------------------------
+bool BackgroundSaver::PollFailedSave()
+{
+	std::lock_guard< std::mutex > lock( m_mutex );
+
+	bool didFail = m_didSaveFail;
+	m_didSaveFail = false;
+	return didFail;
+}
+
+
+//--------------------------------------------------------------------------------------------------------------
+void BackgroundSaver::Reset()
+{
+	WaitForSaves();
+	m_journal.Reset();
+	m_hasSavedSinceReset = false;
+}
+
+
+//--------------------------------------------------------------------------------------------------------------
+void BackgroundSaver::RunWorker()
+{
+	std::vector< unsigned char > saveBytes;
+	std::string saveFilePath;
+
+	for ( ;; )
+	{
+		{
+			std::unique_lock< std::mutex > lock( m_mutex );
+			m_wakeWorkerCondition.wait( lock, [ this ]() { return m_hasPendingSave || m_isShuttingDown; } );
+			if ( !m_hasPendingSave )
+				return; //Shutting down with nothing left to write.
+
+			saveBytes.swap( m_pendingSaveBytes );
+			saveFilePath.swap( m_pendingSaveFilePath );
+			m_hasPendingSave = false;
+			m_isWriting = true;
+		}
+
+		double writeStartSeconds = GetCurrentTimeSeconds();
+		bool didSave = m_journal.Save( saveBytes, saveFilePath );
+		Metrics::RecordSeconds( m_saveWriteSecondsMetric, GetCurrentTimeSeconds() - writeStartSeconds );
+		if ( didSave )
+			Metrics::AddToCounter( m_bytesSavedMetric, m_journal.GetLastSaveNumBytes() );
+
+		{
+			std::lock_guard< std::mutex > lock( m_mutex );
+			m_isWriting = false;
+			if ( !didSave )
+				m_didSaveFail = true;
+		}
+		m_idleCondition.notify_all();
+	}
+}
@@ -0,0 +1,63 @@
+#pragma once
+
+
+#include "Game/Saves/SaveJournal.hpp"
+#include "Engine/FileUtils/Writers/BufferBinaryWriter.hpp"
+#include "Engine/Metrics/Metrics.hpp"
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+
+//-----------------------------------------------------------------------------
+class TheGame;
+
+
+//-----------------------------------------------------------------------------
+// Saves without stalling play: QueueSave serializes the game into a snapshot buffer on the calling thread, which is
+// all the main thread pays for, then a worker diffs it through SaveJournal and writes it out.
+// Only the newest unstarted snapshot is kept, since each one is a whole save and supersedes any before it.
+//-----------------------------------------------------------------------------
+class BackgroundSaver
+{
+public:
+	BackgroundSaver();
+	~BackgroundSaver(); //Finishes writing whatever was queued first.
+
+	void QueueSave( const TheGame& game, const std::string& saveFilePath ); //Call between turns, so the snapshot is consistent.
+	bool WaitForSaves(); //Blocks until everything queued is on disk. False if any save failed since the last wait.
+	bool PollFailedSave(); //Non-blocking: true once per failure, which also clears it.
+	void Reset(); //Waits, then forgets the journal's checkpoint, see SaveJournal::Reset.
+
+	bool HasSavedSinceReset() const { return m_hasSavedSinceReset; }
+	double GetLastSnapshotSeconds() const { return m_lastSnapshotSeconds; }
+
+
+private:
+	BackgroundSaver( const BackgroundSaver& ); //Owns a thread.
+	void operator=( const BackgroundSaver& );
+
+	void RunWorker();
+
+	SaveJournal m_journal; //Only the worker touches it while a save is pending or being written.
+	BufferBinaryWriter m_snapshotWriter; //Main thread only.
+	double m_lastSnapshotSeconds;
+	bool m_hasSavedSinceReset;
+	MetricID m_bytesSavedMetric; //Recorded by the worker.
+	MetricID m_saveWriteSecondsMetric;
+
+	std::mutex m_mutex; //Guards everything below.
+	std::condition_variable m_wakeWorkerCondition;
+	std::condition_variable m_idleCondition;
+	std::vector< unsigned char > m_pendingSaveBytes;
+	std::string m_pendingSaveFilePath;
+	bool m_hasPendingSave;
+	bool m_isWriting;
+	bool m_didSaveFail;
+	bool m_isShuttingDown;
+
+	std::thread m_workerThread; //Last, so it starts after everything it reads is constructed.
+};
@@ -0,0 +1,501 @@
+#include "Game/Saves/BinarySaveGame.hpp"
+
+#include "Engine/FileUtils/FileUtils.hpp"
+#include "Engine/FileUtils/Compression.hpp"
+#include "Engine/FileUtils/Writers/BufferBinaryWriter.hpp"
+#include "Engine/FileUtils/Readers/BufferBinaryReader.hpp"
+#include "Engine/FileUtils/Readers/MappedFileReader.hpp"
+#include "Engine/Time/Profiler.hpp"
+
+#include "Game/TheGame.hpp"
+#include "Game/Map.hpp"
+#include "Game/Player.hpp"
+#include "Game/NPCs/NPC.hpp"
+#include "Game/Items/Item.hpp"
+#include "Game/Features/Feature.hpp"
+#include "Game/FactionSystem.hpp"
+
+#include <map>
+#include <set>
+
+
+//--------------------------------------------------------------------------------------------------------------
+STATIC const char BinarySaveGame::s_MAGIC[ 4 ] = { 'H', 'M', 'S', 'V' };
+STATIC const unsigned int BinarySaveGame::s_VERSION = 3;
+STATIC const char* BinarySaveGame::s_FILE_EXTENSION = ".Save.bin";
+static const unsigned int NUM_SAVE_CHUNKS = 5;
+
+
+//--------------------------------------------------------------------------------------------------------------
+STATIC size_t BinarySaveGame::BeginSizedBlock( BufferBinaryWriter& writer )
+{
+	writer.Write<uint32_t>( 0U );
+	return writer.GetNumBytesWritten();
+}
+
+
+//--------------------------------------------------------------------------------------------------------------
+STATIC void BinarySaveGame::EndSizedBlock( BufferBinaryWriter& writer, size_t blockStartOffset )
+{
+	writer.OverwriteAt<uint32_t>( blockStartOffset - sizeof( uint32_t ), (uint32_t)( writer.GetNumBytesWritten() - blockStartOffset ) );
+}
+
+
+//--------------------------------------------------------------------------------------------------------------
+static void WriteEntitiesChunk( BufferBinaryWriter& writer, const TheGame& game )
+{
+	size_t countOffset = writer.GetNumBytesWritten();
+	uint32_t numRecords = 0;
+	writer.Write<uint32_t>( numRecords );
+
+	for ( const GameEntity* entity : game.m_livingEntities )
+	{
+		if ( entity->GetMap() == nullptr )
+			continue; //Carried items, saved as part of their agent's record.
+
+		writer.Write<EntityID>( entity->GetEntityID() );
+		writer.Write<byte_t>( (byte_t)entity->GetEntityType() );
+		size_t recordStart = BinarySaveGame::BeginSizedBlock( writer );
+		switch ( entity->GetEntityType() )
+		{
+			case ENTITY_TYPE_ITEM: static_cast< const Item* >( entity )->WriteBinaryRecord( writer ); break;
+			case ENTITY_TYPE_FEATURE: static_cast< const Feature* >( entity )->WriteBinaryRecord( writer ); break;
+			case ENTITY_TYPE_NPC: static_cast< const NPC* >( entity )->WriteBinaryRecord( writer ); break;
+			case ENTITY_TYPE_PLAYER: static_cast< const Player* >( entity )->WriteToBinary( writer ); break; //No factory.
+		}
+		BinarySaveGame::EndSizedBlock( writer, recordStart );
+		++numRecords;
+	}
+
+	writer.OverwriteAt<uint32_t>( countOffset, numRecords );
+}
+
+
+//--------------------------------------------------------------------------------------------------------------
+static void WriteFactionsChunk( BufferBinaryWriter& writer, const TheGame& game )
+{
+	size_t countOffset = writer.GetNumBytesWritten();
+	uint32_t numFactions = 0;
+	writer.Write<uint32_t>( numFactions );
+
+	for ( GameEntity* entity : game.m_livingEntities )
+	{
+		if ( entity->GetMap() == nullptr || ( entity->GetEntityType() != ENTITY_TYPE_NPC && entity->GetEntityType() != ENTITY_TYPE_PLAYER ) )
+			continue;
+
+		writer.Write<EntityID>( entity->GetEntityID() );
+		size_t factionStart = BinarySaveGame::BeginSizedBlock( writer );
+		static_cast< Agent* >( entity )->GetFaction().WriteToBinary( writer );
+		BinarySaveGame::EndSizedBlock( writer, factionStart );
+		++numFactions;
+	}
+
+	writer.OverwriteAt<uint32_t>( countOffset, numFactions );
+}
+
+
+//--------------------------------------------------------------------------------------------------------------
+static void WriteSchedulerChunk( BufferBinaryWriter& writer, const TheGame& game )
+{
+	writer.Write<float>( g_mapSimulationTimer );
+	writer.Write<uint32_t>( game.m_activeAgents.size() );
+	for ( const TurnOrderedMapPair& scheduledTurn : game.m_activeAgents )
+	{
+		writer.Write<float>( scheduledTurn.first );
+		writer.Write<EntityID>( scheduledTurn.second->GetEntityID() );
+	}
+}
+
+
+//--------------------------------------------------------------------------------------------------------------
+STATIC void BinarySaveGame::WriteToBuffer( BufferBinaryWriter& writer, const TheGame& game )
+{
+	PROFILE_SCOPE( "BinarySaveGame::WriteToBuffer" );
+
+	WriteHeader( writer, NUM_SAVE_CHUNKS );
+
+	size_t chunkStart;
+
+	writer.Write<uint32_t>( SAVE_CHUNK_MAP_TERRAIN );
+	chunkStart = BeginSizedBlock( writer );
+	game.m_currentMap->WriteTerrainToBinary( writer );
+	EndSizedBlock( writer, chunkStart );
+
+	writer.Write<uint32_t>( SAVE_CHUNK_VISIBILITY );
+	chunkStart = BeginSizedBlock( writer );
+	game.m_currentMap->WriteVisibilityToBinary( writer );
+	EndSizedBlock( writer, chunkStart );
+
+	writer.Write<uint32_t>( SAVE_CHUNK_ENTITIES );
+	chunkStart = BeginSizedBlock( writer );
+	WriteEntitiesChunk( writer, game );
+	EndSizedBlock( writer, chunkStart );
+
+	writer.Write<uint32_t>( SAVE_CHUNK_FACTIONS );
+	chunkStart = BeginSizedBlock( writer );
+	WriteFactionsChunk( writer, game );
+	EndSizedBlock( writer, chunkStart );
+
+	writer.Write<uint32_t>( SAVE_CHUNK_SCHEDULER );
+	chunkStart = BeginSizedBlock( writer );
+	WriteSchedulerChunk( writer, game );
+	EndSizedBlock( writer, chunkStart );
+}
+
+
+//--------------------------------------------------------------------------------------------------------------
+STATIC void BinarySaveGame::WriteHeader( BufferBinaryWriter& writer, unsigned int numChunks )
+{
+	writer.WriteBytes( s_MAGIC, sizeof( s_MAGIC ) );
+	writer.Write<uint32_t>( s_VERSION );
+	writer.Write<uint32_t>( numChunks );
+}
+
+
+//--------------------------------------------------------------------------------------------------------------
+STATIC bool BinarySaveGame::WriteToFile( const std::string& saveFilePath, const TheGame& game )
+{
+	BufferBinaryWriter writer;
+	WriteToBuffer( writer, game );
+
+	BufferBinaryWriter compressedWriter;
+	CompressChunks( writer.GetBuffer().data(), writer.GetNumBytesWritten(), compressedWriter );
+	return SaveBufferToBinaryFile( saveFilePath, compressedWriter.GetBuffer() );
+}
+
+
+//--------------------------------------------------------------------------------------------------------------
+STATIC void BinarySaveGame::CompressChunks( const unsigned char* data, size_t numBytes, BufferBinaryWriter& out_writer )
+{
+	PROFILE_SCOPE( "BinarySaveGame::CompressChunks" );
+
+	SaveChunkTable chunks;
+	unsigned int version = 0;
+	if ( !ReadChunkTable( data, numBytes, chunks, version ) )
+		ERROR_AND_DIE( "BinarySaveGame::CompressChunks was handed an invalid save!" );
+
+	WriteHeader( out_writer, chunks.size() );
+	for ( const SaveChunkTable::value_type& chunk : chunks )
+	{
+		out_writer.Write<uint32_t>( chunk.first | SAVE_CHUNK_COMPRESSED_FLAG );
+		size_t chunkStart = BeginSizedBlock( out_writer );
+		WriteCompressedBlock( out_writer, chunk.second.m_data, chunk.second.m_numBytes );
+		EndSizedBlock( out_writer, chunkStart );
+	}
+}
+
+
+//--------------------------------------------------------------------------------------------------------------
+STATIC const unsigned char* BinarySaveGame::ExpandCompressedChunks( const unsigned char* data, size_t& inout_numBytes, std::vector< unsigned char >& out_storage )
+{
+	SaveChunkTable chunks;
+	unsigned int version = 0;
+	if ( !ReadChunkTable( data, inout_numBytes, chunks, version ) )
+		return nullptr;
+
+	bool hasCompressedChunk = false;
+	for ( const SaveChunkTable::value_type& chunk : chunks )
+		hasCompressedChunk |= ( chunk.first & SAVE_CHUNK_COMPRESSED_FLAG ) != 0;
+	if ( !hasCompressedChunk )
+		return data; //Raw chunks are left where they are, e.g. in the file mapping.
+
+	PROFILE_SCOPE( "BinarySaveGame::ExpandCompressedChunks" );
+
+	BufferBinaryWriter rawWriter;
+	rawWriter.GetBuffer().swap( out_storage ); //Reuse its capacity.
+	rawWriter.Clear();
+
+	WriteHeader( rawWriter, chunks.size() );
+	std::vector< byte_t > rawChunk;
+	for ( const SaveChunkTable::value_type& chunk : chunks )
+	{
+		rawWriter.Write<uint32_t>( chunk.first & ~SAVE_CHUNK_COMPRESSED_FLAG );
+		if ( ( chunk.first & SAVE_CHUNK_COMPRESSED_FLAG ) == 0 )
+		{
+			rawWriter.Write<uint32_t>( chunk.second.m_numBytes );
+			if ( chunk.second.m_numBytes > 0 )
+				rawWriter.WriteBytes( chunk.second.m_data, chunk.second.m_numBytes );
+			continue;
+		}
+
+		BufferBinaryReader chunkReader( chunk.second.m_data, chunk.second.m_numBytes );
+		if ( !ReadCompressedBlock( chunkReader, rawChunk ) )
+		{
+			DebuggerPrintf( "BinarySaveGame chunk %u failed to decompress or its checksum!", chunk.first & ~SAVE_CHUNK_COMPRESSED_FLAG );
+			return nullptr;
+		}
+
+		rawWriter.Write<uint32_t>( rawChunk.size() );
+		if ( !rawChunk.empty() )
+			rawWriter.WriteBytes( rawChunk.data(), rawChunk.size() );
+	}
+
+	out_storage.swap( rawWriter.GetBuffer() );
+	inout_numBytes = out_storage.size();
+	return out_storage.data();
+}
+
+
+//--------------------------------------------------------------------------------------------------------------
+STATIC bool BinarySaveGame::ReadChunkTable( const unsigned char* data, size_t numBytes, SaveChunkTable& out_chunks, unsigned int& out_version )
+{
+	BufferBinaryReader reader( data, numBytes );
+
+	char magic[ 4 ];
+	uint32_t version = 0;
+	uint32_t numChunks = 0;
+	reader.ReadBytes( magic, sizeof( magic ) );
+	reader.Read<uint32_t>( &version );
+	reader.Read<uint32_t>( &numChunks );
+	if ( reader.DidOverrun() || memcmp( magic, s_MAGIC, sizeof( magic ) ) != 0 )
+	{
+		DebuggerPrintf( "BinarySaveGame found no valid header!" );
+		return false;
+	}
+	if ( version > s_VERSION )
+	{
+		DebuggerPrintf( "BinarySaveGame version %u is newer than this build's %u!", version, s_VERSION );
+		return false;
+	}
+	out_version = version;
+
+	for ( uint32_t chunkNum = 0; chunkNum < numChunks; chunkNum++ )
+	{
+		uint32_t chunkID = 0;
+		uint32_t chunkSize = 0;
+		reader.Read<uint32_t>( &chunkID );
+		reader.Read<uint32_t>( &chunkSize );
+		if ( reader.DidOverrun() || chunkSize > reader.GetNumBytesRemaining() )
+		{
+			DebuggerPrintf( "BinarySaveGame chunk %u is truncated!", chunkID );
+			return false;
+		}
+
+		SaveChunkSpan span = { reader.GetCurrentPointer(), chunkSize };
+		out_chunks[ chunkID ] = span; //Unknown IDs are simply never looked up.
+		reader.SkipBytes( chunkSize );
+	}
+
+	return true;
+}
+
+
+//--------------------------------------------------------------------------------------------------------------
+static GameEntity* CreateEntityFromRecord( EntityType entityType, BinaryReader& recordReader, Map* map )
+{
+	switch ( entityType )
+	{
+		case ENTITY_TYPE_ITEM: return Item::CreateFromBinaryRecord( recordReader, map );
+		case ENTITY_TYPE_FEATURE: return Feature::CreateFromBinaryRecord( recordReader, map );
+		case ENTITY_TYPE_NPC: return NPC::CreateFromBinaryRecord( recordReader, map );
+		case ENTITY_TYPE_PLAYER:
+		{
+			Player* player = new Player( ENTITY_TYPE_PLAYER );
+			player->PopulateFromBinary( recordReader, map );
+			return player;
+		}
+		default: return nullptr;
+	}
+}
+
+
+//--------------------------------------------------------------------------------------------------------------
+static bool ReadEntitiesChunk( BufferBinaryReader& reader, unsigned int version, TheGame& game, std::map< EntityID, GameEntity* >& out_loadedEntities )
+{
+	uint32_t numRecords = 0;
+	reader.Read<uint32_t>( &numRecords );
+
+	for ( uint32_t recordNum = 0; recordNum < numRecords; recordNum++ )
+	{
+		EntityID recordID = 0;
+		byte_t entityTypeAsByte = 0;
+		uint32_t recordSize = 0;
+		if ( version >= 2 )
+			reader.Read<EntityID>( &recordID ); //Only SaveJournal needs it, the payload has the ID too.
+		reader.Read<byte_t>( &entityTypeAsByte );
+		reader.Read<uint32_t>( &recordSize );
+		if ( reader.DidOverrun() || recordSize > reader.GetNumBytesRemaining() )
+			return false;
+
+		BufferBinaryReader recordReader( reader.GetCurrentPointer(), recordSize );
+		reader.SkipBytes( recordSize ); //Whatever the record does, the next one starts here.
+
+		GameEntity* newEntity = CreateEntityFromRecord( (EntityType)entityTypeAsByte, recordReader, game.m_currentMap );
+		if ( newEntity == nullptr )
+			continue; //Factory since removed from the data, already reported.
+		if ( recordReader.DidOverrun() )
+			DebuggerPrintf( "BinarySaveGame entity %d's record was short, its remaining fields kept their defaults!", newEntity->GetSavedID() );
+
+		game.m_livingEntities.push_back( newEntity );
+		out_loadedEntities.insert( std::pair< EntityID, GameEntity* >( newEntity->GetSavedID(), newEntity ) );
+
+		if ( newEntity->GetEntityType() == ENTITY_TYPE_PLAYER )
+			game.m_player = static_cast< Player* >( newEntity );
+
+		if ( newEntity->GetEntityType() == ENTITY_TYPE_NPC || newEntity->GetEntityType() == ENTITY_TYPE_PLAYER )
+		{
+			std::vector< Item* > carriedItems = static_cast< Agent* >( newEntity )->GetEquipmentAndItems();
+			for ( Item* carriedItem : carriedItems )
+			{
+				game.m_livingEntities.push_back( carriedItem );
+				out_loadedEntities.insert( std::pair< EntityID, GameEntity* >( carriedItem->GetSavedID(), carriedItem ) );
+			}
+		}
+	}
+
+	return ( game.m_player != nullptr );
+}
+
+
+//--------------------------------------------------------------------------------------------------------------
+static void ReadFactionsChunk( BufferBinaryReader& reader, std::map< EntityID, GameEntity* >& loadedEntities )
+{
+	uint32_t numFactions = 0;
+	reader.Read<uint32_t>( &numFactions );
+
+	for ( uint32_t factionNum = 0; factionNum < numFactions; factionNum++ )
+	{
+		EntityID agentID = 0;
+		uint32_t factionSize = 0;
+		reader.Read<EntityID>( &agentID );
+		reader.Read<uint32_t>( &factionSize );
+		if ( reader.DidOverrun() || factionSize > reader.GetNumBytesRemaining() )
+			return;
+
+		BufferBinaryReader factionReader( reader.GetCurrentPointer(), factionSize );
+		reader.SkipBytes( factionSize );
+
+		std::map< EntityID, GameEntity* >::iterator found = loadedEntities.find( agentID );
+		if ( found == loadedEntities.end() )
+			continue; //Its entity record was skipped.
+
+		EntityType entityType = found->second->GetEntityType();
+		if ( entityType == ENTITY_TYPE_NPC || entityType == ENTITY_TYPE_PLAYER )
+			static_cast< Agent* >( found->second )->GetFaction().RestoreFromBinary( factionReader );
+	}
+}
+
+
+//--------------------------------------------------------------------------------------------------------------
+static void ReadSchedulerChunk( BufferBinaryReader& reader, TheGame& game, std::map< EntityID, GameEntity* >& loadedEntities )
+{
+	std::set< Agent* > scheduledAgents;
+
+	if ( reader.Read<float>( &g_mapSimulationTimer ) )
+	{
+		uint32_t numScheduledTurns = 0;
+		reader.Read<uint32_t>( &numScheduledTurns );
+		for ( uint32_t turnNum = 0; turnNum < numScheduledTurns; turnNum++ )
+		{
+			float turnTime = 0.f;
+			EntityID agentID = 0;
+			reader.Read<float>( &turnTime );
+			if ( !reader.Read<EntityID>( &agentID ) )
+				break;
+
+			std::map< EntityID, GameEntity* >::iterator found = loadedEntities.find( agentID );
+			if ( found == loadedEntities.end() || ( found->second->GetEntityType() != ENTITY_TYPE_NPC && found->second->GetEntityType() != ENTITY_TYPE_PLAYER ) )
+				continue;
+
+			Agent* agent = static_cast< Agent* >( found->second );
+			game.m_activeAgents.insert( TurnOrderedMapPair( turnTime, agent ) );
+			scheduledAgents.insert( agent );
+		}
+	}
+	else
+	{
+		g_mapSimulationTimer = 0.f; //No scheduler chunk, start the clock over as the XML import does.
+	}
+
+	//Anyone the schedule missed goes in as the XML import has it: the player first, NPCs just after.
+	for ( GameEntity* entity : game.m_livingEntities )
+	{
+		if ( entity->GetMap() == nullptr || ( entity->GetEntityType() != ENTITY_TYPE_NPC && entity->GetEntityType() != ENTITY_TYPE_PLAYER ) )
+			continue;
+
+		Agent* agent = static_cast< Agent* >( entity );
+		if ( scheduledAgents.find( agent ) == scheduledAgents.end() )
+			game.m_activeAgents.insert( TurnOrderedMapPair( g_mapSimulationTimer + ( agent->IsPlayer() ? 0.f : .1f ), agent ) );
+	}
+}
+
+
+//--------------------------------------------------------------------------------------------------------------
+STATIC bool BinarySaveGame::ReadFromBuffer( const unsigned char* data, size_t numBytes, TheGame& game )
+{
+	PROFILE_SCOPE( "BinarySaveGame::ReadFromBuffer" );
+
+	SaveChunkTable chunks;
+	unsigned int version = 0;
+	if ( !ReadChunkTable( data, numBytes, chunks, version ) )
+		return false;
+
+	SaveChunkTable::iterator terrainChunk = chunks.find( SAVE_CHUNK_MAP_TERRAIN );
+	SaveChunkTable::iterator entitiesChunk = chunks.find( SAVE_CHUNK_ENTITIES );
+	if ( terrainChunk == chunks.end() || entitiesChunk == chunks.end() )
+	{
+		DebuggerPrintf( "BinarySaveGame is missing its terrain or entities!" );
+		return false;
+	}
+
+	BufferBinaryReader terrainReader( terrainChunk->second.m_data, terrainChunk->second.m_numBytes );
+	game.m_currentMap = Map::CreateFromBinaryTerrain( terrainReader );
+	if ( game.m_currentMap == nullptr )
+		return false;
+
+	SaveChunkTable::iterator visibilityChunk = chunks.find( SAVE_CHUNK_VISIBILITY );
+	BufferBinaryReader visibilityReader( ( visibilityChunk != chunks.end() ) ? visibilityChunk->second.m_data : nullptr,
+										 ( visibilityChunk != chunks.end() ) ? visibilityChunk->second.m_numBytes : 0 );
+	if ( !game.m_currentMap->PopulateVisibilityFromBinary( visibilityReader ) )
+		game.m_currentMap->HideOccludedCells(); //Nothing's been seen yet, but hidden cells can be rederived.
+
+	std::map< EntityID, GameEntity* > loadedEntities;
+	BufferBinaryReader entitiesReader( entitiesChunk->second.m_data, entitiesChunk->second.m_numBytes );
+	if ( !ReadEntitiesChunk( entitiesReader, version, game, loadedEntities ) )
+	{
+		DebuggerPrintf( "BinarySaveGame found no player!" );
+		return false;
+	}
+	game.m_currentMap->RefreshTraversableCells(); //Once features are placed.
+
+	SaveChunkTable::iterator factionsChunk = chunks.find( SAVE_CHUNK_FACTIONS );
+	if ( factionsChunk != chunks.end() )
+	{
+		BufferBinaryReader factionsReader( factionsChunk->second.m_data, factionsChunk->second.m_numBytes );
+		ReadFactionsChunk( factionsReader, loadedEntities );
+	}
+
+	for ( std::pair< EntityID, GameEntity* > entity : loadedEntities )
+		entity.second->ResolvePointersToEntities( loadedEntities ); //After factions, which also hold saved IDs.
+
+	SaveChunkTable::iterator schedulerChunk = chunks.find( SAVE_CHUNK_SCHEDULER );
+	BufferBinaryReader schedulerReader( ( schedulerChunk != chunks.end() ) ? schedulerChunk->second.m_data : nullptr,
+										( schedulerChunk != chunks.end() ) ? schedulerChunk->second.m_numBytes : 0 );
+	ReadSchedulerChunk( schedulerReader, game, loadedEntities );
+
+	return true;
+}
+
+
+//--------------------------------------------------------------------------------------------------------------
+STATIC bool BinarySaveGame::ReadFromFile( const std::string& saveFilePath, TheGame& game )
+{
+	//Mapped rather than loaded into a vector: raw chunk readers point into the mapping, so fixed-layout planes are never copied.
+	MappedFileReader reader;
+	if ( !reader.open( saveFilePath.c_str() ) || reader.GetNumBytes() == 0 )
+		return false;
+
+	std::vector< unsigned char > expandedStorage;
+	size_t numBytes = reader.GetNumBytes();
+	const unsigned char* data = ExpandCompressedChunks( reader.GetData(), numBytes, expandedStorage );
+	return ( data != nullptr ) && ReadFromBuffer( data, numBytes, game );
+}
+
+
+//--------------------------------------------------------------------------------------------------------------
+STATIC bool BinarySaveGame::IsBinarySaveFilename( const std::string& saveFilePath )
+{
+	static const std::string extension = s_FILE_EXTENSION;
+	return saveFilePath.size() >= extension.size()
+		&& saveFilePath.compare( saveFilePath.size() - extension.size(), extension.size(), extension ) == 0;
+}
@@ -0,0 +1,66 @@
+#pragma once
+
+
+#include "Game/GameCommon.hpp"
+#include <map>
+#include <string>
+#include <vector>
+
+
+//-----------------------------------------------------------------------------
+class TheGame;
+class BufferBinaryWriter;
+
+
+//-----------------------------------------------------------------------------
+enum SaveChunkID //Part of the file format: append new sections, never renumber.
+{
+	SAVE_CHUNK_MAP_TERRAIN = 1, //Name, size, and one glyph byte per cell.
+	SAVE_CHUNK_VISIBILITY = 2, //Seen-before and hidden bitplanes.
+	SAVE_CHUNK_ENTITIES = 3, //Length-prefixed records, each led by its EntityID and EntityType.
+	SAVE_CHUNK_FACTIONS = 4, //Each agent's Faction, keyed by its saved EntityID.
+	SAVE_CHUNK_SCHEDULER = 5 //g_mapSimulationTimer and TheGame::m_activeAgents.
+};
+
+
+//-----------------------------------------------------------------------------
+struct SaveChunkSpan //Points into the save's bytes, which must outlive it.
+{
+	const unsigned char* m_data;
+	size_t m_numBytes;
+};
+typedef std::map< uint32_t, SaveChunkSpan > SaveChunkTable;
+static const uint32_t SAVE_CHUNK_COMPRESSED_FLAG = 0x80000000; //Set on an ID on disk when its payload is an Engine/FileUtils/Compression block.
+
+
+//-----------------------------------------------------------------------------
+// Layout: "HMSV" magic, uint32 version, uint32 chunk count, then per chunk a uint32 SaveChunkID, a uint32 byte size, and its payload.
+// Readers skip chunks and entity records they don't recognize, so older saves keep loading after sections are added.
+// Version 2 leads each entity record with its EntityID, so SaveJournal can replace records one at a time.
+// Version 3 files may store any chunk compressed, flagged on its ID. In memory, e.g. WriteToBuffer's output, chunks are always raw.
+//-----------------------------------------------------------------------------
+class BinarySaveGame //Replaces the XML save for speed and size, TheGame still imports *.Save.xml.
+{
+public:
+	static bool WriteToFile( const std::string& saveFilePath, const TheGame& game );
+	static void WriteToBuffer( BufferBinaryWriter& writer, const TheGame& game );
+
+	static bool ReadFromFile( const std::string& saveFilePath, TheGame& game ); //Expects the game already emptied by DestroyAllGameplayEntities().
+	static bool ReadFromBuffer( const unsigned char* data, size_t numBytes, TheGame& game ); //On false, whatever was loaded is left in game for it to destroy.
+
+	static bool IsBinarySaveFilename( const std::string& saveFilePath );
+
+	static void CompressChunks( const unsigned char* data, size_t numBytes, BufferBinaryWriter& out_writer ); //Each chunk in the codec that suits it.
+	static const unsigned char* ExpandCompressedChunks( const unsigned char* data, size_t& inout_numBytes, std::vector< unsigned char >& out_storage );
+		//Returns data itself if nothing was compressed, else the raw layout decompressed into out_storage. Nullptr on a corrupt chunk.
+
+	//Shared with SaveJournal, which splits saves into sections and reassembles them.
+	static void WriteHeader( BufferBinaryWriter& writer, unsigned int numChunks );
+	static bool ReadChunkTable( const unsigned char* data, size_t numBytes, SaveChunkTable& out_chunks, unsigned int& out_version );
+	static size_t BeginSizedBlock( BufferBinaryWriter& writer ); //Writes a placeholder uint32 size, returns where the block starts.
+	static void EndSizedBlock( BufferBinaryWriter& writer, size_t blockStartOffset ); //Backpatches that size.
+
+	static const char s_MAGIC[ 4 ];
+	static const unsigned int s_VERSION;
+	static const char* s_FILE_EXTENSION;
+};
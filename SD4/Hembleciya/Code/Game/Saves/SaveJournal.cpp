@@ -0,0 +1,526 @@
+#include "Game/Saves/SaveJournal.hpp"
+
+#include "Engine/FileUtils/FileUtils.hpp"
+#include "Engine/FileUtils/Compression.hpp"
+#include "Engine/FileUtils/Writers/BufferBinaryWriter.hpp"
+#include "Engine/FileUtils/Readers/BufferBinaryReader.hpp"
+#include "Engine/FileUtils/Readers/MappedFileReader.hpp"
+#include "Engine/Math/MathUtils.hpp"
+#include "Engine/Time/Profiler.hpp"
+#include "Engine/Memory/AllocationTracker.hpp"
+
+#include "Game/Saves/BinarySaveGame.hpp"
+
+#include <stdio.h>
+
+
+//--------------------------------------------------------------------------------------------------------------
+STATIC const unsigned int SaveJournal::s_REGION_NUM_BYTES = 1024;
+STATIC const unsigned int SaveJournal::s_MAX_DELTAS_BEFORE_COMPACTION = 32;
+STATIC const float SaveJournal::s_MAX_DELTA_LOG_FRACTION_OF_BASE = .5f;
+static const char DELTA_MAGIC[ 4 ] = { 'H', 'M', 'D', 'L' };
+static const unsigned int DELTA_VERSION = 2; //Version 1 payloads were stored raw, 2 as one compressed block.
+static const unsigned int NUM_IMAGE_CHUNKS = 5;
+
+
+//--------------------------------------------------------------------------------------------------------------
+static unsigned int HashBytes( const unsigned char* data, size_t numBytes ) //FNV-1a, only to pair deltas with their base.
+{
+	unsigned int hash = 2166136261u;
+	for ( size_t byteIndex = 0; byteIndex < numBytes; byteIndex++ )
+	{
+		hash ^= data[ byteIndex ];
+		hash *= 16777619u;
+	}
+	return hash;
+}
+
+
+//--------------------------------------------------------------------------------------------------------------
+static void CopyChunk( const SaveChunkTable& chunks, SaveChunkID chunkID, std::vector< byte_t >& out_bytes )
+{
+	SaveChunkTable::const_iterator found = chunks.find( chunkID );
+	if ( found == chunks.end() )
+		out_bytes.clear();
+	else
+		out_bytes.assign( found->second.m_data, found->second.m_data + found->second.m_numBytes );
+}
+
+
+//--------------------------------------------------------------------------------------------------------------
+static void WriteBlob( BufferBinaryWriter& writer, const std::vector< byte_t >& bytes )
+{
+	if ( !bytes.empty() )
+		writer.WriteBytes( bytes.data(), bytes.size() );
+}
+
+
+//--------------------------------------------------------------------------------------------------------------
+static bool ReadBlob( BufferBinaryReader& reader, uint32_t numBytes, std::vector< byte_t >& out_bytes )
+{
+	if ( numBytes > reader.GetNumBytesRemaining() )
+		return false;
+
+	out_bytes.assign( reader.GetCurrentPointer(), reader.GetCurrentPointer() + numBytes );
+	reader.SkipBytes( numBytes );
+	return true;
+}
+
+
+//--------------------------------------------------------------------------------------------------------------
+bool SaveImage::ParseFromBuffer( const unsigned char* data, size_t numBytes )
+{
+	Clear();
+
+	SaveChunkTable chunks;
+	unsigned int version = 0;
+	if ( !BinarySaveGame::ReadChunkTable( data, numBytes, chunks, version ) || version < 2 )
+		return false;
+
+	CopyChunk( chunks, SAVE_CHUNK_MAP_TERRAIN, m_terrain );
+	CopyChunk( chunks, SAVE_CHUNK_VISIBILITY, m_visibility );
+	CopyChunk( chunks, SAVE_CHUNK_SCHEDULER, m_scheduler );
+
+	SaveChunkTable::iterator entitiesChunk = chunks.find( SAVE_CHUNK_ENTITIES );
+	if ( entitiesChunk != chunks.end() )
+	{
+		BufferBinaryReader reader( entitiesChunk->second.m_data, entitiesChunk->second.m_numBytes );
+		uint32_t numRecords = 0;
+		reader.Read<uint32_t>( &numRecords );
+		for ( uint32_t recordNum = 0; recordNum < numRecords; recordNum++ )
+		{
+			EntityID entityID = 0;
+			byte_t entityTypeAsByte = 0;
+			uint32_t recordSize = 0;
+			reader.Read<EntityID>( &entityID );
+			reader.Read<byte_t>( &entityTypeAsByte );
+			reader.Read<uint32_t>( &recordSize );
+			if ( reader.DidOverrun() || recordSize > reader.GetNumBytesRemaining() )
+				return false;
+
+			std::vector< byte_t >& record = m_entityRecords[ entityID ];
+			record.reserve( recordSize + 1 );
+			record.push_back( entityTypeAsByte );
+			record.insert( record.end(), reader.GetCurrentPointer(), reader.GetCurrentPointer() + recordSize );
+			reader.SkipBytes( recordSize );
+		}
+	}
+
+	SaveChunkTable::iterator factionsChunk = chunks.find( SAVE_CHUNK_FACTIONS );
+	if ( factionsChunk != chunks.end() )
+	{
+		BufferBinaryReader reader( factionsChunk->second.m_data, factionsChunk->second.m_numBytes );
+		uint32_t numFactions = 0;
+		reader.Read<uint32_t>( &numFactions );
+		for ( uint32_t factionNum = 0; factionNum < numFactions; factionNum++ )
+		{
+			EntityID agentID = 0;
+			uint32_t factionSize = 0;
+			reader.Read<EntityID>( &agentID );
+			reader.Read<uint32_t>( &factionSize );
+			if ( reader.DidOverrun() || !ReadBlob( reader, factionSize, m_factionRecords[ agentID ] ) )
+				return false;
+		}
+	}
+
+	return !m_terrain.empty();
+}
+
+
+//--------------------------------------------------------------------------------------------------------------
+void SaveImage::WriteToBuffer( BufferBinaryWriter& writer ) const
+{
+	BinarySaveGame::WriteHeader( writer, NUM_IMAGE_CHUNKS );
+
+	size_t chunkStart;
+
+	writer.Write<uint32_t>( SAVE_CHUNK_MAP_TERRAIN );
+	chunkStart = BinarySaveGame::BeginSizedBlock( writer );
+	WriteBlob( writer, m_terrain );
+	BinarySaveGame::EndSizedBlock( writer, chunkStart );
+
+	writer.Write<uint32_t>( SAVE_CHUNK_VISIBILITY );
+	chunkStart = BinarySaveGame::BeginSizedBlock( writer );
+	WriteBlob( writer, m_visibility );
+	BinarySaveGame::EndSizedBlock( writer, chunkStart );
+
+	writer.Write<uint32_t>( SAVE_CHUNK_ENTITIES );
+	chunkStart = BinarySaveGame::BeginSizedBlock( writer );
+	writer.Write<uint32_t>( m_entityRecords.size() );
+	for ( const SaveRecordMap::value_type& record : m_entityRecords )
+	{
+		writer.Write<EntityID>( record.first );
+		writer.Write<byte_t>( record.second[ 0 ] );
+		writer.Write<uint32_t>( record.second.size() - 1 );
+		if ( record.second.size() > 1 )
+			writer.WriteBytes( &record.second[ 1 ], record.second.size() - 1 );
+	}
+	BinarySaveGame::EndSizedBlock( writer, chunkStart );
+
+	writer.Write<uint32_t>( SAVE_CHUNK_FACTIONS );
+	chunkStart = BinarySaveGame::BeginSizedBlock( writer );
+	writer.Write<uint32_t>( m_factionRecords.size() );
+	for ( const SaveRecordMap::value_type& faction : m_factionRecords )
+	{
+		writer.Write<EntityID>( faction.first );
+		writer.Write<uint32_t>( faction.second.size() );
+		WriteBlob( writer, faction.second );
+	}
+	BinarySaveGame::EndSizedBlock( writer, chunkStart );
+
+	writer.Write<uint32_t>( SAVE_CHUNK_SCHEDULER );
+	chunkStart = BinarySaveGame::BeginSizedBlock( writer );
+	WriteBlob( writer, m_scheduler );
+	BinarySaveGame::EndSizedBlock( writer, chunkStart );
+}
+
+
+//--------------------------------------------------------------------------------------------------------------
+void SaveImage::Clear()
+{
+	m_terrain.clear();
+	m_visibility.clear();
+	m_entityRecords.clear();
+	m_factionRecords.clear();
+	m_scheduler.clear();
+}
+
+
+//--------------------------------------------------------------------------------------------------------------
+static void WriteRegionDiff( BufferBinaryWriter& writer, const std::vector< byte_t >& previous, const std::vector< byte_t >& current )
+{
+	const size_t regionSize = SaveJournal::s_REGION_NUM_BYTES;
+
+	writer.Write<uint32_t>( current.size() );
+	size_t countOffset = writer.GetNumBytesWritten();
+	uint32_t numChangedRegions = 0;
+	writer.Write<uint32_t>( numChangedRegions );
+
+	for ( size_t regionStart = 0; regionStart < current.size(); regionStart += regionSize )
+	{
+		size_t numRegionBytes = GetMin( regionSize, current.size() - regionStart );
+		bool isUnchanged = ( regionStart + numRegionBytes <= previous.size() )
+			&& memcmp( &previous[ regionStart ], &current[ regionStart ], numRegionBytes ) == 0;
+		if ( isUnchanged )
+			continue;
+
+		writer.Write<uint32_t>( regionStart / regionSize );
+		writer.WriteBytes( &current[ regionStart ], numRegionBytes );
+		++numChangedRegions;
+	}
+
+	writer.OverwriteAt<uint32_t>( countOffset, numChangedRegions );
+}
+
+
+//--------------------------------------------------------------------------------------------------------------
+static bool ApplyRegionDiff( BufferBinaryReader& reader, std::vector< byte_t >& inout_bytes )
+{
+	const size_t regionSize = SaveJournal::s_REGION_NUM_BYTES;
+
+	uint32_t numBytes = 0;
+	uint32_t numChangedRegions = 0;
+	reader.Read<uint32_t>( &numBytes );
+	reader.Read<uint32_t>( &numChangedRegions );
+	if ( reader.DidOverrun() )
+		return false;
+
+	inout_bytes.resize( numBytes );
+	for ( uint32_t changeNum = 0; changeNum < numChangedRegions; changeNum++ )
+	{
+		uint32_t regionIndex = 0;
+		reader.Read<uint32_t>( &regionIndex );
+		size_t regionStart = (size_t)regionIndex * regionSize;
+		if ( reader.DidOverrun() || regionStart >= numBytes )
+			return false;
+
+		size_t numRegionBytes = GetMin( regionSize, numBytes - regionStart );
+		if ( reader.ReadBytes( &inout_bytes[ regionStart ], numRegionBytes ) != numRegionBytes )
+			return false;
+	}
+
+	return true;
+}
+
+
+//--------------------------------------------------------------------------------------------------------------
+static void WriteRecordDiff( BufferBinaryWriter& writer, const SaveRecordMap& previous, const SaveRecordMap& current )
+{
+	size_t countOffset = writer.GetNumBytesWritten();
+	uint32_t numUpserts = 0;
+	writer.Write<uint32_t>( numUpserts );
+	for ( const SaveRecordMap::value_type& record : current )
+	{
+		SaveRecordMap::const_iterator found = previous.find( record.first );
+		if ( found != previous.end() && found->second == record.second )
+			continue;
+
+		writer.Write<EntityID>( record.first );
+		writer.Write<uint32_t>( record.second.size() );
+		WriteBlob( writer, record.second );
+		++numUpserts;
+	}
+	writer.OverwriteAt<uint32_t>( countOffset, numUpserts );
+
+	countOffset = writer.GetNumBytesWritten();
+	uint32_t numRemovals = 0;
+	writer.Write<uint32_t>( numRemovals );
+	for ( const SaveRecordMap::value_type& record : previous )
+	{
+		if ( current.find( record.first ) != current.end() )
+			continue;
+
+		writer.Write<EntityID>( record.first );
+		++numRemovals;
+	}
+	writer.OverwriteAt<uint32_t>( countOffset, numRemovals );
+}
+
+
+//--------------------------------------------------------------------------------------------------------------
+static bool ApplyRecordDiff( BufferBinaryReader& reader, SaveRecordMap& inout_records )
+{
+	uint32_t numUpserts = 0;
+	reader.Read<uint32_t>( &numUpserts );
+	for ( uint32_t upsertNum = 0; upsertNum < numUpserts; upsertNum++ )
+	{
+		EntityID recordID = 0;
+		uint32_t recordSize = 0;
+		reader.Read<EntityID>( &recordID );
+		reader.Read<uint32_t>( &recordSize );
+		if ( reader.DidOverrun() || !ReadBlob( reader, recordSize, inout_records[ recordID ] ) )
+			return false;
+	}
+
+	uint32_t numRemovals = 0;
+	reader.Read<uint32_t>( &numRemovals );
+	for ( uint32_t removalNum = 0; removalNum < numRemovals; removalNum++ )
+	{
+		EntityID recordID = 0;
+		if ( !reader.Read<EntityID>( &recordID ) )
+			return false;
+		inout_records.erase( recordID );
+	}
+
+	return !reader.DidOverrun();
+}
+
+
+//--------------------------------------------------------------------------------------------------------------
+static bool ApplyDelta( BufferBinaryReader& reader, SaveImage& inout_image )
+{
+	if ( !ApplyRegionDiff( reader, inout_image.m_terrain ) || !ApplyRegionDiff( reader, inout_image.m_visibility ) )
+		return false;
+
+	if ( !ApplyRecordDiff( reader, inout_image.m_entityRecords ) || !ApplyRecordDiff( reader, inout_image.m_factionRecords ) )
+		return false;
+
+	uint32_t schedulerSize = 0;
+	reader.Read<uint32_t>( &schedulerSize );
+	return !reader.DidOverrun() && ReadBlob( reader, schedulerSize, inout_image.m_scheduler );
+}
+
+
+//--------------------------------------------------------------------------------------------------------------
+SaveJournal::SaveJournal()
+	: m_baseHash( 0 )
+	, m_baseNumBytes( 0 )
+	, m_deltaLogNumBytes( 0 )
+	, m_numDeltas( 0 )
+	, m_lastSaveNumBytes( 0 )
+	, m_wasLastSaveDelta( false )
+{
+}
+
+
+//--------------------------------------------------------------------------------------------------------------
+void SaveJournal::Reset()
+{
+	m_checkpoint.Clear();
+	m_checkpointPath.clear();
+	m_baseHash = 0;
+	m_baseNumBytes = 0;
+	m_deltaLogNumBytes = 0;
+	m_numDeltas = 0;
+}
+
+
+//--------------------------------------------------------------------------------------------------------------
+bool SaveJournal::NeedsNewBase( const std::string& baseSavePath ) const
+{
+	if ( m_checkpoint.IsEmpty() || baseSavePath != m_checkpointPath )
+		return true;
+
+	//Compact before loads spend longer replaying the log than a base write costs.
+	return ( m_numDeltas >= s_MAX_DELTAS_BEFORE_COMPACTION )
+		|| ( m_deltaLogNumBytes > (size_t)( m_baseNumBytes * s_MAX_DELTA_LOG_FRACTION_OF_BASE ) );
+}
+
+
+//--------------------------------------------------------------------------------------------------------------
+bool SaveJournal::Save( const TheGame& game, const std::string& baseSavePath )
+{
+	//Serializing in memory is cheap next to the disk write, and diffing its bytes against the checkpoint finds
+	//changes however the cell or entity was touched.
+	BufferBinaryWriter saveWriter;
+	BinarySaveGame::WriteToBuffer( saveWriter, game );
+	return Save( saveWriter.GetBuffer(), baseSavePath );
+}
+
+
+//--------------------------------------------------------------------------------------------------------------
+bool SaveJournal::Save( const std::vector< unsigned char >& saveBytes, const std::string& baseSavePath )
+{
+	PROFILE_SCOPE( "SaveJournal::Save" );
+	MEMORY_TAG( "Saves" );
+
+	SaveImage current;
+	if ( !current.ParseFromBuffer( saveBytes.data(), saveBytes.size() ) )
+		ERROR_AND_DIE( "SaveJournal::Save could not parse the save it was handed!" );
+
+	bool didSave = NeedsNewBase( baseSavePath ) ? WriteBase( baseSavePath, saveBytes ) : AppendDelta( current );
+	if ( !didSave )
+	{
+		Reset(); //Disk no longer matches the checkpoint, so the next save starts over with a base.
+		return false;
+	}
+
+	std::swap( m_checkpoint, current );
+	m_checkpointPath = baseSavePath;
+	return true;
+}
+
+
+//--------------------------------------------------------------------------------------------------------------
+bool SaveJournal::WriteBase( const std::string& baseSavePath, const std::vector< unsigned char >& saveBytes )
+{
+	BufferBinaryWriter compressedWriter;
+	BinarySaveGame::CompressChunks( saveBytes.data(), saveBytes.size(), compressedWriter );
+	const std::vector< unsigned char >& fileBytes = compressedWriter.GetBuffer();
+
+	if ( !SaveBufferToBinaryFileAtomically( baseSavePath, fileBytes ) )
+		return false;
+
+	remove( GetDeltaLogPath( baseSavePath ).c_str() ); //Stale now, though its base hash would have it skipped anyway.
+
+	m_baseHash = HashBytes( fileBytes.data(), fileBytes.size() );
+	m_baseNumBytes = fileBytes.size();
+	m_deltaLogNumBytes = 0;
+	m_numDeltas = 0;
+
+	m_lastSaveNumBytes = fileBytes.size();
+	m_wasLastSaveDelta = false;
+	return true;
+}
+
+
+//--------------------------------------------------------------------------------------------------------------
+bool SaveJournal::AppendDelta( const SaveImage& current )
+{
+	//Layout: "HMDL" magic, uint32 version, uint32 base hash, uint32 payload size, then the payload compressed: terrain
+	//and visibility region diffs, entity and faction record diffs, and the whole scheduler chunk.
+	BufferBinaryWriter diffWriter;
+	WriteRegionDiff( diffWriter, m_checkpoint.m_terrain, current.m_terrain );
+	WriteRegionDiff( diffWriter, m_checkpoint.m_visibility, current.m_visibility );
+	WriteRecordDiff( diffWriter, m_checkpoint.m_entityRecords, current.m_entityRecords );
+	WriteRecordDiff( diffWriter, m_checkpoint.m_factionRecords, current.m_factionRecords );
+	diffWriter.Write<uint32_t>( current.m_scheduler.size() );
+	WriteBlob( diffWriter, current.m_scheduler );
+
+	BufferBinaryWriter deltaWriter;
+	deltaWriter.WriteBytes( DELTA_MAGIC, sizeof( DELTA_MAGIC ) );
+	deltaWriter.Write<uint32_t>( DELTA_VERSION );
+	deltaWriter.Write<uint32_t>( m_baseHash );
+	size_t payloadStart = BinarySaveGame::BeginSizedBlock( deltaWriter );
+	WriteCompressedBlock( deltaWriter, diffWriter.GetBuffer().data(), diffWriter.GetNumBytesWritten() );
+	BinarySaveGame::EndSizedBlock( deltaWriter, payloadStart );
+
+	if ( !AppendBufferToBinaryFile( GetDeltaLogPath( m_checkpointPath ), deltaWriter.GetBuffer() ) )
+		return false;
+
+	m_deltaLogNumBytes += deltaWriter.GetNumBytesWritten();
+	++m_numDeltas;
+
+	m_lastSaveNumBytes = deltaWriter.GetNumBytesWritten();
+	m_wasLastSaveDelta = true;
+	return true;
+}
+
+
+//--------------------------------------------------------------------------------------------------------------
+STATIC bool SaveJournal::LoadFromFiles( const std::string& baseSavePath, TheGame& game )
+{
+	PROFILE_SCOPE( "SaveJournal::LoadFromFiles" );
+	MEMORY_TAG( "Saves" );
+
+	MappedFileReader baseReader;
+	if ( !baseReader.open( baseSavePath.c_str() ) || baseReader.GetNumBytes() == 0 )
+		return false;
+
+	std::vector< unsigned char > expandedBaseStorage;
+	size_t numBaseBytes = baseReader.GetNumBytes();
+	const unsigned char* baseData = BinarySaveGame::ExpandCompressedChunks( baseReader.GetData(), numBaseBytes, expandedBaseStorage );
+	if ( baseData == nullptr )
+		return false;
+
+	MappedFileReader deltaReader;
+	if ( !deltaReader.open( GetDeltaLogPath( baseSavePath ).c_str() ) || deltaReader.GetNumBytes() == 0 )
+		return BinarySaveGame::ReadFromBuffer( baseData, numBaseBytes, game );
+
+	SaveImage image;
+	if ( !image.ParseFromBuffer( baseData, numBaseBytes ) )
+		return BinarySaveGame::ReadFromBuffer( baseData, numBaseBytes, game ); //Predates the journal.
+
+	const unsigned int baseHash = HashBytes( baseReader.GetData(), baseReader.GetNumBytes() ); //Of the file as written, compressed or not.
+	baseReader.close();
+	std::vector< byte_t > decompressedPayload;
+	SaveImage stagedImage; //Each delta is applied here first, so one that fails partway leaves image at the last whole save.
+
+	BufferBinaryReader logReader( deltaReader.GetData(), deltaReader.GetNumBytes() );
+	while ( !logReader.IsAtEnd() )
+	{
+		char magic[ 4 ];
+		uint32_t version = 0;
+		uint32_t deltaBaseHash = 0;
+		uint32_t payloadSize = 0;
+		logReader.ReadBytes( magic, sizeof( magic ) );
+		logReader.Read<uint32_t>( &version );
+		logReader.Read<uint32_t>( &deltaBaseHash );
+		logReader.Read<uint32_t>( &payloadSize );
+		if ( logReader.DidOverrun() || memcmp( magic, DELTA_MAGIC, sizeof( magic ) ) != 0 || payloadSize > logReader.GetNumBytesRemaining() )
+		{
+			DebuggerPrintf( "SaveJournal found a truncated delta, e.g. from a crash mid-save, keeping the deltas before it." );
+			break;
+		}
+
+		BufferBinaryReader payloadReader( logReader.GetCurrentPointer(), payloadSize );
+		logReader.SkipBytes( payloadSize );
+
+		if ( deltaBaseHash != baseHash || version > DELTA_VERSION )
+			continue;
+
+		stagedImage = image; //Assignment reuses the staged vectors' capacity from the last delta.
+		bool didApply;
+		if ( version < 2 )
+		{
+			didApply = ApplyDelta( payloadReader, stagedImage );
+		}
+		else
+		{
+			didApply = ReadCompressedBlock( payloadReader, decompressedPayload );
+			BufferBinaryReader decompressedReader( decompressedPayload.data(), decompressedPayload.size() );
+			didApply = didApply && ApplyDelta( decompressedReader, stagedImage );
+		}
+
+		if ( !didApply )
+		{
+			DebuggerPrintf( "SaveJournal found a corrupt delta, ignoring it and any after it." );
+			break;
+		}
+		std::swap( image, stagedImage );
+	}
+
+	BufferBinaryWriter mergedWriter;
+	image.WriteToBuffer( mergedWriter );
+	return BinarySaveGame::ReadFromBuffer( mergedWriter.GetBuffer().data(), mergedWriter.GetNumBytesWritten(), game );
+}
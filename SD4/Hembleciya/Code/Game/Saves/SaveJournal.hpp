@@ -0,0 +1,77 @@
+#pragma once
+
+
+#include "Game/GameCommon.hpp"
+#include <map>
+#include <string>
+#include <vector>
+
+
+//-----------------------------------------------------------------------------
+class TheGame;
+class BufferBinaryWriter;
+
+
+//-----------------------------------------------------------------------------
+typedef std::map< EntityID, std::vector< byte_t > > SaveRecordMap;
+
+
+//-----------------------------------------------------------------------------
+struct SaveImage //A BinarySaveGame split into the pieces SaveJournal diffs, each kept as its serialized bytes.
+{
+	bool ParseFromBuffer( const unsigned char* data, size_t numBytes ); //False for version 1 saves, whose records carry no leading EntityID.
+	void WriteToBuffer( BufferBinaryWriter& writer ) const; //Back to a whole BinarySaveGame.
+	void Clear();
+	bool IsEmpty() const { return m_terrain.empty(); }
+
+	std::vector< byte_t > m_terrain;
+	std::vector< byte_t > m_visibility;
+	SaveRecordMap m_entityRecords; //EntityType byte, then the record.
+	SaveRecordMap m_factionRecords;
+	std::vector< byte_t > m_scheduler;
+};
+
+
+//-----------------------------------------------------------------------------
+// Journaled saves: the first save writes a whole BinarySaveGame as the base, later ones append to <base>.delta
+// only the terrain and visibility regions, entity records and factions whose bytes changed since the last save.
+// Once the log gets long relative to the base, the next save compacts it into a fresh base.
+// Each delta carries a hash of the base it applies to, so deltas left behind by an overwritten base are ignored.
+//-----------------------------------------------------------------------------
+class SaveJournal
+{
+public:
+	SaveJournal();
+
+	bool Save( const TheGame& game, const std::string& baseSavePath );
+	bool Save( const std::vector< unsigned char >& saveBytes, const std::string& baseSavePath ); //A BinarySaveGame::WriteToBuffer snapshot, touches no game state.
+	bool HasCheckpoint() const { return !m_checkpoint.IsEmpty(); } //Whether this session has saved since the last Reset.
+	void Reset(); //Forget the checkpoint, e.g. once the game it described is destroyed, so the next Save writes a base.
+
+	static bool LoadFromFiles( const std::string& baseSavePath, TheGame& game ); //Base plus whichever deltas match it.
+	static std::string GetDeltaLogPath( const std::string& baseSavePath ) { return baseSavePath + ".delta"; }
+
+	size_t GetLastSaveNumBytes() const { return m_lastSaveNumBytes; }
+	bool WasLastSaveDelta() const { return m_wasLastSaveDelta; }
+	unsigned int GetNumDeltas() const { return m_numDeltas; }
+
+	static const unsigned int s_REGION_NUM_BYTES;
+	static const unsigned int s_MAX_DELTAS_BEFORE_COMPACTION;
+	static const float s_MAX_DELTA_LOG_FRACTION_OF_BASE;
+
+
+private:
+	bool NeedsNewBase( const std::string& baseSavePath ) const;
+	bool WriteBase( const std::string& baseSavePath, const std::vector< unsigned char >& saveBytes );
+	bool AppendDelta( const SaveImage& current );
+
+	SaveImage m_checkpoint; //What the files on disk currently add up to.
+	std::string m_checkpointPath;
+	unsigned int m_baseHash;
+	size_t m_baseNumBytes;
+	size_t m_deltaLogNumBytes;
+	unsigned int m_numDeltas;
+
+	size_t m_lastSaveNumBytes;
+	bool m_wasLastSaveDelta;
+};
@@ -9,6 +9,7 @@
 #include "Engine/Core/Command.hpp"
 #include "Engine/Core/TheConsole.hpp"
 #include "Engine/Input/TheInput.hpp"
+#include "Engine/Time/Profiler.hpp"
 
 
 //--------------------------------------------------------------------------------------------------------------
@@ -202,6 +203,8 @@ void TheApp::HandleInput()
 //--------------------------------------------------------------------------------------------------------------
 void TheApp::FlipAndPresent()
 {
+	PROFILE_SCOPE( "TheApp::FlipAndPresent" ); //Where waiting on the GPU shows up.
+
 	SwapBuffers( m_displayDeviceContext );
 }
 
@@ -3,8 +3,13 @@
 #include "Engine/Input/TheInput.hpp"
 #include "Engine/Core/Command.hpp"
 #include "Engine/FileUtils/FileUtils.hpp"
+#include "Engine/FileUtils/XMLPullReader.hpp"
 #include "Engine/Core/TheConsole.hpp"
 #include "Engine/Math/Camera3D.hpp"
+#include "Engine/Time/Time.hpp"
+#include "Engine/Time/Profiler.hpp"
+#include "Engine/Memory/AllocationTracker.hpp"
+#include "Engine/Metrics/Metrics.hpp"
 
 #include "Game/GameEntity.hpp"
 #include "Game/Player.hpp"
@@ -20,6 +25,10 @@
 #include "Game/Features/Feature.hpp"
 #include "Engine/Audio/TheAudio.hpp"
 #include "Game/FactionSystem.hpp"
+#include "Game/Saves/BinarySaveGame.hpp"
+#include "Game/Saves/SaveJournal.hpp"
+#include "Game/Saves/BackgroundSaver.hpp"
+#include "Game/Blueprints/BlueprintCache.hpp"
 
 
 
@@ -28,6 +37,7 @@ TheGame* g_theGame = nullptr;
 static SoundID g_menuAcceptSoundID = 0;
 static SoundID g_menuDeclineSoundID = 0;
 STATIC Camera3D* TheGame::s_playerCamera = new Camera3D( Vector3f::ZERO );
+STATIC const int TheGame::s_AUTOSAVE_INTERVAL_TURNS = 25;
 
 
 //--------------------------------------------------------------------------------------------------------------
@@ -46,6 +56,12 @@ TheGame::TheGame()
 	, m_player( nullptr )
 	, m_FADEOUT_LENGTH_SECONDS( 15.0f )
 	, m_fadeoutTimer( 0.f )
+	, m_simulationTimings( nullptr )
+	, m_backgroundSaver( new BackgroundSaver() )
+	, m_nextAutosaveTurn( 0 )
+	, m_agentTurnsMetric( Metrics::RegisterCounter( "game.agent_turns" ) )
+	, m_agentTurnSecondsMetric( Metrics::RegisterHistogram( "game.agent_turn_seconds" ) )
+	, m_livingEntitiesMetric( Metrics::RegisterGauge( "game.living_entities" ) )
 {
 	g_menuAcceptSoundID = g_theAudio->CreateOrGetSound( "Data/Audio/MenuAccept.wav" );;
 	g_menuDeclineSoundID = g_theAudio->CreateOrGetSound( "Data/Audio/MenuDecline.wav" );;
@@ -56,6 +72,7 @@ TheGame::TheGame()
 TheGame::~TheGame()
 {
 	DestroyAllGameplayEntities();
+	delete m_backgroundSaver;
 }
 
 
@@ -67,51 +84,146 @@ const Camera3D* TheGame::GetActiveCamera() const
 
 
 //-----------------------------------------------------------------------------
-void TheGame::LoadGame()
+bool TheGame::LoadGame()
 {
-	m_foundSave = ( CountFilesInDirectory( "Data/XML/Saves", "*.Save.xml" ) > 0 );
+	std::string saveFilename = "Data/XML/Saves/Save000.Save.bin";
+	if ( CountFilesInDirectory( "Data/XML/Saves", "*.Save.bin" ) == 0 )
+		saveFilename = "Data/XML/Saves/Save000.Save.xml"; //Import a save from before the binary format.
+
+	m_foundSave = ( CountFilesInDirectory( "Data/XML/Saves", "*.Save.bin" ) + CountFilesInDirectory( "Data/XML/Saves", "*.Save.xml" ) > 0 );
 	if ( !m_foundSave )
-		return;
+		return false;
 
-	std::string saveFilename = "Data/XML/Saves/Save000.Save.xml";
+	if ( !LoadGameFromFile( saveFilename ) )
+	{
+		g_theConsole->Printf( "Failed to load game from %s!", saveFilename.c_str() );
+		g_theConsole->ShowConsole();
+		return false;
+	}
 
-	const XMLNode& mapNode = XMLNode::openFileHelper( saveFilename.c_str(), "MapData" );
-	m_currentMap = new Map( mapNode ); //Map reads in mapSize=, <Legend>, TileData, VisibilityData.
+	g_theConsole->Printf( "Game successfully loaded from %s. File deleted.", saveFilename.c_str() );
+	g_theConsole->ShowConsole();
+
+#define DELETE_ENABLED
+#ifdef DELETE_ENABLED
+	DeleteSaveFiles( saveFilename );
+	m_foundSave = ( CountFilesInDirectory( "Data/XML/Saves", "*.Save.bin" ) + CountFilesInDirectory( "Data/XML/Saves", "*.Save.xml" ) > 0 );
+#endif
+
+	return true;
+}
+
+
+//-----------------------------------------------------------------------------
+bool TheGame::LoadGameFromFile( const std::string& saveFilename )
+{
+	bool didLoad = BinarySaveGame::IsBinarySaveFilename( saveFilename ) ? SaveJournal::LoadFromFiles( saveFilename, *this ) : LoadGameFromXMLFile( saveFilename );
+	if ( !didLoad || m_player == nullptr )
+	{
+		DestroyAllGameplayEntities();
+		return false;
+	}
+
+	g_showFullMap = false;
+	m_currentMap->RefreshCellOccupantVisibility();
+	m_player->UpdateFieldOfView();
+	m_nextAutosaveTurn = m_player->GetNumTurns() + s_AUTOSAVE_INTERVAL_TURNS;
+	return true;
+}
+
+
+//-----------------------------------------------------------------------------
+bool TheGame::LoadGameFromXMLFile( const std::string& saveFilename )
+{
+	//Streamed: SaveGameToXMLFile writes the map's elements first, then each entity's tree is built, loaded, and freed in turn.
+	XMLPullReader reader;
+	if ( !reader.open( saveFilename.c_str() ) || !FindXMLPullRootElement( reader, "MapData" ) )
+	{
+		DebuggerPrintf( "TheGame::LoadGameFromXMLFile() found no <MapData> in %s!\n", saveFilename.c_str() );
+		return false;
+	}
+
+	XMLNode mapNode = XMLNode::createXMLTopNode( "MapData" ); //Map reads in mapSize=, <Legend>, TileData, VisibilityData.
+	AddXMLAttributesFromPullReader( reader, mapNode );
+	int mapDataDepth = reader.GetDepth();
 
-	const XMLNode& entityDataNode = mapNode.getChildNode( "EntityData" );
 	std::map< EntityID, GameEntity* > loadedEntities;
+	m_player = nullptr; //Set by the one <PlayerBlueprint>, wherever among the entities it falls.
+	while ( reader.NextChildElement( mapDataDepth ) )
+	{
+		if ( reader.GetName() != "EntityData" )
+		{
+			XMLNode mapChildNode;
+			if ( !ReadXMLNodeFromPullReader( reader, mapChildNode ) )
+				break;
+			mapNode.addChild( mapChildNode );
+			continue;
+		}
 
-	GameEntity* newEntity = nullptr;
-	int childIndex = 0;
-	for ( int numIteration = 0; numIteration < entityDataNode.nChildNode( "NPCBlueprint" ); numIteration++ ) //Incremented by getChildNode(str,&int).
+		if ( mapNode.getChildNode( "TileData" ).isEmpty() )
+		{
+			DebuggerPrintf( "TheGame::LoadGameFromXMLFile() found <EntityData> before <TileData> in %s!\n", saveFilename.c_str() );
+			return false;
+		}
+		m_currentMap = new Map( mapNode );
+
+		int entityDataDepth = reader.GetDepth();
+		while ( reader.NextChildElement( entityDataDepth ) )
+		{
+			XMLNode entityNode;
+			if ( !ReadXMLNodeFromPullReader( reader, entityNode ) )
+				break;
+
+			GameEntity* newEntity = LoadEntityFromXMLNode( entityNode );
+			if ( newEntity != nullptr )
+				loadedEntities.insert( std::pair< EntityID, GameEntity* >( newEntity->GetSavedID(), newEntity ) );
+		}
+	}
+
+	if ( reader.GetEvent() == XML_PULL_EVENT_ERROR )
+	{
+		DebuggerPrintf( "TheGame::LoadGameFromXMLFile() stopped at line %d of %s: %s\n", reader.GetErrorLineNumber(), saveFilename.c_str(), reader.GetErrorDescription() );
+		return false;
+	}
+	ASSERT_OR_DIE( m_player != nullptr, "Only One PlayerBlueprint!" );
+
+	for ( std::pair< EntityID, GameEntity* > entity : loadedEntities )
 	{
-		const XMLNode& npcNode = entityDataNode.getChildNode( "NPCBlueprint", &childIndex );
+		entity.second->ResolvePointersToEntities( loadedEntities ); //Function on GameEntity, override by Agent, Item, Feature, each GE type.
+		m_livingEntities.push_back( entity.second );
+	}
+
+	return true;
+}
+
 
-		std::string factoryName = npcNode.getAttribute( "name" );
+//-----------------------------------------------------------------------------
+GameEntity* TheGame::LoadEntityFromXMLNode( const XMLNode& entityNode )
+{
+	const char* entityTag = entityNode.getName();
+
+	if ( strcmp( entityTag, "NPCBlueprint" ) == 0 )
+	{
+		std::string factoryName = entityNode.getAttribute( "name" );
 
 		std::map< std::string, NPCFactory* >::iterator found = NPCFactory::GetRegistry().find( factoryName );
 
 		if ( found == NPCFactory::GetRegistry().end() )
 		{
 			DebuggerPrintf( "TheGame::LoadGame() failed to find NPCFactory for %s!", factoryName.c_str() );
-			continue;
+			return nullptr;
 		}
 
-		NPC* newNPC = found->second->CreateNPC( m_currentMap, npcNode );
+		NPC* newNPC = found->second->CreateNPC( m_currentMap, entityNode );
 		AddCarriedItemsToEntityListForAgent( newNPC );
-		newEntity = newNPC;
-
-		loadedEntities.insert( std::pair< EntityID, GameEntity* >( newEntity->GetSavedID(), newEntity ) );
-		m_activeAgents.insert( TurnOrderedMapPair( .1f, (Agent*)newEntity ) ); //Not 0 so the player can precede them for first move.
+		m_activeAgents.insert( TurnOrderedMapPair( .1f, newNPC ) ); //Not 0 so the player can precede them for first move.
+		return newNPC;
 	}
 
-	childIndex = 0;
-	for ( int numIteration = 0; numIteration < entityDataNode.nChildNode( "ItemBlueprint" ); numIteration++ ) //Incremented by getChildNode(str,&int).
+	if ( strcmp( entityTag, "ItemBlueprint" ) == 0 )
 	{
-		XMLNode itemNode = entityDataNode.getChildNode( "ItemBlueprint", &childIndex );
-
-		std::string factoryName = itemNode.getAttribute( "name" );
-		std::string itemTypeAsString = itemNode.getAttribute( "type" );
+		std::string factoryName = entityNode.getAttribute( "name" );
+		std::string itemTypeAsString = entityNode.getAttribute( "type" );
 		ItemType itemType = GetItemTypeForString( itemTypeAsString );
 
 		ItemFactoryCategory& registry = ItemFactory::GetRegistryForItemType( itemType );
@@ -121,21 +233,16 @@ void TheGame::LoadGame()
 		if ( found == registry.end() )
 		{
 			DebuggerPrintf( "TheGame::LoadGame() failed to find ItemFactory for %s %s!", itemTypeAsString.c_str(), factoryName.c_str() );
-			continue;
+			return nullptr;
 		}
 
-		newEntity = found->second->CreateItem( m_currentMap, itemNode );
-
-		loadedEntities.insert( std::pair< EntityID, GameEntity* >( newEntity->GetSavedID(), newEntity ) );
+		return found->second->CreateItem( m_currentMap, entityNode );
 	}
-	
-	childIndex = 0;
-	for ( int numIteration = 0; numIteration < entityDataNode.nChildNode( "FeatureBlueprint" ); numIteration++ ) //Incremented by getChildNode(str,&int).
-	{
-		XMLNode featureNode = entityDataNode.getChildNode( "FeatureBlueprint", &childIndex );
 
-		std::string factoryName = featureNode.getAttribute( "name" );
-		std::string featureTypeAsString = featureNode.getAttribute( "type" );
+	if ( strcmp( entityTag, "FeatureBlueprint" ) == 0 )
+	{
+		std::string factoryName = entityNode.getAttribute( "name" );
+		std::string featureTypeAsString = entityNode.getAttribute( "type" );
 		FeatureType featureType = GetFeatureTypeForString( featureTypeAsString );
 
 		FeatureFactoryCategory& registry = FeatureFactory::GetRegistryForFeatureType( featureType );
@@ -145,47 +252,63 @@ void TheGame::LoadGame()
 		if ( found == registry.end() )
 		{
 			DebuggerPrintf( "TheGame::LoadGame() failed to find FeatureFactory for %s %s!", featureTypeAsString.c_str(), factoryName.c_str() );
-			continue;
+			return nullptr;
 		}
 
-		newEntity = found->second->CreateFeature( m_currentMap, featureNode );
-
-		loadedEntities.insert( std::pair< EntityID, GameEntity* >( newEntity->GetSavedID(), newEntity ) );
+		return found->second->CreateFeature( m_currentMap, entityNode );
 	}
 
-	ASSERT_OR_DIE( 1 == entityDataNode.nChildNode( "PlayerBlueprint" ), "Only One PlayerBlueprint!" );
+	if ( strcmp( entityTag, "PlayerBlueprint" ) == 0 )
 	{
-		//Player handle separately via m_player.
-		const XMLNode& playerNode = entityDataNode.getChildNode( "PlayerBlueprint" );
+		ASSERT_OR_DIE( m_player == nullptr, "Only One PlayerBlueprint!" );
 
-		m_player = new Player( ENTITY_TYPE_PLAYER, m_currentMap, playerNode );
-		newEntity = m_player;
+		//Player handle separately via m_player.
+		m_player = new Player( ENTITY_TYPE_PLAYER, m_currentMap, entityNode );
 
 		AddCarriedItemsToEntityListForAgent( m_player );
-		loadedEntities.insert( std::pair< EntityID, GameEntity* >( newEntity->GetSavedID(), newEntity ) );
 		m_activeAgents.insert( TurnOrderedMapPair( 0.f, m_player ) ); //Player will go first if all else inserted > 0.f.
+		return m_player;
 	}
 
-	for ( std::pair< EntityID, GameEntity* > entity : loadedEntities )
+	return nullptr;
+}
+
+
+//-----------------------------------------------------------------------------
+bool TheGame::StartHeadlessGameplay( const std::string& biomeName )
+{
+	std::map< std::string, BiomeBlueprint* >::const_iterator found = BiomeBlueprint::GetRegistry().find( biomeName );
+	if ( found == BiomeBlueprint::GetRegistry().cend() )
 	{
-		entity.second->ResolvePointersToEntities( loadedEntities ); //Function on GameEntity, override by Agent, Item, Feature, each GE type.
-		m_livingEntities.push_back( entity.second );
+		DebuggerPrintf( "TheGame::StartHeadlessGameplay() failed to find BiomeBlueprint %s!", biomeName.c_str() );
+		return false;
 	}
 
-	g_theConsole->Printf( "Game successfully loaded from %s. File deleted.", saveFilename.c_str() );
+	DestroyAllGameplayEntities();
 
-	g_showFullMap = false;
-	m_currentMap->RefreshCellOccupantVisibility();
-	m_player->UpdateFieldOfView();
+	g_pickedBiome = found->second;
+	m_currentMap = g_pickedBiome->InitializeBlueprint();
+	g_pickedBiome->FullyGenerateBlueprint( m_currentMap );
 
-	g_theConsole->ShowConsole();
+	FinalizeMap();
+	StartGameplay();
+	return true;
+}
 
-#define DELETE_ENABLED
-#ifdef DELETE_ENABLED
-	remove( saveFilename.c_str() );
-	m_foundSave = false;
-#endif
 
+//-----------------------------------------------------------------------------
+bool TheGame::StartHeadlessGameplayFromSave( const std::string& saveFilename )
+{
+	DestroyAllGameplayEntities();
+
+	return LoadGameFromFile( saveFilename ); //Unlike LoadGame(), leaves the file in place so runs can be replayed.
+}
+
+
+//-----------------------------------------------------------------------------
+static std::string GetSaveFilename()
+{
+	return Stringf( "Data/XML/Saves/Save000%s", BinarySaveGame::s_FILE_EXTENSION );
 }
 
 
@@ -198,6 +321,54 @@ void TheGame::SaveGame()
 		return; //Nice try.
 	}
 
+	std::string saveFilename = GetSaveFilename();
+	m_backgroundSaver->QueueSave( *this, saveFilename );
+	if ( !m_backgroundSaver->WaitForSaves() ) //Leaving for the menu anyway, and the result gets reported.
+	{
+		g_theConsole->ShowConsole();
+		g_theConsole->Printf( "Failed to save game to %s!", saveFilename.c_str() );
+		return;
+	}
+
+	g_theConsole->ShowConsole();
+	g_theConsole->Printf( "Game successfully saved to %s", saveFilename.c_str() );
+	m_foundSave = true;
+}
+
+
+//-----------------------------------------------------------------------------
+void TheGame::AutosaveGame()
+{
+	std::string saveFilename = GetSaveFilename();
+	if ( m_backgroundSaver->PollFailedSave() )
+		g_theConsole->Printf( "An earlier autosave to %s failed!", saveFilename.c_str() );
+
+	m_backgroundSaver->QueueSave( *this, saveFilename ); //Only the snapshot is paid for here, the write finishes in the background.
+	m_foundSave = true; //Quietly, unlike SaveGame(), as it interrupts play.
+}
+
+
+//-----------------------------------------------------------------------------
+void TheGame::DeleteSaveFiles( const std::string& saveFilename )
+{
+	remove( saveFilename.c_str() );
+	remove( SaveJournal::GetDeltaLogPath( saveFilename ).c_str() );
+}
+
+
+//-----------------------------------------------------------------------------
+bool TheGame::SaveGameToFile( const std::string& saveFilename )
+{
+	if ( BinarySaveGame::IsBinarySaveFilename( saveFilename ) )
+		return BinarySaveGame::WriteToFile( saveFilename, *this );
+
+	return SaveGameToXMLFile( saveFilename );
+}
+
+
+//-----------------------------------------------------------------------------
+bool TheGame::SaveGameToXMLFile( const std::string& saveFilename )
+{
 	XMLNode mapNode = XMLNode::createXMLTopNode( "MapData" );
 	m_currentMap->WriteToXMLNode( mapNode ); //Map writes out mapSize=, <Legend>, TileData, VisibilityData.
 	XMLNode entityDataNode = mapNode.addChild( "EntityData" );
@@ -205,12 +376,7 @@ void TheGame::SaveGame()
 	for ( GameEntity* entity : m_livingEntities )
 		entity->WriteToXMLNode( entityDataNode ); //A virtual function on the base GameEntity class.
 
-	std::string saveFilename = Stringf( "Data/XML/Saves/Save000.Save.xml" );
-	mapNode.writeToFile( saveFilename.c_str() );
-
-	g_theConsole->ShowConsole();
-	g_theConsole->Printf( "Game successfully saved to %s", saveFilename.c_str() );
-	m_foundSave = true;
+	return ( mapNode.writeToFile( saveFilename.c_str() ) == eXMLErrorNone );
 }
 
 
@@ -219,11 +385,7 @@ void TheGame::Startup()
 {
 	RegisterConsoleCommands();
 
-	BiomeBlueprint::LoadAllBiomeBlueprints();
-	Faction::LoadAllFactions(); //Put before NPCs so they can override these.
-	ItemFactory::LoadAllItemBlueprints(); //Put before NPCs so some can be born with these.
-	NPCFactory::LoadAllNPCBlueprints(); 
-	FeatureFactory::LoadAllFeatureBlueprints();
+	BlueprintCache::LoadAllBlueprints(); //Biomes, factions before NPCs so they can override these, items before NPCs so some can be born with these, NPCs, then features.
 }
 
 
@@ -247,7 +409,7 @@ bool TheGame::UpdateMainMenu( float /*deltaSeconds*/ )
 	if ( needToSearchSaves )
 	{
 		needToSearchSaves = false;
-		if ( CountFilesInDirectory( "Data/XML/Saves", "*.Save.xml" ) > 0 )
+		if ( CountFilesInDirectory( "Data/XML/Saves", "*.Save.bin" ) + CountFilesInDirectory( "Data/XML/Saves", "*.Save.xml" ) > 0 )
 			m_foundSave = true;
 	}
 
@@ -267,9 +429,8 @@ bool TheGame::UpdateMainMenu( float /*deltaSeconds*/ )
 		didUpdate = SetGameState( GameState::GAME_STATE_SHUTDOWN );
 	}
 
-	if ( m_foundSave && g_theInput->WasKeyPressedOnce( 'C' ) )
+	if ( m_foundSave && g_theInput->WasKeyPressedOnce( 'C' ) && LoadGame() )
 	{
-		LoadGame();
 		g_theAudio->PlaySound( g_menuAcceptSoundID );
 		m_fadeoutTimer = m_FADEOUT_LENGTH_SECONDS;
 		didUpdate = SetGameState( GameState::GAME_STATE_PLAYING );
@@ -344,6 +505,9 @@ bool TheGame::UpdateMapGenerating( float /*deltaSeconds*/ )
 //--------------------------------------------------------------------------------------------------------------
 void TheGame::FinalizeMap()
 {
+	PROFILE_SCOPE( "TheGame::FinalizeMap" );
+	MEMORY_TAG( "MapSetup" );
+
 	Generator::FinalizeMap( m_currentMap );
 	AddFeaturesToEntityListForMap( m_currentMap );
 	PopulateCurrentMapWithNPCs_RangedRandom( 10, 15 );
@@ -584,6 +748,18 @@ bool TheGame::UpdatePlaying( float deltaSeconds )
 
 	UpdatePlayedMapSimulation( deltaSeconds );
 
+	if ( m_player->IsAlive() && m_player->GetNumTurns() >= m_nextAutosaveTurn )
+	{
+		m_nextAutosaveTurn = m_player->GetNumTurns() + s_AUTOSAVE_INTERVAL_TURNS;
+		AutosaveGame();
+	}
+	else if ( !m_player->IsAlive() && m_backgroundSaver->HasSavedSinceReset() ) //Else the last autosave would undo the death.
+	{
+		m_backgroundSaver->Reset(); //So no write lands after the delete.
+		DeleteSaveFiles( GetSaveFilename() );
+		m_foundSave = ( CountFilesInDirectory( "Data/XML/Saves", "*.Save.bin" ) + CountFilesInDirectory( "Data/XML/Saves", "*.Save.xml" ) > 0 );
+	}
+
 	return didUpdate;
 }
 
@@ -601,6 +777,7 @@ void TheGame::StartGameplay()
 	//Be forewarned that NPCs have already been pushed into m_entities via PopulateMap call.
 	m_livingEntities.push_back( m_player );	
 	m_activeAgents.insert( TurnOrderedMapPair( 0.f, m_player ) ); //Player will go first if all else inserted > 0.f.
+	m_nextAutosaveTurn = s_AUTOSAVE_INTERVAL_TURNS;
 }
 
 
@@ -626,12 +803,16 @@ void TheGame::DestroyAllGameplayEntities()
 
 	//Now player is deleted in the entities container above, so no delete m_player.
 	m_player = nullptr; //Ensure TheGame's copy of it is also nullptr.
+
+	m_backgroundSaver->Reset(); //Loads renumber EntityIDs, so deltas against the old checkpoint would be meaningless.
 }
 
 
 //--------------------------------------------------------------------------------------------------------------
 void TheGame::DestroyDeadGameplayEntities()
 {
+	PROFILE_SCOPE( "TheGame::DestroyDeadGameplayEntities" );
+
 	bool didSeeDeath = false;
 	bool didHearDeath = false;
 
@@ -732,11 +913,13 @@ void TheGame::HandlePlayerDeath()
 //--------------------------------------------------------------------------------------------------------------
 void TheGame::UpdatePlayedMapSimulation( float deltaSeconds )
 {
+	PROFILE_SCOPE( "TheGame::UpdatePlayedMapSimulation" );
+
 	CooldownSeconds duration = 0.f;
 	bool isSimulating = true;
 	bool shouldAdvanceSimulationTimer = true;
 
-	while ( isSimulating ) //Enables us to stop it at some # actions and debug for infinite loops.
+	while ( isSimulating && !m_activeAgents.empty() ) //Enables us to stop it at some # actions and debug for infinite loops.
 	{
 		TurnOrderedMap::iterator agentIter = m_activeAgents.begin();
 		Agent* agent = agentIter->second;
@@ -759,11 +942,32 @@ void TheGame::UpdatePlayedMapSimulation( float deltaSeconds )
 
 		m_activeAgents.erase( agentIter );
 
+		double updateStartSeconds = GetCurrentTimeSeconds();
+
 		if ( agent->IsAlive() )
 			duration = agent->Update( deltaSeconds ); //Allows returning varied cooldown amounts depending on actions.
 
+		double updateEndSeconds = GetCurrentTimeSeconds();
+		Metrics::AddToCounter( m_agentTurnsMetric );
+		Metrics::RecordSeconds( m_agentTurnSecondsMetric, updateEndSeconds - updateStartSeconds );
+
+		if ( m_simulationTimings != nullptr )
+		{
+			if ( agent->IsPlayer() )
+			{
+				m_simulationTimings->m_playerUpdateSeconds += updateEndSeconds - updateStartSeconds;
+				++m_simulationTimings->m_numPlayerUpdates;
+			}
+			else
+			{
+				m_simulationTimings->m_npcUpdateSeconds += updateEndSeconds - updateStartSeconds;
+				++m_simulationTimings->m_numNPCUpdates;
+			}
+		}
+
 		if ( agent->IsAlive() ) //Be sure you kill yourself in Update above!
 		{
+			duration *= m_currentMap->GetHazards().GetTurnCooldownMultiplierForAgent( agent );
 			m_activeAgents.insert( TurnOrderedMapPair( g_mapSimulationTimer + duration, agent ) ); //Note they may actually go again next while loop iteration!
 				//You can make player actions near-no-delay while returning .01, etc.
 				//Simulation clock can also be faster than real-time.
@@ -771,12 +975,24 @@ void TheGame::UpdatePlayedMapSimulation( float deltaSeconds )
 				//Because of this, will empty out until player is the only one left at the top of the map--anyone coming in after will wait on the player.
 		}
 
+		double cleanupStartSeconds = ( m_simulationTimings != nullptr ) ? GetCurrentTimeSeconds() : 0.0;
+
 		DestroyDeadGameplayEntities();
 			//If not called here, but instead outside this loop, one could kill a next Agent to be updated.
+
+		if ( m_simulationTimings != nullptr )
+			m_simulationTimings->m_cleanupSeconds += GetCurrentTimeSeconds() - cleanupStartSeconds;
 	}
 
 	if ( shouldAdvanceSimulationTimer )
+	{
+		m_currentMap->GetHazards().ApplyHazardsForTimeSlice();
+		DestroyDeadGameplayEntities();
+
 		g_mapSimulationTimer += g_mapSimulationDelta;
+	}
+
+	Metrics::SetGauge( m_livingEntitiesMetric, (double)m_livingEntities.size() );
 }
 
 
@@ -793,6 +1009,8 @@ bool TheGame::UpdateShutdown( float /*deltaSeconds*/ )
 //--------------------------------------------------------------------------------------------------------------
 bool TheGame::Update( float deltaSeconds )
 {
+	PROFILE_SCOPE( "TheGame::Update" );
+
 	if ( g_theInput->WasKeyPressedOnce( KEY_TO_MUTE_MUSIC ) && g_backgroundMusic != nullptr )
 		g_backgroundMusic->stop();
 
@@ -2,6 +2,8 @@
 
 
 #include "Game/GameCommon.hpp"
+#include "Engine/Metrics/Metrics.hpp"
+#include <string>
 #include <vector>
 
 
@@ -16,6 +18,8 @@ class Map;
 class Player;
 class NPCFactory;
 class ItemFactory;
+class BackgroundSaver;
+struct XMLNode;
 
 
 //-----------------------------------------------------------------------------
@@ -24,6 +28,19 @@ class ItemFactory;
 extern TheGame* g_theGame;
 
 
+//-----------------------------------------------------------------------------
+struct SimulationTimings //Accumulated by UpdatePlayedMapSimulation only while a caller has requested them.
+{
+	SimulationTimings() : m_playerUpdateSeconds( 0.0 ), m_npcUpdateSeconds( 0.0 ), m_cleanupSeconds( 0.0 ), m_numPlayerUpdates( 0 ), m_numNPCUpdates( 0 ) {}
+
+	double m_playerUpdateSeconds;
+	double m_npcUpdateSeconds;
+	double m_cleanupSeconds; //DestroyDeadGameplayEntities.
+	int m_numPlayerUpdates;
+	int m_numNPCUpdates;
+};
+
+
 //-----------------------------------------------------------------------------
 class TheGame
 {
@@ -33,7 +50,8 @@ public:
 	~TheGame();
 
 	void SaveGame();
-	void LoadGame();
+	bool LoadGame();
+	bool SaveGameToFile( const std::string& saveFilename ); //Binary for *.Save.bin, else XML.
 	bool IsQuitting() const { return m_isQuitting; }
 	void Startup();
 	void Shutdown();
@@ -48,6 +66,12 @@ public:
 
 	const Camera3D* GetActiveCamera() const;
 
+	//Headless runs bypass the state machine and TheInput, see Game/Headless/HeadlessRunner.
+	bool StartHeadlessGameplay( const std::string& biomeName );
+	bool StartHeadlessGameplayFromSave( const std::string& saveFilename );
+	void UpdateHeadlessSimulation( float deltaSeconds ) { UpdatePlayedMapSimulation( deltaSeconds ); }
+	void SetSimulationTimings( SimulationTimings* timings ) { m_simulationTimings = timings; }
+
 	std::vector<GameEntity*> m_livingEntities;
 	TurnOrderedMap m_activeAgents;
 	Map* m_currentMap;
@@ -58,6 +82,21 @@ private:
 
 	bool m_foundSave;
 	bool m_isQuitting;
+	SimulationTimings* m_simulationTimings;
+	BackgroundSaver* m_backgroundSaver; //Journaled, so saves after the first only append what changed.
+	int m_nextAutosaveTurn;
+	static const int s_AUTOSAVE_INTERVAL_TURNS;
+
+	MetricID m_agentTurnsMetric; //Its rate is turns per second.
+	MetricID m_agentTurnSecondsMetric;
+	MetricID m_livingEntitiesMetric;
+
+	bool LoadGameFromFile( const std::string& saveFilename ); //Binary for *.Save.bin, else imports XML.
+	bool LoadGameFromXMLFile( const std::string& saveFilename );
+	GameEntity* LoadEntityFromXMLNode( const XMLNode& entityNode ); //One <EntityData> child, nullptr if its factory is missing.
+	bool SaveGameToXMLFile( const std::string& saveFilename );
+	void AutosaveGame();
+	void DeleteSaveFiles( const std::string& saveFilename );
 
 	void AddCarriedItemsToEntityListForAgent( const Agent* agent );
 	void AddFeaturesToEntityListForMap( Map* map );
@@ -1,6 +1,8 @@
 #include "Game/TheGame.hpp"
 #include "Engine/Renderer/TheRenderer.hpp"
 #include "Engine/Core/TheConsole.hpp"
+#include "Engine/String/StringFormat.hpp"
+#include "Engine/Time/Profiler.hpp"
 
 #include "Game/Biomes/BiomeBlueprint.hpp"
 #include "Game/Map.hpp"
@@ -9,6 +11,7 @@
 #include "Game/Player.hpp"
 #include "Game/Items/Item.hpp"
 #include "Game/Features/Feature.hpp"
+#include "Game/Saves/BackgroundSaver.hpp"
 
 
 //--------------------------------------------------------------------------------------------------------------
@@ -97,7 +100,7 @@ bool TheGame::RenderMapSelection2D()
 	g_theRenderer->DrawTextProportional2D
 		(
 			Vector2f( (float)g_theRenderer->GetScreenWidth() - 475.f, (float)g_theRenderer->GetScreenHeight() - 100.f ),
-			Stringf( "%s", genModeText.c_str() ),
+			genModeText,
 			.25f,
 			nullptr,
 			Rgba::GREEN
@@ -112,7 +115,7 @@ bool TheGame::RenderMapSelection2D()
 		g_theRenderer->DrawTextProportional2D
 			(
 				Vector2f( 50.f, (float)g_theRenderer->GetScreenHeight() - ( 250 + ( 60.f * numQuests ) ) ),
-				Stringf( "%d.) %s", numQuests + 1, currentBiomeBlueprintName.c_str() ),
+				FrameFormat( CHECKED_FORMAT( "{}.) {}", numQuests + 1, currentBiomeBlueprintName ) ),
 				.35f
 				);
 		++numQuests;
@@ -172,7 +175,7 @@ bool TheGame::RenderPlaying2D()
 		g_theRenderer->DrawTextMonospaced2D
 		(
 			Vector2f( 50.f, 25.f ),
-			Stringf( "Health: %d/%d", (int)m_player->GetHealth(), (int)m_player->GetMaxHealth() ),
+			FrameFormat( CHECKED_FORMAT( "Health: {}/{}", (int)m_player->GetHealth(), (int)m_player->GetMaxHealth() ) ),
 			24.f,
 			Rgba::RED + Rgba::GRAY
 		);
@@ -180,7 +183,7 @@ bool TheGame::RenderPlaying2D()
 		g_theRenderer->DrawTextMonospaced2D
 		(
 			Vector2f( (float)g_theRenderer->GetScreenWidth() - 350.f, 25.f ),
-			Stringf( "Turn #: %d", (int)m_player->GetNumTurns() ),
+			FrameFormat( CHECKED_FORMAT( "Turn #: {}", (int)m_player->GetNumTurns() ) ),
 			24.f,
 			Rgba::CYAN * Rgba::GRAY
 		);
@@ -236,7 +239,7 @@ bool TheGame::RenderPlaying2D()
 			g_theRenderer->DrawTextMonospaced2D
 			(
 				Vector2f( 150.f, .5f * (float)g_theRenderer->GetScreenHeight() - 100.f ),
-				Stringf( "# Monsters Killed: %d", (int)m_player->GetNumKills() ),
+				FrameFormat( CHECKED_FORMAT( "# Monsters Killed: {}", (int)m_player->GetNumKills() ) ),
 				24.f,
 				Rgba( 0, 127, 127, newAlpha ),
 				nullptr,
@@ -246,7 +249,7 @@ bool TheGame::RenderPlaying2D()
 			g_theRenderer->DrawTextMonospaced2D
 			(
 				Vector2f( 950.f, .5f * (float)g_theRenderer->GetScreenHeight() - 100.f ),
-				Stringf( "# Turns Survived: %d", (int)m_player->GetNumTurns() ),
+				FrameFormat( CHECKED_FORMAT( "# Turns Survived: {}", (int)m_player->GetNumTurns() ) ),
 				24.f,
 				Rgba( 0, 127, 0, newAlpha ),
 				nullptr,
@@ -327,6 +330,8 @@ bool TheGame::RenderShutdown2D()
 //--------------------------------------------------------------------------------------------------------------
 bool TheGame::Render2D() //Called by TheEngine::Render().
 {
+	PROFILE_SCOPE( "TheGame::Render2D" );
+
 	bool didRender = false;
 
 	switch ( GetGameState() )
@@ -360,12 +365,25 @@ void TheGame::RenderRightDebugText2D()
 	g_theRenderer->DrawTextMonospaced2D
 		(
 			Vector2f( (float)g_theRenderer->GetScreenWidth() - 375.f, (float)g_theRenderer->GetScreenHeight() - 50.f ),
-			Stringf( "GameState: %s", GetGameStateName( GetGameState() ) ),
+			FrameFormat( CHECKED_FORMAT( "GameState: {}", GetGameStateName( GetGameState() ) ) ),
 			18.f,
 			Rgba::GREEN,
 			nullptr,
 			.65f
 		);
+
+	if ( m_backgroundSaver->HasSavedSinceReset() )
+	{
+		g_theRenderer->DrawTextMonospaced2D
+			(
+				Vector2f( (float)g_theRenderer->GetScreenWidth() - 375.f, (float)g_theRenderer->GetScreenHeight() - 70.f ),
+				FrameFormat( CHECKED_FORMAT( "Save snapshot: {:.3} ms", m_backgroundSaver->GetLastSnapshotSeconds() * 1000.0 ) ),
+				18.f,
+				Rgba::GREEN,
+				nullptr,
+				.65f
+			);
+	}
 }
 
 